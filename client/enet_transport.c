@@ -43,12 +43,13 @@
  * a .c file compiled in C mode where bool is not a keyword. */
 #include "global.h"
 #include "crc.h"
+#include "servercore.h"
 
 /* ── Forward declarations for upper-layer callbacks ─────────────────────── */
 /* Defined in network.c — called when a packet arrives on the CLIENT side.   */
 void netUdpPacketArrive(BYTE *buff, int len, unsigned short port);
 /* Defined in servernet.c — called when a packet arrives on the SERVER side. */
-void serverNetUDPPacketArrive(BYTE *buff, int len,
+void serverNetUDPPacketArrive(serverCore sc, BYTE *buff, int len,
                                unsigned long addr, unsigned short port);
 
 /* ── Peer table ─────────────────────────────────────────────────────────── */
@@ -147,8 +148,9 @@ static bool gnsEnsureInit(void)
 static ENetHost   *g_server       = NULL;
 static ENetPeer   *g_lastSrvPeer  = NULL;   /* last peer to send us a packet  */
 static unsigned short g_serverPort = 0;
+static serverCore  g_srvGame      = NULL;   /* the one game the client hosts */
 
-bool serverTransportCreate(unsigned short port, char *addrToUse)
+bool serverTransportCreate(serverCore sc, unsigned short port, char *addrToUse)
 {
     ENetAddress addr;
     (void)addrToUse;  /* TODO: bind to specific IP when addrToUse != NULL     */
@@ -158,6 +160,7 @@ bool serverTransportCreate(unsigned short port, char *addrToUse)
     addr.host = ENET_HOST_ANY;
     addr.port = port;
     g_serverPort = port;
+    g_srvGame = sc;
 
     /* Up to 16 peers, 2 channels, unlimited bandwidth                        */
     g_server = enet_host_create(&addr, ENET_MAX_PEERS, 2, 0, 0);
@@ -169,13 +172,14 @@ bool serverTransportCreate(unsigned short port, char *addrToUse)
     return TRUE;
 }
 
-void serverTransportDestroy(void)
+void serverTransportDestroy(serverCore sc)
 {
     if (g_server) {
         enet_host_destroy(g_server);
         g_server = NULL;
     }
     g_lastSrvPeer = NULL;
+    g_srvGame = NULL;
 }
 
 /*
@@ -183,7 +187,7 @@ void serverTransportDestroy(void)
  * boloUpdate).  The original blocking loop is replaced by a drain loop with
  * timeout=0.
  */
-void serverTransportListenUDP(void)
+void serverTransportListenUDP(serverCore sc)
 {
     static unsigned srvCallCount = 0;
     ENetEvent ev;
@@ -236,7 +240,7 @@ void serverTransportListenUDP(void)
             }
             if (slot) {
                 g_lastSrvPeer = ev.peer;
-                serverNetUDPPacketArrive(
+                serverNetUDPPacketArrive(sc,
                     (BYTE *)ev.packet->data,
                     (int)ev.packet->dataLength,
                     (unsigned long)slot->fakeAddr.s_addr,
@@ -259,18 +263,18 @@ void serverTransportListenUDP(void)
     }
 }
 
-void serverTransportSetUs(void)
+void serverTransportSetUs(serverCore sc)
 {
     /* ENet manages the local address automatically; nothing to do here.      */
 }
 
-void serverTransportGetUs(struct in_addr *dest, unsigned short *port)
+void serverTransportGetUs(serverCore sc, struct in_addr *dest, unsigned short *port)
 {
     dest->s_addr = htonl(0x7f000001u);  /* 127.0.0.1 — good enough for solo  */
     *port        = htons(g_serverPort);
 }
 
-void serverTransportSendUDPLast(BYTE *buff, int len, bool wantCrc)
+void serverTransportSendUDPLast(serverCore sc, BYTE *buff, int len, bool wantCrc)
 {
     ENetPacket *pkt;
     BYTE        crcBuf[2048];
@@ -307,7 +311,7 @@ void serverTransportSendUDPLast(BYTE *buff, int len, bool wantCrc)
 }
 
 /* Generic send to an arbitrary peer by sockaddr_in (used by servernet.c).   */
-void serverTransportSendUDP(BYTE *buff, int len, struct sockaddr_in *addr)
+void serverTransportSendUDP(serverCore sc, BYTE *buff, int len, struct sockaddr_in *addr)
 {
     ENetPeerSlot *slot;
     ENetPacket   *pkt;
@@ -320,20 +324,20 @@ void serverTransportSendUDP(BYTE *buff, int len, struct sockaddr_in *addr)
         enet_peer_send(slot->peer, 0, pkt);
 }
 
-bool serverTransportSetTracker(char *address, unsigned short port)
+bool serverTransportSetTracker(serverCore sc, char *address, unsigned short port)
 {
     (void)address; (void)port;
     return TRUE;  /* Tracker not implemented in Phase C; stub succeeds.       */
 }
 
-void serverTransportSendUdpTracker(BYTE *buff, int len)
+void serverTransportSendUdpTracker(serverCore sc, BYTE *buff, int len)
 {
     (void)buff; (void)len;  /* Stub — tracker not used in Phase C.            */
 }
 
-void serverTransportDoChecks(void)
+void serverTransportDoChecks(serverCore sc)
 {
-    serverTransportListenUDP();
+    serverTransportListenUDP(sc);
 }
 
 /* ════════════════════════════════════════════════════════════════════════════
@@ -547,7 +551,7 @@ bool netClientUdpPing(BYTE *buff, int *len, char *dest,
          * Pump the embedded server so it can accept the connection. */
         deadline = enet_time_get() + 3000;
         while (enet_time_get() < deadline) {
-            serverTransportListenUDP();
+            serverTransportListenUDP(g_srvGame);
             if (enet_host_service(g_client, &ev, 10) > 0) {
                 if (ev.type == ENET_EVENT_TYPE_CONNECT) {
                     enet_log("netClientUdpPing: CONNECT event received — handshake OK");
@@ -613,7 +617,7 @@ bool netClientUdpPing(BYTE *buff, int *len, char *dest,
      * callers (netJoinInit), so copying the full received packet is safe. */
     deadline = enet_time_get() + 6000;
     while (enet_time_get() < deadline && !got_response) {
-        serverTransportListenUDP();
+        serverTransportListenUDP(g_srvGame);
         if (enet_host_service(g_client, &ev, 10) > 0) {
             if (ev.type == ENET_EVENT_TYPE_RECEIVE) {
                 int rcvLen = (int)ev.packet->dataLength;
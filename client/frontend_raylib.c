@@ -25,6 +25,7 @@
  *
  * Phase B2: tile grid rendering.
  * Phase B3: HUD state storage + status icons, bars, messages, man status.
+ * Phase B7: tank / shell / LGM sprites interpolated between game ticks.
  *
  * Zoom model: all coordinates passed to render_bridge use zoom=1 values;
  * render_bridge multiplies by its internal zoom factor automatically.
@@ -49,6 +50,7 @@
 #include "tiles.h"          /* _X/_Y pixel offsets in tiles.bmp */
 #include "positions.h"      /* MAIN_OFFSET_*, STATUS_*, MESSAGE_*, MAN_STATUS_* */
 #include "render_bridge.h"
+#include "game_loop.h"      /* boloTickCount, boloTickAlpha */
 
 /* ------------------------------------------------------------------ */
 /* Tile source-rect lookup table (B2)                                  */
@@ -467,6 +469,101 @@ static void drawHUD(void)
 #define BACKGROUND_BMP_PATH "background.bmp"
 #define SOUNDS_DIR_PATH     "sounds"
 
+/* ------------------------------------------------------------------ */
+/* B7 sprite interpolation                                             */
+/* Game logic runs at a fixed rate (boloAdvance) while frames are      */
+/* drawn as fast as the display allows.  Each frame the sprites seen   */
+/* at the latest tick are matched to the ones seen at the tick before  */
+/* and drawn boloTickAlpha() of the way between the two.  Positions    */
+/* are kept in map pixels (zoom=1) so a whole-square viewport scroll   */
+/* between ticks does not drag sprites across the screen.              */
+/* ------------------------------------------------------------------ */
+#define INTERP_MAX      256          /* sprites tracked per kind          */
+#define INTERP_NO_KEY   0xFF         /* sprite has no identity to match on */
+#define INTERP_SNAP     TILE_SIZE_X  /* further apart than this: no lerp  */
+
+typedef struct {
+    int  x, y;    /* map pixel position (zoom=1) */
+    BYTE frame;   /* sprite frame — shells/LGMs only match the same frame */
+    BYTE key;     /* player number for tanks, INTERP_NO_KEY otherwise */
+} interpItem;
+
+typedef struct {
+    interpItem item[INTERP_MAX];
+    int        count;
+} interpList;
+
+static interpList    g_tankPrev,  g_tankCur;
+static interpList    g_shellPrev, g_shellCur;
+static interpList    g_lgmPrev,   g_lgmCur;
+static unsigned long g_interpTick = 0;
+
+/* interpBegin — called once per frame before the sprite lists are rebuilt.
+ * If exactly one game tick has run since the last frame, what was drawn
+ * last frame is the tick before this one.  After a longer gap there is
+ * nothing sensible to interpolate from, so sprites are drawn where they
+ * are. */
+static void interpBegin(void)
+{
+    unsigned long tick = boloTickCount();
+    if (tick != g_interpTick) {
+        if (tick == g_interpTick + 1) {
+            g_tankPrev  = g_tankCur;
+            g_shellPrev = g_shellCur;
+            g_lgmPrev   = g_lgmCur;
+        } else {
+            g_tankPrev.count  = 0;
+            g_shellPrev.count = 0;
+            g_lgmPrev.count   = 0;
+        }
+        g_interpTick = tick;
+    }
+    g_tankCur.count  = 0;
+    g_shellCur.count = 0;
+    g_lgmCur.count   = 0;
+}
+
+/* interpPlace — records a sprite seen this frame and returns where to draw
+ * it in zoom=1 screen coordinates.  Tanks are matched by player number;
+ * shells and LGMs have no identity, so the nearest sprite with the same
+ * frame from the previous tick is used. */
+static void interpPlace(interpList *prev, interpList *cur, int x, int y,
+                        BYTE frame, BYTE key, int viewX, int viewY,
+                        float *drawX, float *drawY)
+{
+    const interpItem *from = NULL;
+    int best = INTERP_SNAP + 1;
+    int i;
+
+    if (cur->count < INTERP_MAX) {
+        interpItem *it = &cur->item[cur->count++];
+        it->x = x; it->y = y; it->frame = frame; it->key = key;
+    }
+
+    for (i = 0; i < prev->count; i++) {
+        const interpItem *p = &prev->item[i];
+        int dx = p->x > x ? p->x - x : x - p->x;
+        int dy = p->y > y ? p->y - y : y - p->y;
+        int d  = dx > dy ? dx : dy;
+        if (key != INTERP_NO_KEY) {
+            if (p->key == key) { if (d <= INTERP_SNAP) from = p; break; }
+        } else if (p->frame == frame && d < best) {
+            best = d;
+            from = p;
+        }
+    }
+
+    *drawX = (float)x;
+    *drawY = (float)y;
+    if (from != NULL) {
+        float alpha = boloTickAlpha();
+        *drawX = (float)from->x + (float)(x - from->x) * alpha;
+        *drawY = (float)from->y + (float)(y - from->y) * alpha;
+    }
+    *drawX -= (float)(viewX * TILE_SIZE_X);
+    *drawY -= (float)(viewY * TILE_SIZE_Y);
+}
+
 /* ------------------------------------------------------------------ */
 /* frontEndDrawMainScreen — B3 main render function                    */
 /* ------------------------------------------------------------------ */
@@ -476,6 +573,7 @@ void frontEndDrawMainScreen(
     long srtDelay, bool isPillView, int edgeX, int edgeY)
 {
     BYTE x, y, pos;
+    BYTE viewX, viewY;
 
     if (!tilesReady) {
         int i;
@@ -492,6 +590,9 @@ void frontEndDrawMainScreen(
         g_msgBot[0] = '\0';
     }
 
+    screenGetViewOffset(&viewX, &viewY);
+    interpBegin();
+
     /* 1. Background chrome */
     renderDrawBackground();
 
@@ -529,24 +630,24 @@ void frontEndDrawMainScreen(
             6*TILE_SIZE_Y, 6*TILE_SIZE_Y, 6*TILE_SIZE_Y
         };
 
-        BYTE count = 1;
-        BYTE total = screenTanksGetNumEntries(tks);
-        while (count <= total) {
-            BYTE mx, my, px, py, frame, playerNum;
-            char playerName[260];
-            int dstX, dstY;
-            screenTanksGetItem(tks, count, &mx, &my, &px, &py,
-                               &frame, &playerNum, playerName);
-            dstX = MAIN_OFFSET_X + mx * TILE_SIZE_X + (int)(px + 2);
-            dstY = MAIN_OFFSET_Y + my * TILE_SIZE_Y + (int)(py + 2);
+        int pos = 0;
+        screenPosTank *t;
+        while ((t = screenTanksNext(tks, &pos)) != NULL) {
+            BYTE frame = t->frame;
+            float dstX, dstY;
+            interpPlace(&g_tankPrev, &g_tankCur,
+                        (viewX + t->mx) * TILE_SIZE_X + (int)(t->px + 2),
+                        (viewY + t->my) * TILE_SIZE_Y + (int)(t->py + 2),
+                        frame, t->playerNum, viewX, viewY, &dstX, &dstY);
+            dstX += MAIN_OFFSET_X;
+            dstY += MAIN_OFFSET_Y;
             if (frame < 16) {
                 /* TANK_SELF_0..15: row 4, col = frame */
-                renderTile(frame * TILE_SIZE_X, 4 * TILE_SIZE_Y, dstX, dstY);
+                renderTileAt(frame * TILE_SIZE_X, 4 * TILE_SIZE_Y, dstX, dstY);
             } else if (frame < 32) {
                 /* TANK_SELFBOAT_0..15 */
-                renderTile(boatSrcX[frame - 16], boatSrcY[frame - 16], dstX, dstY);
+                renderTileAt(boatSrcX[frame - 16], boatSrcY[frame - 16], dstX, dstY);
             }
-            count++;
         }
     }
 
@@ -582,11 +683,10 @@ void frontEndDrawMainScreen(
         static const int shellW[16]  = {   3,  3,  4,  4,  4,  4,  4,  3,  3,  3,  3,  4,  4,  4,  4,  4 };
         static const int shellH[16]  = {   4,  4,  4,  3,  3,  3,  4,  4,  4,  4,  4,  3,  3,  3,  4,  3 };
 
-        int  total = screenBulletsGetNumEntries(sBullet);
-        int  count = 1;
-        while (count <= total) {
-            BYTE mx, my, px, py, frame;
-            screenBulletsGetItem(sBullet, count, &mx, &my, &px, &py, &frame);
+        int  pos = 0;
+        screenBullet *b;
+        while ((b = screenBulletsNext(sBullet, &pos)) != NULL) {
+            BYTE mx = b->mx, my = b->my, px = b->px, py = b->py, frame = b->frame;
             int dstX = MAIN_OFFSET_X + (int)mx * TILE_SIZE_X + (int)px;
             int dstY = MAIN_OFFSET_Y + (int)my * TILE_SIZE_Y + (int)py;
             if (frame >= 1 && frame <= 8) {
@@ -596,16 +696,42 @@ void frontEndDrawMainScreen(
             } else if (frame >= 9 && frame <= 24) {
                 /* Shell direction: SHELL_DIR0..15 */
                 int d = (int)frame - 9;
-                renderSprite(shellX[d], shellY[d], shellW[d], shellH[d], dstX, dstY);
+                float fx, fy;
+                interpPlace(&g_shellPrev, &g_shellCur,
+                            (viewX + mx) * TILE_SIZE_X + (int)px,
+                            (viewY + my) * TILE_SIZE_Y + (int)py,
+                            frame, INTERP_NO_KEY, viewX, viewY, &fx, &fy);
+                renderSpriteAt(shellX[d], shellY[d], shellW[d], shellH[d],
+                               MAIN_OFFSET_X + fx, MAIN_OFFSET_Y + fy);
+            }
+        }
+    }
+
+    /* 6. LGMs (engineers) — 3x4 man sprites, or the helicopter tile for
+     * a parachuting replacement (LGM3). */
+    {
+        int pos = 0;
+        screenPosLgm *l;
+        while ((l = screenLgmNext(lgms, &pos)) != NULL) {
+            float fx, fy;
+            interpPlace(&g_lgmPrev, &g_lgmCur,
+                        (viewX + l->mx) * TILE_SIZE_X + (int)l->px,
+                        (viewY + l->my) * TILE_SIZE_Y + (int)l->py,
+                        l->frame, INTERP_NO_KEY, viewX, viewY, &fx, &fy);
+            fx += MAIN_OFFSET_X;
+            fy += MAIN_OFFSET_Y;
+            switch (l->frame) {
+            case LGM0: renderSpriteAt(LGM0_X, LGM0_Y, LGM_WIDTH, LGM_HEIGHT, fx, fy); break;
+            case LGM1: renderSpriteAt(LGM1_X, LGM1_Y, LGM_WIDTH, LGM_HEIGHT, fx, fy); break;
+            case LGM2: renderSpriteAt(LGM2_X, LGM2_Y, LGM_WIDTH, LGM_HEIGHT, fx, fy); break;
+            default:   renderTileAt(LGM_HELICOPTER_X, LGM_HELICOPTER_Y, fx, fy);    break;
             }
-            count++;
         }
     }
 
-    /* 6. HUD overlay */
+    /* 7. HUD overlay */
     drawHUD();
 
-    (void)lgms;
     (void)srtDelay; (void)isPillView;
 }
 
@@ -24,8 +24,8 @@
  * main.c to call without pulling in Windows or bolo headers.
  *
  * Call sequence each frame:
- *   boloTick()   — 20 Hz game logic (screenGameTick)
- *   boloUpdate() — render callback (screenUpdate → frontEndDrawMainScreen)
+ *   boloAdvance() — fixed-timestep game logic (screenKeysTick/screenGameTick)
+ *   boloUpdate()  — render callback (screenUpdate → frontEndDrawMainScreen)
  */
 
 #include <stdio.h>
@@ -42,6 +42,25 @@
 /* Defined in win32stubs.c — keeps gameFrontGetPlayerName() in sync. */
 extern void gameFrontSetPlayerName(const char *name);
 
+/* Fixed-timestep state for boloAdvance().  Wall-clock time is banked in
+ * g_stepAccum and spent GAME_TICK_LENGTH ms at a time.  A backlog longer
+ * than STEP_MAX_BACKLOG steps (window drag, breakpoint) is dropped rather
+ * than replayed all at once. */
+#define STEP_MAX_BACKLOG 25
+
+static double        g_stepAccum   = 0.0; /* ms banked, not yet simulated  */
+static double        g_sinceGame   = 0.0; /* ms simulated since game tick  */
+static int           g_keysNext    = 1;   /* next step is screenKeysTick   */
+static unsigned long g_gameTicks   = 0;   /* screenGameTick calls so far   */
+static serverCore    g_hostGame    = NULL; /* game we serve when hosting    */
+
+static void resetTimestep(void)
+{
+    g_stepAccum = 0.0;
+    g_sinceGame = 0.0;
+    g_keysNext  = 1;
+}
+
 /* net_log — append a diagnostic line to net_debug.log next to the exe.
  * Written before/after every blocking network call so a post-crash read
  * shows exactly where execution stopped. */
@@ -76,6 +95,7 @@ int boloInit(const char *mapFile, const char *playerName)
         screenSetAutoScroll(TRUE);  /* center viewport on gunsight, not tank */
         netSetType(netSingle);      /* enable single-player base/pill capture */
         screenForceStatusUpdate();  /* push initial shells/mines/armour/trees to HUD */
+        resetTimestep();
         net_log("boloInit: screenLoadMap OK");
     } else {
         net_log("boloInit: screenLoadMap FAILED");
@@ -83,16 +103,50 @@ int boloInit(const char *mapFile, const char *playerName)
     return ok;
 }
 
-void boloTick(int tbOrdinal, int shoot)
+int boloAdvance(double elapsedSeconds, int tbOrdinal, int shoot)
 {
     tankButton tb = (tankButton)tbOrdinal;
-    /* Mirror the original alternating-tick pattern:
-     *   screenKeysTick fires at the key-update rate (input processing),
-     *   screenGameTick fires at the full game-logic rate.
-     * Calling both here each frame is correct for 20 Hz; the engine
-     * guards internally if the game has not yet started. */
-    screenKeysTick(tb, FALSE);
-    screenGameTick(tb, (bool)shoot, FALSE);
+    int ticks = 0;
+
+    if (elapsedSeconds > 0.0) {
+        g_stepAccum += elapsedSeconds * 1000.0;
+    }
+    if (g_stepAccum > STEP_MAX_BACKLOG * GAME_TICK_LENGTH) {
+        g_stepAccum = STEP_MAX_BACKLOG * GAME_TICK_LENGTH;
+    }
+
+    /* Mirror the original alternating-tick pattern (gui/linux/main.c
+     * windowGameTimer): each GAME_TICK_LENGTH step is either a key-update
+     * tick or a full game-logic tick.  The engine guards internally if the
+     * game has not yet started. */
+    while (g_stepAccum >= GAME_TICK_LENGTH) {
+        g_stepAccum -= GAME_TICK_LENGTH;
+        if (g_keysNext) {
+            screenKeysTick(tb, FALSE);
+            g_sinceGame += GAME_TICK_LENGTH;
+        } else {
+            screenGameTick(tb, (bool)shoot, FALSE);
+            g_sinceGame = 0.0;
+            g_gameTicks++;
+            ticks++;
+        }
+        g_keysNext = !g_keysNext;
+    }
+    return ticks;
+}
+
+unsigned long boloTickCount(void)
+{
+    return g_gameTicks;
+}
+
+float boloTickAlpha(void)
+{
+    /* A game tick happens every second step. */
+    double alpha = (g_sinceGame + g_stepAccum) / (2.0 * GAME_TICK_LENGTH);
+    if (alpha < 0.0) alpha = 0.0;
+    if (alpha > 1.0) alpha = 1.0;
+    return (float)alpha;
 }
 
 void boloUpdate(void)
@@ -105,7 +159,8 @@ void boloUpdate(void)
                 (int)netGetStatus(), (int)threadsGetContext());
         net_log(msg);
     }
-    serverTransportListenUDP(); /* poll ENet server events (non-blocking) */
+    if (g_hostGame != NULL)
+        serverTransportListenUDP(g_hostGame); /* poll ENet server events (non-blocking) */
     netClientUdpCheck();        /* poll ENet client receive (non-blocking) */
     screenUpdate(redraw);
 }
@@ -168,22 +223,23 @@ int boloHost(const char *mapFile, unsigned short port, const char *playerName)
      * These are dereferenced (as pointers) by serverNetMakeInfoRespsonse
      * during the netSetup join handshake — crash if called while NULL. */
     net_log("boloHost: calling serverCoreCreate");
-    if (!serverCoreCreate((char *)mapFile, gameOpen, FALSE, 0,
-                           UNLIMITED_GAME_TIME)) {
+    g_hostGame = serverCoreCreate((char *)mapFile, gameOpen, FALSE, 0,
+                                  UNLIMITED_GAME_TIME);
+    if (g_hostGame == NULL) {
         net_log("boloHost: serverCoreCreate FAILED");
         return 0;
     }
     net_log("boloHost: serverCoreCreate OK");
 
     net_log("boloHost: calling serverNetCreate");
-    if (!serverNetCreate(port, "", aiNone, "", 0, FALSE, "", 0)) {
+    if (!serverNetCreate(g_hostGame, port, "", aiNone, "", 0, FALSE, "", 0)) {
         net_log("boloHost: serverNetCreate FAILED");
         return 0;
     }
     net_log("boloHost: serverNetCreate OK");
 
-    /* threadsCreate builds the mutex used by threadsWaitForMutex /
-     * threadsReleaseMutex inside serverNetUDPPacketArrive.
+    /* threadsCreate starts the thread manager; the game's own mutex,
+     * taken inside serverNetUDPPacketArrive, came with serverCoreCreate.
      *
      * Pass FALSE (client context) so screencReCalc() → needScreenReCalc=TRUE
      * fires correctly.  screenReCalc() skips when threadsGetContext()==TRUE
@@ -246,7 +302,8 @@ int boloNetStatus(void)
 
 void boloNetPoll(void)
 {
-    serverTransportListenUDP(); /* poll ENet server events (non-blocking) */
+    if (g_hostGame != NULL)
+        serverTransportListenUDP(g_hostGame); /* poll ENet server events (non-blocking) */
     netClientUdpCheck();        /* poll ENet client receive (non-blocking) */
 }
 
@@ -265,4 +322,5 @@ void boloNetPostConnect(void)
     screenSetGunsight(TRUE);    /* gunsight defaults off */
     screenSetAutoScroll(TRUE);  /* center viewport on gunsight */
     screenForceStatusUpdate();  /* push initial shells/mines/armour/trees to HUD */
+    resetTimestep();
 }
\ No newline at end of file
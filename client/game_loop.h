@@ -37,11 +37,21 @@ void boloLogMsg(const char *msg);
  * to the game engine.  Pass NULL or "" to use the default "Player". */
 int  boloInit(const char *mapFile, const char *playerName);
 
-/* Run one 20 Hz game-logic tick.
+/* Advance the game by elapsedSeconds of wall-clock time.  Runs
+ * screenKeysTick and screenGameTick alternately every GAME_TICK_LENGTH ms,
+ * the same cadence as the original 100 Hz timer, no matter how often it is
+ * called.  Returns the number of screenGameTick calls made.
  *   tankButtonOrdinal: 0=TNONE 1=TLEFT 2=TRIGHT 3=TACCEL 4=TDECEL
  *                      5=TLEFTACCEL 6=TRIGHTACCEL 7=TLEFTDECEL 8=TRIGHTDECEL
  *   shoot: 1 if fire key is down, 0 otherwise */
-void boloTick(int tankButtonOrdinal, int shoot);
+int  boloAdvance(double elapsedSeconds, int tankButtonOrdinal, int shoot);
+
+/* Number of screenGameTick calls made since the game started. */
+unsigned long boloTickCount(void);
+
+/* How far (0..1) wall-clock time is between the last screenGameTick and
+ * the next one.  The renderer interpolates moving sprites by this. */
+float boloTickAlpha(void);
 
 /* Trigger a screen update (wraps screenUpdate → frontEndDrawMainScreen). */
 void boloUpdate(void);
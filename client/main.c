@@ -483,6 +483,12 @@ static int connectingScreen(void)
 static void runGameLoop(int mapLoaded)
 {
     int buildMode = 0;
+    double lastTime = GetTime();
+
+    /* Game logic runs on its own fixed timestep (boloAdvance), so drawing
+     * no longer needs the 50 FPS cap — render at the display rate and let
+     * the frontend interpolate sprites between ticks. */
+    SetTargetFPS(0);
 
     while (!WindowShouldClose()) {
         BeginDrawing();
@@ -514,7 +520,9 @@ static void runGameLoop(int mapLoaded)
             else if (rgt)        tb = 2;
             else                 tb = 0;
 
-            boloTick(tb, fire);
+            double now = GetTime();
+            boloAdvance(now - lastTime, tb, fire);
+            lastTime = now;
 
             if (IsKeyPressed(KEY_LEFT_BRACKET))  boloGunsightRange(0);
             if (IsKeyPressed(KEY_RIGHT_BRACKET)) boloGunsightRange(1);
@@ -537,15 +545,18 @@ static void runGameLoop(int mapLoaded)
             if (IsKeyPressed(KEY_B))     boloManMove(buildMode);
         }
     }
+
+    SetTargetFPS(50);   /* pre-game screens keep the original frame cap */
 }
 
 int main(void)
 {
     /* Window size = SCREEN_SIZE_X/Y * zoom (see render_bridge.c ZOOM default=2).
      * 515*2=1030, 325*2=650 — crisp on 1920x1200 and above. */
+    SetConfigFlags(FLAG_VSYNC_HINT);   /* in-game frames pace to the display */
     InitWindow(1030, 650, "WinBolo");
     InitAudioDevice();
-    SetTargetFPS(50);   /* original screenGameTick fires at 50 Hz (100 Hz timer, alternating) */
+    SetTargetFPS(50);   /* pre-game screens; the game loop runs uncapped */
 
     /* Load TTF font for all pre-game screens.
      * anonymous_pro_bold.ttf is bundled in fonts/ (OFL licence, shipped with
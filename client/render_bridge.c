@@ -244,11 +244,16 @@ void renderUnloadTiles(void)
  * srcX/srcY are original-sheet coordinates (multiples of 16).
  */
 void renderTile(int srcX, int srcY, int dstX, int dstY)
+{
+    renderTileAt(srcX, srcY, (float)dstX, (float)dstY);
+}
+
+void renderTileAt(int srcX, int srcY, float dstX, float dstY)
 {
     if (!g_tilesLoaded) return;
     Rectangle src = { (float)TO_PAD_X(srcX), (float)TO_PAD_Y(srcY),
                       (float)TILE_W, (float)TILE_H };
-    Rectangle dst = { (float)(dstX * g_zoom), (float)(dstY * g_zoom),
+    Rectangle dst = { dstX * g_zoom, dstY * g_zoom,
                       (float)(TILE_W * g_zoom), (float)(TILE_H * g_zoom) };
     DrawTexturePro(g_tiles, src, dst, (Vector2){0,0}, 0.0f, WHITE);
 }
@@ -258,10 +263,15 @@ void renderTile(int srcX, int srcY, int dstX, int dstY)
  * Used for shell/bullet sprites which may cross tile-row boundaries.
  */
 void renderSprite(int srcX, int srcY, int srcW, int srcH, int dstX, int dstY)
+{
+    renderSpriteAt(srcX, srcY, srcW, srcH, (float)dstX, (float)dstY);
+}
+
+void renderSpriteAt(int srcX, int srcY, int srcW, int srcH, float dstX, float dstY)
 {
     if (!g_iconsLoaded) return;
     Rectangle src = { (float)srcX, (float)srcY, (float)srcW, (float)srcH };
-    Rectangle dst = { (float)(dstX * g_zoom), (float)(dstY * g_zoom),
+    Rectangle dst = { dstX * g_zoom, dstY * g_zoom,
                       (float)(srcW * g_zoom), (float)(srcH * g_zoom) };
     DrawTexturePro(g_icons, src, dst, (Vector2){0,0}, 0.0f, WHITE);
 }
@@ -51,6 +51,12 @@ void renderTile(int srcX, int srcY, int dstX, int dstY);
  * Used for shell projectiles which are 3-4 px wide/tall. */
 void renderSprite(int srcX, int srcY, int srcW, int srcH, int dstX, int dstY);
 
+/* As renderTile / renderSprite but at a fractional zoom=1 position.
+ * Used for interpolated sprites so they move in screen pixels rather
+ * than whole zoom=1 pixels. */
+void renderTileAt(int srcX, int srcY, float dstX, float dstY);
+void renderSpriteAt(int srcX, int srcY, int srcW, int srcH, float dstX, float dstY);
+
 /* Draw a 12x12 status icon from the sheet (zoom=1 coords). */
 void renderStatusIcon(int srcX, int srcY, int dstX, int dstY);
 
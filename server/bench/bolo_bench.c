@@ -0,0 +1,824 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/*
+ * bolo_bench.c — headless server tick benchmark (bolo-bench).
+ *
+ * Loads a map into the server core, joins N scripted tanks and runs K
+ * calls to serverCoreGameTick() back to back with no SDL timer, no
+ * sockets and no tick mutex contention.  servercore.c is compiled with
+ * BOLO_PROFILE for this target so every subsystem called from the tick
+ * records its own time.
+ *
+ * Script
+ * ------
+ * The dedicated server never moves tanks itself: clients send position
+ * packets and fire shells that arrive through serverCoreExtractShellData.
+ * The bench plays that role.  Each tick every tank drives along its
+ * heading, turning when the square ahead is impassable and at random
+ * intervals, and fires every TANK_FIRE_TICKS.  Live pillboxes fire at the
+ * closest tank in range the way a client's pillboxes would.  Shots are
+ * packed in the shell wire format and fed through the same extract path
+ * as a client packet, so the server's shell-count and locality checks run
+ * too.  Every third tick the pending shell / map / PNB / MNT data is
+ * taken into the packet snapshot exactly as serverNetPublishSnapshot
+ * would, so dead shells are reaped and the net lists don't grow without
+ * bound.
+ *
+ * All randomness comes from a private LCG seeded from -seed so two runs
+ * with the same arguments do the same work on every platform.
+ *
+ * Math backend
+ * ------------
+ * -math fixed switches utilCalcDistance / utilCalcAngle /
+ * utilIsItemInRange to the integer table backend so the two can be A/B'd.
+ * A hash of the game state (map, pills, bases, tanks) is printed at the
+ * end of every run; with -math fixed it should match between compilers.
+ *
+ * Output
+ * ------
+ * A table on stdout and a JSON document (-json <file>, "-" for stdout)
+ * with ns/tick for each subsystem, the whole tick and the script itself,
+ * plus the math backend and final state hash.  The tank grid counters show
+ * how many tanks the shell and player collision checks looked at per tick
+ * against how many a scan of every tank would have.
+ *
+ * With -players the tanks also join as players, so each drain builds
+ * every player's position and shell data from the snapshot.  The view
+ * counters then show how many pill range checks the view matrix made per
+ * tick against a pill scan for every lookup.  Players change the game, so
+ * the state hash differs from a run without -players.
+ *
+ * Each player's positions are encoded both ways: the original full
+ * encoding, with the stale refresh every 75th drain, and the delta from
+ * the last frame the player acknowledged.  The deltas are decoded as a
+ * client would and acknowledged BENCH_ACK_DRAINS drains later.  The wire
+ * size report gives the position section bytes per drain for each.  Every
+ * scripted tank moves every tick, which is the worst case for deltas;
+ * -park has the tanks take turns sitting still, which changes the state
+ * hash.
+ *
+ * Tick spread
+ * -----------
+ * Every measured tick's length is kept and the median, 99th percentile
+ * and longest are reported, since log snapshots and the like show up as
+ * occasional long ticks rather than in the average.  With -log the game
+ * log goes through the log writer thread, flushed every -logflush ms;
+ * -logsync writes it from inside the tick as the server used to.  The
+ * writer counters are printed after the table.  Both write the same bytes
+ * for the same game, which can be checked by running each with a fixed
+ * clock and comparing the .wbv files.
+ *
+ * The shell list each logged tick builds comes from a per-tick arena.  Its
+ * counters give the lists built, the items handed out and the heap
+ * allocations made over the measured ticks; once the warmup has sized the
+ * arena the allocations should be zero.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "global.h"
+#include "util.h"
+#include "bolo_map.h"
+#include "pillbox.h"
+#include "bases.h"
+#include "tank.h"
+#include "shells.h"
+#include "tankgrid.h"
+#include "screenarena.h"
+#include "netpnb.h"
+#include "netmt.h"
+#include "posdelta.h"
+#include "servercore.h"
+#include "logwriter.h"
+#include "threads.h"
+#include "resource.h"   /* E_MAP — the inbuilt Everard Island map */
+
+/* Compressed length of E_MAP (matches servermain.c) */
+#define BENCH_INBUILT_MAP_LEN 5097
+
+#define BENCH_DEFAULT_TANKS  8
+#define BENCH_DEFAULT_TICKS  20000
+#define BENCH_DEFAULT_WARMUP 500
+#define BENCH_DEFAULT_SEED   1
+
+/* World units a scripted tank moves per tick (a map square is 256) */
+#define TANK_DRIVE_SPEED 16
+/* Ticks between shots from a scripted tank */
+#define TANK_FIRE_TICKS 12
+/* Shell length a scripted tank fires (half the default sight range) */
+#define TANK_FIRE_LENGTH 7
+/* Ticks between pillbox shots */
+#define PILL_FIRE_TICKS 10
+/* Ticks a tank stays parked or driving with -park */
+#define TANK_PARK_TICKS 300
+/* Server sends position and data packets every third tick */
+#define BENCH_DRAIN_TICKS 3
+
+/* Buffer position and shell data is built into */
+#define BENCH_DRAIN_BUFF 4096
+/* Drains between the original encoding's stale refreshes */
+#define BENCH_STALE_DRAINS 75
+/* Drains before a client's acknowledgement is seen by the server */
+#define BENCH_ACK_DRAINS 2
+/* Section type and length bytes in front of position data */
+#define BENCH_SECTION_HEADER 2
+
+/* One shell in the wire format read by shellsNetExtract */
+#define BENCH_SHELL_ITEM (2 * sizeof(WORLD) + sizeof(TURNTYPE) + 4)
+/* Shell section length is a BYTE so flush before it would overflow */
+#define BENCH_SHELL_BUFF (255 - (255 % BENCH_SHELL_ITEM))
+
+/* FNV-1a 64 bit state hash */
+#define BENCH_HASH_BASIS 14695981039346656037ULL
+#define BENCH_HASH_PRIME 1099511628211ULL
+
+/* Names reported for each serverCoreProfileItem */
+static const char *g_sectionNames[profileNumItems] = {
+    "pillsUpdate",
+    "basesUpdate",
+    "tankUpdate",
+    "lgmUpdate",
+    "tkExplosionUpdate",
+    "shellsUpdate",
+    "explosionsUpdate",
+    "minesExpUpdate",
+    "floodUpdate",
+    "serverCoreLogTick",
+    "logWriteSnapshot"
+};
+
+typedef struct {
+    TURNTYPE angle;   /* heading in bradians */
+    int      turnIn;  /* ticks until the next random turn */
+    int      fireIn;  /* ticks until the next shot */
+} BenchTank;
+
+static BenchTank     g_tanks[MAX_TANKS];
+static int           g_pillReload[MAX_PILLS];
+static unsigned long g_rand;
+static time_t        g_ticks = 0;
+static bool          g_players = FALSE;
+static bool          g_park = FALSE;
+static BYTE          g_shellBuff[BENCH_SHELL_BUFF];
+static BYTE          g_shellLen = 0;
+static posDelta      g_clientPos[MAX_TANKS];   /* Frames each client decoded */
+static BYTE          g_clientAck[MAX_TANKS][BENCH_ACK_DRAINS];
+static unsigned long g_drains = 0;
+static unsigned long g_posDrains = 0;
+static unsigned long long g_posFullBytes = 0;
+static unsigned long long g_posDeltaBytes = 0;
+static unsigned long g_posErrors = 0;
+static unsigned long long *g_tickTimes = NULL; /* Length of each measured tick */
+static long          g_numTickTimes = 0;
+static bool          g_logging = FALSE;
+static bool          g_logSync = FALSE;
+
+/* servernet.c reads the server tick count through servermain.c, which
+ * this target doesn't link. */
+time_t serverMainGetTicks(void)
+{
+    return g_ticks;
+}
+
+/* Deterministic across compilers and C runtimes, unlike rand(). */
+static unsigned int benchRand(void)
+{
+    g_rand = g_rand * 1103515245UL + 12345UL;
+    return (unsigned int) ((g_rand >> 16) & 0x7FFF);
+}
+
+static unsigned long long benchNow(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (unsigned long long) ((double) count.QuadPart * 1000000000.0 /
+                                 (double) freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL +
+           (unsigned long long) ts.tv_nsec;
+#endif
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "Usage: bolo-bench [-map <file>] [-tanks <n>] [-ticks <k>] [-warmup <w>]\n"
+        "                  [-seed <s>] [-math double|fixed] [-log <file.wbv>]\n"
+        "                  [-logflush <ms>] [-logsync] [-json <file>|-]\n"
+        "                  [-players] [-park]\n"
+        "\n"
+        "  -map     Map file to load (default: inbuilt Everard Island)\n"
+        "  -tanks   Scripted tanks, 0-%d (default %d)\n"
+        "  -ticks   Measured ticks (default %d)\n"
+        "  -warmup  Unmeasured ticks run first (default %d)\n"
+        "  -seed    Script random seed (default %d)\n"
+        "  -math    Trig and range backend (default double)\n"
+        "  -log     Record a .wbv log so the log path is exercised\n"
+        "  -logflush Milliseconds between log writer passes (default %d)\n"
+        "  -logsync Write the log from inside the tick, without the writer thread\n"
+        "  -json    Write JSON results to file, or - for stdout\n"
+        "  -players Join the tanks as players so position packets are built\n"
+        "  -park    Tanks take turns to sit still for %d ticks\n",
+        MAX_TANKS, BENCH_DEFAULT_TANKS, BENCH_DEFAULT_TICKS,
+        BENCH_DEFAULT_WARMUP, BENCH_DEFAULT_SEED, LOG_WRITER_FLUSH_DEFAULT,
+        TANK_PARK_TICKS);
+}
+
+/* ── Script ─────────────────────────────────────────────────────────────── */
+
+static void benchFlushShells(serverCore sc)
+{
+    if (g_shellLen > 0) {
+        serverCoreExtractShellData(sc, g_shellBuff, g_shellLen);
+        g_shellLen = 0;
+    }
+}
+
+/* Queues a shot as a client would send it.  len is in map squares and is
+ * converted the same way shellsAddItem does. */
+static void benchFireShell(serverCore sc, WORLD x, WORLD y, TURNTYPE angle, int len,
+                           BYTE owner, bool onBoat, BYTE creator)
+{
+    BYTE *pnt;
+
+    if (g_shellLen + BENCH_SHELL_ITEM > BENCH_SHELL_BUFF) {
+        benchFlushShells(sc);
+    }
+    pnt = g_shellBuff + g_shellLen;
+    memcpy(pnt, &x, sizeof(WORLD));
+    pnt += sizeof(WORLD);
+    memcpy(pnt, &y, sizeof(WORLD));
+    pnt += sizeof(WORLD);
+    memcpy(pnt, &angle, sizeof(TURNTYPE));
+    pnt += sizeof(TURNTYPE);
+    *pnt++ = (BYTE) (1 + (SHELL_LIFE * len) - SHELL_START_ADD);
+    *pnt++ = owner;
+    *pnt++ = onBoat;
+    *pnt   = creator;
+    g_shellLen = (BYTE) (g_shellLen + BENCH_SHELL_ITEM);
+}
+
+static void benchSpawnTanks(serverCore sc, int numTanks)
+{
+    BYTE     mx, my, shells, mines;
+    TURNTYPE angle;
+    int      i;
+
+    for (i = 0; i < numTanks; i++) {
+        if (g_players == TRUE) {
+            char name[PLAYER_NAME_LEN];
+            sprintf(name, "Bench %d", i);
+            playersSetPlayer(serverCoreGetPlayers(sc), (BYTE) i, name, "127.0.0.1",
+                             0, 0, 0, 0, 0, FALSE, 0, NULL);
+            g_clientPos[i] = posDeltaCreate();
+        }
+        serverCorePlayerJoin(sc, (BYTE) i);
+        serverCoreGetStartPosition(sc, (BYTE) i, &mx, &my, &angle, &shells, &mines);
+        g_tanks[i].angle  = angle;
+        g_tanks[i].turnIn = 20 + (int) (benchRand() % 100);
+        g_tanks[i].fireIn = (int) (benchRand() % TANK_FIRE_TICKS);
+    }
+    for (i = 0; i < MAX_PILLS; i++) {
+        g_pillReload[i] = (int) (benchRand() % PILL_FIRE_TICKS);
+    }
+}
+
+static void benchDriveTanks(serverCore sc, int numTanks)
+{
+    WORLD wx, wy, nx, ny;
+    int   xAdd, yAdd;
+    BYTE  terrain;
+    bool  onBoat;
+    int   i;
+
+    for (i = 0; i < numTanks; i++) {
+        tank *tk = &sc->tk[i];
+        if (*tk == NULL || tankGetArmour(tk) > TANK_FULL_ARMOUR) {
+            continue;
+        }
+        if (g_park == TRUE && (g_ticks / TANK_PARK_TICKS + i) % 2 == 0) {
+            /* Half the tanks sit still at a time, as players do between fights */
+            continue;
+        }
+        tankGetWorld(tk, &wx, &wy);
+        onBoat = tankIsOnBoat(tk);
+
+        if (--g_tanks[i].turnIn <= 0) {
+            g_tanks[i].angle += (TURNTYPE) (BRADIANS_GAP * (1 + benchRand() % 15));
+            g_tanks[i].turnIn = 20 + (int) (benchRand() % 100);
+        }
+        if (g_tanks[i].angle >= BRADIANS_MAX) {
+            g_tanks[i].angle -= (TURNTYPE) BRADIANS_MAX;
+        }
+
+        utilCalcDistance(&xAdd, &yAdd, g_tanks[i].angle, TANK_DRIVE_SPEED);
+        nx = (WORLD) (wx + xAdd);
+        ny = (WORLD) (wy + yAdd);
+        if (mapGetSpeed(&sc->mp, &sc->pb, &sc->bs, (BYTE) (nx >> M_W_SHIFT_SIZE),
+                        (BYTE) (ny >> M_W_SHIFT_SIZE), onBoat, (BYTE) i) == 0) {
+            /* Blocked: turn around and try again next tick */
+            g_tanks[i].angle += (TURNTYPE) BRADIANS_SOUTH;
+            tankSetLocationData(tk, wx, wy, g_tanks[i].angle, 0, onBoat);
+        } else {
+            terrain = mapGetPos(&sc->mp, (BYTE) (nx >> M_W_SHIFT_SIZE),
+                                (BYTE) (ny >> M_W_SHIFT_SIZE));
+            onBoat = (terrain == DEEP_SEA || (onBoat == TRUE && terrain == RIVER));
+            tankSetLocationData(tk, nx, ny, g_tanks[i].angle,
+                                (SPEEDTYPE) TANK_DRIVE_SPEED, onBoat);
+        }
+
+        if (--g_tanks[i].fireIn <= 0) {
+            /* Keep the magazine topped up in place of base refuelling */
+            tankSetShells(tk, TANK_FULL_SHELLS);
+            tankGetWorld(tk, &wx, &wy);
+            benchFireShell(sc, wx, wy, g_tanks[i].angle, TANK_FIRE_LENGTH, (BYTE) i,
+                           onBoat, (BYTE) i);
+            g_tanks[i].fireIn = TANK_FIRE_TICKS;
+        }
+    }
+}
+
+static void benchFirePills(serverCore sc, int numTanks)
+{
+    pillbox pill;
+    BYTE    numPills, count;
+    WORLD   px, py, tx, ty, bestX, bestY;
+    TURNTYPE angle;
+    double  amount, best;
+    int     xAdd, yAdd;
+    int     bestTank;
+    int     i;
+
+    numPills = pillsGetNumPills(&sc->pb);
+    for (count = 1; count <= numPills; count++) {
+        if (--g_pillReload[count-1] > 0) {
+            continue;
+        }
+        g_pillReload[count-1] = PILL_FIRE_TICKS;
+        pillsGetPill(&sc->pb, &pill, count);
+        if (pill.armour == 0 || pill.inTank == TRUE) {
+            continue;
+        }
+        px = (WORLD) ((pill.x << M_W_SHIFT_SIZE) + MAP_SQUARE_MIDDLE);
+        py = (WORLD) ((pill.y << M_W_SHIFT_SIZE) + MAP_SQUARE_MIDDLE);
+        best  = PILLBOX_RANGE + 1;
+        bestX = bestY = 0;
+        bestTank = 0;
+        for (i = 0; i < numTanks; i++) {
+            tank *tk = &sc->tk[i];
+            if (*tk == NULL || tankGetArmour(tk) > TANK_FULL_ARMOUR) {
+                continue;
+            }
+            tankGetWorld(tk, &tx, &ty);
+            if (utilIsItemInRange(px, py, tx, ty, PILLBOX_RANGE, &amount) == TRUE
+                && amount < best) {
+                best  = amount;
+                bestX = tx;
+                bestY = ty;
+                bestTank = i;
+            }
+        }
+        if (best <= PILLBOX_RANGE) {
+            /* The server only accepts a pill shot that started two shell
+             * steps out from a live pill, as a client's pillboxes do. */
+            angle = utilCalcAngle(px, py, bestX, bestY);
+            utilCalcDistance(&xAdd, &yAdd, angle, SHELL_SPEED);
+            benchFireShell(sc, (WORLD) (px + 2 * xAdd), (WORLD) (py + 2 * yAdd), angle,
+                           PILLBOX_FIRE_DISTANCE, NEUTRAL, FALSE, (BYTE) bestTank);
+        }
+    }
+}
+
+/* Takes the packet snapshot as serverNetPublishSnapshot does and builds
+ * each player's position and shell data, without sending anything. */
+/* Counts the position section a player would be sent both ways, then
+ * decodes the delta and queues its acknowledgement. */
+static void benchDrainPos(serverCore sc, BYTE playerNum, bool sendStale)
+{
+    BYTE full[BENCH_DRAIN_BUFF];
+    BYTE delta[BENCH_DRAIN_BUFF];
+    posDeltaFrame frame, decoded;
+    int len, i;
+
+    serverCoreMakePosFrame(sc, &frame, playerNum);
+    len = serverCoreMakePosPackets(sc, full, &frame, playerNum, sendStale);
+    if (len > 0) {
+        g_posFullBytes += (unsigned long long) (BENCH_SECTION_HEADER + len);
+    }
+    len = serverCoreMakePosDelta(sc, delta, &frame, playerNum);
+    if (len > 0) {
+        g_posDeltaBytes += (unsigned long long) (BENCH_SECTION_HEADER + len);
+        if (posDeltaDecode(&g_clientPos[playerNum], delta, len, &decoded) == FALSE ||
+            memcmp(&decoded, &frame, sizeof(frame)) != 0) {
+            g_posErrors++;
+        }
+    }
+
+    serverCoreSetPosAck(sc, playerNum, g_clientAck[playerNum][BENCH_ACK_DRAINS - 1]);
+    for (i = BENCH_ACK_DRAINS - 1; i > 0; i--) {
+        g_clientAck[playerNum][i] = g_clientAck[playerNum][i - 1];
+    }
+    g_clientAck[playerNum][0] = posDeltaGetLast(&g_clientPos[playerNum]);
+}
+
+static void benchDrainNet(serverCore sc)
+{
+    BYTE buff[BENCH_DRAIN_BUFF];
+    serverCoreSnapshot *snap;
+    bool sendStale;
+    BYTE i;
+
+    serverCorePublishSnapshot(sc, TRUE, TRUE);
+    snap = serverCoreGetSnapshot(sc);
+    g_drains++;
+    g_posDrains++;
+    sendStale = (bool) (g_drains % BENCH_STALE_DRAINS == 0);
+    for (i = 0; i < MAX_TANKS; i++) {
+        if (snap->inUse[i] == TRUE) {
+            benchDrainPos(sc, i, sendStale);
+            serverCoreMakeShellData(sc, buff, i);
+        }
+    }
+}
+
+static void benchStep(serverCore sc, int numTanks, unsigned long long *scriptNs,
+                      unsigned long long *tickNs)
+{
+    unsigned long long t0, t1, t2;
+
+    t0 = benchNow();
+    benchDriveTanks(sc, numTanks);
+    benchFirePills(sc, numTanks);
+    benchFlushShells(sc);
+    if (g_ticks % BENCH_DRAIN_TICKS == 0) {
+        benchDrainNet(sc);
+    }
+    t1 = benchNow();
+    serverCoreGameTick(sc);
+    t2 = benchNow();
+    g_ticks++;
+    *scriptNs += t1 - t0;
+    *tickNs   += t2 - t1;
+    if (g_tickTimes != NULL) {
+        g_tickTimes[g_numTickTimes++] = t2 - t1;
+    }
+}
+
+/* ── Reporting ──────────────────────────────────────────────────────────── */
+
+static int benchCompareNs(const void *a, const void *b)
+{
+    unsigned long long x = *(const unsigned long long *) a;
+    unsigned long long y = *(const unsigned long long *) b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/* Tick length below which pct percent of the sorted tick times fall. */
+static double benchTickPercentile(double pct)
+{
+    long i;
+
+    if (g_numTickTimes == 0) {
+        return 0.0;
+    }
+    i = (long) (pct / 100.0 * (double) g_numTickTimes);
+    if (i >= g_numTickTimes) {
+        i = g_numTickTimes - 1;
+    }
+    return (double) g_tickTimes[i];
+}
+
+static unsigned long long benchHashByte(unsigned long long hash, BYTE value)
+{
+    return (hash ^ value) * BENCH_HASH_PRIME;
+}
+
+static unsigned long long benchHashWorld(unsigned long long hash, WORLD value)
+{
+    hash = benchHashByte(hash, (BYTE) (value >> 8));
+    return benchHashByte(hash, (BYTE) (value & 0xFF));
+}
+
+/* Hashes everything the tick simulates.  Only integer state goes in so the
+ * result doesn't depend on how floats are printed or laid out. */
+static unsigned long long benchStateHash(serverCore sc, int numTanks)
+{
+    unsigned long long hash = BENCH_HASH_BASIS;
+    pillbox pill;
+    base    bs;
+    WORLD   wx, wy;
+    BYTE    count, num;
+    int     x, y, i;
+
+    for (y = 0; y < MAP_ARRAY_SIZE; y++) {
+        for (x = 0; x < MAP_ARRAY_SIZE; x++) {
+            hash = benchHashByte(hash, mapGetPos(&sc->mp, (BYTE) x, (BYTE) y));
+        }
+    }
+    num = pillsGetNumPills(&sc->pb);
+    for (count = 1; count <= num; count++) {
+        pillsGetPill(&sc->pb, &pill, count);
+        hash = benchHashByte(hash, pill.x);
+        hash = benchHashByte(hash, pill.y);
+        hash = benchHashByte(hash, pill.owner);
+        hash = benchHashByte(hash, pill.armour);
+    }
+    num = basesGetNumBases(&sc->bs);
+    for (count = 1; count <= num; count++) {
+        basesGetBase(&sc->bs, &bs, count);
+        hash = benchHashByte(hash, bs.owner);
+        hash = benchHashByte(hash, bs.armour);
+        hash = benchHashByte(hash, bs.shells);
+        hash = benchHashByte(hash, bs.mines);
+    }
+    for (i = 0; i < numTanks; i++) {
+        tank *tk = &sc->tk[i];
+        if (*tk == NULL) {
+            continue;
+        }
+        tankGetWorld(tk, &wx, &wy);
+        hash = benchHashWorld(hash, wx);
+        hash = benchHashWorld(hash, wy);
+        hash = benchHashByte(hash, tankGetArmour(tk));
+    }
+    return hash;
+}
+
+static void benchWriteJson(serverCore sc, FILE *fp, const char *mapName, int numTanks,
+                           unsigned long ticks, const unsigned long long *ns,
+                           unsigned long long tickNs, unsigned long long scriptNs,
+                           unsigned long long hash)
+{
+    unsigned long long pairs, nearby;
+    unsigned long long lookups, pillChecks, pairChecks;
+    unsigned long long arenaItems, arenaResets, arenaAllocs;
+    int i;
+    double drains;
+
+    tankGridProfileGet(&pairs, &nearby);
+    serverCoreViewProfileGet(&lookups, &pillChecks, &pairChecks);
+    screenArenaProfileGet(&arenaItems, &arenaResets, &arenaAllocs);
+    drains = g_posDrains > 0 ? (double) g_posDrains : 1.0;
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"map\": \"%s\",\n", mapName);
+    fprintf(fp, "  \"tanks\": %d,\n", numTanks);
+    fprintf(fp, "  \"ticks\": %lu,\n", ticks);
+    fprintf(fp, "  \"math\": \"%s\",\n",
+            utilGetMathBackend() == utilMathFixed ? "fixed" : "double");
+    fprintf(fp, "  \"state_hash\": \"%016llx\",\n", hash);
+    fprintf(fp, "  \"tank_checks_per_tick\": { \"all_pairs\": %.1f, \"grid\": %.1f },\n",
+            (double) pairs / (double) ticks, (double) nearby / (double) ticks);
+    fprintf(fp, "  \"view_checks_per_tick\": { \"lookups\": %.1f, \"matrix_pill_checks\": %.1f, \"scan_pill_checks\": %.1f },\n",
+            (double) lookups / (double) ticks, (double) pillChecks / (double) ticks,
+            (double) pairChecks / (double) ticks);
+    fprintf(fp, "  \"pos_bytes_per_drain\": { \"full\": %.1f, \"delta\": %.1f, \"decode_errors\": %lu },\n",
+            (double) g_posFullBytes / (double) drains, (double) g_posDeltaBytes / (double) drains,
+            g_posErrors);
+    fprintf(fp, "  \"screen_arena\": { \"lists\": %llu, \"arena_items\": %llu, \"heap_allocs\": %llu },\n",
+            arenaResets, arenaItems, arenaAllocs);
+    fprintf(fp, "  \"tick_ns\": { \"p50\": %.0f, \"p99\": %.0f, \"max\": %.0f },\n",
+            benchTickPercentile(50.0), benchTickPercentile(99.0), benchTickPercentile(100.0));
+    if (g_logging == TRUE) {
+        logWriterStats stats;
+        serverCoreGetLogWriterStats(sc, &stats);
+        fprintf(fp, "  \"log_writer\": { \"threaded\": %s, \"flush_ms\": %d, \"writes\": %lu, \"bytes\": %lu, \"passes\": %lu, \"deflates\": %lu, \"high_water\": %lu, \"stalls\": %lu, \"waits\": %lu },\n",
+                g_logSync == TRUE ? "false" : "true", logWriterGetFlushTime(), stats.writes,
+                stats.bytes, stats.passes, stats.deflates, stats.highWater, stats.stalls, stats.waits);
+    }
+    fprintf(fp, "  \"ns_per_tick\": {\n");
+    for (i = 0; i < profileNumItems; i++) {
+        fprintf(fp, "    \"%s\": %.1f,\n", g_sectionNames[i],
+                (double) ns[i] / (double) ticks);
+    }
+    fprintf(fp, "    \"serverCoreGameTick\": %.1f,\n", (double) tickNs / (double) ticks);
+    fprintf(fp, "    \"script\": %.1f\n", (double) scriptNs / (double) ticks);
+    fprintf(fp, "  }\n");
+    fprintf(fp, "}\n");
+}
+
+static void benchWriteTable(serverCore sc, FILE *fp, const char *mapName, int numTanks,
+                            unsigned long ticks, const unsigned long long *ns,
+                            unsigned long long tickNs, unsigned long long scriptNs,
+                            unsigned long long hash)
+{
+    unsigned long long pairs, nearby;
+    unsigned long long lookups, pillChecks, pairChecks;
+    unsigned long long arenaItems, arenaResets, arenaAllocs;
+    double perTick, total;
+    int    i;
+    double drains;
+
+    tankGridProfileGet(&pairs, &nearby);
+    serverCoreViewProfileGet(&lookups, &pillChecks, &pairChecks);
+    screenArenaProfileGet(&arenaItems, &arenaResets, &arenaAllocs);
+    drains = g_posDrains > 0 ? (double) g_posDrains : 1.0;
+
+    total = (double) tickNs / (double) ticks;
+    fprintf(fp, "map: %s   tanks: %d   ticks: %lu\n\n", mapName, numTanks, ticks);
+    fprintf(fp, "%-22s %12s %8s\n", "section", "ns/tick", "% tick");
+    fprintf(fp, "%-22s %12s %8s\n", "----------------------", "------------", "--------");
+    for (i = 0; i < profileNumItems; i++) {
+        perTick = (double) ns[i] / (double) ticks;
+        fprintf(fp, "%-22s %12.1f %7.1f%%\n", g_sectionNames[i], perTick,
+                total > 0.0 ? 100.0 * perTick / total : 0.0);
+    }
+    fprintf(fp, "%-22s %12s %8s\n", "----------------------", "------------", "--------");
+    fprintf(fp, "%-22s %12.1f %7.1f%%\n", "serverCoreGameTick", total, 100.0);
+    fprintf(fp, "%-22s %12.1f\n", "script (not in tick)", (double) scriptNs / (double) ticks);
+    fprintf(fp, "\ntick ns: %.0f median, %.0f 99th percentile, %.0f longest\n",
+            benchTickPercentile(50.0), benchTickPercentile(99.0), benchTickPercentile(100.0));
+    if (g_logging == TRUE) {
+        logWriterStats stats;
+        serverCoreGetLogWriterStats(sc, &stats);
+        if (g_logSync == TRUE) {
+            fprintf(fp, "log: written in the tick, %lu writes, %lu bytes, %lu deflates\n",
+                    stats.writes, stats.bytes, stats.deflates);
+        } else {
+            fprintf(fp, "log: writer thread every %d ms, %lu writes, %lu bytes, %lu passes, %lu deflates\n",
+                    logWriterGetFlushTime(), stats.writes, stats.bytes, stats.passes, stats.deflates);
+            fprintf(fp, "     high water %lu of %d bytes, %lu writes waited for room (%lu waits)\n",
+                    stats.highWater, LOG_WRITER_RING_SIZE, stats.stalls, stats.waits);
+        }
+    }
+    fprintf(fp, "\ntank checks/tick: %.1f all pairs, %.1f after grid\n",
+            (double) pairs / (double) ticks, (double) nearby / (double) ticks);
+    fprintf(fp, "view lookups/tick: %.1f, pill checks/tick: %.1f per-pair scan, %.1f view matrix\n",
+            (double) lookups / (double) ticks, (double) pairChecks / (double) ticks,
+            (double) pillChecks / (double) ticks);
+    fprintf(fp, "position bytes/drain: %.1f full, %.1f delta (%.1f%%), %lu decode errors\n",
+            (double) g_posFullBytes / (double) drains, (double) g_posDeltaBytes / (double) drains,
+            g_posFullBytes > 0 ? 100.0 * (double) g_posDeltaBytes / (double) g_posFullBytes : 0.0,
+            g_posErrors);
+    fprintf(fp, "screen lists: %llu built, %llu arena items, %llu heap allocations\n",
+            arenaResets, arenaItems, arenaAllocs);
+    fprintf(fp, "math: %s   state hash: %016llx\n",
+            utilGetMathBackend() == utilMathFixed ? "fixed" : "double", hash);
+}
+
+/* ── Entry point ────────────────────────────────────────────────────────── */
+
+int main(int argc, char **argv)
+{
+    const char *mapFile  = NULL;
+    const char *logFile  = NULL;
+    const char *jsonFile = NULL;
+    int  numTanks = BENCH_DEFAULT_TANKS;
+    long numTicks = BENCH_DEFAULT_TICKS;
+    long warmup   = BENCH_DEFAULT_WARMUP;
+    unsigned long seed = BENCH_DEFAULT_SEED;
+    char mapName[MAP_STR_SIZE];
+    unsigned long long ns[profileNumItems];
+    unsigned long long scriptNs = 0, tickNs = 0;
+    unsigned long profiled;
+    unsigned long long hash;
+    serverCore sc;
+    long t;
+    int  i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-map") == 0 && i + 1 < argc) {
+            mapFile = argv[++i];
+        } else if (strcmp(argv[i], "-tanks") == 0 && i + 1 < argc) {
+            numTanks = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-ticks") == 0 && i + 1 < argc) {
+            numTicks = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-warmup") == 0 && i + 1 < argc) {
+            warmup = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-math") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "fixed") == 0) {
+                utilSetMathBackend(utilMathFixed);
+            } else if (strcmp(argv[i], "double") == 0) {
+                utilSetMathBackend(utilMathDouble);
+            } else {
+                usage();
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-log") == 0 && i + 1 < argc) {
+            logFile = argv[++i];
+        } else if (strcmp(argv[i], "-logflush") == 0 && i + 1 < argc) {
+            logWriterSetFlushTime(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-logsync") == 0) {
+            g_logSync = TRUE;
+        } else if (strcmp(argv[i], "-json") == 0 && i + 1 < argc) {
+            jsonFile = argv[++i];
+        } else if (strcmp(argv[i], "-players") == 0) {
+            g_players = TRUE;
+        } else if (strcmp(argv[i], "-park") == 0) {
+            g_park = TRUE;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (numTanks < 0 || numTanks > MAX_TANKS || numTicks <= 0 || warmup < 0) {
+        usage();
+        return 1;
+    }
+
+    /* Quiet: core startup chatter would otherwise land in the results */
+    serverCoreSetQuietMode(TRUE);
+    if (threadsCreate(TRUE) == FALSE) {
+        fprintf(stderr, "bolo-bench: unable to start the thread manager\n");
+        return 1;
+    }
+
+    if (mapFile != NULL) {
+        sc = serverCoreCreate((char *) mapFile, gameOpen, FALSE, 0, UNLIMITED_GAME_TIME);
+    } else {
+        BYTE emap[6000] = E_MAP;
+        sc = serverCoreCreateCompressed(emap, BENCH_INBUILT_MAP_LEN, "Everard Island",
+                                        gameOpen, FALSE, 0, UNLIMITED_GAME_TIME);
+    }
+    if (sc == NULL) {
+        fprintf(stderr, "bolo-bench: unable to load map %s\n",
+                mapFile != NULL ? mapFile : "(inbuilt)");
+        threadsDestroy();
+        return 1;
+    }
+    serverCoreGetMapName(sc, mapName);
+    logWriterSetThreaded((bool) (g_logSync == FALSE));
+    if (logFile != NULL) {
+        g_logging = serverCoreStartLog(sc, (char *) logFile, 0, (BYTE) numTanks, FALSE);
+        if (g_logging == FALSE) {
+            fprintf(stderr, "bolo-bench: unable to start log %s\n", logFile);
+        }
+    }
+
+    /* serverCoreCreate seeds rand() from the clock; reseed for repeatability */
+    srand((unsigned int) seed);
+    g_rand = seed;
+    benchSpawnTanks(sc, numTanks);
+
+    for (t = 0; t < warmup; t++) {
+        benchStep(sc, numTanks, &scriptNs, &tickNs);
+    }
+    serverCoreProfileReset();
+    tankGridProfileReset();
+    screenArenaProfileReset();
+    scriptNs = tickNs = 0;
+    g_posDrains = 0;
+    g_posFullBytes = g_posDeltaBytes = 0;
+    g_posErrors = 0;
+    g_tickTimes = malloc(sizeof(*g_tickTimes) * (size_t) numTicks);
+    for (t = 0; t < numTicks; t++) {
+        benchStep(sc, numTanks, &scriptNs, &tickNs);
+    }
+    if (g_tickTimes != NULL) {
+        qsort(g_tickTimes, (size_t) g_numTickTimes, sizeof(*g_tickTimes), benchCompareNs);
+    }
+    profiled = serverCoreProfileGet(ns);
+    if (profiled == 0) {
+        profiled = 1;
+    }
+    hash = benchStateHash(sc, numTanks);
+    /* Stopped before reporting so the writer counters are final */
+    if (g_logging == TRUE) {
+        serverCoreStopLog(sc);
+    }
+
+    benchWriteTable(sc, stdout, mapName, numTanks, profiled, ns, tickNs, scriptNs, hash);
+    if (jsonFile != NULL) {
+        if (strcmp(jsonFile, "-") == 0) {
+            fprintf(stdout, "\n");
+            benchWriteJson(sc, stdout, mapName, numTanks, profiled, ns, tickNs, scriptNs, hash);
+        } else {
+            FILE *fp = fopen(jsonFile, "w");
+            if (fp == NULL) {
+                fprintf(stderr, "bolo-bench: unable to write %s\n", jsonFile);
+            } else {
+                benchWriteJson(sc, fp, mapName, numTanks, profiled, ns, tickNs, scriptNs, hash);
+                fclose(fp);
+            }
+        }
+    }
+
+    free(g_tickTimes);
+    serverCoreDestroy(&sc);
+    for (i = 0; i < MAX_TANKS; i++) {
+        if (g_clientPos[i] != NULL) {
+            posDeltaDestroy(&g_clientPos[i]);
+        }
+    }
+    threadsDestroy();
+    return 0;
+}
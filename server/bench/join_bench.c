@@ -0,0 +1,424 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/*
+ * join_bench.c — join download size and time benchmark (join-bench).
+ *
+ * A joining client used to download its starts, bases, pills and the map
+ * one request at a time, the map in LZW runs of six rows, waiting for each
+ * response before asking for the next: 48 round trips before the time
+ * request.  It now asks once and the server sends a zlib blob of the lot
+ * as a run of chunks without waiting, so a join costs two round trips and
+ * the time to push the blob down the link.
+ *
+ * Both downloads are built from a map loaded into the real server core
+ * with the same calls servernet.c makes, and both are decoded the way
+ * network.c would into a pair of client maps which must match square for
+ * square.  Any difference is printed and the program exits 1.
+ *
+ * Link model
+ * ----------
+ * No sockets are opened.  Each packet is put on a simulated link with a
+ * one way delay of half the round trip time and the given bandwidth in
+ * each direction, plus UDP/IP header bytes.  A request is sent when the
+ * response before it arrives, and packets sent together queue behind each
+ * other on the link.  The table gives the time from the first request to
+ * the time response arriving for each round trip time in -rtt.
+ *
+ * Server cost
+ * -----------
+ * The time the server spends building each download, averaged over
+ * BENCH_BUILD_ROUNDS joins, and how much of it is spent holding the game
+ * mutex.  The map doesn't change between joins so after the first one
+ * the row by row runs are copied from the run cache, all of it under the
+ * mutex.  The blob is copied under the mutex and compressed after it is
+ * let go.  The server sends the last blob again if nothing changed; the
+ * bench compresses every time so the total is the worst case.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "global.h"
+#include "bolo_map.h"
+#include "netjoin.h"
+#include "servercore.h"
+#include "threads.h"
+#include "resource.h"   /* E_MAP — the inbuilt Everard Island map */
+
+/* Compressed length of E_MAP (matches servermain.c) */
+#define BENCH_INBUILT_MAP_LEN 5097
+
+/* Round trip times timed when -rtt isn't given (ms) */
+#define BENCH_DEFAULT_RTTS "10,50,100,200,400"
+#define BENCH_MAX_RTTS 16
+/* Link bandwidth each way (kbit/s) */
+#define BENCH_DEFAULT_KBPS 1000
+/* Joins averaged for the server cost */
+#define BENCH_BUILD_ROUNDS 200
+
+/* Bolo header and the request type byte */
+#define BENCH_REQUEST_SIZE 8
+/* Sequence number and CRC added to every reliable packet */
+#define BENCH_RELIABLE_TAIL 3
+/* IP and UDP headers on every packet */
+#define BENCH_UDP_OVERHEAD 28
+/* Map response y position and data length */
+#define BENCH_MAP_RUN_HEADER 3
+/* Time response data */
+#define BENCH_TIME_DATA 8
+
+/* First and last row of the old map download */
+#define BENCH_MAP_FIRST_RUN 21
+#define BENCH_MAP_LAST_RUN 236
+#define BENCH_MAP_RUN_STEP 5
+
+/* Most requests one download can make */
+#define BENCH_MAX_EXCHANGES 128
+
+/* One request and the packets that answer it */
+typedef struct {
+    int request;                       /* Request bytes */
+    int numPackets;                    /* Response packets */
+    int packet[NET_JOIN_MAX_CHUNKS];   /* Bytes in each */
+} benchExchange;
+
+typedef struct {
+    const char *name;
+    benchExchange exchange[BENCH_MAX_EXCHANGES];
+    int numExchanges;
+    long bytesDown;
+    long bytesUp;
+    int packetsDown;
+} benchDownload;
+
+static benchDownload g_old = { "row by row", { { 0, 0, { 0 } } }, 0, 0, 0, 0 };
+static benchDownload g_new = { "whole blob", { { 0, 0, { 0 } } }, 0, 0, 0, 0 };
+static unsigned long long g_lockedNs;
+static int g_rtts[BENCH_MAX_RTTS];
+static int g_numRtts;
+static double g_kbps = BENCH_DEFAULT_KBPS;
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+
+/* servernet.c reads the server tick count through servermain.c, which
+ * this target doesn't link.  No ticks are run. */
+time_t serverMainGetTicks(void)
+{
+    return 0;
+}
+
+static unsigned long long benchNow(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (unsigned long long) ((double) count.QuadPart * 1000000000.0 /
+                                 (double) freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL +
+           (unsigned long long) ts.tv_nsec;
+#endif
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "Usage: join-bench [-map <file>] [-rtt <ms>[,<ms>...]] [-kbps <n>]\n"
+        "\n"
+        "  -map     Map file to load (default: inbuilt Everard Island)\n"
+        "  -rtt     Round trip times to model in ms (default %s)\n"
+        "  -kbps    Link bandwidth each way in kbit/s (default %d)\n",
+        BENCH_DEFAULT_RTTS, BENCH_DEFAULT_KBPS);
+}
+
+static bool benchParseRtts(const char *list)
+{
+    char *end;
+    long rtt;
+
+    g_numRtts = 0;
+    while (*list != '\0') {
+        rtt = strtol(list, &end, 10);
+        if (end == list || rtt < 0 || g_numRtts == BENCH_MAX_RTTS) {
+            return FALSE;
+        }
+        g_rtts[g_numRtts++] = (int) rtt;
+        list = end;
+        if (*list == ',') {
+            list++;
+        }
+    }
+    return g_numRtts > 0;
+}
+
+/* Records a request and its single response packet. */
+static void benchAddExchange(benchDownload *dl, int request, int response)
+{
+    benchExchange *ex = &dl->exchange[dl->numExchanges++];
+
+    ex->request = request;
+    ex->numPackets = 1;
+    ex->packet[0] = response;
+}
+
+static void benchTotal(benchDownload *dl)
+{
+    int i, j;
+
+    dl->bytesDown = dl->bytesUp = 0;
+    dl->packetsDown = 0;
+    for (i = 0; i < dl->numExchanges; i++) {
+        dl->bytesUp += dl->exchange[i].request + BENCH_UDP_OVERHEAD;
+        for (j = 0; j < dl->exchange[i].numPackets; j++) {
+            dl->bytesDown += dl->exchange[i].packet[j] + BENCH_UDP_OVERHEAD;
+            dl->packetsDown++;
+        }
+    }
+}
+
+/* ── Downloads ──────────────────────────────────────────────────────────── */
+
+/* Builds the old download and decodes it into client. */
+static void benchBuildOld(serverCore sc, map *client, bool record)
+{
+    BYTE buff[MAX_UDPPACKET_SIZE];
+    int len, yPos;
+
+    len = serverCoreGetStartsNetData(sc, buff);
+    if (record == TRUE) {
+        benchAddExchange(&g_old, BENCH_REQUEST_SIZE,
+                         BENCH_REQUEST_SIZE + len + BENCH_RELIABLE_TAIL);
+    }
+    len = serverCoreGetBaseNetData(sc, buff);
+    if (record == TRUE) {
+        benchAddExchange(&g_old, BENCH_REQUEST_SIZE,
+                         BENCH_REQUEST_SIZE + len + BENCH_RELIABLE_TAIL);
+    }
+    len = serverCoreGetPillNetData(sc, buff);
+    if (record == TRUE) {
+        benchAddExchange(&g_old, BENCH_REQUEST_SIZE,
+                         BENCH_REQUEST_SIZE + len + BENCH_RELIABLE_TAIL);
+    }
+    for (yPos = BENCH_MAP_FIRST_RUN; yPos <= BENCH_MAP_LAST_RUN; yPos += BENCH_MAP_RUN_STEP) {
+        len = serverCoreMakeMapNetRun(sc, buff, (BYTE) yPos);
+        if (client != NULL) {
+            mapSetNetRun(client, buff, (BYTE) yPos, len);
+        }
+        if (record == TRUE) {
+            benchAddExchange(&g_old, BENCH_REQUEST_SIZE + 1,
+                             BENCH_REQUEST_SIZE + BENCH_MAP_RUN_HEADER + len + BENCH_RELIABLE_TAIL);
+        }
+    }
+    if (record == TRUE) {
+        benchAddExchange(&g_old, BENCH_REQUEST_SIZE,
+                         BENCH_REQUEST_SIZE + BENCH_TIME_DATA + BENCH_RELIABLE_TAIL);
+    }
+}
+
+/* Builds the new download and decodes it into client. */
+static bool benchBuildNew(serverCore sc, map *client, bool record)
+{
+    static BYTE blob[NET_JOIN_MAX_SIZE];
+    static BYTE raw[NET_JOIN_RAW_SIZE];
+    netJoinData data;
+    benchExchange *ex;
+    unsigned long long start;
+    int len, upto, chunk;
+
+    /* Same split as servernet.c: copy under the mutex, compress after */
+    start = benchNow();
+    len = serverCoreGetJoinData(sc, raw);
+    g_lockedNs += benchNow() - start;
+    len = netJoinPack(raw, len, blob);
+    if (len == 0) {
+        fprintf(stderr, "join-bench: unable to make the join blob\n");
+        return FALSE;
+    }
+    if (client != NULL) {
+        if (netJoinTake(blob, len, raw, &data) == FALSE) {
+            fprintf(stderr, "join-bench: join blob did not unpack\n");
+            return FALSE;
+        }
+        mapSetNetBlock(client, data.mapBlock);
+    }
+    if (record == TRUE) {
+        ex = &g_new.exchange[g_new.numExchanges++];
+        ex->request = BENCH_REQUEST_SIZE;
+        ex->numPackets = 0;
+        for (upto = 0, chunk = 0; upto < len; upto += NET_JOIN_CHUNK_SIZE, chunk++) {
+            ex->packet[chunk] = BENCH_REQUEST_SIZE + NET_JOIN_CHUNK_HEADER + BENCH_RELIABLE_TAIL +
+                                (len - upto < NET_JOIN_CHUNK_SIZE ? len - upto : NET_JOIN_CHUNK_SIZE);
+            ex->numPackets++;
+        }
+        benchAddExchange(&g_new, BENCH_REQUEST_SIZE,
+                         BENCH_REQUEST_SIZE + BENCH_TIME_DATA + BENCH_RELIABLE_TAIL);
+    }
+    return TRUE;
+}
+
+/* ── Link model ─────────────────────────────────────────────────────────── */
+
+/* Milliseconds to put bytes on the link. */
+static double benchWire(int bytes)
+{
+    return (bytes + BENCH_UDP_OVERHEAD) * 8.0 / g_kbps;
+}
+
+/* Time from the first request to the last response arriving (ms). */
+static double benchJoinTime(benchDownload *dl, int rtt)
+{
+    double now = 0.0, linkFree;
+    int i, j;
+
+    for (i = 0; i < dl->numExchanges; i++) {
+        /* Request goes up, then the responses queue down the link */
+        now += benchWire(dl->exchange[i].request) + rtt / 2.0;
+        linkFree = now;
+        for (j = 0; j < dl->exchange[i].numPackets; j++) {
+            linkFree += benchWire(dl->exchange[i].packet[j]);
+        }
+        now = linkFree + rtt / 2.0;
+    }
+    return now;
+}
+
+/* ── Checks ─────────────────────────────────────────────────────────────── */
+
+static bool benchCompareMaps(map *a, map *b)
+{
+    int x, y, bad = 0;
+
+    for (y = MAP_NET_FIRST_ROW; y <= MAP_NET_LAST_ROW; y++) {
+        for (x = MAP_MINE_EDGE_LEFT + 1; x < MAP_MINE_EDGE_RIGHT; x++) {
+            if (mapGetPos(a, (BYTE) x, (BYTE) y) != mapGetPos(b, (BYTE) x, (BYTE) y)) {
+                if (bad < 10) {
+                    fprintf(stderr, "join-bench: square %d,%d: row by row %d, blob %d\n",
+                            x, y, mapGetPos(a, (BYTE) x, (BYTE) y), mapGetPos(b, (BYTE) x, (BYTE) y));
+                }
+                bad++;
+            }
+        }
+    }
+    if (bad > 0) {
+        fprintf(stderr, "join-bench: %d map squares differ\n", bad);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+int main(int argc, char **argv)
+{
+    const char *mapFile = NULL;
+    char mapName[MAP_STR_SIZE];
+    unsigned long long start, oldNs, newNs, newLockedNs;
+    map oldMap, newMap;
+    serverCore sc;
+    bool ok;
+    int i;
+
+    benchParseRtts(BENCH_DEFAULT_RTTS);
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-map") == 0 && i + 1 < argc) {
+            mapFile = argv[++i];
+        } else if (strcmp(argv[i], "-rtt") == 0 && i + 1 < argc) {
+            if (benchParseRtts(argv[++i]) == FALSE) {
+                usage();
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-kbps") == 0 && i + 1 < argc) {
+            g_kbps = atof(argv[++i]);
+            if (g_kbps <= 0.0) {
+                usage();
+                return 1;
+            }
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    serverCoreSetQuietMode(TRUE);
+    if (threadsCreate(TRUE) == FALSE) {
+        fprintf(stderr, "join-bench: unable to start the thread manager\n");
+        return 1;
+    }
+    if (mapFile != NULL) {
+        sc = serverCoreCreate((char *) mapFile, gameOpen, FALSE, 0, UNLIMITED_GAME_TIME);
+    } else {
+        BYTE emap[6000] = E_MAP;
+        sc = serverCoreCreateCompressed(emap, BENCH_INBUILT_MAP_LEN, "Everard Island",
+                                        gameOpen, FALSE, 0, UNLIMITED_GAME_TIME);
+    }
+    if (sc == NULL) {
+        fprintf(stderr, "join-bench: unable to load map %s\n",
+                mapFile != NULL ? mapFile : "(inbuilt)");
+        threadsDestroy();
+        return 1;
+    }
+    serverCoreGetMapName(sc, mapName);
+
+    /* Both downloads must give the client the same map */
+    mapCreate(&oldMap);
+    mapCreate(&newMap);
+    benchBuildOld(sc, &oldMap, TRUE);
+    ok = benchBuildNew(sc, &newMap, TRUE);
+    if (ok == TRUE) {
+        ok = benchCompareMaps(&oldMap, &newMap);
+    }
+    mapDestroy(&oldMap);
+    mapDestroy(&newMap);
+    if (ok == FALSE) {
+        serverCoreDestroy(&sc);
+        threadsDestroy();
+        return 1;
+    }
+    benchTotal(&g_old);
+    benchTotal(&g_new);
+
+    start = benchNow();
+    for (i = 0; i < BENCH_BUILD_ROUNDS; i++) {
+        benchBuildOld(sc, NULL, FALSE);
+    }
+    oldNs = (benchNow() - start) / BENCH_BUILD_ROUNDS;
+    g_lockedNs = 0;
+    start = benchNow();
+    for (i = 0; i < BENCH_BUILD_ROUNDS; i++) {
+        benchBuildNew(sc, NULL, FALSE);
+    }
+    newNs = (benchNow() - start) / BENCH_BUILD_ROUNDS;
+    newLockedNs = g_lockedNs / BENCH_BUILD_ROUNDS;
+
+    printf("map: %s, link %.0f kbit/s each way\n", mapName, g_kbps);
+    printf("maps decoded from both downloads match\n\n");
+    printf("%-12s %10s %10s %10s %10s %14s %14s\n", "download", "requests", "packets",
+           "bytes down", "bytes up", "server us/join", "locked us/join");
+    printf("%-12s %10d %10d %10ld %10ld %14.1f %14.1f\n", g_old.name, g_old.numExchanges,
+           g_old.packetsDown, g_old.bytesDown, g_old.bytesUp, oldNs / 1000.0, oldNs / 1000.0);
+    printf("%-12s %10d %10d %10ld %10ld %14.1f %14.1f\n", g_new.name, g_new.numExchanges,
+           g_new.packetsDown, g_new.bytesDown, g_new.bytesUp, newNs / 1000.0,
+           newLockedNs / 1000.0);
+
+    printf("\n%8s  %14s  %14s  %8s\n", "rtt ms", "row by row ms", "whole blob ms", "speedup");
+    for (i = 0; i < g_numRtts; i++) {
+        double oldMs = benchJoinTime(&g_old, g_rtts[i]);
+        double newMs = benchJoinTime(&g_new, g_rtts[i]);
+        printf("%8d  %14.1f  %14.1f  %7.2fx\n", g_rtts[i], oldMs, newMs, oldMs / newMs);
+    }
+
+    serverCoreDestroy(&sc);
+    threadsDestroy();
+    return 0;
+}
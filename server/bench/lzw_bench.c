@@ -0,0 +1,558 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/*
+ * lzw_bench.c — map codec equivalence check and benchmark (lzw-bench).
+ *
+ * The map codec in src/lzw (run length encoding, whatever the file names
+ * say) used to keep its state in globals.  It now works through an
+ * lzwContext so it can run on any number of threads.  The .map files and
+ * the map download depend on the exact bytes, so this keeps a copy of the
+ * global version and checks the two agree before timing anything.
+ *
+ * Equivalence
+ * -----------
+ * Every net run, the join block and the whole map of the loaded map, then
+ * BENCH_RANDOM_BUFFERS random buffers built from runs and literals of
+ * random lengths.  Both encoders must give the same bytes, both decoders
+ * must give the same data back and it must match the input.  Any mismatch
+ * is printed and the program exits 1 without timing.
+ *
+ * Timing
+ * ------
+ * The old and new codec and the embedded zlib's compress2 at levels 1, 6
+ * and 9 each code every data set until about BENCH_BYTES bytes have been
+ * done.  The table gives the compressed size and MB/s both ways.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "global.h"
+#include "bolo_map.h"
+#include "mapruncache.h"
+#include "servercore.h"
+#include "threads.h"
+#include "resource.h"   /* E_MAP — the inbuilt Everard Island map */
+#include "../lzw/lzw.h"
+#include "../zlib/zlib.h"
+
+/* Compressed length of E_MAP (matches servermain.c) */
+#define BENCH_INBUILT_MAP_LEN 5097
+
+/* Random buffers checked for equivalence */
+#define BENCH_RANDOM_BUFFERS 20000
+/* Longest random buffer */
+#define BENCH_RANDOM_MAX 4000
+/* Bytes each codec codes per data set when timing */
+#define BENCH_BYTES (32 * 1024 * 1024)
+/* Whole map */
+#define BENCH_MAP_SIZE (MAP_ARRAY_SIZE * MAP_ARRAY_SIZE)
+/* Largest compressed buffer from any codec */
+#define BENCH_OUT_SIZE (BENCH_MAP_SIZE * 2)
+
+#define BENCH_DEFAULT_SEED 1
+
+/* Data coded */
+typedef enum {
+    benchSetRun,    /* Every net run one after the other */
+    benchSetBlock,  /* The join block */
+    benchSetMap,    /* The whole map */
+    benchNumSets
+} benchSet;
+
+static const char *g_setNames[benchNumSets] = { "net runs", "join block", "whole map" };
+
+/* Codecs timed */
+typedef enum {
+    benchOld,
+    benchNew,
+    benchZlib1,
+    benchZlib6,
+    benchZlib9,
+    benchNumCodecs
+} benchCodec;
+
+static const char *g_codecNames[benchNumCodecs] = {
+    "rle global", "rle context", "zlib 1", "zlib 6", "zlib 9"
+};
+
+static unsigned long g_rand;
+static BYTE g_runs[MAP_RUN_CACHE_BLOCKS][MAP_NET_RUN_SIZE];
+static int g_numRuns;
+static BYTE g_block[MAP_NET_BLOCK_SIZE];
+static BYTE g_map[BENCH_MAP_SIZE];
+static BYTE g_in[BENCH_MAP_SIZE];
+static BYTE g_out[BENCH_OUT_SIZE];
+static BYTE g_outOld[BENCH_OUT_SIZE];
+static BYTE g_back[BENCH_MAP_SIZE];
+static BYTE g_backOld[BENCH_MAP_SIZE];
+/* Stops the timed loops being optimised away */
+static volatile int g_sink;
+
+/* servernet.c reads the server tick count through servermain.c, which
+ * this target doesn't link.  No ticks are run. */
+time_t serverMainGetTicks(void)
+{
+    return 0;
+}
+
+/* ── Reference ──────────────────────────────────────────────────────────── */
+
+/* The codec from src/lzw before the context struct, state and all. */
+static char *g_refSrc, *g_refDest;
+static int g_refLen, g_refSrcLen, g_refUpto;
+
+static int refEnd(void)
+{
+    return g_refUpto >= g_refSrcLen;
+}
+
+static char refRead(void)
+{
+    g_refUpto++;
+    return g_refSrc[g_refUpto - 1];
+}
+
+static void refWrite(char c)
+{
+    g_refDest[g_refLen] = c;
+    g_refLen++;
+}
+
+static void refWriteArray(char *c, int numBytes)
+{
+    int count = 0;
+    while (count < numBytes) {
+        g_refDest[g_refLen] = c[count];
+        g_refLen++;
+        count++;
+    }
+}
+
+static int refEncode(char *src, char *dest, int len)
+{
+    unsigned char byte1 = 0, byte2, frame_size, array[129];
+
+    g_refSrc = src;
+    g_refDest = dest;
+    g_refLen = 0;
+    g_refUpto = 0;
+    g_refSrcLen = len;
+
+    if (!refEnd()) {
+        byte1 = refRead();
+        frame_size = 1;
+        if (!refEnd()) {
+            byte2 = refRead();
+            frame_size = 2;
+            do {
+                if (byte1 == byte2) {
+                    while ((!refEnd()) && (byte1 == byte2) && (frame_size < 129)) {
+                        byte2 = refRead();
+                        frame_size++;
+                    }
+                    if (byte1 == byte2) {
+                        refWrite((char) (126 + frame_size));
+                        refWrite(byte1);
+                        if (!refEnd()) {
+                            byte1 = refRead();
+                            frame_size = 1;
+                        } else {
+                            frame_size = 0;
+                        }
+                    } else {
+                        refWrite((char) (125 + frame_size));
+                        refWrite(byte1);
+                        byte1 = byte2;
+                        frame_size = 1;
+                    }
+                    if (!refEnd()) {
+                        byte2 = refRead();
+                        frame_size = 2;
+                    }
+                } else {
+                    *array = byte1;
+                    array[1] = byte2;
+                    while ((!refEnd()) && (array[frame_size - 2] != array[frame_size - 1]) &&
+                           (frame_size < 128)) {
+                        array[frame_size] = refRead();
+                        frame_size++;
+                    }
+                    if (array[frame_size - 2] == array[frame_size - 1]) {
+                        refWrite((char) (frame_size - 3));
+                        refWriteArray((char *) array, frame_size - 2);
+                        byte1 = array[frame_size - 2];
+                        byte2 = byte1;
+                        frame_size = 2;
+                    } else {
+                        refWrite((char) (frame_size - 1));
+                        refWriteArray((char *) array, frame_size);
+                        if (refEnd()) {
+                            frame_size = 0;
+                        } else {
+                            byte1 = refRead();
+                            if (refEnd()) {
+                                frame_size = 1;
+                            } else {
+                                byte2 = refRead();
+                                frame_size = 2;
+                            }
+                        }
+                    }
+                }
+            } while ((!refEnd()) || (frame_size >= 2));
+        }
+        if (frame_size == 1) {
+            refWrite(0);
+            refWrite(byte1);
+        }
+    }
+    return g_refLen;
+}
+
+static int refDecode(char *src, char *dest, int len)
+{
+    unsigned char header, i, block[129];
+
+    g_refSrc = src;
+    g_refDest = dest;
+    g_refLen = 0;
+    g_refUpto = 0;
+    g_refSrcLen = len;
+    while (!refEnd()) {
+        header = refRead();
+        switch (header & 128) {
+        case 0:
+            for (i = 0; i <= header; i++) {
+                refWrite(refRead());
+            }
+            break;
+        case 128:
+            memset(block, refRead(), (header & 127) + 2);
+            refWriteArray((char *) block, (header & 127) + 2);
+        }
+    }
+    return g_refLen;
+}
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+
+/* Deterministic across compilers and C runtimes, unlike rand(). */
+static unsigned int benchRand(void)
+{
+    g_rand = g_rand * 1103515245UL + 12345UL;
+    return (unsigned int) ((g_rand >> 16) & 0x7FFF);
+}
+
+static unsigned long long benchNow(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (unsigned long long) ((double) count.QuadPart * 1000000000.0 /
+                                 (double) freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL +
+           (unsigned long long) ts.tv_nsec;
+#endif
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "Usage: lzw-bench [-map <file>] [-seed <s>] [-check]\n"
+        "\n"
+        "  -map     Map file to load (default: inbuilt Everard Island)\n"
+        "  -seed    Random seed for the equivalence buffers (default %d)\n"
+        "  -check   Only run the equivalence check\n",
+        BENCH_DEFAULT_SEED);
+}
+
+/* Codes one buffer with the old and new codec, printing it if they disagree. */
+static bool benchCompare(const char *name, BYTE *buff, int len)
+{
+    lzwContext ctx;
+    int newLen, oldLen, backLen, backOldLen;
+
+    oldLen = refEncode((char *) buff, (char *) g_outOld, len);
+    newLen = lzwEncode(&ctx, (char *) buff, (char *) g_out, len);
+    if (newLen != oldLen || memcmp(g_out, g_outOld, (size_t) newLen) != 0) {
+        fprintf(stderr, "lzw-bench: %s (%d bytes): encoders differ (%d vs %d bytes)\n",
+                name, len, newLen, oldLen);
+        return FALSE;
+    }
+    if (newLen > LZW_MAX_SIZE(len)) {
+        fprintf(stderr, "lzw-bench: %s (%d bytes): %d bytes is over LZW_MAX_SIZE\n",
+                name, len, newLen);
+        return FALSE;
+    }
+    backOldLen = refDecode((char *) g_out, (char *) g_backOld, newLen);
+    backLen = lzwDecode(&ctx, (char *) g_out, (char *) g_back, newLen);
+    if (backLen != len || backOldLen != len || memcmp(g_back, buff, (size_t) len) != 0 ||
+        memcmp(g_backOld, buff, (size_t) len) != 0) {
+        fprintf(stderr, "lzw-bench: %s (%d bytes): decoders gave %d and %d bytes\n",
+                name, len, backLen, backOldLen);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Fills g_in with runs and literals of random lengths. */
+static int benchRandomBuffer(void)
+{
+    int len, upto, n;
+    BYTE value;
+
+    len = (int) (benchRand() % BENCH_RANDOM_MAX);
+    upto = 0;
+    while (upto < len) {
+        n = 1 + (int) (benchRand() % (benchRand() % 4 == 0 ? 300 : 4));
+        value = (BYTE) (benchRand() % (benchRand() % 2 == 0 ? 16 : 256));
+        if (benchRand() % 2 == 0) {
+            while (n-- > 0 && upto < len) {
+                g_in[upto++] = value;
+            }
+        } else {
+            while (n-- > 0 && upto < len) {
+                g_in[upto++] = (BYTE) benchRand();
+            }
+        }
+    }
+    return len;
+}
+
+/* ── Data ───────────────────────────────────────────────────────────────── */
+
+static void benchLoadData(serverCore sc)
+{
+    int yPos, x;
+
+    g_numRuns = 0;
+    for (yPos = MAP_NET_FIRST_ROW; yPos + MAP_NET_RUN_ROWS - 1 <= MAP_NET_LAST_ROW;
+         yPos += MAP_NET_RUN_STEP) {
+        mapCopyNetRun(&sc->mp, g_runs[g_numRuns], (BYTE) yPos);
+        g_numRuns++;
+    }
+    mapMakeNetBlock(&sc->mp, g_block);
+    for (x = 0; x < MAP_ARRAY_SIZE; x++) {
+        memcpy(g_map + x * MAP_ARRAY_SIZE, sc->mp->mapItem[x], MAP_ARRAY_SIZE);
+    }
+}
+
+/* ── Equivalence ────────────────────────────────────────────────────────── */
+
+static bool benchCheck(void)
+{
+    char name[32];
+    int i, len;
+
+    for (i = 0; i < g_numRuns; i++) {
+        sprintf(name, "run %d", i);
+        if (benchCompare(name, g_runs[i], MAP_NET_RUN_SIZE) == FALSE) {
+            return FALSE;
+        }
+    }
+    if (benchCompare("join block", g_block, MAP_NET_BLOCK_SIZE) == FALSE ||
+        benchCompare("whole map", g_map, BENCH_MAP_SIZE) == FALSE) {
+        return FALSE;
+    }
+    for (i = 0; i < BENCH_RANDOM_BUFFERS; i++) {
+        len = benchRandomBuffer();
+        sprintf(name, "random %d", i);
+        if (benchCompare(name, g_in, len) == FALSE) {
+            return FALSE;
+        }
+    }
+    printf("equivalence: %d net runs, join block, whole map and %d random buffers match\n",
+           g_numRuns, BENCH_RANDOM_BUFFERS);
+    return TRUE;
+}
+
+/* ── Timing ─────────────────────────────────────────────────────────────── */
+
+static int benchEncode(benchCodec codec, BYTE *src, int len, BYTE *dest)
+{
+    lzwContext ctx;
+    uLongf destLen = BENCH_OUT_SIZE;
+
+    switch (codec) {
+    case benchOld:
+        return refEncode((char *) src, (char *) dest, len);
+    case benchNew:
+        return lzwEncode(&ctx, (char *) src, (char *) dest, len);
+    case benchZlib1:
+        compress2(dest, &destLen, src, (uLong) len, 1);
+        return (int) destLen;
+    case benchZlib6:
+        compress2(dest, &destLen, src, (uLong) len, 6);
+        return (int) destLen;
+    default:
+        compress2(dest, &destLen, src, (uLong) len, 9);
+        return (int) destLen;
+    }
+}
+
+static int benchDecode(benchCodec codec, BYTE *src, int len, BYTE *dest)
+{
+    lzwContext ctx;
+    uLongf destLen = BENCH_MAP_SIZE;
+
+    switch (codec) {
+    case benchOld:
+        return refDecode((char *) src, (char *) dest, len);
+    case benchNew:
+        return lzwDecode(&ctx, (char *) src, (char *) dest, len);
+    default:
+        uncompress(dest, &destLen, src, (uLong) len);
+        return (int) destLen;
+    }
+}
+
+/* Codes every piece of a data set rounds times. Returns ns per data set. */
+static double benchTime(benchCodec codec, benchSet set, bool encode, long rounds,
+                        int *packed)
+{
+    static BYTE packedRuns[MAP_RUN_CACHE_BLOCKS][LZW_MAX_SIZE(MAP_NET_RUN_SIZE) + 64];
+    static int packedRunLen[MAP_RUN_CACHE_BLOCKS];
+    unsigned long long start;
+    int sum = 0, i, len;
+    long r;
+
+    /* Pack once so decoding has something to work on */
+    *packed = 0;
+    if (set == benchSetRun) {
+        for (i = 0; i < g_numRuns; i++) {
+            packedRunLen[i] = benchEncode(codec, g_runs[i], MAP_NET_RUN_SIZE, packedRuns[i]);
+            *packed += packedRunLen[i];
+        }
+    } else if (set == benchSetBlock) {
+        *packed = benchEncode(codec, g_block, MAP_NET_BLOCK_SIZE, g_out);
+    } else {
+        *packed = benchEncode(codec, g_map, BENCH_MAP_SIZE, g_out);
+    }
+
+    start = benchNow();
+    for (r = 0; r < rounds; r++) {
+        if (set == benchSetRun) {
+            for (i = 0; i < g_numRuns; i++) {
+                if (encode == TRUE) {
+                    len = benchEncode(codec, g_runs[i], MAP_NET_RUN_SIZE, g_outOld);
+                } else {
+                    len = benchDecode(codec, packedRuns[i], packedRunLen[i], g_back);
+                }
+                sum += len;
+            }
+        } else if (set == benchSetBlock) {
+            if (encode == TRUE) {
+                sum += benchEncode(codec, g_block, MAP_NET_BLOCK_SIZE, g_outOld);
+            } else {
+                sum += benchDecode(codec, g_out, *packed, g_back);
+            }
+        } else {
+            if (encode == TRUE) {
+                sum += benchEncode(codec, g_map, BENCH_MAP_SIZE, g_outOld);
+            } else {
+                sum += benchDecode(codec, g_out, *packed, g_back);
+            }
+        }
+    }
+    g_sink = sum;
+    return (double) (benchNow() - start) / (double) rounds;
+}
+
+static void benchTiming(void)
+{
+    int setSize[benchNumSets];
+    double encNs, decNs;
+    long rounds;
+    int packed;
+    int set, codec;
+
+    setSize[benchSetRun] = g_numRuns * MAP_NET_RUN_SIZE;
+    setSize[benchSetBlock] = MAP_NET_BLOCK_SIZE;
+    setSize[benchSetMap] = BENCH_MAP_SIZE;
+
+    for (set = 0; set < benchNumSets; set++) {
+        rounds = BENCH_BYTES / setSize[set];
+        printf("\n%s: %d bytes%s\n", g_setNames[set], setSize[set],
+               set == benchSetRun ? " (each run coded on its own)" : "");
+        printf("%-12s  %10s %7s  %12s  %12s\n", "codec", "bytes", "ratio",
+               "encode MB/s", "decode MB/s");
+        for (codec = 0; codec < benchNumCodecs; codec++) {
+            encNs = benchTime((benchCodec) codec, (benchSet) set, TRUE, rounds, &packed);
+            decNs = benchTime((benchCodec) codec, (benchSet) set, FALSE, rounds, &packed);
+            printf("%-12s  %10d %6.1f%%  %12.1f  %12.1f\n", g_codecNames[codec], packed,
+                   packed * 100.0 / setSize[set], setSize[set] * 1000.0 / encNs,
+                   setSize[set] * 1000.0 / decNs);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *mapFile = NULL;
+    char mapName[MAP_STR_SIZE];
+    unsigned long seed = BENCH_DEFAULT_SEED;
+    bool checkOnly = FALSE;
+    serverCore sc;
+    bool ok;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-map") == 0 && i + 1 < argc) {
+            mapFile = argv[++i];
+        } else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-check") == 0) {
+            checkOnly = TRUE;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    g_rand = seed;
+
+    serverCoreSetQuietMode(TRUE);
+    if (threadsCreate(TRUE) == FALSE) {
+        fprintf(stderr, "lzw-bench: unable to start the thread manager\n");
+        return 1;
+    }
+    if (mapFile != NULL) {
+        sc = serverCoreCreate((char *) mapFile, gameOpen, FALSE, 0, UNLIMITED_GAME_TIME);
+    } else {
+        BYTE emap[6000] = E_MAP;
+        sc = serverCoreCreateCompressed(emap, BENCH_INBUILT_MAP_LEN, "Everard Island",
+                                        gameOpen, FALSE, 0, UNLIMITED_GAME_TIME);
+    }
+    if (sc == NULL) {
+        fprintf(stderr, "lzw-bench: unable to load map %s\n",
+                mapFile != NULL ? mapFile : "(inbuilt)");
+        threadsDestroy();
+        return 1;
+    }
+    serverCoreGetMapName(sc, mapName);
+    printf("map: %s\n", mapName);
+    benchLoadData(sc);
+
+    ok = benchCheck();
+    if (ok == TRUE && checkOnly == FALSE) {
+        benchTiming();
+    }
+
+    serverCoreDestroy(&sc);
+    threadsDestroy();
+    return ok == TRUE ? 0 : 1;
+}
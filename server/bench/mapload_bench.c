@@ -0,0 +1,760 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/*
+ * mapload_bench.c — map loading equivalence check and benchmark
+ * (mapload-bench).
+ *
+ * mapRead used to read .map files through stdio and decode each run with
+ * a nibble state machine fed by fgetc.  It now maps the file into memory
+ * and decodes in place, and with mapFileSetCache on it keeps a .bmc file
+ * beside each map holding the tables and the decoded terrain, which later
+ * loads copy straight in.  This keeps a copy of the stdio loader and
+ * checks all three give the same map before timing anything.
+ *
+ * Maps
+ * ----
+ * Every .map in -dir.  Without -dir the inbuilt Everard Island is written
+ * out BENCH_DEFAULT_MAPS times to a scratch directory, which is removed
+ * afterwards.  The .bmc files the benchmark writes are always removed.
+ *
+ * Equivalence
+ * -----------
+ * Each map is loaded by the stdio loader, by mapRead with the cache off,
+ * by mapRead with the cache on (which writes the cache) and by
+ * mapFileReadCache.  Whether the load worked, the terrain and the whole
+ * pill, base and start structures must match.  The first cache is then
+ * damaged - one terrain byte changed, then cut short - and must be
+ * refused both times.  Any failure is printed and the program exits 1 without timing.
+ *
+ * Timing
+ * ------
+ * Each loader loads every map -rounds times.  The table gives the total,
+ * the time per map and the speed up over stdio.  The stdio loader makes a
+ * new map to centre into as it always did; mapRead centres in place and
+ * the cache is stored centred.  A cache hit still checksums and range
+ * checks all 64K of terrain, so for a map as small as Everard Island it
+ * loses to decoding the runs in place.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#include "global.h"
+#include "bolo_map.h"
+#include "mapfile.h"
+#include "pillbox.h"
+#include "bases.h"
+#include "starts.h"
+#include "resource.h"   /* E_MAP — the inbuilt Everard Island map */
+
+/* Compressed length of E_MAP (matches servermain.c) */
+#define BENCH_INBUILT_MAP_LEN 5097
+
+/* Copies of the inbuilt map loaded when -dir isn't given */
+#define BENCH_DEFAULT_MAPS 200
+#define BENCH_DEFAULT_ROUNDS 5
+#define BENCH_SCRATCH_DIR "mapload-bench.tmp"
+/* Most maps loaded from -dir */
+#define BENCH_MAX_MAPS 10000
+
+/* Loaders timed */
+typedef enum {
+    benchStdio,
+    benchMapped,
+    benchCache,
+    benchNumLoaders
+} benchLoader;
+
+static const char *g_loaderNames[benchNumLoaders] = { "stdio", "mmap", "cache" };
+
+/* What a load left behind */
+typedef struct {
+    bool ok;
+    BYTE terrain[MAP_ARRAY_SIZE][MAP_ARRAY_SIZE];
+    struct pillsObj pills;
+    struct basesObj bases;
+    struct startsObj starts;
+} benchResult;
+
+static char **g_names;
+static int g_numMaps;
+static map g_mp;
+static pillboxes g_pb;
+static bases g_bs;
+static starts g_ss;
+static benchResult g_want, g_got;
+
+/* servernet.c reads the server tick count through servermain.c, which
+ * this target doesn't link.  No ticks are run. */
+time_t serverMainGetTicks(void)
+{
+    return 0;
+}
+
+/* ── Reference ──────────────────────────────────────────────────────────── */
+
+/* mapRead and mapCenter from bolo_map.c before the file was mapped, stdio
+ * and all. */
+static bool refReadPills(FILE *fp, pillboxes *value)
+{
+    int total, count = 1;
+    bool returnValue = TRUE;
+    pillbox readInto;
+
+    total = pillsGetNumPills(value);
+    readInto.inTank = FALSE;
+    while (count <= total && returnValue == TRUE && !feof(fp)) {
+        if (fread(&readInto, SIZEOFBMAP_PILL_INFO, 1, fp) != 1) {
+            returnValue = FALSE;
+        } else {
+            readInto.justSeen = FALSE;
+            pillsSetPill(value, &readInto, (BYTE) count);
+        }
+        count++;
+    }
+    return returnValue;
+}
+
+static bool refReadBases(FILE *fp, bases *value)
+{
+    int total, count = 1;
+    bool returnValue = TRUE;
+    base readInto;
+
+    total = basesGetNumBases(value);
+    while (count <= total && returnValue == TRUE && !feof(fp)) {
+        if (fread(&readInto, SIZEOFBAMP_BASE_INFO, 1, fp) != 1) {
+            returnValue = FALSE;
+        } else {
+            readInto.baseTime = 0;
+            basesSetBase(value, &readInto, (BYTE) count);
+        }
+        count++;
+    }
+    return returnValue;
+}
+
+static bool refReadStarts(FILE *fp, starts *value)
+{
+    int total, count = 1;
+    bool returnValue = TRUE;
+    start readInto;
+
+    total = startsGetNumStarts(value);
+    while (count <= total && returnValue == TRUE && !feof(fp)) {
+        if (fread(&readInto, SIZEOFBMAP_START_INFO, 1, fp) != 1) {
+            returnValue = FALSE;
+        } else {
+            startsSetStart(value, &readInto, (BYTE) count);
+        }
+        count++;
+    }
+    return returnValue;
+}
+
+typedef enum { highLen, lowLen, highDiff, lowDiff, highSame, lowSame } refRunState;
+
+static bool refProcessRun(FILE *fp, map *value, BYTE elems, MAP_Y yValue, BYTE startX, BYTE endX)
+{
+    bool needRead;
+    refRunState state = highLen;
+    BYTE item, highNibble, lowNibble, len = 0, mapPos = startX;
+    int count = 0, count2;
+
+    item = (BYTE) fgetc(fp);
+    while (count < elems && !ferror(fp)) {
+        needRead = FALSE;
+        highNibble = (BYTE) (item >> MAP_SHIFT_SIZE);
+        lowNibble = (BYTE) (item & 0x0F);
+        while (needRead == FALSE) {
+            switch (state) {
+            case highLen:
+                len = highNibble;
+                if (len < MAP_RUN_DIFF) {
+                    state = lowDiff;
+                    len++;
+                } else {
+                    state = lowSame;
+                }
+                break;
+            case lowLen:
+                len = lowNibble;
+                if (len < MAP_RUN_DIFF) {
+                    state = highDiff;
+                    len++;
+                } else {
+                    state = highSame;
+                }
+                needRead = TRUE;
+                break;
+            case lowDiff:
+                (*value)->mapItem[mapPos][yValue] = lowNibble;
+                mapPos++;
+                len--;
+                state = (len == 0) ? highLen : highDiff;
+                needRead = TRUE;
+                break;
+            case highDiff:
+                (*value)->mapItem[mapPos][yValue] = highNibble;
+                mapPos++;
+                len--;
+                state = (len == 0) ? lowLen : lowDiff;
+                break;
+            case lowSame:
+                for (count2 = 0; count2 < len - MAP_RUN_SAME; count2++) {
+                    (*value)->mapItem[mapPos + count2][yValue] = lowNibble;
+                }
+                mapPos = (BYTE) (mapPos + count2);
+                state = highLen;
+                needRead = TRUE;
+                break;
+            case highSame:
+                for (count2 = 0; count2 < len - MAP_RUN_SAME; count2++) {
+                    (*value)->mapItem[mapPos + count2][yValue] = highNibble;
+                }
+                mapPos = (BYTE) (mapPos + count2);
+                state = lowLen;
+                break;
+            }
+        }
+        count++;
+        item = (BYTE) fgetc(fp);
+    }
+    count2 = ungetc(item, fp);
+    return (bool) (count == elems && mapPos == endX && count2 != EOF);
+}
+
+static bool refReadRuns(FILE *fp, map *value)
+{
+    bmapRunHeader runHead;
+    size_t bytesRead;
+    bool returnValue = TRUE, done = FALSE;
+
+    bytesRead = fread(&runHead, SIZEOFBMAP_RUN_HEADER, 1, fp);
+    while (!feof(fp) && done == FALSE) {
+        if (bytesRead != 1) {
+            done = TRUE;
+            returnValue = FALSE;
+        } else if (runHead.datalen == 4 && runHead.y == MAP_ARRAY_LAST &&
+                   runHead.startx == MAP_ARRAY_LAST && runHead.endx == MAP_ARRAY_LAST) {
+            done = TRUE;
+        } else if (refProcessRun(fp, value, (BYTE) (runHead.datalen - SIZEOFBMAP_RUN_HEADER),
+                                 runHead.y, runHead.startx, runHead.endx) == FALSE) {
+            done = TRUE;
+            returnValue = FALSE;
+        }
+        bytesRead = fread(&runHead, SIZEOFBMAP_RUN_HEADER, 1, fp);
+    }
+    return returnValue;
+}
+
+static void refCenter(map *value, pillboxes *pb, bases *bs, starts *ss)
+{
+    int bestLeft = MAP_ARRAY_SIZE, bestRight = -1, bestTop = MAP_ARRAY_SIZE, bestBottom = -1;
+    int guessLeft, guessRight, guessTop, guessBottom;
+    int addX, addY, count1, count2, i;
+    map map2;
+
+    for (i = 0; i < 3; i++) {
+        if (i == 0) {
+            pillsGetMaxs(pb, &guessLeft, &guessRight, &guessTop, &guessBottom);
+        } else if (i == 1) {
+            basesGetMaxs(bs, &guessLeft, &guessRight, &guessTop, &guessBottom);
+        } else {
+            startsGetMaxs(ss, &guessLeft, &guessRight, &guessTop, &guessBottom);
+        }
+        /* Right and bottom really are compared with < */
+        if (guessLeft < bestLeft) {
+            bestLeft = guessLeft;
+        }
+        if (guessRight < bestRight) {
+            bestRight = guessRight;
+        }
+        if (guessTop < bestTop) {
+            bestTop = guessTop;
+        }
+        if (guessBottom < bestBottom) {
+            bestBottom = guessBottom;
+        }
+    }
+    for (count1 = 0; count1 <= MAP_ARRAY_LAST; count1++) {
+        for (count2 = 0; count2 <= MAP_ARRAY_LAST; count2++) {
+            if ((*value)->mapItem[count1][count2] != DEEP_SEA) {
+                if (count1 < bestLeft) {
+                    bestLeft = count1;
+                }
+                if (count1 > bestRight) {
+                    bestRight = count1;
+                }
+                if (count2 < bestTop) {
+                    bestTop = count2;
+                }
+                if (count2 > bestBottom) {
+                    bestBottom = count2;
+                }
+            }
+        }
+    }
+    if (bestTop <= bestBottom && bestLeft <= bestRight) {
+        addX = (255 / 2) - ((bestLeft + bestRight) / 2) - 1;
+        addY = (255 / 2) - ((bestTop + bestBottom) / 2) - 1;
+        if (addX != 0 && addY != 0) {
+            mapCreate(&map2);
+            for (count1 = bestLeft; count1 <= (BYTE) bestRight; count1++) {
+                for (count2 = bestTop; count2 <= (BYTE) bestBottom; count2++) {
+                    map2->mapItem[(BYTE) (count1 + addX)][(BYTE) (count2 + addY)] =
+                        (*value)->mapItem[count1][count2];
+                }
+            }
+            pillsMoveAll(pb, addX, addY);
+            basesMoveAll(bs, addX, addY);
+            startsMoveAll(ss, addX, addY);
+            mapDestroy(value);
+            *value = map2;
+        }
+    }
+}
+
+static bool refRead(char *fileName, map *value, pillboxes *pb, bases *bs, starts *ss)
+{
+    FILE *fp;
+    bool returnValue = TRUE;
+    char id[LENGTH_ID + 1];
+
+    fp = fopen(fileName, "rb");
+    if (fp == NULL) {
+        return FALSE;
+    }
+    if (fgets(id, LENGTH_ID + 1, fp) == NULL || strcmp(id, MAP_HEADER) != 0) {
+        returnValue = FALSE;
+    }
+    if (returnValue == TRUE && (BYTE) fgetc(fp) != CURRENT_MAP_VERSION) {
+        returnValue = FALSE;
+    }
+    if (returnValue == TRUE) {
+        pillsSetNumPills(pb, (BYTE) fgetc(fp));
+        basesSetNumBases(bs, (BYTE) fgetc(fp));
+        startsSetNumStarts(ss, (BYTE) fgetc(fp));
+        if (pillsGetNumPills(pb) > MAX_PILLS || basesGetNumBases(bs) > MAX_BASES ||
+            startsGetNumStarts(ss) > MAX_STARTS) {
+            returnValue = FALSE;
+        }
+    }
+    if (returnValue == TRUE) {
+        returnValue = refReadPills(fp, pb);
+    }
+    if (returnValue == TRUE) {
+        returnValue = refReadBases(fp, bs);
+    }
+    if (returnValue == TRUE) {
+        returnValue = refReadStarts(fp, ss);
+    }
+    if (returnValue == TRUE) {
+        returnValue = refReadRuns(fp, value);
+    }
+    if (returnValue == TRUE) {
+        refCenter(value, pb, bs, ss);
+    }
+    fclose(fp);
+    return returnValue;
+}
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+
+static unsigned long long benchNow(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (unsigned long long) ((double) count.QuadPart * 1000000000.0 /
+                                 (double) freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL +
+           (unsigned long long) ts.tv_nsec;
+#endif
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "Usage: mapload-bench [-dir <maps>] [-rounds <n>] [-check]\n"
+        "\n"
+        "  -dir     Directory of .map files (default: %d copies of the inbuilt\n"
+        "           Everard Island in ./%s)\n"
+        "  -rounds  Times each map is loaded by each loader (default %d)\n"
+        "  -check   Only run the equivalence check\n",
+        BENCH_DEFAULT_MAPS, BENCH_SCRATCH_DIR, BENCH_DEFAULT_ROUNDS);
+}
+
+static void benchMakeDir(const char *dir)
+{
+#ifdef _WIN32
+    _mkdir(dir);
+#else
+    mkdir(dir, 0755);
+#endif
+}
+
+static char *benchJoin(const char *dir, const char *name)
+{
+    char *path = malloc(strlen(dir) + strlen(name) + 2);
+    sprintf(path, "%s/%s", dir, name);
+    return path;
+}
+
+static void benchAddMap(char *path)
+{
+    if (g_numMaps < BENCH_MAX_MAPS) {
+        g_names[g_numMaps++] = path;
+    } else {
+        free(path);
+    }
+}
+
+/* Every .map in dir. */
+static void benchListMaps(const char *dir)
+{
+    size_t len;
+#ifdef _WIN32
+    WIN32_FIND_DATAA fd;
+    HANDLE find;
+    char *pattern = benchJoin(dir, "*.map");
+
+    find = FindFirstFileA(pattern, &fd);
+    free(pattern);
+    if (find == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    do {
+        len = strlen(fd.cFileName);
+        if (len > 4 && strcmp(fd.cFileName + len - 4, ".map") == 0) {
+            benchAddMap(benchJoin(dir, fd.cFileName));
+        }
+    } while (FindNextFileA(find, &fd));
+    FindClose(find);
+#else
+    DIR *d;
+    struct dirent *ent;
+
+    d = opendir(dir);
+    if (d == NULL) {
+        return;
+    }
+    while ((ent = readdir(d)) != NULL) {
+        len = strlen(ent->d_name);
+        if (len > 4 && strcmp(ent->d_name + len - 4, ".map") == 0) {
+            benchAddMap(benchJoin(dir, ent->d_name));
+        }
+    }
+    closedir(d);
+#endif
+}
+
+/* Writes the inbuilt map out BENCH_DEFAULT_MAPS times. */
+static bool benchWriteInbuilt(void)
+{
+    BYTE emap[6000] = E_MAP;
+    char name[32];
+    char *path;
+    int i;
+
+    if (mapLoadCompressedMap(&g_mp, &g_pb, &g_bs, &g_ss, emap, BENCH_INBUILT_MAP_LEN) == FALSE) {
+        return FALSE;
+    }
+    benchMakeDir(BENCH_SCRATCH_DIR);
+    for (i = 0; i < BENCH_DEFAULT_MAPS; i++) {
+        sprintf(name, "everard%03d.map", i);
+        path = benchJoin(BENCH_SCRATCH_DIR, name);
+        if (mapWrite(path, &g_mp, &g_pb, &g_bs, &g_ss) == FALSE) {
+            free(path);
+            return FALSE;
+        }
+        benchAddMap(path);
+    }
+    return TRUE;
+}
+
+static void benchRemoveCache(char *fileName)
+{
+    char cacheName[FILENAME_MAX];
+
+    if (mapFileCacheName(fileName, cacheName) == TRUE) {
+        remove(cacheName);
+    }
+}
+
+/* Fresh structures, as a server or client would have before a load. */
+static void benchReset(void)
+{
+    mapDestroy(&g_mp);
+    pillsDestroy(&g_pb);
+    basesDestroy(&g_bs);
+    startsDestroy(&g_ss);
+    mapCreate(&g_mp);
+    pillsCreate(&g_pb);
+    basesCreate(&g_bs);
+    startsCreate(&g_ss);
+}
+
+static bool benchLoad(benchLoader loader, char *fileName)
+{
+    switch (loader) {
+    case benchStdio:
+        return refRead(fileName, &g_mp, &g_pb, &g_bs, &g_ss);
+    case benchMapped:
+        return mapRead(fileName, &g_mp, &g_pb, &g_bs, &g_ss);
+    default:
+        return mapFileReadCache(fileName, &g_mp, &g_pb, &g_bs, &g_ss);
+    }
+}
+
+static void benchSnapshot(bool ok, benchResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->ok = ok;
+    if (ok == TRUE) {
+        memcpy(res->terrain, g_mp->mapItem, sizeof(res->terrain));
+        res->pills = *g_pb;
+        res->bases = *g_bs;
+        res->starts = *g_ss;
+    }
+}
+
+static bool benchSame(const char *fileName, const char *how)
+{
+    if (memcmp(&g_want, &g_got, sizeof(g_want)) != 0) {
+        fprintf(stderr, "mapload-bench: %s: %s load differs from stdio (ok %d vs %d)\n",
+                fileName, how, g_got.ok, g_want.ok);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* ── Equivalence ────────────────────────────────────────────────────────── */
+
+/* Damages the cache at offset (or cuts it there) and checks it's refused. */
+static bool benchDamage(char *fileName, long offset, bool cut)
+{
+    char cacheName[FILENAME_MAX];
+    BYTE *data;
+    long len;
+    FILE *fp;
+    bool refused;
+
+    mapFileCacheName(fileName, cacheName);
+    fp = fopen(cacheName, "rb");
+    if (fp == NULL) {
+        fprintf(stderr, "mapload-bench: %s: no cache written\n", fileName);
+        return FALSE;
+    }
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    data = malloc((size_t) len);
+    if (fread(data, (size_t) len, 1, fp) != 1) {
+        len = 0;
+    }
+    fclose(fp);
+    if (offset >= len) {
+        free(data);
+        return FALSE;
+    }
+    if (cut == FALSE) {
+        data[offset] ^= 0x01;
+    } else {
+        len = offset;
+    }
+    fp = fopen(cacheName, "wb");
+    fwrite(data, (size_t) len, 1, fp);
+    fclose(fp);
+    free(data);
+
+    benchReset();
+    refused = (bool) (mapFileReadCache(fileName, &g_mp, &g_pb, &g_bs, &g_ss) == FALSE);
+    if (refused == FALSE) {
+        fprintf(stderr, "mapload-bench: %s: %s cache was used\n", fileName,
+                cut == TRUE ? "truncated" : "damaged");
+    }
+    return refused;
+}
+
+static bool benchCheck(void)
+{
+    int firstGood = -1;
+    int i;
+    bool ok;
+
+    for (i = 0; i < g_numMaps; i++) {
+        benchRemoveCache(g_names[i]);
+        benchReset();
+        benchSnapshot(refRead(g_names[i], &g_mp, &g_pb, &g_bs, &g_ss), &g_want);
+
+        mapFileSetCache(FALSE);
+        benchReset();
+        benchSnapshot(mapRead(g_names[i], &g_mp, &g_pb, &g_bs, &g_ss), &g_got);
+        if (benchSame(g_names[i], "mmap") == FALSE) {
+            return FALSE;
+        }
+
+        mapFileSetCache(TRUE);
+        benchReset();
+        benchSnapshot(mapRead(g_names[i], &g_mp, &g_pb, &g_bs, &g_ss), &g_got);
+        mapFileSetCache(FALSE);
+        if (benchSame(g_names[i], "first cached") == FALSE) {
+            return FALSE;
+        }
+        if (g_want.ok == FALSE) {
+            continue;
+        }
+
+        benchReset();
+        ok = mapFileReadCache(g_names[i], &g_mp, &g_pb, &g_bs, &g_ss);
+        benchSnapshot(ok, &g_got);
+        if (ok == FALSE) {
+            fprintf(stderr, "mapload-bench: %s: cache was not written or was refused\n",
+                    g_names[i]);
+            return FALSE;
+        }
+        if (benchSame(g_names[i], "cache") == FALSE) {
+            return FALSE;
+        }
+        if (firstGood < 0) {
+            firstGood = i;
+        }
+    }
+
+    /* Damage one cache then write it again for the timing */
+    if (firstGood >= 0) {
+        if (benchDamage(g_names[firstGood], MAP_CACHE_HEADER_SIZE + 300 + MAP_CACHE_TERRAIN_SIZE / 2, FALSE) == FALSE ||
+            benchDamage(g_names[firstGood], MAP_CACHE_HEADER_SIZE + 100, TRUE) == FALSE) {
+            return FALSE;
+        }
+        benchReset();
+        mapFileSetCache(TRUE);
+        mapRead(g_names[firstGood], &g_mp, &g_pb, &g_bs, &g_ss);
+        mapFileSetCache(FALSE);
+    }
+
+    printf("equivalence: %d maps load the same through stdio, mmap and the cache;"
+           " damaged caches refused\n", g_numMaps);
+    return TRUE;
+}
+
+/* ── Timing ─────────────────────────────────────────────────────────────── */
+
+static void benchTiming(int rounds)
+{
+    double ns[benchNumLoaders];
+    unsigned long long start;
+    int loader, r, i;
+
+    for (loader = 0; loader < benchNumLoaders; loader++) {
+        start = benchNow();
+        for (r = 0; r < rounds; r++) {
+            for (i = 0; i < g_numMaps; i++) {
+                /* Just the terrain. A fresh map would time malloc too */
+                memset(g_mp->mapItem, DEEP_SEA, sizeof(g_mp->mapItem));
+                benchLoad((benchLoader) loader, g_names[i]);
+            }
+        }
+        ns[loader] = (double) (benchNow() - start);
+    }
+
+    printf("\n%d maps x %d rounds\n", g_numMaps, rounds);
+    printf("%-8s  %10s  %10s  %8s\n", "loader", "total ms", "us/map", "speedup");
+    for (loader = 0; loader < benchNumLoaders; loader++) {
+        printf("%-8s  %10.1f  %10.1f  %7.2fx\n", g_loaderNames[loader], ns[loader] / 1e6,
+               ns[loader] / 1e3 / ((double) g_numMaps * rounds), ns[benchStdio] / ns[loader]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = NULL;
+    int rounds = BENCH_DEFAULT_ROUNDS;
+    bool checkOnly = FALSE;
+    bool ok;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-dir") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (strcmp(argv[i], "-rounds") == 0 && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-check") == 0) {
+            checkOnly = TRUE;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (rounds < 1) {
+        rounds = 1;
+    }
+
+    g_names = malloc(sizeof(char *) * BENCH_MAX_MAPS);
+    mapCreate(&g_mp);
+    pillsCreate(&g_pb);
+    basesCreate(&g_bs);
+    startsCreate(&g_ss);
+    if (dir != NULL) {
+        benchListMaps(dir);
+        ok = (bool) (g_numMaps > 0);
+        if (ok == FALSE) {
+            fprintf(stderr, "mapload-bench: no .map files in %s\n", dir);
+        }
+    } else {
+        ok = benchWriteInbuilt();
+        if (ok == FALSE) {
+            fprintf(stderr, "mapload-bench: unable to write maps to %s\n", BENCH_SCRATCH_DIR);
+        }
+    }
+
+    if (ok == TRUE) {
+        ok = benchCheck();
+    }
+    if (ok == TRUE && checkOnly == FALSE) {
+        benchTiming(rounds);
+    }
+
+    for (i = 0; i < g_numMaps; i++) {
+        benchRemoveCache(g_names[i]);
+        if (dir == NULL) {
+            remove(g_names[i]);
+        }
+        free(g_names[i]);
+    }
+    if (dir == NULL) {
+#ifdef _WIN32
+        _rmdir(BENCH_SCRATCH_DIR);
+#else
+        rmdir(BENCH_SCRATCH_DIR);
+#endif
+    }
+    free(g_names);
+    mapDestroy(&g_mp);
+    pillsDestroy(&g_pb);
+    basesDestroy(&g_bs);
+    startsDestroy(&g_ss);
+    return ok == TRUE ? 0 : 1;
+}
@@ -0,0 +1,364 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/*
+ * multi_bench.c — multi-game server memory and scheduling benchmark
+ * (multi-bench, Linux only).
+ *
+ * Hosting N games used to mean running N servers, each with its own
+ * timer, its own copy of every table and its own threads.  A server can
+ * now host them all with -games N: one timer wakes a pool of -workers
+ * threads which tick each game in turn.  This runs the real server both
+ * ways on the inbuilt map and compares what the kernel charges for it.
+ *
+ * Runs
+ * ----
+ * First N servers, each started as
+ *   winbolo-server -inbuilt -port P+i -gametype open -noinput -nowinbolonet
+ * then one server started the same way with -games N, and -workers M if
+ * given, otherwise the server runs one worker per CPU.  Each run is
+ * given BENCH_SETTLE_MS to start up, then measured for -seconds.
+ * The servers are stopped with SIGINT and must all exit.
+ *
+ * Measures
+ * --------
+ * Summed over every process of a run, read from /proc:
+ *   RSS      VmRSS from status.  Shared pages are counted once per process
+ *   PSS      Pss from smaps_rollup, shared pages split between the
+ *            processes that map them, so the N server total is fair
+ *   threads  Threads from status
+ *   vol/s    voluntary_ctxt_switches over every task, per second
+ *   invol/s  nonvoluntary_ctxt_switches over every task, per second
+ * The switch counts are read at the start and end of the measured time.
+ * A game with no players still ticks 50 times a second, so this is the
+ * cost of hosting the games and not of playing them.
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_DEFAULT_SERVER "./winbolo-server"
+#define BENCH_DEFAULT_GAMES 8
+/* Workers the server picks for itself */
+#define BENCH_DEFAULT_WORKERS -1
+#define BENCH_DEFAULT_SECONDS 10
+#define BENCH_DEFAULT_PORT 27700
+/* Most games that can be run */
+#define BENCH_MAX_GAMES 64
+/* Time a run is given to start before it is measured */
+#define BENCH_SETTLE_MS 2000
+/* Time the servers are given to exit after SIGINT */
+#define BENCH_EXIT_MS 5000
+
+/* Totals for one run */
+typedef struct {
+    long rssKb;                /* VmRSS over every process */
+    long pssKb;                /* Pss over every process */
+    long threads;              /* Threads over every process */
+    unsigned long long vol;    /* Voluntary switches over every task */
+    unsigned long long invol;  /* Involuntary switches over every task */
+} benchTotals;
+
+static const char *g_server = BENCH_DEFAULT_SERVER;
+static int g_games = BENCH_DEFAULT_GAMES;
+static int g_workers = BENCH_DEFAULT_WORKERS;
+static int g_seconds = BENCH_DEFAULT_SECONDS;
+static int g_port = BENCH_DEFAULT_PORT;
+
+static pid_t g_pids[BENCH_MAX_GAMES];
+static int g_numPids;
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "Usage: multi-bench [-server <path>] [-games <n>] [-workers <n>]\n"
+        "                   [-seconds <s>] [-port <p>]\n"
+        "\n"
+        "  -server   Server to run (default %s)\n"
+        "  -games    Games hosted each way (default %d, at most %d)\n"
+        "  -workers  Workers for the one server run (default one per CPU)\n"
+        "  -seconds  Time each run is measured for (default %d)\n"
+        "  -port     First port used (default %d)\n",
+        BENCH_DEFAULT_SERVER, BENCH_DEFAULT_GAMES, BENCH_MAX_GAMES,
+        BENCH_DEFAULT_SECONDS, BENCH_DEFAULT_PORT);
+}
+
+static void benchSleepMs(long ms)
+{
+    struct timespec ts;
+
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000000L;
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+/* Starts one server with its output thrown away.  Returns 0 on failure. */
+static pid_t benchStart(int port, int games)
+{
+    char portArg[16], gamesArg[16], workersArg[16];
+    char *args[16];
+    int n = 0;
+    int fd;
+    pid_t pid;
+
+    snprintf(portArg, sizeof(portArg), "%d", port);
+    snprintf(gamesArg, sizeof(gamesArg), "%d", games);
+    snprintf(workersArg, sizeof(workersArg), "%d", g_workers);
+    args[n++] = (char *) g_server;
+    args[n++] = "-inbuilt";
+    args[n++] = "-port";
+    args[n++] = portArg;
+    args[n++] = "-gametype";
+    args[n++] = "open";
+    args[n++] = "-noinput";
+    args[n++] = "-nowinbolonet";
+    if (games > 1) {
+        args[n++] = "-games";
+        args[n++] = gamesArg;
+        if (g_workers >= 0) {
+            args[n++] = "-workers";
+            args[n++] = workersArg;
+        }
+    }
+    args[n] = NULL;
+
+    pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 0;
+    }
+    if (pid == 0) {
+        fd = open("/dev/null", O_RDWR);
+        if (fd >= 0) {
+            dup2(fd, STDIN_FILENO);
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        execv(g_server, args);
+        _exit(127);
+    }
+    return pid;
+}
+
+/* Reads a "Name:  value" line from a /proc file.  Returns -1 if missing. */
+static long benchProcField(const char *path, const char *name)
+{
+    char line[256];
+    size_t len = strlen(name);
+    long value = -1;
+    FILE *fp;
+
+    fp = fopen(path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, name, len) == 0 && line[len] == ':') {
+            value = strtol(line + len + 1, NULL, 10);
+            break;
+        }
+    }
+    fclose(fp);
+    return value;
+}
+
+/* Adds the context switches of every task of a process. */
+static void benchAddSwitches(pid_t pid, benchTotals *totals)
+{
+    char path[64];
+    char status[64];
+    struct dirent *entry;
+    DIR *dir;
+    long value;
+
+    snprintf(path, sizeof(path), "/proc/%d/task", (int) pid);
+    dir = opendir(path);
+    if (dir == NULL) {
+        return;
+    }
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        /* Task names are thread ids */
+        snprintf(status, sizeof(status), "/proc/%d/task/%.16s/status", (int) pid, entry->d_name);
+        value = benchProcField(status, "voluntary_ctxt_switches");
+        if (value > 0) {
+            totals->vol += (unsigned long long) value;
+        }
+        value = benchProcField(status, "nonvoluntary_ctxt_switches");
+        if (value > 0) {
+            totals->invol += (unsigned long long) value;
+        }
+    }
+    closedir(dir);
+}
+
+/* Reads the totals of every running server.  Returns 0 if one has died. */
+static int benchRead(benchTotals *totals)
+{
+    char path[64];
+    long value;
+    int i;
+
+    memset(totals, 0, sizeof(*totals));
+    for (i = 0; i < g_numPids; i++) {
+        if (waitpid(g_pids[i], NULL, WNOHANG) != 0) {
+            fprintf(stderr, "Server %d (pid %d) exited early\n", i, (int) g_pids[i]);
+            return 0;
+        }
+        snprintf(path, sizeof(path), "/proc/%d/status", (int) g_pids[i]);
+        value = benchProcField(path, "VmRSS");
+        totals->rssKb += value > 0 ? value : 0;
+        value = benchProcField(path, "Threads");
+        totals->threads += value > 0 ? value : 0;
+        snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", (int) g_pids[i]);
+        value = benchProcField(path, "Pss");
+        totals->pssKb += value > 0 ? value : 0;
+        benchAddSwitches(g_pids[i], totals);
+    }
+    return 1;
+}
+
+/* Stops every running server.  Returns 0 if one had to be killed. */
+static int benchStop(void)
+{
+    int ok = 1;
+    int waited;
+    int i;
+
+    for (i = 0; i < g_numPids; i++) {
+        kill(g_pids[i], SIGINT);
+    }
+    for (i = 0; i < g_numPids; i++) {
+        waited = 0;
+        while (waitpid(g_pids[i], NULL, WNOHANG) == 0) {
+            if (waited >= BENCH_EXIT_MS) {
+                fprintf(stderr, "Server %d (pid %d) did not exit\n", i, (int) g_pids[i]);
+                kill(g_pids[i], SIGKILL);
+                waitpid(g_pids[i], NULL, 0);
+                ok = 0;
+                break;
+            }
+            benchSleepMs(10);
+            waited += 10;
+        }
+    }
+    g_numPids = 0;
+    return ok;
+}
+
+/* Runs the games as the given number of servers and measures them. */
+static int benchRun(int servers, benchTotals *result)
+{
+    benchTotals start;
+    int i;
+
+    g_numPids = 0;
+    for (i = 0; i < servers; i++) {
+        g_pids[i] = benchStart(g_port + i, g_games / servers);
+        if (g_pids[i] == 0) {
+            benchStop();
+            return 0;
+        }
+        g_numPids++;
+    }
+    benchSleepMs(BENCH_SETTLE_MS);
+    if (benchRead(&start) == 0) {
+        benchStop();
+        return 0;
+    }
+    benchSleepMs(g_seconds * 1000L);
+    if (benchRead(result) == 0) {
+        benchStop();
+        return 0;
+    }
+    result->vol -= start.vol;
+    result->invol -= start.invol;
+    return benchStop();
+}
+
+static void benchPrint(const char *name, const benchTotals *t)
+{
+    printf("%-24s %9.1f %9.1f %8ld %9.1f %9.1f\n", name,
+           t->rssKb / 1024.0, t->pssKb / 1024.0, t->threads,
+           (double) t->vol / g_seconds, (double) t->invol / g_seconds);
+}
+
+int main(int argc, char **argv)
+{
+    benchTotals apart, together;
+    char name[64];
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-server") == 0 && i + 1 < argc) {
+            g_server = argv[++i];
+        } else if (strcmp(argv[i], "-games") == 0 && i + 1 < argc) {
+            g_games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-workers") == 0 && i + 1 < argc) {
+            g_workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-seconds") == 0 && i + 1 < argc) {
+            g_seconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-port") == 0 && i + 1 < argc) {
+            g_port = atoi(argv[++i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (g_games < 1 || g_games > BENCH_MAX_GAMES ||
+        g_seconds < 1 || g_port < 1 || g_port + g_games > 65535) {
+        usage();
+        return 1;
+    }
+    if (access(g_server, X_OK) != 0) {
+        fprintf(stderr, "Can't run %s\n", g_server);
+        return 1;
+    }
+
+    printf("%d games on the inbuilt map, measured for %d s after %d ms\n\n",
+           g_games, g_seconds, BENCH_SETTLE_MS);
+    if (benchRun(g_games, &apart) == 0) {
+        return 1;
+    }
+    if (benchRun(1, &together) == 0) {
+        return 1;
+    }
+
+    printf("%-24s %9s %9s %8s %9s %9s\n", "run", "RSS MB", "PSS MB",
+           "threads", "vol/s", "invol/s");
+    snprintf(name, sizeof(name), "%d servers", g_games);
+    benchPrint(name, &apart);
+    if (g_workers < 0) {
+        snprintf(name, sizeof(name), "1 server");
+    } else {
+        snprintf(name, sizeof(name), "1 server, %d worker%s", g_workers,
+                 g_workers == 1 ? "" : "s");
+    }
+    benchPrint(name, &together);
+    printf("\nRSS %.2fx less, PSS %.2fx less, switches %.2fx fewer\n",
+           together.rssKb > 0 ? (double) apart.rssKb / together.rssKb : 0.0,
+           together.pssKb > 0 ? (double) apart.pssKb / together.pssKb : 0.0,
+           together.vol + together.invol > 0 ?
+               (double) (apart.vol + apart.invol) / (together.vol + together.invol) : 0.0);
+    return 0;
+}
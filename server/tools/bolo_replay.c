@@ -0,0 +1,526 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/*
+ * bolo_replay.c — headless WinBolo log player (bolo-replay).
+ *
+ * Plays a .wbv log written by the server's -logfile option through the
+ * replay module without a screen, so long games can be looked through,
+ * searched for events or turned into data for other tools.
+ *
+ * Index
+ * -----
+ * The first time a log is opened the whole of it is inflated once to
+ * find its snapshots, and the index is written beside it as a .wbi file.
+ * Later runs load the index and seek to any tick by restarting inflate
+ * at the deflate block before the nearest snapshot, so -from costs about
+ * the same an hour into a game as a minute in.  A log that has grown or
+ * changed since the index was written is indexed again.  -noindex plays
+ * from the start without one; -reindex ignores the file and rebuilds it.
+ *
+ * Output
+ * ------
+ * -info prints the header and length and stops.  -events prints joins,
+ * quits, kills, messages and captures as they happen.  -export writes a
+ * JSON object per line every -every ticks with the players, pills and
+ * bases at that tick and the events since the last line.  Times are
+ * given as h:mm:ss of game time; a tick is REPLAY_TICK_LENGTH ms.
+ *
+ * Timing
+ * ------
+ * The time to index (or load the index), to seek to -from and to play
+ * to -to are printed to stderr, with the playback speed as a multiple of
+ * real time.  -speed 1 plays in real time; the default of 0 plays as
+ * fast as it can.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "global.h"
+#include "bolo_map.h"
+#include "pillbox.h"
+#include "bases.h"
+#include "starts.h"
+#include "log.h"
+#include "replay.h"
+
+/* Space for the events between two exported lines */
+#define REPLAY_EXPORT_EVENTS (256 * 1024)
+
+/* Longest description replayDescribe writes, with its terminator */
+#define REPLAY_TEXT_SIZE (REPLAY_MAX_EVENT + 2 * PLAYER_NAME_LEN + 64)
+
+static replay g_rp;
+static FILE *g_export;
+static char *g_exportEvents;
+static size_t g_exportEventsLen;
+static bool g_exportEventsFull;
+
+/* servernet.c reads the server tick count through servermain.c, which
+ * this target doesn't link.  No server ticks are run. */
+time_t serverMainGetTicks(void)
+{
+    return 0;
+}
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+
+static unsigned long long replayNow(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (unsigned long long) ((double) count.QuadPart * 1000000000.0 /
+                                 (double) freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ULL +
+           (unsigned long long) ts.tv_nsec;
+#endif
+}
+
+static void replaySleepMs(unsigned long ms)
+{
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    usleep((useconds_t) ms * 1000);
+#endif
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "Usage: bolo-replay <log.wbv> [-info] [-from <time>] [-to <time>]\n"
+        "                   [-speed <n>] [-events] [-export <file>] [-every <n>]\n"
+        "                   [-noindex] [-reindex]\n"
+        "\n"
+        "  -info     Print the log header and length, then stop\n"
+        "  -from     Seek here before playing (default the start)\n"
+        "  -to       Stop playing here (default the end)\n"
+        "  -speed    Multiple of real time to play at, 0 for as fast as\n"
+        "            possible (default 0)\n"
+        "  -events   Print joins, quits, kills, messages and captures\n"
+        "  -export   Write a JSON line of the game state to file, - for stdout\n"
+        "  -every    Ticks between exported lines (default %d, one a second)\n"
+        "  -noindex  Don't load, build or write the .wbi index\n"
+        "  -reindex  Rebuild the index even if the .wbi file is current\n"
+        "\n"
+        "Times are ticks, m:ss or h:mm:ss. There are %d ticks a second.\n",
+        REPLAY_TICKS_SEC, REPLAY_TICKS_SEC);
+}
+
+/* Ticks from a count of ticks, m:ss or h:mm:ss. */
+static bool replayParseTime(const char *text, unsigned long *tick)
+{
+    unsigned long parts[3];
+    int numParts = 0;
+    char *end;
+
+    while (numParts < 3) {
+        parts[numParts++] = strtoul(text, &end, 10);
+        if (end == text) {
+            return FALSE;
+        }
+        if (*end == '\0') {
+            break;
+        }
+        if (*end != ':') {
+            return FALSE;
+        }
+        text = end + 1;
+    }
+    if (*end != '\0') {
+        return FALSE;
+    }
+    if (numParts == 1) {
+        *tick = parts[0];
+    } else if (numParts == 2) {
+        *tick = (parts[0] * 60 + parts[1]) * REPLAY_TICKS_SEC;
+    } else {
+        *tick = (parts[0] * 3600 + parts[1] * 60 + parts[2]) * REPLAY_TICKS_SEC;
+    }
+    return TRUE;
+}
+
+static void replayFormatTime(unsigned long tick, char *text)
+{
+    unsigned long secs = tick / REPLAY_TICKS_SEC;
+
+    sprintf(text, "%lu:%02lu:%02lu", secs / 3600, (secs / 60) % 60, secs % 60);
+}
+
+static const char *replayPlayerName(BYTE playerNum)
+{
+    static char names[2][PLAYER_NAME_LEN + 16];
+    static int next;
+    replayPlayer plr;
+    char *name = names[next];
+
+    next ^= 1;
+    replayGetPlayer(&g_rp, playerNum, &plr);
+    if (playerNum >= MAX_TANKS) {
+        strcpy(name, "nobody");
+    } else if (plr.name[0] == '\0') {
+        sprintf(name, "player %d", playerNum);
+    } else {
+        strcpy(name, plr.name);
+    }
+    return name;
+}
+
+/* Describes an event people would want to read about, or returns FALSE
+ * for movement, sounds and other detail. */
+static bool replayDescribe(replayEvent *ev, char *text)
+{
+    switch (ev->item) {
+    case log_PlayerJoined:
+        sprintf(text, "%s joined from %d.%d.%d.%d", ev->text, ev->opt[1], ev->opt[2],
+                ev->opt[3], ev->opt[4]);
+        return TRUE;
+    case log_PlayerRejoin:
+        sprintf(text, "%s rejoined", replayPlayerName(ev->opt[0]));
+        return TRUE;
+    case log_PlayerQuit:
+        sprintf(text, "%s quit", replayPlayerName(ev->opt[0]));
+        return TRUE;
+    case log_PlayerLeaving:
+        sprintf(text, "%s is leaving", replayPlayerName(ev->opt[0]));
+        return TRUE;
+    case log_ChangeName:
+        sprintf(text, "player %d is now %s", ev->opt[0], ev->text);
+        return TRUE;
+    case log_KillPlayer:
+        sprintf(text, "%s killed %s", replayPlayerName(ev->opt[1]), replayPlayerName(ev->opt[0]));
+        return TRUE;
+    case log_PlayerDied:
+        sprintf(text, "%s died", replayPlayerName(ev->opt[0]));
+        return TRUE;
+    case log_LostMan:
+        sprintf(text, "%s lost their builder", replayPlayerName(ev->opt[0]));
+        return TRUE;
+    case log_AllyRequest:
+        sprintf(text, "%s asked to ally with %s", replayPlayerName(ev->opt[0]),
+                replayPlayerName(ev->opt[1]));
+        return TRUE;
+    case log_AllyAccept:
+        sprintf(text, "%s allied with %s", replayPlayerName(ev->opt[0]), replayPlayerName(ev->opt[1]));
+        return TRUE;
+    case log_AllyLeave:
+        sprintf(text, "%s left their alliance", replayPlayerName(ev->opt[0]));
+        return TRUE;
+    case log_MessageAll:
+        sprintf(text, "%s to all: %s", replayPlayerName(ev->opt[0]), ev->text);
+        return TRUE;
+    case log_MessagePlayers:
+        sprintf(text, "%s to some: %s", replayPlayerName(ev->opt[0]), ev->text);
+        return TRUE;
+    case log_MessageServer:
+        sprintf(text, "server: %s", ev->text);
+        return TRUE;
+    case log_BaseSetOwner:
+        if (ev->opt[1] == NEUTRAL) {
+            sprintf(text, "base %d is neutral", ev->opt[0] + 1);
+        } else {
+            sprintf(text, "%s took base %d", replayPlayerName(ev->opt[1]), ev->opt[0] + 1);
+        }
+        return TRUE;
+    case log_PillSetOwner:
+        if (ev->opt[1] == NEUTRAL) {
+            sprintf(text, "pill %d is neutral", ev->opt[0] + 1);
+        } else {
+            sprintf(text, "%s took pill %d", replayPlayerName(ev->opt[1]), ev->opt[0] + 1);
+        }
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+/* Writes text as a JSON string. */
+static void replayJsonString(FILE *fp, const char *text)
+{
+    fputc('"', fp);
+    for (; *text != '\0'; text++) {
+        if (*text == '"' || *text == '\\') {
+            fprintf(fp, "\\%c", *text);
+        } else if ((unsigned char) *text < 0x20) {
+            fprintf(fp, "\\u%04x", (unsigned char) *text);
+        } else {
+            fputc(*text, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+/* ── Export ─────────────────────────────────────────────────────────────── */
+
+/* Keeps an event for the next exported line as a JSON object. */
+static void replayExportEvent(replayEvent *ev, const char *text, unsigned long tick)
+{
+    /* Every character may be escaped */
+    char quoted[2 * REPLAY_TEXT_SIZE];
+    char buff[sizeof(quoted) + 96];
+    char *out = quoted;
+    const char *in;
+    int len;
+
+    for (in = text; *in != '\0' && out < quoted + sizeof(quoted) - 2; in++) {
+        if (*in == '"' || *in == '\\') {
+            *out++ = '\\';
+            *out++ = *in;
+        } else if ((unsigned char) *in >= 0x20) {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+    len = snprintf(buff, sizeof(buff), "%s{\"tick\":%lu,\"type\":%d,\"text\":\"%s\"}",
+                   g_exportEventsLen > 0 ? "," : "", tick, (int) ev->item, quoted);
+    if (len < 0 || (size_t) len >= sizeof(buff)) {
+        fprintf(stderr, "bolo-replay: event at tick %lu too long to export\n", tick);
+        return;
+    }
+    if (g_exportEventsLen + (size_t) len < REPLAY_EXPORT_EVENTS) {
+        memcpy(g_exportEvents + g_exportEventsLen, buff, (size_t) len + 1);
+        g_exportEventsLen += (size_t) len;
+    } else {
+        g_exportEventsFull = TRUE;
+    }
+}
+
+static void replayExportLine(unsigned long tick)
+{
+    char when[32];
+    replayPlayer plr;
+    pillboxes *pb = replayGetPills(&g_rp);
+    bases *bs = replayGetBases(&g_rp);
+    bool first = TRUE;
+    int count;
+
+    replayFormatTime(tick, when);
+    fprintf(g_export, "{\"tick\":%lu,\"time\":\"%s\",\"players\":[", tick, when);
+    for (count = 0; count < MAX_TANKS; count++) {
+        replayGetPlayer(&g_rp, (BYTE) count, &plr);
+        if (plr.inUse == TRUE) {
+            fprintf(g_export, "%s{\"num\":%d,\"name\":", first ? "" : ",", count);
+            replayJsonString(g_export, plr.name);
+            fprintf(g_export, ",\"mx\":%d,\"my\":%d,\"px\":%d,\"py\":%d,\"dir\":%d,\"boat\":%s}",
+                    plr.mx, plr.my, plr.px, plr.py, plr.dir, plr.onBoat ? "true" : "false");
+            first = FALSE;
+        }
+    }
+    fprintf(g_export, "],\"pills\":[");
+    for (count = 0; count < (*pb)->numPills; count++) {
+        fprintf(g_export, "%s{\"x\":%d,\"y\":%d,\"owner\":%d,\"armour\":%d,\"inTank\":%s}",
+                count > 0 ? "," : "", (*pb)->item[count].x, (*pb)->item[count].y,
+                (*pb)->item[count].owner, (*pb)->item[count].armour,
+                (*pb)->item[count].inTank ? "true" : "false");
+    }
+    fprintf(g_export, "],\"bases\":[");
+    for (count = 0; count < (*bs)->numBases; count++) {
+        fprintf(g_export, "%s{\"x\":%d,\"y\":%d,\"owner\":%d,\"shells\":%d,\"mines\":%d,\"armour\":%d}",
+                count > 0 ? "," : "", (*bs)->item[count].x, (*bs)->item[count].y,
+                (*bs)->item[count].owner, (*bs)->item[count].shells,
+                (*bs)->item[count].mines, (*bs)->item[count].armour);
+    }
+    fprintf(g_export, "],\"events\":[%s]%s}\n", g_exportEvents,
+            g_exportEventsFull ? ",\"eventsDropped\":true" : "");
+    g_exportEventsLen = 0;
+    g_exportEvents[0] = '\0';
+    g_exportEventsFull = FALSE;
+}
+
+/* ── Main ───────────────────────────────────────────────────────────────── */
+
+static void replayPrintInfo(const char *fileName)
+{
+    replayHeader h;
+    char when[32];
+    unsigned long startDelay, timeLeft;
+
+    replayGetHeader(&g_rp, &h);
+    replayGetTimes(&g_rp, &startDelay, &timeLeft);
+    printf("Log:          %s\n", fileName);
+    printf("Map:          %s\n", h.mapName);
+    printf("Server:       %d.%d.%d.%d:%u (version %d.%d.%d)\n", h.address[0], h.address[1],
+           h.address[2], h.address[3], h.port, h.version[0], h.version[1], h.version[2]);
+    printf("Started:      %lu\n", h.startTime);
+    printf("Game type:    %d, hidden mines %s, ai %d, password %s, max players %d\n",
+           h.gameType, h.hiddenMines ? "yes" : "no", h.ai, h.password ? "yes" : "no",
+           h.maxPlayers);
+    printf("Start delay:  %lu, time limit %ld\n", startDelay, (long) timeLeft);
+    if (replayIsIndexed(&g_rp) == TRUE) {
+        replayFormatTime(replayGetNumTicks(&g_rp), when);
+        printf("Length:       %lu ticks (%s)%s\n", replayGetNumTicks(&g_rp), when,
+               replayIsComplete(&g_rp) == TRUE ? "" : ", cut short");
+        printf("Snapshots:    %d\n", replayGetNumSnapshots(&g_rp));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    char indexName[FILENAME_MAX];
+    char when[32], text[REPLAY_TEXT_SIZE];
+    char *fileName = NULL, *exportName = NULL;
+    unsigned long from = 0, to = 0xFFFFFFFFUL, tick, played;
+    unsigned long long start, elapsed, playStart;
+    double speed = 0.0;
+    int every = REPLAY_TICKS_SEC, pos, i;
+    bool info = FALSE, events = FALSE, noIndex = FALSE, reindex = FALSE;
+    bool ok = TRUE;
+    replayEvent ev;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-info") == 0) {
+            info = TRUE;
+        } else if (strcmp(argv[i], "-from") == 0 && i + 1 < argc) {
+            ok = replayParseTime(argv[++i], &from);
+        } else if (strcmp(argv[i], "-to") == 0 && i + 1 < argc) {
+            ok = replayParseTime(argv[++i], &to);
+        } else if (strcmp(argv[i], "-speed") == 0 && i + 1 < argc) {
+            speed = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-events") == 0) {
+            events = TRUE;
+        } else if (strcmp(argv[i], "-export") == 0 && i + 1 < argc) {
+            exportName = argv[++i];
+        } else if (strcmp(argv[i], "-every") == 0 && i + 1 < argc) {
+            every = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-noindex") == 0) {
+            noIndex = TRUE;
+        } else if (strcmp(argv[i], "-reindex") == 0) {
+            reindex = TRUE;
+        } else if (argv[i][0] != '-' && fileName == NULL) {
+            fileName = argv[i];
+        } else {
+            ok = FALSE;
+        }
+        if (ok == FALSE) {
+            break;
+        }
+    }
+    if (ok == FALSE || fileName == NULL || every < 1 || speed < 0.0 || to < from) {
+        usage();
+        return 2;
+    }
+
+    replayCreate(&g_rp);
+    if (replayOpen(&g_rp, fileName) == FALSE) {
+        fprintf(stderr, "bolo-replay: %s is not a WinBolo log or is damaged\n", fileName);
+        replayDestroy(&g_rp);
+        return 1;
+    }
+
+    if (noIndex == FALSE) {
+        start = replayNow();
+        if (reindex == FALSE && replayIndexRead(&g_rp) == TRUE) {
+            elapsed = replayNow() - start;
+            fprintf(stderr, "index: loaded %d snapshots in %.2f ms\n", replayGetNumSnapshots(&g_rp),
+                    (double) elapsed / 1e6);
+        } else if (replayIndexBuild(&g_rp) == TRUE) {
+            elapsed = replayNow() - start;
+            replayFormatTime(replayGetNumTicks(&g_rp), when);
+            fprintf(stderr, "index: scanned %lu ticks (%s) in %.2f ms, %d snapshots\n",
+                    replayGetNumTicks(&g_rp), when, (double) elapsed / 1e6, replayGetNumSnapshots(&g_rp));
+            if (replayIndexName(fileName, indexName) == TRUE && replayIndexWrite(&g_rp) == FALSE) {
+                fprintf(stderr, "index: couldn't write %s\n", indexName);
+            }
+        } else {
+            fprintf(stderr, "index: couldn't index %s, playing without one\n", fileName);
+        }
+    }
+
+    if (info == TRUE) {
+        replayPrintInfo(fileName);
+        replayDestroy(&g_rp);
+        return 0;
+    }
+
+    if (exportName != NULL) {
+        g_export = strcmp(exportName, "-") == 0 ? stdout : fopen(exportName, "w");
+        g_exportEvents = malloc(REPLAY_EXPORT_EVENTS);
+        if (g_export == NULL || g_exportEvents == NULL) {
+            fprintf(stderr, "bolo-replay: couldn't open %s\n", exportName);
+            replayDestroy(&g_rp);
+            return 1;
+        }
+        g_exportEvents[0] = '\0';
+    }
+
+    /* Seek to -from.  The tick seeked to is played so its events are
+     * reported too. */
+    start = replayNow();
+    ok = replaySeek(&g_rp, from);
+    elapsed = replayNow() - start;
+    replayFormatTime(from, when);
+    fprintf(stderr, "seek: to tick %lu (%s) in %.2f ms\n", from, when, (double) elapsed / 1e6);
+
+    played = 0;
+    playStart = replayNow();
+    while (ok == TRUE) {
+        tick = replayGetTick(&g_rp);
+        pos = 0;
+        while (replayGetEvent(&g_rp, &pos, &ev) == TRUE) {
+            if (replayDescribe(&ev, text) == TRUE) {
+                if (events == TRUE) {
+                    replayFormatTime(tick, when);
+                    printf("%s %s\n", when, text);
+                }
+                if (g_export != NULL) {
+                    replayExportEvent(&ev, text, tick);
+                }
+            }
+        }
+        if (g_export != NULL && (tick - from) % (unsigned long) every == 0) {
+            replayExportLine(tick);
+        }
+        if (tick >= to) {
+            break;
+        }
+        if (speed > 0.0) {
+            elapsed = (replayNow() - playStart) / 1000000ULL;
+            i = (int) ((double) played * REPLAY_TICK_LENGTH / speed - (double) elapsed);
+            if (i > 0) {
+                replaySleepMs((unsigned long) i);
+            }
+        }
+        ok = replayStep(&g_rp);
+        if (ok == TRUE) {
+            played++;
+        }
+    }
+    elapsed = replayNow() - playStart;
+
+    replayFormatTime(replayGetTick(&g_rp), when);
+    fprintf(stderr, "play: %lu ticks to %lu (%s) in %.2f ms, %.0f ticks/s, %.0fx real time\n",
+            played, replayGetTick(&g_rp), when, (double) elapsed / 1e6,
+            elapsed > 0 ? (double) played * 1e9 / (double) elapsed : 0.0,
+            elapsed > 0 ? (double) played * REPLAY_TICK_LENGTH * 1e6 / (double) elapsed : 0.0);
+    if (replayIsFailed(&g_rp) == TRUE) {
+        fprintf(stderr, "bolo-replay: %s is damaged after tick %lu\n", fileName, replayGetTick(&g_rp));
+    }
+
+    if (g_export != NULL && g_export != stdout) {
+        fclose(g_export);
+    }
+    free(g_exportEvents);
+    ok = (bool) (replayIsFailed(&g_rp) == FALSE);
+    replayDestroy(&g_rp);
+    return ok == TRUE ? 0 : 1;
+}
@@ -43,7 +43,7 @@ BYTE screenGetNumNeutralBases(void) {
   if (threadsGetContext() == FALSE) {
     return clientGetNumNeutralBases();
   }
-  return serverCoreGetNumNeutralBases();
+  return serverCoreGetNumNeutralBases(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -62,7 +62,7 @@ bool screenMapIsMine(BYTE bmx, BYTE bmy) {
   if (threadsGetContext() == FALSE) {
     return clientMapIsMine(bmx, bmy);
   }
-  return serverCoreMapIsMine(bmx, bmy);
+  return serverCoreMapIsMine(serverCoreGetContext(), bmx, bmy);
 }
 
 
@@ -81,7 +81,7 @@ players *screenGetPlayers() {
   if (threadsGetContext() == FALSE) {
     return clientGetPlayers();
   }
-  return serverCoreGetPlayers();
+  return serverCoreGetPlayers(serverCoreGetContext());
 }
 
 
@@ -101,7 +101,7 @@ tank* screenGetTankFromPlayer(BYTE playerNum) {
   if (threadsGetContext() == FALSE) {
     return clientGetTankFromPlayer(playerNum);
   }
-  return serverCoreGetTankFromPlayer(playerNum);
+  return serverCoreGetTankFromPlayer(serverCoreGetContext(), playerNum);
 }
 
 /*********************************************************
@@ -119,7 +119,7 @@ BYTE screenGetTankPlayer(tank *value) {
   if (threadsGetContext() == FALSE) {
     return clientGetTankPlayer(value);
   }
-  return serverCoreGetTankPlayer(value);
+  return serverCoreGetTankPlayer(serverCoreGetContext(), value);
 }
 
 
@@ -138,7 +138,7 @@ BYTE screenNumBases(void) {
   if (threadsGetContext() == FALSE) {
     return clientNumBases();
   }
-  return serverCoreNumBases();
+  return serverCoreNumBases(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -156,7 +156,7 @@ BYTE screenNumPills(void) {
   if (threadsGetContext() == FALSE) {
     return clientNumPills();
   }
-  return serverCoreNumPills();
+  return serverCoreNumPills(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -175,7 +175,7 @@ lgm *screenGetLgmFromPlayerNum(BYTE playerNum) {
   if (threadsGetContext() == FALSE) {
     return clientGetLgmFromPlayerNum(playerNum);
   }
-  return serverCoreGetLgmFromPlayerNum(playerNum);
+  return serverCoreGetLgmFromPlayerNum(serverCoreGetContext(), playerNum);
 }
 
 /*********************************************************
@@ -196,7 +196,7 @@ void screenGetTankWorldFromLgm(lgm *lgmans, WORLD *x, WORLD *y) {
   if (threadsGetContext() == FALSE) {
     clientGetTankWorldFromLgm(lgmans, x, y);
   } else {
-    serverCoreGetTankWorldFromLgm(lgmans, x, y);
+    serverCoreGetTankWorldFromLgm(serverCoreGetContext(), lgmans, x, y);
   }
 }
 
@@ -217,7 +217,7 @@ void screenGetRandStart(BYTE *mx, BYTE *my, TURNTYPE *dir) {
   if (threadsGetContext() == FALSE) {
     clientGetRandStart(mx, my, dir);
   } else {
-    serverCoreGetRandStart(mx, my, dir);
+    serverCoreGetRandStart(serverCoreGetContext(), mx, my, dir);
   }
 }
 
@@ -240,7 +240,7 @@ bool screenCheckTankRange(BYTE x, BYTE y, BYTE playerNum, double distance) {
   if (threadsGetContext() == FALSE) {
     return clientCheckTankRange(x, y, playerNum, distance);
   }
-  return serverCoreCheckTankRange(x, y, playerNum, distance);
+  return serverCoreCheckTankRange(serverCoreGetContext(), x, y, playerNum, distance);
 }
 
 /*********************************************************
@@ -262,7 +262,7 @@ bool screenCheckPillsRange(BYTE xValue, BYTE yValue, BYTE playerNum, double dist
   if (threadsGetContext() == FALSE) {
     return clientCheckPillsRange(xValue, yValue, playerNum, distance);
   }
-  return serverCoreCheckPillsRange(xValue, yValue, playerNum, distance);
+  return serverCoreCheckPillsRange(serverCoreGetContext(), xValue, yValue, playerNum, distance);
 }
 
 /*********************************************************
@@ -323,7 +323,7 @@ bool screenTankInView(BYTE playerNum, BYTE checkX, BYTE checkY) {
   if (threadsGetContext() == FALSE) {
     return clientTankInView(playerNum, checkX, checkY);
   } else {
-    return serverCoreTankInView(playerNum, checkX, checkY);
+    return serverCoreTankInView(serverCoreGetContext(), playerNum, checkX, checkY);
   }
 }
 
@@ -342,7 +342,7 @@ void screenCenterTank() {
   if (threadsGetContext() == FALSE) {
     clientCenterTank();
   } else {
-    serverCoreCenterTank();
+    serverCoreCenterTank(serverCoreGetContext());
   } 
 }
 
@@ -385,7 +385,7 @@ building *screenGetBuildings() {
     return clientGetBuildings();
   }
 
-  return serverCoreGetBuildings();
+  return serverCoreGetBuildings(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -404,7 +404,7 @@ explosions *screenGetExplosions() {
     return clientGetExplosions();
   }
 
-  return serverCoreGetExplosions();
+  return serverCoreGetExplosions(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -423,7 +423,7 @@ floodFill *screenGetFloodFill() {
     return clientGetFloodFill();
   }
 
-  return serverCoreGetFloodFill();
+  return serverCoreGetFloodFill(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -442,7 +442,7 @@ grass *screenGetGrass() {
     return clientGetGrass();
   }
 
-  return serverCoreGetGrass();
+  return serverCoreGetGrass(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -461,7 +461,7 @@ mines *screenGetMines() {
     return clientGetMines();
   }
 
-  return serverCoreGetMines();
+  return serverCoreGetMines(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -479,7 +479,7 @@ minesExp *screenGetMinesExp() {
   if (threadsGetContext() == FALSE) {
     return clientGetMinesExp();
   }
-  return serverGetMinesExp();
+  return serverGetMinesExp(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -497,7 +497,7 @@ rubble *screenGetRubble() {
   if (threadsGetContext() == FALSE) {
     return clientGetRubble();
   }
-  return serverCoreGetRubble();
+  return serverCoreGetRubble(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -515,7 +515,7 @@ swamp *screenGetSwamp() {
   if (threadsGetContext() == FALSE) {
     return clientGetSwamp();
   }
-  return serverCoreGetSwamp();
+  return serverCoreGetSwamp(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -533,7 +533,7 @@ tkExplosion *screenGetTankExplosions() {
   if (threadsGetContext() == FALSE) {
     return clientGetTankExplosions();
   }
-  return serverCoreGetTankExplosions();
+  return serverCoreGetTankExplosions(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -551,7 +551,7 @@ netPnbContext *screenGetNetPnb() {
   if (threadsGetContext() == FALSE) {
     return clientGetNetPnb();
   }
-  return serverCoreGetNetPnb();
+  return serverCoreGetNetPnb(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -569,7 +569,7 @@ netMntContext *screenGetNetMnt() {
 if (threadsGetContext() == FALSE) {
     return clientGetNetMnt();
   }
-  return serverCoreGetNetMnt();
+  return serverCoreGetNetMnt(serverCoreGetContext());
 }
 
 /*********************************************************
@@ -624,7 +624,7 @@ gameType *screenGetGameType() {
   if (threadsGetContext() == FALSE) {
     return clientGetGameType();
   }
-  return serverCoreGetGameType();
+  return serverCoreGetGameType(serverCoreGetContext());
 }
 
 bool backendGetContext() {
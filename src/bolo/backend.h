@@ -20,7 +20,7 @@
 *Filename:      BackEnd.h
 *Author:        John Morrison
 *Creation Date: 25/11/99
-*Last Modified: 21/05/06
+*Last Modified: 16/10/26
 *Purpose:
 *  Functions called by the front end
 *********************************************************/
@@ -1401,6 +1401,21 @@ void screenSetInStartFind(bool entering);
 *********************************************************/
 bool screenGetInStartFind();
 
+/*********************************************************
+*NAME:          screenGetViewOffset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the map square in the top left of the view. Lets
+* a frontend turn view positions into map positions.
+*
+*ARGUMENTS:
+*  x - Pointer to hold the X map position
+*  y - Pointer to hold the Y map position
+*********************************************************/
+void screenGetViewOffset(BYTE *x, BYTE *y);
+
 bool backendGetContext();
 
 gameType *screenGetGameType();
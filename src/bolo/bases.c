@@ -98,6 +98,7 @@ void basesDestroy(bases *value) {
 void basesSetNumBases(bases *value, BYTE numBases) {
   if (numBases <= MAX_BASES) {
     (*value)->numBases = numBases;
+    basesPosIndexRebuild(value);
   }
 }
 
@@ -134,10 +135,19 @@ BYTE basesGetNumBases(bases *value) {
 *  baseNum - The base number
 *********************************************************/
 void basesSetBase(bases *value, base *item, BYTE baseNum) {
+  BYTE oldX; /* Previous position of the base */
+  BYTE oldY;
+
   if (baseNum > 0 && baseNum <= (*value)->numBases) {
     baseNum--;
+    oldX = (*value)->item[baseNum].x;
+    oldY = (*value)->item[baseNum].y;
     (((*value)->item[baseNum]).x) = item->x;
     (((*value)->item[baseNum]).y) = item->y;
+    if (oldX != item->x || oldY != item->y) {
+      basesPosIndexUpdate(value, oldX, oldY);
+      basesPosIndexUpdate(value, item->x, item->y);
+    }
     if (item->owner > (MAX_TANKS-1) && item->owner != NEUTRAL) {
       item->owner = NEUTRAL;
     }
@@ -194,10 +204,11 @@ void basesGetBase(bases *value, base *item, BYTE baseNum) {
 bool basesExistPos(bases *value, BYTE xValue, BYTE yValue) {
   bool returnValue; /* Value to return */
   BYTE count;       /* Looping Variable */
+  BYTE last;        /* One past the last base to check */
 
   returnValue = FALSE;
-  count = 0;
-  while (returnValue == FALSE && count < ((*value)->numBases)) {
+  basesPosIndexRange(value, xValue, yValue, &count, &last);
+  while (returnValue == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue) {
       returnValue = TRUE;
     }
@@ -226,11 +237,12 @@ baseAlliance basesGetAlliancePos(bases *value, BYTE xValue, BYTE yValue) {
   baseAlliance returnValue; /* Value to return */
   bool done;                /* Finished looping */
   BYTE count;               /* Looping Variable */
+  BYTE last;                /* One past the last base to check */
 
   returnValue = baseNeutral;
-  count = 0;
+  basesPosIndexRange(value, xValue, yValue, &count, &last);
   done = FALSE;
-  while (done == FALSE && count < ((*value)->numBases)) {
+  while (done == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue) {
      if ((*value)->item[count].armour == 0) {
         returnValue = baseDead;
@@ -439,13 +451,14 @@ bool basesAmOwner(bases *value, BYTE owner, BYTE xValue, BYTE yValue) {
   BYTE self;                /* Our player number */
   bool done;                /* Finished looping */
   BYTE count;               /* Looping Variable */
+  BYTE last;                /* One past the last base to check */
 
   returnValue = FALSE;
-  count = 0;
+  basesPosIndexRange(value, xValue, yValue, &count, &last);
   done = FALSE;
   /* FIXME: This is redundent. */
   self = owner;
-  while (done == FALSE && count < ((*value)->numBases)) {
+  while (done == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue) {
       if ((*value)->item[count].owner == self || (playersIsAllie(screenGetPlayers(), (*value)->item[count].owner, self) == TRUE)) {
         returnValue = TRUE;
@@ -549,6 +562,7 @@ BYTE basesSetOwner(bases *value, BYTE xValue, BYTE yValue, BYTE owner, BYTE migr
   BYTE returnValue;         /* Value to return */
   bool done;                /* Finished looping */
   BYTE count;               /* Looping Variable */
+  BYTE last;                /* One past the last base to check */
   /* Message stuff */
   char oldOwner[FILENAME_MAX];
   char messageStr[FILENAME_MAX];
@@ -557,9 +571,9 @@ BYTE basesSetOwner(bases *value, BYTE xValue, BYTE yValue, BYTE owner, BYTE migr
   messageStr[0] = '\0';
 
   returnValue = FALSE;
-  count = 0;
+  basesPosIndexRange(value, xValue, yValue, &count, &last);
   done = FALSE;
-  while (done == FALSE && count < ((*value)->numBases)) {
+  while (done == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue) {
       returnValue = (*value)->item[count].owner;
       if (migrate == TRUE) {
@@ -621,11 +635,12 @@ BYTE basesGetBaseNum(bases *value, BYTE xValue, BYTE yValue) {
   BYTE returnValue;         /* Value to return */
   bool done;                /* Finished looping */
   BYTE count;               /* Looping Variable */
+  BYTE last;                /* One past the last base to check */
 
   returnValue = BASE_NOT_FOUND-1;
-  count = 0;
+  basesPosIndexRange(value, xValue, yValue, &count, &last);
   done = FALSE;
-  while (done == FALSE && count < ((*value)->numBases)) {
+  while (done == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue) {
       returnValue = count;
       done = TRUE;
@@ -798,10 +813,11 @@ void basesGetStats(bases *value, BYTE baseNum, BYTE *shellsAmount, BYTE *mines,
 void basesDamagePos(bases *value, BYTE xValue, BYTE yValue) {
   bool done;                /* Are we finished searching for the base */
   BYTE count;               /* Looping Variable */
+  BYTE last;                /* One past the last base to check */
 
-  count = 0;
+  basesPosIndexRange(value, xValue, yValue, &count, &last);
   done = FALSE;
-  while (done == FALSE && count < ((*value)->numBases)) {
+  while (done == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue && (*value)->item[count].armour > 0) { 
       (*value)->item[count].armour -= DAMAGE;
       if ((*value)->item[count].armour > BASE_FULL_ARMOUR) {
@@ -837,12 +853,13 @@ bool basesCanHit(bases *value, BYTE xValue, BYTE yValue, BYTE hitBy) {
   bool returnValue;         /* Value to return */
   bool done;                /* Finished looping */
   BYTE count;               /* Looping Variable */
+  BYTE last;                /* One past the last base to check */
 
   returnValue = FALSE;
   if (hitBy != NEUTRAL) {
-    count = 0;
+    basesPosIndexRange(value, xValue, yValue, &count, &last);
     done = FALSE;
-    while (done == FALSE && count < ((*value)->numBases)) {
+    while (done == FALSE && count < last) {
       if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue) {
         if ((playersIsAllie(screenGetPlayers(), ((*value)->item[count].owner), hitBy) == FALSE) && (*value)->item[count].owner != NEUTRAL && (*value)->item[count].armour > 0) {
           returnValue = TRUE;
@@ -897,11 +914,12 @@ BYTE basesGetOwnerPos(bases *value, BYTE xValue, BYTE yValue) {
   BYTE returnValue;         /* Value to return */
   bool done;                /* Finished looping */
   BYTE count;               /* Looping Variable */
+  BYTE last;                /* One past the last base to check */
 
   returnValue = NEUTRAL;
-  count = 0;
+  basesPosIndexRange(value, xValue, yValue, &count, &last);
   done = FALSE;
-  while (done == FALSE && count < ((*value)->numBases)) {
+  while (done == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue) {
       returnValue = (*value)->item[count].owner;
       done = TRUE;
@@ -979,11 +997,13 @@ void basesSetBaseNetData(bases *value, BYTE *buff, int len)  {
     returnValue++;
     count++;
   }
+  basesPosIndexRebuild(value);
 }
 
 
 void basesSetBaseCompressData(bases *value, BYTE *buff, int dataLen) {
   memcpy(&(**value), buff, SIZEOF_BASES);
+  basesPosIndexRebuild(value);
 }
 
 /*********************************************************
@@ -1219,11 +1239,12 @@ bool baseIsCapturable(bases *value, BYTE xValue, BYTE yValue) {
   bool returnValue; /* Value to return */
   bool done;        /* Finised looping */
   BYTE count;       /* Looping Variable */  
+  BYTE last;        /* One past the last base to check */
 
   returnValue = FALSE;
   done = FALSE;
-  count = 0;
-  while (done == FALSE && count < ((*value)->numBases)) {
+  basesPosIndexRange(value, xValue, yValue, &count, &last);
+  while (done == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue) {
       done = TRUE;
       if ((*value)->item[count].owner == NEUTRAL || (*value)->item[count].armour <= MIN_ARMOUR_CAPTURE) {
@@ -1411,6 +1432,7 @@ void basesMoveAll(bases *value, int moveX, int moveY) {
     (*value)->item[count].y = (BYTE) ((*value)->item[count].y + moveY);
     count++;
   }
+  basesPosIndexRebuild(value);
 }
 
 /*********************************************************
@@ -1497,3 +1519,95 @@ BYTE basesGetNumberOwnedByPlayer(bases *value, BYTE playerNum) {
 
   return returnValue;
 }
+
+/*********************************************************
+*NAME:          basesPosIndexRebuild
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Rebuilds the whole map square to base number index.
+* Must be called whenever the bases are changed in bulk.
+*
+*ARGUMENTS:
+*  value - Pointer to the bases structure
+*********************************************************/
+void basesPosIndexRebuild(bases *value) {
+  BYTE count; /* Looping variable */
+  BYTE *pos;  /* Index entry for the current base */
+
+  memset((*value)->pos, POS_INDEX_NONE, sizeof((*value)->pos));
+  for (count=0;count<(*value)->numBases;count++) {
+    pos = &((*value)->pos[(*value)->item[count].x][(*value)->item[count].y]);
+    if (*pos == POS_INDEX_NONE) {
+      *pos = (BYTE) (count+1);
+    } else {
+      *pos = POS_INDEX_STACKED;
+    }
+  }
+}
+
+/*********************************************************
+*NAME:          basesPosIndexUpdate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Recalculates the index entry for a single map square
+* after a base has been placed on or removed from it.
+*
+*ARGUMENTS:
+*  value  - Pointer to the bases structure
+*  xValue - X Map position
+*  yValue - Y Map position
+*********************************************************/
+void basesPosIndexUpdate(bases *value, BYTE xValue, BYTE yValue) {
+  BYTE count;       /* Looping variable */
+  BYTE returnValue; /* New index entry */
+
+  returnValue = POS_INDEX_NONE;
+  for (count=0;count<(*value)->numBases;count++) {
+    if ((*value)->item[count].x == xValue && (*value)->item[count].y == yValue) {
+      if (returnValue == POS_INDEX_NONE) {
+        returnValue = (BYTE) (count+1);
+      } else {
+        returnValue = POS_INDEX_STACKED;
+      }
+    }
+  }
+  (*value)->pos[xValue][yValue] = returnValue;
+}
+
+/*********************************************************
+*NAME:          basesPosIndexRange
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the range of base array positions that need to be
+* checked for a base at a map square. Empty if there are
+* none, a single item if one base is there or every base
+* if several share the square.
+*
+*ARGUMENTS:
+*  value  - Pointer to the bases structure
+*  xValue - X Map position
+*  yValue - Y Map position
+*  first  - Pointer to hold the first array position
+*  last   - Pointer to hold one past the last position
+*********************************************************/
+void basesPosIndexRange(bases *value, BYTE xValue, BYTE yValue, BYTE *first, BYTE *last) {
+  BYTE pos; /* Index entry for this square */
+
+  pos = (*value)->pos[xValue][yValue];
+  if (pos == POS_INDEX_NONE) {
+    *first = 0;
+    *last = 0;
+  } else if (pos == POS_INDEX_STACKED) {
+    *first = 0;
+    *last = (*value)->numBases;
+  } else {
+    *first = (BYTE) (pos-1);
+    *last = pos;
+  }
+}
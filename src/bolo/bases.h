@@ -703,4 +703,54 @@ BYTE basesGetNumberOwnedByPlayer(bases *value, BYTE playerNum);
 
 void basesSetBaseCompressData(bases *value, BYTE *buff, int dataLen);
 
+/*********************************************************
+*NAME:          basesPosIndexRebuild
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Rebuilds the whole map square to base number index.
+* Must be called whenever the bases are changed in bulk.
+*
+*ARGUMENTS:
+*  value - Pointer to the bases structure
+*********************************************************/
+void basesPosIndexRebuild(bases *value);
+
+/*********************************************************
+*NAME:          basesPosIndexUpdate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Recalculates the index entry for a single map square
+* after a base has been placed on or removed from it.
+*
+*ARGUMENTS:
+*  value  - Pointer to the bases structure
+*  xValue - X Map position
+*  yValue - Y Map position
+*********************************************************/
+void basesPosIndexUpdate(bases *value, BYTE xValue, BYTE yValue);
+
+/*********************************************************
+*NAME:          basesPosIndexRange
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the range of base array positions that need to be
+* checked for a base at a map square. Empty if there are
+* none, a single item if one base is there or every base
+* if several share the square.
+*
+*ARGUMENTS:
+*  value  - Pointer to the bases structure
+*  xValue - X Map position
+*  yValue - Y Map position
+*  first  - Pointer to hold the first array position
+*  last   - Pointer to hold one past the last position
+*********************************************************/
+void basesPosIndexRange(bases *value, BYTE xValue, BYTE yValue, BYTE *first, BYTE *last);
+
 #endif /* BASES_H */
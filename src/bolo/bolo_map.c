@@ -20,7 +20,7 @@
 *Filename:      bolo_map.c
 *Author:        John Morrison
 *Creation Date: 21/10/98
-*Last Modified: 15/01/02
+*Last Modified: 16/10/26
 *Purpose:
 *  Provides operations for read and writing of
 *  Bolo map files
@@ -44,6 +44,7 @@
 #include "log.h"
 #include "screenbrainmap.h"
 #include "screen.h"
+#include "mapfile.h"
 
 #undef MAP_MAX_SERVER_WAIT
 #define MAP_MAX_SERVER_WAIT 200
@@ -51,14 +52,61 @@
 int lzwdecoding(char *src, char *dest, int len);
 int lzwencoding(char *src, char *dest, int len);
 
+#if MAP_NET_WHEEL_SIZE <= MAP_MAX_SERVER_WAIT + 1
+#error MAP_NET_WHEEL_SIZE must be greater than MAP_MAX_SERVER_WAIT + 1
+#endif
+
+/*********************************************************
+*NAME:          mapNetGrow
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Makes the pending change pool MAP_NET_POOL_SIZE items if
+* it is empty or doubles it otherwise, up to
+* MAP_NET_MAX_ITEMS. The new items go on the free list.
+* Items are found by index so the pool can move. Returns
+* FALSE if it is at its limit or out of memory
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*********************************************************/
+static bool mapNetGrow(map *value) {
+  mapNetItem *q;      /* Grown pool */
+  unsigned long size; /* Items after index 0 in the grown pool */
+  unsigned long count; /* Looping variable */
+
+  if ((*value)->netSize >= MAP_NET_MAX_ITEMS) {
+    return FALSE;
+  }
+  size = (unsigned long) (*value)->netSize * 2;
+  if (size == 0) {
+    size = MAP_NET_POOL_SIZE;
+  } else if (size > MAP_NET_MAX_ITEMS) {
+    size = MAP_NET_MAX_ITEMS;
+  }
+  q = realloc((*value)->netItem, sizeof(mapNetItem) * (size + 1));
+  if (q == NULL) {
+    return FALSE;
+  }
+  for (count=(*value)->netSize+1;count<size;count++) {
+    q[count].next = (mapNetIndex) (count + 1);
+  }
+  q[size].next = (*value)->netFree;
+  (*value)->netFree = (mapNetIndex) ((*value)->netSize + 1);
+  (*value)->netItem = q;
+  (*value)->netSize = (mapNetIndex) size;
+  return TRUE;
+}
+
 /*********************************************************
 *NAME:          mapCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Creates and initilises the map structure. Sets all 
-*  map squares to be deep sea
+*  map squares to be deep sea and nothing pending
 *
 *ARGUMENTS:
 *  value - Pointer to the map file
@@ -68,20 +116,25 @@ void mapCreate(map *value) {
   int count2; /* Looping variable */
 
   New(*value);
+  memset(*value, 0, sizeof(**value));
   for (count=0;count<MAP_ARRAY_SIZE ;count++) {
     for (count2=0;count2<MAP_ARRAY_SIZE;count2++) {
       ((*value)->mapItem[count][count2]) = DEEP_SEA;
     }
   }
-  (*value)->mn = NULL;
-  (*value)->mninc = NULL;
+  (*value)->netItem = NULL;
+  (*value)->netFree = MAP_NET_NONE;
+  mapNetGrow(value);
+  (*value)->mn = MAP_NET_NONE;
+  (*value)->mnSend = MAP_NET_NONE;
+  (*value)->changedAll = TRUE;
 }
 
 /*********************************************************
 *NAME:          mapDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 23/2/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Destroys the map data structure. Also frees memory.
 *
@@ -89,24 +142,10 @@ void mapCreate(map *value) {
 *  value - Pointer to the map file
 *********************************************************/
 void mapDestroy(map *value) {
-  mapNet q;
-  
   if (*value != NULL) {
-    q = (*value)->mn;
-    while (NonEmpty((*value)->mn)) {
-      (*value)->mn = MapNetTail(q);
-      Dispose(q);
-      q = (*value)->mn;
+    if ((*value)->netItem != NULL) {
+      Dispose((*value)->netItem);
     }
-
-    q = (*value)->mninc;
-    while (NonEmpty((*value)->mninc)) {
-      (*value)->mninc = MapNetTail(q);
-      Dispose(q);
-      q = (*value)->mninc;
-    }
-    (*value)->mn = NULL;
-    (*value)->mninc = NULL;
     Dispose(*value);
   }
   *value = NULL;
@@ -116,20 +155,20 @@ void mapDestroy(map *value) {
 *NAME:          mapReadPills
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Reads the pill information from a map file
-*  into the pill structure. Returns if the 
-*  operation was successful or not
+*  Reads the pill information from a map file in memory
+*  into the pill structure and moves buff past it.
+*  Returns if the operation was successful or not
 *
 *ARGUMENTS:
-*  fp    - Pointer to the file being read from
+*  buff  - Pointer to the position in the file
+*  end   - End of the file
 *  value - Pointer to the pillbox structure
 *********************************************************/
-bool mapReadPills(FILE *fp, pillboxes *value) {
+bool mapReadPills(BYTE **buff, BYTE *end, pillboxes *value) {
   int total;        /* Total number of pills to be read in */
   int count;        /* Looping variable */
-  size_t ret;          /* Number of bytes read */
   bool returnValue; /* Value to return */
   pillbox readInto; /* The pillbox being read into */
   
@@ -138,11 +177,12 @@ bool mapReadPills(FILE *fp, pillboxes *value) {
   returnValue = TRUE;
   readInto.inTank = FALSE;
 
-  while (count <= total && returnValue == TRUE && !feof(fp)) {
-    ret = fread(&readInto, SIZEOFBMAP_PILL_INFO, 1, fp);
-    if (ret != 1) {
+  while (count <= total && returnValue == TRUE) {
+    if (end - *buff < SIZEOFBMAP_PILL_INFO) {
       returnValue = FALSE;
     } else {
+      memcpy(&readInto, *buff, SIZEOFBMAP_PILL_INFO);
+      *buff += SIZEOFBMAP_PILL_INFO;
       readInto.justSeen = FALSE;
       pillsSetPill(value,&readInto,(BYTE) count);
     }
@@ -155,20 +195,20 @@ bool mapReadPills(FILE *fp, pillboxes *value) {
 *NAME:          mapReadBases
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Reads the base information from a map file
-*  into the base structure. Returns if the 
-*  operation was successful or not
+*  Reads the base information from a map file in memory
+*  into the base structure and moves buff past it.
+*  Returns if the operation was successful or not
 *
 *ARGUMENTS:
-*  fp    - Pointer to the file being read from
+*  buff  - Pointer to the position in the file
+*  end   - End of the file
 *  value - Pointer to the pillbox structure
 *********************************************************/
-bool mapReadBases(FILE *fp, bases *value) {
+bool mapReadBases(BYTE **buff, BYTE *end, bases *value) {
   int count;        /* Looping variable */
   int total;        /* Total number of bases to read */
-  size_t ret;          /* Number of bytes read */
   bool returnValue; /* Value to return */
   base readInto;    /* The base structure to read into */
 
@@ -176,11 +216,12 @@ bool mapReadBases(FILE *fp, bases *value) {
   total = basesGetNumBases(value);
   returnValue = TRUE;
 
-  while (count <= total && returnValue == TRUE && !feof(fp)) {
-    ret = fread(&readInto,SIZEOFBAMP_BASE_INFO,1,fp);
-    if (ret != 1) {
+  while (count <= total && returnValue == TRUE) {
+    if (end - *buff < SIZEOFBAMP_BASE_INFO) {
       returnValue = FALSE;
     } else {
+      memcpy(&readInto, *buff, SIZEOFBAMP_BASE_INFO);
+      *buff += SIZEOFBAMP_BASE_INFO;
       readInto.baseTime = 0;     /* Time between stock updates */
       basesSetBase(value,&readInto,(BYTE) count);
     }
@@ -193,31 +234,32 @@ bool mapReadBases(FILE *fp, bases *value) {
 *NAME:          mapReadStarts
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Reads the player start information from a map file
-*  into the player starts structure. Returns if the 
-*  operation was successful or not
+*  Reads the player start information from a map file in
+*  memory into the player starts structure and moves buff
+*  past it. Returns if the operation was successful or not
 *
 *ARGUMENTS:
-*  fp    - Pointer to the file being read from
+*  buff  - Pointer to the position in the file
+*  end   - End of the file
 *  value - Pointer to the pillbox structure
 *********************************************************/
-bool mapReadStarts(FILE *fp, starts *value) {
+bool mapReadStarts(BYTE **buff, BYTE *end, starts *value) {
   int total;        /* Total number of entries to read */
   int count;        /* Looping variable */
-  size_t ret;          /* Number of bytes read */
   bool returnValue; /* Value to return */
   start readInto;   /* Item to read into */
 
   count = 1;
   total = startsGetNumStarts(value);
   returnValue = TRUE;
-  while (count <= total && returnValue == TRUE && !feof(fp)) {
-    ret = fread(&readInto,SIZEOFBMAP_START_INFO,1,fp);
-    if (ret != 1) {
+  while (count <= total && returnValue == TRUE) {
+    if (end - *buff < SIZEOFBMAP_START_INFO) {
       returnValue = FALSE;
     } else {
+      memcpy(&readInto, *buff, SIZEOFBMAP_START_INFO);
+      *buff += SIZEOFBMAP_START_INFO;
       startsSetStart(value, &readInto, (BYTE) count);
     }
     count++;
@@ -229,125 +271,68 @@ bool mapReadStarts(FILE *fp, starts *value) {
 *NAME:          mapProcessRun
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Process a single map run and puts values into map
-*  data structure.
+*  data structure. The run is a stream of nibbles, high
+*  nibble first. Each length nibble is followed by length
+*  + 1 different items if it is below MAP_RUN_DIFF or one
+*  item repeated length - MAP_RUN_SAME times if not.
 *  Returns whether operation was successful or not
 *
 *ARGUMENTS:
-*  fp     - Pointer to the file being read from
+*  buff   - Run data. Must hold elems bytes
 *  value  - Pointer to the map data structure
 *  elems  - Number of elements in the run
 *  yValue - The y Map co-ordinate
 *  startX - The start x co-ordinate
 *  endX   - The end x co-ordinate
 *********************************************************/
-bool mapProcessRun(FILE *fp,map *value,BYTE elems, MAP_Y yValue, BYTE startX, BYTE endX) {
-  bool returnValue;  /* Value to return */
-  bool needRead;     /* State variable - Do we need to read the next byte */
-  mapRunState state; /* Current run state */  
-  BYTE item;         /* Item being worked on */
-  BYTE highNibble;   /* The low nibble of a byte */
-  BYTE lowNibble;    /* The low nibble of a byte */
-  BYTE len;          /* Length of the row */
-  BYTE mapPos;       /* Possision on map */
-  int count;         /* Looping variables */
-  int count2;
-  
-  count = 0;
-  returnValue = TRUE;
-  state = highLen;
+bool mapProcessRun(BYTE *buff, map *value, BYTE elems, MAP_Y yValue, BYTE startX, BYTE endX) {
+  int nibble;    /* Next nibble to read */
+  int numNibbles;/* Nibbles in the run */
+  int mapPos;    /* Possision on map */
+  int len;       /* Length of the current part */
+  BYTE item;     /* Item being worked on */
+
+  nibble = 0;
+  numNibbles = elems * 2;
   mapPos = startX;
-  len = 0;
-
-  item = (BYTE) fgetc(fp);
-  while (count < elems && !ferror(fp)) {
-    needRead = FALSE;
-    highNibble = lowNibble = item;
-    /* Extract Nibbles */
-    highNibble >>= MAP_SHIFT_SIZE;
-    lowNibble <<= MAP_SHIFT_SIZE;
-    lowNibble >>= MAP_SHIFT_SIZE;
-
-    while (needRead == FALSE) {
-      switch (state) {
-      
-      case highLen:
-        len = highNibble;
-        if (len < MAP_RUN_DIFF) {
-          state = lowDiff;
-          len++;
-        } else {
-          state = lowSame;
-        }
-        break;
-      
-      case lowLen:
-        len = lowNibble;
-        if (len < MAP_RUN_DIFF) {
-          state = highDiff;
-          len++;
-        } else {
-          state = highSame;
+
+  while (nibble < numNibbles) {
+    len = (buff[nibble >> 1] >> ((~nibble & 1) * MAP_SHIFT_SIZE)) & 0x0F;
+    nibble++;
+    if (len < MAP_RUN_DIFF) {
+      /* Different items */
+      len++;
+      while (len > 0 && nibble < numNibbles) {
+        if (mapPos > MAP_ARRAY_LAST) {
+          return FALSE;
         }
-        needRead = TRUE;
-        break;
-      
-      case lowDiff:
-        ((*value)->mapItem[mapPos][yValue]) = lowNibble;
+        (*value)->mapItem[mapPos][yValue] = (buff[nibble >> 1] >> ((~nibble & 1) * MAP_SHIFT_SIZE)) & 0x0F;
         mapPos++;
+        nibble++;
         len--;
-        if (len == 0) {
-          state = highLen;
-        } else {
-          state = highDiff;
-        }
-        needRead = TRUE;
-        break;
-
-      case highDiff:
-        ((*value)->mapItem[mapPos][yValue]) = highNibble;
+      }
+    } else if (nibble < numNibbles) {
+      /* The same item */
+      item = (buff[nibble >> 1] >> ((~nibble & 1) * MAP_SHIFT_SIZE)) & 0x0F;
+      nibble++;
+      len -= MAP_RUN_SAME;
+      if (mapPos + len > MAP_ARRAY_SIZE) {
+        return FALSE;
+      }
+      while (len > 0) {
+        (*value)->mapItem[mapPos][yValue] = item;
         mapPos++;
         len--;
-        if (len == 0) {
-          state = lowLen;
-        } else {
-          state = lowDiff;
-        }
-        break;
-
-      case lowSame:
-        count2 = 0;
-        while (count2 < (len-MAP_RUN_SAME)) {
-          ((*value)->mapItem[mapPos+count2][yValue]) = lowNibble;
-          count2++;
-        }
-        mapPos = (BYTE) (mapPos + count2);
-        state = highLen;
-        needRead = TRUE;
-        break;
-
-      case highSame:
-        count2 = 0;
-        while (count2 < (len-MAP_RUN_SAME)) {
-          ((*value)->mapItem[mapPos+count2][yValue]) = highNibble;
-          count2++;
-        }
-        mapPos = (BYTE) (mapPos + count2);
-        state = lowLen;
-        break;
       }
     }
-    count++;
-    item = (BYTE) fgetc(fp);
   }
-  count2 = ungetc(item, fp);
+
+  (*value)->changedAll = TRUE;
   /* Check all read correctly */
-  if (count != elems || mapPos != endX || count2 == EOF)  { /*  || mapPos != endX */ 
-    returnValue = FALSE;
-  }
-  return returnValue;
+  return (bool) ((BYTE) mapPos == endX);
 }
 
 
@@ -355,57 +340,159 @@ bool mapProcessRun(FILE *fp,map *value,BYTE elems, MAP_Y yValue, BYTE startX, BY
 *NAME:          mapReadRuns
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Reads the map runs into the map data structure
-*  Returns if the operation was successful or not
+*  Reads the map runs from a map file in memory into the
+*  map data structure. Stops at the last run or the end
+*  of the file. Returns if the operation was successful
+*  or not
 *
 *ARGUMENTS:
-*  fp    - Pointer to the file being read from
+*  buff  - Start of the runs
+*  end   - End of the file
 *  value - Pointer to the map data structure
 *********************************************************/
-bool mapReadRuns(FILE *fp, map *value) {
+bool mapReadRuns(BYTE *buff, BYTE *end, map *value) {
   bmapRunHeader runHead; /* The header of each run */
-  size_t bytesRead;         /* The number of bytes read from the header */
+  int elems;             /* Bytes of run data */
   bool returnValue;      /* Value to return */
   bool done;             /* Is all the runs read */
-  bool ret;              /* Function return Value */
 
   returnValue = TRUE;
   done = FALSE;
 
-  bytesRead = fread(&runHead,SIZEOFBMAP_RUN_HEADER,1,fp);
-
-  while (!feof(fp) && done == FALSE) {
-    if (bytesRead != 1) {
-    /* Something bad happened reading */
+  while (done == FALSE && end - buff >= SIZEOFBMAP_RUN_HEADER) {
+    memcpy(&runHead, buff, SIZEOFBMAP_RUN_HEADER);
+    buff += SIZEOFBMAP_RUN_HEADER;
+    elems = runHead.datalen - SIZEOFBMAP_RUN_HEADER;
+    if (runHead.datalen == 4  &&  runHead.y == MAP_ARRAY_LAST && runHead.startx == MAP_ARRAY_LAST && runHead.endx == MAP_ARRAY_LAST) {
+    /* Finished reading */
+      done = TRUE;
+    } else if (elems < 0 || end - buff < elems) {
+    /* Run is cut short */
       done = TRUE;
       returnValue = FALSE;
-    } else if (runHead.datalen == 4  &&  runHead.y == MAP_ARRAY_LAST && runHead.startx == MAP_ARRAY_LAST && runHead.endx == MAP_ARRAY_LAST) {
-    /* Finished reading */
+    } else if (mapProcessRun(buff, value, (BYTE) elems, runHead.y, runHead.startx, runHead.endx) == FALSE) {
       done = TRUE;
-      returnValue = TRUE;
+      returnValue = FALSE;
     } else {
-      ret = mapProcessRun(fp,value,(BYTE) ((runHead.datalen)- SIZEOFBMAP_RUN_HEADER),runHead.y, runHead.startx, runHead.endx);
-      if (ret == FALSE) {
-        /* Function return failed */
-        done = TRUE;
-        returnValue = FALSE;
-      }
+      buff += elems;
     }
-    bytesRead = fread(&runHead,SIZEOFBMAP_RUN_HEADER,1,fp);
   }
 
   return returnValue;
 }
 
+/*********************************************************
+*NAME:          mapReadTables
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads the header, pills, bases and starts from the
+*  start of a map file in memory. Returns the number of
+*  bytes read, which is where the runs start, or 0 if
+*  they are not valid
+*
+*ARGUMENTS:
+*  buff - Map file
+*  len  - Length of the file
+*  pb   - Pointer to the pillbox structure
+*  bs   - Pointer to the bases structure
+*  ss   - Pointer to the starts structure
+*********************************************************/
+int mapReadTables(BYTE *buff, int len, pillboxes *pb, bases *bs, starts *ss) {
+  BYTE *pos; /* Position in the file */
+  BYTE *end; /* End of the file */
+
+  pos = buff;
+  end = buff + len;
+  if (len < LENGTH_ID + 4 || memcmp(pos, MAP_HEADER, LENGTH_ID) != 0) {
+    return 0;
+  }
+  pos += LENGTH_ID;
+  if (*pos != CURRENT_MAP_VERSION) {
+    return 0;
+  }
+  pos++;
+  pillsSetNumPills(pb, pos[0]);
+  basesSetNumBases(bs, pos[1]);
+  startsSetNumStarts(ss, pos[2]);
+  pos += 3;
+  if (pillsGetNumPills(pb) > MAX_PILLS || basesGetNumBases(bs) > MAX_BASES || startsGetNumStarts(ss) > MAX_STARTS) {
+    return 0;
+  }
+  if (mapReadPills(&pos, end, pb) == FALSE || mapReadBases(&pos, end, bs) == FALSE || mapReadStarts(&pos, end, ss) == FALSE) {
+    return 0;
+  }
+  return (int) (pos - buff);
+}
+
+/*********************************************************
+*NAME:          mapMakeTables
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes the header, pills, bases and starts the way
+*  they start a map file. buff must hold
+*  MAP_TABLES_MAX_SIZE bytes. Returns the length written
+*
+*ARGUMENTS:
+*  pb   - Pointer to the pillbox structure
+*  bs   - Pointer to the bases structure
+*  ss   - Pointer to the starts structure
+*  buff - Buffer to write to
+*********************************************************/
+int mapMakeTables(pillboxes *pb, bases *bs, starts *ss, BYTE *buff) {
+  BYTE *pos;       /* Position in the buffer */
+  BYTE count;      /* Looping variable */
+  pillbox pill;    /* Pill being written */
+  base bse;        /* Base being written */
+  start st;        /* Start being written */
+
+  pos = buff;
+  memcpy(pos, MAP_HEADER, LENGTH_ID);
+  pos += LENGTH_ID;
+  *pos++ = CURRENT_MAP_VERSION;
+  *pos++ = pillsGetNumPills(pb);
+  *pos++ = basesGetNumBases(bs);
+  *pos++ = startsGetNumStarts(ss);
+  for (count = 1; count <= pillsGetNumPills(pb); count++) {
+    pillsGetPill(pb, &pill, count);
+    *pos++ = pill.x;
+    *pos++ = pill.y;
+    *pos++ = pill.owner;
+    *pos++ = pill.armour;
+    *pos++ = pill.speed;
+  }
+  for (count = 1; count <= basesGetNumBases(bs); count++) {
+    basesGetBase(bs, &bse, count);
+    *pos++ = bse.x;
+    *pos++ = bse.y;
+    *pos++ = bse.owner;
+    *pos++ = bse.armour;
+    *pos++ = bse.shells;
+    *pos++ = bse.mines;
+  }
+  for (count = 1; count <= startsGetNumStarts(ss); count++) {
+    startsGetStartStruct(ss, &st, count);
+    *pos++ = st.x;
+    *pos++ = st.y;
+    *pos++ = st.dir;
+  }
+  return (int) (pos - buff);
+}
+
 /*********************************************************
 *NAME:          mapRead
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED:  13/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Reads a map in.
+*  Reads a map in. The file is mapped into memory and
+*  decoded in place. If cache files are on a valid cache
+*  is loaded instead, or written once the map is decoded.
 * Returns if the operation was successful or not
 *
 *ARGUMENTS:
@@ -416,59 +503,30 @@ bool mapReadRuns(FILE *fp, map *value) {
 *  pb      - Pointer to the pillbox structure
 *********************************************************/
 bool mapRead(char *fileName, map *value, pillboxes *pb, bases *bs, starts *ss) {
-  FILE *fp;           /* File pointer */
+  mapFile mf;         /* The mapped file */
   bool returnValue;   /* Value to return */
-  char id[LENGTH_ID+1]; /* The map ID Should read "BMAPBOLO" */
-  BYTE mapVersion;    /* Version of the map file */
-  BYTE current;       /* Item being read */
-  char *str;          /* return value of fgets */
+  int tablesLen;      /* Bytes before the first run */
 
-  returnValue = TRUE;
-  fp = fopen(fileName,"rb");
-  if (!fp) {
-    returnValue = FALSE;
+  if (mapFileGetCache() == TRUE && mapFileReadCache(fileName, value, pb, bs, ss) == TRUE) {
+    return TRUE;
   }
-  if (returnValue == TRUE && fp) {
-    str = fgets(id, (LENGTH_ID+1), fp);
-    if (str == NULL || strcmp(id,MAP_HEADER) != 0) {
-      returnValue = FALSE;
-    }
-  }
-  if (returnValue == TRUE && fp) {
-    mapVersion = (BYTE) fgetc(fp);
-    if (mapVersion != CURRENT_MAP_VERSION) {
-      returnValue = FALSE;
-    }
-  }
-  if (returnValue == TRUE && fp) {
-    current = (BYTE) fgetc(fp);
-    pillsSetNumPills(pb,current);
-    current = (BYTE) fgetc(fp);
-    basesSetNumBases(bs,current); 
-    current = (BYTE) fgetc(fp);
-    startsSetNumStarts(ss,current);
-    if (pillsGetNumPills(pb) > MAX_PILLS || basesGetNumBases(bs) > MAX_BASES || startsGetNumStarts(ss) > MAX_STARTS) {
+
+  returnValue = mapFileOpen(fileName, &mf);
+  if (returnValue == TRUE) {
+    tablesLen = mapReadTables(mf.data, mf.len, pb, bs, ss);
+    if (tablesLen == 0) {
       returnValue = FALSE;
+    } else {
+      returnValue = mapReadRuns(mf.data + tablesLen, mf.data + mf.len, value);
     }
-  }
-  if (returnValue == TRUE && fp) {
-    returnValue = mapReadPills(fp,pb);
-  }
-  if (returnValue == TRUE && fp) {
-    returnValue = mapReadBases(fp,bs);
-  }
-  if (returnValue == TRUE && fp) {
-    returnValue = mapReadStarts(fp,ss);
-  }
-  if (returnValue == TRUE && fp) {
-    returnValue = mapReadRuns(fp,value);
+    mapFileClose(&mf);
   }
 
-  if (returnValue == TRUE && fp) {
+  if (returnValue == TRUE) {
     mapCenter(value, pb, bs, ss);
-  }
-  if (fp) {
-    fclose(fp);
+    if (mapFileGetCache() == TRUE) {
+      mapFileWriteCache(fileName, value, pb, bs, ss);
+    }
   }
   return returnValue;
    
@@ -833,11 +891,32 @@ bool mapIsPassable(map *value, BYTE xValue, BYTE yValue, bool onBoat) {
   return returnValue;
 }
 
+/*********************************************************
+*NAME:          mapDirtyPos
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Marks a square as changed so cached net runs holding
+* its row are made again and the screen redraws the
+* tiles around it
+*
+*ARGUMENTS:
+*  value - Pointer to the map data structure
+*  xPos  - The column
+*  yPos  - The row
+*********************************************************/
+static void mapDirtyPos(map *value, BYTE xPos, BYTE yPos) {
+  (*value)->dirtyRows[yPos >> 3] |= (BYTE) (1 << (yPos & 7));
+  (*value)->changed[yPos][xPos >> 3] |= (BYTE) (1 << (xPos & 7));
+  (*value)->changedRows[yPos >> 3] |= (BYTE) (1 << (yPos & 7));
+}
+
 /*********************************************************
 *NAME:          mapSetPos
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/12/98
-*LAST MODIFIED: 05/05/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets a position on the map
 *
@@ -857,6 +936,7 @@ void mapSetPos(map *value, BYTE xValue, BYTE yValue, BYTE terrain, bool needSend
   if (netGetType() == netSingle || mineClear == TRUE) {
     /* Single player game */
       (*value)->mapItem[xValue][yValue] = terrain;
+      mapDirtyPos(value, xValue, yValue);
       screenBrainMapSetPos(xValue, yValue, terrain, minesExistPos(screenGetMines(), xValue, yValue));
   } else {
     /* Multiplayer game */
@@ -1312,11 +1392,250 @@ long mapPrepareRun(map *value, bmapRun *run, BYTE *xPos, BYTE *yPos) {
 	return(run->datalen = nibble_data - (BYTE*)run);
 }
 
+/*********************************************************
+*NAME:          mapNetQueueHead
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns the head of the queue an item is waiting on.
+* Outgoing items still to be sent wait on the send queue,
+* everything else waits in a timing wheel bucket.
+*
+*ARGUMENTS:
+*  value  - Pointer to the map structure
+*  list   - MAP_NET_OUT or MAP_NET_IN
+*  bucket - Queue number (MAP_NET_SEND or wheel bucket + 1)
+*********************************************************/
+static mapNetIndex *mapNetQueueHead(map *value, BYTE list, unsigned short bucket) {
+  if (bucket == MAP_NET_SEND) {
+    return &((*value)->mnSend);
+  }
+  return &((*value)->wheel[list][bucket-1]);
+}
+
+/*********************************************************
+*NAME:          mapNetUnqueue
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Takes an item off the queue it is waiting on if any
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  pos   - Item to remove
+*********************************************************/
+static void mapNetUnqueue(map *value, mapNetIndex pos) {
+  mapNetItem *q;      /* Item being removed */
+  mapNetIndex *head; /* Head of the queue */
+
+  q = &((*value)->netItem[pos]);
+  if (q->bucket != MAP_NET_UNQUEUED) {
+    head = mapNetQueueHead(value, q->list, q->bucket);
+    if (q->waitPrev != MAP_NET_NONE) {
+      (*value)->netItem[q->waitPrev].waitNext = q->waitNext;
+    } else {
+      *head = q->waitNext;
+    }
+    if (q->waitNext != MAP_NET_NONE) {
+      (*value)->netItem[q->waitNext].waitPrev = q->waitPrev;
+    }
+    q->bucket = MAP_NET_UNQUEUED;
+    q->waitNext = MAP_NET_NONE;
+    q->waitPrev = MAP_NET_NONE;
+  }
+}
+
+/*********************************************************
+*NAME:          mapNetQueue
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* (Re)starts the wait on an item. Items that need sending
+* go on the send queue. Others go in the wheel bucket for
+* the tick they run out of time on. Queues are kept
+* newest first so they are drained in the order the old
+* list scans visited them.
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  pos   - Item to queue
+*********************************************************/
+static void mapNetQueue(map *value, mapNetIndex pos) {
+  mapNetItem *q;      /* Item being queued */
+  mapNetIndex *head; /* Head of the queue */
+  mapNetIndex prev;  /* Item to insert after */
+  mapNetIndex next;  /* Item to insert before */
+
+  mapNetUnqueue(value, pos);
+  q = &((*value)->netItem[pos]);
+  if (q->list == MAP_NET_OUT && q->needSend == TRUE) {
+    q->bucket = MAP_NET_SEND;
+  } else {
+    q->bucket = (unsigned short) ((((*value)->netTick + MAP_MAX_SERVER_WAIT + 1) & (MAP_NET_WHEEL_SIZE - 1)) + 1);
+  }
+  head = mapNetQueueHead(value, q->list, q->bucket);
+
+  prev = MAP_NET_NONE;
+  next = *head;
+  while (next != MAP_NET_NONE && (*value)->netItem[next].seq > q->seq) {
+    prev = next;
+    next = (*value)->netItem[next].waitNext;
+  }
+  q->waitPrev = prev;
+  q->waitNext = next;
+  if (prev != MAP_NET_NONE) {
+    (*value)->netItem[prev].waitNext = pos;
+  } else {
+    *head = pos;
+  }
+  if (next != MAP_NET_NONE) {
+    (*value)->netItem[next].waitPrev = pos;
+  }
+}
+
+/*********************************************************
+*NAME:          mapNetFind
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Finds a pending item at a map square. Returns 
+* MAP_NET_NONE if there isn't one.
+*
+*ARGUMENTS:
+*  value    - Pointer to the map structure
+*  list     - MAP_NET_OUT or MAP_NET_IN
+*  mx       - X position
+*  my       - Y position
+*  terrain  - Terrain the item must have
+*  anyTerr  - Match any terrain
+*********************************************************/
+static mapNetIndex mapNetFind(map *value, BYTE list, BYTE mx, BYTE my, BYTE terrain, bool anyTerr) {
+  mapNetIndex pos; /* Looping variable */
+  mapNetItem *q;
+
+  pos = (*value)->netPos[mx][my];
+  while (pos != MAP_NET_NONE) {
+    q = &((*value)->netItem[pos]);
+    if (q->list == list && (anyTerr == TRUE || q->terrain == terrain)) {
+      return pos;
+    }
+    pos = q->nextPos;
+  }
+  return MAP_NET_NONE;
+}
+
+/*********************************************************
+*NAME:          mapNetNewItem
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Takes an item from the pool and adds it to a list and
+* its map square. Outgoing items are also put at the head
+* of the outgoing list. The pool is grown if it is used
+* up. Returns MAP_NET_NONE and counts the change as lost
+* if it can't be.
+*
+*ARGUMENTS:
+*  value    - Pointer to the map structure
+*  list     - MAP_NET_OUT or MAP_NET_IN
+*  mx       - X position
+*  my       - Y position
+*  terrain  - New terrain
+*  needSend - Do we need to send this?
+*********************************************************/
+static mapNetIndex mapNetNewItem(map *value, BYTE list, BYTE mx, BYTE my, BYTE terrain, bool needSend) {
+  mapNetIndex pos; /* Item to use */
+  mapNetItem *q;
+
+  if ((*value)->netFree == MAP_NET_NONE && mapNetGrow(value) == FALSE) {
+    if ((*value)->netLost == 0) {
+      messageAdd(globalMessage, (char *) "Map", (char *) "Pending change pool is full, map changes are being lost");
+    }
+    (*value)->netLost++;
+    return MAP_NET_NONE;
+  }
+  pos = (*value)->netFree;
+  if (pos != MAP_NET_NONE) {
+    q = &((*value)->netItem[pos]);
+    (*value)->netFree = q->next;
+    q->mx = mx;
+    q->my = my;
+    q->terrain = terrain;
+    q->oldTerrain = (*value)->mapItem[mx][my];
+    q->needSend = needSend;
+    q->list = list;
+    q->bucket = MAP_NET_UNQUEUED;
+    q->seq = (*value)->netSeq;
+    (*value)->netSeq++;
+    q->waitNext = MAP_NET_NONE;
+    q->waitPrev = MAP_NET_NONE;
+    q->nextPos = (*value)->netPos[mx][my];
+    (*value)->netPos[mx][my] = pos;
+    q->prev = MAP_NET_NONE;
+    q->next = MAP_NET_NONE;
+    if (list == MAP_NET_OUT) {
+      q->next = (*value)->mn;
+      if ((*value)->mn != MAP_NET_NONE) {
+        (*value)->netItem[(*value)->mn].prev = pos;
+      }
+      (*value)->mn = pos;
+    }
+    mapNetQueue(value, pos);
+  }
+  return pos;
+}
+
+/*********************************************************
+*NAME:          mapNetDeleteItem
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Removes an item from its queue, map square and list and
+* returns it to the pool
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  pos   - Item to delete
+*********************************************************/
+static void mapNetDeleteItem(map *value, mapNetIndex pos) {
+  mapNetItem *q;      /* Item being deleted */
+  mapNetIndex *link; /* Link to it from its map square */
+
+  mapNetUnqueue(value, pos);
+  q = &((*value)->netItem[pos]);
+
+  link = &((*value)->netPos[q->mx][q->my]);
+  while (*link != pos) {
+    link = &((*value)->netItem[*link].nextPos);
+  }
+  *link = q->nextPos;
+
+  if (q->list == MAP_NET_OUT) {
+    if (q->prev != MAP_NET_NONE) {
+      (*value)->netItem[q->prev].next = q->next;
+    } else {
+      (*value)->mn = q->next;
+    }
+    if (q->next != MAP_NET_NONE) {
+      (*value)->netItem[q->next].prev = q->prev;
+    }
+  }
+  q->prev = MAP_NET_NONE;
+  q->next = (*value)->netFree;
+  (*value)->netFree = pos;
+}
+
 /*********************************************************
 *NAME:          mapNetAdd
 *AUTHOR:        John Morrison
 *CREATION DATE: 23/2/99
-*LAST MODIFIED: 27/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Adds a item to the mapNet structure. If an item already
 * exists at that position it repaces it with the new
@@ -1330,35 +1649,21 @@ long mapPrepareRun(map *value, bmapRun *run, BYTE *xPos, BYTE *yPos) {
 *  needSend - Should we send this update?
 *********************************************************/
 void mapNetAdd(map *value, BYTE mx, BYTE my, BYTE terrain, bool needSend) {
-  mapNet q;
+  mapNetIndex pos;
   bool done;
 
 
   done = FALSE;
   /* Check to see it is in the incoming buffer */
   if (threadsGetContext() == FALSE) {
-    q = (*value)->mninc;
-    while (NonEmpty(q) && done == FALSE) {
-      if (q->mx == mx && q->my == my && q->terrain == terrain) {
-        /* Exists */
-        (*value)->mapItem[mx][my] = terrain;
-        screenBrainMapSetPos(mx, my, terrain, minesExistPos(screenGetMines(), mx, my));
-        if (q->prev != NULL) {
-          q->prev->next = q->next;
-        } else {
-          (*value)->mninc = MapNetTail((*value)->mninc);
-          if (NonEmpty((*value)->mninc)) {
-            (*value)->mninc->prev = NULL;
-          }
-        }
-        if (q->next != NULL) {
-          q->next->prev = q->prev;
-        }
-        Dispose(q);
-        done = TRUE;
-      } else {
-        q = MapNetTail(q);
-      }
+    pos = mapNetFind(value, MAP_NET_IN, mx, my, terrain, FALSE);
+    if (pos != MAP_NET_NONE) {
+      /* Exists */
+      (*value)->mapItem[mx][my] = terrain;
+      mapDirtyPos(value, mx, my);
+      screenBrainMapSetPos(mx, my, terrain, minesExistPos(screenGetMines(), mx, my));
+      mapNetDeleteItem(value, pos);
+      done = TRUE;
     }
   } /*else if (terrain == RIVER || terrain == CRATER) {
       floodAddItem(mx, my);
@@ -1370,33 +1675,19 @@ void mapNetAdd(map *value, BYTE mx, BYTE my, BYTE terrain, bool needSend) {
 
   
   if ((*value)->mapItem[mx][my] != terrain) {
-    q = (*value)->mn;
-    while (NonEmpty(q) && done == FALSE) {
-      if (q->mx == mx && q->my == my) {
-        q->terrain = terrain;
-        q->length = 0;
-        q->needSend = needSend;
-        done = TRUE;
-      }
-      q = MapNetTail(q);
-    } 
-    /* If not found then add it */
     if (done == FALSE) {
-      New(q);
-      q->mx = mx;
-      q->my = my;
-      q->terrain = terrain;
-      q->oldTerrain = (*value)->mapItem[mx][my];
-      q->length = 0;
-      q->needSend = needSend;
-      q->next = (*value)->mn;
-      q->prev = NULL;
-      if (NonEmpty((*value)->mn)) {
-        (*value)->mn->prev = q;
+      pos = mapNetFind(value, MAP_NET_OUT, mx, my, terrain, TRUE);
+      if (pos != MAP_NET_NONE) {
+        (*value)->netItem[pos].terrain = terrain;
+        (*value)->netItem[pos].needSend = needSend;
+        mapNetQueue(value, pos);
+      } else {
+        /* If not found then add it */
+        mapNetNewItem(value, MAP_NET_OUT, mx, my, terrain, needSend);
       }
-      (*value)->mn = q;
     }
     (*value)->mapItem[mx][my] = terrain;
+    mapDirtyPos(value, mx, my);
     screenBrainMapSetPos(mx, my, terrain, minesExistPos(screenGetMines(), mx, my));
   }
 
@@ -1406,11 +1697,12 @@ void mapNetAdd(map *value, BYTE mx, BYTE my, BYTE terrain, bool needSend) {
 *NAME:          mapNetUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE: 23/2/99
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Updates the time the items have been waiting for the 
 * server to authenticate them. If it reaches the expiry
-* date then it is restored.
+* date then it is restored. Only the items in the timing
+* wheel bucket for this tick are looked at.
 *
 *ARGUMENTS:
 *  value   - Pointer to map structure
@@ -1418,73 +1710,48 @@ void mapNetAdd(map *value, BYTE mx, BYTE my, BYTE terrain, bool needSend) {
 *  bs      - Pointer to the bases strucuture
 *********************************************************/
 void mapNetUpdate(map *value, pillboxes *pb, bases *bs) {
-  mapNet q;        /* Used in looping */
-  bool needRedraw; /* Do we need a redraw */
-  mapNet del;
+  mapNetIndex pos;  /* Used in looping */
+  mapNetIndex next;
+  mapNetItem *q;
+  unsigned short bucket; /* Wheel bucket for this tick */
+  bool needRedraw;  /* Do we need a redraw */
   
   needRedraw = FALSE;
-
-  q = (*value)->mn;
-  while (NonEmpty(q)) {
-    q->length = q->length +1;
-    if (q->length > MAP_MAX_SERVER_WAIT && q->needSend == FALSE) {
-      messageAdd(networkMessage, (char *) "\0", (char *) "at");
-      if (q->oldTerrain >= MINE_START && q->oldTerrain <= MINE_END) {
-        q->oldTerrain -= MINE_SUBTRACT;
-      }
-      (*value)->mapItem[q->mx][q->my] = q->oldTerrain;
-      mapNetCheckWater(value, pb, bs, q->mx, q->my);
-      screenBrainMapSetPos(q->mx, q->my, (*value)->mapItem[q->mx][q->my], minesExistPos(screenGetMines(), q->mx, q->my));
+  (*value)->netTick++;
+  bucket = (unsigned short) ((*value)->netTick & (MAP_NET_WHEEL_SIZE - 1));
+
+  pos = (*value)->wheel[MAP_NET_OUT][bucket];
+  while (pos != MAP_NET_NONE) {
+    q = &((*value)->netItem[pos]);
+    next = q->waitNext;
+    messageAdd(networkMessage, (char *) "\0", (char *) "at");
+    if (q->oldTerrain >= MINE_START && q->oldTerrain <= MINE_END) {
+      q->oldTerrain -= MINE_SUBTRACT;
+    }
+    (*value)->mapItem[q->mx][q->my] = q->oldTerrain;
+    mapDirtyPos(value, q->mx, q->my);
+    mapNetCheckWater(value, pb, bs, q->mx, q->my);
+    screenBrainMapSetPos(q->mx, q->my, (*value)->mapItem[q->mx][q->my], minesExistPos(screenGetMines(), q->mx, q->my));
 //        if (q->oldTerrain == CRATER) {
 //          floodAddItem(q->mx, q->my);
 //        }
-      needRedraw = TRUE;
-      if (q->prev != NULL) {
-        q->prev->next = q->next;
-      } else {
-        (*value)->mn = MapNetTail((*value)->mn);
-        if (NonEmpty((*value)->mn)) {
-          (*value)->mn->prev = NULL;
-        }
-      }
-      if (q->next != NULL) {
-        q->next->prev = q->prev;
-      }
-      del = q;
-      q = MapNetTail(q);
-      Dispose(del);
-    } else {
-      q = MapNetTail(q);
-    }
+    needRedraw = TRUE;
+    mapNetDeleteItem(value, pos);
+    pos = next;
   }
 
-  q = (*value)->mninc;
-  while (NonEmpty(q)) {
-    q->length++;
-    if (q->length > MAP_MAX_SERVER_WAIT) { /* Was 25 */
-      messageAdd(networkMessage, (char *) "\0", (char *) "pt"); 
-      (*value)->mapItem[q->mx][q->my] = q->terrain;
-      mapNetCheckWater(value, pb, bs, q->mx, q->my);
-      screenBrainMapSetPos(q->mx, q->my, (*value)->mapItem[q->mx][q->my], minesExistPos(screenGetMines(), q->mx, q->my));
-      needRedraw = TRUE;
-      if (q->prev != NULL) {
-        q->prev->next = q->next;
-      } else {
-        (*value)->mninc = MapNetTail((*value)->mninc);
-        if (NonEmpty((*value)->mninc)) {
-          (*value)->mninc->prev = NULL;
-        }
-      }
-      if (q->next != NULL) {
-        q->next->prev = q->prev;
-      }
-      del = q;
-      q = MapNetTail(q);
-      Dispose(del);
-    } else {
-      q = MapNetTail(q);
-    }
-
+  pos = (*value)->wheel[MAP_NET_IN][bucket];
+  while (pos != MAP_NET_NONE) {
+    q = &((*value)->netItem[pos]);
+    next = q->waitNext;
+    messageAdd(networkMessage, (char *) "\0", (char *) "pt"); 
+    (*value)->mapItem[q->mx][q->my] = q->terrain;
+    mapDirtyPos(value, q->mx, q->my);
+    mapNetCheckWater(value, pb, bs, q->mx, q->my);
+    screenBrainMapSetPos(q->mx, q->my, (*value)->mapItem[q->mx][q->my], minesExistPos(screenGetMines(), q->mx, q->my));
+    needRedraw = TRUE;
+    mapNetDeleteItem(value, pos);
+    pos = next;
   }
 
   if (needRedraw == TRUE) {
@@ -1496,7 +1763,7 @@ void mapNetUpdate(map *value, pillboxes *pb, bases *bs) {
 *NAME:          mapNetIncomingItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 3/11/99
-*LAST MODIFIED: 9/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A incoming map item has come from the server. If it is
 * in the waitinf for confirmation buffer remove it, else
@@ -1510,78 +1777,48 @@ void mapNetUpdate(map *value, pillboxes *pb, bases *bs) {
 *  terrain - Terrain to place
 *********************************************************/
 void mapNetIncomingItem(map *value, BYTE mx, BYTE my, BYTE terrain) {
-  mapNet q, del;
-  bool done; /* Finished looping */
+  mapNetIndex pos;
 
   /* Check for exists in waiting for confirmation buffer */
-  q = (*value)->mn;
-  done = FALSE;
-
-  while (NonEmpty(q) && done == FALSE) {
-    if (q->mx == mx && q->my == my) { /* && q->terrain == terrain */
-      /* Its in our structure */
-      if (q->prev != NULL) {
-        q->prev->next = q->next;
-      } else {
-        (*value)->mn = MapNetTail((*value)->mn);
-        if (NonEmpty((*value)->mn)) {
-          (*value)->mn->prev = NULL;
-        }
-      }
-      if (q->next != NULL) {
-        q->next->prev = q->prev;
-      }
-      done = TRUE;
-      if ((*value)->mapItem[mx][my] == RIVER || (*value)->mapItem[mx][my] == BOAT) {
-        minesRemoveItem(screenGetMines(), mx, my);
-        screenBrainMapSetPos(q->mx, q->my, (*value)->mapItem[mx][my], FALSE);
-      }
-      del = q;
-      q = MapNetTail(q);
-      Dispose(del);
-    } else {
-      q = MapNetTail(q);
-    }
+  pos = mapNetFind(value, MAP_NET_OUT, mx, my, terrain, TRUE); /* && q->terrain == terrain */
+  if (pos != MAP_NET_NONE) {
+    /* Its in our structure */
+    mapNetDeleteItem(value, pos);
+    if ((*value)->mapItem[mx][my] == RIVER || (*value)->mapItem[mx][my] == BOAT) {
+      minesRemoveItem(screenGetMines(), mx, my);
+      screenBrainMapSetPos(mx, my, (*value)->mapItem[mx][my], FALSE);
+    }
+  } else if (mapNetFind(value, MAP_NET_IN, mx, my, terrain, FALSE) == MAP_NET_NONE) {
+    /* If it isn't added */
+    mapNetNewItem(value, MAP_NET_IN, mx, my, terrain, FALSE);
   }
+}
 
 
-  /* Check for exists in the incoming buffer packet */
-  q = (*value)->mninc;
-
-  while (NonEmpty(q) && done == FALSE) {
-    if (q->mx == mx && q->my == my && q->terrain == terrain) {
-      done = TRUE;
-    } else {
-      q = MapNetTail(q);
-    }
-  }
-
-  /* If it isn't added */
-  if (done == FALSE) {
-//      if (terrain != BUILDING && terrain != BOAT && terrain != ROAD && terrain < MINE_START) {
-      New(q);
-      q->mx = mx;
-      q->my = my;
-      q->terrain = terrain;
-      q->length = 0;
-      q->next = (*value)->mninc;
-      q->prev = NULL;
-      if (NonEmpty((*value)->mninc)) {
-        (*value)->mninc->prev = q;
-      }
-      (*value)->mninc = q;
-//    } else {
-  //    (*value)->mapItem[mx][my] = terrain;
-    //} 
-  }
+/*********************************************************
+*NAME:          mapNetGetStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the size of the pending change pool and how many
+* changes were dropped because it could not grow
+*
+*ARGUMENTS:
+*  value    - Pointer to the map structure
+*  poolSize - Items in the pool
+*  lost     - Changes dropped
+*********************************************************/
+void mapNetGetStats(map *value, unsigned long *poolSize, unsigned long *lost) {
+  *poolSize = (*value)->netSize;
+  *lost = (*value)->netLost;
 }
 
-
 /*********************************************************
 *NAME:          mapNetPacket
 *AUTHOR:        John Morrison
 *CREATION DATE: 23/2/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A packet has arrived. Here is a peice of map info in it.
 *
@@ -1592,45 +1829,19 @@ void mapNetIncomingItem(map *value, BYTE mx, BYTE my, BYTE terrain) {
 *  terrain - Terrain to place
 *********************************************************/
 void mapNetPacket(map *value, BYTE mx, BYTE my, BYTE terrain) {
-  mapNet q, del;
-  bool done; /* Finished looping */
+  mapNetIndex pos;
   
-  q = (*value)->mn;
-  done = FALSE;
-
-  while (NonEmpty(q) && done == FALSE) {
-    if (q->mx == mx && q->my == my && q->terrain == terrain) {
-      (*value)->mapItem[mx][my] = terrain;
-      screenBrainMapSetPos(mx, my, (*value)->mapItem[mx][my], minesExistPos(screenGetMines(), mx, my));
-      if (q->prev != NULL) {
-        q->prev->next = q->next;
-      } else {
-        (*value)->mn = MapNetTail((*value)->mn);
-        if (NonEmpty((*value)->mn)) {
-          (*value)->mn->prev = NULL;
-        }
-      }
-      if (q->next != NULL) {
-        q->next->prev = q->prev;
-      }
-      del = q;
-      q = MapNetTail(q);
-      Dispose(del);
-      done = TRUE;
-    } else {
-      q = MapNetTail(q);
-    }
-  }
-
-  if (done == FALSE) {
-    (*value)->mapItem[mx][my] = terrain;
-    screenBrainMapSetPos(mx, my, (*value)->mapItem[mx][my], minesExistPos(screenGetMines(), mx, my));
-    if (terrain == BUILDING || terrain == ROAD) {
-      /* Play the building sound */
-      soundDist(manBuildingNear, mx, my);
-    } else if (terrain == CRATER) {
-      floodAddItem(screenGetFloodFill(), mx, my);
-    }
+  pos = mapNetFind(value, MAP_NET_OUT, mx, my, terrain, FALSE);
+  (*value)->mapItem[mx][my] = terrain;
+  mapDirtyPos(value, mx, my);
+  screenBrainMapSetPos(mx, my, (*value)->mapItem[mx][my], minesExistPos(screenGetMines(), mx, my));
+  if (pos != MAP_NET_NONE) {
+    mapNetDeleteItem(value, pos);
+  } else if (terrain == BUILDING || terrain == ROAD) {
+    /* Play the building sound */
+    soundDist(manBuildingNear, mx, my);
+  } else if (terrain == CRATER) {
+    floodAddItem(screenGetFloodFill(), mx, my);
   }
 }
 
@@ -1638,7 +1849,7 @@ void mapNetPacket(map *value, BYTE mx, BYTE my, BYTE terrain) {
 *NAME:          mapNetMakePacket
 *AUTHOR:        John Morrison
 *CREATION DATE: 27/2/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Make the map part of the packet. Returns the data length.
 * Is destructive on the data
@@ -1649,19 +1860,18 @@ void mapNetPacket(map *value, BYTE mx, BYTE my, BYTE terrain) {
 *********************************************************/
 BYTE mapNetMakePacket(map *value, BYTE *buff) {
   BYTE returnValue; /* Value to return */
-  mapNet q;
+  mapNetItem *q;
 
   returnValue = 0;
-  while (NonEmpty((*value)->mn)) {
-    buff[returnValue] = (*value)->mn->mx;
+  while ((*value)->mn != MAP_NET_NONE) {
+    q = &((*value)->netItem[(*value)->mn]);
+    buff[returnValue] = q->mx;
     returnValue++;
-    buff[returnValue] = (*value)->mn->my;
+    buff[returnValue] = q->my;
     returnValue++;
-    buff[returnValue] = (*value)->mn->terrain;
+    buff[returnValue] = q->terrain;
     returnValue++;
-    q = (*value)->mn;
-    (*value)->mn = MapNetTail((*value)->mn);
-    Dispose(q);
+    mapNetDeleteItem(value, (*value)->mn);
   }
   return returnValue;
 }
@@ -1670,10 +1880,11 @@ BYTE mapNetMakePacket(map *value, BYTE *buff) {
 *NAME:          mapNetClientPacket
 *AUTHOR:        John Morrison
 *CREATION DATE: 27/2/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Make the client map part of the packet. Returns the 
-* data length.
+* data length. Sent items now wait in the timing wheel for
+* the server to confirm them.
 *
 *ARGUMENTS:
 *  map  - Pointer to the map structure
@@ -1681,22 +1892,21 @@ BYTE mapNetMakePacket(map *value, BYTE *buff) {
 *********************************************************/
 BYTE mapNetClientPacket(map *value, BYTE *buff) {
   BYTE returnValue; /* Value to return */
-  mapNet q;
+  mapNetIndex pos;
+  mapNetItem *q;
 
   returnValue = 0;
-  q = (*value)->mn;
-  while (NonEmpty(q)) {
-   if (q->needSend == TRUE) {
-      q->needSend = FALSE;
-      q->length = 0;
-      buff[returnValue] = (*value)->mn->mx;
-      returnValue++;
-      buff[returnValue] = (*value)->mn->my;
-      returnValue++;
-      buff[returnValue] = (*value)->mn->terrain;
-      returnValue++;
-    }
-    q = MapNetTail(q);
+  while ((*value)->mnSend != MAP_NET_NONE) {
+    pos = (*value)->mnSend;
+    q = &((*value)->netItem[pos]);
+    q->needSend = FALSE;
+    buff[returnValue] = q->mx;
+    returnValue++;
+    buff[returnValue] = q->my;
+    returnValue++;
+    buff[returnValue] = q->terrain;
+    returnValue++;
+    mapNetQueue(value, pos);
   }
   return returnValue;
 }
@@ -1705,7 +1915,7 @@ BYTE mapNetClientPacket(map *value, BYTE *buff) {
 *NAME:          mapMakeNetRun
 *AUTHOR:        John Morrison
 *CREATION DATE: 28/2/99
-*LAST MODIFIED: 24/4/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Makes a map network run at yPos. A network run is an 
 * compress array of the bytes from 20 to 236 for the next
@@ -1718,31 +1928,137 @@ BYTE mapNetClientPacket(map *value, BYTE *buff) {
 *  yPos  - Y position of the run
 *********************************************************/
 int mapMakeNetRun(map *value, BYTE *buff, BYTE yPos) {
+  BYTE array[MAP_NET_RUN_SIZE];
+
+  /* Prepare it */
+  mapCopyNetRun(value, array, yPos);
+  /* Compress it */
+  return lzwencoding(array, buff, MAP_NET_RUN_SIZE);
+}
+
+/*********************************************************
+*NAME:          mapCopyNetRun
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies the rows of the map network run at yPos into
+* rows without compressing them. rows must hold
+* MAP_NET_RUN_SIZE bytes
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  rows  - Buffer to hold the rows
+*  yPos  - Y position of the run
+*********************************************************/
+void mapCopyNetRun(map *value, BYTE *rows, BYTE yPos) {
   BYTE count; /* Looping variable */
-  BYTE array[6 * (MAP_MINE_EDGE_RIGHT - (MAP_MINE_EDGE_LEFT+1))];
-  BYTE *arrayPtr;
   BYTE xPos;
 
-  memset(array, sizeof(array), 0);
   count = 0;
-  arrayPtr = array;
-  /* Prepare it */
-  while (count < 6) {
+  while (count < MAP_NET_RUN_ROWS) {
     for (xPos=MAP_MINE_EDGE_LEFT+1;xPos < MAP_MINE_EDGE_RIGHT;xPos++) {
-      *arrayPtr = (*value)->mapItem[xPos][yPos+count];
-      arrayPtr++;
+      *rows = (*value)->mapItem[xPos][(BYTE) (yPos+count)];
+      rows++;
     }
     count++;
   }
-  /* Compress it */
-  return lzwencoding(array, buff, 6*(MAP_MINE_EDGE_RIGHT-(MAP_MINE_EDGE_LEFT+1)));
+}
+
+/*********************************************************
+*NAME:          mapTakeDirtyRows
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies the bitmap of rows changed since the last call
+* into rows and clears it. Bit y%8 of rows[y/8] is set if
+* row y changed
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  rows  - Buffer of MAP_ARRAY_SIZE/8 bytes to hold it
+*********************************************************/
+void mapTakeDirtyRows(map *value, BYTE *rows) {
+  memcpy(rows, (*value)->dirtyRows, sizeof((*value)->dirtyRows));
+  memset((*value)->dirtyRows, 0, sizeof((*value)->dirtyRows));
+}
+
+/*********************************************************
+*NAME:          mapTakeChangedAll
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns if the whole map has changed since the last call
+* because it was created or loaded in bulk. If so the
+* changed squares are cleared too
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*********************************************************/
+bool mapTakeChangedAll(map *value) {
+  bool returnValue; /* Value to return */
+
+  returnValue = (*value)->changedAll;
+  if (returnValue == TRUE) {
+    memset((*value)->changed, 0, sizeof((*value)->changed));
+    memset((*value)->changedRows, 0, sizeof((*value)->changedRows));
+    (*value)->changedAll = FALSE;
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          mapTakeChangedPos
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Takes the next square changed since it was last taken.
+* Returns FALSE if there are none left
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  mx    - Pointer to hold the X co-ordinate
+*  my    - Pointer to hold the Y co-ordinate
+*********************************************************/
+bool mapTakeChangedPos(map *value, BYTE *mx, BYTE *my) {
+  int row;  /* Row being looked at */
+  int col;  /* Byte of the row being looked at */
+  int bit;  /* Bit of the byte */
+  BYTE *q;  /* The changed byte */
+
+  for (row=0;row<MAP_ARRAY_SIZE;row++) {
+    if ((*value)->changedRows[row >> 3] == 0) {
+      /* Skip to the next 8 rows */
+      row |= 7;
+    } else if (((*value)->changedRows[row >> 3] & (1 << (row & 7))) != 0) {
+      for (col=0;col<MAP_ARRAY_SIZE / 8;col++) {
+        q = &(*value)->changed[row][col];
+        if (*q != 0) {
+          bit = 0;
+          while ((*q & (1 << bit)) == 0) {
+            bit++;
+          }
+          *q &= (BYTE) ~(1 << bit);
+          *mx = (BYTE) (col * 8 + bit);
+          *my = (BYTE) row;
+          return TRUE;
+        }
+      }
+      /* Nothing left in the row */
+      (*value)->changedRows[row >> 3] &= (BYTE) ~(1 << (row & 7));
+    }
+  }
+  return FALSE;
 }
 
 /*********************************************************
 *NAME:          mapSetNetRun
 *AUTHOR:        John Morrison
 *CREATION DATE: 28/2/99
-*LAST MODIFIED:  7/1/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets the map to the network run at yPos. A network run 
 * is an array of the bytes from 20 to 236
@@ -1771,13 +2087,65 @@ void mapSetNetRun(map *value, BYTE *buff, BYTE yPos, int dataLen) {
     }
     count++;
   }
+  (*value)->changedAll = TRUE;
+}
+
+/*********************************************************
+*NAME:          mapMakeNetBlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies every map square a joining player downloads into
+* buff, row by row. buff must hold MAP_NET_BLOCK_SIZE
+* bytes. The block is not compressed
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  buff  - Buffer to hold data
+*********************************************************/
+void mapMakeNetBlock(map *value, BYTE *buff) {
+  int yPos; /* Looping variables */
+  int xPos;
+
+  for (yPos=MAP_NET_FIRST_ROW;yPos<=MAP_NET_LAST_ROW;yPos++) {
+    for (xPos=MAP_MINE_EDGE_LEFT+1;xPos<MAP_MINE_EDGE_RIGHT;xPos++) {
+      *buff = (*value)->mapItem[xPos][yPos];
+      buff++;
+    }
+  }
+}
+
+/*********************************************************
+*NAME:          mapSetNetBlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Sets the map from a block made by mapMakeNetBlock
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  buff  - Buffer that contains data
+*********************************************************/
+void mapSetNetBlock(map *value, BYTE *buff) {
+  int yPos; /* Looping variables */
+  int xPos;
+
+  for (yPos=MAP_NET_FIRST_ROW;yPos<=MAP_NET_LAST_ROW;yPos++) {
+    for (xPos=MAP_MINE_EDGE_LEFT+1;xPos<MAP_MINE_EDGE_RIGHT;xPos++) {
+      (*value)->mapItem[xPos][yPos] = *buff;
+      buff++;
+    }
+  }
+  (*value)->changedAll = TRUE;
 }
 
 /*********************************************************
 *NAME:          mapNetCheckWater
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/11/99
-*LAST MODIFIED: 19/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks an square updated through mapNetUpdate to see if
 * it should be filled to overcome the mines problem.
@@ -1829,6 +2197,7 @@ void mapNetCheckWater(map *value, pillboxes *pb, bases *bs, BYTE xValue, BYTE yV
     if (leftPos == DEEP_SEA || leftPos == BOAT || leftPos == RIVER || rightPos == DEEP_SEA || rightPos == BOAT || rightPos == RIVER || above == DEEP_SEA || above == RIVER || above == BOAT || below == DEEP_SEA || below == BOAT || below == RIVER) {
       /* Do fill */
       (*value)->mapItem[xValue][yValue] = RIVER;
+      mapDirtyPos(value, xValue, yValue);
       minesRemoveItem(screenGetMines(), xValue, yValue);
     }
   }
@@ -1841,7 +2210,7 @@ int lzwencoding(char *src, char *dest, int len);
 *NAME:          mapSaveCompressedMap
 *AUTHOR:        John Morrison
 *CREATION DATE: 1/5/99
-*LAST MODIFIED: 1/5/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Saves a map to a compressed map structure. Returns 
 *  compressed data length
@@ -1877,7 +2246,7 @@ int mapSaveCompressedMap(map *value, pillboxes *pb, bases *bs, starts *ss, BYTE
 
   /* Map */
   ptr2 = (BYTE *) (*value)->mapItem;
-  returnValue += lzwencoding((char *) (ptr2), ptr, sizeof(**value));
+  returnValue += lzwencoding((char *) (ptr2), ptr, sizeof((*value)->mapItem));
   return returnValue;
 }
 
@@ -1886,7 +2255,7 @@ int mapSaveCompressedMap(map *value, pillboxes *pb, bases *bs, starts *ss, BYTE
 *NAME:          mapLoadCompressedMap
 *AUTHOR:        John Morrison
 *CREATION DATE: 1/5/99
-*LAST MODIFIED: 1/5/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Reads a map in via a compressed map structure. Returns 
 *  if the operation was successful or not
@@ -1926,19 +2295,74 @@ bool mapLoadCompressedMap(map *value, pillboxes *pb, bases *bs, starts *ss, BYTE
   /* Map */
   ptr2 = (BYTE *) (*value)->mapItem;
   mapSize = lzwdecoding(ptr, ptr2, inputLen);
-  if (mapSize != sizeof(**value) - 2 * sizeof(mapNet)) {
+  if (mapSize != sizeof((*value)->mapItem)) {
     returnValue = FALSE;
   }
   return returnValue;
 }
 
+/*********************************************************
+*NAME:          mapRotate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Moves every square of the map by addX, addY wrapping
+*  round the edges, one column at a time so no second
+*  map is needed
+*
+*ARGUMENTS:
+*  value - Pointer to the map data structure
+*  addX  - Squares to move right
+*  addY  - Squares to move down
+*********************************************************/
+static void mapRotate(map *value, BYTE addX, BYTE addY) {
+  BYTE save[MAP_ARRAY_SIZE]; /* Column being moved */
+  int start;                 /* First column of a cycle */
+  int pos;                   /* Column being filled */
+  int from;                  /* Column it is filled from */
+  int moved;                 /* Columns moved so far */
+  int count;                 /* Looping variable */
+
+  /* Columns. Each cycle fills a column from the one addX
+     to its left until it gets back to where it started */
+  moved = 0;
+  start = 0;
+  while (addX != 0 && moved < MAP_ARRAY_SIZE) {
+    memcpy(save, (*value)->mapItem[start], MAP_ARRAY_SIZE);
+    pos = start;
+    from = (BYTE) (pos - addX);
+    while (from != start) {
+      memcpy((*value)->mapItem[pos], (*value)->mapItem[from], MAP_ARRAY_SIZE);
+      moved++;
+      pos = from;
+      from = (BYTE) (pos - addX);
+    }
+    memcpy((*value)->mapItem[pos], save, MAP_ARRAY_SIZE);
+    moved++;
+    start++;
+  }
+
+  /* Squares in each column */
+  if (addY != 0) {
+    for (count = 0; count < MAP_ARRAY_SIZE; count++) {
+      memcpy(save, (*value)->mapItem[count], MAP_ARRAY_SIZE);
+      memcpy((*value)->mapItem[count] + addY, save, MAP_ARRAY_SIZE - addY);
+      memcpy((*value)->mapItem[count], save + MAP_ARRAY_SIZE - addY, addY);
+    }
+  }
+  (*value)->changedAll = TRUE;
+}
+
 /*********************************************************
 *NAME:          mapCenter
 *AUTHOR:        John Morrison
 *CREATION DATE: 13/6/00
-*LAST MODIFIED: 13/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Centers the map file and everything on it.
+*  Centers the map file and everything on it. Everything
+*  outside the used area is deep sea so the map is
+*  rotated in place rather than copied to a new one.
 *
 *ARGUMENTS:
 *  value   - Pointer to the map data structure
@@ -1959,7 +2383,8 @@ void mapCenter(map *value, pillboxes *pb, bases *bs, starts *ss) {
   int addY;
   int count1;     /* Looping variable */
   int count2;    /* Looping variable */
-  map map2;       /* The new map to create */
+  BYTE *column;   /* Column of the map being checked */
+  BYTE deepSea[MAP_ARRAY_SIZE]; /* A column of deep sea */
 
   bestLeft = MAP_ARRAY_SIZE;
   bestRight = -1;
@@ -2008,22 +2433,30 @@ void mapCenter(map *value, pillboxes *pb, bases *bs, starts *ss) {
   if (guessBottom < bestBottom) {
     bestBottom = guessBottom;
   }
+  memset(deepSea, DEEP_SEA, sizeof(deepSea));
   for (count1=0; count1 <= MAP_ARRAY_LAST; count1++) {
-    for (count2=0; count2 <= MAP_ARRAY_LAST; count2++) {
-      if ((*value)->mapItem[count1][count2] != DEEP_SEA) {
-        /* Center test */
-        if (count1 < bestLeft) {
-          bestLeft = count1;
-        }
-        if (count1 > bestRight) {
-          bestRight = count1;
-        }
-        if (count2 < bestTop) {
-          bestTop = count2;
-        }
-        if (count2 > bestBottom) {
-          bestBottom = count2;
-        }
+    column = (*value)->mapItem[count1];
+    if (memcmp(column, deepSea, sizeof(deepSea)) != 0) {
+      /* Center test */
+      if (count1 < bestLeft) {
+        bestLeft = count1;
+      }
+      if (count1 > bestRight) {
+        bestRight = count1;
+      }
+      count2 = 0;
+      while (column[count2] == DEEP_SEA) {
+        count2++;
+      }
+      if (count2 < bestTop) {
+        bestTop = count2;
+      }
+      count2 = MAP_ARRAY_LAST;
+      while (column[count2] == DEEP_SEA) {
+        count2--;
+      }
+      if (count2 > bestBottom) {
+        bestBottom = count2;
       }
     }
   }
@@ -2034,17 +2467,10 @@ void mapCenter(map *value, pillboxes *pb, bases *bs, starts *ss) {
     addY = (255/2) - ((bestTop + bestBottom) /2) - 1;
     if (addX != 0 && addY != 0) {
       /* It needs centering */
-      mapCreate(&map2);
-      for (count1=bestLeft; count1 <= (BYTE) bestRight; count1++) {
-        for (count2=bestTop; count2 <= (BYTE) bestBottom; count2++) {
-          map2->mapItem[(BYTE) (count1+addX)][(BYTE) (count2+addY)] = (*value)->mapItem[count1][count2];
-        }
-      }
+      mapRotate(value, (BYTE) addX, (BYTE) addY);
       pillsMoveAll(pb, addX, addY);
       basesMoveAll(bs, addX, addY);
       startsMoveAll(ss, addX, addY);
-      mapDestroy(value);
-      *value = map2;
     }   
   }
 }
@@ -34,12 +34,29 @@
 #define SIZEOFBMAP_START_INFO 3
 #define SIZEOFBMAP_RUN_HEADER 4
 
+/* Largest header, pills, bases and starts at the start
+   of a map file */
+#define MAP_TABLES_MAX_SIZE (LENGTH_ID + 4 + MAX_PILLS * SIZEOFBMAP_PILL_INFO + MAX_BASES * SIZEOFBAMP_BASE_INFO + MAX_STARTS * SIZEOFBMAP_START_INFO)
+
 /* Map Edges for mines */
 #define MAP_MINE_EDGE_LEFT  20
 #define MAP_MINE_EDGE_RIGHT 236
 #define MAP_MINE_EDGE_TOP  20
 #define MAP_MINE_EDGE_BOTTOM 236
 
+/* Rows and columns sent to a joining player in one block. The
+   row by row download of 6 rows every 5 rows reached row 241 */
+#define MAP_NET_FIRST_ROW (MAP_MINE_EDGE_TOP + 1)
+#define MAP_NET_LAST_ROW (MAP_MINE_EDGE_BOTTOM + 5)
+#define MAP_NET_WIDTH (MAP_MINE_EDGE_RIGHT - (MAP_MINE_EDGE_LEFT + 1))
+#define MAP_NET_BLOCK_SIZE (MAP_NET_WIDTH * (MAP_NET_LAST_ROW - MAP_NET_FIRST_ROW + 1))
+
+/* A net run is 6 rows. Runs start every 5 rows so each
+   overlaps the next by one */
+#define MAP_NET_RUN_ROWS 6
+#define MAP_NET_RUN_STEP 5
+#define MAP_NET_RUN_SIZE (MAP_NET_RUN_ROWS * MAP_NET_WIDTH)
+
 /* Maximums */
 /* Not required
 #define MAX_PILLS 16
@@ -119,17 +136,6 @@ Given in bradians - 256 bradians in a circle */
 
 /* Type definitions */
 
-/* Defines the state of map reading */
-typedef enum {
-  highLen,  /* The next high nibble is a length */
-  lowLen,   /* The next low nibble is a length */
-  highDiff, /* The next high nibble is a item and the length indicates differnt items */
-  lowDiff,  /* The next low nibble is a item and the length indicates differnt items */
-  highSame, /* The next high nibble is a item and the same items for the length */
-  lowSame   /* The next low nibble is a item and the same items for the length */
-} mapRunState;
-
-
 typedef struct {
   BYTE datalen;	/* length of the data for this run INCLUDING this 4 byte header */
   MAP_Y y;		/* y co-ordinate of this run. */
@@ -151,7 +157,6 @@ typedef struct {
 /* Net map structure */
 #define IsEmpty(list) ((list) ==NULL)
 #define NonEmpty(list) (!IsEmpty(list))
-#define MapNetTail(list) ((list)->next);
 
 /* The maximum amount of time to wait for the server to authorise this change */
 #define MAP_MAX_SERVER_WAIT 3 
@@ -164,10 +169,10 @@ typedef struct {
 *NAME:          mapCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Creates and initilises the map structure. Sets all 
-*  map squares to be deep ocean
+*  map squares to be deep sea and nothing pending
 *
 *ARGUMENTS:
 *  value - Pointer to the map file
@@ -178,7 +183,7 @@ void mapCreate(map *value);
 *NAME:          mapDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Destroys the map data structure. Also frees memory.
 *
@@ -191,93 +196,141 @@ void mapDestroy(map *value);
 *NAME:          mapReadPills
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Reads the pill information from a map file
-*  into the pill structure. Returns if the 
-*  operation was successful or not
+*  Reads the pill information from a map file in memory
+*  into the pill structure and moves buff past it.
+*  Returns if the operation was successful or not
 *
 *ARGUMENTS:
-*  fp    - Pointer to the file being read from
+*  buff  - Pointer to the position in the file
+*  end   - End of the file
 *  value - Pointer to the pillbox structure
 *********************************************************/
-bool mapReadPills(FILE *fp, pillboxes *value);
+bool mapReadPills(BYTE **buff, BYTE *end, pillboxes *value);
 
 /*********************************************************
 *NAME:          mapReadBases
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Reads the base information from a map file
-*  into the base structure. Returns if the 
-*  operation was successful or not
+*  Reads the base information from a map file in memory
+*  into the base structure and moves buff past it.
+*  Returns if the operation was successful or not
 *
 *ARGUMENTS:
-*  fp    - Pointer to the file being read from
+*  buff  - Pointer to the position in the file
+*  end   - End of the file
 *  value - Pointer to the pillbox structure
 *********************************************************/
-bool mapReadBases(FILE *fp, bases *value);
+bool mapReadBases(BYTE **buff, BYTE *end, bases *value);
 
 /*********************************************************
 *NAME:          mapReadStarts
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Reads the player start information from a map file
-*  into the player starts structure. Returns if the 
-*  operation was successful or not
+*  Reads the player start information from a map file in
+*  memory into the player starts structure and moves buff
+*  past it. Returns if the operation was successful or not
 *
 *ARGUMENTS:
-*  fp    - Pointer to the file being read from
+*  buff  - Pointer to the position in the file
+*  end   - End of the file
 *  value - Pointer to the pillbox structure
 *********************************************************/
-bool mapReadStarts(FILE *fp, starts *value);
+bool mapReadStarts(BYTE **buff, BYTE *end, starts *value);
 
 /*********************************************************
 *NAME:          mapProcessRun
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Process a single map run and puts values into map
-*  data structure.
+*  data structure. The run is a stream of nibbles, high
+*  nibble first. Each length nibble is followed by length
+*  + 1 different items if it is below MAP_RUN_DIFF or one
+*  item repeated length - MAP_RUN_SAME times if not.
 *  Returns whether operation was successful or not
 *
 *ARGUMENTS:
-*  fp     - Pointer to the file being read from
+*  buff   - Run data. Must hold elems bytes
 *  value  - Pointer to the map data structure
 *  elems  - Number of elements in the run
 *  yValue - The y Map co-ordinate
 *  startX - The start x co-ordinate
 *  endX   - The end x co-ordinate
 *********************************************************/
-bool mapProcessRun(FILE *fp,map *value,BYTE elems, MAP_Y yValue, BYTE startX, BYTE endX);
+bool mapProcessRun(BYTE *buff, map *value, BYTE elems, MAP_Y yValue, BYTE startX, BYTE endX);
 
 /*********************************************************
 *NAME:          mapReadRuns
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Reads the map runs into the map data structure
-*  Returns if the operation was successful or not
+*  Reads the map runs from a map file in memory into the
+*  map data structure. Stops at the last run or the end
+*  of the file. Returns if the operation was successful
+*  or not
 *
 *ARGUMENTS:
-*  fp    - Pointer to the file being read from
+*  buff  - Start of the runs
+*  end   - End of the file
 *  value - Pointer to the map data structure
 *********************************************************/
-bool mapReadRuns(FILE *fp, map *value);
+bool mapReadRuns(BYTE *buff, BYTE *end, map *value);
 
+/*********************************************************
+*NAME:          mapReadTables
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads the header, pills, bases and starts from the
+*  start of a map file in memory. Returns the number of
+*  bytes read, which is where the runs start, or 0 if
+*  they are not valid
+*
+*ARGUMENTS:
+*  buff - Map file
+*  len  - Length of the file
+*  pb   - Pointer to the pillbox structure
+*  bs   - Pointer to the bases structure
+*  ss   - Pointer to the starts structure
+*********************************************************/
+int mapReadTables(BYTE *buff, int len, pillboxes *pb, bases *bs, starts *ss);
+
+/*********************************************************
+*NAME:          mapMakeTables
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes the header, pills, bases and starts the way
+*  they start a map file. buff must hold
+*  MAP_TABLES_MAX_SIZE bytes. Returns the length written
+*
+*ARGUMENTS:
+*  pb   - Pointer to the pillbox structure
+*  bs   - Pointer to the bases structure
+*  ss   - Pointer to the starts structure
+*  buff - Buffer to write to
+*********************************************************/
+int mapMakeTables(pillboxes *pb, bases *bs, starts *ss, BYTE *buff);
 
 /*********************************************************
 *NAME:          mapRead
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/98
-*LAST MODIFIED: 21/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Reads a map in.
+*  Reads a map in. The file is mapped into memory and
+*  decoded in place. If cache files are on a valid cache
+*  is loaded instead, or written once the map is decoded.
 * Returns if the operation was successful or not
 *
 *ARGUMENTS:
@@ -382,7 +435,7 @@ bool mapIsPassable(map *value, BYTE xValue, BYTE yValue, bool onBoat);
 *NAME:          mapSetPos
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/12/98
-*LAST MODIFIED:  31/7/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets a position on the map
 *
@@ -534,7 +587,7 @@ long mapPrepareRun(map *value, bmapRun *run, BYTE *xPos, BYTE *yPos);
 *NAME:          mapNetAdd
 *AUTHOR:        John Morrison
 *CREATION DATE: 23/2/99
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Adds a item to the mapNet structure. If an item already
 * exists at that position it repaces it with the new
@@ -553,11 +606,12 @@ void mapNetAdd(map *value, BYTE mx, BYTE my, BYTE terrain, bool needSend);
 *NAME:          mapNetUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE: 23/2/99
-*LAST MODIFIED: 19/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Updates the time the items have been waiting for the 
 * server to authenticate them. If it reaches the expiry
-* date then it is restored.
+* date then it is restored. Only the items in the timing
+* wheel bucket for this tick are looked at.
 *
 *ARGUMENTS:
 *  value   - Pointer to map structure
@@ -570,7 +624,7 @@ void mapNetUpdate(map *value, pillboxes *pb, bases *bs);
 *NAME:          mapNetPacket
 *AUTHOR:        John Morrison
 *CREATION DATE: 23/2/99
-*LAST MODIFIED: 23/2/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A packet has arrived. Here is a peice of map info in it.
 *
@@ -586,7 +640,7 @@ void mapNetPacket(map *value, BYTE mx, BYTE my, BYTE terrain);
 *NAME:          mapNetMakePacket
 *AUTHOR:        John Morrison
 *CREATION DATE: 27/2/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Make the map part of the packet. Returns the data length.
 * Is destructive on the data
@@ -601,10 +655,11 @@ BYTE mapNetMakePacket(map *value, BYTE *buff);
 *NAME:          mapNetClientPacket
 *AUTHOR:        John Morrison
 *CREATION DATE: 27/2/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Make the client map part of the packet. Returns the 
-* data length.
+* data length. Sent items now wait in the timing wheel for
+* the server to confirm them.
 *
 *ARGUMENTS:
 *  map  - Pointer to the map structure
@@ -616,7 +671,7 @@ BYTE mapNetClientPacket(map *value, BYTE *buff);
 *NAME:          mapMakeNetRun
 *AUTHOR:        John Morrison
 *CREATION DATE: 28/2/99
-*LAST MODIFIED: 24/4/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Makes a map network run at yPos. A network run is an 
 * compress array of the bytes from 20 to 236 for the next
@@ -630,6 +685,70 @@ BYTE mapNetClientPacket(map *value, BYTE *buff);
 *********************************************************/
 int mapMakeNetRun(map *value, BYTE *buff, BYTE yPos);
 
+/*********************************************************
+*NAME:          mapCopyNetRun
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies the rows of the map network run at yPos into
+* rows without compressing them. rows must hold
+* MAP_NET_RUN_SIZE bytes
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  rows  - Buffer to hold the rows
+*  yPos  - Y position of the run
+*********************************************************/
+void mapCopyNetRun(map *value, BYTE *rows, BYTE yPos);
+
+/*********************************************************
+*NAME:          mapTakeDirtyRows
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies the bitmap of rows changed since the last call
+* into rows and clears it. Bit y%8 of rows[y/8] is set if
+* row y changed
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  rows  - Buffer of MAP_ARRAY_SIZE/8 bytes to hold it
+*********************************************************/
+void mapTakeDirtyRows(map *value, BYTE *rows);
+
+/*********************************************************
+*NAME:          mapTakeChangedAll
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns if the whole map has changed since the last call
+* because it was created or loaded in bulk. If so the
+* changed squares are cleared too
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*********************************************************/
+bool mapTakeChangedAll(map *value);
+
+/*********************************************************
+*NAME:          mapTakeChangedPos
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Takes the next square changed since it was last taken.
+* Returns FALSE if there are none left
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  mx    - Pointer to hold the X co-ordinate
+*  my    - Pointer to hold the Y co-ordinate
+*********************************************************/
+bool mapTakeChangedPos(map *value, BYTE *mx, BYTE *my);
+
 /*********************************************************
 *NAME:          mapSetNetRun
 *AUTHOR:        John Morrison
@@ -647,11 +766,41 @@ int mapMakeNetRun(map *value, BYTE *buff, BYTE yPos);
 *********************************************************/
 void mapSetNetRun(map *value, BYTE *buff, BYTE yPos, int dataLen);
 
+/*********************************************************
+*NAME:          mapMakeNetBlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies every map square a joining player downloads into
+* buff, row by row. buff must hold MAP_NET_BLOCK_SIZE
+* bytes. The block is not compressed
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  buff  - Buffer to hold data
+*********************************************************/
+void mapMakeNetBlock(map *value, BYTE *buff);
+
+/*********************************************************
+*NAME:          mapSetNetBlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Sets the map from a block made by mapMakeNetBlock
+*
+*ARGUMENTS:
+*  value - Pointer to the map structure
+*  buff  - Buffer that contains data
+*********************************************************/
+void mapSetNetBlock(map *value, BYTE *buff);
+
 /*********************************************************
 *NAME:          mapNetIncomingItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 3/11/99
-*LAST MODIFIED: 9/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A incoming map item has come from the server. If it is
 * in the waitinf for confirmation buffer remove it, else
@@ -666,11 +815,27 @@ void mapSetNetRun(map *value, BYTE *buff, BYTE yPos, int dataLen);
 *********************************************************/
 void mapNetIncomingItem(map *value, BYTE mx, BYTE my, BYTE terrain);
 
+/*********************************************************
+*NAME:          mapNetGetStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the size of the pending change pool and how many
+* changes were dropped because it could not grow
+*
+*ARGUMENTS:
+*  value    - Pointer to the map structure
+*  poolSize - Items in the pool
+*  lost     - Changes dropped
+*********************************************************/
+void mapNetGetStats(map *value, unsigned long *poolSize, unsigned long *lost);
+
 /*********************************************************
 *NAME:          mapNetCheckWater
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/11/99
-*LAST MODIFIED: 19/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks an square updated through mapNetUpdate to see if
 * it should be filled to overcome the mines problem.
@@ -688,7 +853,7 @@ void mapNetCheckWater(map *value, pillboxes *pb, bases *bs, BYTE xValue, BYTE yV
 *NAME:          mapLoadCompressedMap
 *AUTHOR:        John Morrison
 *CREATION DATE: 1/5/99
-*LAST MODIFIED: 1/5/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Reads a map in via a compressed map structure. Returns 
 *  if the operation was successful or not
@@ -707,7 +872,7 @@ bool mapLoadCompressedMap(map *value, pillboxes *pb, bases *bs, starts *ss, BYTE
 *NAME:          mapSaveCompressedMap
 *AUTHOR:        John Morrison
 *CREATION DATE: 1/5/99
-*LAST MODIFIED: 1/5/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Saves a map to a compressed map structure. Returns 
 *  compressed data length
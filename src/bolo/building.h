@@ -20,7 +20,7 @@
 *Filename:      building.h
 *Author:        John Morrison
 *Creation Date: 30/12/98
-*Last Modified: 04/10/03
+*Last Modified: 16/10/26
 *Purpose:
 *  Responsable for tracking lifetime of Buildings.
 *  buildings can be shot 5 times before being destroyed
@@ -30,14 +30,11 @@
 #define BUILDING_H
 
 #include "global.h"
+#include "tilelife.h"
 
-/* Empty / Non Empty / Head / Tail Macros */
+/* Empty / Non Empty Macros */
 #define IsEmpty(list) ((list) ==NULL)
 #define NonEmpty(list) (!IsEmpty(list))
-#define BuildingHeadX(list) ((list)->x);
-#define BuildingHeadY(list) ((list)->y);
-#define BuildingHeadLength(list) ((list)->life);
-#define BuildingTail(list) ((list)->next);
 
 /* How manu shots it takes to destroy a building */
 #define BUILDING_LIFE 4
@@ -47,47 +44,17 @@
 
 /* Type structure */
 
-typedef struct buildingObj *building;
-struct buildingObj {
-  building next; /* Next item */ 
-  BYTE x;      /* X and Y positions */
-  BYTE y;
-  BYTE life;   /* Life time of the rubble */
-};
+/* Damage is kept in the tile life layer shared with the other
+   terrain types */
+typedef tileLife building;
 
 /* Prototypes */
 
-/*********************************************************
-*NAME:          buildingCreate
-*AUTHOR:        John Morrison
-*CREATION DATE: 30/12/98
-*LAST MODIFIED: 30/12/98
-*PURPOSE:
-*  Sets up the building data structure
-*
-*ARGUMENTS:
-* bld - Pointer to the buildings object
-*********************************************************/
-void buildingCreate(building *bld);
-
-/*********************************************************
-*NAME:          buildingDestroy
-*AUTHOR:        John Morrison
-*CREATION DATE: 30/12/98
-*LAST MODIFIED: 30/12/98
-*PURPOSE:
-*  Destroys and frees memory for the building data structure
-*
-*ARGUMENTS:
-* bld - Pointer to the buildings object
-*********************************************************/
-void buildingDestroy(building *bld);
-
 /*********************************************************
 *NAME:          buildingeAddItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/12/98
-*LAST MODIFIED: 25/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Adds an item to the building data structure.
 *  If it already exists returns the terrain type of the
@@ -100,25 +67,11 @@ void buildingDestroy(building *bld);
 *********************************************************/
 BYTE buildingAddItem(building *bld, BYTE x, BYTE y);
 
-/*********************************************************
-*NAME:          buildingDeleteItem
-*AUTHOR:        John Morrison
-*CREATION DATE: 30/12/98
-*LAST MODIFIED: 30/12/98
-*PURPOSE:
-*  Deletes the item for the given number
-*
-*ARGUMENTS:
-*  bld     - Pointer to the buildings object
-*  itemNum - The item number to get
-*********************************************************/
-void buildingDeleteItem(building *bld, int itemNum);
-
 /*********************************************************
 *NAME:          buildingRemovePos
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/1/99
-*LAST MODIFIED: 18/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Removes an item from the building data structure if it 
 *  exists at a specific loaction. Otherwise the function
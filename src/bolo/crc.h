@@ -42,10 +42,12 @@
 *NAME:          CRCCalc
 *AUTHOR:        John Morrison
 *CREATION DATE: 7/3/98
-*LAST MODIFIED: 7/3/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Generates a CRC for a buffer buff of length buffLen
-*  Sets number of bases to zero
+*  Generates a CRC for a buffer buff of length buffLen.
+*  Works through four bytes at a time with the slice
+*  tables. Gives the same value as the old nibble at a
+*  time version.
 *
 *ARGUMENTS:
 *  buff    - Pointer to the buffer
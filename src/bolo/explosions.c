@@ -108,23 +108,23 @@ void explosionsAddItem(explosions *expl, BYTE mx, BYTE my, BYTE px, BYTE py, BYT
 *NAME:          explosionsUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE:  1/1/99
-*LAST MODIFIED:  1/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Updates each explosion position
 *
 *ARGUMENTS:
-*  expl - Pointer to the explosions object
+*  expl       - Pointer to the explosions object
+*  updateTime - Ticks since the last update
 *********************************************************/
-void explosionsUpdate(explosions *expl) {
-  static BYTE update =0;  /* The update time */
+void explosionsUpdate(explosions *expl, BYTE *updateTime) {
   explosions position; /* Position throught the items */
   bool needUpdate;     /* Whether an update is needed or not */
 
-  update++;
-  if (update != EXPLOAD_UPDATE_TIME) {
+  (*updateTime)++;
+  if (*updateTime != EXPLOAD_UPDATE_TIME) {
     return;
   } else {
-    update = 0;
+    *updateTime = 0;
   }
 
   position = *expl;
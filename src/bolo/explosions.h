@@ -105,14 +105,15 @@ void explosionsAddItem(explosions *expl, BYTE mx, BYTE my, BYTE px, BYTE py, BYT
 *NAME:          explosionsUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE:  1/1/99
-*LAST MODIFIED:  1/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Updates each explosion position
 *
 *ARGUMENTS:
-*  expl - Pointer to the explosions object
+*  expl       - Pointer to the explosions object
+*  updateTime - Ticks since the last update
 *********************************************************/
-void explosionsUpdate(explosions *expl);
+void explosionsUpdate(explosions *expl, BYTE *updateTime);
 
 /*********************************************************
 *NAME:          explosionDeleteItem
@@ -83,6 +83,13 @@ void efree(Generic object);
 #define	New(p)		((p) = emalloc(sizeof(*(p))))
 #define	Dispose(p)	(efree(p))
 
+/* Gives each thread its own copy of a variable */
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 /* An Null Charector */
 #define EMPTY_CHAR '\0'
 
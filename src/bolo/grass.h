@@ -20,7 +20,7 @@
 *Filename:      grass.h
 *Author:        John Morrison
 *Creation Date: 5/1/99
-*Last Modified: 18/1/99
+*Last Modified: 16/10/26
 *Purpose:
 *  Responsable for tracking lifetime of grass when shot
 *  from a boat
@@ -30,14 +30,11 @@
 #define GRASS_H
 
 #include "global.h"
+#include "tilelife.h"
 
-/* Empty / Non Empty / Head / Tail Macros */
+/* Empty / Non Empty Macros */
 #define IsEmpty(list) ((list) ==NULL)
 #define NonEmpty(list) (!IsEmpty(list))
-#define GrassHeadX(list) ((list)->x);
-#define GrassHeadY(list) ((list)->y);
-#define GrassHeadLength(list) ((list)->life);
-#define GrassTail(list) ((list)->next);
 
 /* How manu shots it takes to destroy a peice of grass */
 #define GRASS_LIFE 4
@@ -50,47 +47,17 @@
 
 /* Type structure */
 
-typedef struct grassObj *grass;
-struct grassObj {
-  grass next; /* Next item */ 
-  BYTE x;     /* X and Y positions */
-  BYTE y;
-  BYTE life;  /* Life time of the Grass */
-};
+/* Damage is kept in the tile life layer shared with the other
+   terrain types */
+typedef tileLife grass;
 
 /* Prototypes */
 
-/*********************************************************
-*NAME:          grassCreate
-*AUTHOR:        John Morrison
-*CREATION DATE: 5/1/99
-*LAST MODIFIED: 5/1/99
-*PURPOSE:
-*  Sets up the grass data structure
-*
-*ARGUMENTS:
-* grs - Pointer to the grass object
-*********************************************************/
-void grassCreate(grass *grs);
-
-/*********************************************************
-*NAME:          grassDestroy
-*AUTHOR:        John Morrison
-*CREATION DATE: 5/1/99
-*LAST MODIFIED: 5/1/99
-*PURPOSE:
-*  Destroys and frees memory for the grass data structure
-*
-*ARGUMENTS:
-* grs - Pointer to the grass object
-*********************************************************/
-void grassDestroy(grass *grs);
-
 /*********************************************************
 *NAME:          grassAddItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/1/99
-*LAST MODIFIED: 25/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Adds an item to the grass data structure.
 *  If it already exists returns the terrain type of the
@@ -103,25 +70,11 @@ void grassDestroy(grass *grs);
 *********************************************************/
 BYTE grassAddItem(grass *grs, BYTE x, BYTE y);
 
-/*********************************************************
-*NAME:          grassDeleteItem
-*AUTHOR:        John Morrison
-*CREATION DATE: 5/1/99
-*LAST MODIFIED: 5/1/99
-*PURPOSE:
-*  Deletes the item for the given number
-*
-*ARGUMENTS:
-*  grs     - Pointer to the grass object
-*  itemNum - The item number to get
-*********************************************************/
-void grassDeleteItem(grass *grs, int itemNum);
-
 /*********************************************************
 *NAME:          grassRemovePos
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/1/99
-*LAST MODIFIED: 18/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Removes an item from the grass data structure if it 
 *  exists at a specific loaction. Otherwise the function
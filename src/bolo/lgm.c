@@ -52,6 +52,7 @@
 #include "log.h"
 #include "util.h"
 #include "../winbolonet/winbolonet.h"
+#include "../server/servernet.h"
 #include "lgm.h"
 
 /* Prototypes */
@@ -469,7 +470,7 @@ void lgmNewPrimaryRequest(lgm *lgman, map *mp, pillboxes *pb, bases *bs, tank *t
       }
     }
     if (netGetType() == netUdp || threadsGetContext() == TRUE) {
-      serverNetSendManWorkingMessage(screenGetTankPlayer(tnk), mapX, mapY, minesAmount, trees, pillNum);
+      serverNetSendManWorkingMessage(serverCoreGetContext(), screenGetTankPlayer(tnk), mapX, mapY, minesAmount, trees, pillNum);
     }
   } else {
     (*lgman)->state = LGM_STATE_IDLE;
@@ -479,7 +480,7 @@ void lgmNewPrimaryRequest(lgm *lgman, map *mp, pillboxes *pb, bases *bs, tank *t
       tankPutCarriedPill(tnk, pillNum);
     }
     if (threadsGetContext() == TRUE) {
-      serverNetSendManReturnMessge(screenGetTankPlayer(tnk), trees, minesAmount, pillNum);
+      serverNetSendManReturnMessge(serverCoreGetContext(), screenGetTankPlayer(tnk), trees, minesAmount, pillNum);
     }
 
   }
@@ -745,7 +746,7 @@ void lgmReturn(lgm *lgman, map *mp, pillboxes *pb, bases *bs, tank *tnk) {
     (*lgman)->blessX = 0;
     (*lgman)->blessY = 0;
 /*    if (threadsGetContext() == TRUE) {
-      serverNetSendManReturnMessge(screenGetTankPlayer(tnk), (*lgman)->numTrees, (*lgman)->numMines, (*lgman)->numPills);
+      serverNetSendManReturnMessge(serverCoreGetContext(), screenGetTankPlayer(tnk), (*lgman)->numTrees, (*lgman)->numMines, (*lgman)->numPills);
     } */
     lgmBackInTank(lgman, mp, pb, bs, tnk, TRUE);
     if (threadsGetContext() == FALSE) {
@@ -974,7 +975,7 @@ void lgmBackInTank(lgm *lgman, map *mp, pillboxes *pb, bases *bs, tank *tnk, boo
   }
   // Added
   if (threadsGetContext() == TRUE) {
-    serverNetSendManReturnMessge(screenGetTankPlayer(tnk), trees, minesAmount, pillNum);
+    serverNetSendManReturnMessge(serverCoreGetContext(), screenGetTankPlayer(tnk), trees, minesAmount, pillNum);
   } else {
     if ((*lgman)->nextAction != LGM_IDLE) {  
       if (/* FIXME - Removed for lgm problem threadsGetContext() == TRUE || */ netGetType() == netSingle) {
@@ -20,7 +20,7 @@
 *Filename:      log.c
 *Author:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *Purpose:
 *  Responsable for creating WinBolo log files
 *********************************************************/
@@ -35,76 +35,114 @@
 #include "pillbox.h"
 #include "bases.h"
 #include "log.h"
+#include "logwriter.h"
 #include "netpacks.h"
 #include "../zlib/zip.h"
 #include "../server/servercore.h"
 #include "../server/servernet.h"
 #include "../winbolonet/winbolonet.h"
 
-zipFile logFile;               /* File to log to */
-unsigned short logLastEvent; /* Last event logged. Increments each time there are no events */
-unsigned short logNumEvents; /* Last event logged. Increments each time there are no events */
-bool  logIsRunning;          /* Are we saving a log */
-BYTE *logMem = NULL;
-unsigned short logMemSize;   /* How much memory are we using */
-BYTE logKey; /* Current log encryption key */
-BYTE logOldKey; /* Old key needed for writing state */
-bool logLastEmpty; /* Was the last log empty? */
-
-logTanks logCheckTanks;
+/* A game's log */
+struct logObj {
+  zipFile logFile;             /* File to log to */
+  logWriter writer;            /* Deflates the log off the tick */
+  unsigned short logLastEvent; /* Last event logged. Increments each time there are no events */
+  unsigned short logNumEvents; /* Last event logged. Increments each time there are no events */
+  bool  logIsRunning;          /* Are we saving a log */
+  BYTE *logMem;
+  unsigned short logMemSize;   /* How much memory are we using */
+  BYTE logKey;                 /* Current log encryption key */
+  BYTE logOldKey;              /* Old key needed for writing state */
+  bool logLastEmpty;           /* Was the last log empty? */
+  logTanks logCheckTanks;
+};
 
 /*********************************************************
 *NAME:          logCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Creates the log subsystem
+* Creates a game's log. Returns NULL on out of memory
 *
 *ARGUMENTS:
 *  
 *********************************************************/
-void logCreate() {
-  logFile = NULL;
-  logLastEvent = 0;
-  logIsRunning = FALSE;
-  logNumEvents = 0;
-  logMem = malloc(LOG_MEMORY_BUFFER_SIZE);
-  logMemSize = 0;
-  logKey = 0;
-  logOldKey = 0;
+logContext logCreate() {
+  logContext lc; /* Value to return */
+
+  New(lc);
+  if (lc == NULL) {
+    return NULL;
+  }
+  memset(lc, 0, sizeof(*lc));
+  lc->logFile = NULL;
+  lc->logLastEvent = 0;
+  lc->logIsRunning = FALSE;
+  lc->logNumEvents = 0;
+  lc->logMem = malloc(LOG_MEMORY_BUFFER_SIZE);
+  lc->writer = logWriterCreate();
+  lc->logMemSize = 0;
+  lc->logKey = 0;
+  lc->logOldKey = 0;
+  if (lc->logMem == NULL || lc->writer == NULL) {
+    logDestroy(&lc);
+  }
+  return lc;
+}
+
+/*********************************************************
+*NAME:          logCurrent
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns the log of the game this thread is working on
+* or NULL if there is none
+*
+*ARGUMENTS:
+*  
+*********************************************************/
+static logContext logCurrent(void) {
+  serverCore sc; /* Game being worked on */
+
+  sc = serverCoreGetContext();
+  if (sc == NULL) {
+    return NULL;
+  }
+  return sc->serverLog;
 }
 
 /*********************************************************
 *NAME:          logWriteEmpty
 *AUTHOR:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Writes the nothing happened for X ticks to the log file
 *
 *ARGUMENTS:
-*  
+*  lc - The log
 *********************************************************/
-void logWriteEmpty() {
+void logWriteEmpty(logContext lc) {
   BYTE data[3];
   unsigned short us;
-  if (logIsRunning == TRUE) {
-    if (logLastEvent > 0) {
-      if (logLastEvent < LOG_SIZE_LONG_DIFF) {
-        data[0] = LOG_NOEVENTS ^ logOldKey;
-        data[1] = (BYTE) logLastEvent ^ logOldKey;
-        zipWriteInFileInZip(logFile, data, 2);
+  if (lc->logIsRunning == TRUE) {
+    if (lc->logLastEvent > 0) {
+      if (lc->logLastEvent < LOG_SIZE_LONG_DIFF) {
+        data[0] = LOG_NOEVENTS;
+        data[1] = (BYTE) lc->logLastEvent;
+        logWriterAdd(lc->writer, data, 2, lc->logOldKey);
       } else {
-        us = htons(logLastEvent);
-        data[0] = LOG_NOEVENTS_LONG ^ logOldKey;
-        data[1] = (BYTE) (us >> 8) ^ logOldKey;
-        data[2] = (BYTE) (us & 0xFF) ^ logOldKey;
-        zipWriteInFileInZip(logFile, data, 3);
+        us = htons(lc->logLastEvent);
+        data[0] = LOG_NOEVENTS_LONG;
+        data[1] = (BYTE) (us >> 8);
+        data[2] = (BYTE) (us & 0xFF);
+        logWriterAdd(lc->writer, data, 3, lc->logOldKey);
       }
     }
-    logOldKey = logKey;
-    logLastEvent = 0;
+    lc->logOldKey = lc->logKey;
+    lc->logLastEvent = 0;
   }
 }
 
@@ -112,29 +150,29 @@ void logWriteEmpty() {
 *NAME:          logWriteTick
 *AUTHOR:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Called every tick. Logs stuff if required
 *
 *ARGUMENTS:
-*  
+*  lc - The log
 *********************************************************/
-void logWriteTick() {
-  BYTE savedKey = logOldKey;
-
-  if (logIsRunning == TRUE) {
-    if (logNumEvents > 0) {
-      logWriteEmpty();
-      logWriteEvents(savedKey);
-      logLastEmpty = FALSE;
+void logWriteTick(logContext lc) {
+  BYTE savedKey = lc->logOldKey;
+
+  if (lc->logIsRunning == TRUE) {
+    if (lc->logNumEvents > 0) {
+      logWriteEmpty(lc);
+      logWriteEvents(lc, savedKey);
+      lc->logLastEmpty = FALSE;
     } else {
-      logLastEvent++;
-      if (logLastEvent == 63000) {
-        logLastEmpty = FALSE;
-        logWriteEmpty();
+      lc->logLastEvent++;
+      if (lc->logLastEvent == 63000) {
+        lc->logLastEmpty = FALSE;
+        logWriteEmpty(lc);
       }
     }
-    logOldKey = logKey;
+    lc->logOldKey = lc->logKey;
   }
 }
 
@@ -142,32 +180,34 @@ void logWriteTick() {
 *NAME:          logWriteEvents
 *AUTHOR:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Writes any memory written events to the log file
 *
 *ARGUMENTS:
+*  lc  - The log
 *  key - Key to use to write events header
 *********************************************************/
-void logWriteEvents(BYTE key) {
+void logWriteEvents(logContext lc, BYTE key) {
   BYTE data[3];
   unsigned short us;
   
-  if (logNumEvents > 0) {
-    if (logNumEvents < LOG_SIZE_LONG_DIFF) {
-      data[0] = LOG_EVENT ^ key;
-      data[1] = (BYTE) logNumEvents ^ key;
-      zipWriteInFileInZip(logFile, data, 2);
+  if (lc->logNumEvents > 0) {
+    if (lc->logNumEvents < LOG_SIZE_LONG_DIFF) {
+      data[0] = LOG_EVENT;
+      data[1] = (BYTE) lc->logNumEvents;
+      logWriterAdd(lc->writer, data, 2, key);
     } else {
-      us = htons(logNumEvents);
-      data[0] = LOG_EVENT_LONG ^ key;
-      data[1] = (BYTE) (us >> 8) ^ key;
-      data[2] = (BYTE) (us & 0xFF) ^ key;
-      zipWriteInFileInZip(logFile, data, 3);
+      us = htons(lc->logNumEvents);
+      data[0] = LOG_EVENT_LONG;
+      data[1] = (BYTE) (us >> 8);
+      data[2] = (BYTE) (us & 0xFF);
+      logWriterAdd(lc->writer, data, 3, key);
     }
-    zipWriteInFileInZip(logFile, logMem, logMemSize);
-    logMemSize = 0;
-    logNumEvents = 0;
+    /* Events were XORed with their own keys as they were added */
+    logWriterAdd(lc->writer, lc->logMem, lc->logMemSize, 0);
+    lc->logMemSize = 0;
+    lc->logNumEvents = 0;
   }
 }
 
@@ -175,48 +215,56 @@ void logWriteEvents(BYTE key) {
 *NAME:          logStop
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Stops logging if we are
 *
 *ARGUMENTS:
-*  
+*  lc - The log
 *********************************************************/
-void logStop() {
+void logStop(logContext lc) {
   BYTE data[2];
-  BYTE savedKey = logOldKey; /* Save the key as the old key will be overridden in WriteEmpty */
-
-  if (logIsRunning == TRUE) {
-    logWriteEmpty();
-    data[0] = LOG_QUIT ^ savedKey;
-    data[1] = LOG_QUIT ^ savedKey;
-    zipWriteInFileInZip(logFile, data, 2);
-    zipCloseFileInZip(logFile);
-    zipClose(logFile, "WinBolo Log File");
+  BYTE savedKey = lc->logOldKey; /* Save the key as the old key will be overridden in WriteEmpty */
+
+  if (lc->logIsRunning == TRUE) {
+    logWriteEmpty(lc);
+    data[0] = LOG_QUIT;
+    data[1] = LOG_QUIT;
+    logWriterAdd(lc->writer, data, 2, savedKey);
+    logWriterStop(lc->writer);
+    zipCloseFileInZip(lc->logFile);
+    zipClose(lc->logFile, "WinBolo Log File");
   }
-  logIsRunning = FALSE;
+  lc->logIsRunning = FALSE;
 }
 
 /*********************************************************
 *NAME:          logIsRecording
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Returns if we are reocrding or not
+* Returns if the game this thread is working on is
+* recording or not
 *
 *ARGUMENTS:
 *  
 *********************************************************/
 bool logIsRecording() {
-  return logIsRunning;
+  logContext lc; /* The game's log */
+
+  lc = logCurrent();
+  if (lc == NULL) {
+    return FALSE;
+  }
+  return lc->logIsRunning;
 }
 
-void logAddToMemory(BYTE *memPos, BYTE *data, BYTE dataLen) {
+void logAddToMemory(logContext lc, BYTE *memPos, BYTE *data, BYTE dataLen) {
   BYTE count = 0;
 
   while (count < dataLen) {
-    *(memPos+count) = *(data+count) ^ logKey;
+    *(memPos+count) = *(data+count) ^ lc->logKey;
     count++;
   }
 }
@@ -225,9 +273,10 @@ void logAddToMemory(BYTE *memPos, BYTE *data, BYTE dataLen) {
 *NAME:          logAddEvent
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Adds a event to be logged
+* Adds a event to be logged to the log of the game this
+* thread is working on
 *
 *ARGUMENTS:
 *  itemNum - Item number to add
@@ -240,127 +289,129 @@ void logAddToMemory(BYTE *memPos, BYTE *data, BYTE dataLen) {
 *********************************************************/
 void logAddEvent(logitem itemNum, BYTE opt1, BYTE opt2, BYTE opt3, BYTE opt4, unsigned short short1, char *words) {
   bool changeKey = TRUE; /* Whether to change the encryption key or not */
+  logContext lc;         /* The game's log */
 
-  if (logIsRunning == TRUE) {
+  lc = logCurrent();
+  if (lc != NULL && lc->logIsRunning == TRUE) {
     switch (itemNum) {
     case log_BaseSetOwner:
-      *(logMem+logMemSize) = log_BaseSetOwner ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt3 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = log_BaseSetOwner ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt3 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_BaseSetStock:
-      *(logMem+logMemSize) = log_BaseSetStock ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt3 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt4 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = log_BaseSetStock ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt3 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt4 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_PlayerJoined:
-      *(logMem+logMemSize) = log_PlayerJoined ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt3 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt4 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = (BYTE) short1 ^ logKey;
-      logMemSize++;
-      logAddToMemory((logMem+logMemSize), words, (BYTE) (words[0]+1));
-//      memcpy((logMem+logMemSize), words, words[0]+1);
-      logMemSize += (BYTE) (words[0]+1);
+      *(lc->logMem+lc->logMemSize) = log_PlayerJoined ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt3 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt4 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = (BYTE) short1 ^ lc->logKey;
+      lc->logMemSize++;
+      logAddToMemory(lc, (lc->logMem+lc->logMemSize), words, (BYTE) (words[0]+1));
+//      memcpy((lc->logMem+lc->logMemSize), words, words[0]+1);
+      lc->logMemSize += (BYTE) (words[0]+1);
       break;
     case log_PlayerQuit:
-      *(logMem+logMemSize) = log_PlayerQuit ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = log_PlayerQuit ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_LostMan:
-      *(logMem+logMemSize) = log_LostMan ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = log_LostMan ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_MapChange:
-      *(logMem+logMemSize) =  log_MapChange ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt3 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) =  log_MapChange ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt3 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_ChangeName:
-      *(logMem+logMemSize) =  log_ChangeName ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      logAddToMemory((logMem+logMemSize), words, (BYTE) (words[0]+1));
-//      memcpy((logMem+logMemSize), words, words[0]+1);
-      logMemSize += (BYTE) (words[0]+1);
+      *(lc->logMem+lc->logMemSize) =  log_ChangeName ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      logAddToMemory(lc, (lc->logMem+lc->logMemSize), words, (BYTE) (words[0]+1));
+//      memcpy((lc->logMem+lc->logMemSize), words, words[0]+1);
+      lc->logMemSize += (BYTE) (words[0]+1);
       break;
     case log_AllyRequest:
-      *(logMem+logMemSize) =  log_AllyRequest ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) =  log_AllyRequest ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_AllyAccept:
-      *(logMem+logMemSize) =  log_AllyAccept ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) =  log_AllyAccept ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_AllyLeave:
-      *(logMem+logMemSize) =  log_AllyLeave ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) =  log_AllyLeave ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_PillSetOwner:
-      *(logMem+logMemSize) =  log_PillSetOwner ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt3 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) =  log_PillSetOwner ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt3 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_PillSetPlace:
-      *(logMem+logMemSize) =  log_PillSetPlace ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt3 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) =  log_PillSetPlace ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt3 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_PillSetHealth:
     case log_PillSetInTank:
-      *(logMem+logMemSize) =  itemNum ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) =  itemNum ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_SoundBuild:
     case log_SoundFarm:
@@ -373,106 +424,106 @@ void logAddEvent(logitem itemNum, BYTE opt1, BYTE opt2, BYTE opt3, BYTE opt4, un
     case log_SoundExplosion:
     case log_SoundBigExplosion:
     case log_SoundManDie:
-      *(logMem+logMemSize) = itemNum ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = itemNum ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_PlayerLocation:
-      if (logCheckTankSame(opt1, opt2, opt3, opt4, (BYTE) short1) == TRUE) {
+      if (logCheckTankSame(lc, opt1, opt2, opt3, opt4, (BYTE) short1) == TRUE) {
         changeKey = FALSE;
-        logNumEvents--;
+        lc->logNumEvents--;
       } else {
-        *(logMem+logMemSize) = itemNum ^ logKey;
-        logMemSize++;
-        *(logMem+logMemSize) = opt1 ^ logKey;
-        logMemSize++;
-        *(logMem+logMemSize) = opt2 ^ logKey;
-        logMemSize++;
-        *(logMem+logMemSize) = opt3 ^ logKey;
-        logMemSize++;
-        *(logMem+logMemSize) = opt4 ^ logKey;
-        logMemSize++;
-        *(logMem+logMemSize) = (BYTE) short1 ^ logKey;
-        logMemSize++;
+        *(lc->logMem+lc->logMemSize) = itemNum ^ lc->logKey;
+        lc->logMemSize++;
+        *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+        lc->logMemSize++;
+        *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+        lc->logMemSize++;
+        *(lc->logMem+lc->logMemSize) = opt3 ^ lc->logKey;
+        lc->logMemSize++;
+        *(lc->logMem+lc->logMemSize) = opt4 ^ lc->logKey;
+        lc->logMemSize++;
+        *(lc->logMem+lc->logMemSize) = (BYTE) short1 ^ lc->logKey;
+        lc->logMemSize++;
       }
       break;
     case log_Shell:
     case log_LgmLocation:
-      *(logMem+logMemSize) = itemNum ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt3 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt4 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = itemNum ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt3 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt4 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_KillPlayer:
-      *(logMem+logMemSize) = itemNum ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = itemNum ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_MessagePlayers:
-      *(logMem+logMemSize) = log_MessagePlayers^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt2 ^ logKey;
-      logMemSize++;
-      logAddToMemory((logMem+logMemSize), words, (BYTE) (words[0]+1));
-      logMemSize += (BYTE) (words[0]+1);
+      *(lc->logMem+lc->logMemSize) = log_MessagePlayers^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt2 ^ lc->logKey;
+      lc->logMemSize++;
+      logAddToMemory(lc, (lc->logMem+lc->logMemSize), words, (BYTE) (words[0]+1));
+      lc->logMemSize += (BYTE) (words[0]+1);
       break;
     case log_MessageAll:
-      *(logMem+logMemSize) = log_MessageAll ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = log_MessageAll ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
       //FIXTHIS
-      logAddToMemory((logMem+logMemSize), words, (BYTE) (words[0]+1));
-      //memcpy((logMem+logMemSize), words, words[0]+1);
-      logMemSize += (BYTE) (words[0]+1);
+      logAddToMemory(lc, (lc->logMem+lc->logMemSize), words, (BYTE) (words[0]+1));
+      //memcpy((lc->logMem+lc->logMemSize), words, words[0]+1);
+      lc->logMemSize += (BYTE) (words[0]+1);
       break;
     case log_MessageServer:
-      *(logMem+logMemSize) = log_MessageServer ^ logKey;
-      logMemSize++;
-      logAddToMemory((logMem+logMemSize), words, (BYTE) (words[0]+1));
-      //memcpy((logMem+logMemSize), words, words[0]+1);
-      logMemSize += (BYTE) (words[0]+1);
+      *(lc->logMem+lc->logMemSize) = log_MessageServer ^ lc->logKey;
+      lc->logMemSize++;
+      logAddToMemory(lc, (lc->logMem+lc->logMemSize), words, (BYTE) (words[0]+1));
+      //memcpy((lc->logMem+lc->logMemSize), words, words[0]+1);
+      lc->logMemSize += (BYTE) (words[0]+1);
       break;
     case log_PlayerRejoin:
-      *(logMem+logMemSize) = log_PlayerRejoin ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = log_PlayerRejoin ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_PlayerLeaving:
-      *(logMem+logMemSize) = log_PlayerLeaving ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = log_PlayerLeaving ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     case log_PlayerDied:
-      *(logMem+logMemSize) = log_PlayerDied ^ logKey;
-      logMemSize++;
-      *(logMem+logMemSize) = opt1 ^ logKey;
-      logMemSize++;
+      *(lc->logMem+lc->logMemSize) = log_PlayerDied ^ lc->logKey;
+      lc->logMemSize++;
+      *(lc->logMem+lc->logMemSize) = opt1 ^ lc->logKey;
+      lc->logMemSize++;
       break;
     default:
       changeKey = FALSE;
-      logNumEvents--;
+      lc->logNumEvents--;
       break;
     }
-    logNumEvents++;
+    lc->logNumEvents++;
     if (changeKey == TRUE) {
-      logKey = itemNum;
+      lc->logKey = itemNum;
     }
   }
 }
@@ -481,39 +532,46 @@ void logAddEvent(logitem itemNum, BYTE opt1, BYTE opt2, BYTE opt3, BYTE opt4, un
 *NAME:          logDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Shuts down the log subsystem
+* Shuts down a game's log
 *
 *ARGUMENTS:
-*  
+*  value - Pointer to the log
 *********************************************************/
-void logDestroy() {
-  logStop();
-  logIsRunning = FALSE;
-  logFile = NULL;  
-  if (logMem != NULL) {
-    free(logMem);
-    logMem = NULL;
+void logDestroy(logContext *value) {
+  logContext lc; /* The log */
+
+  lc = *value;
+  if (lc == NULL) {
+    return;
+  }
+  logStop(lc);
+  lc->logIsRunning = FALSE;
+  lc->logFile = NULL;  
+  if (lc->logMem != NULL) {
+    free(lc->logMem);
+    lc->logMem = NULL;
   }
+  logWriterDestroy(&lc->writer);
+  Dispose(lc);
+  *value = NULL;
 }
 
-int writeData(BYTE *data, int len, BYTE key) {
-  int count = 0;
-  while (count < len) {
-    data[count] = data[count] ^ key;
-    count++;
+int writeData(logContext lc, BYTE *data, int len, BYTE key) {
+  if (logWriterAdd(lc->writer, data, len, key) == FALSE) {
+    return Z_ERRNO;
   }
-
-  return zipWriteInFileInZip(logFile, data, len);
+  return Z_OK;
 }
 
 /*********************************************************
 *NAME:          logWriteSnapshot
 *AUTHOR:        John Morrison
 *CREATION DATE: 25/07/04
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
+* lc   - The log
 * mp   - Map file
 * pb   - Pillboxes
 * bs   - Bases
@@ -521,7 +579,7 @@ int writeData(BYTE *data, int len, BYTE key) {
 * plrs - Players
 * check - Whether to check if running or not
 *********************************************************/
-bool logWriteSnapshot(map *mp, pillboxes *pb, bases *bs, starts *ss, players *plrs, bool check) {
+bool logWriteSnapshot(logContext lc, map *mp, pillboxes *pb, bases *bs, starts *ss, players *plrs, bool check) {
   bool returnValue = TRUE; /* Value to return */
   BYTE dataLen; 
   BYTE savedDataLen;       /* Non XOR'd datalength */
@@ -534,22 +592,22 @@ bool logWriteSnapshot(map *mp, pillboxes *pb, bases *bs, starts *ss, players *pl
   int len;                 /* Length of the run to write */
   long length;
 
-  if (logIsRunning == FALSE && check == TRUE) {
+  if (lc->logIsRunning == FALSE && check == TRUE) {
     return TRUE;
   }
 
   
-//  printf("snapshotting %d - ", logOldKey);
+//  printf("snapshotting %d - ", lc->logOldKey);
 
-  if (logNumEvents > 0) {
-    logWriteEvents(logOldKey);
+  if (lc->logNumEvents > 0) {
+    logWriteEvents(lc, lc->logOldKey);
   } else {
-    logWriteEmpty();
-    if (logLastEmpty == TRUE) {
+    logWriteEmpty(lc);
+    if (lc->logLastEmpty == TRUE) {
   //    printf("Not snapshotting because nothing happened!\n");
       return TRUE;
     }
-    logLastEmpty = TRUE;
+    lc->logLastEmpty = TRUE;
     // Nothing happened return?
   }
 
@@ -557,22 +615,22 @@ bool logWriteSnapshot(map *mp, pillboxes *pb, bases *bs, starts *ss, players *pl
 
 
   data[0] = LOG_EVENT_SNAPSHOT;
-  ret = writeData(data, 1, logOldKey);
+  ret = writeData(lc, data, 1, lc->logOldKey);
   if (ret != Z_OK) {
     returnValue = FALSE;
   }
 
   /* Write start delay and time left */
   if (returnValue == TRUE) {
-    length = htonl(serverCoreGetGameStartDelay());
-    ret = writeData((BYTE *) &length, sizeof(long), logOldKey);   
+    length = htonl(serverCoreGetGameStartDelay(serverCoreGetContext()));
+    ret = writeData(lc, (BYTE *) &length, sizeof(long), lc->logOldKey);   
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
   }
   if (returnValue == TRUE) {
-    length = htonl(serverCoreGetGameTimeLeft());
-    ret = writeData((BYTE *) &length, sizeof(long), logOldKey);   
+    length = htonl(serverCoreGetGameTimeLeft(serverCoreGetContext()));
+    ret = writeData(lc, (BYTE *) &length, sizeof(long), lc->logOldKey);   
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
@@ -582,42 +640,42 @@ bool logWriteSnapshot(map *mp, pillboxes *pb, bases *bs, starts *ss, players *pl
   if (returnValue == TRUE) {
     dataLen = pillsGetPillNetData(pb, data);
     savedDataLen = dataLen;
-    ret = writeData(&dataLen, 1, logOldKey);   
-    ret = writeData(data, savedDataLen, logOldKey);
+    ret = writeData(lc, &dataLen, 1, lc->logOldKey);   
+    ret = writeData(lc, data, savedDataLen, lc->logOldKey);
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
   }
   /* Write bases locations */
-  if (returnValue == TRUE && logFile) {
+  if (returnValue == TRUE && lc->logFile) {
     dataLen = basesGetBaseNetData(bs, data);
     savedDataLen = dataLen;
-    ret = writeData(&dataLen, 1, logOldKey);
-    ret = writeData(data, savedDataLen, logOldKey);
+    ret = writeData(lc, &dataLen, 1, lc->logOldKey);
+    ret = writeData(lc, data, savedDataLen, lc->logOldKey);
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
   }
   /* Write starts locations */
-  if (returnValue == TRUE && logFile) {
+  if (returnValue == TRUE && lc->logFile) {
     dataLen = startsGetStartNetData(ss, data);
     savedDataLen = dataLen;
-    ret = writeData(&dataLen, 1, logOldKey);
-    ret = writeData(data, savedDataLen, logOldKey);
+    ret = writeData(lc, &dataLen, 1, lc->logOldKey);
+    ret = writeData(lc, data, savedDataLen, lc->logOldKey);
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
   }
 
   /* Write the map itself */
-  if (returnValue == TRUE && logFile) {
+  if (returnValue == TRUE && lc->logFile) {
     xPos = 0;
     yPos = 0;
     while (yPos < 0xFF && returnValue == TRUE) {
       /* Process runs */
       len = mapPrepareRun(mp, &run, &xPos, &yPos);
       /* Write the run out */
-      ret = writeData((BYTE *) &run, len, logOldKey);
+      ret = writeData(lc, (BYTE *) &run, len, lc->logOldKey);
       if (ret != Z_OK) {
         returnValue = FALSE;
       }
@@ -628,15 +686,15 @@ bool logWriteSnapshot(map *mp, pillboxes *pb, bases *bs, starts *ss, players *pl
   while (count < MAX_TANKS && returnValue == TRUE) {
     playersPrepareLogSnapshotForPlayer(plrs, count, data, &dataLen);
     savedDataLen = dataLen;
-    ret = writeData((BYTE *) &dataLen, 1, logOldKey);
-    ret = writeData(data, savedDataLen, logOldKey);
+    ret = writeData(lc, (BYTE *) &dataLen, 1, lc->logOldKey);
+    ret = writeData(lc, data, savedDataLen, lc->logOldKey);
 
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
     count++;
   }
-  logOldKey = logKey;
+  lc->logOldKey = lc->logKey;
 
   return returnValue;
 }
@@ -645,11 +703,12 @@ bool logWriteSnapshot(map *mp, pillboxes *pb, bases *bs, starts *ss, players *pl
 *NAME:          logStart
 *AUTHOR:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Starts logging. Return success
 *
 *ARGUMENTS:
+* lc          - The log
 * fileName    - FileName and path of the file to open
 * mp          - Map file
 * pb          - Pillboxes
@@ -661,7 +720,7 @@ bool logWriteSnapshot(map *mp, pillboxes *pb, bases *bs, starts *ss, players *pl
 *                game
 * usePassword - Is the game password protected
 *********************************************************/
-bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, players *plrs, BYTE ai, BYTE maxPlayers, bool usePassword) {
+bool logStart(logContext lc, char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, players *plrs, BYTE ai, BYTE maxPlayers, bool usePassword) {
   bool returnValue; /* Value to return */
   int ret;            /* Function return value */
   zip_fileinfo zi;
@@ -671,22 +730,22 @@ bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, pla
   BYTE count;
 
   returnValue = TRUE;
-  logStop(); /* Stop the current log if it is running */
-  logLastEmpty = FALSE;
+  logStop(lc); /* Stop the current log if it is running */
+  lc->logLastEmpty = FALSE;
 
   count = 0;
   while (count < MAX_TANKS) {
-    logCheckTanks.item[count].mx = 0;
-    logCheckTanks.item[count].my = 0;
-    logCheckTanks.item[count].pxy = 0;
-    logCheckTanks.item[count].opt = 0;
+    lc->logCheckTanks.item[count].mx = 0;
+    lc->logCheckTanks.item[count].my = 0;
+    lc->logCheckTanks.item[count].pxy = 0;
+    lc->logCheckTanks.item[count].opt = 0;
     count++;
   }
 
 
-  logMemSize = 0;
-  logNumEvents = 0;
-  logFile = zipOpen(fileName, 0);
+  lc->logMemSize = 0;
+  lc->logNumEvents = 0;
+  lc->logFile = zipOpen(fileName, 0);
   
   zi.tmz_date.tm_sec = zi.tmz_date.tm_min = zi.tmz_date.tm_hour =
   zi.tmz_date.tm_mday = zi.tmz_date.tm_mon = zi.tmz_date.tm_year = 0;
@@ -695,18 +754,22 @@ bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, pla
   zi.external_fa = 0;
 
   
-  if (logFile == NULL) {
+  if (lc->logFile == NULL) {
     returnValue = FALSE;
     ret = Z_OK;
   } else {
-    ret = zipOpenNewFileInZip(logFile, "log.dat", &zi, NULL, 0, NULL, 0, "", Z_DEFLATED, Z_DEFAULT_COMPRESSION);
+    ret = zipOpenNewFileInZip(lc->logFile, "log.dat", &zi, NULL, 0, NULL, 0, "", Z_DEFLATED, Z_DEFAULT_COMPRESSION);
+  }
+
+  if (ret == Z_OK && logWriterStart(lc->writer, lc->logFile) == FALSE) {
+    ret = Z_ERRNO;
   }
 
   if (ret != Z_OK) {
     returnValue = FALSE;
   } else {
     strcpy(data, LOG_HEADER);
-    ret = zipWriteInFileInZip(logFile, data, strlen(data));
+    ret = writeData(lc, data, strlen(data), 0);
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
@@ -716,7 +779,7 @@ bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, pla
   /* Write log version */
   if (returnValue == TRUE) {
     data[0] = LOG_VERSION;
-    ret = zipWriteInFileInZip(logFile, data, 1);
+    ret = writeData(lc, data, 1, 0);
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
@@ -724,9 +787,9 @@ bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, pla
 
   /* Write Map Name */
   if (returnValue == TRUE) {
-    serverCoreGetMapName(data+1);
+    serverCoreGetMapName(serverCoreGetContext(), data+1);
     data[0] = strlen(data+1);
-    ret = zipWriteInFileInZip(logFile, data, data[0]+1);
+    ret = writeData(lc, data, data[0]+1, 0);
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
@@ -734,29 +797,29 @@ bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, pla
 
   /* Write Game Type, Allow mines, AI type, password */
   if (returnValue == TRUE) {
-    data[0] = serverCoreGetActualGameType();
-    data[1] = serverCoreGetAllowHiddenMines();
+    data[0] = serverCoreGetActualGameType(serverCoreGetContext());
+    data[1] = serverCoreGetAllowHiddenMines(serverCoreGetContext());
     data[2] = ai;
     data[3] = usePassword;
     data[4] = maxPlayers;
     data[5] = BOLO_VERSION_MAJOR;
     data[6] = BOLO_VERSION_MINOR;
     data[7] = BOLO_VERSION_REVISION;
-    ret = zipWriteInFileInZip(logFile, data, 8);
+    ret = writeData(lc, data, 8, 0);
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
   }
 
   /* Write server address and port */
-  serverNetGetUs(data, &port);
+  serverNetGetUs(serverCoreGetContext(), data, &port);
   port = htons(port);
   if (returnValue == TRUE) {
-    ret = zipWriteInFileInZip(logFile, data, 4);
+    ret = writeData(lc, data, 4, 0);
     if (ret != Z_OK) {
       returnValue = FALSE;
     } else {
-      ret = zipWriteInFileInZip(logFile, &port, sizeof(unsigned short));
+      ret = writeData(lc, (BYTE *) &port, sizeof(unsigned short), 0);
       if (ret != Z_OK) {
         returnValue = FALSE;
       }
@@ -765,8 +828,8 @@ bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, pla
 
   /* Start time */
   if (returnValue == TRUE) {
-    start = htonl(serverCoreGetTimeGameCreated());
-    ret = zipWriteInFileInZip(logFile, &start, sizeof(long));
+    start = htonl(serverCoreGetTimeGameCreated(serverCoreGetContext()));
+    ret = writeData(lc, (BYTE *) &start, sizeof(long), 0);
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
@@ -775,24 +838,30 @@ bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, pla
   /* Write WBN Key */
   if (returnValue == TRUE) {
     winboloNetGetServerKey(data);
-    ret = zipWriteInFileInZip(logFile, data, WINBOLONET_KEY_LEN);
+    ret = writeData(lc, data, WINBOLONET_KEY_LEN, 0);
     if (ret != Z_OK) {
       returnValue = FALSE;
     }
   }
 
-  logKey = logOldKey = (BYTE) (serverCoreGetTimeGameCreated() & 0xFF);
+  lc->logKey = lc->logOldKey = (BYTE) (serverCoreGetTimeGameCreated(serverCoreGetContext()) & 0xFF);
   /* Write Snapshot */
   if (returnValue == TRUE) {
-    returnValue = logWriteSnapshot(mp, pb, bs, ss, plrs, FALSE);
+    returnValue = logWriteSnapshot(lc, mp, pb, bs, ss, plrs, FALSE);
+  }
+  /* Writes are deflated later. Wait for these so a log that
+     can't be written is never started */
+  if (returnValue == TRUE) {
+    returnValue = logWriterSync(lc->writer);
   }
 
   if (returnValue == TRUE) {
-    logIsRunning = TRUE;
-  } else if(logFile != NULL) {
-    zipCloseFileInZip(logFile);
-    zipClose(logFile, "");
-    logFile = NULL;
+    lc->logIsRunning = TRUE;
+  } else if(lc->logFile != NULL) {
+    logWriterStop(lc->writer);
+    zipCloseFileInZip(lc->logFile);
+    zipClose(lc->logFile, "");
+    lc->logFile = NULL;
   }
 
   return returnValue;
@@ -802,19 +871,20 @@ bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, pla
 *NAME:          logCheckTankSame
 *AUTHOR:        John Morrison
 *CREATION DATE: 24/01/05
-*LAST MODIFIED: 24/01/05
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks if the tanks position is the same from last
 * update.
 *
 *ARGUMENTS:
+* lc        - The log
 * playerNum - Player number to check
 * mx        - Tank MX
 * my        - Tank MY
 * pxy       - Tank PXY
 * opt       - Misc tank data
 *********************************************************/
-bool logCheckTankSame(BYTE playerNum, BYTE mx, BYTE my, BYTE pxy, BYTE opt) {
+bool logCheckTankSame(logContext lc, BYTE playerNum, BYTE mx, BYTE my, BYTE pxy, BYTE opt) {
 
   if (my == 0) {
     my =0;
@@ -822,12 +892,28 @@ bool logCheckTankSame(BYTE playerNum, BYTE mx, BYTE my, BYTE pxy, BYTE opt) {
 
   if (playerNum >= MAX_TANKS) {
     return FALSE;
-  } else  if (logCheckTanks.item[playerNum].mx != mx || logCheckTanks.item[playerNum].my != my || logCheckTanks.item[playerNum].pxy != pxy || logCheckTanks.item[playerNum].opt != opt) {
-    logCheckTanks.item[playerNum].mx = mx;
-    logCheckTanks.item[playerNum].my = my;
-    logCheckTanks.item[playerNum].pxy = pxy;
-    logCheckTanks.item[playerNum].opt = opt;
+  } else  if (lc->logCheckTanks.item[playerNum].mx != mx || lc->logCheckTanks.item[playerNum].my != my || lc->logCheckTanks.item[playerNum].pxy != pxy || lc->logCheckTanks.item[playerNum].opt != opt) {
+    lc->logCheckTanks.item[playerNum].mx = mx;
+    lc->logCheckTanks.item[playerNum].my = my;
+    lc->logCheckTanks.item[playerNum].pxy = pxy;
+    lc->logCheckTanks.item[playerNum].opt = opt;
     return FALSE;
   }
   return TRUE;
 }
+
+/*********************************************************
+*NAME:          logGetWriterStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the writer counters since the log was started
+*
+*ARGUMENTS:
+* lc    - The log
+* stats - Structure to fill in
+*********************************************************/
+void logGetWriterStats(logContext lc, logWriterStats *stats) {
+  logWriterGetStats(lc->writer, stats);
+}
@@ -20,7 +20,7 @@
 *Filename:      log.h
 *Author:        John Morrison
 *Creation Date: 05/05/01
-*Last Modified: 24/01/05
+*Last Modified: 16/10/26
 *Purpose:
 *  Responsable for creating WinBolo log files
 *********************************************************/
@@ -36,6 +36,7 @@
 #include "pillbox.h"
 #include "bases.h"
 #include "players.h"
+#include "logwriter.h"
 
 /* Log items */
 #define LOG_QUIT 0
@@ -105,80 +106,86 @@ typedef struct {
 typedef struct {
   logTank item[MAX_TANKS];
 } logTanks;
+
+/* A game's log. Engine code adds events to the log of the
+   game the thread is working on */
+typedef struct logObj *logContext;
   
  
 /*********************************************************
 *NAME:          logCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Creates the log subsystem
+* Creates a game's log. Returns NULL on out of memory
 *
 *ARGUMENTS:
 *  
 *********************************************************/
-void logCreate();
+logContext logCreate();
 
 /*********************************************************
 *NAME:          logWriteEmpty
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Writes the nothing happened for X ticks to the log file
 *
 *ARGUMENTS:
-*  
+*  lc - The log
 *********************************************************/
-void logWriteEmpty();
+void logWriteEmpty(logContext lc);
 
 /*********************************************************
 *NAME:          logWriteEvents
 *AUTHOR:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Writes any memory written events to the log file
 *
 *ARGUMENTS:
+*  lc  - The log
 *  key - Key to use to write events header
 *********************************************************/
-void logWriteEvents(BYTE key);
+void logWriteEvents(logContext lc, BYTE key);
 
 /*********************************************************
 *NAME:          logWriteTick
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Called every tick. Logs stuff if required
 *
 *ARGUMENTS:
-*  
+*  lc - The log
 *********************************************************/
-void logWriteTick();
+void logWriteTick(logContext lc);
 
 /*********************************************************
 *NAME:          logStop
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Stops logging if we are
 *
 *ARGUMENTS:
-*  
+*  lc - The log
 *********************************************************/
-void logStop();
+void logStop(logContext lc);
 
 /*********************************************************
 *NAME:          logIsRecording
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Returns if we are reocrding or not
+* Returns if the game this thread is working on is
+* recording or not
 *
 *ARGUMENTS:
 *  
@@ -189,9 +196,10 @@ bool logIsRecording();
 *NAME:          logAddEvent
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Adds a event to be logged
+* Adds a event to be logged to the log of the game this
+* thread is working on
 *
 *ARGUMENTS:
 *  itemNum - Item number to add
@@ -208,24 +216,25 @@ void logAddEvent(logitem itemNum, BYTE opt1, BYTE opt2, BYTE opt3, BYTE opt4, un
 *NAME:          logDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/5/01
-*LAST MODIFIED: 5/5/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Shuts down the log subsystem
+* Shuts down a game's log
 *
 *ARGUMENTS:
-*  
+*  value - Pointer to the log
 *********************************************************/
-void logDestroy();
+void logDestroy(logContext *value);
 
 /*********************************************************
 *NAME:          logStart
 *AUTHOR:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Starts logging, returns success
 *
 *ARGUMENTS:
+* lc          - The log
 * fileName    - FileName and path of the file to open
 * mp          - Map file
 * pb          - Pillboxes
@@ -237,17 +246,18 @@ void logDestroy();
 *                game
 * usePassword - Is the game password protected
 *********************************************************/
-bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, players *plrs, BYTE ai, BYTE maxPlayers, bool usePassword);
+bool logStart(logContext lc, char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, players *plrs, BYTE ai, BYTE maxPlayers, bool usePassword);
 
 /*********************************************************
 *NAME:          logWriteSnapshot
 *AUTHOR:        John Morrison
 *CREATION DATE: 25/07/04
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Writes a snapshot. Returns success
 *
 *ARGUMENTS:
+* lc   - The log
 * mp   - Map file
 * pb   - Pillboxes
 * bs   - Bases
@@ -255,24 +265,39 @@ bool logStart(char *fileName, map *mp, bases *bs, pillboxes *pb, starts *ss, pla
 * plrs - Players
 * check - Whether to check if running or not
 *********************************************************/
-bool logWriteSnapshot(map *mp, pillboxes *pb, bases *bs, starts *ss, players *plrs, bool check);
+bool logWriteSnapshot(logContext lc, map *mp, pillboxes *pb, bases *bs, starts *ss, players *plrs, bool check);
 
 /*********************************************************
 *NAME:          logCheckTankSame
 *AUTHOR:        John Morrison
 *CREATION DATE: 24/01/05
-*LAST MODIFIED: 24/01/05
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks if the tanks position is the same from last
 * update.
 *
 *ARGUMENTS:
+* lc        - The log
 * playerNum - Player number to check
 * mx        - Tank MX
 * my        - Tank MY
 * pxy       - Tank PXY
 * opt       - Misc tank data
 *********************************************************/
-bool logCheckTankSame(BYTE playerNum, BYTE mx, BYTE my, BYTE pxy, BYTE opt);
+bool logCheckTankSame(logContext lc, BYTE playerNum, BYTE mx, BYTE my, BYTE pxy, BYTE opt);
+
+/*********************************************************
+*NAME:          logGetWriterStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the writer counters since the log was started
+*
+*ARGUMENTS:
+* lc    - The log
+* stats - Structure to fill in
+*********************************************************/
+void logGetWriterStats(logContext lc, logWriterStats *stats);
 
 #endif /* _LOG_H */
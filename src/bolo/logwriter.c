@@ -0,0 +1,524 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Log Writer
+*Filename:      logwriter.c
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Takes the bytes of a game log off the game tick. See
+*  logwriter.h
+*********************************************************/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include "SDL.h"
+#include "SDL_thread.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "global.h"
+#include "logwriter.h"
+
+/* Ring positions are shared between the tick and the
+   writer thread. Each side only stores its own position
+   and loads the other's, so a load that acquires and a
+   store that releases are all the ring needs */
+#ifdef _WIN32
+typedef volatile LONG logWriterIndex;
+#define logWriterLoad(x) ((long) InterlockedCompareExchange(&(x), 0, 0))
+#define logWriterStore(x, v) InterlockedExchange(&(x), (LONG) (v))
+#define logWriterSleep(ms) Sleep(ms)
+#else
+typedef volatile long logWriterIndex;
+#define logWriterLoad(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define logWriterStore(x, v) __atomic_store_n(&(x), (long) (v), __ATOMIC_RELEASE)
+#define logWriterSleep(ms) SDL_Delay(ms)
+#endif
+
+#define LOG_WRITER_RING_MASK (LOG_WRITER_RING_SIZE - 1)
+
+static bool logWriterThreaded = TRUE; /* Next log uses a writer thread */
+static int logWriterFlushTime = LOG_WRITER_FLUSH_DEFAULT;
+
+/* A game's writer */
+struct logWriterObj {
+  BYTE *ring;                /* Keys, lengths and bytes */
+  BYTE *batch;               /* XORed bytes to deflate */
+  logWriterIndex head;       /* Next byte the tick adds */
+  logWriterIndex tail;       /* Next byte the writer reads */
+  logWriterIndex running;    /* Writer thread should run */
+  logWriterIndex failed;     /* A deflate failed */
+  logWriterIndex flushNow;   /* Pass without waiting */
+  zipFile file;              /* File being written */
+  bool open;                 /* A log is being written */
+  bool usingThread;          /* This log uses a writer thread */
+  logWriterStats counters;
+#ifdef _WIN32
+  HANDLE thread;
+#else
+  SDL_Thread *thread;
+#endif
+};
+
+/*********************************************************
+*NAME:          logWriterSetThreaded
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Sets if the next log started uses the writer thread. On
+*  by default
+*
+*ARGUMENTS:
+*  on - TRUE to write from a thread
+*********************************************************/
+void logWriterSetThreaded(bool on) {
+  logWriterThreaded = on;
+}
+
+/*********************************************************
+*NAME:          logWriterSetFlushTime
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Sets the milliseconds between writer thread passes.
+*  Values outside 0 to LOG_WRITER_FLUSH_MAX are clamped
+*
+*ARGUMENTS:
+*  ms - Milliseconds between passes
+*********************************************************/
+void logWriterSetFlushTime(int ms) {
+  if (ms < 0) {
+    ms = 0;
+  } else if (ms > LOG_WRITER_FLUSH_MAX) {
+    ms = LOG_WRITER_FLUSH_MAX;
+  }
+  logWriterFlushTime = ms;
+}
+
+/*********************************************************
+*NAME:          logWriterGetFlushTime
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the milliseconds between writer thread passes
+*
+*ARGUMENTS:
+*
+*********************************************************/
+int logWriterGetFlushTime(void) {
+  return logWriterFlushTime;
+}
+
+/*********************************************************
+*NAME:          logWriterCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates a writer for a game's log. Returns NULL on out
+*  of memory
+*
+*ARGUMENTS:
+*
+*********************************************************/
+logWriter logWriterCreate(void) {
+  logWriter returnValue; /* Value to return */
+
+  New(returnValue);
+  if (returnValue != NULL) {
+    memset(returnValue, 0, sizeof(*returnValue));
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          logWriterDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Stops a writer if it is running and frees it
+*
+*ARGUMENTS:
+*  value - Pointer to the writer
+*********************************************************/
+void logWriterDestroy(logWriter *value) {
+  if (*value != NULL) {
+    logWriterStop(*value);
+    Dispose(*value);
+    *value = NULL;
+  }
+}
+
+/*********************************************************
+*NAME:          logWriterDeflate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Deflates a batch into the zip file. Once a deflate has
+*  failed later batches are dropped
+*
+*ARGUMENTS:
+*  lw  - The writer
+*  len - Bytes in the batch
+*********************************************************/
+static void logWriterDeflate(logWriter lw, int len) {
+  if (len > 0 && logWriterLoad(lw->failed) == FALSE) {
+    lw->counters.deflates++;
+    if (zipWriteInFileInZip(lw->file, lw->batch, (unsigned) len) != ZIP_OK) {
+      logWriterStore(lw->failed, TRUE);
+    }
+  }
+}
+
+/*********************************************************
+*NAME:          logWriterPass
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes everything in the ring. The writes are XORed
+*  into a batch which is deflated when the next write
+*  won't fit and at the end. The space a batch came from
+*  is handed back to the tick once it is deflated
+*
+*ARGUMENTS:
+*  lw - The writer
+*********************************************************/
+static void logWriterPass(logWriter lw) {
+  long head;    /* Ring end when the pass started */
+  long tail;    /* Next write to read */
+  long pos;     /* Position in the ring */
+  int len;      /* Length of the write */
+  int batchLen; /* Bytes in the batch */
+  int count;    /* Looping variable */
+  BYTE key;     /* Key of the write */
+
+  head = logWriterLoad(lw->head);
+  tail = logWriterLoad(lw->tail);
+  if (head == tail) {
+    return;
+  }
+  lw->counters.passes++;
+  batchLen = 0;
+  while (tail != head) {
+    key = lw->ring[tail];
+    len = lw->ring[(tail + 1) & LOG_WRITER_RING_MASK] | (lw->ring[(tail + 2) & LOG_WRITER_RING_MASK] << 8);
+    if (batchLen + len > LOG_WRITER_BATCH_SIZE) {
+      logWriterDeflate(lw, batchLen);
+      logWriterStore(lw->tail, tail);
+      batchLen = 0;
+    }
+    pos = (tail + LOG_WRITER_RECORD_HEADER) & LOG_WRITER_RING_MASK;
+    for (count = 0; count < len; count++) {
+      lw->batch[batchLen + count] = lw->ring[pos] ^ key;
+      pos = (pos + 1) & LOG_WRITER_RING_MASK;
+    }
+    batchLen += len;
+    tail = pos;
+  }
+  logWriterDeflate(lw, batchLen);
+  logWriterStore(lw->tail, tail);
+}
+
+/*********************************************************
+*NAME:          logWriterRun
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  The writer thread. Makes a pass every flush interval,
+*  when the ring is half full or when asked to, then a
+*  last pass once it is told to stop
+*
+*ARGUMENTS:
+*  arg - The writer
+*********************************************************/
+static int logWriterRun(void *arg) {
+  logWriter lw; /* The writer */
+  int waited;   /* Milliseconds since the last pass */
+  long used;    /* Ring bytes in use */
+
+  lw = (logWriter) arg;
+  waited = 0;
+  while (logWriterLoad(lw->running) == TRUE) {
+    logWriterSleep(LOG_WRITER_POLL_TIME);
+    waited += LOG_WRITER_POLL_TIME;
+    used = (logWriterLoad(lw->head) - logWriterLoad(lw->tail)) & LOG_WRITER_RING_MASK;
+    if (waited >= logWriterFlushTime || used >= LOG_WRITER_RING_SIZE / 2 || logWriterLoad(lw->flushNow) == TRUE) {
+      logWriterStore(lw->flushNow, FALSE);
+      logWriterPass(lw);
+      waited = 0;
+    }
+  }
+  logWriterPass(lw);
+  return 0;
+}
+
+/*********************************************************
+*NAME:          logWriterStart
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Starts writing to a zip file with a file open in it.
+*  The writer owns the zip file until logWriterStop.
+*  Returns success
+*
+*ARGUMENTS:
+*  lw   - The writer
+*  file - Zip file to write to
+*********************************************************/
+bool logWriterStart(logWriter lw, zipFile file) {
+  bool returnValue; /* Value to return */
+#ifdef _WIN32
+  DWORD threadId;   /* Not used */
+#endif
+
+  logWriterStop(lw);
+  memset(&lw->counters, 0, sizeof(lw->counters));
+  logWriterStore(lw->head, 0);
+  logWriterStore(lw->tail, 0);
+  logWriterStore(lw->failed, FALSE);
+  logWriterStore(lw->flushNow, FALSE);
+  lw->file = file;
+  lw->usingThread = logWriterThreaded;
+
+  returnValue = TRUE;
+  lw->batch = malloc(LOG_WRITER_BATCH_SIZE);
+  if (lw->batch == NULL) {
+    returnValue = FALSE;
+  }
+  if (returnValue == TRUE && lw->usingThread == TRUE) {
+    lw->ring = malloc(LOG_WRITER_RING_SIZE);
+    if (lw->ring == NULL) {
+      returnValue = FALSE;
+    }
+  }
+  if (returnValue == TRUE && lw->usingThread == TRUE) {
+    logWriterStore(lw->running, TRUE);
+#ifdef _WIN32
+    lw->thread = CreateThread((LPSECURITY_ATTRIBUTES) NULL, 0, (LPTHREAD_START_ROUTINE) logWriterRun, lw, 0, &threadId);
+#else
+    lw->thread = SDL_CreateThread(logWriterRun, lw);
+#endif
+    if (lw->thread == NULL) {
+      returnValue = FALSE;
+    }
+  }
+
+  if (returnValue == TRUE) {
+    lw->open = TRUE;
+  } else {
+    free(lw->ring);
+    free(lw->batch);
+    lw->ring = NULL;
+    lw->batch = NULL;
+    lw->file = NULL;
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          logWriterCopyIn
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Copies bytes into the ring, wrapping at the end.
+*  Returns the position after them
+*
+*ARGUMENTS:
+*  lw   - The writer
+*  pos  - Position to copy to
+*  data - Bytes to copy
+*  len  - Number of bytes
+*********************************************************/
+static long logWriterCopyIn(logWriter lw, long pos, BYTE *data, int len) {
+  int first; /* Bytes before the end of the ring */
+
+  first = LOG_WRITER_RING_SIZE - pos;
+  if (first >= len) {
+    memcpy(lw->ring + pos, data, (size_t) len);
+  } else {
+    memcpy(lw->ring + pos, data, (size_t) first);
+    memcpy(lw->ring, data + first, (size_t) (len - first));
+  }
+  return (pos + len) & LOG_WRITER_RING_MASK;
+}
+
+/*********************************************************
+*NAME:          logWriterAdd
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Adds bytes to be XORed with key and written. The bytes
+*  are copied. Returns FALSE if the writer is not running
+*  or a write has failed
+*
+*ARGUMENTS:
+*  lw   - The writer
+*  data - Bytes to write
+*  len  - Number of bytes, up to LOG_WRITER_MAX_WRITE
+*  key  - Key to XOR them with
+*********************************************************/
+bool logWriterAdd(logWriter lw, BYTE *data, int len, BYTE key) {
+  BYTE header[LOG_WRITER_RECORD_HEADER]; /* Key and length */
+  long head;     /* Where the write goes */
+  long used;     /* Ring bytes in use */
+  int done;      /* Bytes XORed so far */
+  int chunk;     /* Bytes XORed this time */
+  int count;     /* Looping variable */
+
+  if (lw->open == FALSE || len < 0 || len > LOG_WRITER_MAX_WRITE) {
+    return FALSE;
+  }
+  lw->counters.writes++;
+  lw->counters.bytes += (unsigned long) len;
+
+  if (lw->usingThread == FALSE) {
+    /* Straight through from the tick */
+    done = 0;
+    while (done < len) {
+      chunk = len - done;
+      if (chunk > LOG_WRITER_BATCH_SIZE) {
+        chunk = LOG_WRITER_BATCH_SIZE;
+      }
+      for (count = 0; count < chunk; count++) {
+        lw->batch[count] = data[done + count] ^ key;
+      }
+      logWriterDeflate(lw, chunk);
+      done += chunk;
+    }
+    return (bool) (logWriterLoad(lw->failed) == FALSE);
+  }
+
+  head = logWriterLoad(lw->head);
+  used = (head - logWriterLoad(lw->tail)) & LOG_WRITER_RING_MASK;
+  if (LOG_WRITER_RING_SIZE - 1 - used < len + LOG_WRITER_RECORD_HEADER) {
+    /* Back pressure. Wait for the writer rather than drop
+       part of the log */
+    lw->counters.stalls++;
+    logWriterStore(lw->flushNow, TRUE);
+    while (LOG_WRITER_RING_SIZE - 1 - used < len + LOG_WRITER_RECORD_HEADER) {
+      logWriterSleep(LOG_WRITER_WAIT_TIME);
+      lw->counters.waits++;
+      used = (head - logWriterLoad(lw->tail)) & LOG_WRITER_RING_MASK;
+    }
+  }
+
+  header[0] = key;
+  header[1] = (BYTE) (len & 0xFF);
+  header[2] = (BYTE) (len >> 8);
+  head = logWriterCopyIn(lw, head, header, LOG_WRITER_RECORD_HEADER);
+  head = logWriterCopyIn(lw, head, data, len);
+  logWriterStore(lw->head, head);
+
+  used += len + LOG_WRITER_RECORD_HEADER;
+  if ((unsigned long) used > lw->counters.highWater) {
+    lw->counters.highWater = (unsigned long) used;
+  }
+  return (bool) (logWriterLoad(lw->failed) == FALSE);
+}
+
+/*********************************************************
+*NAME:          logWriterSync
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Waits until everything added has been deflated.
+*  Returns FALSE if a write has failed
+*
+*ARGUMENTS:
+*  lw - The writer
+*********************************************************/
+bool logWriterSync(logWriter lw) {
+  if (lw->open == FALSE) {
+    return FALSE;
+  }
+  if (lw->usingThread == TRUE) {
+    logWriterStore(lw->flushNow, TRUE);
+    while (logWriterLoad(lw->tail) != logWriterLoad(lw->head)) {
+      logWriterSleep(LOG_WRITER_WAIT_TIME);
+    }
+  }
+  return (bool) (logWriterLoad(lw->failed) == FALSE);
+}
+
+/*********************************************************
+*NAME:          logWriterStop
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes everything added, stops the writer thread and
+*  hands the zip file back. Returns FALSE if a write
+*  failed
+*
+*ARGUMENTS:
+*  lw - The writer
+*********************************************************/
+bool logWriterStop(logWriter lw) {
+  if (lw->open == FALSE) {
+    return FALSE;
+  }
+  if (lw->usingThread == TRUE) {
+    logWriterStore(lw->running, FALSE);
+#ifdef _WIN32
+    WaitForSingleObject(lw->thread, INFINITE);
+    CloseHandle(lw->thread);
+#else
+    SDL_WaitThread(lw->thread, NULL);
+#endif
+    lw->thread = NULL;
+  }
+  free(lw->ring);
+  free(lw->batch);
+  lw->ring = NULL;
+  lw->batch = NULL;
+  lw->file = NULL;
+  lw->open = FALSE;
+  return (bool) (logWriterLoad(lw->failed) == FALSE);
+}
+
+/*********************************************************
+*NAME:          logWriterGetStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the counters since the last log was started
+*
+*ARGUMENTS:
+*  lw    - The writer
+*  stats - Structure to fill in
+*********************************************************/
+void logWriterGetStats(logWriter lw, logWriterStats *stats) {
+  *stats = lw->counters;
+}
@@ -0,0 +1,235 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Log Writer
+*Filename:      logwriter.h
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Takes the bytes of a game log off the game tick. The
+*  tick appends each write with its key to a single
+*  producer, single consumer ring and returns. A writer
+*  thread wakes every flush interval, or sooner once the
+*  ring is half full, XORs the writes with their keys into
+*  a batch and deflates the batch into the zip file.
+*
+*  Deflate output doesn't depend on how its input is split
+*  up so the log is byte for byte what writing from the
+*  tick produced. The ring never drops a write. If it is
+*  full the tick waits for the writer and the wait is
+*  counted.
+*
+*  Threading can be turned off, in which case each write is
+*  XORed and deflated as it is added as it always was.
+*
+*  Each game's log has its own writer, ring and thread.
+*********************************************************/
+
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include "global.h"
+#include "../zlib/zip.h"
+
+/* Ring size. Must be a power of two and hold the largest
+   single write, the 64K event buffer */
+#define LOG_WRITER_RING_SIZE (1024 * 1024)
+
+/* Key and two byte length in front of each write */
+#define LOG_WRITER_RECORD_HEADER 3
+
+/* Largest single write */
+#define LOG_WRITER_MAX_WRITE 0xFFFF
+
+/* Bytes XORed before each deflate */
+#define LOG_WRITER_BATCH_SIZE (64 * 1024)
+
+/* Default and largest milliseconds between writer passes */
+#define LOG_WRITER_FLUSH_DEFAULT 250
+#define LOG_WRITER_FLUSH_MAX 60000
+
+/* Milliseconds the writer sleeps between checking the
+   ring and the tick sleeps waiting for room */
+#define LOG_WRITER_POLL_TIME 5
+#define LOG_WRITER_WAIT_TIME 1
+
+/* Writer counters */
+typedef struct {
+  unsigned long writes;    /* Writes added */
+  unsigned long bytes;     /* Bytes added, without headers */
+  unsigned long passes;    /* Writer passes that found data */
+  unsigned long deflates;  /* Batches passed to deflate */
+  unsigned long highWater; /* Most ring bytes in use */
+  unsigned long stalls;    /* Writes that waited for room */
+  unsigned long waits;     /* Sleeps while waiting for room */
+} logWriterStats;
+
+/* A game log's writer */
+typedef struct logWriterObj *logWriter;
+
+/* Prototypes */
+
+/*********************************************************
+*NAME:          logWriterSetThreaded
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Sets if the next log started uses the writer thread. On
+*  by default
+*
+*ARGUMENTS:
+*  on - TRUE to write from a thread
+*********************************************************/
+void logWriterSetThreaded(bool on);
+
+/*********************************************************
+*NAME:          logWriterSetFlushTime
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Sets the milliseconds between writer thread passes.
+*  Values outside 0 to LOG_WRITER_FLUSH_MAX are clamped
+*
+*ARGUMENTS:
+*  ms - Milliseconds between passes
+*********************************************************/
+void logWriterSetFlushTime(int ms);
+
+/*********************************************************
+*NAME:          logWriterGetFlushTime
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the milliseconds between writer thread passes
+*
+*ARGUMENTS:
+*
+*********************************************************/
+int logWriterGetFlushTime(void);
+
+/*********************************************************
+*NAME:          logWriterCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates a writer for a game's log. Returns NULL on out
+*  of memory
+*
+*ARGUMENTS:
+*
+*********************************************************/
+logWriter logWriterCreate(void);
+
+/*********************************************************
+*NAME:          logWriterDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Stops a writer if it is running and frees it
+*
+*ARGUMENTS:
+*  value - Pointer to the writer
+*********************************************************/
+void logWriterDestroy(logWriter *value);
+
+/*********************************************************
+*NAME:          logWriterStart
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Starts writing to a zip file with a file open in it.
+*  The writer owns the zip file until logWriterStop.
+*  Returns success
+*
+*ARGUMENTS:
+*  lw   - The writer
+*  file - Zip file to write to
+*********************************************************/
+bool logWriterStart(logWriter lw, zipFile file);
+
+/*********************************************************
+*NAME:          logWriterAdd
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Adds bytes to be XORed with key and written. The bytes
+*  are copied. Returns FALSE if the writer is not running
+*  or a write has failed
+*
+*ARGUMENTS:
+*  lw   - The writer
+*  data - Bytes to write
+*  len  - Number of bytes, up to LOG_WRITER_MAX_WRITE
+*  key  - Key to XOR them with
+*********************************************************/
+bool logWriterAdd(logWriter lw, BYTE *data, int len, BYTE key);
+
+/*********************************************************
+*NAME:          logWriterSync
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Waits until everything added has been deflated.
+*  Returns FALSE if a write has failed
+*
+*ARGUMENTS:
+*  lw - The writer
+*********************************************************/
+bool logWriterSync(logWriter lw);
+
+/*********************************************************
+*NAME:          logWriterStop
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes everything added, stops the writer thread and
+*  hands the zip file back. Returns FALSE if a write
+*  failed
+*
+*ARGUMENTS:
+*  lw - The writer
+*********************************************************/
+bool logWriterStop(logWriter lw);
+
+/*********************************************************
+*NAME:          logWriterGetStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the counters since the last log was started
+*
+*ARGUMENTS:
+*  lw    - The writer
+*  stats - Structure to fill in
+*********************************************************/
+void logWriterGetStats(logWriter lw, logWriterStats *stats);
+
+#endif /* LOGWRITER_H */
@@ -0,0 +1,492 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Map File
+*Filename:      mapfile.c
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Maps map files into memory so they can be decoded in
+*  place, and keeps a binary cache of each loaded map
+*  beside it. The cache holds the centred pill, base and
+*  start tables in map file form and the whole centred
+*  terrain array, so loading it skips decoding the runs
+*  and centring the map.
+*********************************************************/
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <string.h>
+#include "global.h"
+#include "bolo_map.h"
+#include "mapfile.h"
+
+/* Are cache files used */
+static bool mapFileCacheOn = FALSE;
+
+/*********************************************************
+*NAME:          mapFileOpen
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Maps a file into memory read only. Returns FALSE if it
+*  can not be opened, is empty or is bigger than
+*  MAP_FILE_MAX_SIZE
+*
+*ARGUMENTS:
+*  fileName - File to open
+*  mf       - Mapping to fill in
+*********************************************************/
+bool mapFileOpen(char *fileName, mapFile *mf) {
+#ifdef _WIN32
+  DWORD size; /* File size */
+
+  mf->data = NULL;
+  mf->len = 0;
+  mf->mapping = NULL;
+  mf->file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (mf->file == INVALID_HANDLE_VALUE) {
+    mf->file = NULL;
+    return FALSE;
+  }
+  size = GetFileSize(mf->file, NULL);
+  if (size > 0 && size <= MAP_FILE_MAX_SIZE) {
+    mf->mapping = CreateFileMappingA(mf->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mf->mapping != NULL) {
+      mf->data = MapViewOfFile(mf->mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+  }
+  if (mf->data == NULL) {
+    mapFileClose(mf);
+    return FALSE;
+  }
+  mf->len = (int) size;
+  return TRUE;
+#else
+  struct stat st; /* File size */
+  int fd;         /* File descriptor */
+  void *data;     /* Mapped file */
+
+  mf->data = NULL;
+  mf->len = 0;
+  fd = open(fileName, O_RDONLY);
+  if (fd < 0) {
+    return FALSE;
+  }
+  if (fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size > MAP_FILE_MAX_SIZE) {
+    close(fd);
+    return FALSE;
+  }
+  data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  /* The mapping stays after the descriptor is closed */
+  close(fd);
+  if (data == MAP_FAILED) {
+    return FALSE;
+  }
+  mf->data = (BYTE *) data;
+  mf->len = (int) st.st_size;
+  return TRUE;
+#endif
+}
+
+/*********************************************************
+*NAME:          mapFileClose
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Unmaps a file opened with mapFileOpen
+*
+*ARGUMENTS:
+*  mf - Mapping to close
+*********************************************************/
+void mapFileClose(mapFile *mf) {
+#ifdef _WIN32
+  if (mf->data != NULL) {
+    UnmapViewOfFile(mf->data);
+  }
+  if (mf->mapping != NULL) {
+    CloseHandle(mf->mapping);
+  }
+  if (mf->file != NULL) {
+    CloseHandle(mf->file);
+  }
+  mf->mapping = NULL;
+  mf->file = NULL;
+#else
+  if (mf->data != NULL) {
+    munmap(mf->data, (size_t) mf->len);
+  }
+#endif
+  mf->data = NULL;
+  mf->len = 0;
+}
+
+/*********************************************************
+*NAME:          mapFileSetCache
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Sets if mapRead uses and writes cache files. Off by
+*  default
+*
+*ARGUMENTS:
+*  on - TRUE to use cache files
+*********************************************************/
+void mapFileSetCache(bool on) {
+  mapFileCacheOn = on;
+}
+
+/*********************************************************
+*NAME:          mapFileGetCache
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns if mapRead uses and writes cache files
+*
+*ARGUMENTS:
+*
+*********************************************************/
+bool mapFileGetCache(void) {
+  return mapFileCacheOn;
+}
+
+/*********************************************************
+*NAME:          mapFileCacheName
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Makes the cache file name for a map file. Returns
+*  FALSE if the name would not fit in FILENAME_MAX
+*
+*ARGUMENTS:
+*  fileName  - Map file name
+*  cacheName - Buffer of FILENAME_MAX to hold the name
+*********************************************************/
+bool mapFileCacheName(char *fileName, char *cacheName) {
+  size_t len; /* Length of the name without .map */
+
+  len = strlen(fileName);
+  if (len >= 4 && strcmp(fileName + len - 4, ".map") == 0) {
+    len -= 4;
+  }
+  /* Room for the temporary name and process id as well */
+  if (len + strlen(MAP_CACHE_EXT) + 32 >= FILENAME_MAX) {
+    return FALSE;
+  }
+  memcpy(cacheName, fileName, len);
+  strcpy(cacheName + len, MAP_CACHE_EXT);
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          mapFileGetLong
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns a little endian number from a cache header
+*
+*ARGUMENTS:
+*  buff     - Position of the number
+*  numBytes - Bytes in the number
+*********************************************************/
+static unsigned long mapFileGetLong(BYTE *buff, int numBytes) {
+  unsigned long returnValue; /* Value to return */
+
+  returnValue = 0;
+  while (numBytes > 0) {
+    numBytes--;
+    returnValue = (returnValue << 8) | buff[numBytes];
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          mapFilePutLong
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes a little endian number into a cache header
+*
+*ARGUMENTS:
+*  buff     - Position of the number
+*  numBytes - Bytes in the number
+*  value    - Number to write
+*********************************************************/
+static void mapFilePutLong(BYTE *buff, int numBytes, unsigned long value) {
+  int count; /* Looping variable */
+
+  for (count = 0; count < numBytes; count++) {
+    buff[count] = (BYTE) (value & 0xFF);
+    value >>= 8;
+  }
+}
+
+/*********************************************************
+*NAME:          mapFileMakeKey
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes the MAP_CACHE_KEY_SIZE byte key a cache is
+*  matched to its map file by. Windows has no inode or
+*  nanoseconds so those parts are zero there
+*
+*ARGUMENTS:
+*  st   - The map file's stat
+*  buff - Buffer to hold the key
+*********************************************************/
+static void mapFileMakeKey(struct stat *st, BYTE *buff) {
+  unsigned long nsec;      /* Nanoseconds of the time */
+  unsigned long long ino;  /* Inode number */
+
+#if defined(_WIN32)
+  nsec = 0;
+  ino = 0;
+#elif defined(__APPLE__)
+  nsec = (unsigned long) st->st_mtimespec.tv_nsec;
+  ino = (unsigned long long) st->st_ino;
+#else
+  nsec = (unsigned long) st->st_mtim.tv_nsec;
+  ino = (unsigned long long) st->st_ino;
+#endif
+  mapFilePutLong(buff, 4, (unsigned long) st->st_size);
+  mapFilePutLong(buff + 4, 4, (unsigned long) st->st_mtime);
+  mapFilePutLong(buff + 8, 4, nsec);
+  mapFilePutLong(buff + 12, 4, (unsigned long) (ino & 0xFFFFFFFFUL));
+  mapFilePutLong(buff + 16, 4, (unsigned long) (ino >> 32));
+}
+
+/*********************************************************
+*NAME:          mapFileCheck
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns a checksum of a buffer. Four Fletcher sums run
+*  side by side over little endian words so each step does
+*  not wait on the one before it. Checking the terrain
+*  this way costs about as much as copying it where
+*  adler32 costs several times more
+*
+*ARGUMENTS:
+*  buff - Buffer to check
+*  len  - Length of the buffer
+*********************************************************/
+static unsigned long mapFileCheck(BYTE *buff, int len) {
+  BYTE tail[MAP_CACHE_CHECK_BLOCK]; /* Zero padded last block */
+  BYTE *block;          /* Block being summed */
+  unsigned long sum1[MAP_CACHE_CHECK_LANES]; /* Sums of the words */
+  unsigned long sum2[MAP_CACHE_CHECK_LANES]; /* Sums of the sums */
+  unsigned long returnValue; /* Value to return */
+  int count;            /* Looping variable */
+  int lane;             /* Lane being summed */
+
+  memset(sum1, 0, sizeof(sum1));
+  memset(sum2, 0, sizeof(sum2));
+  memset(tail, 0, sizeof(tail));
+  count = 0;
+  while (count < len) {
+    block = buff + count;
+    if (len - count < MAP_CACHE_CHECK_BLOCK) {
+      memcpy(tail, block, (size_t) (len - count));
+      block = tail;
+    }
+    for (lane = 0; lane < MAP_CACHE_CHECK_LANES; lane++) {
+      sum1[lane] += (unsigned long) block[0] | ((unsigned long) block[1] << 8) | ((unsigned long) block[2] << 16) | ((unsigned long) block[3] << 24);
+      sum2[lane] += sum1[lane];
+      block += 4;
+    }
+    count += MAP_CACHE_CHECK_BLOCK;
+  }
+
+  returnValue = 0;
+  for (lane = 0; lane < MAP_CACHE_CHECK_LANES; lane++) {
+    returnValue = (returnValue << 7 | returnValue >> 25) ^ sum1[lane] ^ (sum2[lane] << 16 | (sum2[lane] & 0xFFFFFFFFUL) >> 16);
+    returnValue &= 0xFFFFFFFFUL;
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          mapFileTerrainValid
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns if every terrain byte is a map nibble or deep
+*  sea where no run reached. Adding one wraps deep sea to
+*  0 so both are below 0x11 and the loop has no branches
+*
+*ARGUMENTS:
+*  terrain - Terrain to check
+*********************************************************/
+static bool mapFileTerrainValid(BYTE *terrain) {
+  int count; /* Looping variable */
+  int bad;   /* Any invalid byte */
+
+  bad = 0;
+  for (count = 0; count < MAP_CACHE_TERRAIN_SIZE; count++) {
+    bad |= (BYTE) (terrain[count] + 1) > 0x10;
+  }
+  return (bool) (bad == 0);
+}
+
+/*********************************************************
+*NAME:          mapFileReadCache
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Loads a map from its cache file. The cache is only
+*  used if the map file is the same file, size and age,
+*  to the nanosecond, as when the cache was written, the
+*  checksum matches and every table and terrain value is
+*  valid. Returns FALSE if there is no usable cache
+*
+*ARGUMENTS:
+*  fileName - Map file name
+*  value    - Pointer to the map data structure
+*  pb       - Pointer to the pillbox structure
+*  bs       - Pointer to the bases structure
+*  ss       - Pointer to the starts structure
+*********************************************************/
+bool mapFileReadCache(char *fileName, map *value, pillboxes *pb, bases *bs, starts *ss) {
+  char cacheName[FILENAME_MAX]; /* Cache file name */
+  struct stat st;               /* Map file size, time and inode */
+  mapFile mf;                   /* The mapped cache */
+  BYTE *terrain;                /* Terrain in the cache */
+  BYTE key[MAP_CACHE_KEY_SIZE]; /* Key of the map file now */
+  int tablesLen;                /* Length of the tables */
+  bool returnValue;             /* Value to return */
+
+  if (mapFileCacheName(fileName, cacheName) == FALSE || stat(fileName, &st) != 0) {
+    return FALSE;
+  }
+  mapFileMakeKey(&st, key);
+  if (mapFileOpen(cacheName, &mf) == FALSE) {
+    return FALSE;
+  }
+
+  returnValue = FALSE;
+  if (mf.len > MAP_CACHE_HEADER_SIZE && memcmp(mf.data, MAP_CACHE_ID, LENGTH_ID) == 0 && mf.data[LENGTH_ID] == MAP_CACHE_VERSION) {
+    tablesLen = (int) mapFileGetLong(mf.data + LENGTH_ID + 1, 2);
+    terrain = mf.data + MAP_CACHE_HEADER_SIZE + tablesLen;
+    if (mf.len == MAP_CACHE_HEADER_SIZE + tablesLen + MAP_CACHE_TERRAIN_SIZE
+      && memcmp(mf.data + LENGTH_ID + 3, key, MAP_CACHE_KEY_SIZE) == 0
+      && mapFileGetLong(mf.data + LENGTH_ID + 3 + MAP_CACHE_KEY_SIZE, 4) == mapFileCheck(mf.data + MAP_CACHE_HEADER_SIZE, tablesLen)
+      && mapFileGetLong(mf.data + LENGTH_ID + 7 + MAP_CACHE_KEY_SIZE, 4) == mapFileCheck(terrain, MAP_CACHE_TERRAIN_SIZE)
+      && mapFileTerrainValid(terrain) == TRUE
+      && mapReadTables(mf.data + MAP_CACHE_HEADER_SIZE, tablesLen, pb, bs, ss) == tablesLen) {
+      memcpy((*value)->mapItem, terrain, MAP_CACHE_TERRAIN_SIZE);
+      (*value)->changedAll = TRUE;
+      returnValue = TRUE;
+    }
+  }
+  mapFileClose(&mf);
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          mapFileWriteCache
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes the cache file for a map that has just been
+*  loaded and centred. The file is written under a
+*  temporary name and renamed so a reader never sees half
+*  of one. Returns if it was written
+*
+*ARGUMENTS:
+*  fileName - Map file name
+*  value    - Pointer to the map data structure
+*  pb       - Pointer to the pillbox structure
+*  bs       - Pointer to the bases structure
+*  ss       - Pointer to the starts structure
+*********************************************************/
+bool mapFileWriteCache(char *fileName, map *value, pillboxes *pb, bases *bs, starts *ss) {
+  char cacheName[FILENAME_MAX]; /* Cache file name */
+  char tmpName[FILENAME_MAX];   /* Name written to first */
+  BYTE header[MAP_CACHE_HEADER_SIZE]; /* Cache header */
+  BYTE tables[MAP_TABLES_MAX_SIZE]; /* Pills, bases and starts */
+  int tablesLen;                /* Length of the tables */
+  struct stat st;               /* Map file size, time and inode */
+  FILE *fp;                     /* Cache file */
+  bool returnValue;             /* Value to return */
+
+  if (mapFileCacheName(fileName, cacheName) == FALSE || stat(fileName, &st) != 0) {
+    return FALSE;
+  }
+  tablesLen = mapMakeTables(pb, bs, ss, tables);
+
+  memcpy(header, MAP_CACHE_ID, LENGTH_ID);
+  header[LENGTH_ID] = MAP_CACHE_VERSION;
+  mapFilePutLong(header + LENGTH_ID + 1, 2, (unsigned long) tablesLen);
+  mapFileMakeKey(&st, header + LENGTH_ID + 3);
+  mapFilePutLong(header + LENGTH_ID + 3 + MAP_CACHE_KEY_SIZE, 4, mapFileCheck(tables, tablesLen));
+  mapFilePutLong(header + LENGTH_ID + 7 + MAP_CACHE_KEY_SIZE, 4, mapFileCheck((BYTE *) (*value)->mapItem, MAP_CACHE_TERRAIN_SIZE));
+
+  /* Each process writes its own temporary so two servers
+     caching the same map do not write into one file */
+  if (snprintf(tmpName, sizeof(tmpName), "%s.%lu.tmp", cacheName, (unsigned long) getpid()) >= (int) sizeof(tmpName)) {
+    return FALSE;
+  }
+  fp = fopen(tmpName, "wb");
+  if (fp == NULL) {
+    return FALSE;
+  }
+  returnValue = TRUE;
+  if (fwrite(header, MAP_CACHE_HEADER_SIZE, 1, fp) != 1 || fwrite(tables, (size_t) tablesLen, 1, fp) != 1 || fwrite((*value)->mapItem, MAP_CACHE_TERRAIN_SIZE, 1, fp) != 1) {
+    returnValue = FALSE;
+  }
+  if (fclose(fp) != 0) {
+    returnValue = FALSE;
+  }
+  if (returnValue == TRUE) {
+#ifdef _WIN32
+    /* rename will not replace a file on Windows */
+    remove(cacheName);
+#endif
+    if (rename(tmpName, cacheName) != 0) {
+      returnValue = FALSE;
+    }
+  }
+  if (returnValue == FALSE) {
+    remove(tmpName);
+  }
+  return returnValue;
+}
@@ -0,0 +1,193 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Map File
+*Filename:      mapfile.h
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Maps map files into memory so they can be decoded in
+*  place, and keeps a binary cache of each loaded map
+*  beside it. The cache holds the centred pill, base and
+*  start tables in map file form and the whole centred
+*  terrain array, so loading it is one copy into the map
+*  and skips decoding the runs and centring the map.
+*********************************************************/
+
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include "global.h"
+#include "bolo_map.h"
+
+/* Largest file mapped. Real maps are a few kilobytes */
+#define MAP_FILE_MAX_SIZE (4 * 1024 * 1024)
+
+/* Cache file id, version and extension. The extension
+   replaces .map or is added if the name has none */
+#define MAP_CACHE_ID "BMAPCACH"
+#define MAP_CACHE_VERSION 2
+#define MAP_CACHE_EXT ".bmc"
+
+/* Key of the map file a cache was made from. Four byte
+   size, four byte time in seconds, four byte nanoseconds
+   and eight byte inode, so a rewrite within the same
+   second is still seen */
+#define MAP_CACHE_KEY_SIZE (4 + 4 + 4 + 8)
+
+/* Cache header. Id, version, two byte tables length, the
+   map file key and four byte checksums of the tables and
+   of the terrain. All little endian */
+#define MAP_CACHE_HEADER_SIZE (LENGTH_ID + 1 + 2 + MAP_CACHE_KEY_SIZE + 4 + 4)
+
+/* Checksums sum this many words side by side, four bytes
+   to a word */
+#define MAP_CACHE_CHECK_LANES 4
+#define MAP_CACHE_CHECK_BLOCK (MAP_CACHE_CHECK_LANES * 4)
+
+/* Terrain bytes stored after the tables */
+#define MAP_CACHE_TERRAIN_SIZE (MAP_ARRAY_SIZE * MAP_ARRAY_SIZE)
+
+/* A file mapped into memory */
+typedef struct {
+  BYTE *data;      /* File contents */
+  int len;         /* Length of the file */
+#ifdef _WIN32
+  void *file;      /* Open file HANDLE */
+  void *mapping;   /* File mapping object HANDLE */
+#endif
+} mapFile;
+
+/* Prototypes */
+
+/*********************************************************
+*NAME:          mapFileOpen
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Maps a file into memory read only. Returns FALSE if it
+*  can not be opened, is empty or is bigger than
+*  MAP_FILE_MAX_SIZE
+*
+*ARGUMENTS:
+*  fileName - File to open
+*  mf       - Mapping to fill in
+*********************************************************/
+bool mapFileOpen(char *fileName, mapFile *mf);
+
+/*********************************************************
+*NAME:          mapFileClose
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Unmaps a file opened with mapFileOpen
+*
+*ARGUMENTS:
+*  mf - Mapping to close
+*********************************************************/
+void mapFileClose(mapFile *mf);
+
+/*********************************************************
+*NAME:          mapFileSetCache
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Sets if mapRead uses and writes cache files. Off by
+*  default
+*
+*ARGUMENTS:
+*  on - TRUE to use cache files
+*********************************************************/
+void mapFileSetCache(bool on);
+
+/*********************************************************
+*NAME:          mapFileGetCache
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns if mapRead uses and writes cache files
+*
+*ARGUMENTS:
+*
+*********************************************************/
+bool mapFileGetCache(void);
+
+/*********************************************************
+*NAME:          mapFileCacheName
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Makes the cache file name for a map file. Returns
+*  FALSE if the name would not fit in FILENAME_MAX
+*
+*ARGUMENTS:
+*  fileName  - Map file name
+*  cacheName - Buffer of FILENAME_MAX to hold the name
+*********************************************************/
+bool mapFileCacheName(char *fileName, char *cacheName);
+
+/*********************************************************
+*NAME:          mapFileReadCache
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Loads a map from its cache file. The cache is only
+*  used if the map file is the size and age it was when
+*  the cache was written, the checksum matches and every
+*  table and terrain value is valid. Returns FALSE if
+*  there is no usable cache
+*
+*ARGUMENTS:
+*  fileName - Map file name
+*  value    - Pointer to the map data structure
+*  pb       - Pointer to the pillbox structure
+*  bs       - Pointer to the bases structure
+*  ss       - Pointer to the starts structure
+*********************************************************/
+bool mapFileReadCache(char *fileName, map *value, pillboxes *pb, bases *bs, starts *ss);
+
+/*********************************************************
+*NAME:          mapFileWriteCache
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes the cache file for a map that has just been
+*  loaded and centred. The file is written under a
+*  temporary name and renamed so a reader never sees half
+*  of one. Returns if it was written
+*
+*ARGUMENTS:
+*  fileName - Map file name
+*  value    - Pointer to the map data structure
+*  pb       - Pointer to the pillbox structure
+*  bs       - Pointer to the bases structure
+*  ss       - Pointer to the starts structure
+*********************************************************/
+bool mapFileWriteCache(char *fileName, map *value, pillboxes *pb, bases *bs, starts *ss);
+
+#endif /* MAPFILE_H */
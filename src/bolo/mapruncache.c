@@ -0,0 +1,246 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Map Run Cache
+*Filename:      mapruncache.c
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Keeps the compressed map network runs sent to joining
+*  players. A run is made once and copied out until a row
+*  it holds changes. The map marks changed rows and the
+*  cache drops the runs holding them when next asked.
+*********************************************************/
+
+#include <string.h>
+#include "global.h"
+#include "bolo_map.h"
+#include "mapruncache.h"
+
+/*********************************************************
+*NAME:          mapRunCacheBlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns the cache block of the run at yPos or -1 if a
+* joining player would never ask for it
+*
+*ARGUMENTS:
+*  yPos - Y position of the run
+*********************************************************/
+static int mapRunCacheBlock(BYTE yPos) {
+  int returnValue; /* Value to return */
+
+  returnValue = -1;
+  if (yPos >= MAP_NET_FIRST_ROW && (yPos - MAP_NET_FIRST_ROW) % MAP_NET_RUN_STEP == 0) {
+    returnValue = (yPos - MAP_NET_FIRST_ROW) / MAP_NET_RUN_STEP;
+    if (returnValue >= MAP_RUN_CACHE_BLOCKS) {
+      returnValue = -1;
+    }
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          mapRunCacheCollect
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Takes the rows changed since the last call from the map
+* and drops every run holding one of them. A row on the
+* boundary of two runs drops both
+*
+*ARGUMENTS:
+*  rc - Pointer to the run cache
+*  mp - Pointer to the map the runs are from
+*********************************************************/
+static void mapRunCacheCollect(mapRunCache *rc, map *mp) {
+  BYTE rows[MAP_ARRAY_SIZE / 8]; /* Changed rows */
+  int yPos;                      /* Row being looked at */
+  int first;                     /* First run holding the row */
+  int last;                      /* Last run holding the row */
+
+  mapTakeDirtyRows(mp, rows);
+  for (yPos=MAP_NET_FIRST_ROW;yPos<=MAP_NET_LAST_ROW;yPos++) {
+    if ((rows[yPos >> 3] & (1 << (yPos & 7))) != 0) {
+      first = yPos - MAP_NET_FIRST_ROW - (MAP_NET_RUN_ROWS - 1);
+      if (first < 0) {
+        first = 0;
+      } else {
+        first = (first + MAP_NET_RUN_STEP - 1) / MAP_NET_RUN_STEP;
+      }
+      last = (yPos - MAP_NET_FIRST_ROW) / MAP_NET_RUN_STEP;
+      if (last >= MAP_RUN_CACHE_BLOCKS) {
+        last = MAP_RUN_CACHE_BLOCKS - 1;
+      }
+      while (first <= last) {
+        (*rc)->clean[first] = FALSE;
+        (*rc)->version[first]++;
+        first++;
+      }
+    }
+  }
+}
+
+/*********************************************************
+*NAME:          mapRunCacheCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates an empty run cache
+*
+*ARGUMENTS:
+*  rc - Pointer to the run cache
+*********************************************************/
+void mapRunCacheCreate(mapRunCache *rc) {
+  New(*rc);
+  memset(*rc, 0, sizeof(**rc));
+}
+
+/*********************************************************
+*NAME:          mapRunCacheDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys and frees memory for a run cache
+*
+*ARGUMENTS:
+*  rc - Pointer to the run cache
+*********************************************************/
+void mapRunCacheDestroy(mapRunCache *rc) {
+  if (*rc != NULL) {
+    Dispose(*rc);
+    *rc = NULL;
+  }
+}
+
+/*********************************************************
+*NAME:          mapRunCacheGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Copies the run at yPos into buff and returns its
+*  length. If it isn't cached its rows are copied into
+*  rows, version is set for mapRunCachePut and
+*  MAP_RUN_CACHE_MISS is returned. Must be called with
+*  the map locked
+*
+*ARGUMENTS:
+*  rc      - Pointer to the run cache
+*  mp      - Pointer to the map the runs are from
+*  yPos    - Y position of the run
+*  buff    - Buffer to hold the run
+*  rows    - Buffer of MAP_NET_RUN_SIZE to hold the rows
+*  version - Set to the run version on a miss
+*********************************************************/
+int mapRunCacheGet(mapRunCache *rc, map *mp, BYTE yPos, BYTE *buff, BYTE *rows, unsigned long *version) {
+  int block; /* Cache block of the run */
+
+  mapRunCacheCollect(rc, mp);
+  block = mapRunCacheBlock(yPos);
+  if (block >= 0 && (*rc)->clean[block] == TRUE) {
+    memcpy(buff, (*rc)->data[block], (size_t) (*rc)->len[block]);
+    (*rc)->hits++;
+    return (*rc)->len[block];
+  }
+
+  *version = 0;
+  if (block >= 0) {
+    *version = (*rc)->version[block];
+  }
+  mapCopyNetRun(mp, rows, yPos);
+  (*rc)->misses++;
+  return MAP_RUN_CACHE_MISS;
+}
+
+/*********************************************************
+*NAME:          mapRunCacheEncode
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Compresses the rows copied by mapRunCacheGet into buff
+*  and returns the length. Doesn't touch the cache or the
+*  map so the map needn't be locked
+*
+*ARGUMENTS:
+*  rows - Rows copied by mapRunCacheGet
+*  buff - Buffer to hold the run
+*********************************************************/
+int mapRunCacheEncode(BYTE *rows, BYTE *buff) {
+  lzwContext ctx; /* Coding state */
+
+  return lzwEncode(&ctx, (char *) rows, (char *) buff, MAP_NET_RUN_SIZE);
+}
+
+/*********************************************************
+*NAME:          mapRunCachePut
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Keeps a run made by mapRunCacheEncode unless one of its
+*  rows has changed since mapRunCacheGet. Must be called
+*  with the map locked
+*
+*ARGUMENTS:
+*  rc      - Pointer to the run cache
+*  mp      - Pointer to the map the runs are from
+*  yPos    - Y position of the run
+*  buff    - The run
+*  len     - Length of the run
+*  version - Version from mapRunCacheGet
+*********************************************************/
+void mapRunCachePut(mapRunCache *rc, map *mp, BYTE yPos, BYTE *buff, int len, unsigned long version) {
+  int block; /* Cache block of the run */
+
+  mapRunCacheCollect(rc, mp);
+  block = mapRunCacheBlock(yPos);
+  if (block >= 0 && (*rc)->version[block] == version && len > 0 && len <= MAP_RUN_CACHE_MAX_SIZE) {
+    memcpy((*rc)->data[block], buff, (size_t) len);
+    (*rc)->len[block] = len;
+    (*rc)->clean[block] = TRUE;
+  }
+}
+
+/*********************************************************
+*NAME:          mapRunCacheGetStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the number of runs copied out of the cache and the
+*  number that had to be made
+*
+*ARGUMENTS:
+*  rc     - Pointer to the run cache
+*  hits   - Runs copied out
+*  misses - Runs made
+*********************************************************/
+void mapRunCacheGetStats(mapRunCache *rc, unsigned long *hits, unsigned long *misses) {
+  *hits = (*rc)->hits;
+  *misses = (*rc)->misses;
+}
@@ -0,0 +1,169 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Map Run Cache
+*Filename:      mapruncache.h
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Keeps the compressed map network runs sent to joining
+*  players. A run is made once and copied out until a row
+*  it holds changes. The map marks changed rows and the
+*  cache drops the runs holding them when next asked.
+*
+*  A missing run is made in three steps so the compression
+*  can happen without the game lock held:
+*  1. mapRunCacheGet with the lock copies the rows out
+*  2. mapRunCacheEncode without the lock compresses them
+*  3. mapRunCachePut with the lock keeps the run if none
+*     of its rows changed in the meantime
+*********************************************************/
+
+#ifndef MAPRUNCACHE_H
+#define MAPRUNCACHE_H
+
+#include "global.h"
+#include "bolo_map.h"
+#include "../lzw/lzw.h"
+
+/* Runs start at MAP_NET_FIRST_ROW every MAP_NET_RUN_STEP
+   rows down to the last one ending on MAP_NET_LAST_ROW */
+#define MAP_RUN_CACHE_BLOCKS ((MAP_NET_LAST_ROW - MAP_NET_RUN_ROWS + 1 - MAP_NET_FIRST_ROW) / MAP_NET_RUN_STEP + 1)
+
+/* Largest compressed run */
+#define MAP_RUN_CACHE_MAX_SIZE LZW_MAX_SIZE(MAP_NET_RUN_SIZE)
+
+/* Returned by mapRunCacheGet when the run must be made */
+#define MAP_RUN_CACHE_MISS -1
+
+typedef struct mapRunCacheObj *mapRunCache;
+struct mapRunCacheObj {
+  BYTE data[MAP_RUN_CACHE_BLOCKS][MAP_RUN_CACHE_MAX_SIZE]; /* Compressed runs */
+  int len[MAP_RUN_CACHE_BLOCKS];                 /* Length of each run */
+  bool clean[MAP_RUN_CACHE_BLOCKS];              /* Run is up to date */
+  unsigned long version[MAP_RUN_CACHE_BLOCKS];   /* Times each run was dropped */
+  unsigned long hits;                            /* Runs copied out */
+  unsigned long misses;                          /* Runs made */
+};
+
+/* Prototypes */
+
+/*********************************************************
+*NAME:          mapRunCacheCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates an empty run cache
+*
+*ARGUMENTS:
+*  rc - Pointer to the run cache
+*********************************************************/
+void mapRunCacheCreate(mapRunCache *rc);
+
+/*********************************************************
+*NAME:          mapRunCacheDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys and frees memory for a run cache
+*
+*ARGUMENTS:
+*  rc - Pointer to the run cache
+*********************************************************/
+void mapRunCacheDestroy(mapRunCache *rc);
+
+/*********************************************************
+*NAME:          mapRunCacheGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Copies the run at yPos into buff and returns its
+*  length. If it isn't cached its rows are copied into
+*  rows, version is set for mapRunCachePut and
+*  MAP_RUN_CACHE_MISS is returned. Must be called with
+*  the map locked
+*
+*ARGUMENTS:
+*  rc      - Pointer to the run cache
+*  mp      - Pointer to the map the runs are from
+*  yPos    - Y position of the run
+*  buff    - Buffer to hold the run
+*  rows    - Buffer of MAP_NET_RUN_SIZE to hold the rows
+*  version - Set to the run version on a miss
+*********************************************************/
+int mapRunCacheGet(mapRunCache *rc, map *mp, BYTE yPos, BYTE *buff, BYTE *rows, unsigned long *version);
+
+/*********************************************************
+*NAME:          mapRunCacheEncode
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Compresses the rows copied by mapRunCacheGet into buff
+*  and returns the length. Doesn't touch the cache or the
+*  map so the map needn't be locked
+*
+*ARGUMENTS:
+*  rows - Rows copied by mapRunCacheGet
+*  buff - Buffer to hold the run
+*********************************************************/
+int mapRunCacheEncode(BYTE *rows, BYTE *buff);
+
+/*********************************************************
+*NAME:          mapRunCachePut
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Keeps a run made by mapRunCacheEncode unless one of its
+*  rows has changed since mapRunCacheGet. Must be called
+*  with the map locked
+*
+*ARGUMENTS:
+*  rc      - Pointer to the run cache
+*  mp      - Pointer to the map the runs are from
+*  yPos    - Y position of the run
+*  buff    - The run
+*  len     - Length of the run
+*  version - Version from mapRunCacheGet
+*********************************************************/
+void mapRunCachePut(mapRunCache *rc, map *mp, BYTE yPos, BYTE *buff, int len, unsigned long version);
+
+/*********************************************************
+*NAME:          mapRunCacheGetStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the number of runs copied out of the cache and the
+*  number that had to be made
+*
+*ARGUMENTS:
+*  rc     - Pointer to the run cache
+*  hits   - Runs copied out
+*  misses - Runs made
+*********************************************************/
+void mapRunCacheGetStats(mapRunCache *rc, unsigned long *hits, unsigned long *misses);
+
+#endif /* MAPRUNCACHE_H */
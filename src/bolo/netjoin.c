@@ -0,0 +1,149 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Net Join
+*Filename:      netjoin.c
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Packs everything a joining player has to download -
+*  starts, bases, pillboxes and the map - into one zlib
+*  compressed blob. The server sends the blob as a run of
+*  chunks without waiting between them so a join takes
+*  one round trip instead of one per request.
+*********************************************************/
+
+#include <string.h>
+#include "global.h"
+#include "bolo_map.h"
+#include "starts.h"
+#include "bases.h"
+#include "pillbox.h"
+#include "../zlib/zlib.h"
+#include "netjoin.h"
+
+/*********************************************************
+*NAME:          netJoinCopy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Copies everything in the join blob into raw without
+*  compressing it so the game can carry on while it is
+*  packed. raw must hold NET_JOIN_RAW_SIZE bytes. Returns
+*  the length copied
+*
+*ARGUMENTS:
+*  mp  - Pointer to the map structure
+*  ss  - Pointer to the starts structure
+*  bs  - Pointer to the bases structure
+*  pb  - Pointer to the pillboxes structure
+*  raw - Buffer to hold the uncompressed blob
+*********************************************************/
+int netJoinCopy(map *mp, starts *ss, bases *bs, pillboxes *pb, BYTE *raw) {
+  BYTE *pnt; /* Position in raw */
+
+  pnt = raw;
+  *pnt = startsGetStartNetData(ss, pnt+1);
+  pnt += *pnt + 1;
+  *pnt = basesGetBaseNetData(bs, pnt+1);
+  pnt += *pnt + 1;
+  *pnt = pillsGetPillNetData(pb, pnt+1);
+  pnt += *pnt + 1;
+  mapMakeNetBlock(mp, pnt);
+  pnt += MAP_NET_BLOCK_SIZE;
+
+  return (int) (pnt - raw);
+}
+
+/*********************************************************
+*NAME:          netJoinPack
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Compresses a blob made by netJoinCopy. buff must hold
+*  NET_JOIN_MAX_SIZE bytes. Returns the blob length or 0
+*  if it could not be made
+*
+*ARGUMENTS:
+*  raw    - Uncompressed blob
+*  rawLen - Length of raw
+*  buff   - Buffer to hold the blob
+*********************************************************/
+int netJoinPack(BYTE *raw, int rawLen, BYTE *buff) {
+  uLongf len; /* Compressed length */
+
+  len = NET_JOIN_MAX_SIZE;
+  if (compress2(buff, &len, raw, (uLong) rawLen, Z_DEFAULT_COMPRESSION) != Z_OK) {
+    return 0;
+  }
+  return (int) len;
+}
+
+/*********************************************************
+*NAME:          netJoinTake
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Uncompresses a join blob into raw and points data at
+*  each part. raw must hold NET_JOIN_RAW_SIZE bytes.
+*  Returns FALSE if the blob is damaged
+*
+*ARGUMENTS:
+*  buff - Compressed blob
+*  len  - Length of the blob
+*  raw  - Buffer to uncompress into
+*  data - Filled with the parts of the blob
+*********************************************************/
+bool netJoinTake(BYTE *buff, int len, BYTE *raw, netJoinData *data) {
+  uLongf rawLen; /* Uncompressed length */
+  uLongf upto;   /* Position in raw */
+
+  rawLen = NET_JOIN_RAW_SIZE;
+  if (len <= 0 || uncompress(raw, &rawLen, buff, (uLong) len) != Z_OK) {
+    return FALSE;
+  }
+
+  upto = 0;
+  data->startsLen = raw[upto];
+  data->starts = raw + upto + 1;
+  upto += data->startsLen + 1;
+  if (upto >= rawLen) {
+    return FALSE;
+  }
+  data->basesLen = raw[upto];
+  data->bases = raw + upto + 1;
+  upto += data->basesLen + 1;
+  if (upto >= rawLen) {
+    return FALSE;
+  }
+  data->pillsLen = raw[upto];
+  data->pills = raw + upto + 1;
+  upto += data->pillsLen + 1;
+  if (upto + MAP_NET_BLOCK_SIZE != rawLen) {
+    return FALSE;
+  }
+  data->mapBlock = raw + upto;
+
+  return TRUE;
+}
@@ -0,0 +1,131 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Net Join
+*Filename:      netjoin.h
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Packs everything a joining player has to download -
+*  starts, bases, pillboxes and the map - into one zlib
+*  compressed blob. The server sends the blob as a run of
+*  chunks without waiting between them so a join takes
+*  one round trip instead of one per request.
+*********************************************************/
+
+#ifndef NETJOIN_H
+#define NETJOIN_H
+
+#include "global.h"
+#include "bolo_map.h"
+
+/* Largest starts, bases or pills net data. Their lengths
+   are sent in a byte */
+#define NET_JOIN_ITEM_SIZE 256
+
+/* Uncompressed blob. A length byte and data for each of
+   starts, bases and pills then the map block */
+#define NET_JOIN_RAW_SIZE (3 * NET_JOIN_ITEM_SIZE + MAP_NET_BLOCK_SIZE)
+
+/* Data bytes in each chunk. Kept well under a packet so
+   a chunk still fits a retransmission */
+#define NET_JOIN_CHUNK_SIZE 900
+
+/* Chunk header. Blob id, chunk number, number of chunks
+   and a two byte data length */
+#define NET_JOIN_CHUNK_HEADER 5
+
+/* Most chunks a blob can take */
+#define NET_JOIN_MAX_CHUNKS 64
+
+/* Largest compressed blob */
+#define NET_JOIN_MAX_SIZE (NET_JOIN_CHUNK_SIZE * NET_JOIN_MAX_CHUNKS)
+
+/* An unpacked blob. The pointers are into the raw buffer
+   passed to netJoinTake */
+typedef struct {
+  BYTE *starts;
+  BYTE startsLen;
+  BYTE *bases;
+  BYTE basesLen;
+  BYTE *pills;
+  BYTE pillsLen;
+  BYTE *mapBlock;
+} netJoinData;
+
+/* Prototypes */
+
+/*********************************************************
+*NAME:          netJoinCopy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Copies everything in the join blob into raw without
+*  compressing it so the game can carry on while it is
+*  packed. raw must hold NET_JOIN_RAW_SIZE bytes. Returns
+*  the length copied
+*
+*ARGUMENTS:
+*  mp  - Pointer to the map structure
+*  ss  - Pointer to the starts structure
+*  bs  - Pointer to the bases structure
+*  pb  - Pointer to the pillboxes structure
+*  raw - Buffer to hold the uncompressed blob
+*********************************************************/
+int netJoinCopy(map *mp, starts *ss, bases *bs, pillboxes *pb, BYTE *raw);
+
+/*********************************************************
+*NAME:          netJoinPack
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Compresses a blob made by netJoinCopy. buff must hold
+*  NET_JOIN_MAX_SIZE bytes. Returns the blob length or 0
+*  if it could not be made
+*
+*ARGUMENTS:
+*  raw    - Uncompressed blob
+*  rawLen - Length of raw
+*  buff   - Buffer to hold the blob
+*********************************************************/
+int netJoinPack(BYTE *raw, int rawLen, BYTE *buff);
+
+/*********************************************************
+*NAME:          netJoinTake
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Uncompresses a join blob into raw and points data at
+*  each part. raw must hold NET_JOIN_RAW_SIZE bytes.
+*  Returns FALSE if the blob is damaged
+*
+*ARGUMENTS:
+*  buff - Compressed blob
+*  len  - Length of the blob
+*  raw  - Buffer to uncompress into
+*  data - Filled with the parts of the blob
+*********************************************************/
+bool netJoinTake(BYTE *buff, int len, BYTE *raw, netJoinData *data);
+
+#endif /* NETJOIN_H */
@@ -47,6 +47,7 @@
 #include "network.h"
 #include "players.h"
 #include "../server/servercore.h"
+#include "../server/servernet.h"
 #include "../winbolonet/winbolonet.h"
 #include "log.h"
 #include "netmt.h"
@@ -249,7 +250,7 @@ bool netMNTExtractServer(netMntContext *nmtc, map *mp, pillboxes *pb, bases *bs,
   case NMNT_MANRETURN:
     break;
   case NMNT_MANACTION:
-    serverCoreLgmOperation(owner, opt1, opt2, itemNum);
+    serverCoreLgmOperation(serverCoreGetContext(), owner, opt1, opt2, itemNum);
     returnValue = FALSE;
     break;
   case NMNT_RUBBLE:
@@ -274,12 +275,12 @@ bool netMNTExtractServer(netMntContext *nmtc, map *mp, pillboxes *pb, bases *bs,
     break;
   case NMNT_TANKHIT:
     /* Process a tank hit */
-    tk = serverCoreGetTankFromPlayer(owner);
+    tk = serverCoreGetTankFromPlayer(serverCoreGetContext(), owner);
     if (tk != NULL) {
       if (opt1 == 0xFF && opt2 == 0xFF) {
         /* Cheaters */
 
-        netPlayersSetCheater(serverNetGetNetPlayers(), owner);
+        netPlayersSetCheater(serverNetGetNetPlayers(serverCoreGetContext()), owner);
 //        printf("Cheat received - memory hack...\n");
       } else if (opt1 < 127) {
         tankAddHit(tk, opt1);
@@ -36,7 +36,9 @@
 #define BOLO_VERSION_MAJORPOS    4
 #define BOLO_VERSION_MINOR       0x01
 #define BOLO_VERSION_MINORPOS    5
-#define BOLO_VERSION_REVISION    0x05
+/* 0x06 - Positions are sent as BOLO_PACKET_POSDELTA and the
+   client position packet ends with the frame it acknowledges */
+#define BOLO_VERSION_REVISION    0x06
 #define BOLO_VERSION_REVISIONPOS 6
 
 /* Packet types */
@@ -132,6 +134,10 @@
 /* All your missing packets */
 #define BOLOPACKET_RETRANSMITTED_PACKETS 65
 
+/* Starts, bases, pills and map in one compressed blob */
+#define BOLOPACKET_JOINDATAREQUEST 66
+#define BOLOPACKET_JOINDATARESPONSE 67
+
 /* Server message packet */
 #define BOLOSERVERMESSAGE 49
 
@@ -171,6 +177,7 @@
 #define BOLO_PACKET_PNBDATA 13
 #define BOLO_PACKET_MNTDATA 14
 #define BOLO_PACKET_SHELLNHDATA 15
+#define BOLO_PACKET_POSDELTA 16
 /* Game Time request/Response */
 #define BOLOPACKET_TIMEREQUEST 42
 #define BOLOPACKET_TIMERESPONSE 43
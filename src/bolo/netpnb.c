@@ -292,7 +292,7 @@ bool netPNBExtractItemServer(netPnbContext *pnbc, map *mp, bases *bs, pillboxes
     break;
   case NPNB_LGM_FARMTREE:
     /* LGM Farmed a tree */
-    serverCoreLgmOperation(owner, opt1, opt2, LGM_TREE_REQUEST);
+    serverCoreLgmOperation(serverCoreGetContext(), owner, opt1, opt2, LGM_TREE_REQUEST);
     returnValue = FALSE;
     break;
   case NPNB_LGM_BUILDROAD:
@@ -71,6 +71,8 @@
 
 #include "../gui/lang.h"
 #include "udppackets.h"
+#include "posdelta.h"
+#include "netjoin.h"
 #include "../winbolonet/winbolonet.h"
 #include "network.h"
 
@@ -84,6 +86,16 @@ netStatus oldNetStatus = netRunning; /* Network status */
 BYTE netFailedHigh = 0xFF;
 BYTE netYPos; /* Y Position we want for data downloading */
 
+/* Download starts, bases, pills and map as one blob */
+bool netJoinWhole = TRUE;
+/* Join blob being put back together */
+BYTE netJoinBlob[NET_JOIN_MAX_SIZE];
+bool netJoinGot[NET_JOIN_MAX_CHUNKS]; /* Chunks we have */
+int netJoinBlobLen;                   /* Length of the blob */
+BYTE netJoinBlobId;                   /* Blob the chunks are from */
+BYTE netJoinNumChunks = 0;            /* Chunks in the blob */
+BYTE netJoinGotChunks;                /* Chunks we have so far */
+
 /* Data for network status dialog box */
 int netRingDelay = 0;           /* Total Ring delay */
 int netDownStreamDelay = 0;     /* Downstream time delay */
@@ -105,6 +117,9 @@ time_t netLastHeard; /* Last time we got a packet from the server */
 /* Udp packets */
 udpPackets udpp;
 
+/* Position frames received from the server */
+posDelta netPosHistory = NULL;
+
 /* Maximum retries for network things */
 #define MAX_RETRIES 3
 /* Network time */
@@ -117,7 +132,7 @@ int lzwdecoding(char *src, char *dest, int len);
 *NAME:          netSetup
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/02/99
-*LAST MODIFIED: 01/04/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets the network kind of game being played and sets up
 * netClient
@@ -151,6 +166,7 @@ bool netSetup(netType value, unsigned short myPort, char *targetIp, unsigned sho
   networkGameType = value;
   strcpy(netPassword, password);
   udpp = udpPacketsCreate();
+  netPosHistory = posDeltaCreate();
   #ifdef _WIN32
   dlgAllianceWnd = CreateDialog(windowGetInstance(), MAKEINTRESOURCE(IDD_ALLIANCE), windowWnd(), dialogAllianceCallback);
   #else
@@ -191,6 +207,8 @@ bool netSetup(netType value, unsigned short myPort, char *targetIp, unsigned sho
 	
         gameFrontGetPlayerName(playerName);
         netYPos = 21;
+        netJoinWhole = TRUE;
+        netJoinNumChunks = 0;
         returnValue = netJoin(targetIp, targetPort, wantRejoin, playerName, wbnPassword, useWinboloNet, usCreate, password);
 	      if (returnValue == TRUE) {
           screenNetSetupTank(TRUE);
@@ -218,7 +236,7 @@ bool netSetup(netType value, unsigned short myPort, char *targetIp, unsigned sho
 *NAME:          netDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/2/99
-*LAST MODIFIED: 19/4/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Shuts down the network. Calls low-level packet drivers
 * and shuts them down as required.
@@ -245,6 +263,7 @@ void netDestroy(void) {
   networkGameType = netSingle;
   netStat = netRunning;
   udpPacketsDestroy(&udpp);
+  posDeltaDestroy(&netPosHistory);
 }
 
 /*********************************************************
@@ -478,7 +497,7 @@ void netUdpPacketArrive(BYTE *buff, int len, unsigned short port) {
 *NAME:          netTcpPacketArrive
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/09/99
-*LAST MODIFIED: 05/05/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A tcp packet has arrived. It is processed here.
 *
@@ -541,6 +560,10 @@ void netTcpPacketArrive(BYTE *buff, int len) {
     } */
     netPacketsPerSecond++;
     netJoinDataRequests();
+  } else if (len >= BOLOPACKET_REQUEST_SIZE + NET_JOIN_CHUNK_HEADER && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_JOINDATARESPONSE) {
+    /* Here is part of the join blob */
+    netJoinChunkArrive(buff + BOLOPACKET_REQUEST_TYPEPOS + 1, len - (BOLOPACKET_REQUEST_TYPEPOS + 1));
+    netPacketsPerSecond++;
   } else if (len == (int) sizeof(TIME_PACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_TIMERESPONSE) { 
     /* Here is the time data */
     TIME_PACKET tp;
@@ -1352,11 +1375,83 @@ void netDataPacket(BYTE *buff, int len) {
   netPacketsPerSecond++;
 }
 
+/*********************************************************
+*NAME:          netJoinChunkArrive
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* A chunk of the join blob has arrived. Once every chunk
+* is here the blob is unpacked and we move on to the time
+* download. If the server could not make the blob or it
+* is damaged we fall back to downloading piece by piece
+* and ignore any chunks that arrive after.
+*
+*ARGUMENTS:
+*  buff  - Chunk header and data
+*  len   - Length of buff
+*********************************************************/
+void netJoinChunkArrive(BYTE *buff, int len) {
+  BYTE blobId;            /* Blob this chunk is from */
+  BYTE chunk;             /* Chunk number */
+  BYTE numChunks;         /* Chunks in the blob */
+  unsigned short dataLen; /* Length of the chunk data */
+
+  if (netYPos >= 241) {
+    /* Already have the map */
+    return;
+  } else if (netJoinWhole == FALSE) {
+    /* Gave up on the blob, late chunks of it are ignored */
+    return;
+  }
+  blobId = buff[0];
+  chunk = buff[1];
+  numChunks = buff[2];
+  memcpy(&dataLen, buff+3, sizeof(dataLen));
+  if (numChunks == 0) {
+    /* Server couldn't make it. Ask for each piece */
+    netJoinWhole = FALSE;
+    netJoinDataRequests();
+    return;
+  }
+  if (numChunks > NET_JOIN_MAX_CHUNKS || chunk >= numChunks || dataLen > NET_JOIN_CHUNK_SIZE || dataLen > len - NET_JOIN_CHUNK_HEADER) {
+    return;
+  }
+
+  if (blobId != netJoinBlobId || numChunks != netJoinNumChunks) {
+    /* Chunks from a new blob */
+    memset(netJoinGot, FALSE, sizeof(netJoinGot));
+    netJoinBlobId = blobId;
+    netJoinNumChunks = numChunks;
+    netJoinGotChunks = 0;
+    netJoinBlobLen = 0;
+  }
+  if (netJoinGot[chunk] == FALSE) {
+    memcpy(netJoinBlob + chunk * NET_JOIN_CHUNK_SIZE, buff + NET_JOIN_CHUNK_HEADER, dataLen);
+    netJoinGot[chunk] = TRUE;
+    netJoinGotChunks++;
+    if (chunk == numChunks - 1) {
+      netJoinBlobLen = chunk * NET_JOIN_CHUNK_SIZE + dataLen;
+    }
+  }
+
+  if (netJoinGotChunks == netJoinNumChunks) {
+    netJoinNumChunks = 0;
+    if (screenSetJoinData(netJoinBlob, netJoinBlobLen) == TRUE) {
+      netYPos = 241;
+      netStat = netTimeDownload;
+    } else {
+      netJoinWhole = FALSE;
+    }
+    netJoinDataRequests();
+  }
+}
+
 /*********************************************************
 *NAME:          netJoinDataRequests
 *AUTHOR:        John Morrison
 *CREATION DATE: 28/2/99
-*LAST MODIFIED: 29/3/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * If we need to do any downloading request do them here
 *
@@ -1380,6 +1475,9 @@ void netJoinDataRequests(void) {
   switch (joinReq) {
   case netStartDownload:
     data[BOLOPACKET_REQUEST_TYPEPOS] = BOLOPACKET_STARTSDATAREQUEST;
+    if (netJoinWhole == TRUE) {
+      data[BOLOPACKET_REQUEST_TYPEPOS] = BOLOPACKET_JOINDATAREQUEST;
+    }
     netSend(data, BOLOPACKET_REQUEST_SIZE);
     netPacketsPerSecond++;
     break;
@@ -1528,7 +1626,7 @@ void netSecond(void) {
 *NAME:          netDataPosPacket
 *AUTHOR:        John Morrison
 *CREATION DATE: 20/3/99
-*LAST MODIFIED: 12/1/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A data position packet has arrived. Look after it here.
 *
@@ -1543,6 +1641,7 @@ void netDataPosPacket(BYTE *buff, int len, unsigned short port) {
   BYTE sectionLen; /* Length of the section */
   int pos;        /* Position we are through the data */
   BYTE crcA, crcB; /* CRC Bytes */
+  posDeltaFrame frame; /* Positions we can see */
   
   ptr = buff;
   pos = 0;
@@ -1572,6 +1671,11 @@ void netDataPosPacket(BYTE *buff, int len, unsigned short port) {
         case BOLOPACKET_MAND_DATA:
           screenExtractPlayerData(ptr, sectionLen);
           break;
+        case BOLO_PACKET_POSDELTA:
+          if (posDeltaDecode(&netPosHistory, ptr, sectionLen, &frame) == TRUE) {
+            screenExtractPlayerFrame(&frame);
+          }
+          break;
         case BOLO_PACKET_PNBDATA:
           screenExtractPNBData(ptr, sectionLen, FALSE);
           break;
@@ -1603,7 +1707,7 @@ time_t windowsGetTicks();
 *NAME:          netMakeDataPosPacket
 *AUTHOR:        John Morrison
 *CREATION DATE: 20/3/99
-*LAST MODIFIED: 30/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Makes and sends our player location and shells stuff
 * and sends it to all players
@@ -1616,6 +1720,7 @@ void netMakeDataPosPacket(void) {
   static BYTE countHalfAmount = 6;
   static BYTE changed = 0;
   static BYTE last[BOLOPACKET_MAND_DATA];
+  static BYTE lastAck = POS_DELTA_NONE; /* Last position frame acknowledged */
   BYTE info[MAX_UDPPACKET_SIZE] = POSHEADER; /* Packet that is sent */
   BYTE *ptr;                              /* Pointer to buffer for memcopies */
   BYTE crcA, crcB;                        /* CRC Bytes */
@@ -1662,10 +1767,15 @@ This doesn't matter
     posLen = screenMakePosInfo(ptr);
     clientMutexRelease();
     /* Make the CRC */
-    if (memcmp(ptr, last, posLen) != 0 || changed > 2) {
+    if (memcmp(ptr, last, posLen) != 0 || changed > 2 || posDeltaGetLast(&netPosHistory) != lastAck) {
       memcpy(last, ptr, posLen);
       ptr += posLen;
       changed = 0;
+      /* Acknowledge the last position frame we got */
+      lastAck = posDeltaGetLast(&netPosHistory);
+      *ptr = lastAck;
+      ptr++;
+      posLen++;
       /*NEW CODE */
           t = windowsGetTicks();
           memcpy(ptr, &t, sizeof(time_t));
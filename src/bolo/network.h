@@ -379,6 +379,24 @@ void netUdpPacketArrive(BYTE *buff, int len, unsigned short port);
 *********************************************************/
 void netTcpPacketArrive(BYTE *buff, int len);
 
+/*********************************************************
+*NAME:          netJoinChunkArrive
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* A chunk of the join blob has arrived. Once every chunk
+* is here the blob is unpacked and we move on to the time
+* download. If the server could not make the blob or it
+* is damaged we fall back to downloading piece by piece
+* and ignore any chunks that arrive after.
+*
+*ARGUMENTS:
+*  buff  - Chunk header and data
+*  len   - Length of buff
+*********************************************************/
+void netJoinChunkArrive(BYTE *buff, int len);
+
 /*********************************************************
 *NAME:          netMakeInfoRespsonse
 *AUTHOR:        John Morrison
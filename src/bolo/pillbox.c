@@ -103,6 +103,7 @@ void pillsDestroy(pillboxes *value) {
 void pillsSetNumPills(pillboxes *value, BYTE numPills) {
   if (numPills > 0 && numPills <= MAX_PILLS) {
     (*value)->numPills = numPills;
+    pillsPosIndexRebuild(value);
   }
 }
 
@@ -138,10 +139,19 @@ BYTE pillsGetNumPills(pillboxes *value) {
 *  pillNum - The pillbox number
 *********************************************************/
 void pillsSetPill(pillboxes *value, pillbox *item, BYTE pillNum) {
+  BYTE oldX; /* Previous position of the pill */
+  BYTE oldY;
+
   if (pillNum > 0 && pillNum  <= (*value)->numPills) {
     pillNum--;
+    oldX = (*value)->item[pillNum].x;
+    oldY = (*value)->item[pillNum].y;
     (((*value)->item[pillNum]).x) = item->x;
     (((*value)->item[pillNum]).y) = item->y;
+    if (oldX != item->x || oldY != item->y) {
+      pillsPosIndexUpdate(value, oldX, oldY);
+      pillsPosIndexUpdate(value, item->x, item->y);
+    }
     if (item->owner > (MAX_TANKS-1) && item->owner != NEUTRAL) {
       item->owner = NEUTRAL;
     }
@@ -204,10 +214,11 @@ void pillsGetPill(pillboxes *value, pillbox *item, BYTE pillNum) {
 bool pillsExistPos(pillboxes *value, BYTE xValue, BYTE yValue) {
   bool returnValue; /* Value to return */
   BYTE count;       /* Looping Variable */
+  BYTE last;        /* One past the last pill to check */
 
   returnValue = FALSE;
-  count = 0;
-  while (returnValue == FALSE && count < ((*value)->numPills)) {
+  pillsPosIndexRange(value, xValue, yValue, &count, &last);
+  while (returnValue == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue && ((*value)->item[count].inTank) == FALSE) {
       returnValue = TRUE;
     }
@@ -387,10 +398,11 @@ void pillsUpdate(pillboxes *value, map *mp, bases *bs, tank *tnk, shells *shs) {
 bool pillsIsPillHit(pillboxes *value, BYTE xValue, BYTE yValue) {
   bool returnValue; /* Value to return */
   BYTE count;       /* Looping Variable */
+  BYTE last;        /* One past the last pill to check */
 
   returnValue = FALSE;
-  count = 0;
-  while (returnValue == FALSE && count < ((*value)->numPills)) {
+  pillsPosIndexRange(value, xValue, yValue, &count, &last);
+  while (returnValue == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue && ((*value)->item[count].armour >0) && (*value)->item[count].inTank == FALSE) {
       /* Pillbox has been Hit */
       returnValue = TRUE;
@@ -421,11 +433,12 @@ bool pillsDamagePos(pillboxes *value, BYTE xValue, BYTE yValue, bool wantDamage,
   bool returnValue;  /* Value to return */
   bool done;         /* Loop guard */
   BYTE count;        /* Looping Variable */
+  BYTE last;         /* One past the last pill to check */
 
   returnValue = FALSE;
   done = FALSE;
-  count = 0;
-  while (done == FALSE && count < ((*value)->numPills)) {
+  pillsPosIndexRange(value, xValue, yValue, &count, &last);
+  while (done == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue && ((*value)->item[count].armour >0) && (*value)->item[count].inTank == FALSE) {
       /* Pillbox has been Hit */
       done = TRUE;
@@ -471,12 +484,13 @@ BYTE pillsGetScreenHealth(pillboxes *value, BYTE xValue, BYTE yValue) {
   bool done;        /* Finished searching */
   BYTE returnValue; /* Value to return */
   BYTE count;       /* Looping Variable */
+  BYTE last;        /* One past the last pill to check */
 
   done = FALSE;
-  count = 0;
+  pillsPosIndexRange(value, xValue, yValue, &count, &last);
   returnValue = PILL_EVIL_15;
 
-  while (done == FALSE && count < ((*value)->numPills)) {
+  while (done == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue && (*value)->item[count].inTank == FALSE) {
       /* Pillbox has been Hit */
       done = TRUE;
@@ -748,10 +762,11 @@ TURNTYPE pillsTargetTankMove(map *mp, pillboxes *pb, bases *bs, WORLD xValue, WO
 bool pillsDeadPos(pillboxes *value, BYTE xValue, BYTE yValue) {
   bool returnValue; /* Value to return */
   BYTE count;       /* Looping Variable */
+  BYTE last;        /* One past the last pill to check */
 
   returnValue = FALSE;
-  count = 0;
-  while (returnValue == FALSE && count < ((*value)->numPills)) {
+  pillsPosIndexRange(value, xValue, yValue, &count, &last);
+  while (returnValue == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue && ((*value)->item[count].armour == 0)) {
       returnValue = TRUE;
     }
@@ -779,10 +794,11 @@ bool pillsDeadPos(pillboxes *value, BYTE xValue, BYTE yValue) {
 BYTE pillsGetPillNum(pillboxes *value, BYTE xValue, BYTE yValue, bool careInTank, bool inTank) {
   BYTE returnValue; /* Value to return */
   BYTE count;       /* Looping Variable */
+  BYTE last;        /* One past the last pill to check */
 
   returnValue = PILL_NOT_FOUND-1;
-  count = 0;
-  while (count < ((*value)->numPills)) {
+  pillsPosIndexRange(value, xValue, yValue, &count, &last);
+  while (count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue) {
       if (careInTank == FALSE || ((*value)->item[count].inTank == inTank)) {
         returnValue = (BYTE) (count+1);
@@ -924,9 +940,10 @@ BYTE pillsSetPillOwner(pillboxes *value, BYTE pillNum, BYTE owner, bool migrate)
 *********************************************************/
 void pillsGetDamagePos(pillboxes *value, BYTE xValue, BYTE yValue, BYTE amount) {
   BYTE count;       /* Looping Variable */
+  BYTE last;        /* One past the last pill to check */
 
-  count = 0;
-  while (count < ((*value)->numPills)) {
+  pillsPosIndexRange(value, xValue, yValue, &count, &last);
+  while (count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue) {
       (*value)->item[count].armour -= amount;
       if ((*value)->item[count].armour > PILL_MAX_HEALTH) {
@@ -994,9 +1011,10 @@ BYTE pillsNumInRect(pillboxes *value, BYTE leftPos, BYTE rightPos, BYTE top, BYT
 *********************************************************/
 void pillsRepairPos(pillboxes *value, BYTE xValue, BYTE yValue) {
   BYTE count; /* Looping variable */
+  BYTE last;  /* One past the last pill to check */
   
-  count = 0;
-  while (count < ((*value)->numPills)) {
+  pillsPosIndexRange(value, xValue, yValue, &count, &last);
+  while (count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue && ((*value)->item[count].inTank) == FALSE) {
       (*value)->item[count].armour = PILLS_MAX_ARMOUR;
       if (threadsGetContext() == FALSE) {
@@ -1028,10 +1046,11 @@ void pillsRepairPos(pillboxes *value, BYTE xValue, BYTE yValue) {
 BYTE pillsGetArmourPos(pillboxes *value, BYTE mx, BYTE my) {
   BYTE returnValue; /* Value to return */
   BYTE count;       /* Looping variable */
+  BYTE last;        /* One past the last pill to check */
   
   returnValue = PILL_NOT_FOUND;
-  count = 0;
-  while (count < ((*value)->numPills)) {
+  pillsPosIndexRange(value, mx, my, &count, &last);
+  while (count < last) {
     if (((*value)->item[count].x) == mx && ((*value)->item[count].y) == my && ((*value)->item[count].inTank) == FALSE) {
       returnValue = (*value)->item[count].armour;
       count = (*value)->numPills;
@@ -1273,6 +1292,7 @@ BYTE pillsGetNumNeutral(pillboxes *value) {
 
 void pillsSetPillCompressData(pillboxes *value, BYTE *buff, int dataLen) {
   memcpy(&(**value), buff, SIZEOF_PILLS);
+  pillsPosIndexRebuild(value);
 }
 
 /*********************************************************
@@ -1314,6 +1334,7 @@ void pillsSetPillNetData(pillboxes *value, BYTE *buff, BYTE dataLen) {
     len++;
     count++;
   }
+  pillsPosIndexRebuild(value);
 
 /* was in old code to reset this on join? 
  while (count < MAX_TANKS) {
@@ -1451,10 +1472,11 @@ void pillsMigrate(pillboxes *value, BYTE oldOwner, BYTE newOwner) {
 bool pillsIsCapturable(pillboxes *value, BYTE xValue, BYTE yValue) {
   bool returnValue; /* Value to return */
   BYTE count;       /* Looping Variable */
+  BYTE last;        /* One past the last pill to check */
 
   returnValue = FALSE;
-  count = 0;
-  while (returnValue == FALSE && count < ((*value)->numPills)) {
+  pillsPosIndexRange(value, xValue, yValue, &count, &last);
+  while (returnValue == FALSE && count < last) {
     if (((*value)->item[count].x) == xValue && ((*value)->item[count].y) == yValue && ((*value)->item[count].armour == 0)  && ((*value)->item[count].inTank == FALSE)) {
       returnValue = TRUE;
       count = (*value)->numPills;
@@ -1650,6 +1672,7 @@ void pillsMoveAll(pillboxes *value, int moveX, int moveY) {
     (*value)->item[count].y = (BYTE) ((*value)->item[count].y + moveY);
     count++;
   }
+  pillsPosIndexRebuild(value);
 }
 
 /*********************************************************
@@ -1772,3 +1795,97 @@ BYTE pillsGetNumberOwnedByPlayer(pillboxes *value, BYTE playerNum) {
 
   return returnValue;
 }
+
+/*********************************************************
+*NAME:          pillsPosIndexRebuild
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Rebuilds the whole map square to pill number index.
+* Must be called whenever the pills are changed in bulk.
+*
+*ARGUMENTS:
+*  value - Pointer to the pills structure
+*********************************************************/
+void pillsPosIndexRebuild(pillboxes *value) {
+  BYTE count; /* Looping variable */
+  BYTE *pos;  /* Index entry for the current pill */
+
+  memset((*value)->pos, POS_INDEX_NONE, sizeof((*value)->pos));
+  for (count=0;count<(*value)->numPills;count++) {
+    pos = &((*value)->pos[(*value)->item[count].x][(*value)->item[count].y]);
+    if (*pos == POS_INDEX_NONE) {
+      *pos = (BYTE) (count+1);
+    } else {
+      *pos = POS_INDEX_STACKED;
+    }
+  }
+}
+
+/*********************************************************
+*NAME:          pillsPosIndexUpdate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Recalculates the index entry for a single map square
+* after a pill has moved on to or off it.
+*
+*ARGUMENTS:
+*  value  - Pointer to the pills structure
+*  xValue - X Map position
+*  yValue - Y Map position
+*********************************************************/
+void pillsPosIndexUpdate(pillboxes *value, BYTE xValue, BYTE yValue) {
+  BYTE count;       /* Looping variable */
+  BYTE returnValue; /* New index entry */
+
+  returnValue = POS_INDEX_NONE;
+  for (count=0;count<(*value)->numPills;count++) {
+    if ((*value)->item[count].x == xValue && (*value)->item[count].y == yValue) {
+      if (returnValue == POS_INDEX_NONE) {
+        returnValue = (BYTE) (count+1);
+      } else {
+        returnValue = POS_INDEX_STACKED;
+      }
+    }
+  }
+  (*value)->pos[xValue][yValue] = returnValue;
+}
+
+/*********************************************************
+*NAME:          pillsPosIndexRange
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the range of pill array positions that need to be
+* checked for a pill at a map square. Empty if there are
+* none, a single item if one pill is there or every pill
+* if several are stacked on the square. Pills carried in
+* a tank keep their last square, so callers must still
+* check the in tank state if they care about it.
+*
+*ARGUMENTS:
+*  value  - Pointer to the pills structure
+*  xValue - X Map position
+*  yValue - Y Map position
+*  first  - Pointer to hold the first array position
+*  last   - Pointer to hold one past the last position
+*********************************************************/
+void pillsPosIndexRange(pillboxes *value, BYTE xValue, BYTE yValue, BYTE *first, BYTE *last) {
+  BYTE pos; /* Index entry for this square */
+
+  pos = (*value)->pos[xValue][yValue];
+  if (pos == POS_INDEX_NONE) {
+    *first = 0;
+    *last = 0;
+  } else if (pos == POS_INDEX_STACKED) {
+    *first = 0;
+    *last = (*value)->numPills;
+  } else {
+    *first = (BYTE) (pos-1);
+    *last = pos;
+  }
+}
@@ -754,4 +754,56 @@ BYTE pillsGetNumberOwnedByPlayer(pillboxes *value, BYTE playerNum);
 
 void pillsSetPillCompressData(pillboxes *value, BYTE *buff, int dataLen);
 
+/*********************************************************
+*NAME:          pillsPosIndexRebuild
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Rebuilds the whole map square to pill number index.
+* Must be called whenever the pills are changed in bulk.
+*
+*ARGUMENTS:
+*  value - Pointer to the pills structure
+*********************************************************/
+void pillsPosIndexRebuild(pillboxes *value);
+
+/*********************************************************
+*NAME:          pillsPosIndexUpdate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Recalculates the index entry for a single map square
+* after a pill has moved on to or off it.
+*
+*ARGUMENTS:
+*  value  - Pointer to the pills structure
+*  xValue - X Map position
+*  yValue - Y Map position
+*********************************************************/
+void pillsPosIndexUpdate(pillboxes *value, BYTE xValue, BYTE yValue);
+
+/*********************************************************
+*NAME:          pillsPosIndexRange
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the range of pill array positions that need to be
+* checked for a pill at a map square. Empty if there are
+* none, a single item if one pill is there or every pill
+* if several are stacked on the square. Pills carried in
+* a tank keep their last square, so callers must still
+* check the in tank state if they care about it.
+*
+*ARGUMENTS:
+*  value  - Pointer to the pills structure
+*  xValue - X Map position
+*  yValue - Y Map position
+*  first  - Pointer to hold the first array position
+*  last   - Pointer to hold one past the last position
+*********************************************************/
+void pillsPosIndexRange(pillboxes *value, BYTE xValue, BYTE yValue, BYTE *first, BYTE *last);
+
 #endif /* PILLBOX_H */
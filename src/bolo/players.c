@@ -20,7 +20,7 @@
 *Filename:      players.c
 *Author:        John Morrison
 *Creation Date: 09/02/02
-*Last Modified: 09/08/04
+*Last Modified: 16/10/26
 *Purpose:
 *  Looks after players. Alliences between etc.
 *********************************************************/
@@ -49,7 +49,7 @@ char myLastPlayerName[PLAYER_NAME_LEN];
 *NAME:          playersCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/2/99
-*LAST MODIFIED: 26/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets up the players structure.
 *
@@ -67,6 +67,7 @@ void playersCreate(players *plrs) {
     
   
   (*plrs)->myPlayerNum = NEUTRAL; /* Not set yet */
+  (*plrs)->grid = tankGridCreate();
   for (count = 0;count<MAX_TANKS;count++) {
     (*plrs)->item[count].inUse = FALSE;
     (*plrs)->item[count].needUpdate = FALSE;
@@ -80,7 +81,7 @@ void playersCreate(players *plrs) {
 *NAME:          playersDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/2/99
-*LAST MODIFIED: 18/2/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Destroys the playesr structure
 *
@@ -95,6 +96,7 @@ void playersDestroy(players *plrs) {
       (*plrs)->item[count].inUse = FALSE;
       allienceDestroy(&((*plrs)->item[count].allie));
     }
+    tankGridDestroy(&((*plrs)->grid));
     if (*plrs != NULL) {
       Dispose(*plrs);
     }
@@ -121,7 +123,7 @@ BYTE playersGetSelf(players *plrs) {
 *NAME:          playersSetSelf
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/2/99
-*LAST MODIFIED: 26/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets your own player number and player name. Returns 
 * whether the operation succeeded.
@@ -144,6 +146,7 @@ bool playersSetSelf(players *plrs, BYTE playerNum, char *playerName) {
       strcpy((*plrs)->item[playerNum].playerName, playerName);    
       (*plrs)->item[playerNum].inUse = TRUE;
       (*plrs)->myPlayerNum = playerNum;
+      playersGridUpdate(plrs, playerNum);
       lgmSetPlayerNum(screenGetLgmFromPlayerNum(playerNum), playerNum);
       utilCtoPString(playerName, (char *) (*plrs)->playerBrainNames[playerNum]);
       if (threadsGetContext() == FALSE) {
@@ -254,7 +257,7 @@ void playersSetPlayersMenu(players *plrs) {
 *NAME:          playersSetPlayer
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/2/99
-*LAST MODIFIED: 26/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets a player up.
 *
@@ -293,6 +296,7 @@ void playersSetPlayer(players *plrs, BYTE playerNum, char *playerName, char *loc
       allienceAdd(&((*plrs)->item[playerNum].allie), allies[count]);
       count++;
     }
+    playersGridUpdate(plrs, playerNum);
   }
 
   /* Update front end if we are in a running game (ie not in the joining phase) */
@@ -359,7 +363,7 @@ void playerSetLocation(players *plrs, char *ip, char *host) {
 *NAME:          playersUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/2/99
-*LAST MODIFIED: 28/2/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Updates a player with specific location data.
 *
@@ -391,6 +395,7 @@ void playersUpdate(players *plrs, BYTE playerNum, BYTE mx, BYTE my, BYTE px, BYT
     (*plrs)->item[playerNum].lgmPixelX = lgmPX;
     (*plrs)->item[playerNum].lgmPixelY = lgmPY;
     (*plrs)->item[playerNum].lgmFrame = lgmFrame;
+    playersGridUpdate(plrs, playerNum);
   }
 }
 
@@ -933,7 +938,7 @@ bool playersIsTankCloser(players *plrs, WORLD x, WORLD y, BYTE pillOwner, double
 *NAME:          playersIsTankHit
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/2/99
-*LAST MODIFIED: 31/7/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the player number if a player was hit otherwise
 * returns NEUTRAL (255)
@@ -953,13 +958,15 @@ BYTE playersIsTankHit(players *plrs, WORLD x, WORLD y, TURNTYPE angle, BYTE owne
   WORLD conv;         /* Used in conversions */
   TURNTYPE tankAngle; /* Angle tank is traveling */
   BYTE count;         /* Looping variable */
+  tankGridMask nearby; /* Players close enough to be hit */
 
   returnValue = NEUTRAL;
   count = 0;
+  nearby = tankGridGetNear(&((*plrs)->grid), x, y, MAP_SQUARE_MIDDLE);
 
-  while (count < MAX_TANKS && returnValue == NEUTRAL) {
-    /* Check to see player slot is being used */
-    if ((*plrs)->item[count].inUse == TRUE && count != (*plrs)->myPlayerNum && count != owner) {
+  while (count < MAX_TANKS && returnValue == NEUTRAL && nearby != 0) {
+    /* Check to see player slot is being used and is near the shell */
+    if ((nearby & (1 << count)) && (*plrs)->item[count].inUse == TRUE && count != (*plrs)->myPlayerNum && count != owner) {
       /* Check for a collision */
        tankX = (*plrs)->item[count].mapX;
        tankX <<= TANK_SHIFT_MAPSIZE;
@@ -1040,7 +1047,7 @@ BYTE playersGetFirstNotUsed(players *plrs) {
 *NAME:          playersLeaveGame
 *AUTHOR:        John Morrison
 *CREATION DATE: 20/3/99
-*LAST MODIFIED: 2/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A player has left the game.
 *
@@ -1071,6 +1078,7 @@ void playersLeaveGame(players *plrs, BYTE playerNum) {
     (*plrs)->item[playerNum].inUse = FALSE;
     (*plrs)->item[playerNum].needUpdate = FALSE;
     (*plrs)->item[playerNum].isChecked = FALSE;
+    playersGridUpdate(plrs, playerNum);
     (*plrs)->playerBrainNames[playerNum][0] = '\0';
     if (threadsGetContext() == FALSE) {
       frontEndClearPlayer((playerNumbers) playerNum);
@@ -1467,7 +1475,7 @@ void playersGetLgmDetails(players *plrs, BYTE playerNumber, BYTE *mx, BYTE *my ,
 *NAME:          playersCheckCollision
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED:  4/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks for a collision between our tank (given as 
 * variables & the tanks in the players structure)
@@ -1488,14 +1496,16 @@ bool playersCheckCollision(players *plrs, BYTE playerNum, WORLD xValue, WORLD yV
   WORLD my;
   WORLD testX;
   WORLD testY;
+  tankGridMask nearby; /* Players close enough to collide with */
 
   count = 0;
   *leftPos = 0;
   *downPos = 0;
   returnValue = FALSE;
+  nearby = tankGridGetNear(&((*plrs)->grid), xValue, yValue, MAP_SQUARE_MIDDLE * 2);
 
-  while (returnValue == FALSE && count < MAX_TANKS) {
-    if ((*plrs)->item[count].inUse == TRUE && count != playerNum) {
+  while (returnValue == FALSE && count < MAX_TANKS && nearby != 0) {
+    if ((nearby & (1 << count)) && (*plrs)->item[count].inUse == TRUE && count != playerNum) {
       /* Test for collision */
       conv = (*plrs)->item[count].mapX;
       conv <<= TANK_SHIFT_MAPSIZE;
@@ -2056,8 +2066,8 @@ bool playersPrepareLogSnapshotForPlayer(players *value, BYTE playerNum, BYTE *bu
   buff[0] = playerNum;
   buff[1] = returnValue;
   *len = 2;
-  tnk = serverCoreGetTankFromPlayer(playerNum);
-  lgm = serverCoreGetLgmFromPlayerNum(playerNum);
+  tnk = serverCoreGetTankFromPlayer(serverCoreGetContext(), playerNum);
+  lgm = serverCoreGetLgmFromPlayerNum(serverCoreGetContext(), playerNum);
   if (returnValue == TRUE && tnk != NULL && lgm != NULL) {
     /* Set MX/MY/PX/PY/frame/onBoat/lgmMX/lgmMY/lgmPX/lgmPX/frame/Name/Location */
     buff[2] = tankGetMX(tnk);
@@ -2084,6 +2094,7 @@ void playersCheckUpdate(players *plrs, BYTE playerNum) {
     (*plrs)->item[playerNum].mapX = 0;
     (*plrs)->item[playerNum].mapY = 0;
     (*plrs)->item[playerNum].needUpdate = TRUE;
+    playersGridUpdate(plrs, playerNum);
   }
 }
 
@@ -2106,3 +2117,39 @@ void playerNeedUpdateDone(players *plrs) {
   }
 }
 
+/*********************************************************
+*NAME:          playersGridUpdate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Moves a player to its current position in the grid
+* used by the collision checks, or takes it out if the
+* player slot is not in use. Must be called whenever a
+* player's position or in use state changes.
+*
+*ARGUMENTS:
+* plrs      - Pointer to the players object 
+* playerNum - The player number to update
+*********************************************************/
+void playersGridUpdate(players *plrs, BYTE playerNum) {
+  WORLD wx;   /* Player world position */
+  WORLD wy;
+  WORLD conv; /* Used for conversions */
+
+  if ((*plrs)->item[playerNum].inUse == TRUE) {
+    wx = (*plrs)->item[playerNum].mapX;
+    wx <<= TANK_SHIFT_MAPSIZE;
+    conv = (*plrs)->item[playerNum].pixelX;
+    conv <<= TANK_SHIFT_RIGHT2;
+    wx += conv;
+    wy = (*plrs)->item[playerNum].mapY;
+    wy <<= TANK_SHIFT_MAPSIZE;
+    conv = (*plrs)->item[playerNum].pixelY;
+    conv <<= TANK_SHIFT_RIGHT2;
+    wy += conv;
+    tankGridSet(&((*plrs)->grid), playerNum, wx, wy);
+  } else {
+    tankGridRemove(&((*plrs)->grid), playerNum);
+  }
+}
@@ -20,7 +20,7 @@
 *Filename:      players.h
 *Author:        John Morrison
 *Creation Date: 18/02/99
-*Last Modified: 25/07/04
+*Last Modified: 16/10/26
 *Purpose:
 *  Looks after players. Alliences between etc.
 *********************************************************/
@@ -32,6 +32,7 @@
 #include "allience.h"
 #include "screentank.h"
 #include "screenlgm.h"
+#include "tankgrid.h"
 
 /* Defines */
 
@@ -85,6 +86,7 @@ struct playersObj {
   player item[MAX_TANKS];
   char playerBrainNames[MAX_TANKS][PLAYER_NAME_LEN];   /* Brain information */
   BYTE myPlayerNum; /* Your own player number */
+  tankGrid grid;    /* Players in use bucketed by position */
 };
 
 /* Prototypes */
@@ -452,7 +454,7 @@ bool playersIsTankCloser(players *plrs, WORLD x, WORLD y, BYTE pillOwner, double
 *NAME:          playersIsTankHit
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/2/99
-*LAST MODIFIED: 31/7/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the player number if a player was hit otherwise
 * returns NEUTRAL (255)
@@ -706,7 +708,7 @@ void playersGetLgmDetails(players *plrs, BYTE playerNumber, BYTE *mx, BYTE *my ,
 *NAME:          playersCheckCollision
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED:  4/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks for a collision between our tank (given as 
 * variables & the tanks in the players structure)
@@ -898,4 +900,21 @@ bool playersNeedUpdate(players *plrs, BYTE playerNum);
 
 void playerNeedUpdateDone(players *plrs);
 
+/*********************************************************
+*NAME:          playersGridUpdate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Moves a player to its current position in the grid
+* used by the collision checks, or takes it out if the
+* player slot is not in use. Must be called whenever a
+* player's position or in use state changes.
+*
+*ARGUMENTS:
+* plrs      - Pointer to the players object 
+* playerNum - The player number to update
+*********************************************************/
+void playersGridUpdate(players *plrs, BYTE playerNum);
+
 #endif /* PLAYERS_H */
@@ -20,7 +20,7 @@
 *Filename:      playersrejoin.c
 *Author:        John Morrison
 *Creation Date: 22/6/00
-*Last Modified: 22/6/00
+*Last Modified: 16/10/26
 *Purpose:
 *  Looks after players rejoin and ownerships.
 *********************************************************/
@@ -34,25 +34,23 @@
 #include "backend.h"
 #include "log.h"
 
-playersRejoin rejoin;
-
 /*********************************************************
 *NAME:          playersRejoinCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets up the players rejoin structure.
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the rejoin structure
 *********************************************************/
-void playersRejoinCreate() {
+void playersRejoinCreate(playersRejoin *value) {
   BYTE count; /* Looping variable */
  
   count = 0;
   while (count < MAX_TANKS) {
-    rejoin.item[count].inUse = FALSE;
+    value->item[count].inUse = FALSE;
     count++;
   }
 }
@@ -61,19 +59,19 @@ void playersRejoinCreate() {
 *NAME:          playersRejoinDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Destroys the players rejoin structure
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the rejoin structure
 *********************************************************/
-void playersRejoinDestroy() {
+void playersRejoinDestroy(playersRejoin *value) {
   BYTE count; /* Looping variable */
  
   count = 0;
   while (count < MAX_TANKS) {
-    rejoin.item[count].inUse = FALSE;
+    value->item[count].inUse = FALSE;
     count++;
   }
 }
@@ -82,22 +80,22 @@ void playersRejoinDestroy() {
 *NAME:          playersRejoinUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Updates the players rejoin structure. Timeouts etc.
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the rejoin structure
 *********************************************************/
-void playersRejoinUpdate() {
+void playersRejoinUpdate(playersRejoin *value) {
   BYTE count; /* Looping variable */
  
   count = 0;
   while (count < MAX_TANKS) {
-    if (rejoin.item[count].inUse == TRUE) {
-      rejoin.item[count].timeOut++;
-      if (rejoin.item[count].timeOut == MAX_REJOIN_TIME) {
-        rejoin.item[count].inUse = FALSE;
+    if (value->item[count].inUse == TRUE) {
+      value->item[count].timeOut++;
+      if (value->item[count].timeOut == MAX_REJOIN_TIME) {
+        value->item[count].inUse = FALSE;
       }
     }
     count++;
@@ -108,14 +106,14 @@ void playersRejoinUpdate() {
 *NAME:          playersAddPlayer
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Adds a player to the rejoin structure
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the rejoin structure
 *********************************************************/
-void playersRejoinAddPlayer(char *playerName, PlayerBitMap pills, PlayerBitMap bases) {
+void playersRejoinAddPlayer(playersRejoin *value, char *playerName, PlayerBitMap pills, PlayerBitMap bases) {
   BYTE count;    /* Looping variable */
   BYTE best;     /* Best position to add */
   int timeBest;  /* Best time to beat - If we can't find a free spot */
@@ -126,41 +124,42 @@ void playersRejoinAddPlayer(char *playerName, PlayerBitMap pills, PlayerBitMap b
   best = 0;
   timeBest = MAX_REJOIN_TIME;
   while (count < MAX_TANKS && done == FALSE) {
-    if (rejoin.item[count].inUse == FALSE) {
+    if (value->item[count].inUse == FALSE) {
       done = TRUE;
       best = count;
-    } else if (rejoin.item[count].timeOut < timeBest) {
+    } else if (value->item[count].timeOut < timeBest) {
       best = count;
-      timeBest = rejoin.item[count].timeOut;
+      timeBest = value->item[count].timeOut;
     }
     count++;
   }
 
   /* Add it to best slot */
-  rejoin.item[best].inUse  = TRUE;
-  strcpy(rejoin.item[best].playerName, playerName);
-  rejoin.item[best].pills = pills;
-  rejoin.item[best].bases = bases;
-  rejoin.item[best].timeOut = 0;
+  value->item[best].inUse  = TRUE;
+  strcpy(value->item[best].playerName, playerName);
+  value->item[best].pills = pills;
+  value->item[best].bases = bases;
+  value->item[best].timeOut = 0;
 }
 
 /*********************************************************
 *NAME:          playersRejoinRequest
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A player wish to rejoin. See if they exists and assign
 * items to his ownership if they aren't owned by someone
 * else.
 *
 *ARGUMENTS:
+*  value - Pointer to the rejoin structure
 *  playerName - The player name requesting the rejoin
 *  playerNum  - The rejoining players player number
 *  pb         - Pointer to the pillboxes structure
 *  bs         - Pointer to the bases structure
 *********************************************************/
-void playersRejoinRequest(char *playerName, BYTE playerNum, pillboxes *pb, bases *bs) {
+void playersRejoinRequest(playersRejoin *value, char *playerName, BYTE playerNum, pillboxes *pb, bases *bs) {
   BYTE count;    /* Looping variable */
   BYTE num;      /* Number player is at */
   bool found;    /* Found Player */
@@ -170,7 +169,7 @@ void playersRejoinRequest(char *playerName, BYTE playerNum, pillboxes *pb, bases
   count = 0;
   found = FALSE;
   while (count < MAX_TANKS && found == FALSE) {
-    if (strcmp(rejoin.item[count].playerName, playerName) == 0) {
+    if (strcmp(value->item[count].playerName, playerName) == 0) {
       /* Found them */
       found = TRUE;
       num = count;
@@ -184,7 +183,7 @@ void playersRejoinRequest(char *playerName, BYTE playerNum, pillboxes *pb, bases
     logAddEvent(log_PlayerRejoin, playerNum, 0, 0, 0, 0, NULL);
     while (count < MAX_TANKS) {
       /* Pillbox */
-      testItem = (rejoin.item[num].pills >>count);
+      testItem = (value->item[num].pills >>count);
       testItem &= 1;
       if (testItem) {
         if (pillsGetPillOwner(pb, (BYTE) (count+1)) == NEUTRAL) {
@@ -193,7 +192,7 @@ void playersRejoinRequest(char *playerName, BYTE playerNum, pillboxes *pb, bases
         }
       }
       /* Base */
-      testItem = (rejoin.item[num].bases >>count);
+      testItem = (value->item[num].bases >>count);
       testItem &= 1;
       if (testItem) {
         if (basesGetBaseOwner(bs, (BYTE) (count+1)) == NEUTRAL) {
@@ -204,7 +203,7 @@ void playersRejoinRequest(char *playerName, BYTE playerNum, pillboxes *pb, bases
       }
       count++;
     }
-    rejoin.item[num].inUse = FALSE;
+    value->item[num].inUse = FALSE;
   }
 }
 
@@ -20,7 +20,7 @@
 *Filename:      playersrejoin.h
 *Author:        John Morrison
 *Creation Date: 22/6/00
-*Last Modified: 22/6/00
+*Last Modified: 16/10/26
 *Purpose:
 *  Looks after players rejoin and ownerships.
 *********************************************************/
@@ -54,83 +54,71 @@ typedef struct {
 *NAME:          playersRejoinCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets up the players rejoin structure.
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the rejoin structure
 *********************************************************/
-void playersRejoinCreate();
+void playersRejoinCreate(playersRejoin *value);
 
 /*********************************************************
 *NAME:          playersRejoinDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Destroys the players rejoin structure
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the rejoin structure
 *********************************************************/
-void playersRejoinDestroy();
+void playersRejoinDestroy(playersRejoin *value);
 
 /*********************************************************
 *NAME:          playersRejoinUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Updates the players rejoin structure. Timeouts etc.
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the rejoin structure
 *********************************************************/
-void playersRejoinUpdate();
+void playersRejoinUpdate(playersRejoin *value);
 
 /*********************************************************
 *NAME:          playersAddPlayer
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Adds a player to the rejoin structure
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the rejoin structure
 *********************************************************/
-void playersRejoinAddPlayer(char *playerName, PlayerBitMap pills, PlayerBitMap bases);
+void playersRejoinAddPlayer(playersRejoin *value, char *playerName, PlayerBitMap pills, PlayerBitMap bases);
 
 /*********************************************************
 *NAME:          playersRejoinRequest
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A player wish to rejoin. See if they exists and assign
 * items to his ownership if they aren't owned by someone
 * else.
 *
 *ARGUMENTS:
+*  value - Pointer to the rejoin structure
 *  playerName - The player name requesting the rejoin
 *  playerNum  - The rejoining players player number
 *  pb         - Pointer to the pillboxes structure
 *  bs         - Pointer to the bases structure
 *********************************************************/
-void playersRejoinRequest(char *playerName, BYTE playerNum, pillboxes *pb, bases *bs);
-
-/*********************************************************
-*NAME:          serverCoreRequestRejoin
-*AUTHOR:        John Morrison
-*CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
-*PURPOSE:
-* A player number has requested a rejoin
-*
-*ARGUMENTS:
-*  playerNum - Player number requesting join
-********************************************************/
-void serverCoreRequestRejoin(BYTE playerNum);
+void playersRejoinRequest(playersRejoin *value, char *playerName, BYTE playerNum, pillboxes *pb, bases *bs);
 
 #endif /* _PLAYERS_REJOIN_H */
@@ -0,0 +1,561 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Position Delta
+*Filename:      posdelta.c
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Encodes the tank and lgm positions a player can see as
+*  bit packed changes from the last frame that player
+*  acknowledged. Both ends keep a short history of frames
+*  by sequence number so a delta can be undone against
+*  whichever frame it was made from.
+*
+*  A delta is bit packed as:
+*    8 bits - Sequence number
+*    5 bits - How many frames back the base is, 0 if the
+*             delta is from nothing
+*    1 bit  - Set if a 16 bit mask of changed players
+*             follows. Clear if a list follows of 1 bit
+*             set and 4 bit player number per changed
+*             player ending with a clear bit
+*  Then for each changed player:
+*    2 bits - Flags
+*    Tank block then lgm block for each flag set
+*  A block is for X then Y:
+*    1 bit clear if unchanged. Otherwise 1 bit set then
+*    1 bit clear and a 5 bit signed change in pixels, or
+*    1 bit set and the 12 bit position. Then:
+*    1 bit  - Options changed, then 8 bit options
+*********************************************************/
+
+#include <string.h>
+#include "global.h"
+#include "posdelta.h"
+
+/* Bits for the base distance. Bases further back than
+   this can hold are not used */
+#define POS_DELTA_BASE_BITS 5
+#define POS_DELTA_MAX_BASE ((1 << POS_DELTA_BASE_BITS) - 1)
+/* Changed players before a mask is smaller than a list */
+#define POS_DELTA_LIST_MAX 3
+/* Pixel changes that fit in the short form */
+#define POS_DELTA_SMALL_BITS 5
+#define POS_DELTA_SMALL_MIN (-16)
+#define POS_DELTA_SMALL_MAX 15
+/* Map square and pixel as one value */
+#define POS_DELTA_COORD_BITS 12
+
+/* Position through a bit packed buffer */
+typedef struct {
+  BYTE *buff;
+  int bit;
+  int max;
+} posDeltaBits;
+
+/*********************************************************
+*NAME:          posDeltaPut
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes the low numBits of value high bit first
+*
+*ARGUMENTS:
+*  bits    - Buffer position
+*  value   - Value to write
+*  numBits - Number of bits to write
+*********************************************************/
+static void posDeltaPut(posDeltaBits *bits, unsigned int value, int numBits) {
+  BYTE mask; /* Bit in the current byte */
+
+  while (numBits > 0) {
+    numBits--;
+    mask = (BYTE) (0x80 >> (bits->bit & 7));
+    if ((bits->bit & 7) == 0) {
+      bits->buff[bits->bit >> 3] = 0;
+    }
+    if ((value >> numBits) & 1) {
+      bits->buff[bits->bit >> 3] |= mask;
+    }
+    bits->bit++;
+  }
+}
+
+/*********************************************************
+*NAME:          posDeltaTake
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads numBits high bit first. Returns FALSE if that
+*  runs past the end of the buffer
+*
+*ARGUMENTS:
+*  bits    - Buffer position
+*  numBits - Number of bits to read
+*  value   - Value read
+*********************************************************/
+static bool posDeltaTake(posDeltaBits *bits, int numBits, unsigned int *value) {
+  *value = 0;
+  if (bits->bit + numBits > bits->max) {
+    return FALSE;
+  }
+  while (numBits > 0) {
+    numBits--;
+    *value <<= 1;
+    *value |= (bits->buff[bits->bit >> 3] >> (7 - (bits->bit & 7))) & 1;
+    bits->bit++;
+  }
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          posDeltaFind
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the frame held for a sequence number or NULL
+*  if it is not held
+*
+*ARGUMENTS:
+*  pd  - Pointer to the frame history
+*  seq - Sequence number
+*********************************************************/
+static posDeltaFrame *posDeltaFind(posDelta *pd, BYTE seq) {
+  if (seq == POS_DELTA_NONE || (*pd)->seq[seq % POS_DELTA_HISTORY] != seq) {
+    return NULL;
+  }
+  return &(*pd)->frame[seq % POS_DELTA_HISTORY];
+}
+
+/*********************************************************
+*NAME:          posDeltaPutCoord
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes one axis of a position
+*
+*ARGUMENTS:
+*  bits  - Buffer position
+*  base  - Value in the base frame
+*  value - Value to send
+*********************************************************/
+static void posDeltaPutCoord(posDeltaBits *bits, int base, int value) {
+  int change; /* Change from the base */
+
+  change = value - base;
+  if (change == 0) {
+    posDeltaPut(bits, 0, 1);
+  } else if (change >= POS_DELTA_SMALL_MIN && change <= POS_DELTA_SMALL_MAX) {
+    posDeltaPut(bits, 2, 2);
+    posDeltaPut(bits, (unsigned int) change, POS_DELTA_SMALL_BITS);
+  } else {
+    posDeltaPut(bits, 3, 2);
+    posDeltaPut(bits, (unsigned int) value, POS_DELTA_COORD_BITS);
+  }
+}
+
+/*********************************************************
+*NAME:          posDeltaTakeCoord
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads one axis of a position. Returns FALSE if the
+*  buffer is too short
+*
+*ARGUMENTS:
+*  bits  - Buffer position
+*  base  - Value in the base frame
+*  value - Value read
+*********************************************************/
+static bool posDeltaTakeCoord(posDeltaBits *bits, int base, int *value) {
+  unsigned int form; /* Which form follows */
+  unsigned int read; /* Bits read */
+
+  *value = base;
+  if (posDeltaTake(bits, 1, &form) == FALSE) {
+    return FALSE;
+  }
+  if (form == 0) {
+    return TRUE;
+  }
+  if (posDeltaTake(bits, 1, &form) == FALSE) {
+    return FALSE;
+  }
+  if (form == 0) {
+    if (posDeltaTake(bits, POS_DELTA_SMALL_BITS, &read) == FALSE) {
+      return FALSE;
+    }
+    if (read & (1 << (POS_DELTA_SMALL_BITS - 1))) {
+      *value = base + (int) read - (1 << POS_DELTA_SMALL_BITS);
+    } else {
+      *value = base + (int) read;
+    }
+  } else {
+    if (posDeltaTake(bits, POS_DELTA_COORD_BITS, &read) == FALSE) {
+      return FALSE;
+    }
+    *value = (int) read;
+  }
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          posDeltaPutBlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes a tank or lgm block as a change from base
+*
+*ARGUMENTS:
+*  bits  - Buffer position
+*  base  - Block in the base frame
+*  block - Block to send
+*********************************************************/
+static void posDeltaPutBlock(posDeltaBits *bits, BYTE *base, BYTE *block) {
+  posDeltaPutCoord(bits, (base[0] << 4) | (base[2] >> 4), (block[0] << 4) | (block[2] >> 4));
+  posDeltaPutCoord(bits, (base[1] << 4) | (base[2] & 0xF), (block[1] << 4) | (block[2] & 0xF));
+  if (base[3] == block[3]) {
+    posDeltaPut(bits, 0, 1);
+  } else {
+    posDeltaPut(bits, 1, 1);
+    posDeltaPut(bits, block[3], 8);
+  }
+}
+
+/*********************************************************
+*NAME:          posDeltaTakeBlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads a tank or lgm block. Returns FALSE if the buffer
+*  is too short
+*
+*ARGUMENTS:
+*  bits  - Buffer position
+*  base  - Block in the base frame
+*  block - Block read
+*********************************************************/
+static bool posDeltaTakeBlock(posDeltaBits *bits, BYTE *base, BYTE *block) {
+  unsigned int changed; /* Options changed flag */
+  unsigned int read;    /* Bits read */
+  int x;                /* Position read */
+  int y;
+
+  memcpy(block, base, POS_DELTA_BLOCK_SIZE);
+  if (posDeltaTakeCoord(bits, (base[0] << 4) | (base[2] >> 4), &x) == FALSE) {
+    return FALSE;
+  }
+  if (posDeltaTakeCoord(bits, (base[1] << 4) | (base[2] & 0xF), &y) == FALSE) {
+    return FALSE;
+  }
+  block[0] = (BYTE) (x >> 4);
+  block[1] = (BYTE) (y >> 4);
+  block[2] = (BYTE) (((x & 0xF) << 4) | (y & 0xF));
+  if (posDeltaTake(bits, 1, &changed) == FALSE) {
+    return FALSE;
+  }
+  if (changed == 1) {
+    if (posDeltaTake(bits, 8, &read) == FALSE) {
+      return FALSE;
+    }
+    block[3] = (BYTE) read;
+  }
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          posDeltaCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates an empty frame history
+*
+*ARGUMENTS:
+*
+*********************************************************/
+posDelta posDeltaCreate(void) {
+  posDelta returnValue; /* Value to return */
+
+  New(returnValue);
+  posDeltaReset(&returnValue);
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          posDeltaDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys and frees memory for a frame history
+*
+*ARGUMENTS:
+*  pd - Pointer to the frame history
+*********************************************************/
+void posDeltaDestroy(posDelta *pd) {
+  if (*pd != NULL) {
+    Dispose(*pd);
+    *pd = NULL;
+  }
+}
+
+/*********************************************************
+*NAME:          posDeltaReset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Forgets every frame. The next delta made is a full
+*  frame
+*
+*ARGUMENTS:
+*  pd - Pointer to the frame history
+*********************************************************/
+void posDeltaReset(posDelta *pd) {
+  memset((*pd)->seq, POS_DELTA_NONE, sizeof((*pd)->seq));
+  (*pd)->last = POS_DELTA_NONE;
+}
+
+/*********************************************************
+*NAME:          posDeltaGetLast
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the sequence number of the last frame made or
+*  taken. This is what a client acknowledges
+*
+*ARGUMENTS:
+*  pd - Pointer to the frame history
+*********************************************************/
+BYTE posDeltaGetLast(posDelta *pd) {
+  return (*pd)->last;
+}
+
+/*********************************************************
+*NAME:          posDeltaEncode
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Makes a delta of frame from the acknowledged frame and
+*  remembers frame under the next sequence number. If the
+*  acknowledged frame is no longer held the delta is made
+*  from nothing. Returns the data length, or 0 if nothing
+*  changed and force is FALSE.
+*
+*ARGUMENTS:
+*  pd    - Pointer to the frame history
+*  frame - Frame to send
+*  ack   - Last sequence number the client acknowledged
+*  force - Send the frame even if nothing changed
+*  buff  - Buffer to write to
+*********************************************************/
+int posDeltaEncode(posDelta *pd, posDeltaFrame *frame, BYTE ack, bool force, BYTE *buff) {
+  static posDeltaFrame empty;  /* Base when none is held */
+  posDeltaFrame *base;         /* Frame the delta is from */
+  posDeltaItem *item;          /* Item being sent */
+  posDeltaItem *baseItem;      /* Same item in the base */
+  posDeltaBits bits;           /* Position through the buffer */
+  unsigned int changed;        /* Mask of changed players */
+  int numChanged;              /* Number of changed players */
+  int back;                    /* Frames back the base is */
+  BYTE seq;                    /* Sequence number of this frame */
+  BYTE count;                  /* Looping variable */
+
+  seq = (BYTE) ((*pd)->last % POS_DELTA_MAX_SEQ + 1);
+  base = posDeltaFind(pd, ack);
+  back = (seq + POS_DELTA_MAX_SEQ - ack) % POS_DELTA_MAX_SEQ;
+  if (base == NULL || back == 0 || back > POS_DELTA_MAX_BASE) {
+    back = 0;
+    base = &empty;
+  }
+
+  changed = 0;
+  numChanged = 0;
+  count = 0;
+  while (count < MAX_TANKS) {
+    if (memcmp(&frame->item[count], &base->item[count], sizeof(posDeltaItem)) != 0) {
+      changed |= 1 << count;
+      numChanged++;
+    }
+    count++;
+  }
+  if (numChanged == 0 && force == FALSE) {
+    return 0;
+  }
+
+  bits.buff = buff;
+  bits.bit = 0;
+  bits.max = 0;
+  posDeltaPut(&bits, seq, 8);
+  posDeltaPut(&bits, (unsigned int) back, POS_DELTA_BASE_BITS);
+  if (numChanged > POS_DELTA_LIST_MAX) {
+    posDeltaPut(&bits, 1, 1);
+    posDeltaPut(&bits, changed, MAX_TANKS);
+  } else {
+    posDeltaPut(&bits, 0, 1);
+    count = 0;
+    while (count < MAX_TANKS) {
+      if (changed & (1 << count)) {
+        posDeltaPut(&bits, 1, 1);
+        posDeltaPut(&bits, count, 4);
+      }
+      count++;
+    }
+    posDeltaPut(&bits, 0, 1);
+  }
+
+  count = 0;
+  while (count < MAX_TANKS) {
+    if (changed & (1 << count)) {
+      item = &frame->item[count];
+      baseItem = &base->item[count];
+      posDeltaPut(&bits, item->flags, 2);
+      if (item->flags & POS_DELTA_TANK) {
+        posDeltaPutBlock(&bits, baseItem->tank, item->tank);
+      }
+      if (item->flags & POS_DELTA_LGM) {
+        posDeltaPutBlock(&bits, baseItem->lgm, item->lgm);
+      }
+    }
+    count++;
+  }
+
+  memcpy(&(*pd)->frame[seq % POS_DELTA_HISTORY], frame, sizeof(posDeltaFrame));
+  (*pd)->seq[seq % POS_DELTA_HISTORY] = seq;
+  (*pd)->last = seq;
+  return (bits.bit + 7) / 8;
+}
+
+/*********************************************************
+*NAME:          posDeltaDecode
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Undoes a delta made by posDeltaEncode into frame and
+*  remembers it. Returns FALSE if the delta is older than
+*  the last one taken, is from a frame no longer held or
+*  is too short.
+*
+*ARGUMENTS:
+*  pd    - Pointer to the frame history
+*  buff  - Delta data
+*  len   - Length of the data
+*  frame - Frame to write to
+*********************************************************/
+bool posDeltaDecode(posDelta *pd, BYTE *buff, int len, posDeltaFrame *frame) {
+  static posDeltaFrame empty;  /* Base when the delta is from nothing */
+  posDeltaFrame *base;         /* Frame the delta is from */
+  posDeltaItem *item;          /* Item being read */
+  posDeltaItem *baseItem;      /* Same item in the base */
+  posDeltaBits bits;           /* Position through the buffer */
+  unsigned int changed;        /* Mask of changed players */
+  unsigned int read;           /* Bits read */
+  int ahead;                   /* How far seq is past the last frame */
+  BYTE seq;                    /* Sequence number of this frame */
+  BYTE count;                  /* Looping variable */
+
+  bits.buff = buff;
+  bits.bit = 0;
+  bits.max = len * 8;
+  if (posDeltaTake(&bits, 8, &read) == FALSE || read == POS_DELTA_NONE) {
+    return FALSE;
+  }
+  seq = (BYTE) read;
+  if ((*pd)->last != POS_DELTA_NONE) {
+    ahead = (seq + POS_DELTA_MAX_SEQ - (*pd)->last) % POS_DELTA_MAX_SEQ;
+    if (ahead == 0 || ahead > POS_DELTA_MAX_SEQ / 2) {
+      /* Arrived out of order */
+      return FALSE;
+    }
+  }
+  if (posDeltaTake(&bits, POS_DELTA_BASE_BITS, &read) == FALSE) {
+    return FALSE;
+  }
+  base = &empty;
+  if (read != 0) {
+    base = posDeltaFind(pd, (BYTE) ((seq + POS_DELTA_MAX_SEQ - 1 - read) % POS_DELTA_MAX_SEQ + 1));
+    if (base == NULL) {
+      return FALSE;
+    }
+  }
+
+  if (posDeltaTake(&bits, 1, &read) == FALSE) {
+    return FALSE;
+  }
+  if (read == 1) {
+    if (posDeltaTake(&bits, MAX_TANKS, &changed) == FALSE) {
+      return FALSE;
+    }
+  } else {
+    changed = 0;
+    if (posDeltaTake(&bits, 1, &read) == FALSE) {
+      return FALSE;
+    }
+    while (read == 1) {
+      if (posDeltaTake(&bits, 4, &read) == FALSE) {
+        return FALSE;
+      }
+      changed |= 1 << read;
+      if (posDeltaTake(&bits, 1, &read) == FALSE) {
+        return FALSE;
+      }
+    }
+  }
+
+  count = 0;
+  while (count < MAX_TANKS) {
+    item = &frame->item[count];
+    baseItem = &base->item[count];
+    if ((changed & (1 << count)) == 0) {
+      memcpy(item, baseItem, sizeof(posDeltaItem));
+    } else {
+      memset(item, 0, sizeof(posDeltaItem));
+      if (posDeltaTake(&bits, 2, &read) == FALSE) {
+        return FALSE;
+      }
+      item->flags = (BYTE) read;
+      if ((item->flags & POS_DELTA_TANK) && posDeltaTakeBlock(&bits, baseItem->tank, item->tank) == FALSE) {
+        return FALSE;
+      }
+      if ((item->flags & POS_DELTA_LGM) && posDeltaTakeBlock(&bits, baseItem->lgm, item->lgm) == FALSE) {
+        return FALSE;
+      }
+    }
+    count++;
+  }
+
+  memcpy(&(*pd)->frame[seq % POS_DELTA_HISTORY], frame, sizeof(posDeltaFrame));
+  (*pd)->seq[seq % POS_DELTA_HISTORY] = seq;
+  (*pd)->last = seq;
+  return TRUE;
+}
@@ -0,0 +1,171 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Position Delta
+*Filename:      posdelta.h
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Encodes the tank and lgm positions a player can see as
+*  bit packed changes from the last frame that player
+*  acknowledged. Both ends keep a short history of frames
+*  by sequence number so a delta can be undone against
+*  whichever frame it was made from.
+*********************************************************/
+
+#ifndef POSDELTA_H
+#define POSDELTA_H
+
+#include "global.h"
+
+/* Frames remembered. Deltas are only made against frames
+   this recent */
+#define POS_DELTA_HISTORY 32
+
+/* Sequence numbers run 1 to 255. 0 means no frame so a
+   delta from it is a full frame */
+#define POS_DELTA_NONE 0
+#define POS_DELTA_MAX_SEQ 255
+
+/* Item flags */
+#define POS_DELTA_TANK 1
+#define POS_DELTA_LGM 2
+
+/* Bytes in a tank or lgm block. Map X, map Y, pixel X/Y
+   nibbles and an options byte */
+#define POS_DELTA_BLOCK_SIZE 4
+
+/* What a player can see of one other player. Blocks that
+   can not be seen are all zero */
+typedef struct {
+  BYTE flags;
+  BYTE tank[POS_DELTA_BLOCK_SIZE];
+  BYTE lgm[POS_DELTA_BLOCK_SIZE];
+} posDeltaItem;
+
+typedef struct {
+  posDeltaItem item[MAX_TANKS];
+} posDeltaFrame;
+
+typedef struct posDeltaObj *posDelta;
+struct posDeltaObj {
+  posDeltaFrame frame[POS_DELTA_HISTORY]; /* Frames by sequence number */
+  BYTE seq[POS_DELTA_HISTORY];            /* Sequence number of each frame */
+  BYTE last;                              /* Last frame made or taken */
+};
+
+/* Prototypes */
+
+/*********************************************************
+*NAME:          posDeltaCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates an empty frame history
+*
+*ARGUMENTS:
+*
+*********************************************************/
+posDelta posDeltaCreate(void);
+
+/*********************************************************
+*NAME:          posDeltaDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys and frees memory for a frame history
+*
+*ARGUMENTS:
+*  pd - Pointer to the frame history
+*********************************************************/
+void posDeltaDestroy(posDelta *pd);
+
+/*********************************************************
+*NAME:          posDeltaReset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Forgets every frame. The next delta made is a full
+*  frame
+*
+*ARGUMENTS:
+*  pd - Pointer to the frame history
+*********************************************************/
+void posDeltaReset(posDelta *pd);
+
+/*********************************************************
+*NAME:          posDeltaGetLast
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the sequence number of the last frame made or
+*  taken. This is what a client acknowledges
+*
+*ARGUMENTS:
+*  pd - Pointer to the frame history
+*********************************************************/
+BYTE posDeltaGetLast(posDelta *pd);
+
+/*********************************************************
+*NAME:          posDeltaEncode
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Makes a delta of frame from the acknowledged frame and
+*  remembers frame under the next sequence number. If the
+*  acknowledged frame is no longer held the delta is made
+*  from nothing. Returns the data length, or 0 if nothing
+*  changed and force is FALSE.
+*
+*ARGUMENTS:
+*  pd    - Pointer to the frame history
+*  frame - Frame to send
+*  ack   - Last sequence number the client acknowledged
+*  force - Send the frame even if nothing changed
+*  buff  - Buffer to write to
+*********************************************************/
+int posDeltaEncode(posDelta *pd, posDeltaFrame *frame, BYTE ack, bool force, BYTE *buff);
+
+/*********************************************************
+*NAME:          posDeltaDecode
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Undoes a delta made by posDeltaEncode into frame and
+*  remembers it. Returns FALSE if the delta is older than
+*  the last one taken, is from a frame no longer held or
+*  is too short.
+*
+*ARGUMENTS:
+*  pd    - Pointer to the frame history
+*  buff  - Delta data
+*  len   - Length of the data
+*  frame - Frame to write to
+*********************************************************/
+bool posDeltaDecode(posDelta *pd, BYTE *buff, int len, posDeltaFrame *frame);
+
+#endif /* POSDELTA_H */
@@ -0,0 +1,1615 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Replay
+*Filename:      replay.c
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Plays back WinBolo log files without a screen and
+*  keeps an index of their snapshots so any tick can be
+*  reached without inflating the log from the start.
+*********************************************************/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <string.h>
+/* Before types.h, which leaves structures packed */
+#include "../zlib/zlib.h"
+#include "global.h"
+#include "util.h"
+#include "tilenum.h"
+#include "bolo_map.h"
+#include "pillbox.h"
+#include "bases.h"
+#include "starts.h"
+#include "log.h"
+#include "replay.h"
+#include "../winbolonet/winbolonet.h"
+
+/* Bytes per item in the snapshot pill, base and start data */
+#define REPLAY_PILL_DATA 9
+#define REPLAY_BASE_DATA 10
+#define REPLAY_START_DATA 3
+
+/* Player snapshot length up to the name */
+#define REPLAY_PLAYER_DATA 11
+
+/*********************************************************
+*NAME:          replayGetLong
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns a little endian number from a file header
+*
+*ARGUMENTS:
+*  buff     - Position of the number
+*  numBytes - Bytes in the number
+*********************************************************/
+static unsigned long replayGetLong(BYTE *buff, int numBytes) {
+  unsigned long returnValue; /* Value to return */
+
+  returnValue = 0;
+  while (numBytes > 0) {
+    numBytes--;
+    returnValue = (returnValue << 8) | buff[numBytes];
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          replayPutLong
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes a little endian number into an index file
+*
+*ARGUMENTS:
+*  buff     - Position of the number
+*  numBytes - Bytes in the number
+*  value    - Number to write
+*********************************************************/
+static void replayPutLong(BYTE *buff, int numBytes, unsigned long value) {
+  int count; /* Looping variable */
+
+  for (count = 0; count < numBytes; count++) {
+    buff[count] = (BYTE) (value & 0xFF);
+    value >>= 8;
+  }
+}
+
+/*********************************************************
+*NAME:          replayPString
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Copies a pascal string from the log into a C string,
+*  cutting it short if it doesn't fit
+*
+*ARGUMENTS:
+*  src  - Pascal string
+*  dest - Destination
+*  size - Size of dest
+*********************************************************/
+static void replayPString(BYTE *src, char *dest, int size) {
+  int len; /* Length to copy */
+
+  len = src[0];
+  if (len > size - 1) {
+    len = size - 1;
+  }
+  memcpy(dest, src + 1, (size_t) len);
+  dest[len] = '\0';
+}
+
+/*********************************************************
+*NAME:          replayStreamStart
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Starts inflating at a deflate block boundary. Returns
+*  FALSE if the file can't be read there
+*
+*ARGUMENTS:
+*  value     - Pointer to the replay
+*  in        - Compressed offset of the block
+*  bits      - Bits of the byte before in still to use
+*  out       - Uncompressed offset of the block
+*  dict      - Output before the block
+*  dictLen   - Length of dict
+*********************************************************/
+static bool replayStreamStart(replay *value, unsigned long in, BYTE bits, unsigned long out, BYTE *dict, unsigned int dictLen) {
+  z_stream *strm; /* Inflate stream */
+  int c;          /* Byte holding the first bits */
+  bool returnValue; /* Value to return */
+
+  strm = (*value)->strm;
+  if ((*value)->strmOpen == TRUE) {
+    returnValue = (bool) (inflateReset(strm) == Z_OK);
+  } else {
+    strm->zalloc = Z_NULL;
+    strm->zfree = Z_NULL;
+    strm->opaque = Z_NULL;
+    strm->next_in = Z_NULL;
+    strm->avail_in = 0;
+    returnValue = (bool) (inflateInit2(strm, -MAX_WBITS) == Z_OK);
+    (*value)->strmOpen = returnValue;
+  }
+
+  if (returnValue == TRUE) {
+    returnValue = (bool) (fseek((*value)->fp, (long) ((*value)->dataStart + in - (bits > 0 ? 1 : 0)), SEEK_SET) == 0);
+  }
+  if (returnValue == TRUE && bits > 0) {
+    c = fgetc((*value)->fp);
+    returnValue = (bool) (c != EOF && inflatePrime(strm, bits, c >> (8 - bits)) == Z_OK);
+  }
+  if (returnValue == TRUE && dictLen > 0) {
+    returnValue = (bool) (inflateSetDictionary(strm, dict, dictLen) == Z_OK);
+  }
+
+  strm->avail_in = 0;
+  (*value)->inRead = in;
+  (*value)->outPos = 0;
+  (*value)->outEnd = 0;
+  (*value)->outTotal = out;
+  (*value)->streamEnd = FALSE;
+  (*value)->failed = (bool) (returnValue == FALSE);
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          replayStreamBlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Keeps the block boundary inflate has just stopped at
+*  with the output before it. The output up to it hasn't
+*  been read yet so it is held as the one ahead
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+static void replayStreamBlock(replay *value) {
+  replayBlock *block; /* Block being kept */
+  unsigned int end;   /* End of the output in window */
+
+  block = &(*value)->blocks[(*value)->blockNow ^ 1];
+  end = (*value)->outEnd;
+  block->in = (*value)->inRead - (*value)->strm->avail_in;
+  block->bits = (BYTE) ((*value)->strm->data_type & 7);
+  block->out = (*value)->outTotal;
+  if ((*value)->outTotal >= REPLAY_WINDOW_SIZE) {
+    /* The oldest output is just past the newest */
+    memcpy(block->window, (*value)->window + end, REPLAY_WINDOW_SIZE - end);
+    memcpy(block->window + REPLAY_WINDOW_SIZE - end, (*value)->window, end);
+    block->windowLen = REPLAY_WINDOW_SIZE;
+  } else {
+    memcpy(block->window, (*value)->window, end);
+    block->windowLen = end;
+  }
+  (*value)->blockAhead = TRUE;
+}
+
+/*********************************************************
+*NAME:          replayStreamFill
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Inflates more output once all of it has been read.
+*  While indexing inflate stops at every block boundary.
+*  Returns FALSE if there is no more
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+static bool replayStreamFill(replay *value) {
+  z_stream *strm;    /* Inflate stream */
+  unsigned int have; /* Output made */
+  unsigned int made; /* Output made by one inflate */
+  size_t got;        /* Compressed bytes read */
+  int ret;           /* Inflate return */
+
+  strm = (*value)->strm;
+  if ((*value)->outEnd == REPLAY_WINDOW_SIZE) {
+    (*value)->outPos = 0;
+    (*value)->outEnd = 0;
+  }
+
+  have = 0;
+  while (have == 0 && (*value)->streamEnd == FALSE && (*value)->failed == FALSE) {
+    if ((*value)->blockAhead == TRUE) {
+      /* Everything before it has been read */
+      (*value)->blockNow ^= 1;
+      (*value)->blockAhead = FALSE;
+    }
+    if (strm->avail_in == 0) {
+      got = fread((*value)->in, 1, REPLAY_IN_SIZE, (*value)->fp);
+      if (got == 0) {
+        /* Log cut short */
+        (*value)->streamEnd = TRUE;
+        break;
+      }
+      (*value)->inRead += (unsigned long) got;
+      strm->next_in = (*value)->in;
+      strm->avail_in = (uInt) got;
+    }
+
+    strm->next_out = (*value)->window + (*value)->outEnd;
+    strm->avail_out = REPLAY_WINDOW_SIZE - (*value)->outEnd;
+    ret = inflate(strm, (*value)->indexing == TRUE ? Z_BLOCK : Z_NO_FLUSH);
+    made = REPLAY_WINDOW_SIZE - (*value)->outEnd - strm->avail_out;
+    (*value)->outEnd += made;
+    (*value)->outTotal += made;
+    have += made;
+
+    if (ret == Z_STREAM_END) {
+      (*value)->streamEnd = TRUE;
+    } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+      (*value)->failed = TRUE;
+    } else if ((*value)->indexing == TRUE && (strm->data_type & 128) != 0 && (strm->data_type & 64) == 0) {
+      replayStreamBlock(value);
+    }
+  }
+
+  return (bool) (have > 0);
+}
+
+/*********************************************************
+*NAME:          replayStreamRead
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads bytes of the log. Returns FALSE if it ends first
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*  buff  - Destination, or NULL to skip the bytes
+*  len   - Number of bytes
+*********************************************************/
+static bool replayStreamRead(replay *value, BYTE *buff, unsigned long len) {
+  unsigned long amount; /* Bytes to copy at once */
+
+  while (len > 0) {
+    if ((*value)->outPos == (*value)->outEnd && replayStreamFill(value) == FALSE) {
+      return FALSE;
+    }
+    amount = (*value)->outEnd - (*value)->outPos;
+    if (amount > len) {
+      amount = len;
+    }
+    if (buff != NULL) {
+      memcpy(buff, (*value)->window + (*value)->outPos, (size_t) amount);
+      buff += amount;
+    }
+    (*value)->outPos += (unsigned int) amount;
+    len -= amount;
+  }
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          replayReadKeyed
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads bytes of the log and XORs them with the current
+*  key. Returns FALSE if it ends first
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*  buff  - Destination
+*  len   - Number of bytes
+*********************************************************/
+static bool replayReadKeyed(replay *value, BYTE *buff, int len) {
+  int count; /* Looping variable */
+
+  if (replayStreamRead(value, buff, (unsigned long) len) == FALSE) {
+    return FALSE;
+  }
+  for (count = 0; count < len; count++) {
+    buff[count] ^= (*value)->key;
+  }
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          replayGetNet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns a long the server wrote in network order into
+*  a long of its own size
+*
+*ARGUMENTS:
+*  buff - Position of the number
+*********************************************************/
+static unsigned long replayGetNet(BYTE *buff) {
+  return ((unsigned long) buff[0] << 24) | ((unsigned long) buff[1] << 16) | ((unsigned long) buff[2] << 8) | buff[3];
+}
+
+/*********************************************************
+*NAME:          replayEventLength
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the number of options logAddEvent writes after
+*  an event, or -1 if it doesn't write the event
+*
+*ARGUMENTS:
+*  item    - Event
+*  hasText - Set to if a pascal string follows
+*********************************************************/
+static int replayEventLength(BYTE item, bool *hasText) {
+  *hasText = FALSE;
+  switch (item) {
+  case log_MessageServer:
+    *hasText = TRUE;
+    return 0;
+  case log_ChangeName:
+  case log_MessageAll:
+    *hasText = TRUE;
+    return 1;
+  case log_MessagePlayers:
+    *hasText = TRUE;
+    return 2;
+  case log_PlayerJoined:
+    *hasText = TRUE;
+    return 5;
+  case log_PlayerQuit:
+  case log_LostMan:
+  case log_AllyLeave:
+  case log_PillSetHealth:
+  case log_PillSetInTank:
+  case log_PlayerRejoin:
+  case log_PlayerLeaving:
+  case log_PlayerDied:
+    return 1;
+  case log_AllyRequest:
+  case log_AllyAccept:
+  case log_KillPlayer:
+  case log_SoundBuild:
+  case log_SoundFarm:
+  case log_SoundShoot:
+  case log_SoundHitTank:
+  case log_SoundHitTree:
+  case log_SoundHitWall:
+  case log_SoundMineLay:
+  case log_SoundMineExplode:
+  case log_SoundExplosion:
+  case log_SoundBigExplosion:
+  case log_SoundManDie:
+    return 2;
+  case log_BaseSetOwner:
+  case log_MapChange:
+  case log_PillSetOwner:
+  case log_PillSetPlace:
+    return 3;
+  case log_BaseSetStock:
+  case log_Shell:
+  case log_LgmLocation:
+    return 4;
+  case log_PlayerLocation:
+    return 5;
+  }
+  return -1;
+}
+
+/*********************************************************
+*NAME:          replayApplyEvent
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Applies an event that changes the lasting state of the
+*  game. Shells, lgms, sounds and messages only last the
+*  tick and are read back through replayGetEvent
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*  ev    - Event, not XORed
+*********************************************************/
+static void replayApplyEvent(replay *value, BYTE *ev) {
+  replayPlayer *plr; /* Player changed */
+  BYTE num;          /* Item number */
+  BYTE opt;          /* Option in a nibble */
+  BYTE oldX;         /* Previous position of a pill */
+  BYTE oldY;
+
+  switch (ev[0]) {
+  case log_PlayerJoined:
+    if (ev[1] < MAX_TANKS) {
+      plr = &(*value)->plrs[ev[1]];
+      memset(plr, 0, sizeof(*plr));
+      plr->inUse = TRUE;
+      replayPString(ev + 6, plr->name, PLAYER_NAME_LEN);
+    }
+    break;
+  case log_PlayerQuit:
+    if (ev[1] < MAX_TANKS) {
+      (*value)->plrs[ev[1]].inUse = FALSE;
+    }
+    break;
+  case log_ChangeName:
+    if (ev[1] < MAX_TANKS) {
+      replayPString(ev + 2, (*value)->plrs[ev[1]].name, PLAYER_NAME_LEN);
+    }
+    break;
+  case log_PlayerLocation:
+    if (ev[1] < MAX_TANKS) {
+      plr = &(*value)->plrs[ev[1]];
+      plr->mx = ev[2];
+      plr->my = ev[3];
+      utilGetNibbles(ev[4], &plr->px, &plr->py);
+      utilGetNibbles(ev[5], &plr->dir, &opt);
+      plr->onBoat = (bool) (opt != 0);
+    }
+    break;
+  case log_MapChange:
+    (*(*value)->mp).mapItem[ev[1]][ev[2]] = ev[3];
+    break;
+  case log_PillSetOwner:
+    if (ev[1] < (*value)->pb->numPills) {
+      (*value)->pb->item[ev[1]].owner = ev[2];
+    }
+    break;
+  case log_PillSetHealth:
+    utilGetNibbles(ev[1], &num, &opt);
+    if (num < (*value)->pb->numPills) {
+      (*value)->pb->item[num].armour = opt;
+    }
+    break;
+  case log_PillSetInTank:
+    utilGetNibbles(ev[1], &num, &opt);
+    if (num < (*value)->pb->numPills) {
+      (*value)->pb->item[num].inTank = (bool) (opt != 0);
+    }
+    break;
+  case log_PillSetPlace:
+    if (ev[1] < (*value)->pb->numPills) {
+      oldX = (*value)->pb->item[ev[1]].x;
+      oldY = (*value)->pb->item[ev[1]].y;
+      (*value)->pb->item[ev[1]].x = ev[2];
+      (*value)->pb->item[ev[1]].y = ev[3];
+      pillsPosIndexUpdate(&(*value)->pb, oldX, oldY);
+      pillsPosIndexUpdate(&(*value)->pb, ev[2], ev[3]);
+    }
+    break;
+  case log_BaseSetOwner:
+    if (ev[1] < (*value)->bs->numBases) {
+      (*value)->bs->item[ev[1]].owner = ev[2];
+    }
+    break;
+  case log_BaseSetStock:
+    if (ev[1] < (*value)->bs->numBases) {
+      (*value)->bs->item[ev[1]].shells = ev[2];
+      (*value)->bs->item[ev[1]].mines = ev[3];
+      (*value)->bs->item[ev[1]].armour = ev[4];
+    }
+    break;
+  }
+}
+
+/*********************************************************
+*NAME:          replayReadEvents
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads a tick's events into the event buffer and
+*  applies them. Each event is XORed with the one before.
+*  Returns FALSE if the log ends first or an event is
+*  unknown
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*  count - Number of events
+*********************************************************/
+static bool replayReadEvents(replay *value, unsigned short count) {
+  BYTE *ev;     /* Event being read */
+  int len;      /* Options in the event */
+  bool hasText; /* Does a string follow */
+
+  (*value)->eventsLen = 0;
+  while (count > 0) {
+    if ((*value)->eventsLen + REPLAY_MAX_EVENT > LOG_MEMORY_BUFFER_SIZE) {
+      (*value)->failed = TRUE;
+      return FALSE;
+    }
+    ev = (*value)->events + (*value)->eventsLen;
+    if (replayReadKeyed(value, ev, 1) == FALSE) {
+      return FALSE;
+    }
+    len = replayEventLength(ev[0], &hasText);
+    if (len < 0) {
+      (*value)->failed = TRUE;
+      return FALSE;
+    }
+    if (replayReadKeyed(value, ev + 1, len) == FALSE) {
+      return FALSE;
+    }
+    len++;
+    if (hasText == TRUE) {
+      if (replayReadKeyed(value, ev + len, 1) == FALSE || replayReadKeyed(value, ev + len + 1, ev[len]) == FALSE) {
+        return FALSE;
+      }
+      len += ev[len] + 1;
+    }
+    (*value)->key = ev[0];
+    replayApplyEvent(value, ev);
+    (*value)->eventsLen += len;
+    count--;
+  }
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          replayReadSnapshot
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads the rest of a snapshot written by
+*  logWriteSnapshot and replaces the game state with it.
+*  Returns FALSE if it is cut short or doesn't make sense
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+static bool replayReadSnapshot(replay *value) {
+  BYTE data[512];       /* Part being read */
+  BYTE len;             /* Length of the part */
+  BYTE count;           /* Looping variable */
+  replayPlayer *plr;    /* Player being read */
+  bool done;            /* Have all runs been read */
+
+  /* Start delay and time left */
+  if (replayReadKeyed(value, data, (*value)->header.longSize * 2) == FALSE) {
+    return FALSE;
+  }
+  (*value)->startDelay = replayGetNet(data);
+  (*value)->timeLeft = replayGetNet(data + (*value)->header.longSize);
+
+  /* Pills */
+  if (replayReadKeyed(value, &len, 1) == FALSE || replayReadKeyed(value, data, len) == FALSE) {
+    return FALSE;
+  }
+  if (len < 1 || data[0] > MAX_PILLS || 1 + data[0] * REPLAY_PILL_DATA > len) {
+    (*value)->failed = TRUE;
+    return FALSE;
+  }
+  pillsSetPillNetData(&(*value)->pb, data, len);
+
+  /* Bases */
+  if (replayReadKeyed(value, &len, 1) == FALSE || replayReadKeyed(value, data, len) == FALSE) {
+    return FALSE;
+  }
+  if (len < 1 || data[0] > MAX_BASES || 1 + data[0] * REPLAY_BASE_DATA > len) {
+    (*value)->failed = TRUE;
+    return FALSE;
+  }
+  basesSetBaseNetData(&(*value)->bs, data, len);
+
+  /* Starts */
+  if (replayReadKeyed(value, &len, 1) == FALSE || replayReadKeyed(value, data, len) == FALSE) {
+    return FALSE;
+  }
+  if (len < 1 || data[0] > MAX_STARTS || 1 + data[0] * REPLAY_START_DATA > len) {
+    (*value)->failed = TRUE;
+    return FALSE;
+  }
+  startsSetStartNetData(&(*value)->ss, data, len);
+
+  /* Map runs up to the one that marks the end */
+  memset((*(*value)->mp).mapItem, DEEP_SEA, sizeof((*(*value)->mp).mapItem));
+  done = FALSE;
+  while (done == FALSE) {
+    if (replayReadKeyed(value, data, SIZEOFBMAP_RUN_HEADER) == FALSE) {
+      return FALSE;
+    }
+    if (data[0] < SIZEOFBMAP_RUN_HEADER) {
+      (*value)->failed = TRUE;
+      return FALSE;
+    }
+    len = (BYTE) (data[0] - SIZEOFBMAP_RUN_HEADER);
+    if (replayReadKeyed(value, data + SIZEOFBMAP_RUN_HEADER, len) == FALSE) {
+      return FALSE;
+    }
+    if (len == 0 && data[1] == MAP_ARRAY_LAST && data[2] == MAP_ARRAY_LAST && data[3] == MAP_ARRAY_LAST) {
+      done = TRUE;
+    } else if (mapProcessRun(data + SIZEOFBMAP_RUN_HEADER, &(*value)->mp, len, data[1], data[2], data[3]) == FALSE) {
+      (*value)->failed = TRUE;
+      return FALSE;
+    }
+  }
+
+  /* Players */
+  for (count = 0; count < MAX_TANKS; count++) {
+    if (replayReadKeyed(value, &len, 1) == FALSE || replayReadKeyed(value, data, len) == FALSE) {
+      return FALSE;
+    }
+    plr = &(*value)->plrs[count];
+    memset(plr, 0, sizeof(*plr));
+    plr->inUse = (bool) (len >= 2 && data[1] != FALSE);
+    if (plr->inUse == TRUE && len > REPLAY_PLAYER_DATA && REPLAY_PLAYER_DATA + 1 + data[REPLAY_PLAYER_DATA] <= len) {
+      plr->mx = data[2];
+      plr->my = data[3];
+      utilGetNibbles(data[4], &plr->px, &plr->py);
+      plr->dir = (BYTE) (data[5] == TANK_TRANSPARENT ? 0 : data[5] % TANK_BOAT_ADD);
+      plr->onBoat = (bool) (data[6] != FALSE);
+      replayPString(data + REPLAY_PLAYER_DATA, plr->name, PLAYER_NAME_LEN);
+    }
+  }
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          replayIndexAdd
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Adds the snapshot about to be read to the index with
+*  the last block boundary before it
+*
+*ARGUMENTS:
+*  value  - Pointer to the replay
+*  offset - Uncompressed offset of the snapshot
+*********************************************************/
+static void replayIndexAdd(replay *value, unsigned long offset) {
+  replayIndexItem *item;  /* Entry being added */
+  replayIndexItem *grown; /* Larger index */
+  replayBlock *block;     /* Block before the snapshot */
+  uLongf len;             /* Compressed window length */
+
+  if ((*value)->numIndex == (*value)->sizeIndex) {
+    grown = realloc((*value)->index, sizeof(replayIndexItem) * (size_t) ((*value)->sizeIndex * 2 + 16));
+    if (grown == NULL) {
+      (*value)->blockFailed = TRUE;
+      return;
+    }
+    (*value)->index = grown;
+    (*value)->sizeIndex = (*value)->sizeIndex * 2 + 16;
+  }
+
+  block = &(*value)->blocks[(*value)->blockNow];
+  item = &(*value)->index[(*value)->numIndex];
+  item->tick = (*value)->tick;
+  item->offset = offset;
+  item->key = (*value)->key;
+  item->in = block->in;
+  item->bits = block->bits;
+  item->out = block->out;
+  item->windowLen = 0;
+  item->window = NULL;
+  if (block->windowLen > 0) {
+    len = compressBound(block->windowLen);
+    item->window = malloc((size_t) len);
+    if (item->window == NULL || compress(item->window, &len, block->window, block->windowLen) != Z_OK) {
+      free(item->window);
+      (*value)->blockFailed = TRUE;
+      return;
+    }
+    item->windowLen = (unsigned long) len;
+  }
+  (*value)->numIndex++;
+}
+
+/*********************************************************
+*NAME:          replayIndexFree
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Drops the index
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+static void replayIndexFree(replay *value) {
+  int count; /* Looping variable */
+
+  for (count = 0; count < (*value)->numIndex; count++) {
+    free((*value)->index[count].window);
+  }
+  free((*value)->index);
+  (*value)->index = NULL;
+  (*value)->numIndex = 0;
+  (*value)->sizeIndex = 0;
+  (*value)->numTicks = 0;
+  (*value)->complete = FALSE;
+}
+
+/*********************************************************
+*NAME:          replayReadRecord
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads the next record. A record of ticks sets how many
+*  are left to play and reads the events of the first.
+*  Returns the record type, or -1 at the end of the log
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+static int replayReadRecord(replay *value) {
+  BYTE data[3];          /* Record header */
+  unsigned long offset;  /* Uncompressed offset of the record */
+  unsigned short amount; /* Ticks or events in the record */
+  bool ok;               /* Was the record read */
+
+  offset = (*value)->outTotal - ((*value)->outEnd - (*value)->outPos);
+  if (replayReadKeyed(value, data, 1) == FALSE) {
+    return -1;
+  }
+
+  ok = TRUE;
+  amount = 0;
+  switch (data[0]) {
+  case LOG_NOEVENTS:
+  case LOG_EVENT:
+    ok = replayReadKeyed(value, data + 1, 1);
+    amount = data[1];
+    break;
+  case LOG_NOEVENTS_LONG:
+  case LOG_EVENT_LONG:
+    /* Written with htons high byte first, by little endian
+       servers */
+    ok = replayReadKeyed(value, data + 1, 2);
+    amount = (unsigned short) (data[1] | (data[2] << 8));
+    break;
+  case LOG_EVENT_SNAPSHOT:
+    if ((*value)->indexing == TRUE) {
+      replayIndexAdd(value, offset);
+    }
+    ok = replayReadSnapshot(value);
+    break;
+  case LOG_QUIT:
+    ok = replayReadKeyed(value, data + 1, 1);
+    (*value)->finished = TRUE;
+    break;
+  default:
+    (*value)->failed = TRUE;
+    ok = FALSE;
+    break;
+  }
+
+  if (ok == TRUE && amount > 0) {
+    if (data[0] == LOG_NOEVENTS || data[0] == LOG_NOEVENTS_LONG) {
+      (*value)->eventsLen = 0;
+      (*value)->emptyLeft = (unsigned short) (amount - 1);
+    } else {
+      ok = replayReadEvents(value, amount);
+    }
+  }
+  if (ok == FALSE) {
+    return -1;
+  }
+  return data[0];
+}
+
+/*********************************************************
+*NAME:          replayReadHeader
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads the header logStart writes and the snapshot after
+*  it from the start of the log. Returns FALSE if it isn't
+*  a log, or longs aren't longSize bytes
+*
+*ARGUMENTS:
+*  value    - Pointer to the replay
+*  longSize - Bytes the server wrote for a long
+*********************************************************/
+static bool replayReadHeader(replay *value, int longSize) {
+  BYTE data[512];  /* Part being read */
+  replayHeader *h; /* Header being filled in */
+  int len;         /* Length of the map name */
+
+  h = &(*value)->header;
+  memset(h, 0, sizeof(*h));
+  h->longSize = longSize;
+  (*value)->key = 0;
+  (*value)->tick = 0;
+  (*value)->emptyLeft = 0;
+  (*value)->eventsLen = 0;
+  (*value)->finished = FALSE;
+  if (replayStreamStart(value, 0, 0, 0, NULL, 0) == FALSE) {
+    return FALSE;
+  }
+  (*value)->blockNow = 0;
+  (*value)->blockAhead = FALSE;
+  (*value)->blocks[0].in = 0;
+  (*value)->blocks[0].bits = 0;
+  (*value)->blocks[0].out = 0;
+  (*value)->blocks[0].windowLen = 0;
+
+  if (replayStreamRead(value, data, strlen(LOG_HEADER) + 1) == FALSE || memcmp(data, LOG_HEADER, strlen(LOG_HEADER)) != 0 || data[strlen(LOG_HEADER)] != LOG_VERSION) {
+    return FALSE;
+  }
+  if (replayStreamRead(value, data, 1) == FALSE || replayStreamRead(value, data + 1, data[0]) == FALSE) {
+    return FALSE;
+  }
+  len = data[0];
+  if (len > MAP_STR_SIZE - 1) {
+    len = MAP_STR_SIZE - 1;
+  }
+  memcpy(h->mapName, data + 1, (size_t) len);
+  h->mapName[len] = '\0';
+
+  /* Game settings, server address, port, start time and
+     WinBolo.net key */
+  if (replayStreamRead(value, data, 8 + 4 + 2 + longSize + WINBOLONET_KEY_LEN) == FALSE) {
+    return FALSE;
+  }
+  h->gameType = data[0];
+  h->hiddenMines = (bool) (data[1] != FALSE);
+  h->ai = data[2];
+  h->password = (bool) (data[3] != FALSE);
+  h->maxPlayers = data[4];
+  memcpy(h->version, data + 5, 3);
+  memcpy(h->address, data + 8, 4);
+  h->port = (unsigned short) ((data[12] << 8) | data[13]);
+  h->startTime = replayGetNet(data + 14);
+
+  /* The snapshot is keyed with the low byte of the start
+     time */
+  (*value)->key = (BYTE) (h->startTime & 0xFF);
+  return (bool) (replayReadRecord(value) == LOG_EVENT_SNAPSHOT);
+}
+
+/*********************************************************
+*NAME:          replayRewind
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Goes back to tick 0. Servers write longs in their own
+*  size, so eight bytes is tried if four doesn't read.
+*  Returns FALSE if the log can't be read
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+static bool replayRewind(replay *value) {
+  int longSize; /* Size that worked before */
+
+  longSize = (*value)->header.longSize;
+  if (longSize != 0) {
+    return replayReadHeader(value, longSize);
+  }
+  if (replayReadHeader(value, 4) == TRUE) {
+    return TRUE;
+  }
+  return replayReadHeader(value, 8);
+}
+
+/*********************************************************
+*NAME:          replayCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates a replay with no log open
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+void replayCreate(replay *value) {
+  New(*value);
+  memset(*value, 0, sizeof(**value));
+  New((*value)->strm);
+  mapCreate(&(*value)->mp);
+  pillsCreate(&(*value)->pb);
+  basesCreate(&(*value)->bs);
+  startsCreate(&(*value)->ss);
+}
+
+/*********************************************************
+*NAME:          replayDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Closes any open log and frees the replay
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+void replayDestroy(replay *value) {
+  replayClose(value);
+  Dispose((*value)->strm);
+  mapDestroy(&(*value)->mp);
+  pillsDestroy(&(*value)->pb);
+  basesDestroy(&(*value)->bs);
+  startsDestroy(&(*value)->ss);
+  Dispose(*value);
+  *value = NULL;
+}
+
+/*********************************************************
+*NAME:          replayOpen
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Opens a log and reads its header and first snapshot,
+*  leaving the replay at tick 0. Returns FALSE if it is
+*  not a WinBolo log or is damaged
+*
+*ARGUMENTS:
+*  value    - Pointer to the replay
+*  fileName - Log file to open
+*********************************************************/
+bool replayOpen(replay *value, char *fileName) {
+  BYTE zipHeader[REPLAY_ZIP_HEADER_SIZE]; /* Zip local file header */
+  bool returnValue;                       /* Value to return */
+
+  replayClose(value);
+  if (strlen(fileName) >= FILENAME_MAX) {
+    return FALSE;
+  }
+  (*value)->fp = fopen(fileName, "rb");
+  if ((*value)->fp == NULL) {
+    return FALSE;
+  }
+  strcpy((*value)->fileName, fileName);
+
+  /* The log is the only file in the zip. Sizes in the
+     header are ignored as they are only filled in when the
+     log is closed */
+  returnValue = FALSE;
+  if (fread(zipHeader, REPLAY_ZIP_HEADER_SIZE, 1, (*value)->fp) == 1 && replayGetLong(zipHeader, 4) == REPLAY_ZIP_SIGNATURE && (replayGetLong(zipHeader + 6, 2) & 1) == 0 && replayGetLong(zipHeader + 8, 2) == REPLAY_ZIP_DEFLATED) {
+    (*value)->dataStart = REPLAY_ZIP_HEADER_SIZE + replayGetLong(zipHeader + 26, 2) + replayGetLong(zipHeader + 28, 2);
+    returnValue = replayRewind(value);
+  }
+  if (returnValue == FALSE) {
+    replayClose(value);
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          replayClose
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Closes the log and drops its index
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+void replayClose(replay *value) {
+  if ((*value)->fp != NULL) {
+    fclose((*value)->fp);
+    (*value)->fp = NULL;
+  }
+  if ((*value)->strmOpen == TRUE) {
+    inflateEnd((*value)->strm);
+    (*value)->strmOpen = FALSE;
+  }
+  replayIndexFree(value);
+  (*value)->header.longSize = 0;
+  (*value)->fileName[0] = '\0';
+}
+
+/*********************************************************
+*NAME:          replayIndexName
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Makes the index file name for a log file. Returns
+*  FALSE if the name would not fit in FILENAME_MAX
+*
+*ARGUMENTS:
+*  fileName  - Log file name
+*  indexName - Buffer of FILENAME_MAX to hold the name
+*********************************************************/
+bool replayIndexName(char *fileName, char *indexName) {
+  size_t len; /* Length of the name without .wbv */
+
+  len = strlen(fileName);
+  if (len >= 4 && strcmp(fileName + len - 4, ".wbv") == 0) {
+    len -= 4;
+  }
+  /* Room for the temporary name as well */
+  if (len + strlen(REPLAY_INDEX_EXT) + 4 >= FILENAME_MAX) {
+    return FALSE;
+  }
+  memcpy(indexName, fileName, len);
+  strcpy(indexName + len, REPLAY_INDEX_EXT);
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          replayIndexBuild
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Scans the whole log for snapshots, then goes back to
+*  the tick the replay was at. Returns FALSE if the log
+*  is damaged or memory ran out
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIndexBuild(replay *value) {
+  unsigned long tick; /* Tick to go back to */
+  bool returnValue;   /* Value to return */
+
+  if ((*value)->fp == NULL) {
+    return FALSE;
+  }
+  tick = (*value)->tick;
+  replayIndexFree(value);
+  (*value)->indexing = TRUE;
+  (*value)->blockFailed = FALSE;
+  returnValue = replayRewind(value);
+  while (returnValue == TRUE && replayStep(value) == TRUE) {
+  }
+  (*value)->indexing = FALSE;
+
+  if (returnValue == FALSE || (*value)->failed == TRUE || (*value)->blockFailed == TRUE || (*value)->numIndex == 0) {
+    replayIndexFree(value);
+    returnValue = FALSE;
+  } else {
+    (*value)->numTicks = (*value)->tick;
+    /* A log without its quit record was cut short */
+    (*value)->complete = (*value)->finished;
+  }
+  if (replaySeek(value, tick) == FALSE) {
+    returnValue = FALSE;
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          replayIndexRead
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Loads the index file beside the log. It is only used
+*  if the log is the size and age it was when the index
+*  was written. Returns FALSE if there is no usable index
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIndexRead(replay *value) {
+  char indexName[FILENAME_MAX]; /* Index file name */
+  BYTE header[REPLAY_INDEX_HEADER_SIZE]; /* Index header */
+  BYTE data[REPLAY_INDEX_ENTRY_SIZE];    /* Index entry */
+  struct stat st;               /* Log file size and time */
+  replayIndexItem *item;        /* Entry being read */
+  FILE *fp;                     /* Index file */
+  unsigned long count;          /* Entries in the file */
+  bool returnValue;             /* Value to return */
+
+  if ((*value)->fp == NULL || replayIndexName((*value)->fileName, indexName) == FALSE || stat((*value)->fileName, &st) != 0) {
+    return FALSE;
+  }
+  fp = fopen(indexName, "rb");
+  if (fp == NULL) {
+    return FALSE;
+  }
+
+  replayIndexFree(value);
+  returnValue = FALSE;
+  count = 0;
+  if (fread(header, REPLAY_INDEX_HEADER_SIZE, 1, fp) == 1 && memcmp(header, REPLAY_INDEX_ID, REPLAY_INDEX_ID_LEN) == 0 && header[REPLAY_INDEX_ID_LEN] == REPLAY_INDEX_VERSION
+    && replayGetLong(header + REPLAY_INDEX_ID_LEN + 1, 4) == ((unsigned long) st.st_size & 0xFFFFFFFFUL)
+    && replayGetLong(header + REPLAY_INDEX_ID_LEN + 5, 4) == ((unsigned long) st.st_mtime & 0xFFFFFFFFUL)) {
+    count = replayGetLong(header + REPLAY_INDEX_ID_LEN + 14, 4);
+    (*value)->index = malloc(sizeof(replayIndexItem) * (size_t) (count > 0 ? count : 1));
+    returnValue = (bool) ((*value)->index != NULL && count > 0);
+  }
+  if (returnValue == TRUE) {
+    (*value)->sizeIndex = (int) count;
+    (*value)->numTicks = replayGetLong(header + REPLAY_INDEX_ID_LEN + 9, 4);
+    (*value)->complete = (bool) ((header[REPLAY_INDEX_ID_LEN + 13] & REPLAY_INDEX_COMPLETE) != 0);
+  }
+  while (returnValue == TRUE && (unsigned long) (*value)->numIndex < count) {
+    item = &(*value)->index[(*value)->numIndex];
+    if (fread(data, REPLAY_INDEX_ENTRY_SIZE, 1, fp) != 1) {
+      returnValue = FALSE;
+    } else {
+      item->tick = replayGetLong(data, 4);
+      item->key = data[4];
+      item->offset = replayGetLong(data + 5, 4);
+      item->in = replayGetLong(data + 9, 4);
+      item->bits = data[13];
+      item->out = replayGetLong(data + 14, 4);
+      item->windowLen = replayGetLong(data + 18, 4);
+      item->window = NULL;
+      if (item->bits > 7 || item->out > item->offset || item->windowLen > compressBound(REPLAY_WINDOW_SIZE)) {
+        returnValue = FALSE;
+      } else if (item->windowLen > 0) {
+        item->window = malloc((size_t) item->windowLen);
+        if (item->window == NULL || fread(item->window, (size_t) item->windowLen, 1, fp) != 1) {
+          free(item->window);
+          returnValue = FALSE;
+        }
+      }
+      if (returnValue == TRUE) {
+        (*value)->numIndex++;
+      }
+    }
+  }
+  fclose(fp);
+
+  if (returnValue == FALSE) {
+    replayIndexFree(value);
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          replayIndexWrite
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes the index file beside the log. The file is
+*  written under a temporary name and renamed so a reader
+*  never sees half of one. Returns if it was written
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIndexWrite(replay *value) {
+  char indexName[FILENAME_MAX]; /* Index file name */
+  char tmpName[FILENAME_MAX];   /* Name written to first */
+  BYTE header[REPLAY_INDEX_HEADER_SIZE]; /* Index header */
+  BYTE data[REPLAY_INDEX_ENTRY_SIZE];    /* Index entry */
+  struct stat st;               /* Log file size and time */
+  replayIndexItem *item;        /* Entry being written */
+  FILE *fp;                     /* Index file */
+  int count;                    /* Looping variable */
+  bool returnValue;             /* Value to return */
+
+  if ((*value)->numIndex == 0 || replayIndexName((*value)->fileName, indexName) == FALSE || stat((*value)->fileName, &st) != 0) {
+    return FALSE;
+  }
+
+  memcpy(header, REPLAY_INDEX_ID, REPLAY_INDEX_ID_LEN);
+  header[REPLAY_INDEX_ID_LEN] = REPLAY_INDEX_VERSION;
+  replayPutLong(header + REPLAY_INDEX_ID_LEN + 1, 4, (unsigned long) st.st_size);
+  replayPutLong(header + REPLAY_INDEX_ID_LEN + 5, 4, (unsigned long) st.st_mtime);
+  replayPutLong(header + REPLAY_INDEX_ID_LEN + 9, 4, (*value)->numTicks);
+  header[REPLAY_INDEX_ID_LEN + 13] = (BYTE) ((*value)->complete == TRUE ? REPLAY_INDEX_COMPLETE : 0);
+  replayPutLong(header + REPLAY_INDEX_ID_LEN + 14, 4, (unsigned long) (*value)->numIndex);
+
+  if (snprintf(tmpName, sizeof(tmpName), "%s.tmp", indexName) >= (int) sizeof(tmpName)) {
+    return FALSE;
+  }
+  fp = fopen(tmpName, "wb");
+  if (fp == NULL) {
+    return FALSE;
+  }
+  returnValue = (bool) (fwrite(header, REPLAY_INDEX_HEADER_SIZE, 1, fp) == 1);
+  for (count = 0; count < (*value)->numIndex && returnValue == TRUE; count++) {
+    item = &(*value)->index[count];
+    replayPutLong(data, 4, item->tick);
+    data[4] = item->key;
+    replayPutLong(data + 5, 4, item->offset);
+    replayPutLong(data + 9, 4, item->in);
+    data[13] = item->bits;
+    replayPutLong(data + 14, 4, item->out);
+    replayPutLong(data + 18, 4, item->windowLen);
+    if (fwrite(data, REPLAY_INDEX_ENTRY_SIZE, 1, fp) != 1 || (item->windowLen > 0 && fwrite(item->window, (size_t) item->windowLen, 1, fp) != 1)) {
+      returnValue = FALSE;
+    }
+  }
+  if (fclose(fp) != 0) {
+    returnValue = FALSE;
+  }
+  if (returnValue == TRUE) {
+#ifdef _WIN32
+    /* rename will not replace a file on Windows */
+    remove(indexName);
+#endif
+    if (rename(tmpName, indexName) != 0) {
+      returnValue = FALSE;
+    }
+  }
+  if (returnValue == FALSE) {
+    remove(tmpName);
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          replayIsIndexed
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns if the log has been indexed
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIsIndexed(replay *value) {
+  return (bool) ((*value)->numIndex > 0);
+}
+
+/*********************************************************
+*NAME:          replayGetNumSnapshots
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the number of snapshots in the index
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+int replayGetNumSnapshots(replay *value) {
+  return (*value)->numIndex;
+}
+
+/*********************************************************
+*NAME:          replayIsComplete
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns if the indexed log ends with its quit record.
+*  Logs of servers that didn't shut down are cut short
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIsComplete(replay *value) {
+  return (*value)->complete;
+}
+
+/*********************************************************
+*NAME:          replayStep
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Plays the next tick. Returns FALSE at the end of the
+*  log or if it is damaged
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayStep(replay *value) {
+  int record; /* Record read */
+
+  if ((*value)->fp == NULL) {
+    return FALSE;
+  }
+  (*value)->eventsLen = 0;
+  if ((*value)->emptyLeft > 0) {
+    (*value)->emptyLeft--;
+    (*value)->tick++;
+    return TRUE;
+  }
+
+  /* Snapshots happen between ticks */
+  do {
+    if ((*value)->finished == TRUE || (*value)->failed == TRUE) {
+      return FALSE;
+    }
+    record = replayReadRecord(value);
+  } while (record == LOG_EVENT_SNAPSHOT);
+
+  if (record == LOG_NOEVENTS || record == LOG_NOEVENTS_LONG || record == LOG_EVENT || record == LOG_EVENT_LONG) {
+    (*value)->tick++;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/*********************************************************
+*NAME:          replaySeek
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Moves to just after a tick has been played, with that
+*  tick's events. Without an index this plays forward,
+*  from the start if the tick has already passed. Returns
+*  FALSE if the log ends first or is damaged
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*  tick  - Tick to move to
+*********************************************************/
+bool replaySeek(replay *value, unsigned long tick) {
+  BYTE dict[REPLAY_WINDOW_SIZE]; /* Output before the block */
+  uLongf dictLen;                /* Length of dict */
+  replayIndexItem *item;         /* Snapshot to start from */
+  int first;                     /* Binary search range */
+  int last;
+  int middle;
+  bool returnValue;              /* Value to return */
+
+  if ((*value)->fp == NULL) {
+    return FALSE;
+  }
+
+  /* The last snapshot before the tick, so the tick itself
+     is played and has its events */
+  item = NULL;
+  first = 0;
+  last = (*value)->numIndex - 1;
+  while (first <= last) {
+    middle = (first + last) / 2;
+    if ((*value)->index[middle].tick < tick || (*value)->index[middle].tick == 0) {
+      item = &(*value)->index[middle];
+      first = middle + 1;
+    } else {
+      last = middle - 1;
+    }
+  }
+
+  returnValue = TRUE;
+  if (tick == (*value)->tick && (*value)->failed == FALSE) {
+    return TRUE;
+  } else if (item != NULL && (tick < (*value)->tick || item->tick > (*value)->tick)) {
+    /* Start inflating at the block before the snapshot and
+       skip to it */
+    dictLen = REPLAY_WINDOW_SIZE;
+    if (item->windowLen > 0 && uncompress(dict, &dictLen, item->window, item->windowLen) != Z_OK) {
+      returnValue = FALSE;
+    } else if (replayStreamStart(value, item->in, item->bits, item->out, dict, item->windowLen > 0 ? (unsigned int) dictLen : 0) == FALSE) {
+      returnValue = FALSE;
+    } else if (replayStreamRead(value, NULL, item->offset - item->out) == FALSE) {
+      returnValue = FALSE;
+    } else {
+      (*value)->key = item->key;
+      (*value)->tick = item->tick;
+      (*value)->emptyLeft = 0;
+      (*value)->eventsLen = 0;
+      (*value)->finished = FALSE;
+      returnValue = (bool) (replayReadRecord(value) == LOG_EVENT_SNAPSHOT);
+    }
+    if (returnValue == FALSE) {
+      (*value)->failed = TRUE;
+    }
+  } else if (tick < (*value)->tick || (*value)->failed == TRUE) {
+    returnValue = replayRewind(value);
+  }
+
+  while (returnValue == TRUE && (*value)->tick < tick) {
+    returnValue = replayStep(value);
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          replayGetTick
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the number of ticks played
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+unsigned long replayGetTick(replay *value) {
+  return (*value)->tick;
+}
+
+/*********************************************************
+*NAME:          replayGetNumTicks
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the number of ticks in the log, or 0 if it
+*  hasn't been indexed
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+unsigned long replayGetNumTicks(replay *value) {
+  return (*value)->numTicks;
+}
+
+/*********************************************************
+*NAME:          replayIsFailed
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns if playing stopped because the log is damaged
+*  rather than because it ended
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIsFailed(replay *value) {
+  return (*value)->failed;
+}
+
+/*********************************************************
+*NAME:          replayGetHeader
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the log header
+*
+*ARGUMENTS:
+*  value  - Pointer to the replay
+*  header - Structure to fill in
+*********************************************************/
+void replayGetHeader(replay *value, replayHeader *header) {
+  *header = (*value)->header;
+}
+
+/*********************************************************
+*NAME:          replayGetPlayer
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets a player
+*
+*ARGUMENTS:
+*  value     - Pointer to the replay
+*  playerNum - Player to get
+*  item      - Structure to fill in
+*********************************************************/
+void replayGetPlayer(replay *value, BYTE playerNum, replayPlayer *item) {
+  if (playerNum < MAX_TANKS) {
+    *item = (*value)->plrs[playerNum];
+  } else {
+    memset(item, 0, sizeof(*item));
+  }
+}
+
+/*********************************************************
+*NAME:          replayGetMap
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the map. It belongs to the replay
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+map *replayGetMap(replay *value) {
+  return &(*value)->mp;
+}
+
+/*********************************************************
+*NAME:          replayGetPills
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the pillboxes. They belong to the replay
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+pillboxes *replayGetPills(replay *value) {
+  return &(*value)->pb;
+}
+
+/*********************************************************
+*NAME:          replayGetBases
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the bases. They belong to the replay
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bases *replayGetBases(replay *value) {
+  return &(*value)->bs;
+}
+
+/*********************************************************
+*NAME:          replayGetStarts
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the starts. They belong to the replay
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+starts *replayGetStarts(replay *value) {
+  return &(*value)->ss;
+}
+
+/*********************************************************
+*NAME:          replayGetTimes
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the start delay and game time left in ticks as of
+*  the last snapshot
+*
+*ARGUMENTS:
+*  value      - Pointer to the replay
+*  startDelay - Start delay
+*  timeLeft   - Time left
+*********************************************************/
+void replayGetTimes(replay *value, unsigned long *startDelay, unsigned long *timeLeft) {
+  *startDelay = (*value)->startDelay;
+  *timeLeft = (*value)->timeLeft;
+}
+
+/*********************************************************
+*NAME:          replayGetEvent
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets an event from the tick just played. Start pos at
+*  0. Returns FALSE when there are no more
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*  pos   - Position in the tick's events
+*  ev    - Event to fill in
+*********************************************************/
+bool replayGetEvent(replay *value, int *pos, replayEvent *ev) {
+  BYTE *data; /* Event in the buffer */
+  int len;    /* Options in the event */
+  bool hasText; /* Does a string follow */
+
+  if (*pos >= (*value)->eventsLen) {
+    return FALSE;
+  }
+  data = (*value)->events + *pos;
+  len = replayEventLength(data[0], &hasText);
+  memset(ev, 0, sizeof(*ev));
+  ev->item = (logitem) data[0];
+  memcpy(ev->opt, data + 1, (size_t) len);
+  len++;
+  if (hasText == TRUE) {
+    replayPString(data + len, ev->text, REPLAY_MAX_EVENT);
+    len += data[len] + 1;
+  }
+  *pos += len;
+  return TRUE;
+}
@@ -0,0 +1,540 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Replay
+*Filename:      replay.h
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Plays back WinBolo log files without a screen. A log is
+*  one deflate stream of ticks with a snapshot of the whole
+*  game every time something has happened in the last 600
+*  ticks.
+*
+*  Scanning a log once finds each snapshot and the deflate
+*  block boundary before it, with the 32K of output the
+*  block can refer back to. These are kept in an index file
+*  beside the log. Seeking starts inflating at the boundary
+*  before the nearest earlier snapshot, loads the snapshot
+*  and plays forward, so it costs at most one snapshot
+*  interval however long the log is.
+*
+*  The zip local header is read directly rather than
+*  through the central directory so logs cut short by a
+*  server that didn't shut down still play.
+*********************************************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+#include "global.h"
+#include "backend.h"
+#include "bolo_map.h"
+#include "pillbox.h"
+#include "bases.h"
+#include "starts.h"
+#include "log.h"
+
+/* Index file id, version and extension. The extension
+   replaces .wbv or is added if the name has none */
+#define REPLAY_INDEX_ID "WBVINDEX"
+#define REPLAY_INDEX_ID_LEN 8
+#define REPLAY_INDEX_VERSION 1
+#define REPLAY_INDEX_EXT ".wbi"
+
+/* Index header. Id, version, four byte log file size and
+   time, four byte number of ticks, flags and four byte
+   number of entries. All little endian */
+#define REPLAY_INDEX_HEADER_SIZE (REPLAY_INDEX_ID_LEN + 1 + 4 + 4 + 4 + 1 + 4)
+
+/* Index entry. Four byte tick, key, four byte snapshot
+   offset, four byte compressed offset, bit count, four
+   byte output offset and four byte window length followed
+   by the window compressed with zlib */
+#define REPLAY_INDEX_ENTRY_SIZE (4 + 1 + 4 + 4 + 1 + 4 + 4)
+
+/* Index header flags */
+#define REPLAY_INDEX_COMPLETE 1 /* The log ends with a quit */
+
+/* Deflate history and the compressed bytes read at once */
+#define REPLAY_WINDOW_SIZE 32768
+#define REPLAY_IN_SIZE 16384
+
+/* Milliseconds per logged tick. The log is written every
+   server tick */
+#define REPLAY_TICK_LENGTH (GAME_TICK_LENGTH * 2)
+#define REPLAY_TICKS_SEC (1000 / REPLAY_TICK_LENGTH)
+
+/* Zip local file header */
+#define REPLAY_ZIP_HEADER_SIZE 30
+#define REPLAY_ZIP_SIGNATURE 0x04034B50UL
+#define REPLAY_ZIP_DEFLATED 8
+
+/* Largest event, item, five options and a string */
+#define REPLAY_MAX_EVENT (1 + 5 + 256)
+
+/* Log header */
+typedef struct {
+  char mapName[MAP_STR_SIZE]; /* Map name */
+  BYTE gameType;              /* Game type */
+  bool hiddenMines;           /* Are hidden mines allowed */
+  BYTE ai;                    /* Brains allowed */
+  bool password;              /* Was the game password protected */
+  BYTE maxPlayers;            /* Most players allowed */
+  BYTE version[3];            /* Server major, minor and revision */
+  BYTE address[4];            /* Server address */
+  unsigned short port;        /* Server port */
+  unsigned long startTime;    /* Time the game was created */
+  int longSize;               /* Bytes the server wrote for a long */
+} replayHeader;
+
+/* A player */
+typedef struct {
+  bool inUse;                 /* Is the player in the game */
+  char name[PLAYER_NAME_LEN]; /* Player name */
+  BYTE mx;                    /* Tank map position */
+  BYTE my;
+  BYTE px;                    /* Tank pixel position */
+  BYTE py;
+  BYTE dir;                   /* Tank direction, 0 to 15 */
+  bool onBoat;                /* Is the tank on a boat */
+} replayPlayer;
+
+/* An event from the current tick */
+typedef struct {
+  logitem item;                   /* Event */
+  BYTE opt[5];                    /* Options in the order logged */
+  char text[REPLAY_MAX_EVENT];    /* Name or message, empty if none */
+} replayEvent;
+
+/* A snapshot and where to start inflating to reach it */
+typedef struct {
+  unsigned long tick;      /* Ticks played before it */
+  unsigned long offset;    /* Uncompressed offset */
+  BYTE key;                /* Key it was written with */
+  unsigned long in;        /* Compressed offset of the block before it */
+  BYTE bits;               /* Bits of the byte before in still to use */
+  unsigned long out;       /* Uncompressed offset of the block */
+  BYTE *window;            /* Output before the block, compressed */
+  unsigned long windowLen; /* Length of window */
+} replayIndexItem;
+
+/* Where a deflate block starts */
+typedef struct {
+  unsigned long in;                /* Compressed offset */
+  BYTE bits;                       /* Bits of the byte before in still to use */
+  unsigned long out;               /* Uncompressed offset */
+  BYTE window[REPLAY_WINDOW_SIZE]; /* Output before it */
+  unsigned int windowLen;          /* Bytes of window used */
+} replayBlock;
+
+typedef struct replayObj *replay;
+
+struct replayObj {
+  FILE *fp;                        /* The log file */
+  char fileName[FILENAME_MAX];     /* Its name */
+  unsigned long dataStart;         /* File offset of the deflate stream */
+
+  struct z_stream_s *strm;         /* Inflate stream. Not kept in here as
+                                      types.h leaves structures packed */
+  bool strmOpen;                   /* Has strm been initialised */
+  BYTE in[REPLAY_IN_SIZE];         /* Compressed bytes */
+  unsigned long inRead;            /* Compressed bytes read so far */
+  BYTE window[REPLAY_WINDOW_SIZE]; /* Output, written round and round */
+  unsigned int outPos;             /* Next byte of window to read */
+  unsigned int outEnd;             /* End of the output in window */
+  unsigned long outTotal;          /* Uncompressed offset of outEnd */
+  bool streamEnd;                  /* No more output */
+  bool failed;                     /* The log is damaged */
+
+  bool indexing;                   /* Is the log being scanned */
+  replayBlock blocks[2];           /* Block boundaries */
+  int blockNow;                    /* Last boundary read past */
+  bool blockAhead;                 /* Is the other one a boundary not read up to */
+  bool blockFailed;                /* Out of memory building the index */
+
+  BYTE key;                        /* Current key */
+  unsigned long tick;              /* Ticks played */
+  unsigned short emptyLeft;        /* Empty ticks left in the last record */
+  bool finished;                   /* The quit has been read */
+  BYTE events[LOG_MEMORY_BUFFER_SIZE]; /* This tick's events, not XORed */
+  int eventsLen;                   /* Length of events */
+
+  replayHeader header;             /* Log header */
+  unsigned long startDelay;        /* Start delay at the last snapshot */
+  unsigned long timeLeft;          /* Time left at the last snapshot */
+  map mp;                          /* Map */
+  pillboxes pb;                    /* Pillboxes */
+  bases bs;                        /* Bases */
+  starts ss;                       /* Starts */
+  replayPlayer plrs[MAX_TANKS];    /* Players */
+
+  replayIndexItem *index;          /* Snapshots found */
+  int numIndex;                    /* Number of snapshots */
+  int sizeIndex;                   /* Room in index */
+  unsigned long numTicks;          /* Ticks in the log once indexed */
+  bool complete;                   /* Does the log end with a quit */
+};
+
+/* Prototypes */
+
+/*********************************************************
+*NAME:          replayCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates a replay with no log open
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+void replayCreate(replay *value);
+
+/*********************************************************
+*NAME:          replayDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Closes any open log and frees the replay
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+void replayDestroy(replay *value);
+
+/*********************************************************
+*NAME:          replayOpen
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Opens a log and reads its header and first snapshot,
+*  leaving the replay at tick 0. Returns FALSE if it is
+*  not a WinBolo log or is damaged
+*
+*ARGUMENTS:
+*  value    - Pointer to the replay
+*  fileName - Log file to open
+*********************************************************/
+bool replayOpen(replay *value, char *fileName);
+
+/*********************************************************
+*NAME:          replayClose
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Closes the log and drops its index
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+void replayClose(replay *value);
+
+/*********************************************************
+*NAME:          replayIndexName
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Makes the index file name for a log file. Returns
+*  FALSE if the name would not fit in FILENAME_MAX
+*
+*ARGUMENTS:
+*  fileName  - Log file name
+*  indexName - Buffer of FILENAME_MAX to hold the name
+*********************************************************/
+bool replayIndexName(char *fileName, char *indexName);
+
+/*********************************************************
+*NAME:          replayIndexBuild
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Scans the whole log for snapshots, then goes back to
+*  the tick the replay was at. Returns FALSE if the log
+*  is damaged or memory ran out
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIndexBuild(replay *value);
+
+/*********************************************************
+*NAME:          replayIndexRead
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Loads the index file beside the log. It is only used
+*  if the log is the size and age it was when the index
+*  was written. Returns FALSE if there is no usable index
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIndexRead(replay *value);
+
+/*********************************************************
+*NAME:          replayIndexWrite
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Writes the index file beside the log. The file is
+*  written under a temporary name and renamed so a reader
+*  never sees half of one. Returns if it was written
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIndexWrite(replay *value);
+
+/*********************************************************
+*NAME:          replayIsIndexed
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns if the log has been indexed
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIsIndexed(replay *value);
+
+/*********************************************************
+*NAME:          replayGetNumSnapshots
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the number of snapshots in the index
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+int replayGetNumSnapshots(replay *value);
+
+/*********************************************************
+*NAME:          replayIsComplete
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns if the indexed log ends with its quit record.
+*  Logs of servers that didn't shut down are cut short
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIsComplete(replay *value);
+
+/*********************************************************
+*NAME:          replayStep
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Plays the next tick. Returns FALSE at the end of the
+*  log or if it is damaged
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayStep(replay *value);
+
+/*********************************************************
+*NAME:          replaySeek
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Moves to just after a tick has been played, with that
+*  tick's events. Without an index this plays forward,
+*  from the start if the tick has already passed. Returns
+*  FALSE if the log ends first or is damaged
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*  tick  - Tick to move to
+*********************************************************/
+bool replaySeek(replay *value, unsigned long tick);
+
+/*********************************************************
+*NAME:          replayGetTick
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the number of ticks played
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+unsigned long replayGetTick(replay *value);
+
+/*********************************************************
+*NAME:          replayGetNumTicks
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the number of ticks in the log, or 0 if it
+*  hasn't been indexed
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+unsigned long replayGetNumTicks(replay *value);
+
+/*********************************************************
+*NAME:          replayIsFailed
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns if playing stopped because the log is damaged
+*  rather than because it ended
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bool replayIsFailed(replay *value);
+
+/*********************************************************
+*NAME:          replayGetHeader
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the log header
+*
+*ARGUMENTS:
+*  value  - Pointer to the replay
+*  header - Structure to fill in
+*********************************************************/
+void replayGetHeader(replay *value, replayHeader *header);
+
+/*********************************************************
+*NAME:          replayGetPlayer
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets a player
+*
+*ARGUMENTS:
+*  value     - Pointer to the replay
+*  playerNum - Player to get
+*  item      - Structure to fill in
+*********************************************************/
+void replayGetPlayer(replay *value, BYTE playerNum, replayPlayer *item);
+
+/*********************************************************
+*NAME:          replayGetMap
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the map. It belongs to the replay
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+map *replayGetMap(replay *value);
+
+/*********************************************************
+*NAME:          replayGetPills
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the pillboxes. They belong to the replay
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+pillboxes *replayGetPills(replay *value);
+
+/*********************************************************
+*NAME:          replayGetBases
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the bases. They belong to the replay
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+bases *replayGetBases(replay *value);
+
+/*********************************************************
+*NAME:          replayGetStarts
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the starts. They belong to the replay
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*********************************************************/
+starts *replayGetStarts(replay *value);
+
+/*********************************************************
+*NAME:          replayGetTimes
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the start delay and game time left in ticks as of
+*  the last snapshot
+*
+*ARGUMENTS:
+*  value      - Pointer to the replay
+*  startDelay - Start delay
+*  timeLeft   - Time left
+*********************************************************/
+void replayGetTimes(replay *value, unsigned long *startDelay, unsigned long *timeLeft);
+
+/*********************************************************
+*NAME:          replayGetEvent
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets an event from the tick just played. Start pos at
+*  0. Returns FALSE when there are no more
+*
+*ARGUMENTS:
+*  value - Pointer to the replay
+*  pos   - Position in the tick's events
+*  ev    - Event to fill in
+*********************************************************/
+bool replayGetEvent(replay *value, int *pos, replayEvent *ev);
+
+#endif /* REPLAY_H */
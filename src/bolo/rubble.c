@@ -20,7 +20,7 @@
 *Filename:      rubble.c
 *Author:        John Morrison
 *Creation Date: 30/12/98
-*Last Modified: 25/04/01
+*Last Modified: 16/10/26
 *Purpose:
 *  Responsable for tracking lifetime of rubble.
 *  buildings can be shot 5 times before being destroyed
@@ -29,47 +29,11 @@
 #include "global.h"
 #include "rubble.h"
 
-/*********************************************************
-*NAME:          rubbleCreate
-*AUTHOR:        John Morrison
-*CREATION DATE: 30/12/98
-*LAST MODIFIED: 30/12/98
-*PURPOSE:
-*  Sets up the rubble data structure
-*
-*ARGUMENTS:
-*  rbl - Pointer to the rubbble object
-*********************************************************/
-void rubbleCreate(rubble *rbl) {
-  *rbl = NULL;
-}
-
-/*********************************************************
-*NAME:          rubbleDestroy
-*AUTHOR:        John Morrison
-*CREATION DATE: 30/12/98
-*LAST MODIFIED: 30/12/98
-*PURPOSE:
-*  Destroys and frees memory for the rubble data structure
-*
-*ARGUMENTS:
-*  rbl - Pointer to the rubbble object
-*********************************************************/
-void rubbleDestroy(rubble *rbl) {
-  rubble q;
-
-  while (!IsEmpty(*rbl)) {
-    q = *rbl;
-    *rbl = RubbleTail(q);
-    Dispose(q);
-  }
-}
-
 /*********************************************************
 *NAME:          rubbleAddItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/12/98
-*LAST MODIFIED: 25/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Adds an item to the rubble data structure.
 *  If it already exists returns the terrain type of the
@@ -82,84 +46,19 @@ void rubbleDestroy(rubble *rbl) {
 *********************************************************/
 BYTE rubbleAddItem(rubble *rbl, BYTE x, BYTE y) {
   BYTE returnValue; /* Value to return */
-  bool found;       /* Is the item found */
-  int count;        /* Looping Variable */
-  rubble q;
-  rubble inc;
 
-  inc = *rbl;
-  found = FALSE;
   returnValue = RUBBLE;
-  count = 0;
-  
-  while (found == FALSE && NonEmpty(inc)) {
-    count++;
-    if (inc->x == x && inc->y == y) {
-      found = TRUE;
-      inc->life--;
-      if (inc->life == RUBBLE_DEATH) {
-        returnValue = RIVER;
-        rubbleDeleteItem(rbl, count);
-      } 
-    }
-    if (found == FALSE) {
-      inc = RubbleTail(inc);
-	  }
-  }
-
-  /* If not found add a new item */
-  if (found == FALSE) {
-    New (q);
-    q->x = x;
-    q->y = y;
-    q->life = RUBBLE_LIFE;
-    q->next = *rbl;
-    *rbl = q;
+  if (tileLifeAddItem(rbl, TILE_LIFE_RUBBLE, RUBBLE_LIFE, x, y) == TRUE) {
+    returnValue = RIVER;
   }
-
   return returnValue;
 }
 
-/*********************************************************
-*NAME:          rubbleDeleteItem
-*AUTHOR:        John Morrison
-*CREATION DATE: 30/12/98
-*LAST MODIFIED: 30/12/98
-*PURPOSE:
-*  Deletes the item for the given number
-*
-*ARGUMENTS:
-*  rbl     - Pointer to the rubbble object
-*  itemNum - The item number to get
-*********************************************************/
-void rubbleDeleteItem(rubble *rbl, int itemNum) {
-  rubble prev; /* The previous item to link to the delete items next */
-  rubble del;  /* The item to delete */
-  int count;   /* Looping variable */
-
-  if (itemNum == 1) {
-    del = *rbl;
-    *rbl = del->next;
-    Dispose(del);
-  } else {
-    count = 1;
-    prev = *rbl;
-    while (count < (itemNum-1)) {
-      prev = RubbleTail(prev);
-      count++;
-    }
-    del = RubbleTail(prev);
-    prev->next = del->next;
-    Dispose(del);
-  }
-}
-
-
 /*********************************************************
 *NAME:          rubbleRemovePos
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/1/99
-*LAST MODIFIED: 18/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Removes an item from the rubble data structure if it 
 *  exists at a specific loaction. Otherwise the function
@@ -171,24 +70,5 @@ void rubbleDeleteItem(rubble *rbl, int itemNum) {
 *  y   - Y co-ord
 *********************************************************/
 void rubbleRemovePos(rubble *rbl, BYTE x, BYTE y) {
-  bool found;       /* Is the item found */
-  int count;        /* Looping Variable */
-  rubble inc;
-
-  inc = *rbl;
-  found = FALSE;
-  count = 0;
-  
-  while (found == FALSE && NonEmpty(inc)) {
-    count++;
-    if (inc->x == x && inc->y == y) {
-      found = TRUE;
-    }
-    inc = RubbleTail(inc);
-  }
-
-  /* If found remove item */
-  if (found == TRUE) {
-    rubbleDeleteItem(rbl, count);
-  }
+  tileLifeRemovePos(rbl, TILE_LIFE_RUBBLE, x, y);
 }
@@ -20,7 +20,7 @@
 *Filename:      rubble.h
 *Author:        John Morrison
 *Creation Date: 30/12/98
-*Last Modified: 30/12/98
+*Last Modified: 16/10/26
 *Purpose:
 *  Responsable for tracking lifetime of rubble.
 *  buildings can be shot 5 times before being destroyed
@@ -30,14 +30,11 @@
 #define RUBBLE_H
 
 #include "global.h"
+#include "tilelife.h"
 
-/* Empty / Non Empty / Head / Tail Macros */
+/* Empty / Non Empty Macros */
 #define IsEmpty(list) ((list) ==NULL)
 #define NonEmpty(list) (!IsEmpty(list))
-#define RubbleHeadX(list) ((list)->x);
-#define RubbleHeadY(list) ((list)->y);
-#define RubbleHeadLength(list) ((list)->life);
-#define RubbleTail(list) ((list)->next);
 
 /* How manu shots it takes to destroy a building */
 #define RUBBLE_LIFE 4
@@ -47,47 +44,17 @@
 
 /* Type structure */
 
-typedef struct rubbleObj *rubble;
-struct rubbleObj {
-  rubble next; /* Next item */ 
-  BYTE x;      /* X and Y positions */
-  BYTE y;
-  BYTE life;   /* Life time of the rubble */
-};
+/* Damage is kept in the tile life layer shared with the other
+   terrain types */
+typedef tileLife rubble;
 
 /* Prototypes */
 
-/*********************************************************
-*NAME:          rubbleCreate
-*AUTHOR:        John Morrison
-*CREATION DATE: 30/12/98
-*LAST MODIFIED: 30/12/98
-*PURPOSE:
-*  Sets up the rubble data structure
-*
-*ARGUMENTS:
-*  rbl - Pointer to the rubbble object
-*********************************************************/
-void rubbleCreate(rubble *rbl);
-
-/*********************************************************
-*NAME:          rubbleDestroy
-*AUTHOR:        John Morrison
-*CREATION DATE: 30/12/98
-*LAST MODIFIED: 30/12/98
-*PURPOSE:
-*  Destroys and frees memory for the rubble data structure
-*
-*ARGUMENTS:
-*  rbl - Pointer to the rubbble object
-*********************************************************/
-void rubbleDestroy(rubble *rbl);
-
 /*********************************************************
 *NAME:          rubbleAddItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/12/98
-*LAST MODIFIED: 25/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Adds an item to the rubble data structure.
 *  If it already exists returns the terrain type of the
@@ -100,25 +67,11 @@ void rubbleDestroy(rubble *rbl);
 *********************************************************/
 BYTE rubbleAddItem(rubble *rbl, BYTE x, BYTE y);
 
-/*********************************************************
-*NAME:          rubbleDeleteItem
-*AUTHOR:        John Morrison
-*CREATION DATE: 30/12/98
-*LAST MODIFIED: 30/12/98
-*PURPOSE:
-*  Deletes the item for the given number
-*
-*ARGUMENTS:
-*  rbl     - Pointer to the rubbble object
-*  itemNum - The item number to get
-*********************************************************/
-void rubbleDeleteItem(rubble *rbl, int itemNum);
-
 /*********************************************************
 *NAME:          rubbleRemovePos
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/1/99
-*LAST MODIFIED: 18/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Removes an item from the rubble data structure if it 
 *  exists at a specific loaction. Otherwise the function
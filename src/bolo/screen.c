@@ -20,7 +20,7 @@
 *Filename:      screen.c
 *Author:        John Morrison
 *Creation Date: 28/10/98
-*Last Modified: 17/12/03
+*Last Modified: 16/10/26
 *Purpose:
 *  Provides Interfaces with the front end
 *********************************************************/
@@ -72,6 +72,7 @@
 #include "backend.h"
 #include "netmt.h"
 #include "netpnb.h"
+#include "netjoin.h"
 #include "../gui/netclient.h"
 #include "screen.h"
 
@@ -87,17 +88,27 @@ tank mytk = NULL;
 shells myshs = NULL;
 lgm mylgman = NULL;
 players plyrs = NULL;
-building clientBlds = NULL;
 explosions clientExpl = NULL;
+BYTE clientExplTime = 0; /* Ticks since explosions were updated */
 floodFill clientFF = NULL;
-grass clientGrass = NULL;
 mines clientMines = NULL;
 minesExp clientMinesExp = NULL;
-rubble clientRubble = NULL;
-swamp clientSwamp = NULL;
+tileLife clientTileLife = NULL;
 tkExplosion clientTankExplosions = NULL;
+BYTE clientTankExpTime = 0; /* Ticks since tank explosions were updated */
 netPnbContext clientPNB = NULL;
 netMntContext clientNMT = NULL;
+posDeltaFrame clientPosFrame; /* Last positions from the server */
+screenArena clientArena = NULL; /* Lists built each frame */
+
+/* Terrain tile of every map square as drawn, ignoring any
+   pill or base on it. Brought up to date by
+   screenUpdateTiles */
+BYTE screenTiles[MAP_ARRAY_SIZE][MAP_ARRAY_SIZE];
+BYTE screenTilesNumBases = 0;      /* Bases the tiles were worked out with */
+BYTE screenTilesBaseX[MAX_BASES];
+BYTE screenTilesBaseY[MAX_BASES];
+
 gameType myGame;
 
 /* The offset from the top and left of the map */
@@ -148,7 +159,7 @@ int cursorPosX, cursorPosY;
 *NAME:          screenSetup
 *AUTHOR:        John Morrison
 *CREATION DATE: 28/10/98
-*LAST MODIFIED: 05/05/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Sets up all the variables - Should be run when the
 *  program starts.
@@ -180,11 +191,8 @@ void screenSetup(gameType game, bool hiddenMines, int srtDelay, long gmeLen) {
   playersCreate(&plyrs);
   myshs = shellsCreate();
   explosionsCreate(&clientExpl);
-  rubbleCreate(&clientRubble);
-  buildingCreate(&clientBlds);
+  tileLifeCreate(&clientTileLife);
   messageCreate();
-  grassCreate(&clientGrass);
-  swampCreate(&clientSwamp);
   mylgman = lgmCreate(0);
   floodCreate(&clientFF);
   tkExplosionCreate(&clientTankExplosions);
@@ -192,9 +200,10 @@ void screenSetup(gameType game, bool hiddenMines, int srtDelay, long gmeLen) {
   treeGrowCreate();
   netPNBCreate(&clientPNB);
   netMNTCreate(&clientNMT);
+  memset(&clientPosFrame, 0, sizeof(clientPosFrame));
   pillsCreate(&mypb);
-  logCreate();
   screenBrainMapCreate();
+  clientArena = screenArenaCreate();
   brainHoldKeys = 0;
   brainTapKeys = 0;
   brainsWantAllies = 0;
@@ -225,7 +234,6 @@ void screenSetup(gameType game, bool hiddenMines, int srtDelay, long gmeLen) {
 *
 *********************************************************/
 void screenDestroy() {
-  logDestroy();
   screenGameRunning = FALSE;
   tankDestroy(&mytk, &mymp, &mypb, &mybs);
   mytk = NULL; 
@@ -234,17 +242,14 @@ void screenDestroy() {
   basesDestroy(&mybs);
   shellsDestroy(&myshs);
   explosionsDestroy(&clientExpl);
-  rubbleDestroy(&clientRubble);
-  buildingDestroy(&clientBlds );
+  tileLifeDestroy(&clientTileLife);
   messageDestroy();
-  grassDestroy(&clientGrass);
   netPNBDestroy(&clientPNB);
   netNMTDestroy(&clientNMT);
   floodDestroy(&clientFF);
   lgmDestroy(&mylgman);
-  swampDestroy(&clientSwamp);
-  clientSwamp = NULL;
   screenBrainMapDestroy();
+  screenArenaDestroy(&clientArena);
   tkExplosionDestroy(&clientTankExplosions);
   minesExpDestroy(&clientMinesExp);
   treeGrowDestroy();
@@ -331,8 +336,9 @@ void screenUpdate(updateType value) {
 //    cursorPosY++;
   }
 
+  screenArenaReset(&clientArena);
   screenLgmCreate(&lgms);
-  sBullets = screenBulletsCreate();
+  screenBulletsCreate(&sBullets, clientArena);
   screenTanksCreate(&scnTnk);
 
 
@@ -492,7 +498,7 @@ bool screenIsMine(screenMines *value,BYTE xValue, BYTE yValue) {
 *NAME:          screenUpdateView
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/10/98
-*LAST MODIFIED: 29/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Updates the values in the view area
 *
@@ -504,6 +510,7 @@ void screenUpdateView(updateType value) {
   BYTE count;   /* Looping Variables */
   BYTE count2;
 
+  screenUpdateTiles();
   for (count=0;count<MAIN_BACK_BUFFER_SIZE_X;count++) {
     for (count2=0;count2<MAIN_BACK_BUFFER_SIZE_Y;count2++) {
       (*view).screenItem[count][count2] = screenCalcSquare((BYTE) (count+xOffset),(BYTE) (count2+yOffset), count, count2);
@@ -512,30 +519,86 @@ void screenUpdateView(updateType value) {
   }
 }
 
+/*********************************************************
+*NAME:          screenUpdateTiles
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Brings screenTiles up to date with the map. Only the
+*  squares around those changed since the last call are
+*  worked out again, unless the map was loaded or the
+*  bases have moved which needs the whole map
+*
+*ARGUMENTS:
+*
+*********************************************************/
+void screenUpdateTiles(void) {
+  base item;     /* Base being checked */
+  bool all;      /* Work out every square */
+  BYTE numBases; /* Number of bases */
+  BYTE count;    /* Looping variables */
+  int x;
+  int y;
+  BYTE mx;       /* Changed square */
+  BYTE my;
+
+  all = mapTakeChangedAll(&mymp);
+
+  /* Squares next to a base are drawn as if it was road */
+  numBases = basesGetNumBases(&mybs);
+  if (numBases != screenTilesNumBases) {
+    all = TRUE;
+    screenTilesNumBases = numBases;
+  }
+  for (count=1;count<=numBases;count++) {
+    basesGetBase(&mybs, &item, count);
+    if (item.x != screenTilesBaseX[count-1] || item.y != screenTilesBaseY[count-1]) {
+      all = TRUE;
+      screenTilesBaseX[count-1] = item.x;
+      screenTilesBaseY[count-1] = item.y;
+    }
+  }
+
+  if (all == TRUE) {
+    while (mapTakeChangedPos(&mymp, &mx, &my) == TRUE) {
+      /* Covered below */
+    }
+    for (x=0;x<MAP_ARRAY_SIZE;x++) {
+      for (y=0;y<MAP_ARRAY_SIZE;y++) {
+        screenTiles[x][y] = screenCalcTerrain((BYTE) x, (BYTE) y);
+      }
+    }
+  } else {
+    while (mapTakeChangedPos(&mymp, &mx, &my) == TRUE) {
+      for (x=-1;x<=1;x++) {
+        for (y=-1;y<=1;y++) {
+          screenTiles[(BYTE) (mx+x)][(BYTE) (my+y)] = screenCalcTerrain((BYTE) (mx+x), (BYTE) (my+y));
+        }
+      }
+    }
+  }
+}
+
 /*********************************************************
 *NAME:          screenCalcSquare
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/10/98
-*LAST MODIFIED: 30/01/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Calculates the terrain type for a given location
+*  Calculates the terrain type for a given location. The
+*  terrain comes from screenTiles so screenUpdateTiles
+*  must have been called since the map last changed
 *
 *ARGUMENTS:
 *  xValue - The x co-ordinate
 *  yValue - The y co-ordinate
+*  scrX   - The x co-ordinate in the view
+*  scrY   - The y co-ordinate in the view
 *********************************************************/
 BYTE screenCalcSquare(BYTE xValue, BYTE yValue, BYTE scrX, BYTE scrY) {
   baseAlliance ba;  /* The allience of a base */
   BYTE returnValue; /* Value to return */
-  BYTE currentPos;
-  BYTE aboveLeft;
-  BYTE above;
-  BYTE aboveRight;
-  BYTE leftPos;
-  BYTE rightPos;
-  BYTE belowLeft;
-  BYTE below;
-  BYTE belowRight;
 
   (*mineView).mineItem[scrX][scrY] = FALSE;
   /* Set up Items */
@@ -566,118 +629,148 @@ BYTE screenCalcSquare(BYTE xValue, BYTE yValue, BYTE scrX, BYTE scrY) {
       returnValue = BASE_EVIL;
     }
   }  else {
-    currentPos = mapGetPos(&mymp,xValue,yValue);
     if (mapIsMine(&mymp, xValue, yValue) == TRUE) {
       if (minesExistPos(&clientMines, xValue, yValue) == TRUE) {
         (*mineView).mineItem[scrX][scrY] = TRUE;
       }
-      if (currentPos != DEEP_SEA) {
-        currentPos = currentPos - MINE_SUBTRACT;
-      }
-    } else {
-      (*mineView).mineItem[scrX][scrY] = FALSE;
     }
+    returnValue = screenTiles[xValue][yValue];
+  }
+  return returnValue;
+}
 
-    if (basesExistPos(&mybs, (BYTE) (xValue-1), (BYTE) (yValue-1)) == TRUE) {
-      aboveLeft = ROAD;
-    } else {
-      aboveLeft = mapGetPos(&mymp,(BYTE) (xValue-1),(BYTE) (yValue-1));
-      if (aboveLeft >= MINE_START && aboveLeft <= MINE_END) {
-        aboveLeft = aboveLeft - MINE_SUBTRACT;
-      }
-    }
+/*********************************************************
+*NAME:          screenCalcTerrain
+*AUTHOR:        John Morrison
+*CREATION DATE: 29/10/98
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Calculates the terrain tile for a given location from
+*  it and the squares around it. Any pill or base on the
+*  square itself is ignored
+*
+*ARGUMENTS:
+*  xValue - The x co-ordinate
+*  yValue - The y co-ordinate
+*********************************************************/
+BYTE screenCalcTerrain(BYTE xValue, BYTE yValue) {
+  BYTE returnValue; /* Value to return */
+  BYTE currentPos;
+  BYTE aboveLeft;
+  BYTE above;
+  BYTE aboveRight;
+  BYTE leftPos;
+  BYTE rightPos;
+  BYTE belowLeft;
+  BYTE below;
+  BYTE belowRight;
 
-    if (basesExistPos(&mybs, xValue, (BYTE) (yValue-1)) == TRUE) {
-      above = ROAD;
-    } else {
-      above = mapGetPos(&mymp,xValue,(BYTE) (yValue-1));
-      if (above >= MINE_START && above <= MINE_END) {
-        above = above - MINE_SUBTRACT;
-      }
+  currentPos = mapGetPos(&mymp,xValue,yValue);
+  if (mapIsMine(&mymp, xValue, yValue) == TRUE) {
+    if (currentPos != DEEP_SEA) {
+      currentPos = currentPos - MINE_SUBTRACT;
     }
+  }
 
-    if (basesExistPos(&mybs, (BYTE) (xValue+1), (BYTE) (yValue-1)) == TRUE) {
-      aboveRight = ROAD;
-    } else {
-      aboveRight = mapGetPos(&mymp,(BYTE) (xValue+1),(BYTE) (yValue-1));
-      if (aboveRight >= MINE_START && aboveRight <= MINE_END) {
-        aboveRight = aboveRight - MINE_SUBTRACT;
-      }
+  if (basesExistPos(&mybs, (BYTE) (xValue-1), (BYTE) (yValue-1)) == TRUE) {
+    aboveLeft = ROAD;
+  } else {
+    aboveLeft = mapGetPos(&mymp,(BYTE) (xValue-1),(BYTE) (yValue-1));
+    if (aboveLeft >= MINE_START && aboveLeft <= MINE_END) {
+      aboveLeft = aboveLeft - MINE_SUBTRACT;
     }
+  }
 
-    if (basesExistPos(&mybs, (BYTE) (xValue-1), yValue) == TRUE) {
-      leftPos = ROAD;
-    } else {
-      leftPos = mapGetPos(&mymp,(BYTE) (xValue-1),yValue);
-      if (leftPos >= MINE_START && leftPos <= MINE_END) {
-        leftPos = leftPos - MINE_SUBTRACT;
-      }
+  if (basesExistPos(&mybs, xValue, (BYTE) (yValue-1)) == TRUE) {
+    above = ROAD;
+  } else {
+    above = mapGetPos(&mymp,xValue,(BYTE) (yValue-1));
+    if (above >= MINE_START && above <= MINE_END) {
+      above = above - MINE_SUBTRACT;
     }
+  }
 
-    if (basesExistPos(&mybs, (BYTE) (xValue+1), yValue) == TRUE) {
-      rightPos = ROAD;
-    } else {
-      rightPos = mapGetPos(&mymp,(BYTE) (xValue+1),yValue);
-      if (rightPos >= MINE_START && rightPos <= MINE_END) {
-        rightPos = rightPos - MINE_SUBTRACT;
-      }
+  if (basesExistPos(&mybs, (BYTE) (xValue+1), (BYTE) (yValue-1)) == TRUE) {
+    aboveRight = ROAD;
+  } else {
+    aboveRight = mapGetPos(&mymp,(BYTE) (xValue+1),(BYTE) (yValue-1));
+    if (aboveRight >= MINE_START && aboveRight <= MINE_END) {
+      aboveRight = aboveRight - MINE_SUBTRACT;
     }
+  }
 
-    if (basesExistPos(&mybs, (BYTE) (xValue-1), (BYTE) (yValue+1)) == TRUE) {
-      belowLeft = ROAD;
-    } else {
-      belowLeft = mapGetPos(&mymp,(BYTE) (xValue-1),(BYTE) (yValue+1));
-      if (belowLeft >= MINE_START && belowLeft <= MINE_END) {
-        belowLeft = belowLeft - MINE_SUBTRACT;
-      }
+  if (basesExistPos(&mybs, (BYTE) (xValue-1), yValue) == TRUE) {
+    leftPos = ROAD;
+  } else {
+    leftPos = mapGetPos(&mymp,(BYTE) (xValue-1),yValue);
+    if (leftPos >= MINE_START && leftPos <= MINE_END) {
+      leftPos = leftPos - MINE_SUBTRACT;
     }
+  }
 
+  if (basesExistPos(&mybs, (BYTE) (xValue+1), yValue) == TRUE) {
+    rightPos = ROAD;
+  } else {
+    rightPos = mapGetPos(&mymp,(BYTE) (xValue+1),yValue);
+    if (rightPos >= MINE_START && rightPos <= MINE_END) {
+      rightPos = rightPos - MINE_SUBTRACT;
+    }
+  }
 
-    if (basesExistPos(&mybs, xValue, (BYTE) (yValue+1)) == TRUE) {
-      below = ROAD;
-    } else {
-      below = mapGetPos(&mymp,xValue,(BYTE) (yValue+1));
-      if (below >= MINE_START && below <= MINE_END) {
-        below = below - MINE_SUBTRACT;
-      }
+  if (basesExistPos(&mybs, (BYTE) (xValue-1), (BYTE) (yValue+1)) == TRUE) {
+    belowLeft = ROAD;
+  } else {
+    belowLeft = mapGetPos(&mymp,(BYTE) (xValue-1),(BYTE) (yValue+1));
+    if (belowLeft >= MINE_START && belowLeft <= MINE_END) {
+      belowLeft = belowLeft - MINE_SUBTRACT;
     }
+  }
 
-    if (basesExistPos(&mybs, (BYTE) (xValue+1), (BYTE) (yValue+1)) == TRUE) {
-      belowRight = ROAD;
-    } else {
-      belowRight = mapGetPos(&mymp,(BYTE) (xValue+1),(BYTE) (yValue+1));
-      if (belowRight >= MINE_START && belowRight <= MINE_END) {
-        belowRight = belowRight - MINE_SUBTRACT;
-      }
+
+  if (basesExistPos(&mybs, xValue, (BYTE) (yValue+1)) == TRUE) {
+    below = ROAD;
+  } else {
+    below = mapGetPos(&mymp,xValue,(BYTE) (yValue+1));
+    if (below >= MINE_START && below <= MINE_END) {
+      below = below - MINE_SUBTRACT;
     }
+  }
 
-    switch (currentPos) {
-    case ROAD:
-      returnValue = screenCalcRoad(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
-      break;
-    case BUILDING:
-      returnValue = screenCalcBuilding(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
-      break;
-    case FOREST:
-      returnValue = screenCalcForest(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
-      break;
-    case RIVER:
-      returnValue = screenCalcRiver(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
-      break;
-    case DEEP_SEA:
-      returnValue = screenCalcDeepSea(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
-      break;
-    case BOAT:
-      returnValue = screenCalcBoat(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
-      break;
-    case CRATER:
-      returnValue = screenCalcCrater(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
-      break;
-    default:
-      returnValue = currentPos;
-      break;
+  if (basesExistPos(&mybs, (BYTE) (xValue+1), (BYTE) (yValue+1)) == TRUE) {
+    belowRight = ROAD;
+  } else {
+    belowRight = mapGetPos(&mymp,(BYTE) (xValue+1),(BYTE) (yValue+1));
+    if (belowRight >= MINE_START && belowRight <= MINE_END) {
+      belowRight = belowRight - MINE_SUBTRACT;
     }
   }
+
+  switch (currentPos) {
+  case ROAD:
+    returnValue = screenCalcRoad(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
+    break;
+  case BUILDING:
+    returnValue = screenCalcBuilding(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
+    break;
+  case FOREST:
+    returnValue = screenCalcForest(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
+    break;
+  case RIVER:
+    returnValue = screenCalcRiver(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
+    break;
+  case DEEP_SEA:
+    returnValue = screenCalcDeepSea(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
+    break;
+  case BOAT:
+    returnValue = screenCalcBoat(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
+    break;
+  case CRATER:
+    returnValue = screenCalcCrater(aboveLeft, above, aboveRight, leftPos, rightPos, belowLeft, below, belowRight);
+    break;
+  default:
+    returnValue = currentPos;
+    break;
+  }
   return returnValue;
 }
 
@@ -856,7 +949,7 @@ tankButton screenTranslateBrainButtons(bool *isShoot, bool isGameTick) {
 *AUTHOR:        John Morrison
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/10/98
-*LAST MODIFIED: 4/1/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  This function is called whenever a game tick occurs,
 *
@@ -892,12 +985,10 @@ void screenGameTick(tankButton tb, bool tankShoot, bool isBrain) {
   }
 
 
-  /* Check Tank CRC for changes */
-  if (threadsGetContext() == FALSE) {
-//    if (tankCheck(&mytk) == TRUE) {
-//      netMNTAdd(screenGetNetMnt(), NMNT_TANKHIT, playersGetSelf(screenGetPlayers()), playersGetSelf(screenGetPlayers()), 0xFF , 0xFF);
-//    }
-  }
+  /* Check Tank CRC for changes since the last tick and reseal it.
+     Done here rather than at the bottom so the ticks that return
+     early are still checked */
+  tankCheckIntegrity(&mytk);
 
   
   if (gmeStartDelay > 0) {
@@ -978,8 +1069,8 @@ void screenGameTick(tankButton tb, bool tankShoot, bool isBrain) {
   shellsUpdate(&myshs, &mymp, &mypb, &mybs, ta, 1, FALSE);
   lgmUpdate(&mylgman, &mymp, &mypb, &mybs, &mytk);
   test = &mylgman;
-  tkExplosionUpdate(&clientTankExplosions, &mymp, &mypb, &mybs, (lgm **) &test, 1);
-  explosionsUpdate(&clientExpl);
+  tkExplosionUpdate(&clientTankExplosions, &mymp, &mypb, &mybs, (lgm **) &test, 1, &clientTankExpTime);
+  explosionsUpdate(&clientExpl, &clientExplTime);
   minesExpUpdate(&clientMinesExp, &mymp, &mypb, &mybs, (lgm **) &(test), 1);
   floodUpdate(&clientFF, &mymp, &mypb, &mybs);
   treeGrowUpdate(&mymp, &mypb, &mybs);
@@ -1703,6 +1794,24 @@ void screenTankView() {
   screenCenterTank();
 }
 
+/*********************************************************
+*NAME:          screenGetViewOffset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the map square in the top left of the view. Lets
+* a frontend turn view positions into map positions.
+*
+*ARGUMENTS:
+*  x - Pointer to hold the X map position
+*  y - Pointer to hold the Y map position
+*********************************************************/
+void screenGetViewOffset(BYTE *x, BYTE *y) {
+  *x = xOffset;
+  *y = yOffset;
+}
+
 /*********************************************************
 *NAME:          screenPillView
 *AUTHOR:        John Morrison
@@ -2250,6 +2359,34 @@ void screenSetMapNetRun(BYTE *buff, BYTE yPos, int dataLen) {
   mapSetNetRun(&mymp, buff, yPos, dataLen);
 }
 
+/*********************************************************
+*NAME:          screenSetJoinData
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Sets the starts, bases, pills and map from a join blob.
+* Returns FALSE if the blob is damaged
+*
+*ARGUMENTS:
+*  buff - Compressed join blob
+*  len  - Length of the blob
+*********************************************************/
+bool screenSetJoinData(BYTE *buff, int len) {
+  static BYTE raw[NET_JOIN_RAW_SIZE]; /* Uncompressed blob */
+  netJoinData data;                   /* Parts of the blob */
+  bool returnValue;                   /* Value to return */
+
+  returnValue = netJoinTake(buff, len, raw, &data);
+  if (returnValue == TRUE) {
+    screenSetStartsNetData(data.starts, data.startsLen);
+    screenSetBaseNetData(data.bases, data.basesLen);
+    screenSetPillNetData(data.pills, data.pillsLen);
+    mapSetNetBlock(&mymp, data.mapBlock);
+  }
+  return returnValue;
+}
+
 /*********************************************************
 *NAME:          screenExtractPlayerData
 *AUTHOR:        John Morrison
@@ -2334,6 +2471,59 @@ void screenExtractPlayerData(BYTE *buff, int buffLen) {
   }
 }
 
+/*********************************************************
+*NAME:          screenExtractPlayerFrame
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Updates players from a frame of positions sent as a
+*  delta. Players that can be seen or have changed since
+*  the last frame are updated
+*
+*ARGUMENTS:
+*  frame - Positions we can see
+*********************************************************/
+void screenExtractPlayerFrame(posDeltaFrame *frame) {
+  posDeltaItem *item; /* Item being updated */
+  BYTE playerNum;     /* Looping variable */
+  BYTE myPlayerNum;
+  BYTE px;            /* Pixel X and Y position */
+  BYTE py;
+  BYTE onBoat;        /* Is player on boat */
+  BYTE frameNum;      /* Animation frame */
+  BYTE lgmPX;         /* Lgm Data */
+  BYTE lgmPY;
+  BYTE lgmFrame;
+  BYTE lgmObstructed;
+  WORLD wx;
+  WORLD wy;
+
+  myPlayerNum = playersGetSelf(screenGetPlayers());
+  playerNum = 0;
+  while (playerNum < MAX_TANKS) {
+    item = &frame->item[playerNum];
+    if (item->flags != 0 || memcmp(item, &clientPosFrame.item[playerNum], sizeof(posDeltaItem)) != 0) {
+      /* Blocks that can not be seen are zero which hides them */
+      utilGetNibbles(item->tank[2], &px, &py);
+      utilGetNibbles(item->tank[3], &onBoat, &frameNum);
+      utilGetNibbles(item->lgm[2], &lgmPX, &lgmPY);
+      utilGetNibbles(item->lgm[3], &lgmFrame, &lgmObstructed);
+      if (myPlayerNum != playerNum) {
+        playersUpdate(screenGetPlayers(), playerNum, item->tank[0], item->tank[1], px, py, frameNum, (bool) onBoat, item->lgm[0], item->lgm[1], lgmPX, lgmPY, lgmFrame);
+      } else if (item->flags & POS_DELTA_LGM) {
+        /* Put our lgm values in */
+        wx = (WORLD) ((item->lgm[0] << 8) + (lgmPX << 4));
+        wy = (WORLD) ((item->lgm[1] << 8) + (lgmPY << 4));
+        lgmPutWorld(&mylgman, wx, wy, lgmFrame);
+        lgmSetBrainObstructed(&mylgman, lgmObstructed);
+      }
+    }
+    playerNum++;
+  }
+  memcpy(&clientPosFrame, frame, sizeof(posDeltaFrame));
+}
+
 /*********************************************************
 *NAME:          screenExtractMapData
 *AUTHOR:        John Morrison
@@ -3833,7 +4023,7 @@ players *clientGetPlayers() {
 *
 *********************************************************/
 building *clientGetBuildings() {
-  return &clientBlds;
+  return &clientTileLife;
 }
 
 /*********************************************************
@@ -3878,7 +4068,7 @@ floodFill *clientGetFloodFill() {
 *
 *********************************************************/
 grass *clientGetGrass() {
-  return &clientGrass;
+  return &clientTileLife;
 }
 
 /*********************************************************
@@ -3923,7 +4113,7 @@ minesExp *clientGetMinesExp() {
 *
 *********************************************************/
 rubble *clientGetRubble() {
-  return &clientRubble;
+  return &clientTileLife;
 }
 
 /*********************************************************
@@ -3938,7 +4128,7 @@ rubble *clientGetRubble() {
 *
 *********************************************************/
 swamp *clientGetSwamp() {
-  return &clientSwamp;
+  return &clientTileLife;
 }
 
 /*********************************************************
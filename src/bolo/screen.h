@@ -49,6 +49,7 @@
 #include "tankexp.h"
 #include "netpnb.h"
 #include "netmt.h"
+#include "posdelta.h"
 
 /* Button Pressed - These are the valid items 
    that should be passed to this module*/
@@ -149,16 +150,52 @@ void screenUpdateView(updateType value);
 *NAME:          screenCalcSquare
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/10/98
-*LAST MODIFIED: 29/10/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Calculates the terrain type for a given location
+*  Calculates the terrain type for a given location. The
+*  terrain comes from screenTiles so screenUpdateTiles
+*  must have been called since the map last changed
 *
 *ARGUMENTS:
 *  xValue - The x co-ordinate
 *  yValue - The y co-ordinate
+*  scrX   - The x co-ordinate in the view
+*  scrY   - The y co-ordinate in the view
 *********************************************************/
 BYTE screenCalcSquare(BYTE xValue, BYTE yValue, BYTE scrX, BYTE scrY);
 
+/*********************************************************
+*NAME:          screenCalcTerrain
+*AUTHOR:        John Morrison
+*CREATION DATE: 29/10/98
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Calculates the terrain tile for a given location from
+*  it and the squares around it. Any pill or base on the
+*  square itself is ignored
+*
+*ARGUMENTS:
+*  xValue - The x co-ordinate
+*  yValue - The y co-ordinate
+*********************************************************/
+BYTE screenCalcTerrain(BYTE xValue, BYTE yValue);
+
+/*********************************************************
+*NAME:          screenUpdateTiles
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Brings screenTiles up to date with the map. Only the
+*  squares around those changed since the last call are
+*  worked out again, unless the map was loaded or the
+*  bases have moved which needs the whole map
+*
+*ARGUMENTS:
+*
+*********************************************************/
+void screenUpdateTiles(void);
+
 /*********************************************************
 *NAME:          screenReCalc
 *AUTHOR:        John Morrison
@@ -491,6 +528,21 @@ BYTE screenMakeMapTokenData(BYTE *buff);
 *********************************************************/
 void screenSetMapNetRun(BYTE *buff, BYTE yPos, int dataLen);
 
+/*********************************************************
+*NAME:          screenSetJoinData
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Sets the starts, bases, pills and map from a join blob.
+* Returns FALSE if the blob is damaged
+*
+*ARGUMENTS:
+*  buff - Compressed join blob
+*  len  - Length of the blob
+*********************************************************/
+bool screenSetJoinData(BYTE *buff, int len);
+
 /*********************************************************
 *NAME:          screenExtractPlayerData
 *AUTHOR:        John Morrison
@@ -505,6 +557,21 @@ void screenSetMapNetRun(BYTE *buff, BYTE yPos, int dataLen);
 *********************************************************/
 void screenExtractPlayerData(BYTE *buff, int buffLen);
 
+/*********************************************************
+*NAME:          screenExtractPlayerFrame
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Updates players from a frame of positions sent as a
+*  delta. Players that can be seen or have changed since
+*  the last frame are updated
+*
+*ARGUMENTS:
+*  frame - Positions we can see
+*********************************************************/
+void screenExtractPlayerFrame(posDeltaFrame *frame);
+
 /*********************************************************
 *NAME:          screenExtractMapData
 *AUTHOR:        John Morrison
@@ -0,0 +1,288 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Screen Arena
+*Filename:      screenarena.c
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Bump allocator for the lists built each frame or tick.
+*  Everything handed out is released at once by a reset
+*  at the frame boundary
+*********************************************************/
+
+#include <string.h>
+#include "global.h"
+#include "screenarena.h"
+
+#ifdef BOLO_PROFILE
+static unsigned long long screenArenaItems = 0;  /* Items handed out */
+static unsigned long long screenArenaResets = 0; /* Frames released */
+static unsigned long long screenArenaAllocs = 0; /* Heap allocations made */
+#endif
+
+/*********************************************************
+*NAME:          screenArenaRound
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Rounds a size up to the arena alignment
+*
+*ARGUMENTS:
+*  size - Size to round
+*********************************************************/
+static size_t screenArenaRound(size_t size) {
+  if (size == 0) {
+    size = 1;
+  }
+  return (size + SCREEN_ARENA_ALIGN - 1) & ~((size_t) SCREEN_ARENA_ALIGN - 1);
+}
+
+/*********************************************************
+*NAME:          screenArenaCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates an arena with an empty block of
+*  SCREEN_ARENA_SIZE bytes. Returns NULL on out of memory
+*
+*ARGUMENTS:
+*
+*********************************************************/
+screenArena screenArenaCreate(void) {
+  screenArena returnValue; /* Value to return */
+
+  New(returnValue);
+  if (returnValue != NULL) {
+    returnValue->block = emalloc(SCREEN_ARENA_SIZE);
+    if (returnValue->block == NULL) {
+      Dispose(returnValue);
+      return NULL;
+    }
+#ifdef BOLO_PROFILE
+    screenArenaAllocs++;
+#endif
+    returnValue->size = SCREEN_ARENA_SIZE;
+    returnValue->used = 0;
+    returnValue->last = 0;
+    returnValue->want = 0;
+    returnValue->spill = NULL;
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          screenArenaDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys and frees memory for an arena and everything
+*  handed out from it
+*
+*ARGUMENTS:
+*  value - Pointer to the arena
+*********************************************************/
+void screenArenaDestroy(screenArena *value) {
+  screenArenaSpill q; /* Spilled block being freed */
+
+  if (*value != NULL) {
+    while ((*value)->spill != NULL) {
+      q = (*value)->spill;
+      (*value)->spill = q->next;
+      Dispose(q);
+    }
+    Dispose((*value)->block);
+    Dispose(*value);
+    *value = NULL;
+  }
+}
+
+/*********************************************************
+*NAME:          screenArenaReset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Releases everything handed out since the last reset.
+*  If items spilled to the heap the block is regrown to
+*  hold them all so the next frame needs no allocations
+*
+*ARGUMENTS:
+*  value - Pointer to the arena
+*********************************************************/
+void screenArenaReset(screenArena *value) {
+  screenArenaSpill q; /* Spilled block being freed */
+  BYTE *block;        /* Regrown block */
+  size_t size;        /* Size of the regrown block */
+
+  if (*value == NULL) {
+    return;
+  }
+  while ((*value)->spill != NULL) {
+    q = (*value)->spill;
+    (*value)->spill = q->next;
+    Dispose(q);
+  }
+  if ((*value)->want > (*value)->size) {
+    size = (*value)->size;
+    while (size < (*value)->want) {
+      size *= 2;
+    }
+    block = emalloc(size);
+    if (block != NULL) {
+#ifdef BOLO_PROFILE
+      screenArenaAllocs++;
+#endif
+      Dispose((*value)->block);
+      (*value)->block = block;
+      (*value)->size = size;
+    }
+  }
+  (*value)->used = 0;
+  (*value)->last = 0;
+  (*value)->want = 0;
+#ifdef BOLO_PROFILE
+  screenArenaResets++;
+#endif
+}
+
+/*********************************************************
+*NAME:          screenArenaAlloc
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Hands out size bytes that stay valid until the next
+*  reset. Returns NULL on out of memory
+*
+*ARGUMENTS:
+*  value - Pointer to the arena
+*  size  - Number of bytes wanted
+*********************************************************/
+void *screenArenaAlloc(screenArena *value, size_t size) {
+  screenArenaSpill q;        /* Block for an item that does not fit */
+  void *returnValue = NULL;  /* Value to return */
+
+  size = screenArenaRound(size);
+  (*value)->want += size;
+  if ((*value)->size - (*value)->used >= size) {
+    (*value)->last = (*value)->used;
+    returnValue = (*value)->block + (*value)->used;
+    (*value)->used += size;
+  } else {
+    q = emalloc(offsetof(struct screenArenaSpillObj, data) + size);
+    if (q != NULL) {
+#ifdef BOLO_PROFILE
+      screenArenaAllocs++;
+#endif
+      q->next = (*value)->spill;
+      (*value)->spill = q;
+      returnValue = q->data;
+    }
+  }
+#ifdef BOLO_PROFILE
+  if (returnValue != NULL) {
+    screenArenaItems++;
+  }
+#endif
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          screenArenaGrow
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Like realloc for an item from the arena. The newest
+*  item is grown where it is if the block has room,
+*  otherwise it is copied to a new item. Returns NULL on
+*  out of memory leaving ptr untouched
+*
+*ARGUMENTS:
+*  value   - Pointer to the arena
+*  ptr     - Item to grow or NULL for a new one
+*  oldSize - Current size of ptr
+*  newSize - Size wanted
+*********************************************************/
+void *screenArenaGrow(screenArena *value, void *ptr, size_t oldSize, size_t newSize) {
+  void *returnValue; /* Value to return */
+
+  if (ptr == NULL) {
+    return screenArenaAlloc(value, newSize);
+  }
+  if (newSize <= oldSize) {
+    return ptr;
+  }
+  newSize = screenArenaRound(newSize);
+  if ((BYTE *) ptr == (*value)->block + (*value)->last && (*value)->last < (*value)->used && newSize <= (*value)->size - (*value)->last) {
+    /* Newest item in the block, extend it in place */
+    (*value)->want += newSize - ((*value)->used - (*value)->last);
+    (*value)->used = (*value)->last + newSize;
+    return ptr;
+  }
+  returnValue = screenArenaAlloc(value, newSize);
+  if (returnValue != NULL) {
+    memcpy(returnValue, ptr, oldSize);
+  }
+  return returnValue;
+}
+
+#ifdef BOLO_PROFILE
+/*********************************************************
+*NAME:          screenArenaProfileReset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Zeros the arena counters
+*
+*ARGUMENTS:
+*
+*********************************************************/
+void screenArenaProfileReset(void) {
+  screenArenaItems = 0;
+  screenArenaResets = 0;
+  screenArenaAllocs = 0;
+}
+
+/*********************************************************
+*NAME:          screenArenaProfileGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the arena counters since the last reset
+*
+*ARGUMENTS:
+*  items  - Items handed out by every arena
+*  resets - Frames released by every arena
+*  allocs - Heap allocations made by every arena
+*********************************************************/
+void screenArenaProfileGet(unsigned long long *items, unsigned long long *resets, unsigned long long *allocs) {
+  *items = screenArenaItems;
+  *resets = screenArenaResets;
+  *allocs = screenArenaAllocs;
+}
+#endif
@@ -0,0 +1,170 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Screen Arena
+*Filename:      screenarena.h
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Bump allocator for the lists built each frame or tick.
+*  Everything handed out is released at once by a reset
+*  at the frame boundary
+*********************************************************/
+
+#ifndef SCREENARENA_H
+#define SCREENARENA_H
+
+#include <stddef.h>
+#include "global.h"
+
+/* Size of the block an arena starts with */
+#define SCREEN_ARENA_SIZE 4096
+
+/* Items are handed out on multiples of this */
+#define SCREEN_ARENA_ALIGN 8
+
+/* A heap block for an item that did not fit */
+typedef struct screenArenaSpillObj *screenArenaSpill;
+struct screenArenaSpillObj {
+  screenArenaSpill next; /* Next spilled block */
+  double data[1];        /* Start of the item, aligned for anything */
+};
+
+typedef struct screenArenaObj *screenArena;
+struct screenArenaObj {
+  BYTE *block;            /* Memory items are handed out from */
+  size_t size;            /* Size of block */
+  size_t used;            /* Bytes of block handed out since the reset */
+  size_t last;            /* Offset of the newest item in block */
+  size_t want;            /* Bytes asked for since the reset, spilled or not */
+  screenArenaSpill spill; /* Items that did not fit in block */
+};
+
+/* Prototypes */
+
+/*********************************************************
+*NAME:          screenArenaCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates an arena with an empty block of
+*  SCREEN_ARENA_SIZE bytes. Returns NULL on out of memory
+*
+*ARGUMENTS:
+*
+*********************************************************/
+screenArena screenArenaCreate(void);
+
+/*********************************************************
+*NAME:          screenArenaDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys and frees memory for an arena and everything
+*  handed out from it
+*
+*ARGUMENTS:
+*  value - Pointer to the arena
+*********************************************************/
+void screenArenaDestroy(screenArena *value);
+
+/*********************************************************
+*NAME:          screenArenaReset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Releases everything handed out since the last reset.
+*  If items spilled to the heap the block is regrown to
+*  hold them all so the next frame needs no allocations
+*
+*ARGUMENTS:
+*  value - Pointer to the arena
+*********************************************************/
+void screenArenaReset(screenArena *value);
+
+/*********************************************************
+*NAME:          screenArenaAlloc
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Hands out size bytes that stay valid until the next
+*  reset. Returns NULL on out of memory
+*
+*ARGUMENTS:
+*  value - Pointer to the arena
+*  size  - Number of bytes wanted
+*********************************************************/
+void *screenArenaAlloc(screenArena *value, size_t size);
+
+/*********************************************************
+*NAME:          screenArenaGrow
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Like realloc for an item from the arena. The newest
+*  item is grown where it is if the block has room,
+*  otherwise it is copied to a new item. Returns NULL on
+*  out of memory leaving ptr untouched
+*
+*ARGUMENTS:
+*  value   - Pointer to the arena
+*  ptr     - Item to grow or NULL for a new one
+*  oldSize - Current size of ptr
+*  newSize - Size wanted
+*********************************************************/
+void *screenArenaGrow(screenArena *value, void *ptr, size_t oldSize, size_t newSize);
+
+#ifdef BOLO_PROFILE
+/*********************************************************
+*NAME:          screenArenaProfileReset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Zeros the arena counters
+*
+*ARGUMENTS:
+*
+*********************************************************/
+void screenArenaProfileReset(void);
+
+/*********************************************************
+*NAME:          screenArenaProfileGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the arena counters since the last reset
+*
+*ARGUMENTS:
+*  items  - Items handed out by every arena
+*  resets - Frames released by every arena
+*  allocs - Heap allocations made by every arena
+*********************************************************/
+void screenArenaProfileGet(unsigned long long *items, unsigned long long *resets, unsigned long long *allocs);
+#endif
+
+#endif /* SCREENARENA_H */
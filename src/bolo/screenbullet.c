@@ -33,43 +33,46 @@
 *NAME:          screenBulletsCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/12/98
-*LAST MODIFIED: 26/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Sets up the screen bullets data structure
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the screenBullets data structure
+*  arena - Arena to build the list in. NULL to use the
+*          heap
 *********************************************************/
-screenBullets screenBulletsCreate(void) {
-	return NULL;
+void screenBulletsCreate(screenBullets *value, screenArena arena) {
+  (*value).item = NULL;
+  (*value).numItems = 0;
+  (*value).sizeItems = 0;
+  (*value).arena = arena;
 }
 
 /*********************************************************
 *NAME:          screenBulletsDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/12/98
-*LAST MODIFIED: 26/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Destroys and frees memory for the data structure
+*  Destroys and frees memory for the data structure.
+*  Items in an arena are left for its next reset
 *
 *ARGUMENTS:
 *  value - Pointer to the screenBullets data structure
 *********************************************************/
 void screenBulletsDestroy(screenBullets *value) {
-  screenBullets q;
-
-  while (!IsEmpty(*value)) {
-    q = *value;
-    *value = ScreenBulletTail(q);
-    Dispose(q);
+  if ((*value).item != NULL && (*value).arena == NULL) {
+    Dispose((*value).item);
   }
+  screenBulletsCreate(value, (*value).arena);
 }
 
 /*********************************************************
 *NAME:          screenBulletsAddItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/12/98
-*LAST MODIFIED: 26/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Adds an item to the screenBullets data structure.
 *
@@ -82,23 +85,36 @@ void screenBulletsDestroy(screenBullets *value) {
 *  frame - Frame identifer of the bullet
 *********************************************************/
 void screenBulletsAddItem(screenBullets *value, BYTE mx, BYTE my, BYTE px, BYTE py, BYTE frame) {
-  screenBullets q;
-  
-  New (q);
+  screenBullet *q;
+  int size; /* Room to grow to */
+
+  if ((*value).numItems == (*value).sizeItems) {
+    size = (*value).sizeItems * 2 + SCREEN_BULLETS_GROW;
+    if ((*value).arena != NULL) {
+      q = screenArenaGrow(&(*value).arena, (*value).item, sizeof(screenBullet) * (size_t) (*value).sizeItems, sizeof(screenBullet) * (size_t) size);
+    } else {
+      q = realloc((*value).item, sizeof(screenBullet) * (size_t) size);
+    }
+    if (q == NULL) {
+      return;
+    }
+    (*value).item = q;
+    (*value).sizeItems = size;
+  }
+  q = &(*value).item[(*value).numItems];
   q->mx = mx;
   q->my = my;
   q->px = px;
   q->py = py;
   q->frame = frame;
-  q->next = *value;
-  *value = q;
+  (*value).numItems++;
 }
 
 /*********************************************************
 *NAME:          screenBulletsGetNumEntries
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/12/98
-*LAST MODIFIED: 26/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns the number of elements in the data structure
 *
@@ -106,25 +122,14 @@ void screenBulletsAddItem(screenBullets *value, BYTE mx, BYTE my, BYTE px, BYTE
 *  value - Pointer to the screenBullets data structure
 *********************************************************/
 int screenBulletsGetNumEntries(screenBullets *value) {
-  int returnValue; /* Value to return */
-  screenBullets q;
-
-  q = *value;
-  returnValue = 0;
-
-  while (NonEmpty(q)) {
-    returnValue++;
-    q = ScreenBulletTail(q);
-  }
-
-  return returnValue;
+  return (*value).numItems;
 }
 
 /*********************************************************
 *NAME:          screenBulletsGetItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/12/98
-*LAST MODIFIED: 26/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Gets data for a specific item
 *
@@ -138,24 +143,38 @@ int screenBulletsGetNumEntries(screenBullets *value) {
 *  frame - Frame identifer of the bullet
 *********************************************************/
 void screenBulletsGetItem(screenBullets *value, int itemNum, BYTE *mx, BYTE *my, BYTE *px, BYTE *py, BYTE *frame) {
-  int count; /* Looping variable */
-  screenBullets q;
+  screenBullet *q;
 
-  count = 1;
-  q = *value;
-
-  while (NonEmpty(q) && count < itemNum) {
-    count++;
-    q = ScreenBulletTail(q);
-  }
-
-  if (q != NULL) {
+  if (itemNum >= 1 && itemNum <= (*value).numItems) {
+    /* Item 1 is the newest */
+    q = &(*value).item[(*value).numItems - itemNum];
     *mx = q->mx;
     *my = q->my;
     *px = q->px;
     *py = q->py;
     *frame = q->frame;
-  } else {
-    //FIXME: This shouldn't happen though
   }
 }
+
+/*********************************************************
+*NAME:          screenBulletsNext
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Steps through the items without counting from the
+*  start for each. Returns the item at the cursor and
+*  moves it on, or NULL once there are no more. Items are
+*  returned in the same order as screenBulletsGetItem
+*
+*ARGUMENTS:
+*  value - Pointer to the screenBullets data structure
+*  pos   - Cursor. Set to 0 to start
+*********************************************************/
+screenBullet *screenBulletsNext(screenBullets *value, int *pos) {
+  if (*pos < 0 || *pos >= (*value).numItems) {
+    return NULL;
+  }
+  (*pos)++;
+  return &(*value).item[(*value).numItems - *pos];
+}
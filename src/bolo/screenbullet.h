@@ -29,28 +29,34 @@
 #define SCREENBULLETS_H
 
 #include "global.h"
+#include "screenarena.h"
 
-/* Empty / Non Empty / Head / Tail Macros */
+/* Empty / Non Empty Macros */
 #define IsEmpty(list) ((list) ==NULL)
 #define NonEmpty(list) (!IsEmpty(list))
-#define ScreenBulletHeadMX(list) ((list)->mx);
-#define ScreenBulletHeadMY(list) ((list)->my);
-#define ScreenBulletHeadPX(list) ((list)->px);
-#define ScreenBulletHeadPY(list) ((list)->py);
-#define ScreenBulletHeadDir(list) ((list)->dir);
-#define ScreenBulletTail(list) ((list)->next);
+
+/* Room the array is first given and grows by */
+#define SCREEN_BULLETS_GROW 64
 
 /* Type structure */
 
-typedef struct screenBulletsObj *screenBullets;
-struct screenBulletsObj {
-  screenBullets next;
+typedef struct {
   BYTE mx;    /* X Map co-ord of the bullet (Mapped to screen) */
   BYTE my;    /* Y Map co-ord of the bullet (Mapped to screen) */
   BYTE px;    /* X Pixel offset of the bullet */
   BYTE py;    /* Y Pixel offset of the bullet */
   BYTE frame; /* Frame identifier type */
-};
+} screenBullet;
+
+/* Items are kept in the order added in one block of
+   memory and handed out newest first as the list they
+   replaced did */
+typedef struct {
+  screenBullet *item; /* The bullets */
+  int numItems;       /* Number of bullets */
+  int sizeItems;      /* Room in item */
+  screenArena arena;  /* Arena item comes from or NULL for the heap */
+} screenBullets;
 
 /* Prototypes */
 
@@ -63,9 +69,9 @@ struct screenBulletsObj {
 *  Sets up the screen bullets data structure
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the screenBullets data structure
 *********************************************************/
-screenBullets screenBulletsCreate(void);
+void screenBulletsCreate(screenBullets *value, screenArena arena);
 
 /*********************************************************
 *NAME:          screenBulletsAddItem
@@ -130,5 +136,22 @@ void screenBulletsDestroy(screenBullets *value);
 *********************************************************/
 void screenBulletsGetItem(screenBullets *value, int itemNum, BYTE *mx, BYTE *my, BYTE *px, BYTE *py, BYTE *frame);
 
+/*********************************************************
+*NAME:          screenBulletsNext
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Steps through the items without counting from the
+*  start for each. Returns the item at the cursor and
+*  moves it on, or NULL once there are no more. Items are
+*  returned in the same order as screenBulletsGetItem
+*
+*ARGUMENTS:
+*  value - Pointer to the screenBullets data structure
+*  pos   - Cursor. Set to 0 to start
+*********************************************************/
+screenBullet *screenBulletsNext(screenBullets *value, int *pos);
+
 #endif /* SCREENBULLETS_H */
 
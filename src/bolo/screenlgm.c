@@ -38,7 +38,7 @@
 *NAME:          screenLgmCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/2/99
-*LAST MODIFIED: 19/2/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Sets up the screen lgms data structure
 *
@@ -46,7 +46,7 @@
 *  value - New item to create
 *********************************************************/
 void screenLgmCreate(screenLgm *value) {
-  (*value) = NULL;
+  (*value).numLgmScreen = 0;
 }
 
 /*********************************************************
@@ -83,7 +83,7 @@ void screenLgmPrepare(screenLgm *value, BYTE leftPos, BYTE rightPos, BYTE top, B
 *NAME:          screenLgmGetNumEntries
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/2/99
-*LAST MODIFIED: 19/2/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns the number of elements in the data structure
 *
@@ -91,23 +91,14 @@ void screenLgmPrepare(screenLgm *value, BYTE leftPos, BYTE rightPos, BYTE top, B
 *  value - Pointer to the screenLgm data structure
 *********************************************************/
 BYTE screenLgmGetNumEntries(screenLgm *value) {
-  BYTE returnValue; /* Value to return */
-  screenLgm q;
-
-  returnValue = 0;
-  q = *value;
-  while (NonEmpty(q)) {
-    returnValue++;
-    q = ScreenLgmsTail(q);
-  }
-  return returnValue;
+  return (*value).numLgmScreen;
 }
 
 /*********************************************************
 *NAME:          screenLgmDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/2/99
-*LAST MODIFIED: 19/2/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Destroys and frees memory for the data structure
 *
@@ -115,20 +106,14 @@ BYTE screenLgmGetNumEntries(screenLgm *value) {
 *  value - Pointer to the screenLgm data structure
 *********************************************************/
 void screenLgmDestroy(screenLgm *value) {
-  screenLgm q;
-
-  while(NonEmpty(*value)) {
-    q = *value;
-    (*value) = ScreenLgmsTail(q);
-    Dispose(q);
-  }
+  (*value).numLgmScreen = 0;
 }
 
 /*********************************************************
 *NAME:          screenLgmAddItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/2/98
-*LAST MODIFIED: 19/2/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Adds a data set for a specific lgm
 *
@@ -141,23 +126,24 @@ void screenLgmDestroy(screenLgm *value) {
 *  frame      - Frame identifer of the tank
 *********************************************************/
 void screenLgmAddItem(screenLgm *value, BYTE mx, BYTE my, BYTE px, BYTE py, BYTE frame) {
-  screenLgm q;
-
-  New(q);
-  q->mx = mx;
-  q->my = my;
-  q->px = px;
-  q->py = py;
-  q->frame = frame;
-  q->next = (*value);
-  (*value) = q;
+  screenPosLgm *q;
+
+  if ((*value).numLgmScreen < MAX_TANKS) {
+    q = &(*value).pos[(*value).numLgmScreen];
+    q->mx = mx;
+    q->my = my;
+    q->px = px;
+    q->py = py;
+    q->frame = frame;
+    (*value).numLgmScreen++;
+  }
 }
 
 /*********************************************************
 *NAME:          screenLgmGetItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/2/98
-*LAST MODIFIED: 19/2/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Gets data for a specific item
 *
@@ -171,25 +157,37 @@ void screenLgmAddItem(screenLgm *value, BYTE mx, BYTE my, BYTE px, BYTE py, BYTE
 *  frame      - Frame identifer of the LGM
 *********************************************************/
 void screenLgmGetItem(screenLgm *value, BYTE itemNum, BYTE *mx, BYTE *my, BYTE *px, BYTE *py, BYTE *frame) {
-  BYTE count;  /* Looping variable */
-  screenLgm q; 
-
-  count = 1;
-  q = *value;
+  screenPosLgm *q;
 
-  while (count < itemNum && NonEmpty(q)) {
-    count++;
-    q = ScreenLgmsTail(q);
-  }
-  if (q != NULL) {
+  if (itemNum >= 1 && itemNum <= (*value).numLgmScreen) {
+    /* Item 1 is the newest */
+    q = &(*value).pos[(*value).numLgmScreen - itemNum];
     *mx = q->mx;
     *my = q->my;
     *px = q->px;
     *py = q->py;
     *frame = q->frame;
-  } else {
-    // FIXME
   }
 }
 
-
+/*********************************************************
+*NAME:          screenLgmNext
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Steps through the lgms. Returns the one at the cursor
+*  and moves it on, or NULL once there are no more. Lgms
+*  are returned in the same order as screenLgmGetItem
+*
+*ARGUMENTS:
+*  value - Pointer to the screenLgm data structure
+*  pos   - Cursor. Set to 0 to start
+*********************************************************/
+screenPosLgm *screenLgmNext(screenLgm *value, int *pos) {
+  if (*pos < 0 || *pos >= (*value).numLgmScreen) {
+    return NULL;
+  }
+  (*pos)++;
+  return &(*value).pos[(*value).numLgmScreen - *pos];
+}
@@ -31,27 +31,26 @@
 
 #include "global.h"
 
-/* Empty / Non Empty / Head / Tail Macros */
+/* Empty / Non Empty Macros */
 #define IsEmpty(list) ((list) ==NULL)
 #define NonEmpty(list) (!IsEmpty(list))
-#define ScreenLgmsHeadMX(list) ((list)->mx);
-#define ScreenLgmsHeadMY(list) ((list)->my);
-#define ScreenLgmsHeadPX(list) ((list)->px);
-#define ScreenLgmsHeadPY(list) ((list)->py);
-#define ScreenLgmsHeadFrame(list) ((list)->frame);
-#define ScreenLgmsTail(list) ((list)->next);
 
 /* Type structure */
 
-typedef struct screenLgmObj *screenLgm;
-struct screenLgmObj {
-  screenLgm next; /* Next item */
+typedef struct {
   BYTE mx;        /* The map x co-ordinate it is on */
   BYTE my;        /* The map y co-ordinate it is on */
   BYTE px;        /* The pixel offset from the left it is on */
   BYTE py;        /* The pixel offset from the top it is on */
   BYTE frame;     /* The direction it is facing */
-};
+} screenPosLgm;
+
+/* There is at most one lgm per player. Items are handed
+   out newest first as the list they replaced did */
+typedef struct {
+  BYTE numLgmScreen;           /* The number of lgms on screen */
+  screenPosLgm pos[MAX_TANKS]; /* Data for each lgm */
+} screenLgm;
 
 
 /* Prototypes */
@@ -150,5 +149,21 @@ void screenLgmAddItem(screenLgm *value, BYTE mx, BYTE my, BYTE px, BYTE py, BYTE
 *********************************************************/
 void screenLgmGetItem(screenLgm *value, BYTE itemNum, BYTE *mx, BYTE *my, BYTE *px, BYTE *py, BYTE *frame);
 
+/*********************************************************
+*NAME:          screenLgmNext
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Steps through the lgms. Returns the one at the cursor
+*  and moves it on, or NULL once there are no more. Lgms
+*  are returned in the same order as screenLgmGetItem
+*
+*ARGUMENTS:
+*  value - Pointer to the screenLgm data structure
+*  pos   - Cursor. Set to 0 to start
+*********************************************************/
+screenPosLgm *screenLgmNext(screenLgm *value, int *pos);
+
 #endif /* SCREENLGMS_H */
 
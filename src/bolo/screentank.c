@@ -168,7 +168,7 @@ void screenTanksAddItem(screenTanks *value, BYTE mx, BYTE my, BYTE px, BYTE py,
 *NAME:          screenTanksGetItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/2/98
-*LAST MODIFIED: 26/1/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Gets data for a specific item
 *
@@ -185,7 +185,7 @@ void screenTanksAddItem(screenTanks *value, BYTE mx, BYTE my, BYTE px, BYTE py,
 *********************************************************/
 void screenTanksGetItem(screenTanks *value, BYTE itemNum, BYTE *mx, BYTE *my, BYTE *px, BYTE *py, BYTE *frame, BYTE *playerNum, char *playerName) {
   itemNum--;
-  if (itemNum <= (*value).numTanksScreen) {
+  if (itemNum < (*value).numTanksScreen) {
     *mx = (*value).pos[itemNum].mx;
     *my = (*value).pos[itemNum].my;
     *px = (*value).pos[itemNum].px;
@@ -195,3 +195,25 @@ void screenTanksGetItem(screenTanks *value, BYTE itemNum, BYTE *mx, BYTE *my, BY
     strcpy(playerName, (*value).pos[itemNum].playerName);
   }
 }
+
+/*********************************************************
+*NAME:          screenTanksNext
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Steps through the tanks without copying them out.
+*  Returns the tank at the cursor and moves it on, or
+*  NULL once there are no more
+*
+*ARGUMENTS:
+*  value - Pointer to the screenTanks data structure
+*  pos   - Cursor. Set to 0 to start
+*********************************************************/
+screenPosTank *screenTanksNext(screenTanks *value, int *pos) {
+  if (*pos < 0 || *pos >= (*value).numTanksScreen) {
+    return NULL;
+  }
+  (*pos)++;
+  return &(*value).pos[*pos - 1];
+}
@@ -31,15 +31,9 @@
 #include "global.h"
 #include "tank.h"
 
-/* Empty / Non Empty / Head / Tail Macros */
+/* Empty / Non Empty Macros */
 #define IsEmpty(list) ((list) ==NULL)
 #define NonEmpty(list) (!IsEmpty(list))
-#define ScreenTanksHeadMX(list) ((list)->mx);
-#define ScreenTanksHeadMY(list) ((list)->my);
-#define ScreenTanksHeadPX(list) ((list)->px);
-#define ScreenTanksHeadPY(list) ((list)->py);
-#define ScreenTanksHeadFrame(list) ((list)->frame);
-#define ScreenTanksTail(list) ((list)->next);
 
 /* Type structure */
 
@@ -174,5 +168,21 @@ void screenTanksAddItem(screenTanks *value, BYTE mx, BYTE my, BYTE px, BYTE py,
 *********************************************************/
 void screenTanksGetItem(screenTanks *value, BYTE itemNum, BYTE *mx, BYTE *my, BYTE *px, BYTE *py, BYTE *frame, BYTE *playerNum, char *playerName);
 
+/*********************************************************
+*NAME:          screenTanksNext
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Steps through the tanks without copying them out.
+*  Returns the tank at the cursor and moves it on, or
+*  NULL once there are no more
+*
+*ARGUMENTS:
+*  value - Pointer to the screenTanks data structure
+*  pos   - Cursor. Set to 0 to start
+*********************************************************/
+screenPosTank *screenTanksNext(screenTanks *value, int *pos);
+
 #endif /* SCREENTANKS_H */
 
@@ -20,7 +20,7 @@
 *Filename:      serverfrontend.c
 *Author:        John Morrison
 *Creation Date: 3/10/00
-*Last Modified: 3/10/00
+*Last Modified: 16/10/26
 *Purpose:
 * Dummy wrapper for the server functions not required in
 * clients
@@ -29,23 +29,25 @@
 /* Inludes */
 #include "global.h"
 #include "../server/servercore.h"
+#include "../server/servernet.h"
 
 /*********************************************************
 *NAME:          serverCoreLgmOperation
 *AUTHOR:        John Morrison
 *CREATION DATE: 3/10/00
-*LAST MODIFIED: 3/10/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A client has requested a lgm operataion
 * Always your own for a client.
 *
 *ARGUMENTS:
+*  sc        - Game to act on
 *  playerNum - the player numbers lgm to get
 *  destX     - X Destination
 *  destY     - Y Destination
 *  operation - Operation to perform
 *********************************************************/
-void serverCoreLgmOperation(BYTE playerNum, BYTE destX, BYTE destY, BYTE operation) {
+void serverCoreLgmOperation(serverCore sc, BYTE playerNum, BYTE destX, BYTE destY, BYTE operation) {
   return;
 }
 
@@ -65,7 +67,7 @@ void serverCoreServerConsoleMessage(char *msg) {
   return;
 }
 
-void serverNetSendManWorkingMessage(BYTE playerNum, BYTE mapX, BYTE mapY, BYTE numMines, BYTE numTrees, BYTE pillNum) {
+void serverNetSendManWorkingMessage(serverCore sc, BYTE playerNum, BYTE mapX, BYTE mapY, BYTE numMines, BYTE numTrees, BYTE pillNum) {
   return;
 	
 }
@@ -74,16 +76,17 @@ void serverNetSendManWorkingMessage(BYTE playerNum, BYTE mapX, BYTE mapY, BYTE n
 *NAME:          serverCoreTankInView
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED:  8/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns if the item at checkX, checkY is in viewing
 * range of playre playerNum and any of its pillboxes
 *
 *ARGUMENTS:
+* sc        - Game to check
 * playerNum - PlayerNum to check
 * checkX    - X Position to check
 * checkY    - Y Position to check
 *********************************************************/
-bool serverCoreTankInView(BYTE playerNum, BYTE checkX, BYTE checkY) {
+bool serverCoreTankInView(serverCore sc, BYTE playerNum, BYTE checkX, BYTE checkY) {
   return TRUE;
 }
\ No newline at end of file
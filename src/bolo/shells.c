@@ -20,7 +20,7 @@
 *Filename:      shells.c
 *Author:        John Morrison
 *Creation Date: 25/12/98
-*Last Modified: 04/04/02
+*Last Modified: 16/10/26
 *Purpose:
 *  Responsable for Shells tracking/collision detect etc.
 *********************************************************/
@@ -53,7 +53,7 @@
 #include "shells.h"
 #include "screen.h"
 
-bool c;
+THREAD_LOCAL bool c;
 shellsNetHit snh;
 
 #undef SHELL_START_ADD
@@ -72,7 +72,12 @@ shellsNetHit snh;
 *
 *********************************************************/
 shells shellsCreate(void) {
-	return NULL;
+  shells returnValue; /* Value to return */
+
+  New(returnValue);
+  returnValue->numShells = 0;
+  returnValue->tanks = tankGridCreate();
+  return returnValue;
 }
 
 
@@ -88,16 +93,15 @@ shells shellsCreate(void) {
 *  value - Pointer to the shells data structure
 *********************************************************/
 void shellsDestroy(shells *value) {
-  shells q;
-
-  while (!IsEmpty(*value)) {
-    q = *value;
-    *value = ShellsTail(q);
-    Dispose(q);
+  if (*value != NULL) {
+    tankGridDestroy(&((*value)->tanks));
+    Dispose(*value);
+    *value = NULL;
   }
   c = TRUE;
 }
 
+
 /*********************************************************
 *NAME:          shellsAddItem
 *AUTHOR:        John Morrison
@@ -117,10 +121,15 @@ void shellsDestroy(shells *value) {
 *  onBoat - Was the shell launched from a boat
 *********************************************************/
 void shellsAddItem(shells *value, WORLD x, WORLD y, TURNTYPE angle, TURNTYPE len, BYTE owner, bool onBoat) {
-  shells q;
+  shells q; /* The shells pool */
+  int num;  /* Slot to use */
   int xAdd;
   int yAdd;
 
+  q = *value;
+  if (q == NULL || q->numShells >= MAX_SHELLS) {
+    return;
+  }
   utilCalcDistance(&xAdd, &yAdd, angle, SHELL_SPEED);
   x = (WORLD) (x + (SHELL_START_ADD) * xAdd);
   y = (WORLD) (y + (SHELL_START_ADD) * yAdd);
@@ -134,31 +143,33 @@ void shellsAddItem(shells *value, WORLD x, WORLD y, TURNTYPE angle, TURNTYPE len
   } else {
     y -= 22;
   }  */
-  New (q);
-  q->x = x;
-  q->y = y;
-  q->angle = angle;
-  q->length = (BYTE) (1 + (SHELL_LIFE * len) - (SHELL_START_ADD));
-  q->onBoat = onBoat;
-  q->creator = playersGetSelf(screenGetPlayers());
-  q->owner = owner;
-  q->packSent = FALSE;
-  q->shellDead = FALSE;
-  q->next = *value;
-  q->prev = NULL;
-  if (NonEmpty(*value)) {
-    (*value)->prev = q;
+  num = q->numShells;
+  q->x[num] = x;
+  q->y[num] = y;
+  q->xAdd[num] = (WORLD) xAdd;
+  q->yAdd[num] = (WORLD) yAdd;
+  q->angle[num] = angle;
+  q->length[num] = (BYTE) (1 + (SHELL_LIFE * len) - (SHELL_START_ADD));
+  q->creator[num] = playersGetSelf(screenGetPlayers());
+  q->owner[num] = owner;
+  q->flags[num] = 0;
+  if (onBoat == TRUE) {
+    q->flags[num] = SHELL_FLAG_ONBOAT;
   }
-  *value = q;
+  q->numShells++;
 }
 
+
 /*********************************************************
 *NAME:          shellsUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE: 25/12/98
-*LAST MODIFIED: 04/04/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Updates each shells position and checks for colisions
+*  Updates each shells position and checks for colisions.
+*  The next position of every shell is worked out first
+*  in one pass over the pool, then each shell is checked
+*  for collisions newest first.
 *
 *ARGUMENTS:
 *  value    - Pointer to the shells data structure
@@ -169,12 +180,11 @@ void shellsAddItem(shells *value, WORLD x, WORLD y, TURNTYPE angle, TURNTYPE len
 *  isServer - TRUE if we are a server
 *********************************************************/
 void shellsUpdate(shells *value, map *mp, pillboxes *pb, bases *bs, tank *tk, BYTE numTanks, bool isServer) {
-  WORLD newX;      /* X and Y positions of the new shell location */
-  WORLD newY;
-  shells position; /* The position in the stack of items */
-  bool needUpdate; /* Does an update need to occur? */
-  int xAdd;        /* Amounts to add */
-  int yAdd;  
+  shells q;        /* The shells pool */
+  WORLD *newX;     /* X and Y positions of the new shell locations */
+  WORLD *newY;
+  int num;         /* Number of shells at the start of the update */
+  int position;    /* The slot being updated */
   BYTE bmx;        /* Shell X and Y map positions */
   BYTE bmy;
   BYTE sx;         /* Screen - TANK_SUBTRACT Map X and Y Positions */
@@ -184,45 +194,65 @@ void shellsUpdate(shells *value, map *mp, pillboxes *pb, bases *bs, tank *tk, BY
   WORLD conv;      /* Used for bit shifting */
   BYTE testPos;    /* Test position for mine send */
   BYTE count;      /* Looping variable */
+  WORLD tankX;     /* Tank position for the grid */
+  WORLD tankY;
   
-  position = *value;
+  q = *value;
+  if (q == NULL) {
+    return;
+  }
   if (netGetType() == netSingle) {
     isServer = FALSE;
   } 
 
-  while (NonEmpty(position)) {
-    needUpdate = TRUE;
-    if (position->shellDead == TRUE && (position->packSent == TRUE || netGetType() == netSingle)) {
-      needUpdate = FALSE;
-      shellsDeleteItem(value, &position);
-    } else if (position->shellDead == TRUE && position->packSent == FALSE) {
-      needUpdate = TRUE;
-    } else if (position->length > SHELL_DEATH) {
-      /* Move the shell */
-      utilCalcDistance(&xAdd, &yAdd, position->angle, SHELL_SPEED);
-      newX = (WORLD) (position->x + xAdd);
-      newY = (WORLD) (position->y + yAdd);
+  /* Bucket the tanks now they have moved for this tick */
+  tankGridClear(&(q->tanks));
+  for (count=0;count<numTanks;count++) {
+    if (tk[count] != NULL) {
+      tankGetWorld(&tk[count], &tankX, &tankY);
+      tankGridSet(&(q->tanks), count, tankX, tankY);
+    }
+  }
+
+  /* Move every shell. Shells that are dead or finished are
+     moved too but their new position is never used */
+  num = q->numShells;
+  newX = q->newX;
+  newY = q->newY;
+  for (position=0;position<num;position++) {
+    newX[position] = (WORLD) (q->x[position] + q->xAdd[position]);
+    newY[position] = (WORLD) (q->y[position] + q->yAdd[position]);
+  }
+
+  position = num;
+  while (position > 0) {
+    position--;
+    if ((q->flags[position] & SHELL_FLAG_DEAD) && ((q->flags[position] & SHELL_FLAG_SENT) || netGetType() == netSingle)) {
+      shellsDeleteItem(value, position);
+    } else if (q->flags[position] & SHELL_FLAG_DEAD) {
+      /* Waiting to be sent */
+    } else if (q->length[position] > SHELL_DEATH) {
       /* Check for colision */
-      if ((shellsCalcCollision(mp, pb, tk, bs, &newX, &newY, position->angle, position->owner, position->onBoat, numTanks, isServer)) == TRUE) {
+      if ((shellsCalcCollision(mp, pb, tk, &(q->tanks), bs, &newX[position], &newY[position], q->angle[position], q->owner[position], (bool) ((q->flags[position] & SHELL_FLAG_ONBOAT) ? TRUE : FALSE), numTanks, isServer)) == TRUE) {
         /* Get X and Y map co-ords. */
-        conv = newX;
+        conv = newX[position];
         conv >>= TANK_SHIFT_MAPSIZE;
         bmx = (BYTE) conv;
-        conv = newY;
+        conv = newY[position];
         conv >>= TANK_SHIFT_MAPSIZE;
         bmy = (BYTE) conv;
         /* Get Screen - TANK_SUBTRACT co-ords */
-        conv = newX - TANK_SUBTRACT;
+        conv = newX[position] - TANK_SUBTRACT;
         conv >>= TANK_SHIFT_MAPSIZE;
         sx = (BYTE) conv;
-        conv = newY - TANK_SUBTRACT;
+        conv = newY[position] - TANK_SUBTRACT;
         conv >>= TANK_SHIFT_MAPSIZE;
         sy = (BYTE) conv;
-        conv = newX - TANK_SUBTRACT;
+        conv = newX[position] - TANK_SUBTRACT;
         conv <<= TANK_SHIFT_MAPSIZE;
         conv >>= TANK_SHIFT_PIXELSIZE;
         spx = (BYTE) conv;
-        conv = newY - TANK_SUBTRACT;
+        conv = newY[position] - TANK_SUBTRACT;
         conv <<= TANK_SHIFT_MAPSIZE;
         conv >>= TANK_SHIFT_PIXELSIZE;
         spy = (BYTE) conv;
@@ -230,43 +260,41 @@ void shellsUpdate(shells *value, map *mp, pillboxes *pb, bases *bs, tank *tk, BY
         minesExpAddItem(screenGetMinesExp(), mp, bmx, bmy);
         count = 0;
         while (count < numTanks) {
-          lgmDeathCheck(screenGetLgmFromPlayerNum(screenGetTankPlayer(&tk[count])), mp, pb, bs, newX, newY, position->owner);
+          lgmDeathCheck(screenGetLgmFromPlayerNum(screenGetTankPlayer(&tk[count])), mp, pb, bs, newX[position], newY[position], q->owner[position]);
           count++;
         }        
-        if (position->packSent == TRUE) { 
-          needUpdate = FALSE;
-          shellsDeleteItem(value, &position);
+        if (q->flags[position] & SHELL_FLAG_SENT) { 
+          shellsDeleteItem(value, position);
         } else {
-          position->shellDead = TRUE;
+          q->flags[position] |= SHELL_FLAG_DEAD;
         }
       } else {
-        position->length--;
-        position->x = newX;
-        position->y = newY;
+        /* Update Position */
+        q->length[position]--;
+        q->x[position] = newX[position];
+        q->y[position] = newY[position];
       }
-      /* Update Position */
     } else {
       /* Add to explosion Data structure and remove from shells data structure */
-      needUpdate = FALSE;
       /* Get X and Y map co-ords. */
-      conv = position->x;
+      conv = q->x[position];
       conv >>= TANK_SHIFT_MAPSIZE;
       bmx = (BYTE) conv;
-      conv = position->y;
+      conv = q->y[position];
       conv >>= TANK_SHIFT_MAPSIZE;
       bmy = (BYTE) conv;
       /* Get Screen - TANK_SUBTRACT co-ords */
-      conv = position->x - TANK_SUBTRACT;
+      conv = q->x[position] - TANK_SUBTRACT;
       conv >>= TANK_SHIFT_MAPSIZE;
       sx = (BYTE) conv;
-      conv = position->y - TANK_SUBTRACT;
+      conv = q->y[position] - TANK_SUBTRACT;
       conv >>= TANK_SHIFT_MAPSIZE;
       sy = (BYTE) conv;
-      conv = position->x - TANK_SUBTRACT;
+      conv = q->x[position] - TANK_SUBTRACT;
       conv <<= TANK_SHIFT_MAPSIZE;
       conv >>= TANK_SHIFT_PIXELSIZE;
       spx = (BYTE) conv;
-      conv = position->y - TANK_SUBTRACT;
+      conv = q->y[position] - TANK_SUBTRACT;
       conv <<= TANK_SHIFT_MAPSIZE;
       conv >>= TANK_SHIFT_PIXELSIZE;
       spy = (BYTE) conv;
@@ -278,59 +306,62 @@ void shellsUpdate(shells *value, map *mp, pillboxes *pb, bases *bs, tank *tk, BY
       }
       count = 0;
       while (count < numTanks) {
-        lgmDeathCheck(screenGetLgmFromPlayerNum(screenGetTankPlayer(&tk[count])), mp, pb, bs, position->x, position->y, position->owner);
+        lgmDeathCheck(screenGetLgmFromPlayerNum(screenGetTankPlayer(&tk[count])), mp, pb, bs, q->x[position], q->y[position], q->owner[position]);
         count++;
       }
-      if (position->packSent == TRUE) {
-        shellsDeleteItem(value, &position);
-      } else if (position->shellDead == FALSE) {
-        position->shellDead = TRUE;
+      if (q->flags[position] & SHELL_FLAG_SENT) {
+        shellsDeleteItem(value, position);
+      } else {
+        q->flags[position] |= SHELL_FLAG_DEAD;
       }
-      
     }
+  }
 
-    /* Get the next Item */
-    if (*value != NULL && needUpdate == TRUE) {
-      position = ShellsTail(position);
+  /* Reclaim the slots of deleted shells, keeping the order */
+  num = 0;
+  for (position=0;position<q->numShells;position++) {
+    if (!(q->flags[position] & SHELL_FLAG_FREE)) {
+      if (num != position) {
+        q->x[num] = q->x[position];
+        q->y[num] = q->y[position];
+        q->xAdd[num] = q->xAdd[position];
+        q->yAdd[num] = q->yAdd[position];
+        q->angle[num] = q->angle[position];
+        q->length[num] = q->length[position];
+        q->owner[num] = q->owner[position];
+        q->creator[num] = q->creator[position];
+        q->flags[num] = q->flags[position];
+      }
+      num++;
     }
   }
+  if (num != q->numShells) {
+    q->numShells = num;
+    c = TRUE;
+  }
 }
 
+
 /*********************************************************
 *NAME:          shellsDeleteItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 25/12/98
-*LAST MODIFIED: 25/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Deletes the value from the master list
+*  Deletes a shell from the pool by marking its slot
+*  free. The slot is reclaimed at the end of shellsUpdate
 *
 *ARGUMENTS:
-*  master  - The master list of all shells
-*  value   - Pointer to the shells to delete. Also puts
-*            next shell its position
+*  value   - Pointer to the shells data structure
+*  itemNum - Slot of the shell to delete
 *********************************************************/
-void shellsDeleteItem(shells *master, shells *value) {
-  shells del;  /* The item to delete */
-
-  del = *value;
-  (*value) = ShellsTail(del);
-  if (del->prev != NULL) {
-    del->prev->next = del->next;
-  } else {
-    /* Must be the first item - Move the master position along one */
-    (*master) = ShellsTail(*master);
-    if (NonEmpty(*master)) {
-      (*master)->prev = NULL;
-    }
+void shellsDeleteItem(shells *value, int itemNum) {
+  if (*value != NULL && itemNum >= 0 && itemNum < (*value)->numShells) {
+    (*value)->flags[itemNum] |= SHELL_FLAG_FREE;
   }
-
-  if (del->next != NULL) {
-    del->next->prev = del->prev;
-  }
-  Dispose(del);
-  c= TRUE;
 }
 
+
 /*********************************************************
 *NAME:          shellsCalcScreenBullets
 *AUTHOR:        John Morrison
@@ -349,39 +380,44 @@ void shellsDeleteItem(shells *master, shells *value) {
 *  bottom   - Y Map offset end
 *********************************************************/
 void shellsCalcScreenBullets(shells *value, screenBullets *sBullets, BYTE leftPos, BYTE rightPos, BYTE top, BYTE bottom) {
-  shells q;   /* Temp Pointer */
-  WORLD conv; /* Used for Bit shifting */
-  BYTE x;     /* Map X and Y Positions (relative to screen) */
+  shells q;     /* The shells pool */
+  int position; /* The slot being looked at */
+  WORLD conv;   /* Used for Bit shifting */
+  BYTE x;       /* Map X and Y Positions (relative to screen) */
   BYTE y;
-  BYTE px;    /* Pixel X and Y Positions */
+  BYTE px;      /* Pixel X and Y Positions */
   BYTE py;
-  BYTE frame; /* Animation Frame to draw */
+  BYTE frame;   /* Animation Frame to draw */
 
 
   q = *value;
+  if (q == NULL) {
+    return;
+  }
   c = FALSE;
-  while (NonEmpty(q) && c == FALSE) {
-    conv = q->x;
+  position = q->numShells;
+  while (position > 0 && c == FALSE) {
+    position--;
+    conv = q->x[position];
     conv >>= TANK_SHIFT_MAPSIZE;
     x = (BYTE) conv;
-    conv = q->y;
+    conv = q->y[position];
     conv >>= TANK_SHIFT_MAPSIZE;
     y = (BYTE) conv;
     if (x >= leftPos && x < rightPos && y >= top && y < bottom) {
-      frame = utilGetDir(q->angle);
+      frame = utilGetDir(q->angle[position]);
       x -= (BYTE) leftPos;
       y -= (BYTE) top;
-      conv = q->x;
+      conv = q->x[position];
       conv <<= TANK_SHIFT_MAPSIZE;
       conv >>= TANK_SHIFT_PIXELSIZE;
       px = (BYTE) conv;
-      conv = q->y;
+      conv = q->y[position];
       conv <<= TANK_SHIFT_MAPSIZE;
       conv >>= TANK_SHIFT_PIXELSIZE;
       py = (BYTE) conv;
       screenBulletsAddItem(sBullets, x, y, px, py, (BYTE) (frame + SHELL_START_EXPLODE+1)); 
     }
-    q = ShellsTail(q);
   }
 }
 
@@ -389,14 +425,16 @@ void shellsCalcScreenBullets(shells *value, screenBullets *sBullets, BYTE leftPo
 *NAME:          shellsCalcCollision
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/12/98
-*LAST MODIFIED: 29/07/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Returns whether the collision has occured.
+*  Returns whether the collision has occured. Only the
+*  tanks the grid places near the shell are checked.
 *  
 *ARGUMENTS:
 *  map      - Pointer to the Map Structure
 *  pb       - Pointer to the pillboxes structure
 *  tk       - Pointer to an array of tank structures
+*  grid     - The tanks in tk bucketed by position
 *  bs       - Pointer to the bases structure
 *  xValue   - X position
 *  yValue   - Y position
@@ -406,7 +444,7 @@ void shellsCalcScreenBullets(shells *value, screenBullets *sBullets, BYTE leftPo
 *  numTanks - Number of tanks in the array
 *  isServer - TRUE if we are a server
 *********************************************************/
-bool shellsCalcCollision(map *mp, pillboxes *pb, tank *tk, bases *bs, WORLD *xValue, WORLD *yValue, TURNTYPE angle, BYTE owner, bool onBoat, BYTE numTanks, bool isServer) {
+bool shellsCalcCollision(map *mp, pillboxes *pb, tank *tk, tankGrid *grid, bases *bs, WORLD *xValue, WORLD *yValue, TURNTYPE angle, BYTE owner, bool onBoat, BYTE numTanks, bool isServer) {
   bool returnValue; /* Value to return */
   tankHit th;       /* Used to store whether the tank has been hit */
   WORLD conv;       /* Used in the conversion */
@@ -419,6 +457,9 @@ bool shellsCalcCollision(map *mp, pillboxes *pb, tank *tk, bases *bs, WORLD *xVa
   BYTE count;       /* Looping variable */
   bool baseExist;   /* Does a base exist here */
   netType gameT;    /* Type of network game */
+  tankGridMask nearby; /* Tanks close enough to be hit */
+  WORLD tankX;      /* Tank position after being hit */
+  WORLD tankY;
 
 
   returnValue =  FALSE;
@@ -455,10 +496,16 @@ bool shellsCalcCollision(map *mp, pillboxes *pb, tank *tk, bases *bs, WORLD *xVa
     soundDist(shotBuildingNear, mapX, mapY);
   }
   if (returnValue == FALSE) {
+    nearby = tankGridGetNear(grid, *xValue, *yValue, MAP_SQUARE_MIDDLE);
     count = 0;
-    while (count < numTanks && returnValue == FALSE) {
-      if (screenGetTankPlayer(&tk[count]) != owner) {
+    while (count < numTanks && returnValue == FALSE && nearby != 0) {
+      if ((nearby & (1 << count)) && screenGetTankPlayer(&tk[count]) != owner) {
         th = tankIsTankHit(&(tk[count]), mp, pb, bs, *xValue, *yValue, angle, owner);
+        if (th != TH_MISSED) {
+          /* Being hit pushes the tank along */
+          tankGetWorld(&(tk[count]), &tankX, &tankY);
+          tankGridSet(grid, count, tankX, tankY);
+        }
         switch (th) {
         case TH_HIT:
           returnValue = TRUE;
@@ -739,45 +786,108 @@ BYTE shellsNetMake(shells *value, BYTE *buff, BYTE noPlayerNum, bool sentState)
   unsigned int ttsz; /* Size of turntype type */
   unsigned int wsz;  /* Size of world type */
   BYTE *pnt;         /* Pointer to offset in the buffer */
-  shells q;          /* Temp pointer to the shells structure */
+  shells q;          /* The shells pool */
+  int position;      /* The slot being looked at */
 
   ttsz = sizeof(TURNTYPE);
   wsz = sizeof(WORLD);
   returnValue = 0;
   pnt = buff;
   q = *value;
+  if (q == NULL) {
+    return returnValue;
+  }
 
-  while (NonEmpty(q)) {
-    if (q->packSent == FALSE && q->creator != noPlayerNum) {
+  position = q->numShells;
+  while (position > 0) {
+    position--;
+    if (!(q->flags[position] & SHELL_FLAG_SENT) && q->creator[position] != noPlayerNum) {
       /* Need to add */
       /* Check range from things */
-      if (screenTankInView(noPlayerNum, (BYTE) (q->x >> TANK_SHIFT_MAPSIZE), (BYTE) (q->y >> TANK_SHIFT_MAPSIZE)) == TRUE) {
-        memcpy(pnt, &(q->x), wsz); /* X */
+      if (screenTankInView(noPlayerNum, (BYTE) (q->x[position] >> TANK_SHIFT_MAPSIZE), (BYTE) (q->y[position] >> TANK_SHIFT_MAPSIZE)) == TRUE) {
+        memcpy(pnt, &(q->x[position]), wsz); /* X */
         pnt += wsz;
         returnValue = (BYTE) (returnValue + wsz);
-        memcpy(pnt, &(q->y), wsz); /* Y */
+        memcpy(pnt, &(q->y[position]), wsz); /* Y */
         pnt += wsz;
         returnValue = (BYTE) (returnValue + wsz);
-        memcpy(pnt, &(q->angle), ttsz); /* Angle */
+        memcpy(pnt, &(q->angle[position]), ttsz); /* Angle */
         pnt += ttsz;
         returnValue = (BYTE) (returnValue + ttsz);
-        *pnt = q->length; /* Length */
+        *pnt = q->length[position]; /* Length */
         pnt++;
         returnValue++;
-        *pnt = q->owner; /* Owner */
+        *pnt = q->owner[position]; /* Owner */
         pnt++;
         returnValue++;
-        *pnt = q->onBoat; /* On Boat */
+        *pnt = (BYTE) ((q->flags[position] & SHELL_FLAG_ONBOAT) ? TRUE : FALSE); /* On Boat */
         pnt++;
         returnValue++;
-        *pnt = q->creator; /* Creator */
+        *pnt = q->creator[position]; /* Creator */
         pnt++;
         returnValue++;
       }
       /* We have no sent it */
-      q->packSent = sentState;
+      if (sentState == TRUE) {
+        q->flags[position] |= SHELL_FLAG_SENT;
+      } else {
+        q->flags[position] &= ~SHELL_FLAG_SENT;
+      }
+    }
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          shellsNetTake
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Copies every shell not yet sent into items, in the
+*  order shellsNetMake would write them, and marks them
+*  as sent. Returns the number of items copied
+*
+*ARGUMENTS:
+*  value - Pointer to shells structure
+*  items - Array of MAX_SHELLS items to copy into
+*********************************************************/
+int shellsNetTake(shells *value, shellsNetItem *items) {
+  int returnValue;   /* Value to return */
+  BYTE *pnt;         /* Pointer to offset in the item data */
+  shells q;          /* The shells pool */
+  int position;      /* The slot being looked at */
+
+  returnValue = 0;
+  q = *value;
+  if (q == NULL) {
+    return returnValue;
+  }
+
+  position = q->numShells;
+  while (position > 0) {
+    position--;
+    if (!(q->flags[position] & SHELL_FLAG_SENT)) {
+      pnt = items[returnValue].data;
+      memcpy(pnt, &(q->x[position]), sizeof(WORLD)); /* X */
+      pnt += sizeof(WORLD);
+      memcpy(pnt, &(q->y[position]), sizeof(WORLD)); /* Y */
+      pnt += sizeof(WORLD);
+      memcpy(pnt, &(q->angle[position]), sizeof(TURNTYPE)); /* Angle */
+      pnt += sizeof(TURNTYPE);
+      *pnt = q->length[position]; /* Length */
+      pnt++;
+      *pnt = q->owner[position]; /* Owner */
+      pnt++;
+      *pnt = (BYTE) ((q->flags[position] & SHELL_FLAG_ONBOAT) ? TRUE : FALSE); /* On Boat */
+      pnt++;
+      *pnt = q->creator[position]; /* Creator */
+      items[returnValue].mx = (BYTE) (q->x[position] >> TANK_SHIFT_MAPSIZE);
+      items[returnValue].my = (BYTE) (q->y[position] >> TANK_SHIFT_MAPSIZE);
+      items[returnValue].creator = q->creator[position];
+      q->flags[position] |= SHELL_FLAG_SENT;
+      returnValue++;
     }
-    q = ShellsTail(q);
   }
   return returnValue;
 }
@@ -802,7 +912,8 @@ BYTE shellsNetMake(shells *value, BYTE *buff, BYTE noPlayerNum, bool sentState)
 void shellsNetExtract(shells *value, pillboxes *pb, BYTE *buff, BYTE dataLen, bool isServer) {
   BYTE pos;   /* Position through the data we are */
   BYTE *pnt;  /* Pointer to offset in the buffer */
-  shells q;   /* Temp pointer to hold additions to the shells structure */
+  shells q;   /* The shells pool */
+  int added;  /* Slot of the last shell added */
   WORLD conv; /* Used in the conversion */
   BYTE mx;    /* Map X position */
   BYTE my;    /* Map Y position */
@@ -825,7 +936,11 @@ void shellsNetExtract(shells *value, pillboxes *pb, BYTE *buff, BYTE dataLen, bo
   self = playersGetSelf(screenGetPlayers());
   pos = 0;
   pnt = buff;
-  q = NULL;
+  q = *value;
+  added = -1;
+  if (q == NULL) {
+    return;
+  }
 
   while (pos < dataLen) {
     shouldAdd = FALSE;
@@ -888,37 +1003,35 @@ void shellsNetExtract(shells *value, pillboxes *pb, BYTE *buff, BYTE dataLen, bo
 
 
     /* Add it if required */
-    if (shouldAdd == TRUE) {
-      New(q);
-      if (isServer == TRUE) {
-        q->packSent = FALSE;
-      } else {
-        q->packSent = TRUE;
+    if (shouldAdd == TRUE && q->numShells < MAX_SHELLS) {
+      added = q->numShells;
+      q->flags[added] = 0;
+      if (isServer == FALSE) {
+        q->flags[added] = SHELL_FLAG_SENT;
       }
-      q->x = wx;
-      q->y = wy;
-      q->angle = tt;
-      q->shellDead = FALSE;
-      q->length = length;
-      q->owner = owner;
-      q->onBoat = onBoat;
-      q->creator = creator;
-      /* Add it to the structure */
-      q->next = *value;
-      q->prev = NULL;
-      if (NonEmpty(*value)) {
-        (*value)->prev = q;
+      if (onBoat == TRUE) {
+        q->flags[added] |= SHELL_FLAG_ONBOAT;
       }
-      *value = q;
+      utilCalcDistance(&xAdd, &yAdd, tt, SHELL_SPEED);
+      q->x[added] = wx;
+      q->y[added] = wy;
+      q->xAdd[added] = (WORLD) xAdd;
+      q->yAdd[added] = (WORLD) yAdd;
+      q->angle[added] = tt;
+      q->length[added] = length;
+      q->owner[added] = owner;
+      q->creator[added] = creator;
+      /* Add it to the structure */
+      q->numShells++;
     }
   }
   
   /* Play the last sound event if exist */
-  if (q != NULL) {
-    conv = q->x;
+  if (added >= 0) {
+    conv = q->x[added];
     conv >>= TANK_SHIFT_MAPSIZE;
     mx = (BYTE) conv;
-    conv = q->y;
+    conv = q->y[added];
     conv >>= TANK_SHIFT_MAPSIZE;
     my = (BYTE) conv;
     soundDist(shootNear, mx, my);
@@ -942,7 +1055,8 @@ void shellsNetExtract(shells *value, pillboxes *pb, BYTE *buff, BYTE dataLen, bo
 *  bottomPos - Bottom position of rectangle
 *********************************************************/
 void shellsGetBrainShellsInRect(shells *value, BYTE leftPos, BYTE rightPos, BYTE topPos, BYTE bottomPos) {
-  shells position; /* The position in the stack of items */
+  shells q;        /* The shells pool */
+  int position;    /* The slot being looked at */
   BYTE owner;      /* Owner of the item */
   WORLD conv;      /* Used in converting items world co-ordinates */
   BYTE mx;         /* Shell X and Y Positions */
@@ -950,7 +1064,11 @@ void shellsGetBrainShellsInRect(shells *value, BYTE leftPos, BYTE rightPos, BYTE
   BYTE playerNum;  /* Our player number       */
 
   playerNum = playersGetSelf(screenGetPlayers());
-  position = *value;
+  q = *value;
+  if (q == NULL) {
+    return;
+  }
+  position = q->numShells;
 
 /* typedef struct
 	{
@@ -963,24 +1081,24 @@ void shellsGetBrainShellsInRect(shells *value, BYTE leftPos, BYTE rightPos, BYTE
 	} ObjectInfo;
 */
 
-  while (NonEmpty(position)) {
-    conv = position->x;
+  while (position > 0) {
+    position--;
+    conv = q->x[position];
     conv >>= TANK_SHIFT_MAPSIZE;
     mx = (BYTE) conv;
-    conv = position->y;
+    conv = q->y[position];
     conv >>= TANK_SHIFT_MAPSIZE;
     my = (BYTE) conv;
     if (mx >= leftPos && mx <= rightPos && my >= topPos && my <= bottomPos) {
       /* In the rectangle */
-      if (position->owner == NEUTRAL) {
+      if (q->owner[position] == NEUTRAL) {
         owner = SHELLS_BRAIN_NEUTRAL;
-      } else if (playersIsAllie(screenGetPlayers(), playerNum, position->owner) == TRUE) {
+      } else if (playersIsAllie(screenGetPlayers(), playerNum, q->owner[position]) == TRUE) {
         owner = SHELLS_BRAIN_FRIENDLY;
       } else {
         owner = SHELLS_BRAIN_HOSTILE;
       }
-      screenAddBrainObject(SHELLS_BRAIN_OBJECT_TYPE, position->x, position->y, 0, utilGet16Dir(position->angle), owner);
+      screenAddBrainObject(SHELLS_BRAIN_OBJECT_TYPE, q->x[position], q->y[position], 0, utilGet16Dir(q->angle[position]), owner);
     }
-    position = ShellsTail(position);
   }
 }
@@ -20,7 +20,7 @@
 *Filename:      shells.h
 *Author:        John Morrison
 *Creation Date: 25/12/98
-*Last Modified:  23/9/00
+*Last Modified: 16/10/26
 *Purpose:
 *  Responsable for Shells tracking/collision detect etc.
 *********************************************************/
@@ -32,6 +32,7 @@
 #include "types.h"
 #include "util.h"
 #include "screenbullet.h"
+#include "tankgrid.h"
 
 /* Empty / Non Empty / Head / Tail Macros */
 #define IsEmpty(list) ((list) ==NULL)
@@ -65,26 +66,55 @@
 #define SHELLS_BRAIN_OBJECT_TYPE 1
 
 
+/* Maximum number of shells in flight at once. Shells fired
+   while the pool is full are dropped */
+#define MAX_SHELLS 1024
+
+/* Shell state flags */
+#define SHELL_FLAG_ONBOAT 1 /* Was the shell launched from a boat */
+#define SHELL_FLAG_SENT 2   /* Has this shell been included in a network packet yet */
+#define SHELL_FLAG_DEAD 4   /* Used to over come the if shell dies straight away and 
+                               hasn't been sent it never does. So we mark it dead
+                               and it doesn't get updated any more but exists till
+                               it gets sent (ie packSent == TRUE) */
+#define SHELL_FLAG_FREE 8   /* Deleted during an update, removed at the end of it */
+
 /* Type structure */
 
+/* Shells are held in a fixed pool with one array per field so
+   the per tick move is a straight loop over plain arrays. Slots
+   0 to numShells-1 are in use, in the order they were added.
+   The newest shell is processed first, as it was at the head of
+   the old linked list */
 typedef struct shellsObj *shells;
 struct shellsObj {
-  shells next;      /* Pointer to the next shell */
-  shells prev;      /* Pointer to previous item */
-  WORLD x;          /* Co-ords of the shell */
-  WORLD y;
-  TURNTYPE angle;   /* The angle the shell is firing */
-  BYTE length;      /* Number of map squares for the shell to fire */
-  BYTE owner;       /* Who owns the shell */
-  bool onBoat;      /* Was the shell launched from a boat */
-  bool packSent;    /* Has this shell been included in a network packet yet */
-  BYTE creator;     /* Creator machines player Number */
-  bool shellDead;   /* Used to over come the if shell dies straight away and 
-                       hasn't been sent it never does. So we mark it dead
-                       and it doesn't get updated any more but exists till
-                       it gets sent (ie packSent == TRUE) */
+  WORLD x[MAX_SHELLS];        /* Co-ords of the shell */
+  WORLD y[MAX_SHELLS];
+  WORLD xAdd[MAX_SHELLS];     /* Distance moved each tick, worked out once when fired */
+  WORLD yAdd[MAX_SHELLS];
+  WORLD newX[MAX_SHELLS];     /* Next position, used during shellsUpdate */
+  WORLD newY[MAX_SHELLS];
+  TURNTYPE angle[MAX_SHELLS]; /* The angle the shell is firing */
+  BYTE length[MAX_SHELLS];    /* Number of map squares for the shell to fire */
+  BYTE owner[MAX_SHELLS];     /* Who owns the shell */
+  BYTE creator[MAX_SHELLS];   /* Creator machines player Number */
+  BYTE flags[MAX_SHELLS];     /* SHELL_FLAG_ items */
+  int numShells;              /* Number of slots in use */
+  tankGrid tanks;             /* Tanks bucketed by position, rebuilt each update */
 };
 
+/* Size of one shell in shells net data */
+#define SHELLS_NET_ITEM_SIZE (2 * sizeof(WORLD) + sizeof(TURNTYPE) + 4)
+
+/* A shell taken for sending. data is the shell as written in
+   shells net data. mx, my and creator are kept so the data can
+   be filtered for each player */
+typedef struct {
+  BYTE data[SHELLS_NET_ITEM_SIZE];
+  BYTE mx;
+  BYTE my;
+  BYTE creator;
+} shellsNetItem;
 
 typedef struct shellsNetHitObj *shellsNetHit;
 struct shellsNetHitObj {
@@ -135,7 +165,7 @@ void shellsAddItem(shells *value, WORLD x, WORLD y, TURNTYPE angle, TURNTYPE len
 *NAME:          shellsUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE: 25/12/98
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Updates each shells position and checks for colisions
 *
@@ -166,16 +196,16 @@ void shellsDestroy(shells *value);
 *NAME:          shellsDeleteItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 25/12/98
-*LAST MODIFIED: 25/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Deletes the value from the master list
+*  Deletes a shell from the pool by marking its slot
+*  free. The slot is reclaimed at the end of shellsUpdate
 *
 *ARGUMENTS:
-*  master  - The master list of all shells
-*  value   - Pointer to the shells to delete. Also puts
-*            next shell its position
+*  value   - Pointer to the shells data structure
+*  itemNum - Slot of the shell to delete
 *********************************************************/
-void shellsDeleteItem(shells *master, shells *value);
+void shellsDeleteItem(shells *value, int itemNum);
 
 /*********************************************************
 *NAME:          shellsCalcScreenBullets
@@ -200,14 +230,16 @@ void shellsCalcScreenBullets(shells *value, screenBullets *sBullets, BYTE leftPo
 *NAME:          shellsCalcCollision
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/12/98
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Returns whether the collision has occured.
+*  Returns whether the collision has occured. Only the
+*  tanks the grid places near the shell are checked.
 *  
 *ARGUMENTS:
 *  map      - Pointer to the Map Structure
 *  pb       - Pointer to the pillboxes structure
 *  tk       - Pointer to an array of tank structures
+*  grid     - The tanks in tk bucketed by position
 *  bs       - Pointer to the bases structure
 *  xValue   - X position
 *  yValue   - Y position
@@ -217,7 +249,7 @@ void shellsCalcScreenBullets(shells *value, screenBullets *sBullets, BYTE leftPo
 *  numTanks - Number of tanks in the array
 *  isServer - TRUE if we are a server
 *********************************************************/
-bool shellsCalcCollision(map *mp, pillboxes *pb, tank *tk, bases *bs, WORLD *xValue, WORLD *yValue, TURNTYPE angle, BYTE owner, bool onBoat, BYTE numTanks, bool isServer);
+bool shellsCalcCollision(map *mp, pillboxes *pb, tank *tk, tankGrid *grid, bases *bs, WORLD *xValue, WORLD *yValue, TURNTYPE angle, BYTE owner, bool onBoat, BYTE numTanks, bool isServer);
 
 /*********************************************************
 *NAME:          shellsCheckRoad
@@ -259,6 +291,22 @@ BYTE shellsCheckRoad(map *mp, pillboxes *pb, bases *bs, BYTE mapX, BYTE mapY, TU
 *********************************************************/
 BYTE shellsNetMake(shells *value, BYTE *buff, BYTE noPlayerNum, bool sentState);
 
+/*********************************************************
+*NAME:          shellsNetTake
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Copies every shell not yet sent into items, in the
+*  order shellsNetMake would write them, and marks them
+*  as sent. Returns the number of items copied
+*
+*ARGUMENTS:
+*  value - Pointer to shells structure
+*  items - Array of MAX_SHELLS items to copy into
+*********************************************************/
+int shellsNetTake(shells *value, shellsNetItem *items);
+
 /*********************************************************
 *NAME:          shellsNetExtract
 *AUTHOR:        John Morrison
@@ -20,7 +20,7 @@
 *Filename:      swamp.h
 *Author:        John Morrison
 *Creation Date: 5/1/99
-*Last Modified: 18/1/99
+*Last Modified: 16/10/26
 *Purpose:
 *  Responsable for tracking lifetime of swamp when shot
 *  from a boat
@@ -30,14 +30,11 @@
 #define SWAMP_H
 
 #include "global.h"
+#include "tilelife.h"
 
-/* Empty / Non Empty / Head / Tail Macros */
+/* Empty / Non Empty Macros */
 #define IsEmpty(list) ((list) ==NULL)
 #define NonEmpty(list) (!IsEmpty(list))
-#define SwampHeadX(list) ((list)->x);
-#define SwampHeadY(list) ((list)->y);
-#define SwampHeadLength(list) ((list)->life);
-#define SwampTail(list) ((list)->next);
 
 /* How manu shots it takes to destroy a peice of grass */
 #define SWAMP_LIFE 4
@@ -50,47 +47,17 @@
 
 /* Type structure */
 
-typedef struct swampObj *swamp;
-struct swampObj {
-  swamp next; /* Next item */ 
-  BYTE x;     /* X and Y positions */
-  BYTE y;
-  BYTE life;  /* Life time of the swamp */
-};
+/* Damage is kept in the tile life layer shared with the other
+   terrain types */
+typedef tileLife swamp;
 
 /* Prototypes */
 
-/*********************************************************
-*NAME:          swampCreate
-*AUTHOR:        John Morrison
-*CREATION DATE: 5/1/99
-*LAST MODIFIED: 5/1/99
-*PURPOSE:
-*  Sets up the swamp data structure
-*
-*ARGUMENTS:
-*
-*********************************************************/
-void swampCreate(swamp *swmp);
-
-/*********************************************************
-*NAME:          swampDestroy
-*AUTHOR:        John Morrison
-*CREATION DATE: 5/1/99
-*LAST MODIFIED: 5/1/99
-*PURPOSE:
-*  Destroys and frees memory for the swamp data structure
-*
-*ARGUMENTS:
-*
-*********************************************************/
-void swampDestroy(swamp *swmp);
-
 /*********************************************************
 *NAME:          swampAddItem
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/1/99
-*LAST MODIFIED: 25/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Adds an item to the swamp data structure.
 *  If it already exists returns the terrain type of the
@@ -102,24 +69,11 @@ void swampDestroy(swamp *swmp);
 *********************************************************/
 BYTE swampAddItem(swamp *swmp, BYTE x, BYTE y);
 
-/*********************************************************
-*NAME:          swampDeleteItem
-*AUTHOR:        John Morrison
-*CREATION DATE: 5/1/99
-*LAST MODIFIED: 5/1/99
-*PURPOSE:
-*  Deletes the item for the given number
-*
-*ARGUMENTS:
-*  itemNum - The item number to get
-*********************************************************/
-void swampDeleteItem(swamp *swmp, int itemNum);
-
 /*********************************************************
 *NAME:          swampRemovePos
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/1/99
-*LAST MODIFIED: 18/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Removes an item from the swamp data structure if it 
 *  exists at a specific loaction. Otherwise the function
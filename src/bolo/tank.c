@@ -54,9 +54,13 @@
 #include "backend.h"
 #include "crc.h"
 #include "log.h"
+#include "../server/servernet.h"
 
 bool tankShuttingDown = FALSE; // Enourmouse HACK. Please Fix Me FIXME
 BYTE ct[50];
+/* Bytes of ct written since the tank was last sealed, one bit
+   per byte. CRC_TANK_SIZE must stay under 64 */
+unsigned long long ctDirty = 0;
 
 /*********************************************************
 *NAME:          tankCreate
@@ -105,6 +109,7 @@ void tankCreate(tank *value, starts *sts) {
   (*value)->autoHideGunsight = FALSE;
   (*value)->justFired = FALSE;
   (*value)->tankHitCount = 0;
+  (*value)->clearAmount = 1;
 
   /* Get the start position */
   screenSetInStartFind(TRUE);
@@ -2264,7 +2269,7 @@ void tankNearMines(map *mp, BYTE mx, BYTE my) {
 *NAME:          tankCheckGroundClear
 *AUTHOR:        John Morrison
 *CREATION DATE: 9/2/99
-*LAST MODIFIED: 9/1/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks that the ground beneath the tank is clear (ie no
 * one has built under our tank) If it is not it moves the
@@ -2277,7 +2282,6 @@ void tankNearMines(map *mp, BYTE mx, BYTE my) {
 *  bs    - Pointer to the bases structure
 *********************************************************/
 void tankCheckGroundClear(tank *value, map *mp, pillboxes *pb, bases *bs) {
-  static BYTE modAmount = 1;
   WORLD conv;   /* Used for conversions */
   BYTE bmx;     /* Tank map offsets */
   BYTE bmy;
@@ -2373,30 +2377,30 @@ void tankCheckGroundClear(tank *value, map *mp, pillboxes *pb, bases *bs) {
       int rnd = rand() % 6;
 //      srand((unsigned int) (rand() * time(NULL)));
       if (rnd < 3 ) {
-        (*value)->x = (WORLD) ((*value)->x + rand() % modAmount);
+        (*value)->x = (WORLD) ((*value)->x + rand() % (*value)->clearAmount);
       } else {
-        (*value)->x = (WORLD) ((*value)->x - rand() % modAmount);
+        (*value)->x = (WORLD) ((*value)->x - rand() % (*value)->clearAmount);
       }
       tankRegisterChangeWorld(value, CRC_WORLDX_OFFSET, (*value)->x);
-      modAmount++;
+      (*value)->clearAmount++;
     }
     if (downPos > 0) {
-      (*value)->y = (WORLD) ((*value)->y - rand() % modAmount);
+      (*value)->y = (WORLD) ((*value)->y - rand() % (*value)->clearAmount);
     } else if (downPos < 0) {
-      (*value)->y = (WORLD) ((*value)->y + rand() % modAmount);
+      (*value)->y = (WORLD) ((*value)->y + rand() % (*value)->clearAmount);
     } else {
       int rnd = rand() % 6;
 //      srand((unsigned int) (rand() * time(NULL)));
       if (rnd < 3 ) {
-        (*value)->y = (WORLD) ((*value)->y + rand() % modAmount);
+        (*value)->y = (WORLD) ((*value)->y + rand() % (*value)->clearAmount);
       } else {
-        (*value)->y = (WORLD) ((*value)->y - rand() % modAmount);
+        (*value)->y = (WORLD) ((*value)->y - rand() % (*value)->clearAmount);
       }
-      modAmount++;
+      (*value)->clearAmount++;
     }
     tankRegisterChangeWorld(value, CRC_WORLDY_OFFSET, (*value)->y);
   } else {
-    modAmount = 1;
+    (*value)->clearAmount = 1;
   }
 
 }
@@ -2775,7 +2779,7 @@ void tankAddHit(tank *value, int amount) {
     if (((*value)->tankHitCount > 10 && amount > 1) || ((*value)->tankHitCount > 9 && amount == 1)) {
       /* Cheater */
 //      printf("Cheat received form of armour!...\n");
-      netPlayersSetCheater((netPlayers *) serverNetGetNetPlayers(), (BYTE) serverCoreGetTankPlayer(value));
+      netPlayersSetCheater((netPlayers *) serverNetGetNetPlayers(serverCoreGetContext()), (BYTE) serverCoreGetTankPlayer(serverCoreGetContext(), value));
     }
   } else {
     /* Cheater? */
@@ -2786,26 +2790,37 @@ void tankAddHit(tank *value, int amount) {
 
 int tankCalcCRCSetup(tank *value) {
   memcpy(ct, *value, CRC_TANK_SIZE);
+  ctDirty = 0;
   return CRCCalc((BYTE *) ct, CRC_TANK_SIZE);
 }
 
+/*********************************************************
+*NAME:          tankRegisterChange
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Marks the bytes of a tank field as written this tick so
+*  tankCheckIntegrity does not count them as tampering.
+*  Returns if the check is done in this context
+*
+*ARGUMENTS:
+*  offset - CRC_ offset of the field
+*  size   - Size of the field
+*********************************************************/
+static bool tankRegisterChange(int offset, int size) {
+  if (threadsGetContext() == TRUE || netGetType() == netSingle) {
+    return FALSE;
+  }
+  ctDirty |= ((1ULL << size) - 1) << offset;
+  return TRUE;
+}
+
 void tankRegisterChangeFloat(tank *value, int offset, float newValue) {
   float tempValue;
-  int crc;
   BYTE *original = (BYTE *) *value;
 
-  if (threadsGetContext() == FALSE && netGetType() != netSingle) {
-    memcpy(&tempValue, (ct+offset), sizeof(float));
-    memcpy(ct, *value, CRC_TANK_SIZE);
-    memcpy(ct+offset, &tempValue, sizeof(float));
-    crc = CRCCalc((BYTE *) ct, CRC_TANK_SIZE);
-    if (crc != (*value)->crc) {
-      netMNTAdd(screenGetNetMnt(), NMNT_TANKHIT, playersGetSelf(screenGetPlayers()), playersGetSelf(screenGetPlayers()), 0xFF , 0xFF);
-    }
-
-    memcpy(ct+offset, &newValue, sizeof(float));
-    crc = CRCCalc((BYTE *) *value, CRC_TANK_SIZE);
-    (*value)->crc = crc;
+  if (tankRegisterChange(offset, sizeof(float)) == TRUE) {
     memcpy(&tempValue, (original+offset), sizeof(float));
     if (newValue != tempValue) {
       netMNTAdd(screenGetNetMnt(), NMNT_TANKHIT, playersGetSelf(screenGetPlayers()), playersGetSelf(screenGetPlayers()), 0xFF , 0xFF);
@@ -2815,21 +2830,9 @@ void tankRegisterChangeFloat(tank *value, int offset, float newValue) {
 
 void tankRegisterChangeWorld(tank *value, int offset, WORLD newValue) {
   WORLD tempValue;
-  int crc = sizeof(WORLD);
   BYTE *original = (BYTE *) *value;
 
-  if (threadsGetContext() == FALSE && netGetType() != netSingle) {
-    memcpy(&tempValue, (ct+offset), sizeof(WORLD));
-    memcpy(ct, *value, CRC_TANK_SIZE);
-    memcpy(ct+offset, &tempValue, sizeof(WORLD));
-    crc = CRCCalc((BYTE *) ct, CRC_TANK_SIZE);
-    if (crc != (*value)->crc) {
-      netMNTAdd(screenGetNetMnt(), NMNT_TANKHIT, playersGetSelf(screenGetPlayers()), playersGetSelf(screenGetPlayers()), 0xFF , 0xFF);
-    }
-
-    memcpy(ct+offset, &newValue, sizeof(WORLD));
-    crc = CRCCalc((BYTE *) *value, CRC_TANK_SIZE);
-    (*value)->crc = crc;
+  if (tankRegisterChange(offset, sizeof(WORLD)) == TRUE) {
     memcpy(&tempValue, original+offset, sizeof(WORLD));
     if (newValue != tempValue) {
       netMNTAdd(screenGetNetMnt(), NMNT_TANKHIT, playersGetSelf(screenGetPlayers()), playersGetSelf(screenGetPlayers()), 0xFF , 0xFF);
@@ -2839,21 +2842,9 @@ void tankRegisterChangeWorld(tank *value, int offset, WORLD newValue) {
 
 void tankRegisterChangeInt(tank *value, int offset, int newValue) {
   int tempValue;
-  int crc;
   BYTE *original = (BYTE *) *value;
 
-  if (threadsGetContext() == FALSE && netGetType() != netSingle) {
-    memcpy(&tempValue, (ct+offset), sizeof(int));
-    memcpy(ct, *value, CRC_TANK_SIZE);
-    memcpy(ct+offset, &tempValue, sizeof(int));
-    crc = CRCCalc((BYTE *) ct, CRC_TANK_SIZE);
-    if (crc != (*value)->crc) {
-      netMNTAdd(screenGetNetMnt(), NMNT_TANKHIT, playersGetSelf(screenGetPlayers()), playersGetSelf(screenGetPlayers()), 0xFF , 0xFF);
-    }
-
-    memcpy(ct+offset, &newValue, sizeof(int));
-    crc = CRCCalc((BYTE *) *value, CRC_TANK_SIZE);
-    (*value)->crc = crc;
+  if (tankRegisterChange(offset, sizeof(int)) == TRUE) {
     memcpy(&tempValue, original+offset, sizeof(int));
     if (newValue != tempValue) {
       netMNTAdd(screenGetNetMnt(), NMNT_TANKHIT, playersGetSelf(screenGetPlayers()), playersGetSelf(screenGetPlayers()), 0xFF , 0xFF);
@@ -2862,31 +2853,50 @@ void tankRegisterChangeInt(tank *value, int offset, int newValue) {
 }
 
 void tankRegisterChangeByte(tank *value, int offset, BYTE newValue) {
-  BYTE tempValue;
-  int crc = sizeof(BYTE);
   BYTE *original = (BYTE *) *value;
-  
 
-  if (threadsGetContext() == FALSE && netGetType() != netSingle) {
-    //memcpy(&tempValue, (ct+offset), sizeof(BYTE));
-    tempValue = *(ct+offset);
-    memcpy(ct, *value, CRC_TANK_SIZE);
-    
-    //memcpy(ct+offset, &tempValue, sizeof(BYTE));
-    *(ct+offset) = tempValue;
-    crc = CRCCalc((BYTE *) ct, CRC_TANK_SIZE);
-    if (crc != (*value)->crc) {
+  if (tankRegisterChange(offset, sizeof(BYTE)) == TRUE) {
+    if (newValue != *(original+offset)) {
       netMNTAdd(screenGetNetMnt(), NMNT_TANKHIT, playersGetSelf(screenGetPlayers()), playersGetSelf(screenGetPlayers()), 0xFF , 0xFF);
     }
+  }
+}
 
-    *(ct+offset) = newValue;
-    crc = CRCCalc((BYTE *) *value, CRC_TANK_SIZE);
-    (*value)->crc = crc;
-    memcpy(&tempValue, original+offset, sizeof(BYTE));
-    if (newValue != tempValue) {
-      netMNTAdd(screenGetNetMnt(), NMNT_TANKHIT, playersGetSelf(screenGetPlayers()), playersGetSelf(screenGetPlayers()), 0xFF , 0xFF);
+/*********************************************************
+*NAME:          tankCheckIntegrity
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Checks the tank has only changed where fields were
+*  registered since it was last sealed, then seals it
+*  again. With the registered bytes put back to their
+*  sealed values the tank must give the sealed CRC. A
+*  mismatch is reported to the server as a cheat.
+*
+*ARGUMENTS:
+*  value - Pointer to the tank structure
+*********************************************************/
+void tankCheckIntegrity(tank *value) {
+  BYTE check[CRC_TANK_SIZE]; /* Tank with registered bytes undone */
+  int count;                 /* Looping variable */
+
+  if (threadsGetContext() == TRUE || netGetType() == netSingle) {
+    return;
+  }
+
+  memcpy(check, *value, CRC_TANK_SIZE);
+  if (ctDirty != 0) {
+    for (count=0;count<CRC_TANK_SIZE;count++) {
+      if ((ctDirty >> count) & 1) {
+        check[count] = ct[count];
+      }
     }
   }
+  if (CRCCalc(check, CRC_TANK_SIZE) != (*value)->crc) {
+    netMNTAdd(screenGetNetMnt(), NMNT_TANKHIT, playersGetSelf(screenGetPlayers()), playersGetSelf(screenGetPlayers()), 0xFF , 0xFF);
+  }
+  (*value)->crc = tankCalcCRCSetup(value);
 }
 
 
@@ -975,7 +975,7 @@ void tankNearMines(map *mp, BYTE mx, BYTE my);
 *NAME:          tankCheckGroundClear
 *AUTHOR:        John Morrison
 *CREATION DATE: 9/2/99
-*LAST MODIFIED: 9/1/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks that the ground beneath the tank is clear (ie no
 * one has built under our tank) If it is not it moves the
@@ -1257,6 +1257,23 @@ void tankRegisterChangeWorld(tank *value, int offset, WORLD newValue);
 void tankRegisterChangeInt(tank *value, int offset, int newValue);
 void tankRegisterChangeByte(tank *value, int offset, BYTE newValue);
 
+/*********************************************************
+*NAME:          tankCheckIntegrity
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Checks the tank has only changed where fields were
+*  registered since it was last sealed, then seals it
+*  again. With the registered bytes put back to their
+*  sealed values the tank must give the sealed CRC. A
+*  mismatch is reported to the server as a cheat.
+*
+*ARGUMENTS:
+*  value - Pointer to the tank structure
+*********************************************************/
+void tankCheckIntegrity(tank *value);
+
 /*********************************************************
 *NAME:          tankSetOnBoat
 *AUTHOR:        John Morrison
@@ -127,19 +127,20 @@ void tkExplosionAddItem(tkExplosion *tke, WORLD x, WORLD y, TURNTYPE angle, BYTE
 *NAME:          tkExplosionUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/01/99
-*LAST MODIFIED: 04/04/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Updates each tkExplosion position
 *
 *ARGUMENTS:
-*  tke    - Pointer to the tank explosions object
-*  mp     - Pointer to the map structure
-*  pb     - Pointer to the pillbox structure
-*  bs     - Pointer to the bases structure
-*  lgms   - Array of lgms
-*  numLgm - Number of lgms in the array
+*  tke        - Pointer to the tank explosions object
+*  mp         - Pointer to the map structure
+*  pb         - Pointer to the pillbox structure
+*  bs         - Pointer to the bases structure
+*  lgms       - Array of lgms
+*  numLgm     - Number of lgms in the array
+*  updateTime - Ticks since the last update
 *********************************************************/
-void tkExplosionUpdate(tkExplosion *tke, map *mp, pillboxes *pb, bases *bs, lgm **lgms, BYTE numLgm);
+void tkExplosionUpdate(tkExplosion *tke, map *mp, pillboxes *pb, bases *bs, lgm **lgms, BYTE numLgm, BYTE *updateTime);
 
 /*********************************************************
 *NAME:          tkExplosionDeleteItem
@@ -0,0 +1,241 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Tank Grid
+*Filename:      tankgrid.c
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Buckets tanks by position so collision checks only
+*  look at the tanks near a point instead of all of them
+*********************************************************/
+
+#include <string.h>
+#include "global.h"
+#include "tankgrid.h"
+
+#ifdef BOLO_PROFILE
+static unsigned long long tankGridPairs = 0; /* Slots in the grid at each query */
+static unsigned long long tankGridNear = 0;  /* Slots returned by each query */
+#endif
+
+/*********************************************************
+*NAME:          tankGridCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates an empty tank grid
+*
+*ARGUMENTS:
+*
+*********************************************************/
+tankGrid tankGridCreate(void) {
+  tankGrid returnValue; /* Value to return */
+
+  New(returnValue);
+  memset(returnValue, 0, sizeof(*returnValue));
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          tankGridDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys and frees memory for a tank grid
+*
+*ARGUMENTS:
+*  value - Pointer to the tank grid
+*********************************************************/
+void tankGridDestroy(tankGrid *value) {
+  if (*value != NULL) {
+    Dispose(*value);
+    *value = NULL;
+  }
+}
+
+/*********************************************************
+*NAME:          tankGridClear
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Removes every slot from the grid. Only the cells that
+*  are in use are touched
+*
+*ARGUMENTS:
+*  value - Pointer to the tank grid
+*********************************************************/
+void tankGridClear(tankGrid *value) {
+  BYTE count; /* Looping variable */
+
+  for (count=0;count<MAX_TANKS;count++) {
+    if ((*value)->used & (1 << count)) {
+      (*value)->cell[(*value)->cellY[count]][(*value)->cellX[count]] = 0;
+    }
+  }
+  (*value)->used = 0;
+}
+
+/*********************************************************
+*NAME:          tankGridSet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Places a slot in the grid or moves it if it is
+*  already there
+*
+*ARGUMENTS:
+*  value - Pointer to the tank grid
+*  slot  - Slot number (0 to MAX_TANKS-1)
+*  x     - World X co-ordinate of the tank
+*  y     - World Y co-ordinate of the tank
+*********************************************************/
+void tankGridSet(tankGrid *value, BYTE slot, WORLD x, WORLD y) {
+  BYTE cx; /* Cell the slot goes in */
+  BYTE cy;
+
+  cx = (BYTE) (x >> TANK_GRID_SHIFT);
+  cy = (BYTE) (y >> TANK_GRID_SHIFT);
+  if ((*value)->used & (1 << slot)) {
+    if ((*value)->cellX[slot] == cx && (*value)->cellY[slot] == cy) {
+      return;
+    }
+    (*value)->cell[(*value)->cellY[slot]][(*value)->cellX[slot]] &= (tankGridMask) ~(1 << slot);
+  }
+  (*value)->cell[cy][cx] |= (tankGridMask) (1 << slot);
+  (*value)->cellX[slot] = cx;
+  (*value)->cellY[slot] = cy;
+  (*value)->used |= (tankGridMask) (1 << slot);
+}
+
+/*********************************************************
+*NAME:          tankGridRemove
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Removes a slot from the grid
+*
+*ARGUMENTS:
+*  value - Pointer to the tank grid
+*  slot  - Slot number (0 to MAX_TANKS-1)
+*********************************************************/
+void tankGridRemove(tankGrid *value, BYTE slot) {
+  if ((*value)->used & (1 << slot)) {
+    (*value)->cell[(*value)->cellY[slot]][(*value)->cellX[slot]] &= (tankGridMask) ~(1 << slot);
+    (*value)->used &= (tankGridMask) ~(1 << slot);
+  }
+}
+
+/*********************************************************
+*NAME:          tankGridGetNear
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns a mask of every slot that may be within range
+*  world units of x,y on both axis. Slots not in the mask
+*  are certainly out of range. Callers walk the mask from
+*  the lowest bit up so slots are visited in the same
+*  order as a scan of the whole array
+*
+*ARGUMENTS:
+*  value - Pointer to the tank grid
+*  x     - World X co-ordinate to check around
+*  y     - World Y co-ordinate to check around
+*  range - Distance in world units to check
+*********************************************************/
+tankGridMask tankGridGetNear(tankGrid *value, WORLD x, WORLD y, WORLD range) {
+  tankGridMask returnValue; /* Value to return */
+  int left;                 /* Cells to check */
+  int right;
+  int top;
+  int bottom;
+  int cx;                   /* Looping variables */
+  int cy;
+
+  returnValue = 0;
+  left = (x > range) ? (x - range) : 0;
+  right = (x + range > WORLD_MAX) ? WORLD_MAX : (x + range);
+  top = (y > range) ? (y - range) : 0;
+  bottom = (y + range > WORLD_MAX) ? WORLD_MAX : (y + range);
+  left >>= TANK_GRID_SHIFT;
+  right >>= TANK_GRID_SHIFT;
+  top >>= TANK_GRID_SHIFT;
+  bottom >>= TANK_GRID_SHIFT;
+
+  for (cy=top;cy<=bottom;cy++) {
+    for (cx=left;cx<=right;cx++) {
+      returnValue |= (*value)->cell[cy][cx];
+    }
+  }
+
+#ifdef BOLO_PROFILE
+  for (cx=0;cx<MAX_TANKS;cx++) {
+    if ((*value)->used & (1 << cx)) {
+      tankGridPairs++;
+    }
+    if (returnValue & (1 << cx)) {
+      tankGridNear++;
+    }
+  }
+#endif
+  return returnValue;
+}
+
+#ifdef BOLO_PROFILE
+/*********************************************************
+*NAME:          tankGridProfileReset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Zeros the grid query counters
+*
+*ARGUMENTS:
+*
+*********************************************************/
+void tankGridProfileReset(void) {
+  tankGridPairs = 0;
+  tankGridNear = 0;
+}
+
+/*********************************************************
+*NAME:          tankGridProfileGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the grid query counters since the last reset
+*
+*ARGUMENTS:
+*  pairs  - Tanks a scan of every slot would have checked
+*  nearby - Tanks the grid returned to be checked
+*********************************************************/
+void tankGridProfileGet(unsigned long long *pairs, unsigned long long *nearby) {
+  *pairs = tankGridPairs;
+  *nearby = tankGridNear;
+}
+#endif
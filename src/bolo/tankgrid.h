@@ -0,0 +1,179 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Tank Grid
+*Filename:      tankgrid.h
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Buckets tanks by position so collision checks only
+*  look at the tanks near a point instead of all of them
+*********************************************************/
+
+#ifndef TANKGRID_H
+#define TANKGRID_H
+
+#include "global.h"
+
+/* Each cell is 2x2 map squares (512 world units). Shell and
+   tank collision ranges are at most 256 so a query touches
+   at most 2x2 cells */
+#define TANK_GRID_SHIFT 9
+#define TANK_GRID_SIZE 128
+
+/* One bit per tank slot */
+typedef unsigned short tankGridMask;
+
+#if MAX_TANKS > 16
+#error tankGridMask must have a bit for every tank
+#endif
+
+typedef struct tankGridObj *tankGrid;
+struct tankGridObj {
+  tankGridMask cell[TANK_GRID_SIZE][TANK_GRID_SIZE]; /* Tanks in each cell */
+  BYTE cellX[MAX_TANKS];                             /* Cell each slot is in */
+  BYTE cellY[MAX_TANKS];
+  tankGridMask used;                                 /* Slots in the grid */
+};
+
+/* Prototypes */
+
+/*********************************************************
+*NAME:          tankGridCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates an empty tank grid
+*
+*ARGUMENTS:
+*
+*********************************************************/
+tankGrid tankGridCreate(void);
+
+/*********************************************************
+*NAME:          tankGridDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys and frees memory for a tank grid
+*
+*ARGUMENTS:
+*  value - Pointer to the tank grid
+*********************************************************/
+void tankGridDestroy(tankGrid *value);
+
+/*********************************************************
+*NAME:          tankGridClear
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Removes every slot from the grid. Only the cells that
+*  are in use are touched
+*
+*ARGUMENTS:
+*  value - Pointer to the tank grid
+*********************************************************/
+void tankGridClear(tankGrid *value);
+
+/*********************************************************
+*NAME:          tankGridSet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Places a slot in the grid or moves it if it is
+*  already there
+*
+*ARGUMENTS:
+*  value - Pointer to the tank grid
+*  slot  - Slot number (0 to MAX_TANKS-1)
+*  x     - World X co-ordinate of the tank
+*  y     - World Y co-ordinate of the tank
+*********************************************************/
+void tankGridSet(tankGrid *value, BYTE slot, WORLD x, WORLD y);
+
+/*********************************************************
+*NAME:          tankGridRemove
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Removes a slot from the grid
+*
+*ARGUMENTS:
+*  value - Pointer to the tank grid
+*  slot  - Slot number (0 to MAX_TANKS-1)
+*********************************************************/
+void tankGridRemove(tankGrid *value, BYTE slot);
+
+/*********************************************************
+*NAME:          tankGridGetNear
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns a mask of every slot that may be within range
+*  world units of x,y on both axis. Slots not in the mask
+*  are certainly out of range. Callers walk the mask from
+*  the lowest bit up so slots are visited in the same
+*  order as a scan of the whole array
+*
+*ARGUMENTS:
+*  value - Pointer to the tank grid
+*  x     - World X co-ordinate to check around
+*  y     - World Y co-ordinate to check around
+*  range - Distance in world units to check
+*********************************************************/
+tankGridMask tankGridGetNear(tankGrid *value, WORLD x, WORLD y, WORLD range);
+
+#ifdef BOLO_PROFILE
+/*********************************************************
+*NAME:          tankGridProfileReset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Zeros the grid query counters
+*
+*ARGUMENTS:
+*
+*********************************************************/
+void tankGridProfileReset(void);
+
+/*********************************************************
+*NAME:          tankGridProfileGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the grid query counters since the last reset
+*
+*ARGUMENTS:
+*  pairs  - Tanks a scan of every slot would have checked
+*  nearby - Tanks the grid returned to be checked
+*********************************************************/
+void tankGridProfileGet(unsigned long long *pairs, unsigned long long *nearby);
+#endif
+
+#endif /* TANKGRID_H */
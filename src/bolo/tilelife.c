@@ -0,0 +1,133 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Tile Life
+*Filename:      tilelife.c
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Tracks the remaining life of damaged map squares.
+*  Grass, rubble, swamp and buildings share one byte per
+*  map square holding which of them was damaged and how
+*  many more shots it can take.
+*********************************************************/
+
+#include <string.h>
+#include "global.h"
+#include "tilelife.h"
+
+/*********************************************************
+*NAME:          tileLifeCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Sets up the tile life data structure with every
+*  square undamaged
+*
+*ARGUMENTS:
+*  tl - Pointer to the tile life object
+*********************************************************/
+void tileLifeCreate(tileLife *tl) {
+  New(*tl);
+  memset(*tl, TILE_LIFE_NONE, sizeof(**tl));
+}
+
+/*********************************************************
+*NAME:          tileLifeDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys and frees memory for the tile life data
+*  structure
+*
+*ARGUMENTS:
+*  tl - Pointer to the tile life object
+*********************************************************/
+void tileLifeDestroy(tileLife *tl) {
+  if (*tl != NULL) {
+    Dispose(*tl);
+    *tl = NULL;
+  }
+}
+
+/*********************************************************
+*NAME:          tileLifeAddItem
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  A square has been shot. If it is not already damaged
+*  as this kind it starts with life shots left, otherwise
+*  its life is decremented. Returns TRUE if the square
+*  has run out of life, in which case it is cleared.
+*
+*ARGUMENTS:
+*  tl   - Pointer to the tile life object
+*  kind - TILE_LIFE_ kind of terrain shot
+*  life - Life of a newly damaged square
+*  x    - X co-ord
+*  y    - Y co-ord
+*********************************************************/
+bool tileLifeAddItem(tileLife *tl, BYTE kind, BYTE life, BYTE x, BYTE y) {
+  bool returnValue; /* Value to return */
+  BYTE current;     /* Current state of the square */
+
+  returnValue = FALSE;
+  current = (*tl)->item[x][y];
+  if ((current & TILE_LIFE_MASK) != TILE_LIFE_NONE && (current >> TILE_LIFE_KIND_SHIFT) == kind) {
+    current--;
+    if ((current & TILE_LIFE_MASK) == TILE_LIFE_NONE) {
+      returnValue = TRUE;
+      current = TILE_LIFE_NONE;
+    }
+  } else {
+    current = (BYTE) ((kind << TILE_LIFE_KIND_SHIFT) | (life & TILE_LIFE_MASK));
+  }
+  (*tl)->item[x][y] = current;
+
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          tileLifeRemovePos
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Clears the damage at a square if it is damaged as
+*  this kind. Otherwise the function does nothing
+*
+*ARGUMENTS:
+*  tl   - Pointer to the tile life object
+*  kind - TILE_LIFE_ kind of terrain
+*  x    - X co-ord
+*  y    - Y co-ord
+*********************************************************/
+void tileLifeRemovePos(tileLife *tl, BYTE kind, BYTE x, BYTE y) {
+  BYTE current; /* Current state of the square */
+
+  current = (*tl)->item[x][y];
+  if ((current & TILE_LIFE_MASK) != TILE_LIFE_NONE && (current >> TILE_LIFE_KIND_SHIFT) == kind) {
+    (*tl)->item[x][y] = TILE_LIFE_NONE;
+  }
+}
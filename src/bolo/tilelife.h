@@ -0,0 +1,125 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          Tile Life
+*Filename:      tilelife.h
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  Tracks the remaining life of damaged map squares.
+*  Grass, rubble, swamp and buildings share one byte per
+*  map square holding which of them was damaged and how
+*  many more shots it can take.
+*********************************************************/
+
+#ifndef TILELIFE_H
+#define TILELIFE_H
+
+#include "global.h"
+#include "types.h"
+
+/* Kinds of damaged terrain */
+#define TILE_LIFE_GRASS 0
+#define TILE_LIFE_RUBBLE 1
+#define TILE_LIFE_SWAMP 2
+#define TILE_LIFE_BUILDING 3
+
+/* Each square is (kind << TILE_LIFE_KIND_SHIFT) | life. A life
+   of 0 means the square is undamaged */
+#define TILE_LIFE_MASK 7
+#define TILE_LIFE_KIND_SHIFT 3
+#define TILE_LIFE_NONE 0
+
+/* Type structure */
+
+typedef struct tileLifeObj *tileLife;
+struct tileLifeObj {
+  BYTE item[MAP_ARRAY_SIZE][MAP_ARRAY_SIZE];
+};
+
+/* Prototypes */
+
+/*********************************************************
+*NAME:          tileLifeCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Sets up the tile life data structure with every
+*  square undamaged
+*
+*ARGUMENTS:
+*  tl - Pointer to the tile life object
+*********************************************************/
+void tileLifeCreate(tileLife *tl);
+
+/*********************************************************
+*NAME:          tileLifeDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys and frees memory for the tile life data
+*  structure
+*
+*ARGUMENTS:
+*  tl - Pointer to the tile life object
+*********************************************************/
+void tileLifeDestroy(tileLife *tl);
+
+/*********************************************************
+*NAME:          tileLifeAddItem
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  A square has been shot. If it is not already damaged
+*  as this kind it starts with life shots left, otherwise
+*  its life is decremented. Returns TRUE if the square
+*  has run out of life, in which case it is cleared.
+*
+*ARGUMENTS:
+*  tl   - Pointer to the tile life object
+*  kind - TILE_LIFE_ kind of terrain shot
+*  life - Life of a newly damaged square
+*  x    - X co-ord
+*  y    - Y co-ord
+*********************************************************/
+bool tileLifeAddItem(tileLife *tl, BYTE kind, BYTE life, BYTE x, BYTE y);
+
+/*********************************************************
+*NAME:          tileLifeRemovePos
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Clears the damage at a square if it is damaged as
+*  this kind. Otherwise the function does nothing
+*
+*ARGUMENTS:
+*  tl   - Pointer to the tile life object
+*  kind - TILE_LIFE_ kind of terrain
+*  x    - X co-ord
+*  y    - Y co-ord
+*********************************************************/
+void tileLifeRemovePos(tileLife *tl, BYTE kind, BYTE x, BYTE y);
+
+#endif /* TILELIFE_H */
@@ -21,6 +21,12 @@
 #include "global.h"
 /* Defines */
 #define MAX_BASES 16
+#define MAP_ARRAY_SIZE 256 /* maps are 256x256 units square */
+
+/* Position index entries for pills and bases. Otherwise the
+   1-based item number that is the only item on the square */
+#define POS_INDEX_NONE 0       /* Nothing on this square */
+#define POS_INDEX_STACKED 0xFF /* More than one item on this square */
 
 
 /* Typedefs */
@@ -45,29 +51,68 @@ typedef struct basesObj *bases;
 struct basesObj {
   base item[MAX_BASES];
   BYTE numBases;
+  BYTE pos[MAP_ARRAY_SIZE][MAP_ARRAY_SIZE]; /* Base number at each map square */
 };
 
-#define MAP_ARRAY_SIZE 256 /* maps are 256x256 units square */
+/* Pending map changes are kept in a pool and found through
+   a table indexed by map square. Index 0 is unused so a
+   zeroed table means nothing is pending. The pool starts
+   with MAP_NET_POOL_SIZE items and doubles when it is used
+   up, to at most MAP_NET_MAX_ITEMS */
+typedef unsigned short mapNetIndex;
+#define MAP_NET_NONE 0
+#define MAP_NET_POOL_SIZE 1024
+#define MAP_NET_MAX_ITEMS 65535
+
+/* Timing wheel buckets for ageing pending changes. Must be a
+   power of two greater than MAP_MAX_SERVER_WAIT + 1 as used
+   by bolo_map.c */
+#define MAP_NET_WHEEL_SIZE 256
+
+/* Which list a pending change is on */
+#define MAP_NET_OUT 0 /* Waiting to be sent or confirmed */
+#define MAP_NET_IN 1  /* Arrived before our own change did */
+
+/* Queue a pending change waits on. Otherwise it is the wheel
+   bucket + 1 */
+#define MAP_NET_UNQUEUED 0
+#define MAP_NET_SEND 0xFFFF
 
-typedef struct mapNetObj *mapNet;
-struct mapNetObj {
-  mapNet next;     /* Next item */
-  mapNet prev;     /* Next item */
-  BYTE mx;         /* X Map position */
-  BYTE my;         /* Y Map position */
-  BYTE terrain;    /* New terrain at that position */
-  BYTE oldTerrain; /* The old terrain at that position */
-  bool needSend;   /* Do we need to send this?         */
-  BYTE length;     /* How long have we been waiting for the server? */
-};
+typedef struct {
+  BYTE mx;               /* X Map position */
+  BYTE my;               /* Y Map position */
+  BYTE terrain;          /* New terrain at that position */
+  BYTE oldTerrain;       /* The old terrain at that position */
+  bool needSend;         /* Do we need to send this?         */
+  BYTE list;             /* MAP_NET_OUT or MAP_NET_IN */
+  unsigned short bucket; /* Queue the item is waiting on */
+  unsigned long seq;     /* Order added. Higher is newer */
+  mapNetIndex nextPos;   /* Next item on the same square */
+  mapNetIndex next;      /* Next item on the list, or free list */
+  mapNetIndex prev;      /* Previous item on the list */
+  mapNetIndex waitNext;  /* Next item on the same queue */
+  mapNetIndex waitPrev;  /* Previous item on the same queue */
+} mapNetItem;
 
 
 typedef struct mapObj *map;
 
 struct mapObj {
 	BYTE mapItem[MAP_ARRAY_SIZE][MAP_ARRAY_SIZE]; /* The actual map */
-  mapNet mn;
-  mapNet mninc;
+  mapNetItem *netItem;                           /* Pool of pending changes */
+  mapNetIndex netSize;                           /* Items in the pool after index 0 */
+  mapNetIndex netPos[MAP_ARRAY_SIZE][MAP_ARRAY_SIZE]; /* First pending change on each square */
+  mapNetIndex netFree;                           /* Unused pool items */
+  unsigned long netLost;                         /* Changes dropped as the pool could not grow */
+  mapNetIndex mn;                                /* Outgoing changes, newest first */
+  mapNetIndex mnSend;                            /* Outgoing changes still to send, newest first */
+  mapNetIndex wheel[2][MAP_NET_WHEEL_SIZE];      /* Ageing items of each list by bucket */
+  unsigned long netTick;                         /* mapNetUpdate calls so far */
+  unsigned long netSeq;                          /* Sequence of the next item */
+  BYTE dirtyRows[MAP_ARRAY_SIZE / 8];            /* Rows changed since the net run cache looked */
+  BYTE changed[MAP_ARRAY_SIZE][MAP_ARRAY_SIZE / 8]; /* Squares changed since the screen looked, by row */
+  BYTE changedRows[MAP_ARRAY_SIZE / 8];          /* Rows with a square set in changed */
+  bool changedAll;                               /* Every square changed */
 } mapObj;
 
 
@@ -94,6 +139,7 @@ typedef struct pillsObj *pillboxes;
 struct pillsObj {
   pillbox item[MAX_PILLS];
   BYTE numPills;
+  BYTE pos[MAP_ARRAY_SIZE][MAP_ARRAY_SIZE]; /* Pill number at each map square */
 };
 
 
@@ -157,6 +203,7 @@ struct tankObj {
   BYTE tankHitCount;  /* Number of times a tank has been hit to determine if they are cheating */
   int crc; /* CRC used to detect memory cheats */
   tankCarryPb carryPills; /* The Pillboxes being carried */  
+  BYTE clearAmount;  /* Most an obstructed tank is moved each tick. Grows till the ground is clear */
 };
 
 #pragma pack(pop, enter_tank_obj,1)
@@ -20,7 +20,7 @@
 *Filename:      udppackets.c
 *Author:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *Purpose:
 * Handles keeping track of network packets for
 * retransmission on errors
@@ -56,16 +56,420 @@
 * 7. If invalid sends back a packet request for missing 
 *    sequence number(s) and stores packets at sequence
 *    position for processing.
+*
+* Packets are kept in a ring of variable length records per
+* direction. Ring arenas come from a pool shared by every
+* udpPackets item so a player leaving hands its memory to
+* the next one to join.
 *********************************************************/
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include "SDL.h"
+typedef SDL_mutex *HANDLE;
+#endif
+#include <string.h>
 #include "global.h"
 #include "udppackets.h"
 
+/* Arenas waiting for reuse by size class. Each free arena
+   holds a pointer to the next */
+static BYTE *udpPoolFree[UDP_ARENA_CLASSES] = { NULL };
+static int udpPoolHeld = 0;   /* Bytes of arena handed out */
+static int udpPoolPooled = 0; /* Bytes of arena waiting for reuse */
+static HANDLE udpPoolMutex = NULL;
+
+/* Returned for a sequence number with no packet */
+static BYTE udpNoPacket[1] = { 0 };
+
+/*********************************************************
+*NAME:          udpPoolLock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Waits for the pool. The client and its server share it
+*
+*ARGUMENTS:
+*
+*********************************************************/
+static void udpPoolLock(void) {
+#ifdef _WIN32
+  WaitForSingleObject(udpPoolMutex, INFINITE);
+#else
+  SDL_mutexP(udpPoolMutex);
+#endif
+}
+
+/*********************************************************
+*NAME:          udpPoolUnlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Releases the pool
+*
+*ARGUMENTS:
+*
+*********************************************************/
+static void udpPoolUnlock(void) {
+#ifdef _WIN32
+  ReleaseMutex(udpPoolMutex);
+#else
+  SDL_mutexV(udpPoolMutex);
+#endif
+}
+
+/*********************************************************
+*NAME:          udpPoolTake
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns an arena of size class sizeClass, reusing one
+* from the pool if it can. Returns NULL on error
+*
+*ARGUMENTS:
+* sizeClass - Size class. The arena is UDP_ARENA_MIN 
+*             shifted left by this
+*********************************************************/
+static BYTE *udpPoolTake(int sizeClass) {
+  BYTE *returnValue; /* Value to return */
+  int size;          /* Size of the arena */
+
+  size = UDP_ARENA_MIN << sizeClass;
+  udpPoolLock();
+  returnValue = udpPoolFree[sizeClass];
+  if (returnValue != NULL) {
+    memcpy(&udpPoolFree[sizeClass], returnValue, sizeof(BYTE *));
+    udpPoolPooled -= size;
+  } else {
+    returnValue = (BYTE *) emalloc((size_t) size);
+  }
+  if (returnValue != NULL) {
+    udpPoolHeld += size;
+  }
+  udpPoolUnlock();
+
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          udpPoolGive
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns an arena to the pool for reuse
+*
+*ARGUMENTS:
+* arena     - Arena to return
+* sizeClass - Size class it was taken as
+*********************************************************/
+static void udpPoolGive(BYTE *arena, int sizeClass) {
+  int size; /* Size of the arena */
+
+  size = UDP_ARENA_MIN << sizeClass;
+  udpPoolLock();
+  memcpy(arena, &udpPoolFree[sizeClass], sizeof(BYTE *));
+  udpPoolFree[sizeClass] = arena;
+  udpPoolHeld -= size;
+  udpPoolPooled += size;
+  udpPoolUnlock();
+}
+
+/*********************************************************
+*NAME:          udpPoolGetClass
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns the size class of an arena of size bytes
+*
+*ARGUMENTS:
+* size - Arena size
+*********************************************************/
+static int udpPoolGetClass(int size) {
+  int returnValue; /* Value to return */
+
+  returnValue = 0;
+  while ((UDP_ARENA_MIN << returnValue) < size) {
+    returnValue++;
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          udpRingInit
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Sets up an empty ring. No arena is taken until the first
+* packet is kept
+*
+*ARGUMENTS:
+* ring - Ring to set up
+*********************************************************/
+static void udpRingInit(udpRing *ring) {
+  BYTE count; /* Looping variable */
+
+  ring->arena = NULL;
+  ring->size = 0;
+  ring->head = 0;
+  ring->tail = 0;
+  ring->wrapEnd = -1;
+  ring->records = 0;
+  ring->inUse = 0;
+  count = 0;
+  while (count < MAX_UDP_SEQUENCE) {
+    ring->offset[count] = 0;
+    ring->lens[count] = UDP_NO_PACKET;
+    count++;
+  }
+}
+
+/*********************************************************
+*NAME:          udpRingFree
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns a ring's arena to the pool
+*
+*ARGUMENTS:
+* ring - Ring to free
+*********************************************************/
+static void udpRingFree(udpRing *ring) {
+  if (ring->arena != NULL) {
+    udpPoolGive(ring->arena, udpPoolGetClass(ring->size));
+    ring->arena = NULL;
+    ring->size = 0;
+  }
+}
+
+/*********************************************************
+*NAME:          udpRingFind
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns where a record of need bytes can go after the
+* newest one, wrapping to the start of the arena if the
+* end is too short. Returns -1 if there is no room
+*
+*ARGUMENTS:
+* ring - Ring to look in
+* need - Bytes needed
+*********************************************************/
+static int udpRingFind(udpRing *ring, int need) {
+  int returnValue; /* Value to return */
+
+  returnValue = -1;
+  if (ring->records == 0) {
+    ring->head = 0;
+    ring->tail = 0;
+    ring->wrapEnd = -1;
+  }
+  if (ring->wrapEnd < 0) {
+    if (ring->size - ring->head >= need) {
+      returnValue = ring->head;
+    } else if (ring->tail >= need) {
+      ring->wrapEnd = ring->head;
+      ring->head = 0;
+      returnValue = 0;
+    }
+  } else if (ring->tail - ring->head >= need) {
+    returnValue = ring->head;
+  }
+
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          udpRingDropOldest
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Frees the oldest record if its sequence number has since
+* been given another packet. Returns FALSE if the ring is
+* empty or the oldest packet is still kept
+*
+*ARGUMENTS:
+* ring - Ring to drop from
+*********************************************************/
+static bool udpRingDropOldest(udpRing *ring) {
+  BYTE *record; /* Oldest record */
+  int len;      /* Its packet length */
+
+  if (ring->records == 0) {
+    return FALSE;
+  }
+  record = ring->arena + ring->tail;
+  len = record[1] | (record[2] << 8);
+  if (ring->lens[record[0]] != UDP_NO_PACKET && ring->offset[record[0]] == ring->tail + UDP_RECORD_HEADER) {
+    return FALSE;
+  }
+  ring->tail += UDP_RECORD_HEADER + len;
+  ring->records--;
+  if (ring->tail == ring->wrapEnd) {
+    ring->tail = 0;
+    ring->wrapEnd = -1;
+  }
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          udpRingRepack
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Moves the kept packets oldest first into a new arena
+* with room for need more bytes, dropping replaced ones on
+* the way. Returns FALSE if the arena could not be had
+*
+*ARGUMENTS:
+* ring - Ring to grow
+* need - Bytes needed for the next record
+*********************************************************/
+static bool udpRingRepack(udpRing *ring, int need) {
+  BYTE *arena;   /* New arena */
+  BYTE *record;  /* Record being moved */
+  int sizeClass; /* Size class of the new arena */
+  int kept;      /* Records kept */
+  int pos;       /* Position in the old arena */
+  int len;       /* Length of the packet being moved */
+  int head;      /* Position in the new arena */
+  int count;     /* Looping variable */
+
+  kept = 0;
+  for (count=0;count<MAX_UDP_SEQUENCE;count++) {
+    if (ring->lens[count] != UDP_NO_PACKET) {
+      kept++;
+    }
+  }
+  /* Leave a quarter spare so replaced records can pile up
+     behind the oldest kept one for a while before moving
+     everything again */
+  need += ring->inUse + kept * UDP_RECORD_HEADER;
+  sizeClass = udpPoolGetClass(need + need / 4);
+  if (sizeClass >= UDP_ARENA_CLASSES) {
+    sizeClass = UDP_ARENA_CLASSES - 1;
+    if ((UDP_ARENA_MIN << sizeClass) < need) {
+      return FALSE;
+    }
+  }
+  arena = udpPoolTake(sizeClass);
+  if (arena == NULL) {
+    return FALSE;
+  }
+
+  head = 0;
+  pos = ring->tail;
+  count = ring->records;
+  while (count > 0) {
+    record = ring->arena + pos;
+    len = record[1] | (record[2] << 8);
+    if (ring->lens[record[0]] != UDP_NO_PACKET && ring->offset[record[0]] == pos + UDP_RECORD_HEADER) {
+      memcpy(arena + head, record, (size_t) (UDP_RECORD_HEADER + len));
+      ring->offset[record[0]] = head + UDP_RECORD_HEADER;
+      head += UDP_RECORD_HEADER + len;
+    }
+    pos += UDP_RECORD_HEADER + len;
+    if (pos == ring->wrapEnd) {
+      pos = 0;
+    }
+    count--;
+  }
+
+  udpRingFree(ring);
+  ring->arena = arena;
+  ring->size = UDP_ARENA_MIN << sizeClass;
+  ring->head = head;
+  ring->tail = 0;
+  ring->wrapEnd = -1;
+  ring->records = kept;
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          udpRingSet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Keeps a packet at sequenceNumber, replacing any packet
+* already there. Records older than it are freed until it
+* fits, or the ring is repacked if the oldest is still kept.
+* If memory runs out the packet is not kept
+*
+*ARGUMENTS:
+* ring           - Ring to keep it in
+* sequenceNumber - Sequence number position
+* buff           - Buffer to keep
+* length         - Length of the buffer
+*********************************************************/
+static void udpRingSet(udpRing *ring, BYTE sequenceNumber, BYTE *buff, int length) {
+  BYTE *record; /* Record being written */
+  int need;     /* Bytes for the record */
+  int pos;      /* Where the record goes */
+
+  if (ring->lens[sequenceNumber] != UDP_NO_PACKET) {
+    ring->inUse -= ring->lens[sequenceNumber];
+    ring->lens[sequenceNumber] = UDP_NO_PACKET;
+  }
+  if (length < 0 || length > SIZE_OF_PACKET) {
+    return;
+  }
+
+  need = UDP_RECORD_HEADER + length;
+  pos = udpRingFind(ring, need);
+  while (pos < 0) {
+    if (udpRingDropOldest(ring) == FALSE && udpRingRepack(ring, need) == FALSE) {
+      return;
+    }
+    pos = udpRingFind(ring, need);
+  }
+
+  record = ring->arena + pos;
+  record[0] = sequenceNumber;
+  record[1] = (BYTE) (length & 0xFF);
+  record[2] = (BYTE) (length >> 8);
+  memcpy(record + UDP_RECORD_HEADER, buff, (size_t) length);
+  ring->head = pos + need;
+  ring->records++;
+  ring->offset[sequenceNumber] = pos + UDP_RECORD_HEADER;
+  ring->lens[sequenceNumber] = length;
+  ring->inUse += length;
+}
+
+/*********************************************************
+*NAME:          udpRingGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns a pointer to the packet at sequenceNumber
+*
+*ARGUMENTS:
+* ring           - Ring to look in
+* sequenceNumber - Sequence number position
+*********************************************************/
+static BYTE *udpRingGet(udpRing *ring, BYTE sequenceNumber) {
+  if (ring->lens[sequenceNumber] == UDP_NO_PACKET) {
+    return udpNoPacket;
+  }
+  return ring->arena + ring->offset[sequenceNumber];
+}
+
 /*********************************************************
 *NAME:          udpPacketsCreate
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Creates an udpPackets struncture. Returns NULL on error
 *
@@ -74,20 +478,25 @@
 *********************************************************/
 udpPackets udpPacketsCreate(void) {
   udpPackets returnValue; /* Value to return */
-  BYTE count;             /* Looping variable */
+
+  if (udpPoolMutex == NULL) {
+#ifdef _WIN32
+    udpPoolMutex = CreateMutex(NULL, FALSE, NULL);
+#else
+    udpPoolMutex = SDL_CreateMutex();
+#endif
+    if (udpPoolMutex == NULL) {
+      return NULL;
+    }
+  }
 
   New(returnValue);
   if (returnValue != NULL) {
     returnValue->inUpTo = 0;
     returnValue->inSequenceNumber = 1; /* In sequence number is always +1 */
     returnValue->outSequenceNumber = 0;
-    count = 0;
-
-    while (count < MAX_UDP_SEQUENCE) {
-      returnValue->outLens[count] = UDP_NO_PACKET;
-      returnValue->inLens[count] = UDP_NO_PACKET;
-      count++;
-    }
+    udpRingInit(&returnValue->out);
+    udpRingInit(&returnValue->in);
   }
 
   return returnValue;
@@ -97,7 +506,7 @@ udpPackets udpPacketsCreate(void) {
 *NAME:          udpPacketsDestroy
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Destroys a udpPackets structure
 *
@@ -106,6 +515,8 @@ udpPackets udpPacketsCreate(void) {
 *********************************************************/
 void udpPacketsDestroy(udpPackets *value) {
   if (*value != NULL) {
+    udpRingFree(&(*value)->out);
+    udpRingFree(&(*value)->in);
     Dispose(*value);
     *value = NULL;
   }
@@ -186,34 +597,36 @@ BYTE udpPacketsGetNextOutSequenceNumber(udpPackets *value) {
 *NAME:          udpPacketsGetInBuff
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Returns a pointer to the inbound byte array at 
-* sequenceNumber
+* sequenceNumber. It is good until the next packet is
+* set
 *
 *ARGUMENTS:
 * value          - UdpPackets item
 * sequenceNumber - Sequence number position
 *********************************************************/
 BYTE* udpPacketsGetInBuff(udpPackets *value, BYTE sequenceNumber) {
-  return (*value)->inBuff[sequenceNumber];
+  return udpRingGet(&(*value)->in, sequenceNumber);
 }
 
 /*********************************************************
 *NAME:          udpPacketsGetOutBuff
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Returns a pointer to the outbound pointer at 
-* sequenceNumber
+* sequenceNumber. It is good until the next packet is
+* set
 *
 *ARGUMENTS:
 * value          - UdpPackets item
 * sequenceNumber - Sequence number position
 *********************************************************/
 BYTE* udpPacketsGetOutBuff(udpPackets *value, BYTE sequenceNumber) {
-  return (*value)->outBuff[sequenceNumber];
+  return udpRingGet(&(*value)->out, sequenceNumber);
 }
 
 /*********************************************************
@@ -230,7 +643,7 @@ BYTE* udpPacketsGetOutBuff(udpPackets *value, BYTE sequenceNumber) {
 * sequenceNumber - Sequence number position
 *********************************************************/
 int udpPacketsGetInBuffLength(udpPackets *value, BYTE sequenceNumber) {
-  return (*value)->inLens[sequenceNumber];
+  return (*value)->in.lens[sequenceNumber];
 }
 
 /*********************************************************
@@ -247,14 +660,14 @@ int udpPacketsGetInBuffLength(udpPackets *value, BYTE sequenceNumber) {
 * sequenceNumber - Sequence number position
 *********************************************************/
 int udpPacketsGetOutBuffLength(udpPackets *value, BYTE sequenceNumber) {
-  return (*value)->outLens[sequenceNumber];
+  return (*value)->out.lens[sequenceNumber];
 }
 
 /*********************************************************
 *NAME:          udpPacketsSetInBuff
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Sets the packet at position sequence number to buff in
 * the inbound items
@@ -266,15 +679,14 @@ int udpPacketsGetOutBuffLength(udpPackets *value, BYTE sequenceNumber) {
 * length         - Lenght of the buffer
 *********************************************************/
 void udpPacketsSetInBuff(udpPackets *value, BYTE sequenceNumber, BYTE *buff, int length) {
-  memcpy((*value)->inBuff[sequenceNumber], buff, (unsigned int) length);
-  (*value)->inLens[sequenceNumber] = length;
+  udpRingSet(&(*value)->in, sequenceNumber, buff, length);
 }
 
 /*********************************************************
 *NAME:          udpPacketsSetOutBuff
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Sets the packet at position sequence number to buff in
 * the output items
@@ -286,7 +698,48 @@ void udpPacketsSetInBuff(udpPackets *value, BYTE sequenceNumber, BYTE *buff, int
 * length         - Lenght of the buffer
 *********************************************************/
 void udpPacketsSetOutBuff(udpPackets *value, BYTE sequenceNumber, BYTE *buff, int length) {
-  memcpy((*value)->outBuff[sequenceNumber], buff, (unsigned int) length);
-  (*value)->outLens[sequenceNumber] = length;
+  udpRingSet(&(*value)->out, sequenceNumber, buff, length);
+}
+
+/*********************************************************
+*NAME:          udpPacketsGetMemory
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the bytes of packets kept and the bytes of arena
+* held for them
+*
+*ARGUMENTS:
+* value    - UdpPackets item
+* inUse    - Pointer to hold the bytes of packets kept
+* reserved - Pointer to hold the bytes of arena held
+*********************************************************/
+void udpPacketsGetMemory(udpPackets *value, int *inUse, int *reserved) {
+  *inUse = (*value)->out.inUse + (*value)->in.inUse;
+  *reserved = (*value)->out.size + (*value)->in.size;
 }
 
+/*********************************************************
+*NAME:          udpPacketsGetPoolMemory
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the bytes of arena handed out by the shared pool
+* and the bytes waiting in it for reuse
+*
+*ARGUMENTS:
+* held   - Pointer to hold the bytes handed out
+* pooled - Pointer to hold the bytes waiting for reuse
+*********************************************************/
+void udpPacketsGetPoolMemory(int *held, int *pooled) {
+  *held = 0;
+  *pooled = 0;
+  if (udpPoolMutex != NULL) {
+    udpPoolLock();
+    *held = udpPoolHeld;
+    *pooled = udpPoolPooled;
+    udpPoolUnlock();
+  }
+}
@@ -20,7 +20,7 @@
 *Filename:      udppackets.h
 *Author:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *Purpose:
 * Handles keeping track of network packets for
 * retransmission on errors
@@ -78,14 +78,37 @@
 
 typedef struct udpPacketsObj *udpPackets;
 
+/* Bytes stored before each record in a ring. The sequence
+   number and a two byte length */
+#define UDP_RECORD_HEADER 3
+/* Smallest ring arena. Arenas double in size from here */
+#define UDP_ARENA_MIN 512
+/* Arena sizes the shared pool keeps. The largest holds
+   MAX_UDP_SEQUENCE packets of SIZE_OF_PACKET */
+#define UDP_ARENA_CLASSES 10
+
+/* Packets kept by sequence number as variable length records
+   laid end to end in one arena. Replaced records are freed
+   from the oldest end. If the oldest is still kept the ring
+   is repacked into a new arena, larger if need be */
+typedef struct {
+  BYTE *arena;                  /* Records oldest first, from the shared pool */
+  int size;                     /* Size of the arena, 0 if none yet */
+  int head;                     /* Where the next record goes */
+  int tail;                     /* Start of the oldest record */
+  int wrapEnd;                  /* End of the records before the ring wrapped, -1 if it has not */
+  int records;                  /* Records from tail to head, kept or replaced */
+  int inUse;                    /* Bytes of packets kept */
+  int offset[MAX_UDP_SEQUENCE]; /* Where each packet is in the arena */
+  int lens[MAX_UDP_SEQUENCE];   /* Size of each packet */
+} udpRing;
+
 struct udpPacketsObj {
-  BYTE outSequenceNumber;                     /* The next packet sequence number to get for sending out */
-  BYTE outBuff[MAX_UDP_SEQUENCE][SIZE_OF_PACKET]; /* Copy of the packets for retransmission */
-  int outLens[MAX_UDP_SEQUENCE];                 /* Size of each packet */
-  BYTE inSequenceNumber; 	                    /* The next packet sequence number expected */
-  BYTE inUpTo;                                /* Sequence number to process up to  on error */
-  BYTE inBuff[MAX_UDP_SEQUENCE][SIZE_OF_PACKET];  /* Copy of the incoming packets for processing on missing packets */
-  int inLens[MAX_UDP_SEQUENCE];                 /* Size of each packet */
+  BYTE outSequenceNumber;       /* The next packet sequence number to get for sending out */
+  udpRing out;                  /* Copy of the packets for retransmission */
+  BYTE inSequenceNumber;        /* The next packet sequence number expected */
+  BYTE inUpTo;                  /* Sequence number to process up to  on error */
+  udpRing in;                   /* Copy of the incoming packets for processing on missing packets */
 };
 
 /* Prototypes */
@@ -94,7 +117,7 @@ struct udpPacketsObj {
 *NAME:          udpPacketsCreate
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Creates an udpPackets struncture. Returns NULL on error
 *
@@ -107,7 +130,7 @@ udpPackets udpPacketsCreate(void);
 *NAME:          udpPacketsDestroy
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Destroys a udpPackets structure
 *
@@ -174,10 +197,11 @@ BYTE udpPacketsGetNextOutSequenceNumber(udpPackets *value);
 *NAME:          udpPacketsGetInBuff
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Returns a pointer to the inbound byte array at 
-* sequenceNumber
+* sequenceNumber. It is good until the next packet is
+* set
 *
 *ARGUMENTS:
 * value          - UdpPackets item
@@ -189,10 +213,11 @@ BYTE* udpPacketsGetInBuff(udpPackets *value, BYTE sequenceNumber);
 *NAME:          udpPacketsGetOutBuff
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Returns a pointer to the outbound pointer at 
-* sequenceNumber
+* sequenceNumber. It is good until the next packet is
+* set
 *
 *ARGUMENTS:
 * value          - UdpPackets item
@@ -234,7 +259,7 @@ int udpPacketsGetOutBuffLength(udpPackets *value, BYTE sequenceNumber);
 *NAME:          udpPacketsSetInBuff
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Sets the packet at position sequence number to buff in
 * the inbound items
@@ -251,7 +276,7 @@ void udpPacketsSetInBuff(udpPackets *value, BYTE sequenceNumber, BYTE *buff, int
 *NAME:          udpPacketsSetOutBuff
 *AUTHOR:        John Morrison
 *Creation Date: 24/02/02
-*Last Modified: 24/02/02
+*Last Modified: 16/10/26
 *PURPOSE:
 * Sets the packet at position sequence number to buff in
 * the output items
@@ -264,5 +289,35 @@ void udpPacketsSetInBuff(udpPackets *value, BYTE sequenceNumber, BYTE *buff, int
 ********************************************************/
 void udpPacketsSetOutBuff(udpPackets *value, BYTE sequenceNumber, BYTE *buff, int length);
 
-#endif /* _UDP_PACKETS_H */
+/*********************************************************
+*NAME:          udpPacketsGetMemory
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the bytes of packets kept and the bytes of arena
+* held for them
+*
+*ARGUMENTS:
+* value    - UdpPackets item
+* inUse    - Pointer to hold the bytes of packets kept
+* reserved - Pointer to hold the bytes of arena held
+*********************************************************/
+void udpPacketsGetMemory(udpPackets *value, int *inUse, int *reserved);
 
+/*********************************************************
+*NAME:          udpPacketsGetPoolMemory
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the bytes of arena handed out by the shared pool
+* and the bytes waiting in it for reuse
+*
+*ARGUMENTS:
+* held   - Pointer to hold the bytes handed out
+* pooled - Pointer to hold the bytes waiting for reuse
+*********************************************************/
+void udpPacketsGetPoolMemory(int *held, int *pooled);
+
+#endif /* _UDP_PACKETS_H */
@@ -20,7 +20,7 @@
 *Filename:      util.c
 *Author:        John Morrison
 *Creation Date: 25/12/98
-*Last Modified: 22/04/01
+*Last Modified: 16/10/26
 *Purpose:
 *  Provides misc functions
 *********************************************************/
@@ -35,11 +35,160 @@
 #include "bases.h"
 #include "util.h"
 
+/* Which math backend the trig and range functions use */
+static utilMath utilMathBackend = utilMathDouble;
+
+/* Fixed point tables. Angles are indexed in bradians and the
+   tables are built with the same RADIAN_MAX the double backend
+   uses so both backends agree to within rounding. Values are
+   round(f(i * RADIAN_MAX / 256) * 65536) for i = 0 to 256 */
+static const int utilSinTable[UTIL_TRIG_TABLE_SIZE] = {
+  0, 1608, 3214, 4819, 6420, 8018, 9611, 11199,
+  12779, 14352, 15916, 17471, 19015, 20547, 22068, 23575,
+  25067, 26545, 28007, 29452, 30879, 32288, 33677, 35046,
+  36394, 37719, 39023, 40302, 41558, 42788, 43993, 45171,
+  46322, 47446, 48540, 49606, 50641, 51647, 52621, 53563,
+  54473, 55350, 56194, 57005, 57781, 58522, 59228, 59898,
+  60532, 61130, 61691, 62215, 62702, 63150, 63561, 63934,
+  64268, 64563, 64820, 65037, 65216, 65355, 65455, 65515,
+  65536, 65518, 65460, 65362, 65226, 65050, 64835, 64581,
+  64288, 63957, 63587, 63178, 62732, 62248, 61726, 61168,
+  60572, 59940, 59272, 58569, 57830, 57056, 56248, 55406,
+  54531, 53623, 52683, 51711, 50708, 49674, 48610, 47518,
+  46396, 45247, 44070, 42867, 41639, 40385, 39107, 37805,
+  36480, 35134, 33766, 32378, 30971, 29545, 28101, 26641,
+  25164, 23672, 22166, 20646, 19115, 17571, 16017, 14454,
+  12881, 11301, 9715, 8122, 6524, 4923, 3318, 1712,
+  104, -1503, -3110, -4715, -6317, -7915, -9508, -11096,
+  -12677, -14250, -15815, -17370, -18915, -20448, -21969, -23477,
+  -24971, -26450, -27913, -29359, -30787, -32197, -33587, -34958,
+  -36307, -37634, -38939, -40220, -41477, -42709, -43916, -45096,
+  -46249, -47374, -48470, -49538, -50575, -51582, -52558, -53503,
+  -54415, -55294, -56141, -56953, -57731, -58475, -59183, -59856,
+  -60492, -61093, -61656, -62182, -62671, -63123, -63536, -63911,
+  -64247, -64545, -64804, -65024, -65205, -65347, -65449, -65512,
+  -65536, -65520, -65465, -65370, -65236, -65063, -64850, -64599,
+  -64308, -63979, -63612, -63206, -62762, -62281, -61761, -61205,
+  -60612, -59983, -59317, -58616, -57879, -57107, -56302, -55462,
+  -54589, -53683, -52745, -51775, -50774, -49742, -48680, -47589,
+  -46470, -45322, -44148, -42946, -41719, -40467, -39190, -37890,
+  -36567, -35222, -33856, -32469, -31063, -29638, -28196, -26736,
+  -25260, -23769, -22264, -20746, -19214, -17672, -16118, -14555,
+  -12984, -11404, -9818, -8225, -6628, -5027, -3423, -1816,
+  -209
+};
+
+static const int utilCosTable[UTIL_TRIG_TABLE_SIZE] = {
+  65536, 65516, 65457, 65359, 65221, 65044, 64827, 64572,
+  64278, 63945, 63574, 63164, 62717, 62232, 61709, 61149,
+  60552, 59919, 59250, 58545, 57805, 57030, 56221, 55378,
+  54502, 53593, 52652, 51679, 50674, 49640, 48575, 47482,
+  46359, 45209, 44032, 42828, 41598, 40344, 39065, 37762,
+  36437, 35090, 33722, 32333, 30925, 29499, 28054, 26593,
+  25116, 23623, 22117, 20597, 19065, 17521, 15967, 14403,
+  12830, 11250, 9663, 8070, 6472, 4871, 3266, 1660,
+  52, -1555, -3162, -4767, -6368, -7966, -9560, -11147,
+  -12728, -14301, -15865, -17420, -18965, -20498, -22019, -23526,
+  -25019, -26497, -27960, -29405, -30833, -32242, -33632, -35002,
+  -36350, -37677, -38981, -40261, -41518, -42749, -43954, -45134,
+  -46286, -47410, -48505, -49572, -50608, -51614, -52589, -53533,
+  -54444, -55322, -56168, -56979, -57756, -58498, -59205, -59877,
+  -60512, -61111, -61674, -62199, -62687, -63137, -63549, -63922,
+  -64258, -64554, -64812, -65031, -65210, -65351, -65452, -65514,
+  -65536, -65519, -65462, -65366, -65231, -65056, -64843, -64590,
+  -64298, -63968, -63599, -63192, -62747, -62264, -61744, -61186,
+  -60592, -59961, -59295, -58592, -57854, -57082, -56275, -55434,
+  -54560, -53653, -52714, -51743, -50741, -49708, -48645, -47554,
+  -46433, -45285, -44109, -42907, -41679, -40426, -39148, -37847,
+  -36524, -35178, -33811, -32424, -31017, -29592, -28148, -26688,
+  -25212, -23721, -22215, -20696, -19165, -17621, -16068, -14505,
+  -12933, -11353, -9766, -8174, -6576, -4975, -3370, -1764,
+  -157, 1451, 3058, 4663, 6265, 7863, 9456, 11044,
+  12625, 14199, 15764, 17320, 18865, 20399, 21920, 23429,
+  24923, 26402, 27865, 29312, 30741, 32151, 33542, 34913,
+  36263, 37591, 38897, 40179, 41437, 42670, 43877, 45058,
+  46212, 47338, 48435, 49503, 50542, 51550, 52527, 53473,
+  54386, 55266, 56114, 56927, 57707, 58451, 59161, 59834,
+  60472, 61074, 61638, 62166, 62656, 63108, 63523, 63899,
+  64237, 64536, 64796, 65018, 65200, 65343, 65447, 65511,
+  65536
+};
+
+/* round(atan(i / 256) * 256 / RADIAN_MAX * 256) for i = 0 to 256.
+   Results are in 1/256ths of a bradian */
+static const int utilAtanTable[UTIL_TRIG_TABLE_SIZE] = {
+  0, 41, 82, 122, 163, 204, 245, 285,
+  326, 367, 407, 448, 489, 529, 570, 611,
+  651, 692, 733, 773, 814, 854, 895, 935,
+  975, 1016, 1056, 1097, 1137, 1177, 1217, 1258,
+  1298, 1338, 1378, 1418, 1458, 1498, 1538, 1578,
+  1617, 1657, 1697, 1737, 1776, 1816, 1855, 1895,
+  1934, 1974, 2013, 2052, 2091, 2130, 2169, 2208,
+  2247, 2286, 2325, 2364, 2402, 2441, 2480, 2518,
+  2557, 2595, 2633, 2671, 2709, 2747, 2785, 2823,
+  2861, 2899, 2937, 2974, 3012, 3049, 3086, 3124,
+  3161, 3198, 3235, 3272, 3309, 3345, 3382, 3419,
+  3455, 3492, 3528, 3564, 3600, 3636, 3672, 3708,
+  3744, 3780, 3815, 3851, 3886, 3922, 3957, 3992,
+  4027, 4062, 4097, 4131, 4166, 4201, 4235, 4270,
+  4304, 4338, 4372, 4406, 4440, 4474, 4507, 4541,
+  4574, 4608, 4641, 4674, 4707, 4740, 4773, 4806,
+  4838, 4871, 4903, 4936, 4968, 5000, 5032, 5064,
+  5096, 5128, 5159, 5191, 5222, 5254, 5285, 5316,
+  5347, 5378, 5409, 5440, 5470, 5501, 5531, 5561,
+  5592, 5622, 5652, 5682, 5711, 5741, 5771, 5800,
+  5829, 5859, 5888, 5917, 5946, 5975, 6003, 6032,
+  6061, 6089, 6117, 6146, 6174, 6202, 6230, 6258,
+  6285, 6313, 6340, 6368, 6395, 6422, 6450, 6477,
+  6504, 6530, 6557, 6584, 6610, 6637, 6663, 6689,
+  6715, 6741, 6767, 6793, 6819, 6845, 6870, 6896,
+  6921, 6946, 6971, 6996, 7021, 7046, 7071, 7096,
+  7120, 7145, 7169, 7194, 7218, 7242, 7266, 7290,
+  7314, 7338, 7361, 7385, 7408, 7432, 7455, 7478,
+  7501, 7525, 7547, 7570, 7593, 7616, 7638, 7661,
+  7683, 7706, 7728, 7750, 7772, 7794, 7816, 7838,
+  7860, 7881, 7903, 7924, 7946, 7967, 7988, 8009,
+  8031, 8052, 8072, 8093, 8114, 8135, 8155, 8176,
+  8196
+};
+
+/*********************************************************
+*NAME:          utilSetMathBackend
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Sets the math backend used by utilCalcDistance,
+* utilCalcAngle and utilIsItemInRange. Every player in a
+* game must use the same backend.
+*
+*ARGUMENTS:
+*  value - The backend to use
+*********************************************************/
+void utilSetMathBackend(utilMath value) {
+  utilMathBackend = value;
+}
+
+/*********************************************************
+*NAME:          utilGetMathBackend
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns the math backend in use
+*
+*ARGUMENTS:
+*
+*********************************************************/
+utilMath utilGetMathBackend(void) {
+  return utilMathBackend;
+}
+
 /*********************************************************
 *NAME:          utilCalcDistance
 *AUTHOR:        John Morrison
 *CREATION DATE: 25/12/98
-*LAST MODIFIED: 25/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Calculates the X and Y distance an object 
 * should move from a given speed and angle
@@ -52,12 +201,34 @@
 *********************************************************/
 void utilCalcDistance(int *xAmount, int *yAmount, TURNTYPE angle, int speed) {
   double dbAngle; /* Floating piont number for calculations */
+  int pos;        /* Table position in 1/256ths of a bradian */
+  int index;      /* Table entry and fraction past it */
+  int frac;
+  int cosValue;   /* Interpolated table values */
+  int sinValue;
 
   /* Take away 64 bradians to make angle correct for sin/cos calculations */
   angle -= BRADIANS_EAST;
   if (angle < 0) {
     angle += BRADIANS_MAX;
   }
+  if (utilMathBackend == utilMathFixed) {
+    /* Multiplying by 256 is exact in a float so this is the same everywhere */
+    pos = (int) (angle * UTIL_FIXED_STEP);
+    if (pos < 0) {
+      pos = 0;
+    } else if (pos >= (UTIL_TRIG_TABLE_SIZE - 1) * UTIL_FIXED_STEP) {
+      pos = (UTIL_TRIG_TABLE_SIZE - 1) * UTIL_FIXED_STEP - 1;
+    }
+    index = pos >> UTIL_FIXED_SHIFT;
+    frac = pos & (UTIL_FIXED_STEP - 1);
+    cosValue = utilCosTable[index] + ((utilCosTable[index+1] - utilCosTable[index]) * frac) / UTIL_FIXED_STEP;
+    sinValue = utilSinTable[index] + ((utilSinTable[index+1] - utilSinTable[index]) * frac) / UTIL_FIXED_STEP;
+    /* Division truncates toward zero like the (int) casts below */
+    *xAmount = (speed * cosValue) / UTIL_FIXED_ONE;
+    *yAmount = (speed * sinValue) / UTIL_FIXED_ONE;
+    return;
+  }
   /* Convert bradians to degrees */
   dbAngle = (DEGREES_MAX / BRADIANS_MAX) * angle;
   /* Convert degrees to radians */
@@ -205,7 +376,7 @@ bool utilIsTankHit(WORLD xTank, WORLD yTank, TURNTYPE tankAngle, WORLD x, WORLD
 *NAME:          utilCalcAngle
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/1/99
-*LAST MODIFIED: 18/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns the angle from object 1 to object 2
 *
@@ -220,6 +391,12 @@ TURNTYPE utilCalcAngle(WORLD object1X, WORLD object1Y, WORLD object2X, WORLD obj
   double angle;
   double gapX;
   double gapY;
+  unsigned long small; /* Fixed point backend values */
+  unsigned long large;
+  unsigned long ratio;
+  int index;
+  int frac;
+  int fixedAngle;
 
   if (object2X - object1X < 0) {
     gapX = object1X - object2X;
@@ -232,10 +409,32 @@ TURNTYPE utilCalcAngle(WORLD object1X, WORLD object1Y, WORLD object2X, WORLD obj
     gapY = object2Y - object1Y;
   }
  
-  angle = atan((gapX/gapY));
-  angle = (angle / RADIAN_MAX) * DEGREES_MAX;
+  if (utilMathBackend == utilMathFixed) {
+    /* Look up atan of the smaller gap over the larger so the ratio
+       is always between 0 and 1, then mirror about 45 degrees */
+    small = (unsigned long) (gapX < gapY ? gapX : gapY);
+    large = (unsigned long) (gapX < gapY ? gapY : gapX);
+    fixedAngle = 0;
+    if (large > 0) {
+      ratio = (small << 16) / large;
+      index = (int) (ratio >> UTIL_FIXED_SHIFT);
+      frac = (int) (ratio & (UTIL_FIXED_STEP - 1));
+      fixedAngle = utilAtanTable[index];
+      if (index < UTIL_TRIG_TABLE_SIZE - 1) {
+        fixedAngle += ((utilAtanTable[index+1] - utilAtanTable[index]) * frac) / UTIL_FIXED_STEP;
+      }
+    }
+    if (gapX > gapY) {
+      fixedAngle = UTIL_FIXED_QUARTER - fixedAngle;
+    }
+    /* Dividing by 256 is exact in a float */
+    returnValue = (TURNTYPE) fixedAngle / UTIL_FIXED_STEP;
+  } else {
+    angle = atan((gapX/gapY));
+    angle = (angle / RADIAN_MAX) * DEGREES_MAX;
   
-  returnValue = (TURNTYPE) ((BRADIANS_MAX/ DEGREES_MAX) * angle);
+    returnValue = (TURNTYPE) ((BRADIANS_MAX/ DEGREES_MAX) * angle);
+  }
   
   if (object2X - object1X <= 0 && object2Y - object1Y <= 0) {
     returnValue = (TURNTYPE) (BRADIANS_MAX - returnValue);
@@ -253,7 +452,7 @@ TURNTYPE utilCalcAngle(WORLD object1X, WORLD object1Y, WORLD object2X, WORLD obj
 *NAME:          utilIsItemInRange
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/12/98
-*LAST MODIFIED:  23/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns whether an item is in range of range.
 * (Remained from utilIsTankInRange) 
@@ -271,6 +470,9 @@ bool utilIsItemInRange(WORLD x, WORLD y, WORLD tankX, WORLD tankY, WORLD range,
   WORLD gapX;       /* Gap from pillbox to tank */
   WORLD gapY;
   double distance;  /* Hold distance */
+  unsigned long long squared; /* Fixed point backend values */
+  unsigned long long root;
+  unsigned long long bit;
 
   /* FIXME: optimise me by using unsigned types. neg*neg = positive */
   returnValue = FALSE;
@@ -285,6 +487,35 @@ bool utilIsItemInRange(WORLD x, WORLD y, WORLD tankX, WORLD tankY, WORLD range,
     gapY = tankY - y;
   }
 
+  if (utilMathBackend == utilMathFixed) {
+    /* Compare squared distances so no square root is needed to test range */
+    squared = (unsigned long long) gapX * gapX + (unsigned long long) gapY * gapY;
+    if (squared <= (unsigned long long) range * range) {
+      /* Callers compare distances so work one out in 1/256ths of a
+         world unit with an integer square root */
+      squared <<= 16;
+      root = 0;
+      bit = 1ULL << 62;
+      while (bit > squared) {
+        bit >>= 2;
+      }
+      while (bit != 0) {
+        if (squared >= root + bit) {
+          squared -= root + bit;
+          root = (root >> 1) + bit;
+        } else {
+          root >>= 1;
+        }
+        bit >>= 2;
+      }
+      returnValue = TRUE;
+      *amount = (double) root / UTIL_FIXED_STEP;
+    } else {
+      *amount = WORLD_MAX;
+    }
+    return returnValue;
+  }
+
   distance = (double) gapX * gapX;
   distance += (double) gapY * gapY;
   distance = sqrt(distance);
@@ -20,7 +20,7 @@
 *Filename:      util.h 
 *Author:        John Morrison
 *Creation Date: 25/12/98
-*Last Modified: 30/01/02
+*Last Modified: 16/10/26
 *Purpose:
 *  Provides misc functions
 *********************************************************/
@@ -51,17 +51,60 @@
 /* We allow big file names */
 #define BIG_FILENAME 1024
 
+/* Fixed point math backend. Tables have an entry for every
+   bradian plus one so the last step can interpolate */
+#define UTIL_TRIG_TABLE_SIZE 257
+#define UTIL_FIXED_SHIFT 8
+#define UTIL_FIXED_STEP 256
+#define UTIL_FIXED_ONE 65536
+/* 90 degrees in 1/256ths of a bradian using RADIAN_MAX */
+#define UTIL_FIXED_QUARTER 16392
+
 
 
 /* Includes */
 #include "global.h"
 #include "types.h"
 
+/* Math backends for the trig and range functions */
+typedef enum {
+  utilMathDouble, /* Original double precision sin/cos/atan/sqrt */
+  utilMathFixed   /* Integer tables, identical results on every compiler */
+} utilMath;
+
+/*********************************************************
+*NAME:          utilSetMathBackend
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Sets the math backend used by utilCalcDistance,
+* utilCalcAngle and utilIsItemInRange. Every player in a
+* game must use the same backend.
+*
+*ARGUMENTS:
+*  value - The backend to use
+*********************************************************/
+void utilSetMathBackend(utilMath value);
+
+/*********************************************************
+*NAME:          utilGetMathBackend
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns the math backend in use
+*
+*ARGUMENTS:
+*
+*********************************************************/
+utilMath utilGetMathBackend(void);
+
 /*********************************************************
 *NAME:          tankCalcDistance
 *AUTHOR:        John Morrison
 *CREATION DATE: 25/12/98
-*LAST MODIFIED: 25/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Calculates the X and Y distance an object 
 * should move from a given speed and angle
@@ -122,7 +165,7 @@ bool utilIsTankHit(WORLD xTank, WORLD yTank, TURNTYPE tankAngle, WORLD x, WORLD
 *NAME:          utilCalcAngle
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/1/99
-*LAST MODIFIED: 18/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns the angle from object 1 to object 2
 *
@@ -138,7 +181,7 @@ TURNTYPE utilCalcAngle(WORLD object1X, WORLD object1Y, WORLD object2X, WORLD obj
 *NAME:          utilIsItemInRange
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/12/98
-*LAST MODIFIED:  23/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns whether an item is in range of range.
 * (Remained from utilIsTankInRange) 
@@ -515,8 +515,8 @@ void drawSetManStatus(bool isDead, TURNTYPE angle, bool needLocking) {
 *********************************************************/
 void drawShells(screenBullets *sBullets) {
   SDL_Rect output; /* Output Rectangle */
-  int total;   /* Total shells to been drawn */
-  int count;   /* Looping Variable */
+  screenBullet *q; /* Current shell */
+  int count;   /* Cursor */
   BYTE px;
   BYTE py;
   BYTE frame;
@@ -527,11 +527,14 @@ void drawShells(screenBullets *sBullets) {
   BYTE zf;
   SDL_Rect dest;
 
-  total = screenBulletsGetNumEntries(sBullets);
-  count = 1;
+  count = 0;
   zf = 1; //FIXME: windowGetZoomFactor();
-  while (count <= total) {
-    screenBulletsGetItem(sBullets, count, &mx, &my,&px,&py, &frame);
+  while ((q = screenBulletsNext(sBullets, &count)) != NULL) {
+    mx = q->mx;
+    my = q->my;
+    px = q->px;
+    py = q->py;
+    frame = q->frame;
     dest.x = (mx * zf * TILE_SIZE_X) + zf * px;
     dest.y = (my * zf * TILE_SIZE_Y) + zf * py;
     switch (frame) {
@@ -682,7 +685,6 @@ void drawShells(screenBullets *sBullets) {
     break;
 
     }
-    count++;
     dest.w = output.w;
     dest.h = output.h;
     SDL_BlitSurface(lpTiles, &output, lpBackBuffer, &dest);
@@ -763,8 +765,8 @@ void drawTanks(screenTanks *tks) {
   int y;
   SDL_Rect output; /* Source Rectangle */
   SDL_Rect dest;
-  BYTE count;  /* Looping Variable */
-  BYTE total;  /* Total number of tanks on the screen */
+  screenPosTank *q; /* Current tank */
+  int count;   /* Cursor */
   /* Current tank Stuff */
   char playerName[PLAYER_NAME_LEN]; /* Player name */
   BYTE frame;                       /* Frame id */
@@ -775,15 +777,20 @@ void drawTanks(screenTanks *tks) {
   BYTE zoomFactor;                  /* Scaling Factor */
   BYTE playerNum;                   /* Player Number */
 
-  count = 1;
-  total = screenTanksGetNumEntries(tks);
+  count = 0;
   zoomFactor = 1; //FIXME: windowGetZoomFactor();
   output.w = zoomFactor * TILE_SIZE_X;
   output.h = zoomFactor * TILE_SIZE_Y;
   dest.w = output.w;
   dest.h = output.h;
-  while (count <= total) {
-    screenTanksGetItem(tks, count, &mx, &my, &px, &py, &frame, &playerNum, playerName);
+  while ((q = screenTanksNext(tks, &count)) != NULL) {
+    mx = q->mx;
+    my = q->my;
+    px = q->px;
+    py = q->py;
+    frame = q->frame;
+    playerNum = q->playerNum;
+    strcpy(playerName, q->playerName);
     switch (frame) {
     case TANK_SELF_0:
       output.x = TANK_SELF_0_X;
@@ -1186,7 +1193,6 @@ void drawTanks(screenTanks *tks) {
     SDL_BlitSurface(lpTiles, &output, lpBackBuffer, &dest);
     /* Output the label */
     drawTankLabel(playerName, mx, my, px, py);
-    count++;
   }
 
 }
@@ -1206,7 +1212,7 @@ void drawTanks(screenTanks *tks) {
 *  lgms - The screenLgm data structure 
 *********************************************************/
 void drawLGMs(screenLgm *lgms) {
-  BYTE total;   /* Total number to draw */
+  screenPosLgm *q; /* Current LGM */
   BYTE frame;   /* Current LGM screen info */
   BYTE mx;
   BYTE my;
@@ -1216,14 +1222,18 @@ void drawLGMs(screenLgm *lgms) {
   int y;
   SDL_Rect output; /* Source Rectangle */
   SDL_Rect dest;   /* Destination rect */
-  BYTE count;  /* Looping variable */
+  int count;   /* Cursor */
   BYTE zf;     /* Zoom factor */
 
-  total = screenLgmGetNumEntries(lgms);
+  count = 0;
   zf = 1; //FIXME: windowGetZoomFactor();
 
-  for (count=1;count<=total;count++) {
-    screenLgmGetItem(lgms, count, &mx, &my, &px, &py, &frame);
+  while ((q = screenLgmNext(lgms, &count)) != NULL) {
+    mx = q->mx;
+    my = q->my;
+    px = q->px;
+    py = q->py;
+    frame = q->frame;
     switch (frame) {
       case LGM0:
         output.x = zf * LGM0_X;
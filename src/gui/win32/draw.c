@@ -1707,8 +1707,8 @@ void drawStatusTankBars(int xValue, int yValue, BYTE shells, BYTE mines, BYTE ar
 *********************************************************/
 void drawShells(screenBullets *sBullets) {
   RECT output; /* Output Rectangle */
-  int total;   /* Total shells to been drawn */
-  int count;   /* Looping Variable */
+  screenBullet *q; /* Current shell */
+  int count;   /* Cursor */
   BYTE px;
   BYTE py;
   BYTE frame;
@@ -1718,11 +1718,14 @@ void drawShells(screenBullets *sBullets) {
   int y;
   BYTE zf;
 
-  total = screenBulletsGetNumEntries(sBullets);
-  count = 1;
+  count = 0;
   zf = windowGetZoomFactor();
-  while (count <= total) {
-    screenBulletsGetItem(sBullets, count, &mx, &my,&px,&py, &frame);
+  while ((q = screenBulletsNext(sBullets, &count)) != NULL) {
+    mx = q->mx;
+    my = q->my;
+    px = q->px;
+    py = q->py;
+    frame = q->frame;
     x = (mx * zf * TILE_SIZE_X) + zf * px;
     y = (my * zf * TILE_SIZE_Y) + zf * py;
     switch (frame) {
@@ -1873,7 +1876,6 @@ void drawShells(screenBullets *sBullets) {
     break;
 
     }
-    count++;
     lpDDSBackBuffer->lpVtbl->BltFast(lpDDSBackBuffer, x, y, lpDDSTiles ,&output, DDBLTFAST_WAIT | DDBLTFAST_SRCCOLORKEY);
   }
 }
@@ -1950,8 +1952,8 @@ void drawTanks(screenTanks *tks) {
   int x;       /* X and Y Co-ordinates */
   int y; 
   RECT output; /* Source Rectangle */
-  BYTE count;  /* Looping Variable */
-  BYTE total;  /* Total number of tanks on the screen */
+  screenPosTank *q; /* Current tank */
+  int count;   /* Cursor */
   /* Current tank Stuff */
   char playerName[MAX_PATH];        /* Player name */
   BYTE frame;                       /* Frame id */
@@ -1962,12 +1964,17 @@ void drawTanks(screenTanks *tks) {
   BYTE zoomFactor;                  /* Scaling Factor */
   BYTE playerNum;                   /* Tanks Player Number */
   
-  count = 1;
-  total = screenTanksGetNumEntries(tks);
+  count = 0;
   zoomFactor = windowGetZoomFactor();
   
-  while (count <= total) {
-    screenTanksGetItem(tks, count, &mx, &my, &px, &py, &frame, &playerNum, playerName);
+  while ((q = screenTanksNext(tks, &count)) != NULL) {
+    mx = q->mx;
+    my = q->my;
+    px = q->px;
+    py = q->py;
+    frame = q->frame;
+    playerNum = q->playerNum;
+    strcpy(playerName, q->playerName);
     switch (frame) {
     case TANK_SELF_0:
       output.left = TANK_SELF_0_X;
@@ -2380,7 +2387,6 @@ void drawTanks(screenTanks *tks) {
     /* Output the label */
     drawTankLabel(playerName, playerNum, mx, my, px, py);
 
-    count++;
   }
 
 }
@@ -2545,7 +2551,7 @@ void drawStatusBaseBars(int xValue, int yValue, BYTE shells, BYTE mines, BYTE ar
 *  lgms - The screenLgm data structure 
 *********************************************************/
 void drawLGMs(screenLgm *lgms) {
-  BYTE total;   /* Total number to draw */
+  screenPosLgm *q; /* Current LGM */
   BYTE frame;   /* Current LGM screen info */
   BYTE mx;
   BYTE my;
@@ -2554,14 +2560,18 @@ void drawLGMs(screenLgm *lgms) {
   int x;       /* X and Y Co-ordinates */
   int y; 
   RECT output; /* Source Rectangle */
-  BYTE count;  /* Looping variable */
+  int count;   /* Cursor */
   BYTE zf;     /* Zoom factor */
 
-  total = screenLgmGetNumEntries(lgms);
+  count = 0;
   zf = windowGetZoomFactor();
 
-  for (count=1;count<=total;count++) {
-    screenLgmGetItem(lgms, count, &mx, &my, &px, &py, &frame);
+  while ((q = screenLgmNext(lgms, &count)) != NULL) {
+    mx = q->mx;
+    my = q->my;
+    px = q->px;
+    py = q->py;
+    frame = q->frame;
     switch (frame) {
       case LGM0:
         output.left = zf * LGM0_X;
@@ -20,7 +20,7 @@
 *Filename:      gamefront.c
 *Author:        John Morrison
 *Creation Date: 27/01/99
-*Last Modified: 21/04/06
+*Last Modified: 16/10/26
 *Purpose:
 *  Provides the front end for dialog/preferences etc.
 *********************************************************/
@@ -53,6 +53,8 @@
 #include "..\dialogkeysetup.h"
 #include "..\dialogsetname.h"
 #include "..\..\bolo\network.h"
+#include "..\..\server\servercore.h"
+#include "..\..\server\servernet.h"
 #include "..\lang.h"
 #include "..\brainsHandler.h"
 #include "..\clientmutex.h"
@@ -95,6 +97,7 @@ bool gameFrontWbnSavePass;
 openingStates dlgState = openStart;
 
 bool isServer = FALSE; /* Are we server of a net game */
+serverCore serverGame = NULL; /* Game we serve */
 DWORD oldTick;     /* Number of ticks passed - Server variable */
 DWORD serverOldTick;
 DWORD serverTick;
@@ -1116,7 +1119,7 @@ bool gameFrontGetRemeber() {
 *NAME:          serverGameTimer
 *AUTHOR:        John Morrison
 *CREATION DATE: 24/11/98
-*LAST MODIFIED: 20/3/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * The Game Timer. If there are no events to prcess this 
 * routine is called. If the elapsed
@@ -1140,18 +1143,18 @@ void CALLBACK serverGameTimer(UINT uID, UINT uMsg, DWORD dwUser, DWORD dw1, DWOR
       trackerTime++;
       wbnTime++;
       
-      threadsWaitForMutex();
+      serverCoreLock(serverGame);
       threadsSetContext(TRUE);
-      serverCoreGameTick();
+      serverCoreGameTick(serverGame);
       threadsSetContext(FALSE);
-      threadsReleaseMutex();
+      serverCoreUnlock(serverGame);
       ticks++;
       serverOldTick += SERVER_TICK_LENGTH;
     }
-    if (winbolonetIsRunning() == TRUE && serverCoreGetActualGameType() != gameOpen) {
-      threadsWaitForMutex();
-      isGameWon = serverCoreCheckGameWin(FALSE);
-      threadsReleaseMutex();
+    if (winbolonetIsRunning() == TRUE && serverCoreGetActualGameType(serverGame) != gameOpen) {
+      serverCoreLock(serverGame);
+      isGameWon = serverCoreCheckGameWin(serverGame, FALSE);
+      serverCoreUnlock(serverGame);
       if (isGameWon == TRUE) {
         gameFrontShutdownServer();
         return;
@@ -1159,25 +1162,26 @@ void CALLBACK serverGameTimer(UINT uID, UINT uMsg, DWORD dwUser, DWORD dw1, DWOR
     }
   } 
 
-  threadsWaitForMutex();
+  serverCoreLock(serverGame);
   threadsSetContext(TRUE);  
-  serverNetCheckRemovePlayers();
-  serverNetMakePosPackets();
-  serverNetMakeData();
+  serverNetCheckRemovePlayers(serverGame);
+  serverNetPublishSnapshot(serverGame);
+  serverNetMakePosPackets(serverGame);
+  serverNetMakeData(serverGame);
   threadsSetContext(FALSE);
-  threadsReleaseMutex();
+  serverCoreUnlock(serverGame);
   
   
   if (wbnTime > 100) {
-    threadsWaitForMutex();
-    winbolonetServerUpdate(serverCoreGetNumPlayers(), serverCoreGetNumNeutralBases(), serverCoreGetNumNeutralPills(), FALSE);
-    threadsReleaseMutex();
+    serverCoreLock(serverGame);
+    winbolonetServerUpdate(serverCoreGetNumPlayers(serverGame), serverCoreGetNumNeutralBases(serverGame), serverCoreGetNumNeutralPills(serverGame), FALSE);
+    serverCoreUnlock(serverGame);
     wbnTime = 0;
   }
 
 
   if (trackerTime >= (6000)) {
-    serverNetSendTrackerUpdate();
+    serverNetSendTrackerUpdate(serverGame);
     trackerTime = 0;
   }
 }
@@ -1186,7 +1190,7 @@ void CALLBACK serverGameTimer(UINT uID, UINT uMsg, DWORD dwUser, DWORD dw1, DWOR
 *NAME:          gameFrontShutdownServer
 *AUTHOR:        John Morrison
 *CREATION DATE: 11/12/03
-*LAST MODIFIED: 11/12/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Stops the server if we are hosting
 *
@@ -1197,11 +1201,11 @@ void gameFrontShutdownServer() {
   if (isServer == TRUE) {
     isServer = FALSE;
     threadsSetContext(TRUE);
-    serverNetSendQuitMessage();
+    serverNetSendQuitMessage(serverGame);
     timeKillEvent(serverTimerGameID);
-    serverNetDestroy();
+    serverNetDestroy(serverGame);
     winbolonetDestroy();
-    serverCoreDestroy();
+    serverCoreDestroy(&serverGame);
     threadsSetContext(FALSE);
   }
 }
@@ -1210,7 +1214,7 @@ void gameFrontShutdownServer() {
 *NAME:          gameFrontSetupServer
 *AUTHOR:        John Morrison
 *CREATION DATE: 3/11/99
-*LAST MODIFIED:  3/1/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Attempts to start the server process. Returns success
 *
@@ -1226,7 +1230,8 @@ bool gameFrontSetupServer() {
 
   threadsSetContext(TRUE);
   if (strcmp(fileName, "") != 0 ) {
-    if (serverCoreCreate(fileName, gametype, hiddenMines, startDelay , timeLen ) == FALSE) {
+    serverGame = serverCoreCreate(fileName, gametype, hiddenMines, startDelay , timeLen );
+    if (serverGame == NULL) {
       returnValue = FALSE;
       MessageBox(NULL, "Error Loading Map", DIALOG_BOX_TITLE, MB_OK);
     }
@@ -1242,34 +1247,38 @@ bool gameFrontSetupServer() {
       if (hGlobal != NULL) {
         buff = LockResource(hGlobal);
         if (buff != NULL) {
-          serverCoreCreateCompressed(buff, 5097, "Everard Island", gametype, hiddenMines, startDelay, timeLen);
+          serverGame = serverCoreCreateCompressed(buff, 5097, "Everard Island", gametype, hiddenMines, startDelay, timeLen);
         }
       }
     }
+    if (serverGame == NULL) {
+      returnValue = FALSE;
+      MessageBox(NULL, "Error Loading Map", DIALOG_BOX_TITLE, MB_OK);
+    }
   }
 
 
   if (returnValue == TRUE) {
-    if (serverNetCreate(gameFrontTargetUdp, password, compTanks, gameFrontTrackerAddr, gameFrontTrackerPort, gameFrontTrackerEnabled, NULL, 0) == FALSE) {
+    if (serverNetCreate(serverGame, gameFrontTargetUdp, password, compTanks, gameFrontTrackerAddr, gameFrontTrackerPort, gameFrontTrackerEnabled, NULL, 0) == FALSE) {
       MessageBox(NULL,"Error starting Network. Is the port in use?", DIALOG_BOX_TITLE, MB_OK);
-      serverNetDestroy();
-      serverCoreDestroy();
+      serverNetDestroy(serverGame);
+      serverCoreDestroy(&serverGame);
       returnValue = FALSE;
     }
   }
 
   if (returnValue == TRUE && gameFrontWbnUse == TRUE) {
     char mapName[255];
-    serverCoreGetMapName(mapName);
-    winbolonetCreateServer(mapName, gameFrontTargetUdp, (BYTE) gametype, (BYTE) compTanks, serverCoreGetAllowHiddenMines(), (BYTE) (password[0] == 0 ? FALSE : TRUE), screenNumBases(), screenNumPills(), serverCoreGetNumNeutralBases(), serverCoreGetNumNeutralPills(), serverCoreGetNumPlayers(), serverCoreGetTimeGameCreated());
+    serverCoreGetMapName(serverGame, mapName);
+    winbolonetCreateServer(mapName, gameFrontTargetUdp, (BYTE) gametype, (BYTE) compTanks, serverCoreGetAllowHiddenMines(serverGame), (BYTE) (password[0] == 0 ? FALSE : TRUE), serverCoreNumBases(serverGame), serverCoreNumPills(serverGame), serverCoreGetNumNeutralBases(serverGame), serverCoreGetNumNeutralPills(serverGame), serverCoreGetNumPlayers(serverGame), serverCoreGetTimeGameCreated(serverGame));
   }
   threadsSetContext(FALSE);
 
 
   if (threadsCreate(TRUE) == FALSE) {
     threadsDestroy();
-    serverNetDestroy();
-    serverCoreDestroy();
+    serverNetDestroy(serverGame);
+    serverCoreDestroy(&serverGame);
 	  returnValue = FALSE;
   } 
   
@@ -18,90 +18,55 @@
 
 /* This used to be a LZW implemtnation, hence the directory, file and function names but replaced by a RLE implementation as it was more effecient. Could probably be replaced with built in map RLE functions. */
 
+/* The coding state is kept in an lzwContext rather than globals so
+   more than one thread can uncompress at once. */
 
-/* File: dcodrle1.c
-   Author: David Bourgin
-   Creation date: 1/2/94
-   Last update: 24/7/95
-   Purpose: Example of RLE type 1 decoding with a file source to decompress
-*/
-
-#include <stdio.h>
-/* For routines printf,fgetc,fputc and fwrite */
-#include <memory.h>
-/* For routine memset */
-
-/* Useful constants */
-#define FALSE 0
-#define TRUE  1
-
-/* Global variables. */
-char *compressSrc, *compressDest;
-
-int compressLen; /* Length of the compressed array */
-int uncompressLen; /* Length of the data to compress */
-int compressUpto; /* Where we are up to in the compression */
+#include <string.h>
+#include "lzw.h"
 
 /* Pseudo procedures */
-__inline int decend_of_data() {
-  if (compressUpto >= uncompressLen) {
-    return TRUE;
-  } else {
-    return FALSE;
-  }
-}
-
-
-__inline char decread_byte() {
-  compressUpto++;
-  return compressSrc[compressUpto-1];
-}
-
+#define decend_of_data(ctx) ((ctx)->srcUpto >= (ctx)->srcLen)
+#define decread_byte(ctx) ((unsigned char) (ctx)->src[(ctx)->srcUpto++])
 
-__inline void decwrite_byte(char c) {
-  compressDest[compressLen] = c;
-  compressLen++;
-}
 
-void decwrite_array(char *c, int numBytes) {
-  int count = 0;
-  while (count < numBytes) {
-    compressDest[compressLen] = c[count];
-    compressLen++;
-    count++;
-  }
+int lzwDecode(lzwContext *ctx, char *src, char *dest, int len)
+/* Returned parameters: Length of the uncompressed data
+   Action: Decompresses with RLE type 1 method all len bytes of src into dest
+   Errors: A frame cut short by the end of src is dropped
+*/
+{ unsigned char header;
+  int frame_size;
+
+  ctx->src = src;
+  ctx->dest = dest;
+  ctx->destLen = 0;
+  ctx->srcUpto = 0;
+  ctx->srcLen = len;
+  while (!decend_of_data(ctx))
+        { header=decread_byte(ctx);
+          if ((header & 128) == 0)
+             { frame_size=header+1;
+               if (ctx->srcLen-ctx->srcUpto < frame_size)
+                  break;
+               memcpy(ctx->dest+ctx->destLen,ctx->src+ctx->srcUpto,frame_size);
+               ctx->srcUpto += frame_size;
+             }
+          else { frame_size=(header & 127)+2;
+                 if (decend_of_data(ctx))
+                    break;
+                 memset(ctx->dest+ctx->destLen,decread_byte(ctx),frame_size);
+               }
+          ctx->destLen += frame_size;
+        }
+  return ctx->destLen;
 }
 
 
-
-#define decwrite_block(byte,time_nb)  { unsigned char array_to_write[129];\
-                                     (void)memset(array_to_write,(byte),(time_nb));\
-                                     decwrite_array(array_to_write,(time_nb));\
-                                   }
-
-
 int lzwdecoding(char *src, char *dest, int len)
-/* Returned parameters: None
-   Action: Decompresses with RLE type 1 method all bytes read by the function read_byte
-   Erreurs: An input/output error could disturb the running of the program
+/* Returned parameters: Length of the uncompressed data
+   Action: lzwDecode with a coding state on the stack
 */
-{ unsigned char header;
-  unsigned char i;
+{ lzwContext ctx;
 
-  compressSrc = src;
-  compressDest = dest;
-  compressLen = 0;
-  compressUpto = 0;
-  uncompressLen = len;
-  while (!decend_of_data())
-        { header=decread_byte();
-          switch (header & 128)
-          { case 0:for (i=0;i<=header;i++)
-                       decwrite_byte(decread_byte());
-                   break;
-            case 128:decwrite_block(decread_byte(),(header & 127)+2);
-          }
-        }
-  return compressLen;
+  return lzwDecode(&ctx, src, dest, len);
 }
-
@@ -0,0 +1,125 @@
+/*
+ * OpenBolo — cross-platform remake of WinBolo (1998)
+ * Copyright (C) 2026 OpenBolo Contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*********************************************************
+*Name:          LZW
+*Filename:      lzw.h
+*Author:        OpenBolo Contributors
+*Creation Date: 16/10/26
+*Last Modified: 16/10/26
+*Purpose:
+*  The map codec. Despite the name it is run length
+*  encoding (RLE type 1). All state lives in an lzwContext
+*  the caller provides so any number of threads can code
+*  at once and nothing is allocated.
+*
+*  A frame starts with a header byte. 0-127 is followed by
+*  header+1 bytes copied as is. 128-255 is followed by one
+*  byte repeated (header & 127)+2 times.
+*********************************************************/
+
+#ifndef LZW_H
+#define LZW_H
+
+/* Most bytes in a frame */
+#define LZW_FRAME_SIZE 129
+
+/* Largest compressed size of len bytes. A lone byte
+   between pairs costs two */
+#define LZW_MAX_SIZE(len) ((len) * 4 / 3 + 2)
+
+/* Coding state. Only valid during a call */
+typedef struct {
+  char *src;                           /* Data being read */
+  char *dest;                          /* Data being written */
+  int srcLen;                          /* Length of src */
+  int srcUpto;                         /* Bytes of src read */
+  int destLen;                         /* Bytes written to dest */
+  unsigned char frame[LZW_FRAME_SIZE]; /* Bytes of the frame being built */
+} lzwContext;
+
+/* Prototypes */
+
+/*********************************************************
+*NAME:          lzwEncode
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Compresses len bytes of src into dest and returns the
+*  compressed length. dest must hold LZW_MAX_SIZE(len)
+*  bytes
+*
+*ARGUMENTS:
+*  ctx  - Coding state to use
+*  src  - Data to compress
+*  dest - Buffer for the compressed data
+*  len  - Length of src
+*********************************************************/
+int lzwEncode(lzwContext *ctx, char *src, char *dest, int len);
+
+/*********************************************************
+*NAME:          lzwDecode
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Uncompresses len bytes of src into dest and returns
+*  the uncompressed length. A frame cut short by the end
+*  of src is dropped
+*
+*ARGUMENTS:
+*  ctx  - Coding state to use
+*  src  - Data to uncompress
+*  dest - Buffer for the uncompressed data
+*  len  - Length of src
+*********************************************************/
+int lzwDecode(lzwContext *ctx, char *src, char *dest, int len);
+
+/*********************************************************
+*NAME:          lzwencoding
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  lzwEncode with a coding state of its own
+*
+*ARGUMENTS:
+*  src  - Data to compress
+*  dest - Buffer for the compressed data
+*  len  - Length of src
+*********************************************************/
+int lzwencoding(char *src, char *dest, int len);
+
+/*********************************************************
+*NAME:          lzwdecoding
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  lzwDecode with a coding state of its own
+*
+*ARGUMENTS:
+*  src  - Data to uncompress
+*  dest - Buffer for the uncompressed data
+*  len  - Length of src
+*********************************************************/
+int lzwdecoding(char *src, char *dest, int len);
+
+#endif /* LZW_H */
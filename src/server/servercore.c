@@ -20,7 +20,7 @@
 *Filename:      serverCore.c
 *Author:        John Morrison
 *Creation Date: 10/08/99
-*Last Modified: 27/07/04
+*Last Modified: 16/10/26
 *Purpose:
 *  WinBolo Server Core Simulation modelling.
 *********************************************************/
@@ -59,6 +59,7 @@
 #include "../bolo/screen.h"
 #include "../bolo/frontend.h"
 #include "../bolo/log.h"
+#include "../bolo/netjoin.h"
 #include "../winbolonet/winbolonet.h"
 #include "servernet.h"
 #include "servercore.h"
@@ -71,48 +72,162 @@
 #define COPYRIGHT_STRING "LinBolo Copyright 1998-2006 John Morrison\nBolo Copyright 1987-1995 Stuart Cheshire\0"
 #endif
 
-map mp;
-bases bs;
-pillboxes pb;
-starts ss;
-tank tk[MAX_TANKS];
-lgm lgman[MAX_TANKS];
-shells shs;
-players splrs;
-building serverBlds = NULL;
-explosions serverExpl = NULL;
-floodFill serverFF = NULL;
-grass serverGrass = NULL;
-mines serverMines = NULL;
-minesExp serverMinesExp = NULL;
-rubble serverRubble = NULL;
-swamp serverSwamp = NULL;
-tkExplosion serverTankExp = NULL;
-netPnbContext serverPNB = NULL; 
-netMntContext serverNMT = NULL;
-
-gameType sGame;
-
-/* Map name */
-char sMapName[MAP_STR_SIZE];
-
-/* Game length and start delay */
-int sGmeStartDelay;
-long sGmeLength;
-
-/* Time game was created */
-time_t sTimeStart;
-
-/* Are we running? */
-bool serverCoreGameRunning = FALSE;
+/* Game each thread is working on. The backend reaches the
+   game through it when the engine calls back */
+static THREAD_LOCAL serverCore serverCoreCurrent = NULL;
+
+#ifdef BOLO_PROFILE
+/* Nanoseconds spent in each section of the game tick */
+static unsigned long long serverCoreProfile[profileNumItems];
+
+/* Number of game ticks profiled */
+static unsigned long serverCoreProfileTicks = 0;
+
+/* View matrix counters */
+static unsigned long long serverCoreViewLookups = 0;    /* Views read from the matrix */
+static unsigned long long serverCoreViewPillChecks = 0; /* Pill checks building it */
+static unsigned long long serverCoreViewPairChecks = 0; /* Pill checks a scan per lookup makes */
+
+/*********************************************************
+*NAME:          serverCoreProfileNow
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns a monotonic timestamp in nanoseconds
+*
+*ARGUMENTS:
+*
+*********************************************************/
+static unsigned long long serverCoreProfileNow(void) {
+#ifdef _WIN32
+  LARGE_INTEGER count; /* Performance counter */
+  LARGE_INTEGER freq;  /* Counter frequency */
+
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&freq);
+  return (unsigned long long) ((double) count.QuadPart * 1000000000.0 / (double) freq.QuadPart);
+#else
+  struct timespec ts; /* Current time */
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long) ts.tv_sec * 1000000000ULL + (unsigned long long) ts.tv_nsec;
+#endif
+}
+
+/* Times call and adds the time taken to the item section */
+#define SERVER_CORE_PROFILE(item, call) { \
+  unsigned long long profileStart = serverCoreProfileNow(); \
+  call; \
+  serverCoreProfile[item] += serverCoreProfileNow() - profileStart; \
+}
+#else
+#define SERVER_CORE_PROFILE(item, call) call;
+#endif
+
+/*********************************************************
+*NAME:          serverCoreSetContext
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Sets the game the calling thread is working on. The
+*  backend reaches the game through it when the engine
+*  calls back. serverCoreCreate and serverCoreLock set it
+*  so a thread only needs to call this when it works on a
+*  game without locking it
+*
+*ARGUMENTS:
+*  value - Game the thread is working on
+*********************************************************/
+void serverCoreSetContext(serverCore value) {
+  serverCoreCurrent = value;
+}
+
+/*********************************************************
+*NAME:          serverCoreGetContext
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the game the calling thread is working on
+*
+*ARGUMENTS:
+*
+*********************************************************/
+serverCore serverCoreGetContext(void) {
+  return serverCoreCurrent;
+}
+
+/*********************************************************
+*NAME:          serverCoreLock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Waits till the game's mutex is acquired and makes it
+*  the game the calling thread is working on
+*
+*ARGUMENTS:
+*  sc - Game to lock
+*********************************************************/
+void serverCoreLock(serverCore sc) {
+  threadsMutexWait(sc->mutex);
+  serverCoreCurrent = sc;
+}
+
+/*********************************************************
+*NAME:          serverCoreUnlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Releases the game's mutex
+*
+*ARGUMENTS:
+*  sc - Game to unlock
+*********************************************************/
+void serverCoreUnlock(serverCore sc) {
+  threadsMutexRelease(sc->mutex);
+}
+
+/*********************************************************
+*NAME:          serverCoreNew
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Allocates an empty game with its mutex and makes it the
+*  game the calling thread is working on. Returns NULL on
+*  failure
+*
+*ARGUMENTS:
+*
+*********************************************************/
+static serverCore serverCoreNew(void) {
+  serverCore returnValue; /* Value to return */
+
+  New(returnValue);
+  if (returnValue != NULL) {
+    memset(returnValue, 0, sizeof(*returnValue));
+    returnValue->mutex = threadsMutexCreate();
+    if (returnValue->mutex == NULL) {
+      Dispose(returnValue);
+      returnValue = NULL;
+    }
+  }
+  serverCoreCurrent = returnValue;
+  return returnValue;
+}
 
 /*********************************************************
 *NAME:          serverCoreCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 10/8/99
-*LAST MODIFIED:  5/5/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Creates a new server. Returns FALSE if an error occured
+*  Creates a new game and makes it the game the calling
+*  thread is working on. Returns NULL if an error occured
 *  such as error loading map
 *
 *ARGUMENTS:
@@ -123,64 +238,80 @@ bool serverCoreGameRunning = FALSE;
 *  gmeLen      - Length of the game (in 50ths) 
 *                (-1 =unlimited)
 *********************************************************/
-bool serverCoreCreate(char *fileName, gameType game, bool hiddenMines, int srtDelay, long gmeLen) {
-  bool returnValue; /* Value to return */
+serverCore serverCoreCreate(char *fileName, gameType game, bool hiddenMines, int srtDelay, long gmeLen) {
+  serverCore sc;    /* Game being created */
+  bool returnValue; /* Did the map load */
   BYTE count;       /* Looping variable */
 
+  sc = serverCoreNew();
+  if (sc == NULL) {
+    return NULL;
+  }
   srand((unsigned int) time(NULL));
   messageAdd(globalMessage, (char *) BOLO_VERSION_STRING, (char *) COPYRIGHT_STRING);
   messageAdd(globalMessage, (char *) "", (char *) "Core Simulation Startup");
 
-  sMapName[0] = '\0';
-  sGmeStartDelay = srtDelay;
-  sGmeLength = gmeLen;
+  sc->sMapName[0] = '\0';
+  sc->sGmeStartDelay = srtDelay;
+  sc->sGmeLength = gmeLen;
+  sc->tickCount = 0;
+  sc->doneOnce = FALSE;
+  sc->doneWbnOnce = FALSE;
+  sc->hadPlayers = FALSE;
 
   for (count=0;count<MAX_TANKS;count++) {
-    tk[count] = NULL;
+    sc->tk[count] = NULL;
+    sc->posAck[count] = POS_DELTA_NONE;
+    sc->posJoin[count] = 0;
+    sc->posHistory[count] = posDeltaCreate();
+    sc->posHistoryJoin[count] = 0;
   }
 
-  gameTypeSet(&sGame, game);
-  mapCreate(&mp);
-  pillsCreate(&pb);
-  startsCreate(&ss);
-  basesCreate(&bs);
-  playersCreate(&splrs);
-  shs = shellsCreate();
-  explosionsCreate(&serverExpl);
-  rubbleCreate(&serverRubble);
-  buildingCreate(&serverBlds);
-  grassCreate(&serverGrass);
-  swampCreate(&serverSwamp);
-  netPNBCreate(&serverPNB);
-  netMNTCreate(&serverNMT);
-  logCreate();
-  floodCreate(&serverFF);
-  tkExplosionCreate(&serverTankExp);
-  minesCreate(&serverMines, hiddenMines);
-  minesExpCreate(&serverMinesExp);
-  playersRejoinCreate();
-
-  returnValue = mapRead(fileName, &mp, &pb, &bs, &ss);
+  gameTypeSet(&sc->sGame, game);
+  mapCreate(&sc->mp);
+  pillsCreate(&sc->pb);
+  startsCreate(&sc->ss);
+  basesCreate(&sc->bs);
+  playersCreate(&sc->splrs);
+  sc->shs = shellsCreate();
+  explosionsCreate(&sc->serverExpl);
+  tileLifeCreate(&sc->serverTileLife);
+  mapRunCacheCreate(&sc->runCache);
+  sc->logArena = screenArenaCreate();
+  netPNBCreate(&sc->serverPNB);
+  netMNTCreate(&sc->serverNMT);
+  sc->serverLog = logCreate();
+  floodCreate(&sc->serverFF);
+  tkExplosionCreate(&sc->serverTankExp);
+  minesCreate(&sc->serverMines, hiddenMines);
+  minesExpCreate(&sc->serverMinesExp);
+  playersRejoinCreate(&sc->rejoin);
+
+  returnValue = FALSE;
+  if (sc->serverLog != NULL) {
+    returnValue = mapRead(fileName, &sc->mp, &sc->pb, &sc->bs, &sc->ss);
+  }
 
   if (returnValue == TRUE) {
-    utilExtractMapName(fileName, sMapName);
-    basesClearMines(&bs, &mp);
-    serverCoreGameRunning = TRUE;
+    utilExtractMapName(fileName, sc->sMapName);
+    basesClearMines(&sc->bs, &sc->mp);
+    sc->serverCoreGameRunning = TRUE;
   } else {
-    serverCoreDestroy();
+    serverCoreDestroy(&sc);
   }
 
-  return returnValue;
+  return sc;
 }
 
 /*********************************************************
 *NAME:          serverCoreCreateCompressed
 *AUTHOR:        John Morrison
 *CREATION DATE: 10/8/99
-*LAST MODIFIED: 5/05/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Creates a new server via loading a compressed map
-*  structure. Returns FALSE if an error occured such as 
+*  Creates a new game via loading a compressed map
+*  structure and makes it the game the calling thread is
+*  working on. Returns NULL if an error occured such as 
 *  error loading map
 *
 *ARGUMENTS:
@@ -194,128 +325,162 @@ bool serverCoreCreate(char *fileName, gameType game, bool hiddenMines, int srtDe
 *  gmeLen      - Length of the game (in 50ths) 
 *                (-1 =unlimited)
 *********************************************************/
-bool serverCoreCreateCompressed(BYTE *buff, int buffLen, char *mapn, gameType game, bool hiddenMines, int srtDelay, long gmeLen) {
-  bool returnValue; /* Value to return */
+serverCore serverCoreCreateCompressed(BYTE *buff, int buffLen, char *mapn, gameType game, bool hiddenMines, int srtDelay, long gmeLen) {
+  serverCore sc;    /* Game being created */
+  bool returnValue; /* Did the map load */
   BYTE count;       /* Looping variable */
 
+  sc = serverCoreNew();
+  if (sc == NULL) {
+    return NULL;
+  }
+
   messageAdd(globalMessage, (char *) BOLO_VERSION_STRING, (char *) COPYRIGHT_STRING);
   messageAdd(globalMessage, (char *) "", (char *) "Core Simulation Startup");
 
-  sMapName[0] = '\0';
-  sGmeStartDelay = srtDelay;
-  sGmeLength = gmeLen;
+  sc->sMapName[0] = '\0';
+  sc->sGmeStartDelay = srtDelay;
+  sc->sGmeLength = gmeLen;
+  sc->tickCount = 0;
+  sc->doneOnce = FALSE;
+  sc->doneWbnOnce = FALSE;
+  sc->hadPlayers = FALSE;
 
   for (count=0;count<MAX_TANKS;count++) {
-    tk[count] = NULL;
-    lgman[count] = NULL;
+    sc->tk[count] = NULL;
+    sc->lgman[count] = NULL;
+    sc->posAck[count] = POS_DELTA_NONE;
+    sc->posJoin[count] = 0;
+    sc->posHistory[count] = posDeltaCreate();
+    sc->posHistoryJoin[count] = 0;
   }
 
-  gameTypeSet(&sGame, game);
-  mapCreate(&mp);
-  pillsCreate(&pb);
-  startsCreate(&ss);
-  basesCreate(&bs);
-  playersCreate(&splrs);
-  playersRejoinCreate();
-  shs = shellsCreate();
-  explosionsCreate(&serverExpl);
-  rubbleCreate(&serverRubble);
-  buildingCreate(&serverBlds);
-  grassCreate(&serverGrass);
-  swampCreate(&serverSwamp);
-  floodCreate(&serverFF);
-  tkExplosionCreate(&serverTankExp);
-  netPNBCreate(&serverPNB);
-  netMNTCreate(&serverNMT);
-  minesCreate(&serverMines, hiddenMines);
-  minesExpCreate(&serverMinesExp);
-  logCreate();
-
-  returnValue = mapLoadCompressedMap(&mp, &pb, &bs, &ss, buff, buffLen);
+  gameTypeSet(&sc->sGame, game);
+  mapCreate(&sc->mp);
+  pillsCreate(&sc->pb);
+  startsCreate(&sc->ss);
+  basesCreate(&sc->bs);
+  playersCreate(&sc->splrs);
+  playersRejoinCreate(&sc->rejoin);
+  sc->shs = shellsCreate();
+  explosionsCreate(&sc->serverExpl);
+  tileLifeCreate(&sc->serverTileLife);
+  mapRunCacheCreate(&sc->runCache);
+  sc->logArena = screenArenaCreate();
+  floodCreate(&sc->serverFF);
+  tkExplosionCreate(&sc->serverTankExp);
+  netPNBCreate(&sc->serverPNB);
+  netMNTCreate(&sc->serverNMT);
+  minesCreate(&sc->serverMines, hiddenMines);
+  minesExpCreate(&sc->serverMinesExp);
+  sc->serverLog = logCreate();
+
+  returnValue = FALSE;
+  if (sc->serverLog != NULL) {
+    returnValue = mapLoadCompressedMap(&sc->mp, &sc->pb, &sc->bs, &sc->ss, buff, buffLen);
+  }
 
   if (returnValue == TRUE) {
-    strcpy(sMapName, mapn);
-    basesClearMines(&bs, &mp);
-    serverCoreGameRunning = TRUE;
+    strcpy(sc->sMapName, mapn);
+    basesClearMines(&sc->bs, &sc->mp);
+    sc->serverCoreGameRunning = TRUE;
   } else {
-    serverCoreDestroy();
+    serverCoreDestroy(&sc);
   }
 
-  return returnValue;
+  return sc;
 }
 
 /*********************************************************
 *NAME:          serverCoreDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 10/8/99
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Shuts down the server.
+*  Shuts down a game and frees it.
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the game
 *********************************************************/
-void serverCoreDestroy() {
-  BYTE count; /* Looping variable */
+void serverCoreDestroy(serverCore *value) {
+  serverCore sc;       /* Game being shut down */
+  serverCore previous; /* Game the thread was working on */
+  BYTE count;          /* Looping variable */
 
+  sc = *value;
+  if (sc == NULL) {
+    return;
+  }
+  previous = serverCoreCurrent;
+  serverCoreCurrent = sc;
   messageAdd(globalMessage, (char *) "Core Simulation Shutdown", (char *) "");
-  serverCoreGameRunning = FALSE;
+  sc->serverCoreGameRunning = FALSE;
   for (count=0;count<MAX_TANKS;count++) {
-    tankDestroy(&tk[count], &mp, &pb, &bs);
-    lgmDestroy(&lgman[count]);
+    tankDestroy(&sc->tk[count], &sc->mp, &sc->pb, &sc->bs);
+    lgmDestroy(&sc->lgman[count]);
+    posDeltaDestroy(&sc->posHistory[count]);
   }
 
-  mapDestroy(&mp);
-  pillsDestroy(&pb);
-  startsDestroy(&ss);
-  basesDestroy(&bs);
-  shellsDestroy(&shs);
-  explosionsDestroy(&serverExpl);
-  playersRejoinDestroy();
-  rubbleDestroy(&serverRubble);
-  buildingDestroy(&serverBlds);
-  grassDestroy(&serverGrass);
-  floodDestroy(&serverFF);
-  swampDestroy(&serverSwamp);
-  netPNBDestroy(&serverPNB);
-  netNMTDestroy(&serverNMT);
-  tkExplosionDestroy(&serverTankExp);
-  minesDestroy(&serverMines);
-  minesExpDestroy(&serverMinesExp);
-  logDestroy();
-  playersDestroy(&splrs);
+  mapDestroy(&sc->mp);
+  pillsDestroy(&sc->pb);
+  startsDestroy(&sc->ss);
+  basesDestroy(&sc->bs);
+  shellsDestroy(&sc->shs);
+  explosionsDestroy(&sc->serverExpl);
+  playersRejoinDestroy(&sc->rejoin);
+  tileLifeDestroy(&sc->serverTileLife);
+  mapRunCacheDestroy(&sc->runCache);
+  screenArenaDestroy(&sc->logArena);
+  floodDestroy(&sc->serverFF);
+  netPNBDestroy(&sc->serverPNB);
+  netNMTDestroy(&sc->serverNMT);
+  tkExplosionDestroy(&sc->serverTankExp);
+  minesDestroy(&sc->serverMines);
+  minesExpDestroy(&sc->serverMinesExp);
+  logDestroy(&sc->serverLog);
+  playersDestroy(&sc->splrs);
+  threadsMutexDestroy(&sc->mutex);
+  Dispose(sc);
+  serverCoreCurrent = NULL;
+  if (previous != sc) {
+    serverCoreCurrent = previous;
+  }
+  *value = NULL;
 }
 
 /* FIXME: Comment */
-void serverCoreLogTick() {
+void serverCoreLogTick(serverCore sc) {
   if (logIsRecording() == TRUE) {
-    BYTE temp1, temp2, temp3, mx, my;
-    int count, entries;
-    screenBullets sb = screenBulletsCreate();
+    BYTE mx, my;
+    int count;
+    screenBullets sb;
+    screenBullet *q;
+
+    screenArenaReset(&sc->logArena);
+    screenBulletsCreate(&sb, sc->logArena);
     /* Item locations */
     for (count=0;count<MAX_TANKS;count++) {
-      if (tk[count] != NULL) {
-        mx = tankGetMX(&tk[count]);
-        my = tankGetMY(&tk[count]);
-        logAddEvent(log_PlayerLocation, (BYTE) count, mx, my, utilPutNibble(tankGetPX(&tk[count]), tankGetPY(&tk[count])), (BYTE) utilPutNibble(tankGetDir(&tk[count]), tankIsOnBoat(&tk[count])), NULL);
-        if (lgmIsOut(&lgman[count]) == TRUE) {
-          logAddEvent(log_LgmLocation, utilPutNibble((BYTE) count, lgmGetFrame(&lgman[count])), lgmGetMX(&lgman[count]), lgmGetMY(&lgman[count]), utilPutNibble(lgmGetPX(&lgman[count]), lgmGetPY(&lgman[count])), 0, NULL);
+      if (sc->tk[count] != NULL) {
+        mx = tankGetMX(&sc->tk[count]);
+        my = tankGetMY(&sc->tk[count]);
+        logAddEvent(log_PlayerLocation, (BYTE) count, mx, my, utilPutNibble(tankGetPX(&sc->tk[count]), tankGetPY(&sc->tk[count])), (BYTE) utilPutNibble(tankGetDir(&sc->tk[count]), tankIsOnBoat(&sc->tk[count])), NULL);
+        if (lgmIsOut(&sc->lgman[count]) == TRUE) {
+          logAddEvent(log_LgmLocation, utilPutNibble((BYTE) count, lgmGetFrame(&sc->lgman[count])), lgmGetMX(&sc->lgman[count]), lgmGetMY(&sc->lgman[count]), utilPutNibble(lgmGetPX(&sc->lgman[count]), lgmGetPY(&sc->lgman[count])), 0, NULL);
         }
       }
     }
 
     /* Shells */
-    shellsCalcScreenBullets(&shs, &sb, 0, MAP_ARRAY_LAST, 0, MAP_ARRAY_LAST);
-    explosionsCalcScreenBullets(&serverExpl, &sb, 0, MAP_ARRAY_LAST, 0, MAP_ARRAY_LAST);
-    tkExplosionCalcScreenBullets(&serverTankExp, &sb, 0, MAP_ARRAY_LAST, 0, MAP_ARRAY_LAST);
-    entries = screenBulletsGetNumEntries(&sb);
-    for (count=1;count<=entries;count++) {
-      screenBulletsGetItem(&sb, count, &mx, &my, &temp1, &temp2, &temp3);
-      logAddEvent(log_Shell, mx, my, utilPutNibble(temp1, temp2), temp3, 0, NULL);
+    shellsCalcScreenBullets(&sc->shs, &sb, 0, MAP_ARRAY_LAST, 0, MAP_ARRAY_LAST);
+    explosionsCalcScreenBullets(&sc->serverExpl, &sb, 0, MAP_ARRAY_LAST, 0, MAP_ARRAY_LAST);
+    tkExplosionCalcScreenBullets(&sc->serverTankExp, &sb, 0, MAP_ARRAY_LAST, 0, MAP_ARRAY_LAST);
+    count = 0;
+    while ((q = screenBulletsNext(&sb, &count)) != NULL) {
+      logAddEvent(log_Shell, q->mx, q->my, utilPutNibble(q->px, q->py), q->frame, 0, NULL);
     }
     screenBulletsDestroy(&sb);
   }  
-  logWriteTick();
+  logWriteTick(sc->serverLog);
 }
 
 
@@ -323,211 +488,215 @@ void serverCoreLogTick() {
 *NAME:          serverCoreGameTick
 *AUTHOR:        John Morrison
 *CREATION DATE: 10/8/99
-*LAST MODIFIED: 3/10/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Called once every game tick to update the game world
 *
 *ARGUMENTS:
-*  
+*  sc - Game to use
 *********************************************************/
-void serverCoreGameTick() {
-  static int tickCount = 0; /* Tick Count */
+void serverCoreGameTick(serverCore sc) {
   BYTE count;          /* Looping variable */
   tank ta[MAX_TANKS];  /* Array of tanks   */
   lgm lgms[MAX_TANKS]; /* Array of lgms    */
   BYTE numTanks;       /* Number of tanks  */
   
 
-  if (serverCoreGameRunning == FALSE ) {
+  if (sc->serverCoreGameRunning == FALSE ) {
     return;
   }
-  if (sGmeStartDelay > 0) {
-    sGmeStartDelay--;
+  if (sc->sGmeStartDelay > 0) {
+    sc->sGmeStartDelay--;
     return;
   }
 
-  if (sGmeLength > 0) {
-    sGmeLength--;
-    if (sGmeLength == 0) {
+  if (sc->sGmeLength > 0) {
+    sc->sGmeLength--;
+    if (sc->sGmeLength == 0) {
       /* Game Times Up. */
-      serverCoreGameRunning = FALSE;
+      sc->serverCoreGameRunning = FALSE;
       frontEndGameOver();
-      serverCoreGameRunning = FALSE;
+      sc->serverCoreGameRunning = FALSE;
       return;
     }
   }
 
  
-  pillsUpdate(&pb, &mp, &bs, NULL, &shs);
-  basesUpdate(&bs, NULL);
+  SERVER_CORE_PROFILE(profilePills, pillsUpdate(&sc->pb, &sc->mp, &sc->bs, NULL, &sc->shs));
+  SERVER_CORE_PROFILE(profileBases, basesUpdate(&sc->bs, NULL));
   
   numTanks = 0;
   for (count=0;count<MAX_TANKS;count++) {
-    if (tk[count] != NULL) {
-      tankUpdate(&(tk[count]), &mp, &bs, &pb, &shs, &ss, TNONE, FALSE, FALSE);
-      lgmUpdate(&lgman[count], &mp, &pb, &bs, &tk[count]);
-      ta[numTanks] = tk[count];
-      lgms[numTanks] = (struct lgmObj *) (&(lgman[count])); /* FIXME: Yeah bigass type cast warning there */
+    if (sc->tk[count] != NULL) {
+      SERVER_CORE_PROFILE(profileTanks, tankUpdate(&(sc->tk[count]), &sc->mp, &sc->bs, &sc->pb, &sc->shs, &sc->ss, TNONE, FALSE, FALSE));
+      SERVER_CORE_PROFILE(profileLgms, lgmUpdate(&sc->lgman[count], &sc->mp, &sc->pb, &sc->bs, &sc->tk[count]));
+      ta[numTanks] = sc->tk[count];
+      lgms[numTanks] = (struct lgmObj *) (&(sc->lgman[count])); /* FIXME: Yeah bigass type cast warning there */
       numTanks++;
     }
   } 
   
-  tkExplosionUpdate(&serverTankExp, &mp, &pb, &bs, (lgm **) lgms, numTanks);
-  shellsUpdate(&shs, &mp, &pb, &bs, ta, numTanks, TRUE);
-  explosionsUpdate(&serverExpl);
-  minesExpUpdate(&serverMinesExp, &mp, &pb, &bs, (lgm **) lgms, numTanks); 
-  floodUpdate(&serverFF, &mp, &pb, &bs);
-  playersRejoinUpdate();
+  SERVER_CORE_PROFILE(profileTankExp, tkExplosionUpdate(&sc->serverTankExp, &sc->mp, &sc->pb, &sc->bs, (lgm **) lgms, numTanks, &sc->tankExpTime));
+  SERVER_CORE_PROFILE(profileShells, shellsUpdate(&sc->shs, &sc->mp, &sc->pb, &sc->bs, ta, numTanks, TRUE));
+  SERVER_CORE_PROFILE(profileExplosions, explosionsUpdate(&sc->serverExpl, &sc->explTime));
+  SERVER_CORE_PROFILE(profileMinesExp, minesExpUpdate(&sc->serverMinesExp, &sc->mp, &sc->pb, &sc->bs, (lgm **) lgms, numTanks)); 
+  SERVER_CORE_PROFILE(profileFlood, floodUpdate(&sc->serverFF, &sc->mp, &sc->pb, &sc->bs));
+  playersRejoinUpdate(&sc->rejoin);
 
   /* Prepare log entries if required */
-  serverCoreLogTick();
+  SERVER_CORE_PROFILE(profileLog, serverCoreLogTick(sc));
   /* tkExplosionUpdate(&mp, &pb, &bs);
   shellsUpdate(&shs, &mp, &pb, &bs, &tk);
   explosionsUpdate();
   minesExpUpdate(&mp); 
   floodUpdate(&mp, &pb, &bs);  */
 
-  tickCount++;
-  if (tickCount == 20 * 30) {
-    tickCount = 0;
-    logWriteSnapshot(&mp, &pb, &bs, &ss, &splrs, TRUE);
+  sc->tickCount++;
+  if (sc->tickCount == 20 * 30) {
+    sc->tickCount = 0;
+    SERVER_CORE_PROFILE(profileSnapshot, logWriteSnapshot(sc->serverLog, &sc->mp, &sc->pb, &sc->bs, &sc->ss, &sc->splrs, TRUE));
   }
+#ifdef BOLO_PROFILE
+  serverCoreProfileTicks++;
+#endif
 }
 
 /*********************************************************
 *NAME:          serverCoreGetTimeGameCreated
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99*PURPOSE:
+*LAST MODIFIED: 16/10/26*PURPOSE:
 * Returns the time the game was created
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-long serverCoreGetTimeGameCreated(void) {
-  return sTimeStart;
+long serverCoreGetTimeGameCreated(serverCore sc) {
+  return sc->sTimeStart;
 }
 
 /*********************************************************
 *NAME:          serverCoreSetTimeGameCreated
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets the time the game was created
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  value - Time to set it to
 *********************************************************/
-void serverCoreSetTimeGameCreated(long value) {
-  sTimeStart = value;
+void serverCoreSetTimeGameCreated(serverCore sc, long value) {
+  sc->sTimeStart = value;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetMapName
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * The front end wants to know what the map name is.
 * Make a copy for it.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  value - Place to hold copy of the map name
 *********************************************************/
-void serverCoreGetMapName(char *value) {
-  strcpy(value, sMapName);
+void serverCoreGetMapName(serverCore sc, char *value) {
+  strcpy(value, sc->sMapName);
 }
 
 /*********************************************************
 *NAME:          serverCoreGetActualGameType
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the game type (open/tournament etc.)
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-gameType serverCoreGetActualGameType() {
-  return gameTypeGet(&sGame);
+gameType serverCoreGetActualGameType(serverCore sc) {
+  return gameTypeGet(&sc->sGame);
 }
 
 /*********************************************************
 *NAME:          serverCoreGetAllowHiddenMines
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns whether hidden mines are allowed in the game
 * or not
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-bool serverCoreGetAllowHiddenMines() {
-  return minesGetAllowHiddenMines(&serverMines);
+bool serverCoreGetAllowHiddenMines(serverCore sc) {
+  return minesGetAllowHiddenMines(&sc->serverMines);
 }
 
 /*********************************************************
 *NAME:          serverCoreGetGameStartDelay
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the time remaining to start the current game
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-long serverCoreGetGameStartDelay() {
-  return sGmeStartDelay;
+long serverCoreGetGameStartDelay(serverCore sc) {
+  return sc->sGmeStartDelay;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetGameTimeLeft
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the time remaining the current game
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-long serverCoreGetGameTimeLeft() {
-  return sGmeLength;
+long serverCoreGetGameTimeLeft(serverCore sc) {
+  return sc->sGmeLength;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetNumPlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the number of players in the game
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverCoreGetNumPlayers() {
-  return playersGetNumPlayers(&splrs);
+BYTE serverCoreGetNumPlayers(serverCore sc) {
+  return playersGetNumPlayers(&sc->splrs);
 }
 
 /*********************************************************
 *NAME:          serverCoreGetNumNeutralPills
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the number of neutral pills
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverCoreGetNumNeutralPills(void) {
-  return pillsGetNumNeutral(&pb);
+BYTE serverCoreGetNumNeutralPills(serverCore sc) {
+  return pillsGetNumNeutral(&sc->pb);
 }
 
 
@@ -535,107 +704,206 @@ BYTE serverCoreGetNumNeutralPills(void) {
 *NAME:          serverCoreGetNumNeutralBases
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the number of neutral bases
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverCoreGetNumNeutralBases(void) {
-  return basesGetNumNeutral(&bs);
+BYTE serverCoreGetNumNeutralBases(serverCore sc) {
+  return basesGetNumNeutral(&sc->bs);
 }
 
 /*********************************************************
 *NAME:          serverCoreGetBaseNetData
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 27/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Request for base data has been made.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer to hold copy of base data
 *********************************************************/
-BYTE serverCoreGetBaseNetData(BYTE *buff) {
-  return basesGetBaseNetData(&bs, buff);
+BYTE serverCoreGetBaseNetData(serverCore sc, BYTE *buff) {
+  return basesGetBaseNetData(&sc->bs, buff);
 }
 
 /*********************************************************
 *NAME:          serverCoreGetPillNetData
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 27/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Request for pill data has been made.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer to hold copy of pill data
 *********************************************************/
-BYTE serverCoreGetPillNetData(BYTE *buff) {
-  return pillsGetPillNetData(&pb, buff);
+BYTE serverCoreGetPillNetData(serverCore sc, BYTE *buff) {
+  return pillsGetPillNetData(&sc->pb, buff);
 }
 
 /*********************************************************
 *NAME:          serverCoreGetStartsNetData
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 27/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Request for starts data has been made.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer to hold copy of starts data
 *********************************************************/
-BYTE serverCoreGetStartsNetData(BYTE *buff) {
-  return startsGetStartNetData(&ss, buff);
+BYTE serverCoreGetStartsNetData(serverCore sc, BYTE *buff) {
+  return startsGetStartNetData(&sc->ss, buff);
 }
 
 /*********************************************************
 *NAME:          serverCoreMakeMapNetRun
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/8/99
-*LAST MODIFIED:  7/1/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Makes the map net run data. Returns data length
+* Makes the map net run data from the run cache. Returns
+* data length
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer to hold data
 *  yPos - Y position of the run
 *********************************************************/
-int serverCoreMakeMapNetRun(BYTE *buff, BYTE yPos) {
-  return mapMakeNetRun(&mp, buff, yPos);
+int serverCoreMakeMapNetRun(serverCore sc, BYTE *buff, BYTE yPos) {
+  BYTE rows[MAP_NET_RUN_SIZE]; /* Rows of a run not cached */
+  unsigned long version;       /* Version of a run not cached */
+  int returnValue;             /* Value to return */
+
+  returnValue = serverCoreGetMapNetRun(sc, buff, yPos, rows, &version);
+  if (returnValue == MAP_RUN_CACHE_MISS) {
+    returnValue = mapRunCacheEncode(rows, buff);
+    serverCorePutMapNetRun(sc, buff, yPos, returnValue, version);
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          serverCoreGetMapNetRun
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies the cached map net run at yPos into buff and
+* returns its length. If it isn't cached the rows are
+* copied into rows and MAP_RUN_CACHE_MISS is returned.
+* The caller can then unlock, make the run with
+* mapRunCacheEncode, lock and pass it to
+* serverCorePutMapNetRun
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  buff    - Buffer to hold data
+*  yPos    - Y position of the run
+*  rows    - Buffer of MAP_NET_RUN_SIZE to hold the rows
+*  version - Set to the run version on a miss
+*********************************************************/
+int serverCoreGetMapNetRun(serverCore sc, BYTE *buff, BYTE yPos, BYTE *rows, unsigned long *version) {
+  return mapRunCacheGet(&sc->runCache, &sc->mp, yPos, buff, rows, version);
+}
+
+/*********************************************************
+*NAME:          serverCorePutMapNetRun
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Caches a map net run made after serverCoreGetMapNetRun
+* missed, unless the map has changed under it
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  buff    - The run
+*  yPos    - Y position of the run
+*  len     - Length of the run
+*  version - Version from serverCoreGetMapNetRun
+*********************************************************/
+void serverCorePutMapNetRun(serverCore sc, BYTE *buff, BYTE yPos, int len, unsigned long version) {
+  mapRunCachePut(&sc->runCache, &sc->mp, yPos, buff, len, version);
+}
+
+/*********************************************************
+*NAME:          serverCoreGetMapNetStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the size of the map's pending change pool and how
+* many changes were dropped because it could not grow
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  poolSize - Items in the pool
+*  lost     - Changes dropped
+*********************************************************/
+void serverCoreGetMapNetStats(serverCore sc, unsigned long *poolSize, unsigned long *lost) {
+  mapNetGetStats(&sc->mp, poolSize, lost);
+}
+
+/*********************************************************
+*NAME:          serverCoreGetJoinData
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies the starts, bases, pills and map a joining player
+* downloads into buff uncompressed. It is packed with
+* netJoinPack once the game mutex has been let go. buff
+* must hold NET_JOIN_RAW_SIZE bytes. Returns the length
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  buff - Buffer to hold data
+*********************************************************/
+int serverCoreGetJoinData(serverCore sc, BYTE *buff) {
+  return netJoinCopy(&sc->mp, &sc->ss, &sc->bs, &sc->pb, buff);
 }
 
 /*********************************************************
 *NAME:          serverCorePlayerJoin
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A new player has joined the game
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Player number of th new player
 *********************************************************/
-void serverCorePlayerJoin(BYTE playerNum) {
-  tankCreate(&tk[playerNum], &ss);
-  lgman[playerNum] = lgmCreate(playerNum);
-  tankSetWorld(&tk[playerNum], 0, 0, 0.0f , FALSE);
+void serverCorePlayerJoin(serverCore sc, BYTE playerNum) {
+  tankCreate(&sc->tk[playerNum], &sc->ss);
+  sc->lgman[playerNum] = lgmCreate(playerNum);
+  tankSetWorld(&sc->tk[playerNum], 0, 0, 0.0f , FALSE);
+  sc->posAck[playerNum] = POS_DELTA_NONE;
+  sc->posJoin[playerNum]++;
 }
 
 /*********************************************************
 *NAME:          serverCorePlayerLeave
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A player has left the game
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Player number of th new player
 *********************************************************/
-void serverCorePlayerLeave(BYTE playerNum) {
+void serverCorePlayerLeave(serverCore sc, BYTE playerNum) {
   BYTE count; /* Looping variable */
   bool found; /* Finished searching */
   char playerName[PLAYER_NAME_LEN]; /* Player Name */
@@ -643,47 +911,48 @@ void serverCorePlayerLeave(BYTE playerNum) {
   PlayerBitMap basesOwn;            /* Bases they own */
 
 
-  playersGetPlayerName(&splrs, playerNum, playerName);
-  tankDestroy(&tk[playerNum], &mp, &pb, &bs);
-  pills = pillsGetOwnerBitMask(&pb, playerNum);
-  basesOwn = basesGetOwnerBitMask(&bs, playerNum);
-  playersRejoinAddPlayer(playerName, pills, basesOwn);
-  tk[playerNum] = NULL;
-  if (playersGetNumAllie(&splrs, playerNum) == 1) {
+  playersGetPlayerName(&sc->splrs, playerNum, playerName);
+  tankDestroy(&sc->tk[playerNum], &sc->mp, &sc->pb, &sc->bs);
+  pills = pillsGetOwnerBitMask(&sc->pb, playerNum);
+  basesOwn = basesGetOwnerBitMask(&sc->bs, playerNum);
+  playersRejoinAddPlayer(&sc->rejoin, playerName, pills, basesOwn);
+  sc->tk[playerNum] = NULL;
+  if (playersGetNumAllie(&sc->splrs, playerNum) == 1) {
     /* Has no allies - Set all things owned to neutral */
-    pillsDropSetNeutralOwner(&pb, playerNum);
-    basesSetNeutralOwner(&bs, playerNum);
+    pillsDropSetNeutralOwner(&sc->pb, playerNum);
+    basesSetNeutralOwner(&sc->bs, playerNum);
   } else {
     count = 0;
     found = FALSE;
     while (count < MAX_TANKS && found == FALSE) {
       if (playerNum != count) {
-        if (playersIsAllie(&splrs, count, playerNum) == TRUE) {
+        if (playersIsAllie(&sc->splrs, count, playerNum) == TRUE) {
           found = TRUE;
         }
       }
       count++;
     }
     count--;
-    basesMigrate(&bs, playerNum, count);
-    pillsMigrate(&pb, playerNum, count);
+    basesMigrate(&sc->bs, playerNum, count);
+    pillsMigrate(&sc->pb, playerNum, count);
   }
 
-  playersLeaveGame(&splrs, playerNum);
+  playersLeaveGame(&sc->splrs, playerNum);
 }
 
 /*********************************************************
 *NAME:          serverCoreSetPosData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED: 31/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Process a player pos packet
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Data Buffer
 *********************************************************/
-void serverCoreSetPosData(BYTE *buff) {
+void serverCoreSetPosData(serverCore sc, BYTE *buff) {
   BYTE frame;     /* Animation frame */
   BYTE mx;        /* Map X and Y position */
   BYTE my;
@@ -708,7 +977,7 @@ void serverCoreSetPosData(BYTE *buff) {
   ptr = buff;
   utilGetNibbles(*ptr, &playerNum, &frame);
   ptr++;
-  if (tk[playerNum] != NULL) {
+  if (sc->tk[playerNum] != NULL) {
     memcpy(&wx, ptr, sizeof(WORLD));
     ptr += sizeof(WORLD);
     memcpy(&wy, ptr, sizeof(WORLD));
@@ -741,18 +1010,18 @@ void serverCoreSetPosData(BYTE *buff) {
 
     /* Update Players */
     mx=my=px=py=0;
-    if (tk[playerNum] != NULL) {
+    if (sc->tk[playerNum] != NULL) {
       if (wx == 0 && wy == 0) {
-        tankGetWorld(&tk[playerNum], &testX, &testY);
+        tankGetWorld(&sc->tk[playerNum], &testX, &testY);
         if (testX != 0 || testY != 0) {
           /* Tank is dead but we received a pos packet before we received the death packet */
-          tankDropPills(&tk[playerNum], &mp, &pb, &bs);
-          tankSetArmour(&tk[playerNum], TANK_FULL_ARMOUR+1);
+          tankDropPills(&sc->tk[playerNum], &sc->mp, &sc->pb, &sc->bs);
+          tankSetArmour(&sc->tk[playerNum], TANK_FULL_ARMOUR+1);
         }
       }
-      tankSetLocationData(&tk[playerNum], wx, wy, ang, st, onBoat);
+      tankSetLocationData(&sc->tk[playerNum], wx, wy, ang, st, onBoat);
     }
-    playersUpdate(&splrs, playerNum, mx, my, px, py, frame, onBoat, lgmMX, lgmMY, lgmPX, lgmPY, lgmFrame);
+    playersUpdate(&sc->splrs, playerNum, mx, my, px, py, frame, onBoat, lgmMX, lgmMY, lgmPX, lgmPY, lgmFrame);
   }
 }
 
@@ -760,17 +1029,18 @@ void serverCoreSetPosData(BYTE *buff) {
 *NAME:          serverCoreTankInView
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED:  8/9/00
+*LAST MODIFIED:  16/10/26
 *PURPOSE:
 * Returns if the item at checkX, checkY is in viewing
 * range of playre playerNum and any of its pillboxes
 *
 *ARGUMENTS:
+*  sc - Game to use
 * playerNum - PlayerNum to check
 * checkX    - X Position to check
 * checkY    - Y Position to check
 *********************************************************/
-bool serverCoreTankInView(BYTE playerNum, BYTE checkX, BYTE checkY) {
+bool serverCoreTankInView(serverCore sc, BYTE playerNum, BYTE checkX, BYTE checkY) {
   bool returnValue; /* Value to return */
   BYTE mx;
   BYTE my;
@@ -779,8 +1049,8 @@ bool serverCoreTankInView(BYTE playerNum, BYTE checkX, BYTE checkY) {
 
   returnValue = FALSE;
   if (playerNum < MAX_TANKS) {
-    mx = tankGetMX(&tk[playerNum]);
-    my = tankGetMY(&tk[playerNum]);
+    mx = tankGetMX(&sc->tk[playerNum]);
+    my = tankGetMY(&sc->tk[playerNum]);
 
     if (checkX - mx < 0) {
       gapX = mx - checkX;
@@ -798,129 +1068,530 @@ bool serverCoreTankInView(BYTE playerNum, BYTE checkX, BYTE checkY) {
       returnValue = TRUE;
     } else {
       /* Check for pill views */
-      returnValue = pillsIsInView(&pb, playerNum, checkX, checkY);
+      returnValue = pillsIsInView(&sc->pb, playerNum, checkX, checkY);
     }
   }
   return returnValue;
 }
 
- typedef struct {
-  BYTE buff[50];
-  bool lgmOut;
-  int len;
-} posData;
-
-posData playersPosData[MAX_TANKS];
-
 /*********************************************************
 *NAME:          serverCorePreparePosPackets
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED:  8/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Prepares the player pos data in the array
+* Prepares the player pos data in a snapshot
 *
 *ARGUMENTS:
+*  sc - Game to use
+*  snap - Snapshot to fill
 *********************************************************/
-void serverCorePreparePosPackets() {
+static void serverCorePreparePosPackets(serverCore sc, serverCoreSnapshot *snap) {
   BYTE pos;   /* Position in the buffer for adding */
   BYTE high;  /* Nibble high */
   BYTE low;   /* Nibble Low */
   BYTE count; /* Looping variable */
+  BYTE view;  /* Looping variable */
 
   count = 0;
   while (count < MAX_TANKS) {
-    if (playersIsInUse(&splrs, count) == TRUE && tk[count] != NULL) {
-      playersPosData[count].len = 0;
+    snap->inUse[count] = playersIsInUse(&sc->splrs, count);
+    count++;
+  }
+
+  count = 0;
+  while (count < MAX_TANKS) {
+    if (snap->inUse[count] == TRUE && sc->tk[count] != NULL) {
+      snap->player[count].len = 0;
       pos = 0;
 
       /* Tank position */
-      playersPosData[count].buff[pos] = tankGetMX(&tk[count]);
+      snap->player[count].buff[pos] = tankGetMX(&sc->tk[count]);
       pos++;
-      playersPosData[count].buff[pos] = tankGetMY(&tk[count]);
+      snap->player[count].buff[pos] = tankGetMY(&sc->tk[count]);
       pos++;
-      high = tankGetPX(&tk[count]);
-      low = tankGetPY(&tk[count]);
-      playersPosData[count].buff[pos] = utilPutNibble(high, low);
+      high = tankGetPX(&sc->tk[count]);
+      low = tankGetPY(&sc->tk[count]);
+      snap->player[count].buff[pos] = utilPutNibble(high, low);
       pos++;
 
       /* Tank Options */
-      high = tankIsOnBoat(&tk[count]);
-      low = tankGetDir(&tk[count]);
-      playersPosData[count].buff[pos] = utilPutNibble(high, low);
+      high = tankIsOnBoat(&sc->tk[count]);
+      low = tankGetDir(&sc->tk[count]);
+      snap->player[count].buff[pos] = utilPutNibble(high, low);
       pos++;
 
 
       /* Lgm position */
-      playersPosData[count].buff[pos] = lgmGetMX(&lgman[count]);
+      snap->player[count].buff[pos] = lgmGetMX(&sc->lgman[count]);
       pos++;
-      playersPosData[count].buff[pos] = lgmGetMY(&lgman[count]);
+      snap->player[count].buff[pos] = lgmGetMY(&sc->lgman[count]);
       pos++;
-      playersPosData[count].buff[pos] = utilPutNibble(lgmGetPX(&lgman[count]), lgmGetPY(&lgman[count]));
+      snap->player[count].buff[pos] = utilPutNibble(lgmGetPX(&sc->lgman[count]), lgmGetPY(&sc->lgman[count]));
       pos++;
       /* Frame */
-      playersPosData[count].buff[pos] = utilPutNibble(lgmGetFrame(&lgman[count]), lgmGetBrainObstructed(&lgman[count]));
+      snap->player[count].buff[pos] = utilPutNibble(lgmGetFrame(&sc->lgman[count]), lgmGetBrainObstructed(&sc->lgman[count]));
       pos++;
-      playersPosData[count].len = pos;
-      playersPosData[count].lgmOut = lgmIsOut(&lgman[count]);
+      snap->player[count].len = pos;
+      snap->player[count].lgmOut = lgmIsOut(&sc->lgman[count]);
+      snap->player[count].tankMX = tankGetMX(&sc->tk[count]);
+      snap->player[count].tankMY = tankGetMY(&sc->tk[count]);
+      snap->player[count].lgmMX = (BYTE) (lgmGetWX(&sc->lgman[count]) >> M_W_SHIFT_SIZE);
+      snap->player[count].lgmMY = (BYTE) (lgmGetWY(&sc->lgman[count]) >> M_W_SHIFT_SIZE);
+
+      /* A tank that needs an update is sent to the first other
+         player whatever the range */
+      snap->player[count].forceView = NEUTRAL;
+      if (playersNeedUpdate(&sc->splrs, count) == TRUE) {
+        view = 0;
+        while (view < MAX_TANKS && (snap->inUse[view] == FALSE || view == count)) {
+          view++;
+        }
+        if (view < MAX_TANKS) {
+          snap->player[count].forceView = view;
+        }
+      }
     } else {
-      playersPosData[count].len = -1;
+      snap->player[count].len = -1;
     }
     count++;
   }
+  playerNeedUpdateDone(&sc->splrs);
 } 
 
+/*********************************************************
+*NAME:          serverCorePrepareViews
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies the pillbox positions and which players each
+* one gives a view to into a snapshot
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  snap - Snapshot to fill
+*********************************************************/
+static void serverCorePrepareViews(serverCore sc, serverCoreSnapshot *snap) {
+  pillbox item; /* Pillbox being copied */
+  BYTE count;   /* Looping variables */
+  BYTE player;
+
+  snap->numPills = pillsGetNumPills(&sc->pb);
+  count = 0;
+  while (count < snap->numPills) {
+    pillsGetPill(&sc->pb, &item, (BYTE) (count+1));
+    snap->pillX[count] = item.x;
+    snap->pillY[count] = item.y;
+    snap->pillAllies[count] = 0;
+    player = 0;
+    while (player < MAX_TANKS) {
+      if (playersIsAllie(&sc->splrs, item.owner, player) == TRUE) {
+        snap->pillAllies[count] |= (unsigned short) (1 << player);
+      }
+      player++;
+    }
+    count++;
+  }
+}
+
+/*********************************************************
+*NAME:          serverCorePillsNear
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns a bit for each pill in a snapshot that is close
+* enough to see the map square checkX, checkY
+*
+*ARGUMENTS:
+* snap   - Snapshot to check
+* checkX - X Position to check
+* checkY - Y Position to check
+*********************************************************/
+static unsigned short serverCorePillsNear(serverCoreSnapshot *snap, BYTE checkX, BYTE checkY) {
+  unsigned short returnValue; /* Value to return */
+  int gapX;                   /* Distance from the pill */
+  int gapY;
+  BYTE count;                 /* Looping variable */
+
+  returnValue = 0;
+  count = 0;
+  while (count < snap->numPills) {
+    gapX = snap->pillX[count] - checkX;
+    gapY = snap->pillY[count] - checkY;
+    if (gapX >= -10 && gapX <= 10 && gapY >= -10 && gapY <=  10) {
+      returnValue |= (unsigned short) (1 << count);
+    }
+    count++;
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          serverCoreTankNear
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns if the map square checkX, checkY is on the
+* screen of player playerNum's tank, with a little buffer
+*
+*ARGUMENTS:
+* snap      - Snapshot to check
+* playerNum - PlayerNum to check
+* checkX    - X Position to check
+* checkY    - Y Position to check
+*********************************************************/
+static bool serverCoreTankNear(serverCoreSnapshot *snap, BYTE playerNum, BYTE checkX, BYTE checkY) {
+  int gapX; /* Distance from the tank */
+  int gapY;
+
+  if (snap->player[playerNum].len == -1) {
+    return FALSE;
+  }
+  gapX = checkX - snap->player[playerNum].tankMX;
+  gapY = checkY - snap->player[playerNum].tankMY;
+  if (gapX < 0) {
+    gapX = -gapX;
+  }
+  if (gapY < 0) {
+    gapY = -gapY;
+  }
+  return (bool) (gapX <= MAIN_SCREEN_SIZE_X +2 && gapY <= MAIN_SCREEN_SIZE_Y +2);
+}
+
+#ifdef BOLO_PROFILE
+/*********************************************************
+*NAME:          serverCoreViewScanCost
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns the number of pills serverCoreTankInView would
+* look at to see if a player can see a map square
+*
+*ARGUMENTS:
+* snap      - Snapshot to check
+* playerNum - PlayerNum to check
+* checkX    - X Position to check
+* checkY    - Y Position to check
+*********************************************************/
+static unsigned long serverCoreViewScanCost(serverCoreSnapshot *snap, BYTE playerNum, BYTE checkX, BYTE checkY) {
+  unsigned short near; /* Pills in range */
+  BYTE count;          /* Looping variable */
+
+  if (serverCoreTankNear(snap, playerNum, checkX, checkY) == TRUE) {
+    return 0;
+  }
+  near = serverCorePillsNear(snap, checkX, checkY);
+  count = 0;
+  while (count < snap->numPills) {
+    if ((snap->pillAllies[count] & (1 << playerNum)) && (near & (1 << count))) {
+      return count + 1;
+    }
+    count++;
+  }
+  return snap->numPills;
+}
+#endif
+
+/*********************************************************
+*NAME:          serverCorePrepareViewMatrix
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Works out which tanks and lgms every player can see
+* from their tank or their allies pills. Each tank and
+* lgm is checked against the pills once, then each
+* player only needs a screen range check and a mask test.
+*
+*ARGUMENTS:
+*  snap - Snapshot to fill. Positions and pill views must
+*         already be in it
+*********************************************************/
+static void serverCorePrepareViewMatrix(serverCoreSnapshot *snap) {
+  unsigned short alliedPills[MAX_TANKS]; /* Pills each player can see from */
+  unsigned short tankPills;              /* Pills that can see the tank */
+  unsigned short lgmPills;               /* Pills that can see the lgm */
+  BYTE count;                            /* Looping variables */
+  BYTE view;
+
+  view = 0;
+  while (view < MAX_TANKS) {
+    alliedPills[view] = 0;
+    snap->tankView[view] = 0;
+    snap->lgmView[view] = 0;
+    view++;
+  }
+  count = 0;
+  while (count < snap->numPills) {
+    view = 0;
+    while (view < MAX_TANKS) {
+      if (snap->pillAllies[count] & (1 << view)) {
+        alliedPills[view] |= (unsigned short) (1 << count);
+      }
+      view++;
+    }
+    count++;
+  }
+
+  count = 0;
+  while (count < MAX_TANKS) {
+    if (snap->player[count].len != -1) {
+      tankPills = serverCorePillsNear(snap, snap->player[count].tankMX, snap->player[count].tankMY);
+      lgmPills = 0;
+      if (snap->player[count].lgmOut == TRUE) {
+        lgmPills = serverCorePillsNear(snap, snap->player[count].lgmMX, snap->player[count].lgmMY);
+      }
+#ifdef BOLO_PROFILE
+      serverCoreViewPillChecks += (snap->player[count].lgmOut == TRUE) ? 2 * snap->numPills : snap->numPills;
+#endif
+      view = 0;
+      while (view < MAX_TANKS) {
+        if (snap->inUse[view] == TRUE) {
+          if ((tankPills & alliedPills[view]) || serverCoreTankNear(snap, view, snap->player[count].tankMX, snap->player[count].tankMY) == TRUE) {
+            snap->tankView[view] |= (unsigned short) (1 << count);
+          }
+          if (snap->player[count].lgmOut == TRUE && ((lgmPills & alliedPills[view]) || serverCoreTankNear(snap, view, snap->player[count].lgmMX, snap->player[count].lgmMY) == TRUE)) {
+            snap->lgmView[view] |= (unsigned short) (1 << count);
+          }
+        }
+        view++;
+      }
+    }
+    count++;
+  }
+}
+
+/*********************************************************
+*NAME:          serverCorePublishSnapshot
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Fills the unpublished snapshot from the game and then
+* publishes it. Shells, map, tank explosion, pillbox/base
+* and mine/terrain data taken are marked as sent. Must be
+* called holding the mutex.
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  wantPos  - Take position and shell data
+*  wantData - Take map and event data
+*********************************************************/
+void serverCorePublishSnapshot(serverCore sc, bool wantPos, bool wantData) {
+  serverCoreSnapshot *snap; /* Snapshot being filled */
+
+  snap = &sc->snap[1 - sc->snapFront];
+  sc->snapSeq++;
+  snap->seq = sc->snapSeq;
+  snap->hasPos = wantPos;
+  snap->hasData = wantData;
+  if (wantPos == TRUE) {
+    serverCorePreparePosPackets(sc, snap);
+    memcpy(snap->posAck, sc->posAck, sizeof(snap->posAck));
+    memcpy(snap->posJoin, sc->posJoin, sizeof(snap->posJoin));
+    serverCorePrepareViews(sc, snap);
+    serverCorePrepareViewMatrix(snap);
+    snap->numShells = shellsNetTake(&sc->shs, snap->shell);
+  }
+  if (wantData == TRUE) {
+    snap->mapLen = serverCoreMakeMapData(sc, snap->mapData);
+    snap->tkLen = serverCoreMakeTkData(sc, snap->tkData);
+    snap->pnbLen = (BYTE) netPNBMake(&sc->serverPNB, snap->pnbData);
+    snap->mntLen = (BYTE) netMNTMake(&sc->serverNMT, snap->mntData);
+  }
+  sc->snapFront = 1 - sc->snapFront;
+}
+
+/*********************************************************
+*NAME:          serverCoreGetSnapshot
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns the last published snapshot. It is not changed
+* until the snapshot after next is published.
+*
+*ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+serverCoreSnapshot *serverCoreGetSnapshot(serverCore sc) {
+  return &sc->snap[sc->snapFront];
+}
+
+/*********************************************************
+*NAME:          serverCoreSnapshotInView
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns if the item at checkX, checkY is in viewing
+* range of player playerNum or any of its pillboxes as
+* they were when the snapshot was taken. Matches
+* serverCoreTankInView.
+*
+*ARGUMENTS:
+* snap      - Snapshot to check
+* playerNum - PlayerNum to check
+* checkX    - X Position to check
+* checkY    - Y Position to check
+*********************************************************/
+static bool serverCoreSnapshotInView(serverCoreSnapshot *snap, BYTE playerNum, BYTE checkX, BYTE checkY) {
+  unsigned short near; /* Pills in range */
+  BYTE count;          /* Looping variable */
+
+  if (playerNum >= MAX_TANKS) {
+    return FALSE;
+  }
+  if (serverCoreTankNear(snap, playerNum, checkX, checkY) == TRUE) {
+    return TRUE;
+  }
+
+  /* Check for pill views */
+  near = serverCorePillsNear(snap, checkX, checkY);
+  count = 0;
+  while (count < snap->numPills) {
+    if ((near & (1 << count)) && (snap->pillAllies[count] & (1 << playerNum))) {
+      return TRUE;
+    }
+    count++;
+  }
+  return FALSE;
+}
+
+/*********************************************************
+*NAME:          serverCoreSnapshotSees
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns if player playerNum can see item itemNum in a
+* snapshot view matrix
+*
+*ARGUMENTS:
+* snap      - Snapshot to check
+* view      - tankView or lgmView of the snapshot
+* playerNum - Player looking
+* itemNum   - Player the tank or lgm belongs to
+*********************************************************/
+static bool serverCoreSnapshotSees(serverCoreSnapshot *snap, unsigned short *view, BYTE playerNum, BYTE itemNum) {
+#ifdef BOLO_PROFILE
+  serverCoreViewLookups++;
+#endif
+  if (playerNum >= MAX_TANKS) {
+    return FALSE;
+  }
+  return (bool) ((view[playerNum] >> itemNum) & 1);
+}
+
+/*********************************************************
+*NAME:          serverCoreMakePosFrame
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Fills frame with the tanks and lgms player playerNum
+* can see in the published snapshot
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  frame     - Frame to fill
+*  playerNum - Player looking
+*********************************************************/
+void serverCoreMakePosFrame(serverCore sc, posDeltaFrame *frame, BYTE playerNum) {
+  BYTE count; /* Looping variable */
+  bool tankInView;
+  bool lgmInView;
+  posDeltaItem *item;       /* Item being filled */
+  serverCoreSnapshot *snap; /* Snapshot to build from */
+
+  count = 0;
+  snap = serverCoreGetSnapshot(sc);
+  memset(frame, 0, sizeof(posDeltaFrame));
+
+  while (count < MAX_TANKS) {
+    if (snap->player[count].len != -1) {
+      item = &frame->item[count];
+      lgmInView = snap->player[count].lgmOut;
+      if (lgmInView == TRUE) {
+        lgmInView = serverCoreSnapshotSees(snap, snap->lgmView, playerNum, count);
+#ifdef BOLO_PROFILE
+        serverCoreViewPairChecks += serverCoreViewScanCost(snap, playerNum, snap->player[count].lgmMX, snap->player[count].lgmMY);
+#endif
+      }
+      tankInView = FALSE;
+      if (playerNum != count) {
+        tankInView = (bool) (snap->player[count].forceView == playerNum);
+        if (tankInView == FALSE) {
+          tankInView = serverCoreSnapshotSees(snap, snap->tankView, playerNum, count);
+#ifdef BOLO_PROFILE
+          serverCoreViewPairChecks += serverCoreViewScanCost(snap, playerNum, snap->player[count].tankMX, snap->player[count].tankMY);
+#endif
+        }
+      }
+      if (tankInView == TRUE) {
+        item->flags |= POS_DELTA_TANK;
+        memcpy(item->tank, snap->player[count].buff, POS_DELTA_BLOCK_SIZE);
+      }
+      if (lgmInView == TRUE) {
+        item->flags |= POS_DELTA_LGM;
+        memcpy(item->lgm, snap->player[count].buff + POS_DELTA_BLOCK_SIZE, POS_DELTA_BLOCK_SIZE);
+      }
+    }
+    count++;
+  }
+}
+
 /*********************************************************
 *NAME:          serverCoreMakePosPackets
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED: 30/7/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Makes a position packet for all players in the game.
-* Returns packet length
+* Makes the original full position data for a frame.
+* Every visible tank and lgm is sent each time. No longer
+* sent by the server but kept to compare against
+* serverCoreMakePosDelta. Returns packet length
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff      - Data Buffer of packet
+*  frame     - Frame made by serverCoreMakePosFrame
 *  noPlayer  - Player not to make data for
 *  sendStale - TRUE if we want to send out stale values
 *              aswell
 *********************************************************/
-int serverCoreMakePosPackets(BYTE *buff, BYTE noPlayer, bool sendStale) {
+int serverCoreMakePosPackets(serverCore sc, BYTE *buff, posDeltaFrame *frame, BYTE noPlayer, bool sendStale) {
   BYTE pos;   /* Position in the buffer for adding */
   BYTE count; /* Looping variable */
   BYTE *loc;
   bool tankInView;
   bool lgmInView;
+  serverCoreSnapshot *snap; /* Snapshot the frame is from */
 
   pos = 0;
   count = 0;
   loc = buff;
+  snap = serverCoreGetSnapshot(sc);
 
   while (count < MAX_TANKS) {
-    if (playersPosData[count].len != -1) {
-      lgmInView = lgmIsOut(&lgman[count]);
-      if (lgmInView == TRUE) {
-//        serverCoreTankInView(noPlayer, lgmGetMX(&lgman[count]), lgmGetMY(&lgman[count]), TRUE, lgmGetFrame(&lgman[count]));
-        lgmInView = serverCoreTankInView(noPlayer, (BYTE) (lgmGetWX(&lgman[count]) >> M_W_SHIFT_SIZE), (BYTE) (lgmGetWY(&lgman[count])  >> M_W_SHIFT_SIZE));
-      }
-      tankInView = FALSE;
-      if (noPlayer != count) {
-        tankInView = playersNeedUpdate(&splrs, count);
-        if (tankInView == FALSE) {
-          tankInView = serverCoreTankInView(noPlayer, tankGetMX(&tk[count]), tankGetMY(&tk[count]));
-        }
-      }
+    if (snap->player[count].len != -1) {
+      tankInView = (bool) ((frame->item[count].flags & POS_DELTA_TANK) != 0);
+      lgmInView = (bool) ((frame->item[count].flags & POS_DELTA_LGM) != 0);
       if (tankInView == TRUE || lgmInView == TRUE) {
         *loc = utilPutNibble(count, (BYTE) (((tankInView << 2) + lgmInView)));
         loc++;
         pos++;
         if (tankInView == TRUE) {
-          memcpy(loc, playersPosData[count].buff, 4);
+          memcpy(loc, frame->item[count].tank, 4);
           loc += 4;
           pos += 4;
         }
         if (lgmInView == TRUE) {
-          memcpy(loc, (playersPosData[count].buff+4), 4);
+          memcpy(loc, frame->item[count].lgm, 4);
           loc += 4;
           pos += 4;
         }
@@ -937,107 +1608,180 @@ int serverCoreMakePosPackets(BYTE *buff, BYTE noPlayer, bool sendStale) {
 
 }
 
+/*********************************************************
+*NAME:          serverCoreMakePosDelta
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Makes the position data for a frame as a delta from the
+* last frame player playerNum acknowledged. Returns the
+* data length, 0 if there is nothing to send
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  buff      - Data Buffer of packet
+*  frame     - Frame made by serverCoreMakePosFrame
+*  playerNum - Player the packet is for
+*********************************************************/
+int serverCoreMakePosDelta(serverCore sc, BYTE *buff, posDeltaFrame *frame, BYTE playerNum) {
+  serverCoreSnapshot *snap; /* Snapshot the frame is from */
+  bool force;               /* Send even if nothing changed */
+
+  snap = serverCoreGetSnapshot(sc);
+  if (snap->posJoin[playerNum] != sc->posHistoryJoin[playerNum]) {
+    /* A new player is in the slot */
+    posDeltaReset(&sc->posHistory[playerNum]);
+    sc->posHistoryJoin[playerNum] = snap->posJoin[playerNum];
+  }
+  /* The client moves its own lgm too so keep correcting it
+     while it is out */
+  force = (bool) ((frame->item[playerNum].flags & POS_DELTA_LGM) != 0);
+  return posDeltaEncode(&sc->posHistory[playerNum], frame, snap->posAck[playerNum], force, buff);
+}
+
+/*********************************************************
+*NAME:          serverCoreSetPosAck
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* A player has acknowledged a position frame. Deltas made
+* after the next snapshot are from it. Must be called
+* holding the mutex.
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  playerNum - Player number
+*  seq       - Frame sequence number acknowledged
+*********************************************************/
+void serverCoreSetPosAck(serverCore sc, BYTE playerNum, BYTE seq) {
+  if (playerNum < MAX_TANKS) {
+    sc->posAck[playerNum] = seq;
+  }
+}
+
 /*********************************************************
 *NAME:          serverCoreExtractShellData
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/10/99
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Extracts the shell data from a network packet
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *  len  - Length of the buffer
 *********************************************************/
-void serverCoreExtractShellData(BYTE *buff, BYTE len) {
-  shellsNetExtract(&shs, &pb, buff, len, TRUE);
+void serverCoreExtractShellData(serverCore sc, BYTE *buff, BYTE len) {
+  shellsNetExtract(&sc->shs, &sc->pb, buff, len, TRUE);
 }
 
 /*********************************************************
 *NAME:          serverCoreMakeShellData
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/10/99
-*LAST MODIFIED:  8/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Makes the shell data for a network packet. Returns the
-* packet length
+* Makes the shell data for a network packet from the
+* published snapshot. Returns the packet length
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff        - Buffer containing the data
 *  noPlayerNum - Player not to make data for
-*  sentState   - What to set the shell sent state to
 *********************************************************/
-BYTE serverCoreMakeShellData(BYTE *buff, BYTE noPlayerNum, bool sentState) {
-  return shellsNetMake(&shs, buff, noPlayerNum, sentState);
+BYTE serverCoreMakeShellData(serverCore sc, BYTE *buff, BYTE noPlayerNum) {
+  BYTE returnValue;         /* Value to return */
+  serverCoreSnapshot *snap; /* Snapshot to build from */
+  int count;                /* Looping variable */
+
+  returnValue = 0;
+  snap = serverCoreGetSnapshot(sc);
+  count = 0;
+  while (count < snap->numShells) {
+    if (snap->shell[count].creator != noPlayerNum && serverCoreSnapshotInView(snap, noPlayerNum, snap->shell[count].mx, snap->shell[count].my) == TRUE) {
+      memcpy(buff, snap->shell[count].data, SHELLS_NET_ITEM_SIZE);
+      buff += SHELLS_NET_ITEM_SIZE;
+      returnValue = (BYTE) (returnValue + SHELLS_NET_ITEM_SIZE);
+    }
+    count++;
+  }
+  return returnValue;
 }
 
 /*********************************************************
 *NAME:          serverCoreMakeMapData
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/10/99
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Makes the map data for a network packet. Returns the
 * packet length
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *********************************************************/
-BYTE serverCoreMakeMapData(BYTE *buff) {
-  return mapNetMakePacket(&mp, buff);
+BYTE serverCoreMakeMapData(serverCore sc, BYTE *buff) {
+  return mapNetMakePacket(&sc->mp, buff);
 }
 
 /*********************************************************
 *NAME:          serverCoreMapIsMine
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED: 31/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns whether a mines exists at a map square
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  bmx - Map X position
 *  bmy - Map X position
 *********************************************************/
-bool serverCoreMapIsMine(BYTE bmx, BYTE bmy) {
-  return mapIsMine(&mp, bmx, bmy);
+bool serverCoreMapIsMine(serverCore sc, BYTE bmx, BYTE bmy) {
+  return mapIsMine(&sc->mp, bmx, bmy);
 }
 
 /*********************************************************
 *NAME:          serverCoreGetTankFromPlayer
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/00
-*LAST MODIFIED: 21/10/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the tank for a specific player num. In a client
 * it always return our own tank
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Tank to get for this player number
 *********************************************************/
-tank* serverCoreGetTankFromPlayer(BYTE playerNum) {
-  return &tk[playerNum];
+tank* serverCoreGetTankFromPlayer(serverCore sc, BYTE playerNum) {
+  return &sc->tk[playerNum];
 }
 
 /*********************************************************
 *NAME:          serverCoreGetTankPlayer
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns this tanks player number
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  value - Pointer to the tank
 *********************************************************/
-BYTE serverCoreGetTankPlayer(tank *value) {
+BYTE serverCoreGetTankPlayer(serverCore sc, tank *value) {
   BYTE returnValue; /* Value to return */
   BYTE count;       /* Looping variable */
   
   returnValue = NEUTRAL;
   count = 0;
   while (returnValue == NEUTRAL && count < MAX_TANKS) {
-    if (*value == tk[count]) {
+    if (*value == sc->tk[count]) {
       returnValue = count;
     }
     count++;
@@ -1046,17 +1790,18 @@ BYTE serverCoreGetTankPlayer(tank *value) {
 }
 
 /*********************************************************
-*NAME:          clientCenterTank
+*NAME:          serverCoreCenterTank
 *AUTHOR:        John Morrison
 *CREATION DATE: 5/11/99
-*LAST MODIFIED: 5/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Centers the screen around the tank.
+*  Centers the screen around the tank. The server has no
+*  screen so this does nothing.
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverCoreCenterTank() {
+void serverCoreCenterTank(serverCore sc) {
   return;
 }
 
@@ -1064,16 +1809,17 @@ void serverCoreCenterTank() {
 *NAME:          severCoreExtractClientMapData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED:  21/9/00
+*LAST MODIFIED:  16/10/26
 *PURPOSE:
 * Extracts the client map data into the map file.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff      - Buffer containing the data
 *  len       - Length of the buffer
 *  playerNum - Player number this data came from
 *********************************************************/
-void severCoreExtractClientMapData(BYTE *buff, BYTE len, BYTE playerNum) {
+void severCoreExtractClientMapData(serverCore sc, BYTE *buff, BYTE len, BYTE playerNum) {
   BYTE pos;     /* Position through the data */
   BYTE mx;      /* Map X position */
   BYTE my;      /* Map Y position */
@@ -1088,7 +1834,7 @@ void severCoreExtractClientMapData(BYTE *buff, BYTE len, BYTE playerNum) {
     pos++;
     terrain = buff[pos];
     pos++;    
-    mapSetPos(&mp, mx, my, terrain, TRUE, FALSE);
+    mapSetPos(&sc->mp, mx, my, terrain, TRUE, FALSE);
   }
 }
 
@@ -1096,111 +1842,116 @@ void severCoreExtractClientMapData(BYTE *buff, BYTE len, BYTE playerNum) {
 *NAME:          serverCoreExtractPNBData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Extracts the netPNB Data
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *  len  - Length of the buffer
 *********************************************************/
-void serverCoreExtractPNBData(BYTE *buff, BYTE len) {
-  netPNBExtract(&serverPNB, &mp, &bs, &pb, buff, len, TRUE);
+void serverCoreExtractPNBData(serverCore sc, BYTE *buff, BYTE len) {
+  netPNBExtract(&sc->serverPNB, &sc->mp, &sc->bs, &sc->pb, buff, len, TRUE);
 }
 
 /*********************************************************
 *NAME:          serverCoreExtractTkExpData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Extracts the tank explosion Data
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *  len  - Length of the buffer
 *********************************************************/
-void serverCoreExtractTkExpData(BYTE *buff, BYTE len) {
-  tkExplosionNetExtract(&serverTankExp, buff, len, NEUTRAL);
+void serverCoreExtractTkExpData(serverCore sc, BYTE *buff, BYTE len) {
+  tkExplosionNetExtract(&sc->serverTankExp, buff, len, NEUTRAL);
 }
 
 /*********************************************************
 *NAME:          serverCoreMakeTkData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Makes the tank explosion Data
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *********************************************************/
-BYTE serverCoreMakeTkData(BYTE *buff) {
-  return tkExplosionNetMake(&serverTankExp, buff);
+BYTE serverCoreMakeTkData(serverCore sc, BYTE *buff) {
+  return tkExplosionNetMake(&sc->serverTankExp, buff);
 }
 
 /*********************************************************
 *NAME:          serverCoreExtractNMTData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Extracts the NMT data.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *  len  - Length of the buffer
 ********************************************************/
-void serverCoreExtractNMTData(BYTE *buff, BYTE len) {
-  netMNTExtract(&serverNMT, &mp, &pb, &bs, NULL, buff, len, FALSE);
+void serverCoreExtractNMTData(serverCore sc, BYTE *buff, BYTE len) {
+  netMNTExtract(&sc->serverNMT, &sc->mp, &sc->pb, &sc->bs, NULL, buff, len, FALSE);
 }
 
 /*********************************************************
 *NAME:          serverCoreNumBases
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/12/98
-*LAST MODIFIED: 21/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns the number of bases
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverCoreNumBases(void) {
-  return basesGetNumBases(&bs);
+BYTE serverCoreNumBases(serverCore sc) {
+  return basesGetNumBases(&sc->bs);
 }
 
 /*********************************************************
 *NAME:          serverCoreNumPills
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/12/98
-*LAST MODIFIED: 21/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns the number of pillboxes
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverCoreNumPills(void) {
-  return pillsGetNumPills(&pb);
+BYTE serverCoreNumPills(serverCore sc) {
+  return pillsGetNumPills(&sc->pb);
 }
 
 /*********************************************************
 *NAME:          serverCoreRequestRejoin
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A player number has requested a rejoin
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Player number requesting join
 ********************************************************/
-void serverCoreRequestRejoin(BYTE playerNum) {
+void serverCoreRequestRejoin(serverCore sc, BYTE playerNum) {
   char playerName[PLAYER_NAME_LEN]; /* Player Name */
 
-  playersGetPlayerName(&splrs, playerNum, playerName);
-  playersRejoinRequest(playerName, playerNum, &pb, &bs);
+  playersGetPlayerName(&sc->splrs, playerNum, playerName);
+  playersRejoinRequest(&sc->rejoin, playerName, playerNum, &sc->pb, &sc->bs);
 }
 
 void serverMessageSetQuietMode(bool modeOn);
@@ -1238,48 +1989,50 @@ void serverCoreServerConsoleMessage(char *msg) {
 }
 
 
-bool serverCoreRunning() {
-  return serverCoreGameRunning;
+bool serverCoreRunning(serverCore sc) {
+  return sc->serverCoreGameRunning;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetLgmFromPlayerNum
 *AUTHOR:        John Morrison
 *CREATION DATE: 23/9/00
-*LAST MODIFIED: 23/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the lgm structure for a particular player number.
 * Always your own for a client.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - the player numbers lgm to get
 *********************************************************/
-lgm *serverCoreGetLgmFromPlayerNum(BYTE playerNum) {
-  return &lgman[playerNum];
+lgm *serverCoreGetLgmFromPlayerNum(serverCore sc, BYTE playerNum) {
+  return &sc->lgman[playerNum];
 }
 
 /*********************************************************
 *NAME:          serverCoreLgmOperation
 *AUTHOR:        John Morrison
 *CREATION DATE: 3/10/00
-*LAST MODIFIED: 3/10/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A client has requested a lgm operataion
 * Always your own for a client.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - the player numbers lgm to get
 *  destX     - X Destination
 *  destY     - Y Destination
 *  operation - Operation to perform
 *********************************************************/
-void serverCoreLgmOperation(BYTE playerNum, BYTE destX, BYTE destY, BYTE operation) {
-  if (tankGetArmour(&tk[playerNum]) <= TANK_FULL_ARMOUR) {
+void serverCoreLgmOperation(serverCore sc, BYTE playerNum, BYTE destX, BYTE destY, BYTE operation) {
+  if (tankGetArmour(&sc->tk[playerNum]) <= TANK_FULL_ARMOUR) {
     /* If not dead */
-    lgmAddRequest(&lgman[playerNum], &mp, &pb,  &bs, &tk[playerNum], destX, destY, operation);
+    lgmAddRequest(&sc->lgman[playerNum], &sc->mp, &sc->pb,  &sc->bs, &sc->tk[playerNum], destX, destY, operation);
   } else {
     /* Failed */
-    serverNetSendManReturnMessge(playerNum, 0, 0, LGM_NO_PILL);
+    serverNetSendManReturnMessge(sc, playerNum, 0, 0, LGM_NO_PILL);
   }     
 }
 
@@ -1287,26 +2040,27 @@ void serverCoreLgmOperation(BYTE playerNum, BYTE destX, BYTE destY, BYTE operati
 *NAME:          serverCoreGetTankWorldFromLgm
 *AUTHOR:        John Morrison
 *CREATION DATE: 28/12/00
-*LAST MODIFIED: 28/12/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Gets the tank world co-ordinates from a lgman object
 * returns own tank co-ordinates in a client game
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  lgmans - Pointer to the lgm structure
 *  x      - Pointer to hold World X Co-ordinates
 *  y      - Pointer to hold World Y Co-ordinates
 *********************************************************/
-void serverCoreGetTankWorldFromLgm(lgm *lgmans, WORLD *x, WORLD *y) {
+void serverCoreGetTankWorldFromLgm(serverCore sc, lgm *lgmans, WORLD *x, WORLD *y) {
   bool found = FALSE; /* Loop guard */
   BYTE count = 0;     /* Loop variant */
 
   *x = 0;
   *y = 0;
   while (count < MAX_TANKS && found == FALSE) {
-    if (lgmans == &lgman[count]) {
+    if (lgmans == &sc->lgman[count]) {
       found = TRUE;
-      tankGetWorld(&tk[count], x, y);
+      tankGetWorld(&sc->tk[count], x, y);
     }
     count++;
   }
@@ -1316,17 +2070,18 @@ void serverCoreGetTankWorldFromLgm(lgm *lgmans, WORLD *x, WORLD *y) {
 *NAME:          serverCoreGetRandStart
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/1/99
-*LAST MODIFIED: 18/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Places a random start position into the parmeters passed
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  mx - Pointer to hold Map X Co-ordinates
 *  my - Pointer to hold Map Y Co-ordinates
 *  dir - Direction facing
 *********************************************************/
-void serverCoreGetRandStart(BYTE *mx, BYTE *my, TURNTYPE *dir) {
-   startsGetRandStart(&ss, mx, my ,dir);
+void serverCoreGetRandStart(serverCore sc, BYTE *mx, BYTE *my, TURNTYPE *dir) {
+   startsGetRandStart(&sc->ss, mx, my ,dir);
   return;
 }
 
@@ -1334,11 +2089,12 @@ void serverCoreGetRandStart(BYTE *mx, BYTE *my, TURNTYPE *dir) {
 *NAME:          serverCoreGetStartPosition
 *AUTHOR:        John Morrison
 *CREATION DATE: 3/10/01
-*LAST MODIFIED: 8/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Client has request a start position.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Player Number to get
 *  xValue    - Pointer to hold X Value
 *  yValue    - Pointer to hold Y Value
@@ -1346,15 +2102,15 @@ void serverCoreGetRandStart(BYTE *mx, BYTE *my, TURNTYPE *dir) {
 *  numShells - Pointer to hold number of shells
 *  numMines  - Pointer to hold number of mines
 *********************************************************/
-void serverCoreGetStartPosition(BYTE playerNum, BYTE *xValue, BYTE *yValue, TURNTYPE *angel, BYTE *numShells, BYTE *numMines) {
+void serverCoreGetStartPosition(serverCore sc, BYTE playerNum, BYTE *xValue, BYTE *yValue, TURNTYPE *angel, BYTE *numShells, BYTE *numMines) {
   BYTE numArmour, numTrees; /* Number of trees */
 
-  startsGetStart(&ss, xValue, yValue, angel, playerNum);
-  gameTypeGetItems(&sGame, numShells, numMines, &numArmour, &numTrees);
-  tankSetWorld(&tk[playerNum], *xValue, *yValue, *angel, FALSE);
-  tankSetStats(&tk[playerNum], *numShells, *numMines, numArmour, numTrees);
-  tankSetOnBoat(&tk[playerNum], TRUE);
-  tankResetHitCount(&tk[playerNum]);
+  startsGetStart(&sc->ss, xValue, yValue, angel, playerNum);
+  gameTypeGetItems(&sc->sGame, numShells, numMines, &numArmour, &numTrees);
+  tankSetWorld(&sc->tk[playerNum], *xValue, *yValue, *angel, FALSE);
+  tankSetStats(&sc->tk[playerNum], *numShells, *numMines, numArmour, numTrees);
+  tankSetOnBoat(&sc->tk[playerNum], TRUE);
+  tankResetHitCount(&sc->tk[playerNum]);
 
 }
 
@@ -1362,18 +2118,19 @@ void serverCoreGetStartPosition(BYTE playerNum, BYTE *xValue, BYTE *yValue, TURN
 *NAME:          serverCoreCheckTankRange
 *AUTHOR:        John Morrison
 *CREATION DATE: 9/04/01
-*LAST MODIFIED: 11/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks to see if there is enemy tank within range
 * supplied. Returns TRUE if we are in the clear
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  xValue    - X Value
 *  yValue    - Y Value
 *  playerNum - Player number to check against
 *  distance  - Distance to be less then to return FALSE
 *********************************************************/
-bool serverCoreCheckTankRange(BYTE x, BYTE y, BYTE playerNum, double distance) {
+bool serverCoreCheckTankRange(serverCore sc, BYTE x, BYTE y, BYTE playerNum, double distance) {
   bool returnValue; /* Value to return */
   BYTE count;       /* Looping Variable */
   WORLD ourWX;
@@ -1388,8 +2145,8 @@ bool serverCoreCheckTankRange(BYTE x, BYTE y, BYTE playerNum, double distance) {
   
   count = 0;
   while (count < MAX_TANKS && returnValue == TRUE) {
-    if (playerNum != count && tk[count] != NULL && count != playerNum) {
-      tankGetWorld(&tk[count], &testWX, &testWY);
+    if (playerNum != count && sc->tk[count] != NULL && count != playerNum) {
+      tankGetWorld(&sc->tk[count], &testWX, &testWY);
       returnValue = !(utilIsItemInRange(ourWX, ourWY, testWX, testWY, (WORLD) distance, &dummy));
     }
     count++;
@@ -1402,18 +2159,19 @@ bool serverCoreCheckTankRange(BYTE x, BYTE y, BYTE playerNum, double distance) {
 *NAME:          serverCoreCheckPillsRange
 *AUTHOR:        John Morrison
 *CREATION DATE: 9/04/01
-*LAST MODIFIED: 9/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks to see if there is enemy pill within range
 * supplied. Returns TRUE if we are in the clear
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  xValue    - X Value
 *  yValue    - Y Value
 *  playerNum - Player number to check against
 *  distance  - Distance to be less then to return true
 *********************************************************/
-bool serverCoreCheckPillsRange(BYTE xValue, BYTE yValue, BYTE playerNum, double distance) {
+bool serverCoreCheckPillsRange(serverCore sc, BYTE xValue, BYTE yValue, BYTE playerNum, double distance) {
   bool returnValue; /* Value to return  */
   BYTE count;       /* Looping variable */
   BYTE total;
@@ -1429,10 +2187,10 @@ bool serverCoreCheckPillsRange(BYTE xValue, BYTE yValue, BYTE playerNum, double
   startX = (xValue << M_W_SHIFT_SIZE) + MAP_SQUARE_MIDDLE;
   startY = (yValue << M_W_SHIFT_SIZE) + MAP_SQUARE_MIDDLE;
   count = 1;
-  total = pillsGetNumPills(&pb);
+  total = pillsGetNumPills(&sc->pb);
   while (returnValue == TRUE && count <= total) {
-    pillsGetPill(&pb, &pill, count);
-    if (playersIsAllie(&splrs, playerNum, pill.owner) == FALSE) {
+    pillsGetPill(&sc->pb, &pill, count);
+    if (playersIsAllie(&sc->splrs, playerNum, pill.owner) == FALSE) {
       testX = (pill.x << M_W_SHIFT_SIZE) + MAP_SQUARE_MIDDLE;
       testY = (pill.y << M_W_SHIFT_SIZE) + MAP_SQUARE_MIDDLE;
       returnValue = !(utilIsItemInRange(startX, startY, testX, testY, (WORLD) distance, &dummy));
@@ -1446,14 +2204,14 @@ bool serverCoreCheckPillsRange(BYTE xValue, BYTE yValue, BYTE playerNum, double
 *NAME:          serverCoreSendTeams
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/02/03
-*LAST MODIFIED: 21/02/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Generates a list of teams and send them to winbolo.net
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverCoreSendTeams() {
+void serverCoreSendTeams(serverCore sc) {
   BYTE count; /* Looping variables */
   BYTE count2;
   BYTE donePlayers[MAX_TANKS]; /* Players we have search through */
@@ -1472,7 +2230,7 @@ void serverCoreSendTeams() {
   count = 0;
   arrayPos = 1;
   while (count < MAX_TANKS) {
-    if (donePlayers[count] == FALSE && tk[count] != NULL) {
+    if (donePlayers[count] == FALSE && sc->tk[count] != NULL) {
       /* This is a new team */
       numTeams++;
       count2 = 0;
@@ -1484,7 +2242,7 @@ void serverCoreSendTeams() {
       arraySize++;
       donePlayers[count] = TRUE;
       while (count2 < MAX_TANKS) {
-        if (count2 != count && tk[count2] != NULL && playersIsAllie(&splrs, count, count2)) {
+        if (count2 != count && sc->tk[count2] != NULL && playersIsAllie(&sc->splrs, count, count2)) {
           donePlayers[count2] = TRUE;
           array[arrayPos] = count2;
           arrayPos++;
@@ -1505,17 +2263,16 @@ void serverCoreSendTeams() {
 *NAME:          serverCoreCheckGameWin
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/04/01
-*LAST MODIFIED: 14/04/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks to see if all the bases are owned by a specific
 * alliance
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  printWinners - If TRUE print out the list of winners
 *********************************************************/
-bool serverCoreCheckGameWin(bool printWinners) {
-  static bool doneOnce = FALSE; /* Have we done this once successfully */
-  static bool doneWbnOnce = FALSE; /* Have we done this once successfully */
+bool serverCoreCheckGameWin(serverCore sc, bool printWinners) {
   bool returnValue; /* Value to return */
   BYTE count;       /* Looping variable */
   BYTE max;         /* Max number of bases */
@@ -1527,39 +2284,39 @@ bool serverCoreCheckGameWin(bool printWinners) {
   BYTE armourAmount;
 
   returnValue = TRUE;
-  max = basesGetNumBases(&bs);
+  max = basesGetNumBases(&sc->bs);
   count = 1;
   while (count <= max && returnValue == TRUE) {
-    current = basesGetBaseOwner(&bs, count);
-    basesGetStats(&bs, count, &shellsAmount, &minesAmount, &armourAmount);
+    current = basesGetBaseOwner(&sc->bs, count);
+    basesGetStats(&sc->bs, count, &shellsAmount, &minesAmount, &armourAmount);
     if (current == NEUTRAL || armourAmount <= MIN_ARMOUR_CAPTURE) {
       returnValue = FALSE;
     } else {
       if (count == 1) {
         first = current;
       } else {
-        returnValue = playersIsAllie(&splrs, current, first);
+        returnValue = playersIsAllie(&sc->splrs, current, first);
       }
     }
     count++;
   }
 
-  if (returnValue == TRUE && doneWbnOnce == FALSE) {
-    serverCoreSendTeams();
+  if (returnValue == TRUE && sc->doneWbnOnce == FALSE) {
+    serverCoreSendTeams(sc);
     /* Tell WinBolo.net about it */
     winbolonetAddEvent(WINBOLO_NET_EVENT_WIN, TRUE, first, WINBOLO_NET_NO_PLAYER);
-    doneWbnOnce = TRUE;
+    sc->doneWbnOnce = TRUE;
   }
 
-  if (returnValue == TRUE && printWinners == TRUE && doneOnce == FALSE) {
-    doneOnce = TRUE;
+  if (returnValue == TRUE && printWinners == TRUE && sc->doneOnce == FALSE) {
+    sc->doneOnce = TRUE;
     serverMessageConsoleMessage("Winners");
     count = 0;
     while (count < MAX_TANKS) {
-      if (tk[count] != NULL) {
-        if (playersIsAllie(&splrs, first, count) == TRUE) {
+      if (sc->tk[count] != NULL) {
+        if (playersIsAllie(&sc->splrs, first, count) == TRUE) {
           /* Print it */
-          playersGetPlayerName(&splrs, count, dest);
+          playersGetPlayerName(&sc->splrs, count, dest);
           serverMessageConsoleMessage(dest);
         }
       }
@@ -1573,25 +2330,24 @@ bool serverCoreCheckGameWin(bool printWinners) {
 *NAME:          serverCoreCheckAutoClose
 *AUTHOR:        John Morrison
 *CREATION DATE: 10/12/03
-*LAST MODIFIED: 10/12/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks if the autoclose server function has completed
 * It has completed if one player has joined and then
 * all players have quit the server
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-bool serverCoreCheckAutoClose() {
-  static bool hadPlayers = FALSE; /* Have we done this once successfully */
+bool serverCoreCheckAutoClose(serverCore sc) {
   bool returnValue = FALSE; /* Value to return */
 
-  if (hadPlayers == FALSE) {
-    if (playersGetNumPlayers(&splrs) > 0) {
-      hadPlayers = TRUE;
+  if (sc->hadPlayers == FALSE) {
+    if (playersGetNumPlayers(&sc->splrs) > 0) {
+      sc->hadPlayers = TRUE;
     }
   } else {
-    if (playersGetNumPlayers(&splrs) == 0) {
+    if (playersGetNumPlayers(&sc->splrs) == 0) {
       returnValue = TRUE;
     }
   }
@@ -1603,34 +2359,51 @@ bool serverCoreCheckAutoClose() {
 *NAME:          serverCoreStartLog
 *AUTHOR:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Starts logging game events to a log file
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  fileName    - Filename to log to
 *  ai          - Games AI type
 *  maxPlayers  - Maximum number of players allowed in the
 *                game
 *  usePassword - Is the game password protected
 *********************************************************/
-bool serverCoreStartLog(char *fileName, BYTE ai, BYTE maxPlayers, bool usePassword) {
-  return logStart(fileName, &mp, &bs, &pb, &ss, &splrs, ai, maxPlayers, usePassword);
+bool serverCoreStartLog(serverCore sc, char *fileName, BYTE ai, BYTE maxPlayers, bool usePassword) {
+  return logStart(sc->serverLog, fileName, &sc->mp, &sc->bs, &sc->pb, &sc->ss, &sc->splrs, ai, maxPlayers, usePassword);
 }
 
 /*********************************************************
 *NAME:          serverCoreStopLog
 *AUTHOR:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 05/05/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Stops logging
 *
 *ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+void serverCoreStopLog(serverCore sc) {
+  logStop(sc->serverLog);
+}
+
+/*********************************************************
+*NAME:          serverCoreGetLogWriterStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the counters of the game's log writer
 *
+*ARGUMENTS:
+*  sc    - Game to use
+*  stats - Structure to fill in
 *********************************************************/
-void serverCoreStopLog() {
-  logStop();
+void serverCoreGetLogWriterStats(serverCore sc, logWriterStats *stats) {
+  logGetWriterStats(sc->serverLog, stats);
 }
 
 /*********************************************************
@@ -1653,258 +2426,320 @@ void serverCoreSetServerLogFile(char *logFile) {
 *NAME:          serverCoreSaveMap
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/02/03
-*LAST MODIFIED: 01/03/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Saves the map file to fileName and returns success
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  fileName - File to write to
 *********************************************************/
-bool serverCoreSaveMap(char *fileName) {
-  serverNetSendServerMessageAllPlayers("Server Admin saved map file.");
-  return mapWrite(fileName, &mp, &pb, &bs, &ss);
+bool serverCoreSaveMap(serverCore sc, char *fileName) {
+  serverNetSendServerMessageAllPlayers(sc, "Server Admin saved map file.");
+  return mapWrite(fileName, &sc->mp, &sc->pb, &sc->bs, &sc->ss);
 }
 
 /*********************************************************
 *NAME:          serverCoreGetPlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/02/03
-*LAST MODIFIED: 01/03/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the players object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-players *serverCoreGetPlayers() {
-  return &splrs;
+players *serverCoreGetPlayers(serverCore sc) {
+  return &sc->splrs;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetBuildings
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the buildings Object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-building *serverCoreGetBuildings() {
-  return &serverBlds;
+building *serverCoreGetBuildings(serverCore sc) {
+  return &sc->serverTileLife;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetExplosions
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the explosions Object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-explosions *serverCoreGetExplosions() {
-  return &serverExpl;
+explosions *serverCoreGetExplosions(serverCore sc) {
+  return &sc->serverExpl;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetFloodFill
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the floodfill object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-floodFill *serverCoreGetFloodFill() {
-  return &serverFF;
+floodFill *serverCoreGetFloodFill(serverCore sc) {
+  return &sc->serverFF;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetGrass
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the grass object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-grass *serverCoreGetGrass() {
-  return &serverGrass;
+grass *serverCoreGetGrass(serverCore sc) {
+  return &sc->serverTileLife;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetMines
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the mines object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-mines *serverCoreGetMines() {
-  return &serverMines;
+mines *serverCoreGetMines(serverCore sc) {
+  return &sc->serverMines;
 }
 
 /*********************************************************
 *NAME:          serverGetMinesExp
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the mines explosion object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-minesExp *serverGetMinesExp() {
-  return &serverMinesExp;
+minesExp *serverGetMinesExp(serverCore sc) {
+  return &sc->serverMinesExp;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetRubble
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the rubble object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-rubble *serverCoreGetRubble() {
-  return &serverRubble;
+rubble *serverCoreGetRubble(serverCore sc) {
+  return &sc->serverTileLife;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetSwamp
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the swamp object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-swamp *serverCoreGetSwamp() {
-  return &serverSwamp;
+swamp *serverCoreGetSwamp(serverCore sc) {
+  return &sc->serverTileLife;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetTankExplosions
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the tank explosions object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-tkExplosion  *serverCoreGetTankExplosions() {
-  return &serverTankExp;
+tkExplosion  *serverCoreGetTankExplosions(serverCore sc) {
+  return &sc->serverTankExp;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetNetPnb
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the Pnb Object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-netPnbContext *serverCoreGetNetPnb() {
-  return &serverPNB;
+netPnbContext *serverCoreGetNetPnb(serverCore sc) {
+  return &sc->serverPNB;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetNetMnt
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the Pnb Object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-netMntContext *serverCoreGetNetMnt() {
-  return &serverNMT;
+netMntContext *serverCoreGetNetMnt(serverCore sc) {
+  return &sc->serverNMT;
 }
 
 /*********************************************************
 *NAME:          serverCoreGetGameType
 *AUTHOR:        John Morrison
 *CREATION DATE: 17/12/03
-*LAST MODIFIED: 17/12/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the game type
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-gameType *serverCoreGetGameType() {
-  return &sGame;
+gameType *serverCoreGetGameType(serverCore sc) {
+  return &sc->sGame;
 }
 
 /*********************************************************
 *NAME:          serverCoreInformation
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/11/03
-*LAST MODIFIED: 19/11/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Prints out the server information to stdout
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverCoreInformation() {
+void serverCoreInformation(serverCore sc) {
   BYTE count; /* Looping variable */
   BYTE numPlayers; /* Number of players in the game */
   BYTE maxPlayers;
   char name[255];
   char location[255];
 
-  numPlayers = playersGetNumPlayers(&splrs);
-  maxPlayers = serverNetGetMaxPlayers();
+  numPlayers = playersGetNumPlayers(&sc->splrs);
+  maxPlayers = serverNetGetMaxPlayers(sc);
   if (maxPlayers == 0) {
     maxPlayers = MAX_TANKS;
   }
   fprintf(stdout, "\n");
   fprintf(stdout, BOLO_VERSION_STRING);
-  fprintf(stdout, "\nGame start time: %sMap Name: %s - Locked: ", asctime(gmtime(&sTimeStart)), sMapName);
-  if (serverNetGetIsLocked() == TRUE) {
+  fprintf(stdout, "\nGame start time: %sMap Name: %s - Locked: ", asctime(gmtime(&sc->sTimeStart)), sc->sMapName);
+  if (serverNetGetIsLocked(sc) == TRUE) {
     fprintf(stdout, "Yes");
   } else {
     fprintf(stdout, "No");
   }
-  fprintf(stdout, "\nPlayers: (%d/%d) Neutral Pillboxes: (%d/%d), Neutral Bases: (%d/%d)\n\n", numPlayers, maxPlayers, pillsGetNumNeutral(&pb), pillsGetNumPills(&pb), basesGetNumNeutral(&bs), basesGetNumBases(&bs));
+  fprintf(stdout, "\nPlayers: (%d/%d) Neutral Pillboxes: (%d/%d), Neutral Bases: (%d/%d)\n\n", numPlayers, maxPlayers, pillsGetNumNeutral(&sc->pb), pillsGetNumPills(&sc->pb), basesGetNumNeutral(&sc->bs), basesGetNumBases(&sc->bs));
   
   if (numPlayers > 0) {
     fprintf(stdout, "Players:\n");
     
     count = 0;
     while (count < MAX_TANKS) {
-      if (playersIsInUse(&splrs, count) == TRUE) {
-        playersGetPlayerName(&splrs, count, name);
-        playersGetPlayerLocation(&splrs, count, location);
-        fprintf(stderr, "%s@%s - (P:%d B: %d)\n", name, location, pillsGetNumberOwnedByPlayer(&pb, count), basesGetNumberOwnedByPlayer(&bs, count));
+      if (playersIsInUse(&sc->splrs, count) == TRUE) {
+        playersGetPlayerName(&sc->splrs, count, name);
+        playersGetPlayerLocation(&sc->splrs, count, location);
+        fprintf(stderr, "%s@%s - (P:%d B: %d)\n", name, location, pillsGetNumberOwnedByPlayer(&sc->pb, count), basesGetNumberOwnedByPlayer(&sc->bs, count));
       }
       count++;
     }
   }
 }
 
+#ifdef BOLO_PROFILE
+/*********************************************************
+*NAME:          serverCoreProfileReset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Clears the game tick section timings and view matrix
+*  counters
+*
+*ARGUMENTS:
+*
+*********************************************************/
+void serverCoreProfileReset(void) {
+  memset(serverCoreProfile, 0, sizeof(serverCoreProfile));
+  serverCoreProfileTicks = 0;
+  serverCoreViewLookups = 0;
+  serverCoreViewPillChecks = 0;
+  serverCoreViewPairChecks = 0;
+}
+
+/*********************************************************
+*NAME:          serverCoreProfileGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Copies the total nanoseconds spent in each section of
+*  the game tick since the last reset into ns. Returns the
+*  number of game ticks profiled.
+*
+*ARGUMENTS:
+*  ns - Array of profileNumItems to hold the timings
+*********************************************************/
+unsigned long serverCoreProfileGet(unsigned long long *ns) {
+  memcpy(ns, serverCoreProfile, sizeof(serverCoreProfile));
+  return serverCoreProfileTicks;
+}
+
+/*********************************************************
+*NAME:          serverCoreViewProfileGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the view matrix counters since the last reset
+*
+*ARGUMENTS:
+*  lookups    - Views answered from the matrix when
+*               building position packets
+*  pillChecks - Pill range checks made building the
+*               matrix
+*  pairChecks - Pill range checks a scan for every
+*               lookup would have made
+*********************************************************/
+void serverCoreViewProfileGet(unsigned long long *lookups, unsigned long long *pillChecks, unsigned long long *pairChecks) {
+  *lookups = serverCoreViewLookups;
+  *pillChecks = serverCoreViewPillChecks;
+  *pairChecks = serverCoreViewPairChecks;
+}
+#endif
@@ -20,7 +20,7 @@
 *Filename:      serverCore.h
 *Author:        John Morrison
 *Creation Date: 10/08/99
-*Last Modified: 27/07/04
+*Last Modified: 16/10/26
 *Purpose:
 *  WinBolo Server Core Simulation modelling.
 *********************************************************/
@@ -28,6 +28,7 @@
 #ifndef SERVER_CORE_H
 #define SERVER_CORE_H
 
+#include <time.h>
 #include "../bolo/global.h"
 #include "../bolo/gametype.h"
 #include "../bolo/screen.h"
@@ -44,14 +45,200 @@
 #include "../bolo/netpnb.h"
 #include "../bolo/netmt.h"
 #include "../bolo/gametype.h"
+#include "../bolo/bolo_map.h"
+#include "../bolo/pillbox.h"
+#include "../bolo/bases.h"
+#include "../bolo/starts.h"
+#include "../bolo/tank.h"
+#include "../bolo/shells.h"
+#include "../bolo/players.h"
+#include "../bolo/netpacks.h"
+#include "../bolo/posdelta.h"
+#include "../bolo/mapruncache.h"
+#include "../bolo/screenarena.h"
+#include "../bolo/log.h"
+#include "../bolo/playersrejoin.h"
+#include "threads.h"
+
+/* Size of a players cached position packet data */
+#define SERVER_CORE_POS_DATA_SIZE 50
+
+/* Cached player position data for building position packets */
+typedef struct {
+  BYTE buff[SERVER_CORE_POS_DATA_SIZE];
+  bool lgmOut;
+  int len;
+  BYTE tankMX;    /* Tank map position */
+  BYTE tankMY;
+  BYTE lgmMX;     /* Lgm map position */
+  BYTE lgmMY;
+  BYTE forceView; /* Player sent this tank whatever the range or NEUTRAL */
+} posData;
+
+#if MAX_TANKS > 16 || MAX_PILLS > 16
+#error Snapshot view masks must have a bit for every tank and pill
+#endif
+
+/* World state copied out under the mutex at the end of a
+   game step. Packets are then built from it without holding
+   the mutex. Only the sections taken this step are valid */
+typedef struct {
+  unsigned long seq;                     /* Publish number */
+  bool hasPos;                           /* Was position data taken */
+  bool hasData;                          /* Was map and event data taken */
+  bool inUse[MAX_TANKS];                 /* Players in the game */
+  BYTE posAck[MAX_TANKS];                /* Last position frame each player acknowledged */
+  BYTE posJoin[MAX_TANKS];               /* Times each player slot has been joined */
+  posData player[MAX_TANKS];             /* Player positions */
+  BYTE numPills;                         /* Pillboxes and who they give a view to */
+  BYTE pillX[MAX_PILLS];
+  BYTE pillY[MAX_PILLS];
+  unsigned short pillAllies[MAX_PILLS];  /* Bit per player allied to the owner */
+  unsigned short tankView[MAX_TANKS];    /* Bit per tank each player can see */
+  unsigned short lgmView[MAX_TANKS];     /* Bit per lgm each player can see */
+  int numShells;                         /* Shells not sent before */
+  shellsNetItem shell[MAX_SHELLS];
+  BYTE mapLen;                           /* Map, tank explosion, pillbox/base */
+  BYTE tkLen;                            /* and mine/terrain net data */
+  BYTE pnbLen;
+  BYTE mntLen;
+  BYTE mapData[MAX_UDPPACKET_SIZE];
+  BYTE tkData[MAX_UDPPACKET_SIZE];
+  BYTE pnbData[MAX_UDPPACKET_SIZE];
+  BYTE mntData[MAX_UDPPACKET_SIZE];
+} serverCoreSnapshot;
+
+/* A single game hosted by the server core. Every serverCore*
+   function is passed the game it operates on */
+typedef struct serverCoreObj *serverCore;
+struct serverCoreObj {
+  threadsMutex mutex;          /* Held while the game is worked on */
+  struct serverNetObj *net;    /* Network side of the game */
+  struct serverTransportObj *transport; /* Socket the game is served on */
+  map mp;                      /* Game map */
+  bases bs;                    /* Bases */
+  pillboxes pb;                /* Pillboxes */
+  starts ss;                   /* Start positions */
+  tank tk[MAX_TANKS];          /* Players tanks */
+  lgm lgman[MAX_TANKS];        /* Players lgms */
+  shells shs;                  /* Shells in flight */
+  players splrs;               /* Players in the game */
+  explosions serverExpl;       /* Explosions */
+  BYTE explTime;               /* Ticks since explosions were updated */
+  floodFill serverFF;          /* Flood fills */
+  mines serverMines;           /* Mines */
+  minesExp serverMinesExp;     /* Mine explosions */
+  tileLife serverTileLife;     /* Damaged buildings, grass, rubble and swamp */
+  tkExplosion serverTankExp;   /* Tank explosions */
+  BYTE tankExpTime;            /* Ticks since tank explosions were updated */
+  netPnbContext serverPNB;     /* Pending pillbox and base events */
+  netMntContext serverNMT;     /* Pending mine and terrain events */
+  playersRejoin rejoin;        /* Players who left and may rejoin */
+  gameType sGame;              /* Game type */
+  char sMapName[MAP_STR_SIZE]; /* Map name */
+  int sGmeStartDelay;          /* Game start delay */
+  long sGmeLength;             /* Game length */
+  time_t sTimeStart;           /* Time game was created */
+  bool serverCoreGameRunning;  /* Are we running? */
+  int tickCount;               /* Ticks since the last log snapshot */
+  bool doneOnce;               /* Game win printed */
+  bool doneWbnOnce;            /* Game win sent to WinBolo.net */
+  bool hadPlayers;             /* Has a player ever joined */
+  serverCoreSnapshot snap[2];  /* Published and next packet snapshots */
+  volatile int snapFront;      /* Which snapshot is published */
+  unsigned long snapSeq;       /* Snapshots published */
+  BYTE posAck[MAX_TANKS];      /* Last position frame each player acknowledged */
+  BYTE posJoin[MAX_TANKS];     /* Times each player slot has been joined */
+  posDelta posHistory[MAX_TANKS]; /* Frames sent to each player */
+  BYTE posHistoryJoin[MAX_TANKS]; /* posJoin each history was reset at */
+  mapRunCache runCache;        /* Compressed map runs for joining players */
+  screenArena logArena;        /* Lists built each logged tick */
+  logContext serverLog;        /* Game log */
+};
+
+#ifdef BOLO_PROFILE
+/* Sections of the game tick timed when built with BOLO_PROFILE */
+typedef enum {
+  profilePills,
+  profileBases,
+  profileTanks,
+  profileLgms,
+  profileTankExp,
+  profileShells,
+  profileExplosions,
+  profileMinesExp,
+  profileFlood,
+  profileLog,
+  profileSnapshot,
+  profileNumItems
+} serverCoreProfileItem;
+#endif
+
+/*********************************************************
+*NAME:          serverCoreSetContext
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Sets the game the calling thread is working on. The
+*  backend reaches the game through it when the engine
+*  calls back. serverCoreCreate and serverCoreLock set it
+*  so a thread only needs to call this when it works on a
+*  game without locking it
+*
+*ARGUMENTS:
+*  value - Game the thread is working on
+*********************************************************/
+void serverCoreSetContext(serverCore value);
+
+/*********************************************************
+*NAME:          serverCoreGetContext
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the game the calling thread is working on
+*
+*ARGUMENTS:
+*
+*********************************************************/
+serverCore serverCoreGetContext(void);
+
+/*********************************************************
+*NAME:          serverCoreLock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Waits till the game's mutex is acquired and makes it
+*  the game the calling thread is working on
+*
+*ARGUMENTS:
+*  sc - Game to lock
+*********************************************************/
+void serverCoreLock(serverCore sc);
+
+/*********************************************************
+*NAME:          serverCoreUnlock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Releases the game's mutex
+*
+*ARGUMENTS:
+*  sc - Game to unlock
+*********************************************************/
+void serverCoreUnlock(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 10/8/99
-*LAST MODIFIED:  5/5/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Creates a new server. Returns FALSE if an error occured
+*  Creates a new game and makes it the game the calling
+*  thread is working on. Returns NULL if an error occured
 *  such as error loading map
 *
 *ARGUMENTS:
@@ -62,16 +249,17 @@
 *  gmeLen      - Length of the game (in 50ths) 
 *                (-1 =unlimited)
 *********************************************************/
-bool serverCoreCreate(char *fileName, gameType game, bool hiddenMines, int srtDelay, long gmeLen);
+serverCore serverCoreCreate(char *fileName, gameType game, bool hiddenMines, int srtDelay, long gmeLen);
 
 /*********************************************************
 *NAME:          serverCoreCreateCompressed
 *AUTHOR:        John Morrison
 *CREATION DATE: 10/8/99
-*LAST MODIFIED: 5/05/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Creates a new server via loading a compressed map
-*  structure. Returns FALSE if an error occured such as 
+*  Creates a new game via loading a compressed map
+*  structure and makes it the game the calling thread is
+*  working on. Returns NULL if an error occured such as 
 *  error loading map
 *
 *ARGUMENTS:
@@ -85,482 +273,667 @@ bool serverCoreCreate(char *fileName, gameType game, bool hiddenMines, int srtDe
 *  gmeLen      - Length of the game (in 50ths) 
 *                (-1 =unlimited)
 *********************************************************/
-bool serverCoreCreateCompressed(BYTE *buff, int buffLen, char *mapn, gameType game, bool hiddenMines, int srtDelay, long gmeLen);
+serverCore serverCoreCreateCompressed(BYTE *buff, int buffLen, char *mapn, gameType game, bool hiddenMines, int srtDelay, long gmeLen);
 
 /*********************************************************
 *NAME:          serverDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 10/8/99
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Shuts down the server.
+*  Shuts down a game and frees it.
 *
 *ARGUMENTS:
-*
+*  value - Pointer to the game
 *********************************************************/
-void serverCoreDestroy();
+void serverCoreDestroy(serverCore *value);
 
 /*********************************************************
 *NAME:          serverCoreGameTick
 *AUTHOR:        John Morrison
 *CREATION DATE: 10/8/99
-*LAST MODIFIED: 3/10/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Called once every game tick to update the game world
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  fileName - Points to the map file
 *********************************************************/
-void serverCoreGameTick();
+void serverCoreGameTick(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetTimeGameCreated
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99*PURPOSE:
+*LAST MODIFIED: 16/10/26*PURPOSE:
 * Returns the time the game was created
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-long serverCoreGetTimeGameCreated(void);
+long serverCoreGetTimeGameCreated(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreSetTimeGameCreated
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets the time the game was created
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  value - Time to set it to
 *********************************************************/
-void serverCoreSetTimeGameCreated(long value);
+void serverCoreSetTimeGameCreated(serverCore sc, long value);
 
 /*********************************************************
 *NAME:          serverCoreGetMapName
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * The front end wants to know what the map name is.
 * Make a copy for it.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  value - Place to hold copy of the map name
 *********************************************************/
-void serverCoreGetMapName(char *value);
+void serverCoreGetMapName(serverCore sc, char *value);
 
 /*********************************************************
 *NAME:          serverCoreGetAllowHiddenMines
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns whether hidden mines are allowed in the game
 * or not
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-bool serverCoreGetAllowHiddenMines();
+bool serverCoreGetAllowHiddenMines(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetGameStartDelay
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the time remaining to start the current game
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-long serverCoreGetGameStartDelay();
+long serverCoreGetGameStartDelay(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetGameTimeLeft
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the time remaining the current game
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-long serverCoreGetGameTimeLeft();
+long serverCoreGetGameTimeLeft(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetNumPlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the number of players in the game
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverCoreGetNumPlayers();
+BYTE serverCoreGetNumPlayers(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetNumNeutralPills
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the number of neutral pills
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverCoreGetNumNeutralPills(void);
+BYTE serverCoreGetNumNeutralPills(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetNumNeutralBases
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the number of neutral bases
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverCoreGetNumNeutralBases(void);
+BYTE serverCoreGetNumNeutralBases(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetBaseNetData
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 27/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Request for base data has been made.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer to hold copy of base data
 *********************************************************/
-BYTE serverCoreGetBaseNetData(BYTE *buff);
+BYTE serverCoreGetBaseNetData(serverCore sc, BYTE *buff);
 
 /*********************************************************
 *NAME:          serverCoreGetPillNetData
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 27/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Request for pill data has been made.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer to hold copy of pill data
 *********************************************************/
-BYTE serverCoreGetPillNetData(BYTE *buff);
+BYTE serverCoreGetPillNetData(serverCore sc, BYTE *buff);
 
 /*********************************************************
 *NAME:          serverCoreGetStartsNetData
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 27/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Request for starts data has been made.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer to hold copy of starts data
 *********************************************************/
-BYTE serverCoreGetStartsNetData(BYTE *buff);
+BYTE serverCoreGetStartsNetData(serverCore sc, BYTE *buff);
 
 /*********************************************************
 *NAME:          serverCoreMakeMapNetRun
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/8/99
-*LAST MODIFIED:  7/1/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Makes the map net run data. Returns data length
+* Makes the map net run data from the run cache. Returns
+* data length
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer to hold data
 *  yPos - Y position of the run
 *********************************************************/
-int serverCoreMakeMapNetRun(BYTE *buff, BYTE yPos);
+int serverCoreMakeMapNetRun(serverCore sc, BYTE *buff, BYTE yPos);
+
+/*********************************************************
+*NAME:          serverCoreGetMapNetRun
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies the cached map net run at yPos into buff and
+* returns its length. If it isn't cached the rows are
+* copied into rows and MAP_RUN_CACHE_MISS is returned.
+* The caller can then unlock, make the run with
+* mapRunCacheEncode, lock and pass it to
+* serverCorePutMapNetRun
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  buff    - Buffer to hold data
+*  yPos    - Y position of the run
+*  rows    - Buffer of MAP_NET_RUN_SIZE to hold the rows
+*  version - Set to the run version on a miss
+*********************************************************/
+int serverCoreGetMapNetRun(serverCore sc, BYTE *buff, BYTE yPos, BYTE *rows, unsigned long *version);
+
+/*********************************************************
+*NAME:          serverCorePutMapNetRun
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Caches a map net run made after serverCoreGetMapNetRun
+* missed, unless the map has changed under it
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  buff    - The run
+*  yPos    - Y position of the run
+*  len     - Length of the run
+*  version - Version from serverCoreGetMapNetRun
+*********************************************************/
+void serverCorePutMapNetRun(serverCore sc, BYTE *buff, BYTE yPos, int len, unsigned long version);
+
+/*********************************************************
+*NAME:          serverCoreGetMapNetStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the size of the map's pending change pool and how
+* many changes were dropped because it could not grow
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  poolSize - Items in the pool
+*  lost     - Changes dropped
+*********************************************************/
+void serverCoreGetMapNetStats(serverCore sc, unsigned long *poolSize, unsigned long *lost);
+
+/*********************************************************
+*NAME:          serverCoreGetJoinData
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Copies the starts, bases, pills and map a joining player
+* downloads into buff uncompressed. It is packed with
+* netJoinPack once the game mutex has been let go. buff
+* must hold NET_JOIN_RAW_SIZE bytes. Returns the length
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  buff - Buffer to hold data
+*********************************************************/
+int serverCoreGetJoinData(serverCore sc, BYTE *buff);
 
 /*********************************************************
 *NAME:          serverCorePlayerJoin
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A new player has joined the game
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Player number of th new player
 *********************************************************/
-void serverCorePlayerJoin(BYTE playerNum);
+void serverCorePlayerJoin(serverCore sc, BYTE playerNum);
 
 /*********************************************************
 *NAME:          serverCorePlayerLeave
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A player has left the game
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Player number of th new player
 *********************************************************/
-void serverCorePlayerLeave(BYTE playerNum);
+void serverCorePlayerLeave(serverCore sc, BYTE playerNum);
 
 /*********************************************************
 *NAME:          serverCoreSetPosData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED: 31/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Process a player pos packet
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Data Buffer
 *********************************************************/
-void serverCoreSetPosData(BYTE *buff);
+void serverCoreSetPosData(serverCore sc, BYTE *buff);
 
 /*********************************************************
 *NAME:          serverCoreTankInView
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED:  8/9/00
+*LAST MODIFIED:  16/10/26
 *PURPOSE:
 * Returns if the item at checkX, checkY is in viewing
 * range of playre playerNum and any of its pillboxes
 *
 *ARGUMENTS:
+*  sc - Game to use
 * playerNum - PlayerNum to check
 * checkX    - X Position to check
 * checkY    - Y Position to check
 *********************************************************/
-bool serverCoreTankInView(BYTE playerNum, BYTE checkX, BYTE checkY);
+bool serverCoreTankInView(serverCore sc, BYTE playerNum, BYTE checkX, BYTE checkY);
 
 /*********************************************************
-*NAME:          serverCorePreparePosPackets
+*NAME:          serverCoreCenterTank
 *AUTHOR:        John Morrison
-*CREATION DATE: 31/8/99
-*LAST MODIFIED:  8/9/00
+*CREATION DATE: 5/11/99
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Centers the screen around the tank. The server has no
+*  screen so this does nothing.
+*
+*ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+void serverCoreCenterTank(serverCore sc);
+
+/*********************************************************
+*NAME:          serverCorePublishSnapshot
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Fills the unpublished snapshot from the game and then
+* publishes it. Shells, map, tank explosion, pillbox/base
+* and mine/terrain data taken are marked as sent. Must be
+* called holding the mutex.
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  wantPos  - Take position and shell data
+*  wantData - Take map and event data
+*********************************************************/
+void serverCorePublishSnapshot(serverCore sc, bool wantPos, bool wantData);
+
+/*********************************************************
+*NAME:          serverCoreGetSnapshot
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Prepares the player pos data in the array
+* Returns the last published snapshot. It is not changed
+* until the snapshot after next is published.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *********************************************************/
-void serverCorePreparePosPackets();
+serverCoreSnapshot *serverCoreGetSnapshot(serverCore sc);
+
+/*********************************************************
+*NAME:          serverCoreMakePosFrame
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Fills frame with the tanks and lgms player playerNum
+* can see in the published snapshot
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  frame     - Frame to fill
+*  playerNum - Player looking
+*********************************************************/
+void serverCoreMakePosFrame(serverCore sc, posDeltaFrame *frame, BYTE playerNum);
 
 /*********************************************************
 *NAME:          serverCoreMakePosPackets
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED: 30/7/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Makes a position packet for all players in the game.
-* Returns packet length
+* Makes the original full position data for a frame.
+* Every visible tank and lgm is sent each time. No longer
+* sent by the server but kept to compare against
+* serverCoreMakePosDelta. Returns packet length
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff      - Data Buffer of packet
+*  frame     - Frame made by serverCoreMakePosFrame
 *  noPlayer  - Player not to make data for
 *  sendStale - TRUE if we want to send out stale values
 *              aswell
 *********************************************************/
-int serverCoreMakePosPackets(BYTE *buff, BYTE noPlayer, bool sendStale);
+int serverCoreMakePosPackets(serverCore sc, BYTE *buff, posDeltaFrame *frame, BYTE noPlayer, bool sendStale);
+
+/*********************************************************
+*NAME:          serverCoreMakePosDelta
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Makes the position data for a frame as a delta from the
+* last frame player playerNum acknowledged. Returns the
+* data length, 0 if there is nothing to send
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  buff      - Data Buffer of packet
+*  frame     - Frame made by serverCoreMakePosFrame
+*  playerNum - Player the packet is for
+*********************************************************/
+int serverCoreMakePosDelta(serverCore sc, BYTE *buff, posDeltaFrame *frame, BYTE playerNum);
+
+/*********************************************************
+*NAME:          serverCoreSetPosAck
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* A player has acknowledged a position frame. Deltas made
+* after the next snapshot are from it. Must be called
+* holding the mutex.
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  playerNum - Player number
+*  seq       - Frame sequence number acknowledged
+*********************************************************/
+void serverCoreSetPosAck(serverCore sc, BYTE playerNum, BYTE seq);
 
 /*********************************************************
 *NAME:          serverCoreExtractShellData
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/10/99
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Extracts the shell data from a network packet
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *  len  - Length of the buffer
 *********************************************************/
-void serverCoreExtractShellData(BYTE *buff, BYTE len);
+void serverCoreExtractShellData(serverCore sc, BYTE *buff, BYTE len);
 
 /*********************************************************
 *NAME:          serverCoreMakeShellData
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/10/99
-*LAST MODIFIED:  8/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Makes the shell data for a network packet. Returns the
-* packet length
+* Makes the shell data for a network packet from the
+* published snapshot. Returns the packet length
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff        - Buffer containing the data
 *  noPlayerNum - Player not to make data for
-*  sentState   - What to set the shell sent state to
 *********************************************************/
-BYTE serverCoreMakeShellData(BYTE *buff, BYTE noPlayerNum, bool sentState);
+BYTE serverCoreMakeShellData(serverCore sc, BYTE *buff, BYTE noPlayerNum);
 
 /*********************************************************
 *NAME:          serverCoreMakeMapData
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/10/99
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Makes the map data for a network packet. Returns the
 * packet length
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *********************************************************/
-BYTE serverCoreMakeMapData(BYTE *buff);
+BYTE serverCoreMakeMapData(serverCore sc, BYTE *buff);
 
 /*********************************************************
 *NAME:          serverCoreMapIsMine
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED: 31/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns whether a mines exists at a map square
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  bmx - Map X position
 *  bmy - Map X position
 *********************************************************/
-bool serverCoreMapIsMine(BYTE bmx, BYTE bmy);
+bool serverCoreMapIsMine(serverCore sc, BYTE bmx, BYTE bmy);
 
 /*********************************************************
 *NAME:          serverCoreGetTankFromPlayer
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/10/00
-*LAST MODIFIED: 21/10/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the tank for a specific player num. In a client
 * it always return our own tank
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Tank to get for this player number
 *********************************************************/
-tank* serverCoreGetTankFromPlayer(BYTE playerNum);
+tank* serverCoreGetTankFromPlayer(serverCore sc, BYTE playerNum);
 
 /*********************************************************
 *NAME:          serverCoreGetTankPlayer
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns this tanks player number
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  value - Pointer to the tank
 *********************************************************/
-BYTE serverCoreGetTankPlayer(tank *value);
+BYTE serverCoreGetTankPlayer(serverCore sc, tank *value);
 
 /*********************************************************
 *NAME:          severCoreExtractClientMapData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED:  21/9/00
+*LAST MODIFIED:  16/10/26
 *PURPOSE:
 * Extracts the client map data into the map file.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff      - Buffer containing the data
 *  len       - Length of the buffer
 *  playerNum - Player number this data came from
 *********************************************************/
-void severCoreExtractClientMapData(BYTE *buff, BYTE len, BYTE playerNum);
+void severCoreExtractClientMapData(serverCore sc, BYTE *buff, BYTE len, BYTE playerNum);
 
 /*********************************************************
 *NAME:          serverCoreExtractPNBData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Extracts the netPNB Data
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *  len  - Length of the buffer
 *********************************************************/
-void serverCoreExtractPNBData(BYTE *buff, BYTE len);
+void serverCoreExtractPNBData(serverCore sc, BYTE *buff, BYTE len);
 
 /*********************************************************
 *NAME:          serverCoreExtractTkExpData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Extracts the tank explosion Data
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *  len  - Length of the buffer
 *********************************************************/
-void serverCoreExtractTkExpData(BYTE *buff, BYTE len);
+void serverCoreExtractTkExpData(serverCore sc, BYTE *buff, BYTE len);
 
 /*********************************************************
 *NAME:          serverCoreMakeTkData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Makes the tank explosion Data
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *********************************************************/
-BYTE serverCoreMakeTkData(BYTE *buff);
+BYTE serverCoreMakeTkData(serverCore sc, BYTE *buff);
 
 /*********************************************************
 *NAME:          serverCoreExtractNMTData
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/10/99
-*LAST MODIFIED: 31/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Extracts the NMT data.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer containing the data
 *  len  - Length of the buffer
 ********************************************************/
-void serverCoreExtractNMTData(BYTE *buff, BYTE len);
+void serverCoreExtractNMTData(serverCore sc, BYTE *buff, BYTE len);
 
 /*********************************************************
 *NAME:          serverCoreNumBases
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/12/98
-*LAST MODIFIED: 21/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns the number of bases
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverCoreNumBases(void);
+BYTE serverCoreNumBases(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreNumPills
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/12/98
-*LAST MODIFIED: 21/12/98
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns the number of pillboxes
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverCoreNumPills(void);
+BYTE serverCoreNumPills(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreRequestRejoin
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/6/00
-*LAST MODIFIED: 22/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A player number has requested a rejoin
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Player number requesting join
 ********************************************************/
-void serverCoreRequestRejoin(BYTE playerNum);
+void serverCoreRequestRejoin(serverCore sc, BYTE playerNum);
 
 /*********************************************************
 *NAME:          serverCoreSetQuietMode
@@ -605,79 +978,84 @@ void screenServerConsoleMessage(char *msg);
 void serverCoreServerConsoleMessage(char *msg);
 
 
-bool serverCoreRunning();
+bool serverCoreRunning(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetLgmFromPlayerNum
 *AUTHOR:        John Morrison
 *CREATION DATE: 23/9/00
-*LAST MODIFIED: 23/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the lgm structure for a particular player number.
 * Always your own for a client.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - the player numbers lgm to get
 *********************************************************/
-lgm *serverCoreGetLgmFromPlayerNum(BYTE playerNum);
+lgm *serverCoreGetLgmFromPlayerNum(serverCore sc, BYTE playerNum);
 
 /*********************************************************
 *NAME:          serverCoreLgmOperation
 *AUTHOR:        John Morrison
 *CREATION DATE: 3/10/00
-*LAST MODIFIED: 3/10/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A client has requested a lgm operataion
 * Always your own for a client.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - the player numbers lgm to get
 *  destX     - X Destination
 *  destY     - Y Destination
 *  operation - Operation to perform
 *********************************************************/
-void serverCoreLgmOperation(BYTE playerNum, BYTE destX, BYTE destY, BYTE operation);
+void serverCoreLgmOperation(serverCore sc, BYTE playerNum, BYTE destX, BYTE destY, BYTE operation);
 
 /*********************************************************
 *NAME:          serverCoreGetTankWorldFromLgm
 *AUTHOR:        John Morrison
 *CREATION DATE: 28/12/00
-*LAST MODIFIED: 28/12/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Gets the tank world co-ordinates from a lgman object
 * returns own tank co-ordinates in a client game
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  lgmans - Pointer to the lgm structure
 *  x      - Pointer to hold World X Co-ordinates
 *  y      - Pointer to hold World Y Co-ordinates
 *********************************************************/
-void serverCoreGetTankWorldFromLgm(lgm *lgmans, WORLD *x, WORLD *y);
+void serverCoreGetTankWorldFromLgm(serverCore sc, lgm *lgmans, WORLD *x, WORLD *y);
 
 /*********************************************************
 *NAME:          serverCoreGetRandStart
 *AUTHOR:        John Morrison
 *CREATION DATE: 18/1/99
-*LAST MODIFIED: 18/1/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Places a random start position into the parmeters passed
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  mx - Pointer to hold Map X Co-ordinates
 *  my - Pointer to hold Map Y Co-ordinates
 *  dir - Direction facing
 *********************************************************/
-void serverCoreGetRandStart(BYTE *mx, BYTE *my, TURNTYPE *dir);
+void serverCoreGetRandStart(serverCore sc, BYTE *mx, BYTE *my, TURNTYPE *dir);
 
 /*********************************************************
 *NAME:          serverCoreGetStartPosition
 *AUTHOR:        John Morrison
 *CREATION DATE: 3/10/01
-*LAST MODIFIED: 8/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Client has request a start position.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Player Number to get
 *  xValue    - Pointer to hold X Value
 *  yValue    - Pointer to hold Y Value
@@ -685,98 +1063,116 @@ void serverCoreGetRandStart(BYTE *mx, BYTE *my, TURNTYPE *dir);
 *  numShells - Pointer to hold number of shells
 *  numMines  - Pointer to hold number of mines
 *********************************************************/
-void serverCoreGetStartPosition(BYTE playerNum, BYTE *xValue, BYTE *yValue, TURNTYPE *angel, BYTE *numShells, BYTE *numMines);
+void serverCoreGetStartPosition(serverCore sc, BYTE playerNum, BYTE *xValue, BYTE *yValue, TURNTYPE *angel, BYTE *numShells, BYTE *numMines);
 
 /*********************************************************
 *NAME:          serverCoreCheckTankRange
 *AUTHOR:        John Morrison
 *CREATION DATE: 9/04/01
-*LAST MODIFIED: 11/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks to see if there is enemy tank within range
 * supplied. Returns TRUE if we are in the clear
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  xValue    - X Value
 *  yValue    - Y Value
 *  playerNum - Player number to check against
 *  distance  - Distance to be less then to return FALSE
 *********************************************************/
-bool serverCoreCheckTankRange(BYTE x, BYTE y, BYTE playerNum, double distance);
+bool serverCoreCheckTankRange(serverCore sc, BYTE x, BYTE y, BYTE playerNum, double distance);
 
 /*********************************************************
 *NAME:          serverCoreCheckPillsRange
 *AUTHOR:        John Morrison
 *CREATION DATE: 9/04/01
-*LAST MODIFIED: 9/04/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks to see if there is enemy pill within range
 * supplied. Returns TRUE if we are in the clear
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  xValue    - X Value
 *  yValue    - Y Value
 *  playerNum - Player number to check against
 *  distance  - Distance to be less then to return true
 *********************************************************/
-bool serverCoreCheckPillsRange(BYTE xValue, BYTE yValue, BYTE playerNum, double distance);
+bool serverCoreCheckPillsRange(serverCore sc, BYTE xValue, BYTE yValue, BYTE playerNum, double distance);
 
 /*********************************************************
 *NAME:          serverCoreSendTeams
 *AUTHOR:        John Morrison
 *CREATION DATE: 21/02/03
-*LAST MODIFIED: 21/02/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Generates a list of teams and send them to winbolo.net
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverCoreSendTeams();
+void serverCoreSendTeams(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreCheckGameWin
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/04/01
-*LAST MODIFIED: 14/04/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks to see if all the bases are owned by a specific
 * alliance
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  printWinners - If TRUE print out the list of winners
 *********************************************************/
-bool serverCoreCheckGameWin(bool printWinners);
+bool serverCoreCheckGameWin(serverCore sc, bool printWinners);
 
 /*********************************************************
 *NAME:          serverCoreStartLog
 *AUTHOR:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 25/07/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Starts logging game events to a log file
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  fileName    - Filename to log to
 *  ai          - Games AI type
 *  maxPlayers  - Maximum number of players allowed in the
 *                game
 *  usePassword - Is the game password protected
 *********************************************************/
-bool serverCoreStartLog(char *fileName, BYTE ai, BYTE maxPlayers, bool usePassword);
+bool serverCoreStartLog(serverCore sc, char *fileName, BYTE ai, BYTE maxPlayers, bool usePassword);
 
 /*********************************************************
 *NAME:          serverCoreStopLog
 *AUTHOR:        John Morrison
 *CREATION DATE: 05/05/01
-*LAST MODIFIED: 05/05/01
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Stops logging
 *
 *ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+void serverCoreStopLog(serverCore sc);
+
+/*********************************************************
+*NAME:          serverCoreGetLogWriterStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Gets the counters of the game's log writer
 *
+*ARGUMENTS:
+*  sc    - Game to use
+*  stats - Structure to fill in
 *********************************************************/
-void serverCoreStopLog();
+void serverCoreGetLogWriterStats(serverCore sc, logWriterStats *stats);
 
 /*********************************************************
 *NAME:          serverCoreSetServerLogFile
@@ -796,223 +1192,273 @@ void serverCoreSetServerLogFile(char *logFile);
 *NAME:          serverCoreSaveMap
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/02/03
-*LAST MODIFIED: 01/03/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Saves the map file to fileName and returns success
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  fileName - File to write to
 *********************************************************/
-bool serverCoreSaveMap(char *fileName);
+bool serverCoreSaveMap(serverCore sc, char *fileName);
 
 /*********************************************************
 *NAME:          serverCoreGetPlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 26/02/03
-*LAST MODIFIED: 01/03/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the players object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-players *serverCoreGetPlayers();
+players *serverCoreGetPlayers(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetBuildings
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the buildings Object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-building *serverCoreGetBuildings();
+building *serverCoreGetBuildings(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetExplosions
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the explosions Object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-explosions *serverCoreGetExplosions();
+explosions *serverCoreGetExplosions(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetFloodFill
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the floodfill object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-floodFill *serverCoreGetFloodFill();
+floodFill *serverCoreGetFloodFill(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetGrass
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the grass object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-grass *serverCoreGetGrass();
+grass *serverCoreGetGrass(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetMines
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the mines object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-mines *serverCoreGetMines();
+mines *serverCoreGetMines(serverCore sc);
 
 /*********************************************************
 *NAME:          serverGetMinesExp
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the mines explosion object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-minesExp *serverGetMinesExp();
+minesExp *serverGetMinesExp(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetRubble
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the rubble object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-rubble *serverCoreGetRubble();
+rubble *serverCoreGetRubble(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetSwamp
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the swamp object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-swamp *serverCoreGetSwamp();
+swamp *serverCoreGetSwamp(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetTankExplosions
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the tank explosions object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-tkExplosion  *serverCoreGetTankExplosions();
+tkExplosion  *serverCoreGetTankExplosions(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetNetPnb
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the Pnb Object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-netPnbContext *serverCoreGetNetPnb();
+netPnbContext *serverCoreGetNetPnb(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetNetMnt
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/10/03
-*LAST MODIFIED: 04/10/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the Pnb Object
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-netMntContext *serverCoreGetNetMnt();
+netMntContext *serverCoreGetNetMnt(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreInformation
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/11/03
-*LAST MODIFIED: 19/11/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Prints out the server information to stdout
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverCoreInformation();
+void serverCoreInformation(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreCheckAutoClose
 *AUTHOR:        John Morrison
 *CREATION DATE: 10/12/03
-*LAST MODIFIED: 10/12/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Checks if the autoclose server function has completed
 * It has completed if one player has joined and then
 * all players have quit the server
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-bool serverCoreCheckAutoClose();
+bool serverCoreCheckAutoClose(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetGameType
 *AUTHOR:        John Morrison
 *CREATION DATE: 17/12/03
-*LAST MODIFIED: 17/12/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns a pointer to the game type
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-gameType *serverCoreGetGameType();
+gameType *serverCoreGetGameType(serverCore sc);
 
 /*********************************************************
 *NAME:          serverCoreGetActualGameType
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the game type (open/tournament etc.)
 *
 *ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+gameType serverCoreGetActualGameType(serverCore sc);
+
+#ifdef BOLO_PROFILE
+/*********************************************************
+*NAME:          serverCoreProfileReset
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Clears the game tick section timings and view matrix
+*  counters
+*
+*ARGUMENTS:
+*
+*********************************************************/
+void serverCoreProfileReset(void);
+
+/*********************************************************
+*NAME:          serverCoreProfileGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Copies the total nanoseconds spent in each section of
+*  the game tick since the last reset into ns. Returns the
+*  number of game ticks profiled.
+*
+*ARGUMENTS:
+*  ns - Array of profileNumItems to hold the timings
+*********************************************************/
+unsigned long serverCoreProfileGet(unsigned long long *ns);
+
+/*********************************************************
+*NAME:          serverCoreViewProfileGet
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the view matrix counters since the last reset
 *
+*ARGUMENTS:
+*  lookups    - Views answered from the matrix when
+*               building position packets
+*  pillChecks - Pill range checks made building the
+*               matrix
+*  pairChecks - Pill range checks a scan for every
+*               lookup would have made
 *********************************************************/
-gameType serverCoreGetActualGameType();
+void serverCoreViewProfileGet(unsigned long long *lookups, unsigned long long *pillChecks, unsigned long long *pairChecks);
+#endif
 
 #endif /* SERVER_CORE_H */
@@ -29,6 +29,7 @@
   #include <unistd.h>
   #include <signal.h>
   #include <errno.h>
+  #include <time.h>
   #include "SDL.h"
   typedef Uint32 DWORD;
   #define USING_SDL
@@ -39,6 +40,8 @@
 #include "../bolo/backend.h"
 #include "servercore.h"
 #include "../bolo/gametype.h"
+#include "../bolo/logwriter.h"
+#include "../bolo/mapfile.h"
 #include "servernet.h"
 #include "servertransport.h"
 #include "threads.h"
@@ -48,6 +51,12 @@
 	#define MAX_PATH 512
 #endif
 
+#ifdef __linux__
+  #include <stdint.h>
+  #include <sys/epoll.h>
+  #include <sys/timerfd.h>
+#endif
+
 
 #include <ctype.h>
 #include <time.h>
@@ -66,6 +75,41 @@ bool dontSendLog = FALSE;
 
 time_t ticks = 0;
 
+/* Most games one server can host */
+#define SERVER_MAX_GAMES 64
+
+/* Where a hosted game is in the worker pool */
+typedef enum {
+  hostIdle,    /* Nothing queued */
+  hostQueued,  /* Waiting for a worker */
+  hostRunning  /* A worker is running it */
+} serverHostState;
+
+/* A game the server is hosting. Each is served on its own port */
+typedef struct {
+  serverCore sc;                /* The game */
+  unsigned short port;          /* Port it is served on */
+  serverHostState state;        /* Where it is in the worker pool */
+  int ticksDue;                 /* Game ticks waiting to be run */
+  bool serveDue;                /* Packets waiting to be read */
+  bool isOver;                  /* Game has been won, closed or timed out */
+  bool quitSent;                /* Players have been told we are quitting */
+  bool isLogging;               /* Is a game log being written */
+  char logFileName[MAX_PATH];   /* Game log file name */
+  int trackerTime;              /* Ticks since the tracker was updated */
+  int wbnTime;                  /* Ticks since WinBolo.net was updated */
+} serverHostGame;
+
+serverHostGame hostGames[SERVER_MAX_GAMES]; /* Games being hosted */
+int hostNumGames = 0;                       /* Number of them */
+threadsPool hostPool = NULL;   /* Workers that run the games, NULL to run them on the loop thread */
+int hostMaxJobs = 1;           /* Most jobs to have in the pool at once */
+int hostJobs = 0;              /* Jobs in the pool or being run */
+int hostReady[SERVER_MAX_GAMES]; /* Ring of games waiting for a job */
+int hostReadyHead = 0;         /* First game in the ring */
+int hostReadyNum = 0;          /* Games in the ring */
+threadsMutex hostLock = NULL;  /* Guards the pool states, the ring and the tick timing counters */
+
 /* Game Tick */
 #define SERVER_TICK_LENGTH (GAME_TICK_LENGTH*2)
 
@@ -89,6 +133,16 @@ typedef enum {
 
 alarmType alarmRaised;
 
+/* Upper bounds in microseconds of the tick lateness histogram
+   buckets. The last bucket holds anything later */
+#define JITTER_NUM_BUCKETS 9
+static const long long jitterLimit[JITTER_NUM_BUCKETS-1] = {100, 250, 500, 1000, 2000, 5000, 10000, 20000};
+static unsigned long jitterCount[JITTER_NUM_BUCKETS]; /* Wake ups in each bucket */
+static unsigned long jitterMissed = 0;  /* Ticks run late as catch up */
+static unsigned long jitterOverrun = 0; /* Steps longer than a tick */
+static long long jitterWorst = 0;       /* Latest wake up */
+static long long jitterLongest = 0;     /* Longest step */
+
 #ifndef _WIN32
 /* Signal handler for linux */
 void
@@ -110,6 +164,164 @@ catch_alarm (int sig)
 #endif
 
 
+/*********************************************************
+*NAME:          serverClockMicros
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns a monotonic time in microseconds
+*
+*ARGUMENTS:
+*
+*********************************************************/
+long long serverClockMicros(void) {
+#ifdef _WIN32
+  return (long long) GetTickCount() * 1000;
+#else
+  struct timespec now; /* Current time */
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#endif
+}
+
+/*********************************************************
+*NAME:          serverJitterRecord
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Records how late the tick source woke us up
+*
+*ARGUMENTS:
+*  late   - Microseconds after the tick was due
+*  missed - Extra ticks that were due and are being run
+*           as catch up
+*********************************************************/
+void serverJitterRecord(long long late, unsigned long missed) {
+  int count; /* Looping variable */
+
+  if (late < 0) {
+    late = 0;
+  }
+  count = 0;
+  while (count < JITTER_NUM_BUCKETS-1 && late >= jitterLimit[count]) {
+    count++;
+  }
+  jitterCount[count]++;
+  jitterMissed += missed;
+  if (late > jitterWorst) {
+    jitterWorst = late;
+  }
+}
+
+/*********************************************************
+*NAME:          serverJitterStep
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Records how long a step of a game took to run. Steps of
+*  different games may be recorded from different workers
+*
+*ARGUMENTS:
+*  length - Microseconds the step took
+*********************************************************/
+void serverJitterStep(long long length) {
+  threadsMutexWait(hostLock);
+  if (length > SERVER_TICK_LENGTH * 1000) {
+    jitterOverrun++;
+  }
+  if (length > jitterLongest) {
+    jitterLongest = length;
+  }
+  threadsMutexRelease(hostLock);
+}
+
+/*********************************************************
+*NAME:          serverJitterPrint
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Prints the tick lateness histogram
+*
+*ARGUMENTS:
+*
+*********************************************************/
+void serverJitterPrint(void) {
+  char buff[256];         /* Line to print */
+  unsigned long total;    /* Total wake ups */
+  int count;              /* Looping variable */
+
+  total = 0;
+  for (count=0;count<JITTER_NUM_BUCKETS;count++) {
+    total += jitterCount[count];
+  }
+  sprintf(buff, "Tick timing: %lu wake ups, %lu catch up ticks, %lu overruns", total, jitterMissed, jitterOverrun);
+  screenServerConsoleMessage(buff);
+  for (count=0;count<JITTER_NUM_BUCKETS;count++) {
+    if (count < JITTER_NUM_BUCKETS-1) {
+      sprintf(buff, "  late < %5lldus: %lu", jitterLimit[count], jitterCount[count]);
+    } else {
+      sprintf(buff, "  late >=%5lldus: %lu", jitterLimit[count-1], jitterCount[count]);
+    }
+    screenServerConsoleMessage(buff);
+  }
+  sprintf(buff, "  worst late %lldus, longest step %lldus", jitterWorst, jitterLongest);
+  screenServerConsoleMessage(buff);
+}
+
+/*********************************************************
+*NAME:          serverLogPrint
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Prints the game log writer counters if a log is being
+*  written
+*
+*ARGUMENTS:
+*  hg - Game to use
+*********************************************************/
+void serverLogPrint(serverHostGame *hg) {
+  char buff[256];        /* Line to print */
+  logWriterStats stats;  /* Writer counters */
+
+  if (hg->isLogging == FALSE) {
+    return;
+  }
+  serverCoreGetLogWriterStats(hg->sc, &stats);
+  sprintf(buff, "Game log: %lu writes, %lu bytes, %lu writer passes, %lu deflates", stats.writes, stats.bytes, stats.passes, stats.deflates);
+  screenServerConsoleMessage(buff);
+  sprintf(buff, "  buffer high water %lu of %d bytes, %lu writes waited for room (%lu waits)", stats.highWater, LOG_WRITER_RING_SIZE, stats.stalls, stats.waits);
+  screenServerConsoleMessage(buff);
+}
+
+/*********************************************************
+*NAME:          serverMapPrint
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Prints the map pending change pool counters
+*
+*ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+void serverMapPrint(serverCore sc) {
+  char buff[256];         /* Line to print */
+  unsigned long poolSize; /* Items in the pool */
+  unsigned long lost;     /* Changes dropped */
+
+  serverCoreLock(sc);
+  serverCoreGetMapNetStats(sc, &poolSize, &lost);
+  serverCoreUnlock(sc);
+  sprintf(buff, "Map changes: pool of %lu pending items, %lu changes lost as it was full", poolSize, lost);
+  screenServerConsoleMessage(buff);
+}
+
 void strlower(char *s) {
   while(*s) {
     *s = tolower(*s);
@@ -117,7 +329,7 @@ void strlower(char *s) {
   }
 }
 
-void saveMap(char *line) {
+void saveMap(serverCore sc, char *line, unsigned short port) {
   char *ptr;
   int len;
   ptr = line;
@@ -141,43 +353,49 @@ void saveMap(char *line) {
     } else if (strcmp(ptr+len-4, ".map") != 0) {
       strcat(ptr, ".map");
     }
-    if (serverCoreSaveMap(ptr) == FALSE) {
+    if (port != 0) {
+      sprintf(ptr+strlen(ptr)-4, "_%u.map", (unsigned int) port);
+    }
+    if (serverCoreSaveMap(sc, ptr) == FALSE) {
       fprintf(stderr, "Sorry, an error occured saving the map. Is the path correct?\n");
     }
   }
 }
 
-bool serverCoreRunning();
-
 void printHelp() {
-  fprintf(stderr, "Help:\n Lock - Locks the server and stops new players from joining.\n Unlock - Unlocks the server and allows new players to join.\n savemap <map file> - Save the map file to path and file <map file>\n Say <text> - Sends this message to all players in the game unless they have turned off server messages.\n Quit - Exits the server.\n Info - Provide information about the current game\n");
+  fprintf(stderr, "Help:\n Lock - Locks the server and stops new players from joining.\n Unlock - Unlocks the server and allows new players to join.\n savemap <map file> - Save the map file to path and file <map file>\n Say <text> - Sends this message to all players in the game unless they have turned off server messages.\n Quit - Exits the server.\n Info - Provide information about the current game\n Stats - Show how late game ticks have been and the memory kept for resending packets\n");
 }
 
 
 #ifdef _WIN32
-void processKeys(bool isQuiet) {
+void processKeys(serverCore sc, bool isQuiet) {
   char keyBuff[256] = "\0";
   char saveBuff[256] = "\0";
   
   if (isQuiet == TRUE || isNoInput == TRUE) {
-    while (serverCoreRunning() == TRUE && isGameOver == FALSE) {
+    while (serverCoreRunning(sc) == TRUE && isGameOver == FALSE) {
       Sleep(1000);
    }
   } else {
-    while (strncmp(keyBuff, "quit", 4) != 0 && isGameOver == FALSE && serverCoreRunning()) {
+    while (strncmp(keyBuff, "quit", 4) != 0 && isGameOver == FALSE && serverCoreRunning(sc)) {
       if (strncmp(keyBuff, "help", 4) == 0) {
         /* Help */
         printHelp();
       } else if (strncmp(keyBuff, "lock", 4) == 0) {
-        serverNetSetLock(TRUE);
+        serverNetSetLock(sc, TRUE);
       } else if (strncmp(keyBuff, "unlock", 6) == 0) {
-        serverNetSetLock(FALSE);
+        serverNetSetLock(sc, FALSE);
       } else if (strncmp(keyBuff, "info", 4) == 0) {
-        serverCoreInformation();
+        serverCoreInformation(sc);
+      } else if (strncmp(keyBuff, "stats", 5) == 0) {
+        serverJitterPrint();
+        serverNetPrintPacketMemory(sc);
+        serverMapPrint(sc);
+        serverLogPrint(&hostGames[0]);
       } else if (strncmp(keyBuff, "savemap", 7) == 0) {
-        saveMap(saveBuff);
+        saveMap(sc, saveBuff, 0);
       } else if (strncmp(keyBuff, "say ", 4) == 0) {
-        serverNetSendServerMessageAllPlayers((char *) keyBuff+4);
+        serverNetSendServerMessageAllPlayers(sc, (char *) keyBuff+4);
       } else if (strncmp(keyBuff, "\n", 1) != 0 && strncmp(keyBuff, "\0", 1) != 0) {
         fprintf(stderr, "Unknown command - Type \"help\" for help\n");
       }
@@ -190,8 +408,112 @@ void processKeys(bool isQuiet) {
 }
 
 #else
+/*********************************************************
+*NAME:          processCommand
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Runs a console command on one game. Returns FALSE if
+*  it is not a game command
+*
+*ARGUMENTS:
+*  hg       - Game to use
+*  keyBuff  - Command line in lower case
+*  saveBuff - Command line as typed
+*********************************************************/
+bool processCommand(serverHostGame *hg, char *keyBuff, char *saveBuff) {
+  bool returnValue; /* Value to return */
+
+  returnValue = TRUE;
+  if (strncmp(keyBuff, "lock", 4) == 0) {
+    serverNetSetLock(hg->sc, TRUE);
+  } else if (strncmp(keyBuff, "info", 4) == 0) {
+    serverCoreInformation(hg->sc);
+  } else if (strncmp(keyBuff, "stats", 5) == 0) {
+    serverNetPrintPacketMemory(hg->sc);
+    serverMapPrint(hg->sc);
+    serverLogPrint(hg);
+  } else if (strncmp(keyBuff, "unlock", 6) == 0) {
+    serverNetSetLock(hg->sc, FALSE);
+  } else if (strncmp(keyBuff, "savemap", 7) == 0) {
+    saveMap(hg->sc, saveBuff, (unsigned short) (hostNumGames > 1 ? hg->port : 0));
+  } else if (strncmp(keyBuff, "say ", 4) == 0) {
+    serverNetSendServerMessageAllPlayers(hg->sc, (char *) keyBuff+4);
+  } else {
+    returnValue = FALSE;
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          serverHostCommand
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Runs a console command other than quit. Game commands
+*  are run on every game still being played
+*
+*ARGUMENTS:
+*  keyBuff  - Command line in lower case
+*  saveBuff - Command line as typed
+*********************************************************/
+void serverHostCommand(char *keyBuff, char *saveBuff) {
+  char buff[256];     /* Game heading and command copy */
+  bool isCommand;     /* Was it a game command */
+  bool wantHeading;   /* Does the command print about each game */
+  int count;          /* Looping variable */
+
+  if (strncmp(keyBuff, "help", 4) == 0) {
+    /* Help */
+    printHelp();
+    return;
+  }
+  if (strncmp(keyBuff, "stats", 5) == 0) {
+    serverJitterPrint();
+  }
+  wantHeading = (bool) (hostNumGames > 1 && (strncmp(keyBuff, "info", 4) == 0 || strncmp(keyBuff, "stats", 5) == 0));
+  isCommand = TRUE;
+  count = 0;
+  while (isCommand == TRUE && count < hostNumGames) {
+    if (hostGames[count].isOver == FALSE) {
+      if (wantHeading == TRUE) {
+        sprintf(buff, "Game on port %u:", (unsigned int) hostGames[count].port);
+        screenServerConsoleMessage(buff);
+      }
+      /* savemap changes the line it is given */
+      strcpy(buff, saveBuff);
+      isCommand = processCommand(&hostGames[count], keyBuff, buff);
+    }
+    count++;
+  }
+  if (isCommand == FALSE && strncmp(keyBuff, "\n", 1) != 0 && strncmp(keyBuff, "\0", 1) != 0) {
+    fprintf(stderr, "Unknown command - Type \"help\" for help\n");
+  }
+}
+
+/*********************************************************
+*NAME:          serverHostSetLock
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Locks or unlocks every game being hosted
+*
+*ARGUMENTS:
+*  lock - TRUE to stop new players joining
+*********************************************************/
+void serverHostSetLock(bool lock) {
+  int count; /* Looping variable */
+
+  for (count=0;count<hostNumGames;count++) {
+    serverNetSetLock(hostGames[count].sc, lock);
+  }
+}
+
 /* Linux */
-void processKeys() {
+void processKeys(void) {
   char keyBuff[256] = "\0";
   char saveBuff[256] = "\0";
   fd_set fdmask; /* for our select               */
@@ -204,14 +526,14 @@ void processKeys() {
   FD_SET(STDIN_FILENO, &fdmask);
 
   if (isQuiet == TRUE || isNoInput == TRUE) {
-    while (serverCoreRunning() == TRUE && isGameOver == FALSE) {
+    while (isGameOver == FALSE) {
     if (alarmRaised == alarmInterrupt) {
        break;
     } else if (alarmRaised == alarmLock) {
-      serverNetSetLock(TRUE);	    
+      serverHostSetLock(TRUE);
       alarmRaised = alarmNone;
     } else if (alarmRaised == alarmUnlock) {
-      serverNetSetLock(FALSE);
+      serverHostSetLock(FALSE);
       alarmRaised = alarmNone;
     }
 
@@ -219,25 +541,9 @@ void processKeys() {
     sleep(1);
     }
   } else {
-    while (strncmp(keyBuff, "quit", 4) != 0 && isGameOver == FALSE && serverCoreRunning()) {
-      if (strncmp(keyBuff, "help", 4) == 0) {
-        /* Help */
-        printHelp();
-      } else if (strncmp(keyBuff, "lock", 4) == 0) {
-        serverNetSetLock(TRUE);
-      } else if (strncmp(keyBuff, "info", 4) == 0) {
-        serverCoreInformation();
-      } else if (strncmp(keyBuff, "unlock", 6) == 0) {
-        serverNetSetLock(FALSE);
-      } else if (strncmp(keyBuff, "savemap", 7) == 0) {
-        saveMap(saveBuff);
-      } else if (strncmp(keyBuff, "say ", 4) == 0) {
-        serverNetSendServerMessageAllPlayers((char *) keyBuff+4);
-      } else if (strncmp(keyBuff, "\n", 1) != 0 && strncmp(keyBuff, "\0", 1) != 0) {
-        fprintf(stderr, "Unknown command - Type \"help\" for help\n");
-      }
-    
-      
+    while (strncmp(keyBuff, "quit", 4) != 0 && isGameOver == FALSE) {
+      serverHostCommand(keyBuff, saveBuff);
+
       timer.tv_sec = 1;
       timer.tv_usec = 0;
       FD_ZERO(&fdmask);
@@ -268,14 +574,246 @@ void processKeys() {
 
 #endif
 
+/*********************************************************
+*NAME:          serverHostGameOver
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Stops running a game that has been won, closed or has
+*  run out of time. Once every game is over the server
+*  quits. While others are still running its players are
+*  told straight away
+*
+*ARGUMENTS:
+*  hg - Game that is over
+*********************************************************/
+void serverHostGameOver(serverHostGame *hg) {
+  int count;   /* Looping variable */
+  bool allOver; /* Is every game over */
+
+  hg->isOver = TRUE;
+  threadsMutexWait(hostLock);
+  allOver = TRUE;
+  for (count=0;count<hostNumGames;count++) {
+    if (hostGames[count].isOver == FALSE) {
+      allOver = FALSE;
+    }
+  }
+  threadsMutexRelease(hostLock);
+  if (allOver == TRUE) {
+    isGameOver = TRUE;
+  } else {
+    serverNetSendQuitMessage(hg->sc);
+    hg->quitSent = TRUE;
+  }
+}
+
+/*********************************************************
+*NAME:          serverGameStep
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Runs the game ticks that are due then sends out the
+* network updates. Called each time the tick source wakes
+* us up. Only one thread steps a game at a time
+*
+*ARGUMENTS:
+*  hg       - Game to use
+*  numTicks - Number of game ticks due
+*********************************************************/
+void serverGameStep(serverHostGame *hg, int numTicks) {
+  serverCore sc;       /* The game */
+  long long stepStart; /* When this step started */
+  bool over;           /* Is the game over */
+
+  sc = hg->sc;
+  threadsSetContext(TRUE);
+  serverCoreSetContext(sc);
+  stepStart = serverClockMicros();
+  if (numTicks > 0) {
+    while (numTicks > 0) {
+      hg->trackerTime++;
+      hg->wbnTime++;
+      
+      serverCoreLock(sc);
+      serverCoreGameTick(sc);
+      serverCoreUnlock(sc);
+      numTicks--;
+    }
+    over = (bool) (serverCoreRunning(sc) == FALSE);
+    if (quitOnWinFlag == TRUE || autoClose == TRUE || (winbolonetIsRunning() == TRUE && serverCoreGetActualGameType(sc) != gameOpen)) {
+      serverCoreLock(sc);
+      if (serverCoreCheckGameWin(sc, printGameWinners) == TRUE) {
+        over = TRUE;
+      } else if (autoClose == TRUE && serverCoreCheckAutoClose(sc) == TRUE) {
+        over = TRUE;
+      }
+      serverCoreUnlock(sc);
+    }
+    if (over == TRUE) {
+      serverHostGameOver(hg);
+    }
+    #ifdef _WIN32  
+    if (isQuiet == FALSE && isGameOver == TRUE) {
+      BYTE key[64];
+      serverNetSendQuitMessage(sc);
+      timeKillEvent(serverTimerGameID);
+
+
+
+      if (isLogging == TRUE && winbolonetIsRunning() == TRUE && dontSendLog == FALSE) {
+        winboloNetGetServerKey(key);
+      } else {
+        key[0] = EMPTY_CHAR;
+      }
+
+      winbolonetDestroy();
+      serverNetDestroy(sc);
+      threadsDestroy();
+      serverCoreStopLog(sc);
+
+      if (isLogging == TRUE && key[0] != EMPTY_CHAR && dontSendLog == FALSE) {
+        screenServerConsoleMessage((char *)"Uploading log file to winbolo.net");  
+        httpCreate();
+        httpSendLogFile(fileName, key, FALSE);
+        httpDestroy();
+      }
+      serverCoreDestroy(&sc);
+      WSACleanup();
+      exit(0);
+    }
+    #endif
+  } 
+  
+  serverNetCheckRemovePlayers(sc);
+  serverNetPublishSnapshot(sc);
+  serverNetMakePosPackets(sc);
+  serverNetMakeData(sc);
+  
+  
+  /* WinBolo.net tracks the first game only */
+  if (hg->wbnTime > 100 && hg == &hostGames[0]) {
+    serverCoreLock(sc);
+    winbolonetServerUpdate(serverCoreGetNumPlayers(sc), serverCoreGetNumNeutralBases(sc), serverCoreGetNumNeutralPills(sc), FALSE);
+    serverCoreUnlock(sc);
+    hg->wbnTime = 0;
+  }
+
+
+  if (hg->trackerTime >= (6000)) {
+    serverNetSendTrackerUpdate(sc);
+    hg->trackerTime = 0;
+  }
+  serverJitterStep(serverClockMicros() - stepStart);
+}
+
+/*********************************************************
+*NAME:          serverHostRun
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Worker pool job. Takes games off the ready ring and
+*  runs the ticks that are due or reads waiting packets
+*  till the ring is empty. A game is kept while more work
+*  arrives for it so it is never run by two jobs at once
+*
+*ARGUMENTS:
+*  arg - Unused
+*********************************************************/
+void serverHostRun(void *arg) {
+  serverHostGame *hg; /* The game */
+  int numTicks;       /* Ticks to run this time */
+  bool serve;         /* Read packets this time */
+
+  threadsMutexWait(hostLock);
+  while (hostReadyNum > 0) {
+    hg = &hostGames[hostReady[hostReadyHead]];
+    hostReadyHead = (hostReadyHead + 1) % SERVER_MAX_GAMES;
+    hostReadyNum--;
+    hg->state = hostRunning;
+    while (hg->ticksDue > 0 || hg->serveDue == TRUE) {
+      numTicks = hg->ticksDue;
+      serve = hg->serveDue;
+      hg->ticksDue = 0;
+      hg->serveDue = FALSE;
+      threadsMutexRelease(hostLock);
+      if (hg->isOver == FALSE) {
+        if (numTicks > 0) {
+          /* Stepping reads the waiting packets too */
+          serverGameStep(hg, numTicks);
+        } else if (serve == TRUE) {
+          threadsSetContext(TRUE);
+          serverCoreSetContext(hg->sc);
+          serverTransportListenUDP(hg->sc);
+        }
+      }
+      threadsMutexWait(hostLock);
+    }
+    hg->state = hostIdle;
+  }
+  hostJobs--;
+  threadsMutexRelease(hostLock);
+}
+
+/*********************************************************
+*NAME:          serverHostQueue
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Adds work for a game. An idle game is put on the ready
+*  ring and a job is handed to the worker pool if it has
+*  fewer than one per worker, otherwise a job already
+*  there picks it up. A game that is queued or running
+*  just has the work added. Without a pool the work is run
+*  straight away on the calling thread
+*
+*ARGUMENTS:
+*  hg       - Game to use
+*  numTicks - Game ticks that are due
+*  serve    - Are packets waiting to be read
+*********************************************************/
+void serverHostQueue(serverHostGame *hg, int numTicks, bool serve) {
+  bool runNow; /* Run it on this thread */
+
+  runNow = FALSE;
+  threadsMutexWait(hostLock);
+  hg->ticksDue += numTicks;
+  if (serve == TRUE) {
+    hg->serveDue = TRUE;
+  }
+  if (hg->state == hostIdle) {
+    hostReady[(hostReadyHead + hostReadyNum) % SERVER_MAX_GAMES] = (int) (hg - hostGames);
+    hostReadyNum++;
+    hg->state = hostQueued;
+    if (hostJobs < hostMaxJobs) {
+      if (hostPool != NULL && threadsPoolAdd(hostPool, serverHostRun, NULL) == TRUE) {
+        hostJobs++;
+      } else if (hostJobs == 0) {
+        /* No pool or it is full so nothing would run it */
+        runNow = TRUE;
+        hostJobs++;
+      }
+    }
+  }
+  threadsMutexRelease(hostLock);
+  if (runNow == TRUE) {
+    serverHostRun(NULL);
+  }
+}
+
 /*********************************************************
 *NAME:          serverGameTimer
 *AUTHOR:        John Morrison
 *CREATION DATE: 24/11/98
-*LAST MODIFIED: 20/3/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * The Game Timer. If there are no events to prcess this 
-* routine is called. If the elapsed
+* routine is called. If the elapsed. Steps each game in
+* turn on the timer thread
 *
 *ARGUMENTS:
 *
@@ -283,91 +821,208 @@ void processKeys() {
 #ifdef _WIN32
 void CALLBACK serverGameTimer(UINT uID, UINT uMsg, DWORD dwUser, DWORD dw1, DWORD dw2) {
   DWORD tick;     /* Number of ticks passed */
-  static int trackerTime = 5500;   /* When we should update the tracker */
-  static int wbnTime = 0;
+  int numTicks;   /* Game ticks due */
+  long long late; /* How late the timer was */
+  int count;      /* Looping variable */
 
   tick = GetTickCount();
 #else
   Uint32 serverGameTimer (Uint32 interval) {
   DWORD tick;     /* Number of ticks passed */
-  static int wbnTime = 0;
-  static int trackerTime = 5500;   /* When we should update the tracker */
+  int numTicks;   /* Game ticks due */
+  long long late; /* How late the timer was */
+  int count;      /* Looping variable */
   tick = SDL_GetTicks();
 #endif
 
+  numTicks = 0;
   if ((tick - oldTick) > SERVER_TICK_LENGTH) {
-    /* Get the keyboard state */
+    late = (long long) (tick - oldTick - SERVER_TICK_LENGTH) * 1000;
     while ((tick - oldTick) > SERVER_TICK_LENGTH) {
-      trackerTime++;
-      wbnTime++;
-      
-      threadsWaitForMutex();
-      serverCoreGameTick();
-      threadsReleaseMutex();
-      ticks++;
+      numTicks++;
       oldTick += SERVER_TICK_LENGTH;
     }
-    if (quitOnWinFlag == TRUE || autoClose == TRUE || (winbolonetIsRunning() == TRUE && serverCoreGetActualGameType() != gameOpen)) {
-      BYTE key[64];
-      threadsWaitForMutex();
-      isGameOver = serverCoreCheckGameWin(printGameWinners);
-      if (autoClose == TRUE && isGameOver == FALSE) {
-        isGameOver = serverCoreCheckAutoClose();
-      }
-      threadsReleaseMutex();
-      #ifdef _WIN32  
-      if (isQuiet == FALSE && isGameOver == TRUE) {
-        serverNetSendQuitMessage();
-        timeKillEvent(serverTimerGameID);
-
+    serverJitterRecord(late, (unsigned long) (numTicks - 1));
+  }
+  ticks += numTicks;
+  for (count=0;count<hostNumGames;count++) {
+    if (hostGames[count].isOver == FALSE) {
+      serverGameStep(&hostGames[count], numTicks);
+    }
+  }
+#ifdef USING_SDL 
+  return interval;
+#endif
+}
 
+#ifdef __linux__
+/* Most epoll events handled per wake up */
+#define SERVER_LOOP_EVENTS 8
 
-        if (isLogging == TRUE && winbolonetIsRunning() == TRUE && dontSendLog == FALSE) {
-          winboloNetGetServerKey(key);
-        } else {
-          key[0] = EMPTY_CHAR;
-        }
+/* epoll tags for the tick timer and stdin. Games are tagged
+   with their place in hostGames */
+#define SERVER_LOOP_TIMER 0xFFFFFFFFU
+#define SERVER_LOOP_INPUT 0xFFFFFFFEU
 
-        winbolonetDestroy();
-        serverNetDestroy();
-        threadsDestroy();
-        serverCoreStopLog();
+/*********************************************************
+*NAME:          serverEventInput
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Reads whatever is waiting on stdin and runs each
+*  complete line as a console command. Returns FALSE if
+*  stdin has been closed
+*
+*ARGUMENTS:
+*
+*********************************************************/
+bool serverEventInput(void) {
+  static char lineBuff[256];   /* Line read so far as typed */
+  static int lineLen = 0;
+  char readBuff[256];          /* Data read this time */
+  char keyBuff[256];           /* Line in lower case */
+  ssize_t ret;
+  ssize_t count;
+
+  ret = read(STDIN_FILENO, readBuff, sizeof(readBuff));
+  if (ret < 0 && (errno == EINTR || errno == EAGAIN)) {
+    return TRUE;
+  } else if (ret <= 0) {
+    return FALSE;
+  }
 
-        if (isLogging == TRUE && key[0] != EMPTY_CHAR && dontSendLog == FALSE) {
-          screenServerConsoleMessage((char *)"Uploading log file to winbolo.net");  
-          httpCreate();
-          httpSendLogFile(fileName, key, FALSE);
-          httpDestroy();
-        }
-        serverCoreDestroy();
-        WSACleanup();
-        exit(0);
+  for (count=0;count<ret;count++) {
+    if (readBuff[count] == '\n') {
+      /* Kept on the end of the line as fgets would */
+      lineBuff[lineLen] = '\n';
+      lineBuff[lineLen+1] = '\0';
+      strcpy(keyBuff, lineBuff);
+      strlower(keyBuff);
+      if (strncmp(keyBuff, "quit", 4) == 0) {
+        alarmRaised = alarmInterrupt;
+      } else {
+        serverHostCommand(keyBuff, lineBuff);
       }
-      #endif
+      lineLen = 0;
+    } else if (lineLen < (int) sizeof(lineBuff) - 2) {
+      lineBuff[lineLen] = readBuff[count];
+      lineLen++;
     }
-  } 
-  
-  serverNetCheckRemovePlayers();
-  serverNetMakePosPackets();
-  serverNetMakeData();
-  
-  
-  if (wbnTime > 100) {
-    threadsWaitForMutex();
-    winbolonetServerUpdate(serverCoreGetNumPlayers(), serverCoreGetNumNeutralBases(), serverCoreGetNumNeutralPills(), FALSE);
-    threadsReleaseMutex();
-    wbnTime = 0;
+  }
+  return TRUE;
+}
+
+/*********************************************************
+*NAME:          serverEventLoop
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Runs the server on this thread until it is told to
+*  quit. Game ticks come from one timerfd for every game
+*  while UDP packets and console commands are handled as
+*  soon as epoll says they are readable. The games
+*  themselves are run by the worker pool if there is one.
+*  Returns FALSE without running anything if the loop
+*  could not be set up.
+*
+*ARGUMENTS:
+*
+*********************************************************/
+bool serverEventLoop(void) {
+  int epollFd;                /* Our epoll instance */
+  int timerFd;                /* Game tick timer */
+  struct epoll_event ev;      /* Event to add */
+  struct epoll_event events[SERVER_LOOP_EVENTS]; /* Events to process */
+  struct itimerspec timerSpec; /* Timer settings */
+  long long startTime;        /* When the loop started */
+  unsigned long long due;     /* Ticks due since the loop started */
+  uint64_t expired;           /* Ticks due since the last read */
+  int numEvents;
+  int count;
+  int game;                   /* Looping variable */
+  bool ok;                    /* Was everything added */
+
+  epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (epollFd < 0) {
+    return FALSE;
+  }
+  timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (timerFd < 0) {
+    close(epollFd);
+    return FALSE;
   }
 
+  /* Absolute so tick n is always due at startTime + n ticks */
+  startTime = serverClockMicros();
+  timerSpec.it_interval.tv_sec = 0;
+  timerSpec.it_interval.tv_nsec = SERVER_TICK_LENGTH * 1000000L;
+  timerSpec.it_value.tv_sec = (time_t) ((startTime + SERVER_TICK_LENGTH * 1000) / 1000000);
+  timerSpec.it_value.tv_nsec = (long) ((startTime + SERVER_TICK_LENGTH * 1000) % 1000000) * 1000;
+  ev.events = EPOLLIN;
+  ev.data.u32 = SERVER_LOOP_TIMER;
+  ok = (bool) (timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &timerSpec, NULL) == 0 && epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &ev) == 0);
+  /* Edge triggered as a game's packets may not be read till its job runs */
+  ev.events = EPOLLIN | EPOLLET;
+  game = 0;
+  while (ok == TRUE && game < hostNumGames) {
+    ev.data.u32 = (uint32_t) game;
+    ok = (bool) (epoll_ctl(epollFd, EPOLL_CTL_ADD, serverTransportGetSocket(hostGames[game].sc), &ev) == 0);
+    game++;
+  }
+  if (ok == FALSE) {
+    close(timerFd);
+    close(epollFd);
+    return FALSE;
+  }
+  if (isQuiet == FALSE && isNoInput == FALSE) {
+    /* Fails if stdin is a plain file in which case we run without input */
+    ev.events = EPOLLIN;
+    ev.data.u32 = SERVER_LOOP_INPUT;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, STDIN_FILENO, &ev);
+  }
+
+  due = 0;
+  while (isGameOver == FALSE && alarmRaised != alarmInterrupt) {
+    numEvents = epoll_wait(epollFd, events, SERVER_LOOP_EVENTS, -1);
+    count = 0;
+    while (count < numEvents) {
+      if (events[count].data.u32 == SERVER_LOOP_TIMER) {
+        if (read(timerFd, &expired, sizeof(expired)) == sizeof(expired) && expired > 0) {
+          due += expired;
+          ticks += (time_t) expired;
+          serverJitterRecord(serverClockMicros() - startTime - (long long) due * SERVER_TICK_LENGTH * 1000, (unsigned long) (expired - 1));
+          for (game=0;game<hostNumGames;game++) {
+            if (hostGames[game].isOver == FALSE) {
+              serverHostQueue(&hostGames[game], (int) expired, FALSE);
+            }
+          }
+        }
+      } else if (events[count].data.u32 == SERVER_LOOP_INPUT) {
+        if (serverEventInput() == FALSE) {
+          epoll_ctl(epollFd, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+        }
+      } else if (events[count].data.u32 < (uint32_t) hostNumGames) {
+        serverHostQueue(&hostGames[events[count].data.u32], 0, TRUE);
+      }
+      count++;
+    }
 
-  if (trackerTime >= (6000)) {
-    serverNetSendTrackerUpdate();
-    trackerTime = 0;
+    if (alarmRaised == alarmLock) {
+      serverHostSetLock(TRUE);
+      alarmRaised = alarmNone;
+    } else if (alarmRaised == alarmUnlock) {
+      serverHostSetLock(FALSE);
+      alarmRaised = alarmNone;
+    }
   }
-#ifdef USING_SDL 
-  return interval;
-#endif
+
+  close(timerFd);
+  close(epollFd);
+  return TRUE;
 }
+#endif
 
 void printArgs() {
 #ifdef _WIN32
@@ -401,6 +1056,21 @@ void printArgs() {
   fprintf(stderr, "                server.\n");
   fprintf(stderr, "-log          - Create game log file (filename optional)\n");
   fprintf(stderr, "-dontsendlog  - Don't upload game log to winbolo.net\n");
+  fprintf(stderr, "-logflush     - Milliseconds between game log writes from the log writer\n");
+  fprintf(stderr, "                thread (default %d)\n", LOG_WRITER_FLUSH_DEFAULT);
+  fprintf(stderr, "-logsync      - Write the game log from the game tick instead of a thread\n");
+  fprintf(stderr, "-mapcache     - Keep a decoded copy of the map beside it (.bmc) and load\n");
+  fprintf(stderr, "                that instead while the map file is unchanged\n");
+#ifdef __linux__
+  fprintf(stderr, "-sdltimer     - Drive game ticks from an SDL timer thread instead of\n");
+  fprintf(stderr, "                the single threaded epoll loop\n");
+  fprintf(stderr, "-games        - Number of games to host, each on its own port counting up\n");
+  fprintf(stderr, "                from <Port> (1 if not specified). WinBolo.net only tracks\n");
+  fprintf(stderr, "                the first\n");
+  fprintf(stderr, "-workers      - Threads that run the games (one per processor up to the\n");
+  fprintf(stderr, "                number of games if not specified, 0 runs them on the\n");
+  fprintf(stderr, "                epoll loop thread)\n");
+#endif
 }
 
 
@@ -461,14 +1131,14 @@ bool argExist(int numArgs, char **argv[], char *argname) {
 }
 
 /** Generates a log file name based on current time and map name and copies to fileName */
-void makeLogFileName(char *fileName) {
+void makeLogFileName(serverCore sc, char *fileName) {
   time_t t;
   struct tm *tmt;
   int count = 0;
   int len;
   char mapName[256];
 
-  serverCoreGetMapName(mapName);
+  serverCoreGetMapName(sc, mapName);
   time(&t);
   tmt = localtime(&t);
   
@@ -615,6 +1285,116 @@ bool processArgs(int numArgs, char **argv[], char *mapName, unsigned short *port
   return returnValue;
 }
 
+/*********************************************************
+*NAME:          serverHostCreateGame
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates a game from the map file or the inbuilt map.
+*  Returns NULL if an error occured
+*
+*ARGUMENTS:
+*  mapName     - Map file or "-inbuilt"
+*  game        - The game type-Open/tournament/strict
+*                tournament
+*  hiddenMines - Are hidden mines allowed
+*  srtDelay    - Game start delay (50th second increments)
+*  gmeLen      - Length of the game (in 50ths)
+*                (-1 =unlimited)
+*********************************************************/
+serverCore serverHostCreateGame(char *mapName, gameType game, bool hiddenMines, int srtDelay, long gmeLen) {
+  serverCore returnValue; /* Value to return */
+
+  returnValue = NULL;
+  if (strcmp(mapName, "-inbuilt") == 0) {
+    /* Use the inbuilt map */
+#ifdef _WIN32
+    HGLOBAL hGlobal;  /* Resource handle */
+    BYTE *buff;       /* Byte buffer     */
+    HRSRC res;        /* FindResource return */
+
+    res = FindResource(NULL, MAKEINTRESOURCE(IDR_EVERARD), "MAPS");
+    if (res != NULL) {
+      hGlobal = LoadResource(NULL, res);
+      if (hGlobal != NULL) {
+        buff = LockResource(hGlobal);
+        if (buff != NULL) {
+          returnValue = serverCoreCreateCompressed(buff, 5097, "Everard Island", game, hiddenMines, srtDelay, gmeLen);
+        }
+      }
+    }
+#else
+  BYTE emap[6000] = E_MAP;
+  returnValue = serverCoreCreateCompressed(emap, 5097, "Everard Island", game, hiddenMines, srtDelay, gmeLen);
+
+#endif
+  } else {
+    returnValue = serverCoreCreate(mapName, game, hiddenMines, srtDelay, gmeLen);
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          serverHostStartLog
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Starts the game log for a game. When several games are
+*  hosted the port is added to the file name
+*
+*ARGUMENTS:
+*  hg         - Game to use
+*  argName    - File name given after -log or NULL
+*  ai         - Games AI type
+*  maxPlayers - Maximum number of players allowed in the
+*               game
+*  usePassword - Is the game password protected
+*********************************************************/
+void serverHostStartLog(serverHostGame *hg, char *argName, BYTE ai, BYTE maxPlayers, bool usePassword) {
+  char logFileName[512];
+
+  if (argName == NULL) {
+    makeLogFileName(hg->sc, logFileName);
+  } else {
+    strcpy(logFileName, argName);
+  }
+  if (strlen(logFileName) > 4) {
+    if (strcmp(logFileName + (strlen(logFileName)-4), ".wbv") == 0) {
+      logFileName[strlen(logFileName)-4] = '\0';
+    }
+  }
+  if (hostNumGames > 1) {
+    sprintf(logFileName + strlen(logFileName), "_%u", (unsigned int) hg->port);
+  }
+  strcat(logFileName, ".wbv");
+  strcpy(hg->logFileName, logFileName);
+  hg->isLogging = serverCoreStartLog(hg->sc, logFileName, ai, maxPlayers, usePassword);
+}
+
+/*********************************************************
+*NAME:          serverHostDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Shuts down the network and core of every game hosted
+*
+*ARGUMENTS:
+*
+*********************************************************/
+void serverHostDestroy(void) {
+  int count; /* Looping variable */
+
+  for (count=0;count<hostNumGames;count++) {
+    serverNetDestroy(hostGames[count].sc);
+    serverCoreDestroy(&hostGames[count].sc);
+  }
+  hostNumGames = 0;
+  threadsMutexDestroy(&hostLock);
+}
+
 #include <time.h>
 
 int main(int argc, char **argv[]) {
@@ -633,12 +1413,19 @@ int main(int argc, char **argv[]) {
   char *useAddr;
   int maxPlayers;
   BYTE key[32]; /* WBN Key */
+  serverCore sc; /* The game being set up */
+  int numGames;   /* Games to host */
+  int numWorkers; /* Threads to run them, 0 to run them on the loop thread */
+  int count;      /* Looping variable */
 
   threadsSetContext(TRUE);
   serverCoreSetQuietMode(FALSE);
   isQuiet = FALSE;
   isNoInput = FALSE;
   maxPlayers = 0;
+  numGames = 1;
+  numWorkers = 0;
+  sc = NULL;
 
 
   alarmRaised = alarmNone;
@@ -670,6 +1457,42 @@ int main(int argc, char **argv[]) {
       maxPlayers = 0;
     }
   }
+
+#ifdef __linux__
+  if (findArg(argc, argv, "games") != ARG_NOT_FOUND) {
+    numGames = atoi((char *) argv[findArg(argc, argv, "games")]);
+    if (numGames < 1 || numGames > SERVER_MAX_GAMES || (long) port + numGames - 1 > 65535) {
+      fprintf(stderr, "Error in games parameter. Between 1 and %d games can be hosted\n", SERVER_MAX_GAMES);
+      printArgs();
+      exit(0);
+    }
+  }
+  if (numGames > 1) {
+    /* A worker for each processor, but no more than there are games */
+    numWorkers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (numWorkers > numGames) {
+      numWorkers = numGames;
+    } else if (numWorkers < 1) {
+      numWorkers = 1;
+    }
+  }
+  if (findArg(argc, argv, "workers") != ARG_NOT_FOUND) {
+    numWorkers = atoi((char *) argv[findArg(argc, argv, "workers")]);
+    if (numWorkers < 0) {
+      numWorkers = 0;
+    } else if (numWorkers > numGames) {
+      numWorkers = numGames;
+    }
+  }
+  if (argExist(argc, argv, "sdltimer") == TRUE) {
+    /* The timer thread steps the games itself */
+    numWorkers = 0;
+  }
+#endif
+  hostLock = threadsMutexCreate();
+  if (hostLock == NULL) {
+    exit(0);
+  }
   
 #ifdef USING_SDL 
   if (SDL_Init(SDL_INIT_TIMER) < 0) {
@@ -677,36 +1500,25 @@ int main(int argc, char **argv[]) {
     exit(0);
   }
 #endif
-  if (strcmp(mapName, "-inbuilt") == 0) {
-    /* Use the inbuilt map */
-#ifdef _WIN32
-    HGLOBAL hGlobal;  /* Resource handle */
-    BYTE *buff;       /* Byte buffer     */
-    HRSRC res;        /* FindResource return */
-
-    res = FindResource(NULL, MAKEINTRESOURCE(IDR_EVERARD), "MAPS");
-    if (res != NULL) {
-      hGlobal = LoadResource(NULL, res);
-      if (hGlobal != NULL) {
-        buff = LockResource(hGlobal);
-        if (buff != NULL) {
-          serverCoreCreateCompressed(buff, 5097, "Everard Island", game, hiddenMines, srtDelay, gmeLen);
-        }
-      }
-    }
-#else
-  BYTE emap[6000] = E_MAP;
-  serverCoreCreateCompressed(emap, 5097, "Everard Island", game, hiddenMines, srtDelay, gmeLen);
-
-#endif
-  } else {
-    if (serverCoreCreate(mapName, game, hiddenMines, srtDelay, gmeLen) == FALSE) {
+  if (strcmp(mapName, "-inbuilt") != 0) {
+    mapFileSetCache(argExist(argc, argv, "mapcache"));
+  }
+  for (count=0;count<numGames;count++) {
+    sc = serverHostCreateGame(mapName, game, hiddenMines, srtDelay, gmeLen);
+    if (sc == NULL) {
       fprintf(stderr, "Error starting Core Simulation\n");
+      serverHostDestroy();
 #ifdef USING_SDL
       SDL_Quit();
 #endif
       return 0;
     }
+    memset(&hostGames[count], 0, sizeof(hostGames[count]));
+    hostGames[count].sc = sc;
+    hostGames[count].port = (unsigned short) (port + count);
+    hostGames[count].state = hostIdle;
+    hostGames[count].trackerTime = 5500;
+    hostNumGames++;
   }
   useAddr = NULL;
   if (argExist(argc, argv, "addr") == TRUE) {
@@ -717,78 +1529,113 @@ int main(int argc, char **argv[]) {
   autoClose = argExist(argc, argv, "autoclose");
   printGameWinners = argExist(argc, argv, "printwinners");
 
-  if (serverNetCreate(port, pass, ai, trackerAddr, trackerPort, trackerUse, useAddr, (BYTE) maxPlayers) == FALSE) {
-    fprintf(stderr, "Error starting Network\n");
-    serverNetDestroy();
-    serverCoreDestroy();
+  for (count=0;count<hostNumGames;count++) {
+    if (serverNetCreate(hostGames[count].sc, hostGames[count].port, pass, ai, trackerAddr, trackerPort, trackerUse, useAddr, (BYTE) maxPlayers) == FALSE) {
+      fprintf(stderr, "Error starting Network\n");
+      serverHostDestroy();
 #ifdef USING_SDL
-    SDL_Quit();
+      SDL_Quit();
 #endif
 return 0;
+    }
   }
+  sc = hostGames[0].sc;
 
+  /* WinBolo.net tracks the first game only */
   if (argExist(argc, argv, "nowinbolonet") == FALSE) {
     char mapName[255];
-    serverCoreGetMapName(mapName);
-    winbolonetCreateServer(mapName, port, (BYTE) game, (BYTE) ai, serverCoreGetAllowHiddenMines(), (BYTE) (pass[0] == 0 ? FALSE : TRUE), screenNumBases(), screenNumPills(), serverCoreGetNumNeutralBases(), serverCoreGetNumNeutralPills(), serverCoreGetNumPlayers(), serverCoreGetTimeGameCreated());
+    serverCoreGetMapName(sc, mapName);
+    serverCoreSetContext(sc);
+    winbolonetCreateServer(mapName, port, (BYTE) game, (BYTE) ai, serverCoreGetAllowHiddenMines(sc), (BYTE) (pass[0] == 0 ? FALSE : TRUE), serverCoreNumBases(sc), serverCoreNumPills(sc), serverCoreGetNumNeutralBases(sc), serverCoreGetNumNeutralPills(sc), serverCoreGetNumPlayers(sc), serverCoreGetTimeGameCreated(sc));
   }
   dontSendLog = argExist(argc, argv, "dontsendlog");
 
   /* Log file generation */
+  logWriterSetThreaded((bool) (argExist(argc, argv, "logsync") == FALSE));
+  if (findArg(argc, argv, "logflush") != ARG_NOT_FOUND) {
+    logWriterSetFlushTime(atoi((char *) argv[findArg(argc, argv, "logflush")]));
+  }
   if (argExist(argc, argv, "log") == TRUE) {
-    char logFileName[512];
+    char *logArg = NULL;
     int arg = findArg(argc, argv, "log");
 
-    if (arg == ARG_NOT_FOUND) {
-      makeLogFileName(logFileName);
-    } else if ((char) argv[arg][0] == '-') {
-      makeLogFileName(logFileName);
-    } else {
-      strcpy(logFileName, (char *) argv[arg]);
+    if (arg != ARG_NOT_FOUND && (char) argv[arg][0] != '-') {
+      logArg = (char *) argv[arg];
     }
-    if (strlen(logFileName) > 4) {
-      if (strcmp(logFileName + (strlen(logFileName)-4), ".wbv") != 0) {
-        strcat(logFileName, ".wbv");
-      }
-    } else {
-      strcat(logFileName, ".wbv");
+    for (count=0;count<hostNumGames;count++) {
+      serverHostStartLog(&hostGames[count], logArg, ai, maxPlayers, (BYTE) (pass[0] == 0 ? FALSE : TRUE));
     }
-    strcpy(fileName, logFileName);
-    isLogging = serverCoreStartLog(logFileName, ai, maxPlayers, (BYTE) (pass[0] == 0 ? FALSE : TRUE));
+    /* Only the first game's log is sent to WinBolo.net */
+    strcpy(fileName, hostGames[0].logFileName);
+    isLogging = hostGames[0].isLogging;
   }
 
 
   if (threadsCreate(TRUE) == FALSE) {
     fprintf(stderr, "Error starting Thread Manger\n");
     threadsDestroy();
-    serverNetDestroy();
-    serverCoreDestroy();
+    serverHostDestroy();
     #ifdef USING_SDL
           SDL_Quit();
     #endif
 	  return 0;
   } 
+  if (numWorkers > 0) {
+    hostPool = threadsPoolCreate(numWorkers);
+    hostMaxJobs = numWorkers;
+    if (hostPool == NULL) {
+      fprintf(stderr, "Error starting Worker Pool\n");
+      threadsDestroy();
+      serverHostDestroy();
+#ifdef USING_SDL
+      SDL_Quit();
+#endif
+      return 0;
+    }
+  }
+  if (hostNumGames > 1) {
+    char buff[256];
+    sprintf(buff, "Hosting %d games on ports %u to %u with %d workers", hostNumGames, (unsigned int) port, (unsigned int) (port + hostNumGames - 1), numWorkers);
+    screenServerConsoleMessage(buff);
+  }
   screenServerConsoleMessage("Type \"help\" for help, \"quit\" to exit.");
 #ifdef _WIN32
   oldTick = GetTickCount();
   serverTimerGameID = timeSetEvent(SERVER_TICK_LENGTH, 10, serverGameTimer, 0, TIME_PERIODIC);
-#else
-  oldTick = SDL_GetTicks();
-  serverTimerGameID = SDL_SetTimer(SERVER_TICK_LENGTH, (SDL_TimerCallback) serverGameTimer);
-
-#endif
 
   // Comment out to quit straight away
-  processKeys(isQuiet);
-  serverNetSendQuitMessage();
-#ifdef _WIN32  
+  processKeys(sc, isQuiet);
   timeKillEvent(serverTimerGameID);
 #else
-  SDL_SetTimer(0, NULL);
+#ifdef __linux__
+  /* The SDL timer is kept for comparison and in case epoll is not
+     available. It steps every game in turn on its own thread */
+  if (argExist(argc, argv, "sdltimer") == TRUE || serverEventLoop() == FALSE) {
+#endif
+    oldTick = SDL_GetTicks();
+    serverTimerGameID = SDL_SetTimer(SERVER_TICK_LENGTH, (SDL_TimerCallback) serverGameTimer);
+    processKeys();
+    SDL_SetTimer(0, NULL);
+#ifdef __linux__
+  }
 #endif
-  serverNetDestroy();
+#endif
+  /* Let the workers finish what they are running */
+  threadsPoolDestroy(&hostPool);
+  for (count=0;count<hostNumGames;count++) {
+    if (hostGames[count].quitSent == FALSE) {
+      serverNetSendQuitMessage(hostGames[count].sc);
+    }
+  }
+  serverJitterPrint();
+  for (count=0;count<hostNumGames;count++) {
+    serverNetDestroy(hostGames[count].sc);
+  }
   threadsDestroy();
-  serverCoreStopLog();
+  for (count=0;count<hostNumGames;count++) {
+    serverCoreStopLog(hostGames[count].sc);
+    serverLogPrint(&hostGames[count]);
+  }
 
   if (isLogging == TRUE && winbolonetIsRunning() == TRUE && argExist(argc, argv, "dontsendlog") == FALSE) {
     winboloNetGetServerKey(key);
@@ -805,7 +1652,7 @@ return 0;
     httpDestroy();
   }
 
-  serverCoreDestroy();
+  serverHostDestroy();
 #ifdef _WIN32
   WSACleanup();
 #endif
@@ -47,18 +47,31 @@
 #include "threads.h"
 #include "../bolo/netpacks.h"
 #include "../bolo/log.h"
+#include "../bolo/netjoin.h"
 #include "../winbolonet/winbolonet.h"
 #include "servernet.h"
 
-/* Password in netgames */
-char netPassword[MAP_STR_SIZE];
-aiType allowAi;
-bool netUseTracker; /* Do we use the tracker or not */
-bool serverLock;    /* Is the game locked by server? */
-bool hasPass;       /* Do we have a password         */
-BYTE snMaxPlayers;  /* Max Players */
-
-netPlayers np; /* Network players status */
+/* The network side of a game */
+struct serverNetObj {
+  char netPassword[MAP_STR_SIZE]; /* Password in netgames */
+  aiType allowAi;
+  bool netUseTracker;             /* Do we use the tracker or not */
+  bool serverLock;                /* Is the game locked by server? */
+  bool hasPass;                   /* Do we have a password         */
+  BYTE snMaxPlayers;              /* Max Players */
+  netPlayers np;                  /* Network players status */
+  unsigned long netPosSent;       /* Last snapshot positions were sent from */
+  unsigned long netDataSent;      /* Last snapshot data was sent from */
+  bool inFix;                     /* Processing retransmitted packets */
+  int posCount;                   /* Snapshots since positions were taken */
+  time_t lastCheck;               /* Time between removing players */
+  BYTE joinRaw[NET_JOIN_RAW_SIZE];    /* Uncompressed join blob */
+  BYTE joinPacked[NET_JOIN_RAW_SIZE]; /* What the join blob was made from */
+  int joinPackedLen;                  /* Length of joinPacked */
+  BYTE joinBlob[NET_JOIN_MAX_SIZE];   /* Compressed join blob */
+  int joinBlobLen;                    /* Length of the join blob */
+  BYTE joinBlobId;                    /* Tells join blobs apart */
+};
 
 int lzwencoding(char *src, char *dest, int len);
 
@@ -66,12 +79,13 @@ int lzwencoding(char *src, char *dest, int len);
 *NAME:          serverNetCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/08/99
-*LAST MODIFIED: 27/02/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets the network kind of game being played and sets up
 * udp
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  myPort      - UDP port on this machine
 *  password    - Password to use to verify joins
 *  ai          - Ai Type of the game (allow/disallow/adv)
@@ -82,39 +96,44 @@ int lzwencoding(char *src, char *dest, int len);
 *  maxPlayers  - Max players this server can handle (0 for
 *                unlimited)
 **********************************************************/
-bool serverNetCreate(unsigned short myPort, char *password, aiType ai, char *trackerAddr, unsigned short trackerPort, bool useTracker, char *useAddr, BYTE maxPlayers) {
+bool serverNetCreate(serverCore sc, unsigned short myPort, char *password, aiType ai, char *trackerAddr, unsigned short trackerPort, bool useTracker, char *useAddr, BYTE maxPlayers) {
   bool returnValue; /* Value to return */
   time_t startTime; /* Start Time if we created the game */
 
+  New(sc->net);
+  if (sc->net == NULL) {
+    return FALSE;
+  }
+  memset(sc->net, 0, sizeof(*sc->net));
   returnValue = TRUE;
-  snMaxPlayers = maxPlayers;
+  sc->net->snMaxPlayers = maxPlayers;
   startTime = 0;
-  hasPass = FALSE;
-  strcpy(netPassword, password);
-  if (netPassword[0] != '\0') {
-    hasPass = TRUE;
+  sc->net->hasPass = FALSE;
+  strcpy(sc->net->netPassword, password);
+  if (sc->net->netPassword[0] != '\0') {
+    sc->net->hasPass = TRUE;
   }
-  netPlayersCreate(&np);
-  allowAi = ai;
-  serverLock = FALSE;
+  netPlayersCreate(&sc->net->np);
+  sc->net->allowAi = ai;
+  sc->net->serverLock = FALSE;
 
-  returnValue = serverTransportCreate(myPort, useAddr);
+  returnValue = serverTransportCreate(sc, myPort, useAddr);
   if (returnValue == TRUE) {
-    serverTransportSetUs();
+    serverTransportSetUs(sc);
     time(&startTime);
-    serverCoreSetTimeGameCreated(startTime);
+    serverCoreSetTimeGameCreated(sc, startTime);
     /* Try and set the tracker */
-    netUseTracker = useTracker;
+    sc->net->netUseTracker = useTracker;
     if (useTracker == TRUE) {
-      if (serverTransportSetTracker(trackerAddr, trackerPort) == FALSE) {
+      if (serverTransportSetTracker(sc, trackerAddr, trackerPort) == FALSE) {
         screenServerConsoleMessage((char *) "The tracker hostname lookup failed.\n Tracker notification disabled");
-        netUseTracker = FALSE;
+        sc->net->netUseTracker = FALSE;
       }
     }
   }
 
   if (returnValue == FALSE) {
-    serverNetDestroy();
+    serverNetDestroy(sc);
   }
 
   return returnValue;
@@ -124,59 +143,74 @@ bool serverNetCreate(unsigned short myPort, char *password, aiType ai, char *tra
 *NAME:          serverNetDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Shuts down the network. Shutsdown transport as well.
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetDestroy(void) {
-  serverTransportDestroy();
-  netPlayersDestroy(&np);
+void serverNetDestroy(serverCore sc) {
+  if (sc->net != NULL) {
+    serverTransportDestroy(sc);
+    netPlayersDestroy(&sc->net->np);
+    Dispose(sc->net);
+    sc->net = NULL;
+  }
 }
 
 
 time_t serverMainGetTicks();
 
-void serverNetCheck(BYTE *ptr, int len) {
+void serverNetCheck(serverCore sc, BYTE *ptr, int len) {
   BYTE playerNum;
   BYTE frame;
   time_t t;
   memcpy(&t, ptr+len-sizeof(time_t), sizeof(time_t));
   utilGetNibbles(*(ptr+BOLOPACKET_REQUEST_SIZE), &playerNum, &frame);
-  if (netPlayersCheck(&np, playerNum, t, serverMainGetTicks()) == TRUE) {
-    serverNetPlayerLeave(playerNum, FALSE);
+  if (netPlayersCheck(&sc->net->np, playerNum, t, serverMainGetTicks()) == TRUE) {
+    serverNetPlayerLeave(sc, playerNum, FALSE);
   }
 }
 
 
-netPlayers *serverNetGetNetPlayers() {
-  return &np;
+/*********************************************************
+*NAME:          serverNetGetNetPlayers
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns the network status of the game's players
+*
+*ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+netPlayers *serverNetGetNetPlayers(serverCore sc) {
+  return &sc->net->np;
 }
 
 /*********************************************************
 *NAME:          serverNetUDPPacketArrive
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/08/99
-*LAST MODIFIED: 19/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A UDP packet has arrived. It is processed here.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff  - Buffer that has arrived.
 *  len   - length of the packet
 *  addr  - Address long
 *  port  - The port the last packet came in on
 *********************************************************/
-void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned short port) {
-  static char info[MAX_UDPPACKET_SIZE] = GENERICHEADER; /* Buffer to send */
-  static bool inFix = FALSE;
-  static BYTE playerNum; /* Player number that sent us this packet. Used only in PosData */
-  static BYTE dummy; /* Used to hold unused nibble to get player Number. Used only in PosData */
-  static BYTE crcA;  /* First CRC Byte */
-  static BYTE crcB;  /* Second CRC Byte */
-  static BYTE sequenceNumber; /* Sequence number */
+void serverNetUDPPacketArrive(serverCore sc, BYTE *buff, int len, unsigned long addr, unsigned short port) {
+  char info[MAX_UDPPACKET_SIZE] = GENERICHEADER; /* Buffer to send */
+  BYTE playerNum; /* Player number that sent us this packet. Used only in PosData */
+  BYTE dummy; /* Used to hold unused nibble to get player Number. Used only in PosData */
+  BYTE crcA;  /* First CRC Byte */
+  BYTE crcB;  /* Second CRC Byte */
+  BYTE sequenceNumber; /* Sequence number */
   udpPackets udpp;
 
   if ((strncmp(buff, BOLO_SIGNITURE, BOLO_SIGNITURE_SIZE) == 0) && buff[BOLO_VERSION_MAJORPOS] == BOLO_VERSION_MAJOR && buff[BOLO_VERSION_MINORPOS] == BOLO_VERSION_MINOR && buff[BOLO_VERSION_REVISIONPOS] == BOLO_VERSION_REVISION) {
@@ -184,27 +218,27 @@ void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned
       /* Ping packet */
       PING_PACKET *pp;
       int pos;
-      playerNum = netPlayersGetPlayerNumber(&np, addr, port);
-      if (playerNum < MAX_TANKS && playersIsInUse(screenGetPlayers(), playerNum)) {
+      playerNum = netPlayersGetPlayerNumber(&sc->net->np, addr, port);
+      if (playerNum < MAX_TANKS && playersIsInUse(serverCoreGetPlayers(sc), playerNum)) {
         pp = (PING_PACKET *) buff;
-        udpp = netPlayersGetUdpPackets(&np, playerNum);
+        udpp = netPlayersGetUdpPackets(&sc->net->np, playerNum);
       	pos = 1 + pp->outPacket;;
 	      if (pos == MAX_UDP_SEQUENCE) {
           pos = 0;
         }
 
-        if (udpPacketsGetInSequenceNumber(&udpp) != pos && inFix == FALSE) {
+        if (udpPacketsGetInSequenceNumber(&udpp) != pos && sc->net->inFix == FALSE) {
           REREQUEST_PACKET rrp;
           serverNetMakePacketHeader(&(rrp.h), BOLOPACKET_PACKETREREQUEST);
           rrp.nonReliable = UDP_NON_RELIABLE_PACKET;
           rrp.rerequestItem = udpPacketsGetInSequenceNumber(&udpp);
           CRCCalcBytes((BYTE *) &rrp, sizeof(REREQUEST_PACKET)-2 , &(rrp.crcA), &(rrp.crcB));
-          serverTransportSendUDPLast((BYTE *) &rrp, sizeof(rrp), FALSE);
+          serverTransportSendUDPLast(sc, (BYTE *) &rrp, sizeof(rrp), FALSE);
         }
         pp->h.type  = BOLOPACKET_PINGRESPONSE;
         pp->inPacket = udpPacketsGetInSequenceNumber(&udpp);
         pp->outPacket = udpPacketsGetOutSequenceNumber(&udpp);
-        serverTransportSendUDPLast(buff, len, FALSE);
+        serverTransportSendUDPLast(sc, buff, len, FALSE);
       }
     } else if (buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_RETRANSMITTED_PACKETS) {
        BYTE count;
@@ -212,24 +246,24 @@ void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned
        int pos;
        count = 0;
        pos = BOLOPACKET_REQUEST_TYPEPOS+2;
-       inFix = TRUE;
+       sc->net->inFix = TRUE;
        while (count < buff[BOLOPACKET_REQUEST_TYPEPOS+1]) {
          memcpy(&us, buff+pos, 2);
          pos += 2;
-         serverNetUDPPacketArrive(buff+pos, us, addr, port);
+         serverNetUDPPacketArrive(sc, buff+pos, us, addr, port);
          pos += us;
          count++;
        }
-       inFix = FALSE;
+       sc->net->inFix = FALSE;
 
     } else if (len == BOLOPACKET_REQUEST_SIZE && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_INFOREQUEST) {
      /* Make info response packet */
       INFO_PACKET h;
       screenServerConsoleMessage((char *)"Info packet request!");
       memset(&h, 0, sizeof(h));
-      serverNetMakeInfoRespsonse(&h);
+      serverNetMakeInfoRespsonse(sc, &h);
       memcpy(info, &h, sizeof(h));
-      serverTransportSendUDPLast(info, sizeof(h), FALSE);
+      serverTransportSendUDPLast(sc, info, sizeof(h), FALSE);
     } else {
       /* Person must be in game 
          Check CRC
@@ -238,7 +272,7 @@ void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned
       */
       BYTE playerNum;
 
-      playerNum = netPlayersGetPlayerNumber(&np, addr, port);
+      playerNum = netPlayersGetPlayerNumber(&sc->net->np, addr, port);
 
       if (playerNum != NET_PLAYERS_NOT_FOUND || buff[len-3] == UDP_NON_RELIABLE_PACKET) { // || buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_PLAYERDATAREQUEST || buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_PASSWORDCHECK  || buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_NAMECHECK || buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_PLAYERNUMREQUEST || buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_SERVERKEYREQUEST || buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOREJOINREQUEST) {
 
@@ -251,12 +285,12 @@ void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned
           if (sequenceNumber == UDP_NON_RELIABLE_PACKET) {
             /* Non reliable marker */
             len--;
-            if (buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_PACKETREREQUEST && netPlayersGetInUse(&np, playerNum) == TRUE) {
+            if (buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_PACKETREREQUEST && netPlayersGetInUse(&sc->net->np, playerNum) == TRUE) {
               BYTE upto;
               BYTE high;
       	      BYTE count=0;
               unsigned short us;
-              udpp = netPlayersGetUdpPackets(&np, playerNum);
+              udpp = netPlayersGetUdpPackets(&sc->net->np, playerNum);
               upto = buff[BOLOPACKET_REQUEST_TYPEPOS+1];
               high = udpPacketsGetOutSequenceNumber(&udpp);
               high++;
@@ -282,24 +316,29 @@ void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned
                 }
               }  
               info[BOLOPACKET_REQUEST_TYPEPOS+1] = count;
-              serverTransportSendUDPLast(info, len, TRUE);
+              serverTransportSendUDPLast(sc, info, len, TRUE);
             } else if (buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_SERVERKEYREQUEST) {
               info[BOLOPACKET_REQUEST_TYPEPOS] = BOLOPACKET_SERVERKEYRESPONSE;
               winboloNetGetServerKey(info + sizeof(BOLOHEADER));
-              serverTransportSendUDPLast(info, sizeof(BOLOHEADER) + WINBOLONET_KEY_LEN, FALSE);
+              serverTransportSendUDPLast(sc, info, sizeof(BOLOHEADER) + WINBOLONET_KEY_LEN, FALSE);
             } else if (buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPOSITION_DATA) {
               /* Position packet */
               BYTE *ptr;
               struct sockaddr_in sAddr;
               ptr = buff + BOLOPACKET_REQUEST_SIZE;
-              serverNetCheck(buff, len);
+              serverNetCheck(sc, buff, len);
 
-              threadsWaitForMutex();
+              serverCoreLock(sc);
               
-              serverCoreSetPosData(ptr);
+              serverCoreSetPosData(sc, ptr);
+              utilGetNibbles(*ptr, &playerNum, &dummy);
+              if (len > BOLOPACKET_REQUEST_SIZE + (int) sizeof(time_t)) {
+                /* Position frame acknowledged is just before the time.
+                   Clients older than revision 0x06 never get this far */
+                serverCoreSetPosAck(sc, playerNum, buff[len - sizeof(time_t) - 1]);
+              }
               
               /* Reset the players address and port for routers that change them */
-              utilGetNibbles(*ptr, &playerNum, &dummy);
               sAddr.sin_family = AF_INET;
               #ifdef _WIN32
                 sAddr.sin_addr.S_un.S_addr = addr;
@@ -307,10 +346,10 @@ void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned
                 sAddr.sin_addr.s_addr = addr;
               #endif
               sAddr.sin_port=port;
-              netPlayersSetAddr(&np, playerNum, &sAddr);
-              threadsReleaseMutex();
+              netPlayersSetAddr(&sc->net->np, playerNum, &sAddr);
+              serverCoreUnlock(sc);
             } else if (len == sizeof(REJOINREQUEST_PACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOREJOINREQUEST) {
-              serverCoreRequestRejoin(buff[BOLOPACKET_REQUEST_TYPEPOS+1]);
+              serverCoreRequestRejoin(sc, buff[BOLOPACKET_REQUEST_TYPEPOS+1]);
             } else if (len == sizeof(PASSWORD_PACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_PASSWORDCHECK) { 
              /* Password check packet */
               PASSWORD_PACKET pp;
@@ -318,13 +357,13 @@ void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned
 
               memcpy(&pp, buff, sizeof(pp));
               utilPtoCString(pp.password, info);
-              if (strcmp(info, netPassword) != 0) {
+              if (strcmp(info, sc->net->netPassword) != 0) {
                 serverNetMakePacketHeader(&h, BOLOPACKET_PASSWORDFAIL);
               } else {
                 serverNetMakePacketHeader(&h, BOLOPACKET_PASSWORDACCEPT);
               } 
               memcpy(info, &h, sizeof(h));
-              serverTransportSendUDPLast(info, sizeof(h), TRUE);
+              serverTransportSendUDPLast(sc, info, sizeof(h), TRUE);
               } else if (len == sizeof(PLAYERNAME_PACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_NAMECHECK) { 
                /* Player name check packet */
                 PLAYERNAME_PACKET pn;
@@ -333,37 +372,37 @@ void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned
 
                 memcpy(&pn, buff, sizeof(pn));
                 utilPtoCString(pn.playerName, info);
-                threadsWaitForMutex();
-            		numPlayers = playersGetNumPlayers(screenGetPlayers());
-            		if (serverLock == TRUE || (numPlayers > 0 && netPlayersIsLocked(&np) == TRUE)) {
+                serverCoreLock(sc);
+            		numPlayers = playersGetNumPlayers(serverCoreGetPlayers(sc));
+            		if (sc->net->serverLock == TRUE || (numPlayers > 0 && netPlayersIsLocked(&sc->net->np) == TRUE)) {
                   serverNetMakePacketHeader(&h, BOLOPACKET_GAMELOCKED);
-            		} else if (snMaxPlayers > 0 && numPlayers >= snMaxPlayers) {
+            		} else if (sc->net->snMaxPlayers > 0 && numPlayers >= sc->net->snMaxPlayers) {
                   serverNetMakePacketHeader(&h, BOLOPACKET_MAXPLAYERS);
-		            } else if (playersNameTaken(screenGetPlayers(), info) == TRUE) {
+		            } else if (playersNameTaken(serverCoreGetPlayers(sc), info) == TRUE) {
                   serverNetMakePacketHeader(&h, BOLOPACKET_NAMEFAIL);
                 } else {
                   serverNetMakePacketHeader(&h, BOLOPACKET_NAMEACCEPT);
                 }
-                threadsReleaseMutex();
+                serverCoreUnlock(sc);
                 memcpy(info, &h, sizeof(h));
-                serverTransportSendUDPLast(info, sizeof(h), TRUE);
+                serverTransportSendUDPLast(sc, info, sizeof(h), TRUE);
               } else if (len == sizeof(PLAYERNUM_REQ_PACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_PLAYERNUMREQUEST) { 
                 /* Player Number request */
-                threadsWaitForMutex();
-                serverNetPlayerNumReq(buff, len, addr, port);
-                threadsReleaseMutex();
+                serverCoreLock(sc);
+                serverNetPlayerNumReq(sc, buff, len, addr, port);
+                serverCoreUnlock(sc);
               } else if (len == sizeof(PLAYERDATA_REQPACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_PLAYERDATAREQUEST) {
                 /* Player data request */
-                threadsWaitForMutex();
-                serverNetPlayerDataReq();
-                threadsReleaseMutex();
+                serverCoreLock(sc);
+                serverNetPlayerDataReq(sc);
+                serverCoreUnlock(sc);
 
               } else {
 //                screenServerConsoleMessage((char *) "Bad unknown unreliable packet ");
               }
 
           } else {
-            udpp = netPlayersGetUdpPackets(&np, playerNum);
+            udpp = netPlayersGetUdpPackets(&sc->net->np, playerNum);
             if (sequenceNumber != udpPacketsGetInSequenceNumber(&udpp)) {
               /* Rerequest *
               REREQUEST_PACKET rrp;
@@ -371,11 +410,11 @@ void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned
               rrp.nonReliable = UDP_NON_RELIABLE_PACKET;
               rrp.rerequestItem = udpPacketsGetInSequenceNumber(&udpp);           
               CRCCalcBytes((BYTE *) &rrp, sizeof(REREQUEST_PACKET)-2 , &(rrp.crcA), &(rrp.crcB));
-              serverTransportSendUDPLast((BYTE *) &rrp, sizeof(rrp), FALSE);
+              serverTransportSendUDPLast(sc, (BYTE *) &rrp, sizeof(rrp), FALSE);
 //              screenServerConsoleMessage((char *) "Bad sequence number - Rerequesting"); */
             } else {
               udpPacketsGetNextInSequenceNumber(&udpp);
-              serverNetTCPPacketArrive(buff, len-1, playerNum, addr, port);
+              serverNetTCPPacketArrive(sc, buff, len-1, playerNum, addr, port);
             }
           }
         } else {
@@ -386,31 +425,96 @@ void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned
   }
 }
 
+/*********************************************************
+*NAME:          serverNetSendJoinData
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Sends a joining player the starts, bases, pills and map
+* blob. Every chunk is sent straight away and the reliable
+* packet stream keeps them in order. If the blob can't be
+* made a single chunk saying there are none is sent and
+* the client falls back to downloading piece by piece.
+* Must be called holding the game mutex. It is let go
+* while the blob is compressed, and if nothing changed
+* since the last join that blob is sent again.
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  playerNum - The player number to send to
+*********************************************************/
+static void serverNetSendJoinData(serverCore sc, BYTE playerNum) {
+  BYTE info[MAX_UDPPACKET_SIZE] = GENERICHEADER; /* Buffer to send */
+  struct serverNetObj *net;                   /* Join blob cache */
+  int rawLen;                                 /* Length of raw */
+  int upto;                                   /* Sent so far */
+  unsigned short dataLen;                     /* Length of this chunk */
+  BYTE numChunks;                             /* Chunks in the blob */
+  BYTE chunk;                                 /* Chunk being sent */
+  BYTE *pnt;                                  /* Data Pointer */
+
+  net = sc->net;
+  rawLen = serverCoreGetJoinData(sc, net->joinRaw);
+  /* Compress it without holding up the game */
+  serverCoreUnlock(sc);
+  if (rawLen != net->joinPackedLen || memcmp(net->joinRaw, net->joinPacked, (size_t) rawLen) != 0) {
+    net->joinBlobLen = netJoinPack(net->joinRaw, rawLen, net->joinBlob);
+    net->joinPackedLen = 0;
+    if (net->joinBlobLen > 0) {
+      memcpy(net->joinPacked, net->joinRaw, (size_t) rawLen);
+      net->joinPackedLen = rawLen;
+    }
+  }
+  serverCoreLock(sc);
+  numChunks = (BYTE) ((net->joinBlobLen + NET_JOIN_CHUNK_SIZE - 1) / NET_JOIN_CHUNK_SIZE);
+  net->joinBlobId++;
+  serverNetMakePacketHeader((BOLOHEADER *) info, BOLOPACKET_JOINDATARESPONSE);
+  upto = 0;
+  chunk = 0;
+  do {
+    dataLen = NET_JOIN_CHUNK_SIZE;
+    if (net->joinBlobLen - upto < NET_JOIN_CHUNK_SIZE) {
+      dataLen = (unsigned short) (net->joinBlobLen - upto);
+    }
+    pnt = info + BOLOPACKET_REQUEST_TYPEPOS + 1;
+    pnt[0] = net->joinBlobId;
+    pnt[1] = chunk;
+    pnt[2] = numChunks;
+    memcpy(pnt+3, &dataLen, sizeof(dataLen));
+    memcpy(pnt+NET_JOIN_CHUNK_HEADER, net->joinBlob+upto, dataLen);
+    serverNetSendPlayer(sc, playerNum, info, BOLOPACKET_REQUEST_SIZE + NET_JOIN_CHUNK_HEADER + dataLen);
+    upto += dataLen;
+    chunk++;
+  } while (chunk < numChunks);
+}
+
 /*********************************************************
 *NAME:          serverNetTCPPacketArrive
 *AUTHOR:        John Morrison
 *CREATION DATE: 27/08/99
-*LAST MODIFIED: 19/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A UDP packet has arrived. It is processed here.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff      - Buffer that has arrived.
 *  len       - length of the packet
 *  playerNum - The player number packet came from
 *  addr  - Address long
 *  port  - The port the last packet came in on
 *********************************************************/
-void serverNetTCPPacketArrive(BYTE *buff, int len, BYTE playerNum, unsigned long addr, unsigned short port) {
-  static char info[MAX_UDPPACKET_SIZE] = GENERICHEADER; /* Buffer to send */
+void serverNetTCPPacketArrive(serverCore sc, BYTE *buff, int len, BYTE playerNum, unsigned long addr, unsigned short port) {
+  char info[MAX_UDPPACKET_SIZE] = GENERICHEADER; /* Buffer to send */
   BYTE *pnt;                                  /* Data Pointer   */
 
    /* Server password check */
-  if (hasPass == TRUE) {
-    if (netPlayersHasPassed(&np, playerNum) == FALSE) {
+  if (sc->net->hasPass == TRUE) {
+    if (netPlayersHasPassed(&sc->net->np, playerNum) == FALSE) {
       /* If this isn't a password packet drop them */
       if (len != sizeof(PASSWORD_PACKET) || buff[BOLOPACKET_REQUEST_TYPEPOS] != BOLOPACKET_PASSWORDCHECK) {
-        serverNetPlayerLeave(playerNum, FALSE);
+        serverNetPlayerLeave(sc, playerNum, FALSE);
         return;
       }
     }
@@ -418,40 +522,43 @@ void serverNetTCPPacketArrive(BYTE *buff, int len, BYTE playerNum, unsigned long
 
   memset(info, 0, MAX_TCPPACKET_SIZE);
   serverNetMakePacketHeader((BOLOHEADER *) info, 0);
-  threadsWaitForMutex();
+  serverCoreLock(sc);
 
   if (len == sizeof(BOLOHEADER) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_PACKETQUIT) {
     /* This player has quit */
-    serverNetPlayerLeave(playerNum, TRUE);
+    serverNetPlayerLeave(sc, playerNum, TRUE);
   } else if (len == BOLOPACKET_REQUEST_SIZE && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_BASESDATAREQUEST) { 
     /* Wants bases data */
     BYTE len;
     info[BOLOPACKET_REQUEST_TYPEPOS] = BOLOPACKET_BASESDATARESPONSE;
     pnt = info;
     pnt += BOLOPACKET_REQUEST_TYPEPOS+1;
-    len = serverCoreGetBaseNetData(pnt);
-    serverNetSendPlayer(playerNum, info, (BOLOPACKET_REQUEST_SIZE + len));
+    len = serverCoreGetBaseNetData(sc, pnt);
+    serverNetSendPlayer(sc, playerNum, info, (BOLOPACKET_REQUEST_SIZE + len));
   } else if (len == BOLOPACKET_REQUEST_SIZE && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_STARTSDATAREQUEST) { 
     /* Wants Starts data */
     BYTE len;
     info[BOLOPACKET_REQUEST_TYPEPOS] = BOLOPACKET_STARTSDATARESPONSE;
     pnt = info;
     pnt += BOLOPACKET_REQUEST_TYPEPOS+1;
-    len = serverCoreGetStartsNetData(pnt);
-    serverNetSendPlayer(playerNum, info, (BOLOPACKET_REQUEST_SIZE + len));
-    netPlayersSetInGame(&np, playerNum, TRUE);
+    len = serverCoreGetStartsNetData(sc, pnt);
+    serverNetSendPlayer(sc, playerNum, info, (BOLOPACKET_REQUEST_SIZE + len));
+    netPlayersSetInGame(&sc->net->np, playerNum, TRUE);
   } else if (len == BOLOPACKET_REQUEST_SIZE && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_PILLSDATAREQUEST) { 
     /* Wants Pillbox data */
     BYTE len;
     info[BOLOPACKET_REQUEST_TYPEPOS] = BOLOPACKET_PILLSDATARESPONSE;
     pnt = info;
     pnt += BOLOPACKET_REQUEST_TYPEPOS+1;
-    len = serverCoreGetPillNetData(pnt);
-    serverNetSendPlayer(playerNum, info, (BOLOPACKET_REQUEST_SIZE + len));
+    len = serverCoreGetPillNetData(sc, pnt);
+    serverNetSendPlayer(sc, playerNum, info, (BOLOPACKET_REQUEST_SIZE + len));
   } else if (len == sizeof(MAPDOWNLOADREQUEST_PACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_MAPDATAREQUEST) { 
     /* Wants Map download data */
     unsigned short dataLen;
     BYTE *savePtr;
+    BYTE rows[MAP_NET_RUN_SIZE];
+    unsigned long version;
+    int runLen;
 
     pnt = info;
     info[BOLOPACKET_REQUEST_TYPEPOS] = BOLOPACKET_MAPDATARESPONSE;
@@ -460,37 +567,49 @@ void serverNetTCPPacketArrive(BYTE *buff, int len, BYTE playerNum, unsigned long
     savePtr = pnt;
     pnt += 2;
     memset(pnt, 0, MAX_UDPPACKET_SIZE-20);
-    dataLen = serverCoreMakeMapNetRun(pnt, buff[BOLOPACKET_MAPDDOWNLOAD_YPOS]);
+    runLen = serverCoreGetMapNetRun(sc, pnt, buff[BOLOPACKET_MAPDDOWNLOAD_YPOS], rows, &version);
+    if (runLen == MAP_RUN_CACHE_MISS) {
+      /* Not cached. Compress it without holding up the game */
+      serverCoreUnlock(sc);
+      runLen = mapRunCacheEncode(rows, pnt);
+      serverCoreLock(sc);
+      serverCorePutMapNetRun(sc, pnt, buff[BOLOPACKET_MAPDDOWNLOAD_YPOS], runLen, version);
+    }
+    dataLen = (unsigned short) runLen;
     memcpy(savePtr, &dataLen, sizeof(dataLen));
-    serverNetSendPlayer(playerNum, info, sizeof(BOLOHEADER) + sizeof(BYTE) + sizeof(unsigned short) + dataLen);
+    serverNetSendPlayer(sc, playerNum, info, sizeof(BOLOHEADER) + sizeof(BYTE) + sizeof(unsigned short) + dataLen);
+  } else if (len == BOLOPACKET_REQUEST_SIZE && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_JOINDATAREQUEST) {
+    /* Wants everything needed to join in one go */
+    serverNetSendJoinData(sc, playerNum);
+    netPlayersSetInGame(&sc->net->np, playerNum, TRUE);
   } else if (len == BOLOPACKET_REQUEST_SIZE && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_TIMEREQUEST) { 
     /* Wants Time data */
     TIME_PACKET tp = TIMEHEADER;
-    tp.start_delay = serverCoreGetGameStartDelay();
-    tp.time_limit = serverCoreGetGameTimeLeft();
+    tp.start_delay = serverCoreGetGameStartDelay(sc);
+    tp.time_limit = serverCoreGetGameTimeLeft(sc);
     memcpy(info, &tp, sizeof(TIME_PACKET));
-    serverNetSendPlayer(playerNum, info, sizeof(TIME_PACKET));
+    serverNetSendPlayer(sc, playerNum, info, sizeof(TIME_PACKET));
   } else if (len == sizeof(PLAYERNAMECHANGE_PACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOCHANGENAME_DATA) {
     /* Change Player Name packet */
-    serverNetChangePlayerName(playerNum, buff);
+    serverNetChangePlayerName(sc, playerNum, buff);
   } else if (buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_MESSAGE_ALL_PLAYERS) {
     /* Message to all players */
-    serverNetSendAllExceptPlayer(playerNum, buff, len);
+    serverNetSendAllExceptPlayer(sc, playerNum, buff, len);
     logAddEvent(log_MessageAll, playerNum, 0, 0, 0, 0, (char *) (buff + BOLOPACKET_REQUEST_TYPEPOS + 3));
   } else if (buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOPACKET_MESSAGE) {
     /* Message to a certain player */
-    serverNetSendPlayer(buff[BOLOPACKET_REQUEST_TYPEPOS+2], buff, len);
+    serverNetSendPlayer(sc, buff[BOLOPACKET_REQUEST_TYPEPOS+2], buff, len);
     logAddEvent(log_MessagePlayers, playerNum, buff[BOLOPACKET_REQUEST_TYPEPOS+2],0, 0, 0, buff+BOLOPACKET_REQUEST_TYPEPOS+3);
-    //serverTransportSendTCPData(netPlayersGetSockNum(&np, buff[BOLOPACKET_REQUEST_TYPEPOS+2]), buff, len);
+    //serverTransportSendTCPData(netPlayersGetSockNum(&sc->net->np, buff[BOLOPACKET_REQUEST_TYPEPOS+2]), buff, len);
   } else if (buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOCLIENT_DATA) {
     /* Client Data */
-    severNetProcessClientData(buff, len, playerNum);
+    severNetProcessClientData(sc, buff, len, playerNum);
   } else if (len == sizeof(ALLIANCE_PACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOLEAVEALLIANCE_DATA) {
     /* Player leave alliance */
-    playersLeaveAlliance(screenGetPlayers(), buff[BOLOPACKET_REQUEST_TYPEPOS+1]);
+    playersLeaveAlliance(serverCoreGetPlayers(sc), buff[BOLOPACKET_REQUEST_TYPEPOS+1]);
     winbolonetAddEvent(WINBOLO_NET_EVENT_ALLY_LEAVE, TRUE, buff[BOLOPACKET_REQUEST_TYPEPOS+1], WINBOLO_NET_NO_PLAYER);
     logAddEvent(log_AllyLeave, buff[BOLOPACKET_REQUEST_TYPEPOS+1], 0, 0, 0, 0, NULL);
-    serverNetSendAll(buff, len);
+    serverNetSendAll(sc, buff, len);
   } else if (len == BOLOPACKET_REQUEST_SIZE && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOALLOWNEWPLAYERS) {
     /* Client is allowing new players */
     BYTE *ptr;
@@ -499,21 +618,21 @@ void serverNetTCPPacketArrive(BYTE *buff, int len, BYTE playerNum, unsigned long
     ptr = info;
     ptr += BOLOPACKET_REQUEST_TYPEPOS+1;
 
-    playersGetPlayerName(screenGetPlayers(), playerNum, str);
+    playersGetPlayerName(serverCoreGetPlayers(sc), playerNum, str);
     strcat(str, (char *) " is now allowing players to join.");
     utilCtoPString(str, ptr);
     logAddEvent(log_MessageServer, 0, 0, 0, 0, 0, (char *) ptr);
-    serverNetSendAll(info, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
-    if (netPlayersIsLocked(&np) == TRUE) {
+    serverNetSendAll(sc, info, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
+    if (netPlayersIsLocked(&sc->net->np) == TRUE) {
       /* Send out game is unlocked message */
       utilCtoPString((char *) "This game is now unlocked to new players (client unlock)", ptr);
       logAddEvent(log_MessageServer, 0, 0, 0, 0, 0, (char *) ptr);
-      serverNetSendAll(info, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);  
-      if (serverLock == FALSE) {
+      serverNetSendAll(sc, info, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);  
+      if (sc->net->serverLock == FALSE) {
         winboloNetSendLock(FALSE);
       }
     }
-    netPlayersSetLock(&np, playerNum, FALSE);
+    netPlayersSetLock(&sc->net->np, playerNum, FALSE);
   } else if (len == BOLOPACKET_REQUEST_SIZE && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLONOALLOWNEWPLAYERS) {
     /* Client is not allowing new players */
     BYTE *ptr;
@@ -522,85 +641,86 @@ void serverNetTCPPacketArrive(BYTE *buff, int len, BYTE playerNum, unsigned long
     ptr = info;
     ptr += BOLOPACKET_REQUEST_TYPEPOS +1;
 
-    playersGetPlayerName(screenGetPlayers(), playerNum, str);
+    playersGetPlayerName(serverCoreGetPlayers(sc), playerNum, str);
     strcat(str, (char *) " is now not allowing players to join.");
     utilCtoPString(str, ptr);
     logAddEvent(log_MessageServer, 0, 0, 0, 0, 0, (char *) ptr);
-    serverNetSendAll(info, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
-    netPlayersSetLock(&np, playerNum, TRUE);
-    if (netPlayersIsLocked(&np) == TRUE) {
+    serverNetSendAll(sc, info, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
+    netPlayersSetLock(&sc->net->np, playerNum, TRUE);
+    if (netPlayersIsLocked(&sc->net->np) == TRUE) {
       /* Send out game is locked message */
       utilCtoPString((char *) "This game is now locked to new players (client lock)", ptr);
       logAddEvent(log_MessageServer, 0, 0, 0, 0, 0, (char *) ptr);
-      serverNetSendAll(info, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);   
+      serverNetSendAll(sc, info, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);   
       winboloNetSendLock(TRUE);
     }
 
   } else if (len == sizeof(ALLIANCE_PACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOREQUESTALLIANCE_DATA) {
     /* Player Request alliance */
-    serverNetSendPlayer(buff[BOLOPACKET_REQUEST_TYPEPOS+2], buff, len);
+    serverNetSendPlayer(sc, buff[BOLOPACKET_REQUEST_TYPEPOS+2], buff, len);
     logAddEvent(log_AllyRequest, buff[BOLOPACKET_REQUEST_TYPEPOS+1], buff[BOLOPACKET_REQUEST_TYPEPOS+2], 0, 0, 0, NULL);
   } else if (len == sizeof(ALLIANCE_PACKET) && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOACCEPTALLIANCE_DATA) {
     /* Player is accepted into an alliance */
-    playersAcceptAlliance(screenGetPlayers(), buff[BOLOPACKET_REQUEST_TYPEPOS+1], buff[BOLOPACKET_REQUEST_TYPEPOS+2]);
+    playersAcceptAlliance(serverCoreGetPlayers(sc), buff[BOLOPACKET_REQUEST_TYPEPOS+1], buff[BOLOPACKET_REQUEST_TYPEPOS+2]);
     winbolonetAddEvent(WINBOLO_NET_EVENT_ALLY_JOIN, TRUE, buff[BOLOPACKET_REQUEST_TYPEPOS+1], buff[BOLOPACKET_REQUEST_TYPEPOS+2]);
     logAddEvent(log_AllyAccept, buff[BOLOPACKET_REQUEST_TYPEPOS+1], buff[BOLOPACKET_REQUEST_TYPEPOS+2], 0, 0, 0, NULL);
-    serverNetSendAll(buff, len);   
+    serverNetSendAll(sc, buff, len);   
   } else if (len == BOLOPACKET_REQUEST_SIZE && buff[BOLOPACKET_REQUEST_TYPEPOS] == BOLOREQUEST_STARTPOS) {
     /* Start position request */
     BYTE *ptr;
     STARTPOSITION_PACKET spp = STARTRESPONSEHEADER;
     
-    serverCoreGetStartPosition(playerNum, &(spp.x), &(spp.y),  &(spp.angle), &(spp.numShells), &(spp.numMines));
+    serverCoreGetStartPosition(sc, playerNum, &(spp.x), &(spp.y),  &(spp.angle), &(spp.numShells), &(spp.numMines));
     ptr = info;
     ptr += BOLOPACKET_REQUEST_TYPEPOS +1;
     memcpy(info, &spp, sizeof(STARTPOSITION_PACKET));
-    serverNetSendPlayer(playerNum, info, sizeof(STARTPOSITION_PACKET));
+    serverNetSendPlayer(sc, playerNum, info, sizeof(STARTPOSITION_PACKET));
   }
-  threadsReleaseMutex();
+  serverCoreUnlock(sc);
 }
 
 /*********************************************************
 *NAME:          serverNetMakeInfoRespsonse
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 24/12/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A request for an info packet has been made. Make a 
 * response packet.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer to hold the info packet.
 *********************************************************/
-void serverNetMakeInfoRespsonse(INFO_PACKET *buff) {
+void serverNetMakeInfoRespsonse(serverCore sc, INFO_PACKET *buff) {
   char dummy[MAP_STR_SIZE]; /* Used to get the map name before conversion to pascal string */
 
   /* Make header */
   serverNetMakePacketHeader(&(buff->h), BOLOPACKET_INFORESPONSE);
   /* Make game ID */
-  buff->gameid.start_time = htonl(serverCoreGetTimeGameCreated());
-  serverTransportGetUs(&(buff->gameid.serveraddress), &(buff->gameid.serverport));
+  buff->gameid.start_time = htonl(serverCoreGetTimeGameCreated(sc));
+  serverTransportGetUs(sc, &(buff->gameid.serveraddress), &(buff->gameid.serverport));
   buff->gameid.serverport = htons(buff->gameid.serverport);
   buff->gameid.serveraddress.s_addr = 0;
   /* Get the map name and convert to a pascal string */
-  serverCoreGetMapName(dummy);
+  serverCoreGetMapName(sc, dummy);
   utilCtoPString(dummy, buff->mapname);
   
   /* Make game variables */
-  buff->gametype = serverCoreGetActualGameType();
-  if (serverCoreGetAllowHiddenMines() == TRUE) {
+  buff->gametype = serverCoreGetActualGameType(sc);
+  if (serverCoreGetAllowHiddenMines(sc) == TRUE) {
     buff->allow_mines = HIDDEN_MINES;
   } else {
     buff->allow_mines = ALL_MINES_VISIBLE;
   }
-  buff->allow_AI = allowAi;
+  buff->allow_AI = sc->net->allowAi;
   buff->spare1 = 0;
-  buff->start_delay = htonl(serverCoreGetGameStartDelay());
-  buff->time_limit = htonl(serverCoreGetGameTimeLeft());
-  buff->num_players = serverCoreGetNumPlayers();
-  buff->free_pills = serverCoreGetNumNeutralPills();
-  buff->free_bases = serverCoreGetNumNeutralBases();
-  buff->has_password = netPassword[0];
+  buff->start_delay = htonl(serverCoreGetGameStartDelay(sc));
+  buff->time_limit = htonl(serverCoreGetGameTimeLeft(sc));
+  buff->num_players = serverCoreGetNumPlayers(sc);
+  buff->free_pills = serverCoreGetNumNeutralPills(sc);
+  buff->free_bases = serverCoreGetNumNeutralBases(sc);
+  buff->has_password = sc->net->netPassword[0];
   buff->spare2 = 0;
 }
 
@@ -628,7 +748,7 @@ void serverNetMakePacketHeader(BOLOHEADER *hdr, BYTE packetType) {
 *NAME:          serverNetPlayerNumReq
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 19/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Request for a player number. Checks name isn't in use and
 * returns a new player number for the player. Sends out
@@ -636,12 +756,13 @@ void serverNetMakePacketHeader(BOLOHEADER *hdr, BYTE packetType) {
 * the game
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff    - Buffer that has arrived.
 *  len     - length of the packet
 *  addr    - Address this packet came form
 *  port    - Port this packet came from
 *********************************************************/
-void serverNetPlayerNumReq(BYTE *buff, int len, unsigned long addr, unsigned short port) {
+void serverNetPlayerNumReq(serverCore sc, BYTE *buff, int len, unsigned long addr, unsigned short port) {
   PLAYERNUM_PACKET pnp;                       /* Packet to send back to the requesting player */
   PLAYERNUM_REQ_PACKET prp;                   /* The request player number packet */
   NEWPLAYER_PACKET npp;                       /* New Player Packet */
@@ -662,7 +783,7 @@ void serverNetPlayerNumReq(BYTE *buff, int len, unsigned long addr, unsigned sho
   memset(&prp, 0, sizeof(prp));
   memcpy(&prp, buff, sizeof(prp));
   utilPtoCString(prp.password, info);
-  if (strcmp(info, netPassword) != 0) {
+  if (strcmp(info, sc->net->netPassword) != 0) {
     /* Passwords do not match */
   	return;
   }
@@ -671,7 +792,7 @@ void serverNetPlayerNumReq(BYTE *buff, int len, unsigned long addr, unsigned sho
 				    
 
   
-  if (playersNameTaken(screenGetPlayers(), info) == FALSE && prp.playerName[0] != '*') {
+  if (playersNameTaken(serverCoreGetPlayers(sc), info) == FALSE && prp.playerName[0] != '*') {
     /* Name not taken - Add to players*/
     serverNetMakePacketHeader(&(pnp.h), BOLOPACKET_PLAYERNUMRESPONSE);
     memset(&npp, 0, sizeof(npp));
@@ -681,15 +802,15 @@ void serverNetPlayerNumReq(BYTE *buff, int len, unsigned long addr, unsigned sho
     npp.addr.s_addr = addr;
 #endif
     npp.port = port;
-    pnp.playerNumber = playersGetFirstNotUsed(screenGetPlayers());
+    pnp.playerNumber = playersGetFirstNotUsed(serverCoreGetPlayers(sc));
     sAddr.sin_port=port;
 #ifdef _WIN32
     sAddr.sin_addr.S_un.S_addr = addr;
 #else
     sAddr.sin_addr.s_addr = addr;
 #endif
-    netPlayersSetPlayer(&np, pnp.playerNumber, &sAddr); 
-    netPlayersDonePassword(&np, pnp.playerNumber);
+    netPlayersSetPlayer(&sc->net->np, pnp.playerNumber, &sAddr); 
+    netPlayersDonePassword(&sc->net->np, pnp.playerNumber);
     /* Verify with wbn if playing */
     if (prp.key[0] != EMPTY_CHAR) {
       if (winboloNetVerifyClientKey(prp.key, info, pnp.playerNumber) == TRUE) {
@@ -706,11 +827,11 @@ void serverNetPlayerNumReq(BYTE *buff, int len, unsigned long addr, unsigned sho
     strcpy(ipStr, ip);
     if (strcmp(ipStr, "127.0.0.1") == 0) {
       /* The joined from localhost */
-      serverTransportGetUs(&dummyAddr, &dummyPort);
+      serverTransportGetUs(sc, &dummyAddr, &dummyPort);
       ip = inet_ntoa(dummyAddr);
     }
-    playersSetPlayer(screenGetPlayers(), pnp.playerNumber, info, ip, 0, 0, 0, 0, 0, 0, 0, NULL);
-    serverCorePlayerJoin(pnp.playerNumber);
+    playersSetPlayer(serverCoreGetPlayers(sc), pnp.playerNumber, info, ip, 0, 0, 0, 0, 0, 0, 0, NULL);
+    serverCorePlayerJoin(sc, pnp.playerNumber);
     sprintf(str, (char *) "New Player %s accepted into game.\n", info);
     screenServerConsoleMessage(str);
 
@@ -731,7 +852,7 @@ void serverNetPlayerNumReq(BYTE *buff, int len, unsigned long addr, unsigned sho
     npp.playerNumber = pnp.playerNumber;
     utilCtoPString(info, npp.playerName);
     memcpy(info, &npp, sizeof(npp));
-    serverNetSendAllExceptPlayer(npp.playerNumber, info, sizeof(npp));
+    serverNetSendAllExceptPlayer(sc, npp.playerNumber, info, sizeof(npp));
     winbolonetAddEvent(WINBOLO_NET_EVENT_PLAYER_JOIN, TRUE, npp.playerNumber, WINBOLO_NET_NO_PLAYER);
   } else {
     /* Name in use  - Just send back a incorrect packet */
@@ -740,34 +861,34 @@ void serverNetPlayerNumReq(BYTE *buff, int len, unsigned long addr, unsigned sho
 
   /* Send reply */
   memcpy(info, &pnp, sizeof(pnp));
-  serverTransportSendUDPLast(info, sizeof(pnp), TRUE);
+  serverTransportSendUDPLast(sc, info, sizeof(pnp), TRUE);
 }
 
 /*********************************************************
 *NAME:          serverNetSendPlayerLeaveGracefulMessage
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/12/03
-*LAST MODIFIED: 19/12/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends the "is quiting" message to all clients
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetSendPlayerLeaveGracefulMessage(BYTE playerNum) {
+void serverNetSendPlayerLeaveGracefulMessage(serverCore sc, BYTE playerNum) {
   BYTE buff[MAX_UDPPACKET_SIZE] = SEVERMSGHEADER;
   BYTE *ptr;
   char str[256];
   
   ptr = buff;
   ptr += BOLOPACKET_REQUEST_TYPEPOS +1;
-  playersGetPlayerName(screenGetPlayers(), playerNum, str);
+  playersGetPlayerName(serverCoreGetPlayers(sc), playerNum, str);
   strcat(str, (char *) " is quitting.");
 
   /* Send message to clients */
   utilCtoPString(str, ptr);
 //FIXME send to WBN  logAddEvent(log_MessageServer, 0, 0, 0, 0, 0, (char *) ptr);
-  serverNetSendAllExceptPlayer(playerNum, buff, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
+  serverNetSendAllExceptPlayer(sc, playerNum, buff, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
   winbolonetAddEvent(WINBOLO_NET_EVENT_QUITTING, TRUE, playerNum, WINBOLO_NET_NO_PLAYER);
   logAddEvent(log_PlayerLeaving, playerNum, 0, 0, 0, 0, NULL);
 }
@@ -776,39 +897,40 @@ void serverNetSendPlayerLeaveGracefulMessage(BYTE playerNum) {
 *NAME:          serverNetPlayerLeave
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 18/12/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Called when a TCP socket is closed indicating a player
 * has left the game. Tells all the clients about it and 
 * make slot available.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - The player number that quit
 *  graceful  - True if the player choose to quit, false
 *              if timed out
 *********************************************************/
-void serverNetPlayerLeave(BYTE playerNum, bool graceful) {
+void serverNetPlayerLeave(serverCore sc, BYTE playerNum, bool graceful) {
   PLAYERLEAVE_PACKET plp; /* Packet send to all players saying who left */
 
   /* Remove it */
-  playerNum = netPlayersRemovePlayerNum(&np, playerNum);
+  playerNum = netPlayersRemovePlayerNum(&sc->net->np, playerNum);
   if (playerNum != NEUTRAL) {
-    threadsWaitForMutex();
+    serverCoreLock(sc);
     if (graceful == TRUE) {
-      serverNetSendPlayerLeaveGracefulMessage(playerNum);
+      serverNetSendPlayerLeaveGracefulMessage(sc, playerNum);
     }
     logAddEvent(log_PlayerQuit, playerNum, 0, 0, 0, 0, NULL);
     /* Tell the other players about it */
     serverNetMakePacketHeader(&(plp.h), BOLOPACKET_PLAYERLEAVE);
     plp.playerNumber = playerNum;
-    serverNetSendAllExceptPlayer(playerNum, (BYTE *) &plp, sizeof(plp));
+    serverNetSendAllExceptPlayer(sc, playerNum, (BYTE *) &plp, sizeof(plp));
     /* Tell WinBolo.net */
-    winboloNetClientLeaveGame(playerNum, playersGetNumPlayers(screenGetPlayers()), serverCoreGetNumNeutralBases(), serverCoreGetNumNeutralPills());
+    winboloNetClientLeaveGame(playerNum, playersGetNumPlayers(serverCoreGetPlayers(sc)), serverCoreGetNumNeutralBases(sc), serverCoreGetNumNeutralPills(sc));
 
-    serverCorePlayerLeave(playerNum);
-    threadsReleaseMutex();
+    serverCorePlayerLeave(sc, playerNum);
+    serverCoreUnlock(sc);
   }
-  if (playersGetNumPlayers(screenGetPlayers()) == 0 && serverLock == FALSE) {
+  if (playersGetNumPlayers(serverCoreGetPlayers(sc)) == 0 && sc->net->serverLock == FALSE) {
     /* Unlock the game */
     winboloNetSendLock(FALSE);
   }
@@ -818,16 +940,17 @@ void serverNetPlayerLeave(BYTE playerNum, bool graceful) {
 *NAME:          serverNetPlayerDataReq
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 19/19/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A request has been made for player data packet. Process
 * it and send the reply.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff      - Buffer that has arrived.
 *  len       - length of the packet
 *********************************************************/
-void serverNetPlayerDataReq() {
+void serverNetPlayerDataReq(serverCore sc) {
   BYTE *sendBuff;
   PLAYERDATA_PACKET pdp;  /* The packet to send back */
   BYTE count;             /* Looping variable */
@@ -838,40 +961,40 @@ void serverNetPlayerDataReq() {
   sendBuff = malloc(2048);
 
   while (count < MAX_TANKS) {
-    if (playersIsInUse(screenGetPlayers(), count) == TRUE) {
+    if (playersIsInUse(serverCoreGetPlayers(sc), count) == TRUE) {
       pdp.items[count].inUse = TRUE;
-      playersGetPlayerName(screenGetPlayers(), count, sendBuff);
+      playersGetPlayerName(serverCoreGetPlayers(sc), count, sendBuff);
       utilCtoPString(sendBuff, pdp.items[count].playerName);
-      pdp.items[count].numAllies = playersMakeNetAlliences(screenGetPlayers(), count, pdp.items[count].allies);
-      netPlayersGetPlayerDataReq(&np, count, &(pdp.items[count].addr), &(pdp.items[count].port));
+      pdp.items[count].numAllies = playersMakeNetAlliences(serverCoreGetPlayers(sc), count, pdp.items[count].allies);
+      netPlayersGetPlayerDataReq(&sc->net->np, count, &(pdp.items[count].addr), &(pdp.items[count].port));
     }
     count++;
   } 
   
   memcpy(sendBuff, &pdp, sizeof(pdp));
-  serverTransportSendUDPLast(sendBuff, sizeof(pdp), TRUE);
+  serverTransportSendUDPLast(sc, sendBuff, sizeof(pdp), TRUE);
   free(sendBuff);
 }
 
 
-void serverNetSendPlayer(BYTE playerNum, BYTE *buff, int len) {
+void serverNetSendPlayer(serverCore sc, BYTE playerNum, BYTE *buff, int len) {
   BYTE crcA;
   BYTE crcB;
   udpPackets udp;
 
-  if (netPlayersGetInUse(&np, playerNum) == TRUE) {
-    udp = netPlayersGetUdpPackets(&np, playerNum);
+  if (netPlayersGetInUse(&sc->net->np, playerNum) == TRUE) {
+    udp = netPlayersGetUdpPackets(&sc->net->np, playerNum);
     buff[len] = udpPacketsGetNextOutSequenceNumber(&udp);
     CRCCalcBytes(buff, len+1, &crcA, &crcB);
 
     buff[len+1] = crcA;
     buff[len+2] = crcB;
     udpPacketsSetOutBuff(&udp, buff[len], buff, len+3);
-    serverTransportSendUDP(buff, len+3, netPlayersGetAddr(&np, playerNum));
+    serverTransportSendUDP(sc, buff, len+3, netPlayersGetAddr(&sc->net->np, playerNum));
   }
 }
 
-void serverNetSendAllExceptPlayer(BYTE playerNum, BYTE *buff, int len) {
+void serverNetSendAllExceptPlayer(serverCore sc, BYTE playerNum, BYTE *buff, int len) {
   BYTE crcA;
   BYTE crcB;
   BYTE count;
@@ -879,9 +1002,9 @@ void serverNetSendAllExceptPlayer(BYTE playerNum, BYTE *buff, int len) {
 
   count = 0;
   while (count < MAX_TANKS) {
-    if (count != playerNum && netPlayersGetInUse(&np, count) == TRUE) {
+    if (count != playerNum && netPlayersGetInUse(&sc->net->np, count) == TRUE) {
       /* Send it */
-      udp = netPlayersGetUdpPackets(&np, count);
+      udp = netPlayersGetUdpPackets(&sc->net->np, count);
 
       buff[len] = udpPacketsGetNextOutSequenceNumber(&udp);
       CRCCalcBytes(buff, len+1, &crcA, &crcB);
@@ -889,13 +1012,13 @@ void serverNetSendAllExceptPlayer(BYTE playerNum, BYTE *buff, int len) {
       buff[len+1] = crcA;
       buff[len+2] = crcB;
       udpPacketsSetOutBuff(&udp, buff[len], buff, len+3);
-      serverTransportSendUDP(buff, len+3, netPlayersGetAddr(&np, count));
+      serverTransportSendUDP(sc, buff, len+3, netPlayersGetAddr(&sc->net->np, count));
     }
     count++;
   }
 }
 
-void serverNetSendAll(BYTE *buff, int len) {
+void serverNetSendAll(serverCore sc, BYTE *buff, int len) {
   BYTE crcA;
   BYTE crcB;
   BYTE count;
@@ -903,16 +1026,16 @@ void serverNetSendAll(BYTE *buff, int len) {
 
   count = 0;
   while (count < MAX_TANKS) {
-    if (netPlayersGetInUse(&np, count) == TRUE) {
+    if (netPlayersGetInUse(&sc->net->np, count) == TRUE) {
       /* Send it */
-      udp = netPlayersGetUdpPackets(&np, count);
+      udp = netPlayersGetUdpPackets(&sc->net->np, count);
 
       buff[len] = udpPacketsGetNextOutSequenceNumber(&udp);
       CRCCalcBytes(buff, len+1, &crcA, &crcB);
       buff[len+1] = crcA;
       buff[len+2] = crcB;
       udpPacketsSetOutBuff(&udp, buff[len], buff, len+3);
-      serverTransportSendUDP(buff, len+3, netPlayersGetAddr(&np, count));
+      serverTransportSendUDP(sc, buff, len+3, netPlayersGetAddr(&sc->net->np, count));
     }
     count++;
   }
@@ -922,46 +1045,81 @@ void serverNetSendAll(BYTE *buff, int len) {
 *NAME:          serverNetChangePlayerName
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/8/99
-*LAST MODIFIED: 29/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A change of player name packet has been recieved. Send
 * it out the make the change.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - The player number it came from
 *  buff    - Buffer that has arrived.
 *********************************************************/
-void serverNetChangePlayerName(BYTE playerNum, BYTE *buff) {
+void serverNetChangePlayerName(serverCore sc, BYTE playerNum, BYTE *buff) {
   PLAYERNAMECHANGE_PACKET *pncp;
   char name[512];
 
   if (winboloNetIsPlayerParticipant(playerNum) == FALSE) {
     pncp = (PLAYERNAMECHANGE_PACKET*) buff;
     /* Send to everyone */
-    serverNetSendAllExceptPlayer(playerNum, buff, sizeof(*pncp));
+    serverNetSendAllExceptPlayer(sc, playerNum, buff, sizeof(*pncp));
     /* Process */
     utilPtoCString(pncp->playerName, name);
-    playersSetPlayerName(screenGetPlayers(), pncp->playerNum, name  );
+    playersSetPlayerName(serverCoreGetPlayers(sc), pncp->playerNum, name  );
   }
 }
 
-void serverTransportDoChecks();
-void playerNeedUpdateDone();
+/*********************************************************
+*NAME:          serverNetPublishSnapshot
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Processes waiting packets then publishes the snapshot
+* that serverNetMakePosPackets and serverNetMakeData
+* build from. Positions are only taken every third call.
+* This is the only place packet building takes the mutex.
+*
+*ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+void serverNetPublishSnapshot(serverCore sc) {
+  bool wantPos;   /* Take positions this time */
+  bool wantData;  /* Take map and event data this time */
+
+  /* Do checks */
+  serverTransportDoChecks(sc);
+
+  wantPos = FALSE;
+  wantData = FALSE;
+  sc->net->posCount++;
+  if (playersGetNumPlayers(serverCoreGetPlayers(sc)) > 0) {
+    wantData = TRUE;
+    if (sc->net->posCount >= 3) {
+      sc->net->posCount = 0;
+      wantPos = TRUE;
+    }
+  }
+
+  serverCoreLock(sc);
+  serverCorePublishSnapshot(sc, wantPos, wantData);
+  serverCoreUnlock(sc);
+}
+
 /*********************************************************
 *NAME:          serverNetMakePosPackets
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Makes and send out the positions of every person in the
-* game.
+* game from the published snapshot. Positions are sent as
+* a delta from the last frame each player acknowledged.
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetMakePosPackets(void) {
-  static int c = 0;
-  static BYTE stale = 0; /* Should we send stale packets */
+void serverNetMakePosPackets(serverCore sc) {
   char info[MAX_UDPPACKET_SIZE] = POSHEADER; /* Buffer to send */
   BYTE shellBuff[MAX_UDPPACKET_SIZE]; /* Buffer to send */
   BYTE playerBuff[MAX_UDPPACKET_SIZE]; /* Buffer to send */
@@ -971,87 +1129,66 @@ void serverNetMakePosPackets(void) {
   BYTE playerDataLen;
   BYTE count;
   bool needSend;
-  bool sendStale;
+  serverCoreSnapshot *snap; /* Snapshot to send from */
+  posDeltaFrame frame;      /* What the player can see */
 
-  /* Do checks */
-  serverTransportDoChecks();
+  snap = serverCoreGetSnapshot(sc);
+  if (snap->hasPos == FALSE || snap->seq == sc->net->netPosSent) {
+    return;
+  }
+  sc->net->netPosSent = snap->seq;
 
-  packetLen = BOLOPACKET_REQUEST_SIZE+1;
-  c++;
-  if (playersGetNumPlayers(screenGetPlayers()) > 0) {
-    if (c < 3) {
-      return;
-    }
-    c = 0;
-    stale++;
-    sendStale = FALSE;
-    if (stale == 75) {
-      stale = 0;
-      sendStale = TRUE;
-    }
-    threadsWaitForMutex();
-    serverCorePreparePosPackets();
-    threadsReleaseMutex();
-    count = 0;
-    while (count < MAX_TANKS) {
-      if (playersIsInUse(screenGetPlayers(), count) == TRUE) {
-        /* Send them a packet */
-        needSend = FALSE;
-        ptr = info;
-        ptr += BOLOPACKET_REQUEST_TYPEPOS+1;
-        packetLen = BOLOPACKET_REQUEST_SIZE+1;
-
-        threadsWaitForMutex();
-        playerDataLen = serverCoreMakePosPackets(playerBuff, count, sendStale);
-        threadsReleaseMutex();
-
-        if (playerDataLen > 0) {
-          needSend = TRUE;
-          *ptr = BOLOPACKET_MAND_DATA;
-          ptr++;
-          packetLen++;
-          *ptr = playerDataLen;
-          ptr++;
-          packetLen++;
-          memcpy(ptr, playerBuff, playerDataLen);
-          packetLen += playerDataLen;
-          ptr += playerDataLen;
-        }
+  count = 0;
+  while (count < MAX_TANKS) {
+    if (snap->inUse[count] == TRUE) {
+      /* Send them a packet */
+      needSend = FALSE;
+      ptr = info;
+      ptr += BOLOPACKET_REQUEST_TYPEPOS+1;
+      packetLen = BOLOPACKET_REQUEST_SIZE+1;
+
+      serverCoreMakePosFrame(sc, &frame, count);
+      playerDataLen = (BYTE) serverCoreMakePosDelta(sc, playerBuff, &frame, count);
+      if (playerDataLen > 0) {
+        needSend = TRUE;
+        *ptr = BOLO_PACKET_POSDELTA;
+        ptr++;
+        packetLen++;
+        *ptr = playerDataLen;
+        ptr++;
+        packetLen++;
+        memcpy(ptr, playerBuff, playerDataLen);
+        packetLen += playerDataLen;
+        ptr += playerDataLen;
+      }
+      
+      shellDataLen = serverCoreMakeShellData(sc, shellBuff, count);
+
+      /* Add shell data */
+      if (shellDataLen > 0) {
+        *ptr = BOLO_PACKET_SHELLDATA;
+        ptr++;
+        packetLen++;
+        *ptr = shellDataLen;
+        ptr++;
+        packetLen++;
+        memcpy(ptr, shellBuff, shellDataLen);
+        ptr += shellDataLen;
+        packetLen += shellDataLen;
+        needSend = TRUE;
+      } 
+
+      /* Send packet */
+      if (needSend == TRUE) {
+        BYTE crcA, crcB;
+        CRCCalcBytes(info, packetLen, &crcA, &crcB);
+        info[packetLen] = crcA;
+        info[packetLen + 1] = crcB;
         
-        threadsWaitForMutex();      
-        shellDataLen = (BYTE) serverCoreMakeShellData(shellBuff, count, FALSE);
-        threadsReleaseMutex();
-
-        /* Add shell data */
-        if (shellDataLen > 0) {
-          *ptr = BOLO_PACKET_SHELLDATA;
-          ptr++;
-          packetLen++;
-          *ptr = shellDataLen;
-          ptr++;
-          packetLen++;
-          memcpy(ptr, shellBuff, shellDataLen);
-          ptr += shellDataLen;
-          packetLen += shellDataLen;
-          needSend = TRUE;
-        } 
-
-        /* Send packet */
-        if (needSend == TRUE) {
-          BYTE crcA, crcB;
-          CRCCalcBytes(info, packetLen, &crcA, &crcB);
-          info[packetLen] = crcA;
-          info[packetLen + 1] = crcB;
-          
-          serverTransportSendUDP(info, packetLen+2, netPlayersGetAddr(&np, count));
-        }
+        serverTransportSendUDP(sc, info, packetLen+2, netPlayersGetAddr(&sc->net->np, count));
       }
-      count++;
     }
-    threadsWaitForMutex();      
-    shellDataLen = (BYTE) serverCoreMakeShellData(shellBuff, 0xFF, TRUE);
-    playerNeedUpdateDone(screenGetPlayers());
-    threadsReleaseMutex();
+    count++;
   }
 }
 
@@ -1059,17 +1196,18 @@ void serverNetMakePosPackets(void) {
 *NAME:          severNetProcessClientData
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/10/99
-*LAST MODIFIED:  21/8/00
+*LAST MODIFIED:  16/10/26
 *PURPOSE:
 * Client data has arrived. Client data consists of:
 * - Shells that have been fired.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff      - Buffer that has arrived.
 *  len       - Length of the packet.
 *  playerNum - Player number this packet belongs with
 *********************************************************/
-void severNetProcessClientData(BYTE *buff, int len, BYTE playerNum) {
+void severNetProcessClientData(serverCore sc, BYTE *buff, int len, BYTE playerNum) {
   BYTE *ptr;        /* Pointer to the Buffer   */
   BYTE sectionLen;  /* Length of the section   */
   BYTE sectionType; /* Type of the section     */
@@ -1088,20 +1226,20 @@ void severNetProcessClientData(BYTE *buff, int len, BYTE playerNum) {
     if (sectionLen > 0) {
       switch (sectionType) {
       case BOLO_PACKET_MAPDATA:
-        severCoreExtractClientMapData(ptr, sectionLen, playerNum);
+        severCoreExtractClientMapData(sc, ptr, sectionLen, playerNum);
         break;
       case BOLO_PACKET_PNBDATA:
-        serverCoreExtractPNBData(ptr, sectionLen);
+        serverCoreExtractPNBData(sc, ptr, sectionLen);
         break;
       case BOLO_PACKET_TKDATA:
-        serverCoreExtractTkExpData(ptr, sectionLen);
+        serverCoreExtractTkExpData(sc, ptr, sectionLen);
         break;
       case BOLO_PACKET_MNTDATA:
-        serverCoreExtractNMTData(ptr, sectionLen);
+        serverCoreExtractNMTData(sc, ptr, sectionLen);
         break;
       default:
       /* BOLO_PACKET_SHELLDATA */
-        serverCoreExtractShellData(ptr, sectionLen);
+        serverCoreExtractShellData(sc, ptr, sectionLen);
         break;
       }
     }
@@ -1110,114 +1248,67 @@ void severNetProcessClientData(BYTE *buff, int len, BYTE playerNum) {
   }
 }
 
+/*********************************************************
+*NAME:          serverNetAddSection
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Adds a type, length and data section to a packet if
+* there is any data. Returns the new packet length
+*
+*ARGUMENTS:
+*  ptr       - Where the section goes in the packet
+*  packetLen - Packet length so far
+*  type      - Section type
+*  data      - Section data
+*  len       - Length of the data
+*********************************************************/
+static int serverNetAddSection(BYTE *ptr, int packetLen, BYTE type, BYTE *data, BYTE len) {
+  if (len > 0) {
+    *ptr = type;
+    ptr++;
+    *ptr = len;
+    ptr++;
+    memcpy(ptr, data, len);
+    packetLen += len + 2;
+  }
+  return packetLen;
+}
+
 /*********************************************************
 *NAME:          serverNetMakeData
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/10/99
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Makes the server data to be sent to all clients.
+* Makes the server data to be sent to all clients from
+* the published snapshot.
 * Includes:
 * - Map Data
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetMakeData() {
+void serverNetMakeData(serverCore sc) {
   char info[MAX_UDPPACKET_SIZE] = DATAHEADER; /* Buffer to send */
-  BYTE *ptr;
-  BYTE *posLen;
   int packetLen;
-  bool shouldSend; /* Should we send that packet */
-  
-  packetLen = BOLOPACKET_REQUEST_SIZE+1;
-  shouldSend = FALSE;
-  if (playersGetNumPlayers(screenGetPlayers()) > 0) {
-    ptr = info;
-    ptr += BOLOPACKET_REQUEST_TYPEPOS+1;
-    *ptr = BOLO_PACKET_MAPDATA;
-    ptr++;
-    packetLen++;
-    posLen = ptr;
-    ptr++;
-    threadsWaitForMutex();
-    *posLen = serverCoreMakeMapData(ptr);
-    threadsReleaseMutex();
-    ptr += *posLen;
-    packetLen += *posLen;
-    if (*posLen > 0) {
-      shouldSend = TRUE;
-    } else {
-      ptr--;
-      ptr--;
-      packetLen--;
-      packetLen--;
-    }
-
-    *ptr = BOLO_PACKET_TKDATA;
-    ptr++;
-    packetLen++;
-    posLen = ptr;
-    ptr++;
-    packetLen++;
-    threadsWaitForMutex();
-    *posLen = (BYTE) serverCoreMakeTkData(ptr);
-    threadsReleaseMutex();
-    ptr += *posLen;
-    packetLen += *posLen;
-    if (*posLen > 0) {
-      shouldSend = TRUE;
-    } else {
-      ptr--;
-      ptr--;
-      packetLen--;
-      packetLen--;
-    }
+  serverCoreSnapshot *snap; /* Snapshot to send from */
 
+  snap = serverCoreGetSnapshot(sc);
+  if (snap->hasData == FALSE || snap->seq == sc->net->netDataSent) {
+    return;
+  }
+  sc->net->netDataSent = snap->seq;
 
-    *ptr = BOLO_PACKET_PNBDATA;
-    ptr++;
-    packetLen++;
-    posLen = ptr;
-    ptr++;
-    packetLen++;
-    threadsWaitForMutex();
-    *posLen = (BYTE) netPNBMake(screenGetNetPnb(), ptr);
-    threadsReleaseMutex();
-    ptr += *posLen;
-    packetLen += *posLen;
-    if (*posLen > 0) {
-      shouldSend = TRUE;
-    }else {
-      ptr--;
-      ptr--;
-      packetLen--;
-      packetLen--;
-    }
+  packetLen = BOLOPACKET_REQUEST_TYPEPOS+1;
+  packetLen = serverNetAddSection((BYTE *) info + packetLen, packetLen, BOLO_PACKET_MAPDATA, snap->mapData, snap->mapLen);
+  packetLen = serverNetAddSection((BYTE *) info + packetLen, packetLen, BOLO_PACKET_TKDATA, snap->tkData, snap->tkLen);
+  packetLen = serverNetAddSection((BYTE *) info + packetLen, packetLen, BOLO_PACKET_PNBDATA, snap->pnbData, snap->pnbLen);
+  packetLen = serverNetAddSection((BYTE *) info + packetLen, packetLen, BOLO_PACKET_MNTDATA, snap->mntData, snap->mntLen);
 
-   *ptr = BOLO_PACKET_MNTDATA;
-    ptr++;
-    packetLen++;
-    posLen = ptr;
-    ptr++;
-    packetLen++;
-    threadsWaitForMutex();
-    *posLen = (BYTE) netMNTMake(screenGetNetMnt(), ptr);
-    threadsReleaseMutex();
-    ptr += *posLen;
-    packetLen += *posLen;
-    if (*posLen > 0) {
-      shouldSend = TRUE;
-    } else {
-      ptr--;
-      ptr--;
-      packetLen--;
-      packetLen--;
-    }
-
-    if (shouldSend == TRUE) {
-      serverNetSendAll(info, packetLen);
-    }
+  if (packetLen > BOLOPACKET_REQUEST_TYPEPOS+1) {
+    serverNetSendAll(sc, info, packetLen);
   }
 }
 
@@ -1225,24 +1316,24 @@ void serverNetMakeData() {
 *NAME:          serverNetSendTrackerUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/12/99
-*LAST MODIFIED: 22/12/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Called when it is time to send the tracker an updated
 * game snapshot
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetSendTrackerUpdate() {
+void serverNetSendTrackerUpdate(serverCore sc) {
   INFO_PACKET h; /* Packet to send */
   struct in_addr dumb;
   unsigned short port;
 
-  if (netUseTracker == TRUE) {
-    serverNetMakeInfoRespsonse(&h);
-    serverTransportGetUs(&dumb, &port);
+  if (sc->net->netUseTracker == TRUE) {
+    serverNetMakeInfoRespsonse(sc, &h);
+    serverTransportGetUs(sc, &dumb, &port);
     h.gameid.serverport = port;
-    serverTransportSendUdpTracker((char *) &h, sizeof(h));
+    serverTransportSendUdpTracker(sc, (char *) &h, sizeof(h));
   }
 }
 
@@ -1253,14 +1344,15 @@ void serverNetSendTrackerUpdate() {
 *NAME:          serverNetSetLock
 *AUTHOR:        John Morrison
 *CREATION DATE: 1/6/00
-*LAST MODIFIED: 1/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets whether the server lock is on or off
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  lockState - The state to set to 
 *********************************************************/
-void serverNetSetLock(bool lockState) {
+void serverNetSetLock(serverCore sc, bool lockState) {
   BYTE buff[MAX_UDPPACKET_SIZE] = SEVERMSGHEADER;
   BYTE *ptr;
   
@@ -1269,25 +1361,25 @@ void serverNetSetLock(bool lockState) {
 
   if (lockState == TRUE) {
     screenServerConsoleMessage((char *) "This game is now locked to new players (server lock)");
-    if (serverLock != lockState) {
+    if (sc->net->serverLock != lockState) {
       /* Send message to clients */
       utilCtoPString((char *) "This game is now locked to new players (server lock)", ptr);
       logAddEvent(log_MessageServer, 0, 0, 0, 0, 0, (char *) ptr);
-      serverNetSendAll(buff, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
+      serverNetSendAll(sc, buff, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
       winboloNetSendLock(TRUE);
     }
-    serverLock = TRUE;
+    sc->net->serverLock = TRUE;
   } else {
     /* Unlock */
     screenServerConsoleMessage((char *) "This game is now unlocked to new players (server unlock)");
-    if (serverLock != lockState) {
+    if (sc->net->serverLock != lockState) {
       /* Send message to clients */
       utilCtoPString((char *) "This game is now unlocked to new players (server unlock)", ptr);
       logAddEvent(log_MessageServer, 0, 0, 0, 0, 0, (char *) ptr);
-      serverNetSendAll(buff, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
+      serverNetSendAll(sc, buff, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
       winboloNetSendLock(FALSE);
     }
-    serverLock = FALSE;
+    sc->net->serverLock = FALSE;
   }
 }
 
@@ -1295,20 +1387,20 @@ void serverNetSetLock(bool lockState) {
 *NAME:          serverNetIsGameLocked
 *AUTHOR:        John Morrison
 *CREATION DATE: 1/6/00
-*LAST MODIFIED: 1/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns whether the game is locked or not
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-bool serverNetIsGameLocked() {
+bool serverNetIsGameLocked(serverCore sc) {
   bool returnValue; /* Value to return */
 
-  returnValue = serverLock;
+  returnValue = sc->net->serverLock;
   if (returnValue == FALSE) {
-    if (playersGetNumPlayers(screenGetPlayers()) > 0) {
-      returnValue = netPlayersIsLocked(&np);
+    if (playersGetNumPlayers(serverCoreGetPlayers(sc)) > 0) {
+      returnValue = netPlayersIsLocked(&sc->net->np);
     }
   }
 
@@ -1319,14 +1411,14 @@ bool serverNetIsGameLocked() {
 *NAME:          serverNetSendQuitMessage
 *AUTHOR:        John Morrison
 *CREATION DATE: 1/6/00
-*LAST MODIFIED: 1/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends the quit message to all clients
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetSendQuitMessage() {
+void serverNetSendQuitMessage(serverCore sc) {
   BYTE buff[MAX_UDPPACKET_SIZE] = SEVERMSGHEADER;
   BYTE *ptr;
   
@@ -1335,26 +1427,27 @@ void serverNetSendQuitMessage() {
   /* Send message to clients */
   utilCtoPString((char *) "Server received quit message", ptr);
   logAddEvent(log_MessageServer, 0, 0, 0, 0, 0, (char *) ptr);
-  serverNetSendAll(buff, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
+  serverNetSendAll(sc, buff, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
   buff[BOLOPACKET_REQUEST_TYPEPOS] = BOLOPACKET_PACKETQUIT;
-  serverNetSendAll(buff, BOLOPACKET_REQUEST_SIZE);
+  serverNetSendAll(sc, buff, BOLOPACKET_REQUEST_SIZE);
 }
 
 /*********************************************************
 *NAME:          serverNetSendManReturnMessge
 *AUTHOR:        John Morrison
 *CREATION DATE: 2/12/00
-*LAST MODIFIED: 2/12/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends the man has return packet to playerNum
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Player number to send to.
 *  numTrees  - Amount of trees lgm is carrying
 *  numMines  - Amount of mines the lgm is carrying
 *  pillNum   - Pillbox being carries
 *********************************************************/
-void serverNetSendManReturnMessge(BYTE playerNum, BYTE numTrees, BYTE numMines, BYTE pillNum) {
+void serverNetSendManReturnMessge(serverCore sc, BYTE playerNum, BYTE numTrees, BYTE numMines, BYTE pillNum) {
   BYTE sendBuff[sizeof(LGMRETURN_PACKET) + 3];
   LGMRETURN_PACKET buff = LGMRETURNHEADER;
   buff.numMines = numMines;
@@ -1362,10 +1455,10 @@ void serverNetSendManReturnMessge(BYTE playerNum, BYTE numTrees, BYTE numMines,
   buff.numTrees = numTrees;
 
   memcpy(sendBuff, &buff, sizeof(LGMRETURN_PACKET));
-  serverNetSendPlayer(playerNum, sendBuff, sizeof(buff));
+  serverNetSendPlayer(sc, playerNum, sendBuff, sizeof(buff));
 }
 
-void serverNetSendManWorkingMessage(BYTE playerNum, BYTE mapX, BYTE mapY, BYTE numMines, BYTE numTrees, BYTE pillNum) {
+void serverNetSendManWorkingMessage(serverCore sc, BYTE playerNum, BYTE mapX, BYTE mapY, BYTE numMines, BYTE numTrees, BYTE pillNum) {
   BYTE sendBuff[sizeof(LGMMOVE_PACKET) + 3];
   LGMMOVE_PACKET buff = LGMWORKINGHEADER;
   buff.mapX = mapX;
@@ -1375,37 +1468,37 @@ void serverNetSendManWorkingMessage(BYTE playerNum, BYTE mapX, BYTE mapY, BYTE n
   buff.trees = numTrees;
 
   memcpy(sendBuff, &buff, sizeof(LGMMOVE_PACKET));
-  serverNetSendPlayer(playerNum, sendBuff, sizeof(buff));
+  serverNetSendPlayer(sc, playerNum, sendBuff, sizeof(buff));
 }
 
 /*********************************************************
 *NAME:          serverNetCheckRemovePlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 2/08/02
-*LAST MODIFIED: 2/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends the man has return packet to playerNum
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - Player number to send to.
 *  numTrees  - Amount of trees lgm is carrying
 *  numMines  - Amount of mines the lgm is carrying
 *  pillNum   - Pillbox being carries
 *********************************************************/
-void serverNetCheckRemovePlayers() {
-  static time_t lastCheck = 0; /* Time between removing players */
+void serverNetCheckRemovePlayers(serverCore sc) {
   BYTE count;                  /* Looping Variable */
 
-  if (time(NULL) - lastCheck >= SERVER_NET_REMOVE_CHECKTIME) {
+  if (time(NULL) - sc->net->lastCheck >= SERVER_NET_REMOVE_CHECKTIME) {
     count = 0;
     while (count < MAX_TANKS) {
-      if (netPlayersShouldDisconnectPlayer(&np, count) == TRUE) {
+      if (netPlayersShouldDisconnectPlayer(&sc->net->np, count) == TRUE) {
         /* Disconnect them */
-        serverNetPlayerLeave(count, FALSE);
+        serverNetPlayerLeave(sc, count, FALSE);
       }
       count++;
     }
-    lastCheck = time(NULL);
+    sc->net->lastCheck = time(NULL);
   }
 }
 
@@ -1413,15 +1506,16 @@ void serverNetCheckRemovePlayers() {
 *NAME:          serverNetSendserverMessageAllPlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 2/08/02
-*LAST MODIFIED: 2/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends a server message to all players 
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  msg - Message to send 
 *********************************************************/
-void serverNetSendServerMessageAllPlayers(char *msg) {
-  static char info[MAX_UDPPACKET_SIZE] = GENERICHEADER; /* Buffer to send */
+void serverNetSendServerMessageAllPlayers(serverCore sc, char *msg) {
+  char info[MAX_UDPPACKET_SIZE] = GENERICHEADER; /* Buffer to send */
   BYTE *ptr; /* Data Ptr */
   int len; /* Line length */
   info[BOLOPACKET_REQUEST_TYPEPOS] = BOLOSERVERMESSAGE; 
@@ -1436,43 +1530,43 @@ void serverNetSendServerMessageAllPlayers(char *msg) {
   }
   utilCtoPString(msg, ptr);
   logAddEvent(log_MessageServer, 0, 0, 0, 0, 0, (char *) ptr);
-  serverNetSendAll(info, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
+  serverNetSendAll(sc, info, BOLOPACKET_REQUEST_SIZE +(*ptr)+1);
 }
 
 /*********************************************************
 *NAME:          serverNetGetMaxPlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/11/03
-*LAST MODIFIED: 19/11/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the maximum number of players allowed on this
 * server
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverNetGetMaxPlayers() {
-  return snMaxPlayers;
+BYTE serverNetGetMaxPlayers(serverCore sc) {
+  return sc->net->snMaxPlayers;
 }
 
 /*********************************************************
 *NAME:          serverNetGetIsLocked
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/11/03
-*LAST MODIFIED: 19/11/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns if the game is locked or not.
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-bool serverNetGetIsLocked() {
+bool serverNetGetIsLocked(serverCore sc) {
 	bool returnValue; /* Value to return */
   BYTE numPlayers; /* Number of players in this game */
 
   returnValue = FALSE;
-  numPlayers = playersGetNumPlayers(screenGetPlayers());
-	if (serverLock == TRUE || (numPlayers > 0 && netPlayersIsLocked(&np) == TRUE)) {
+  numPlayers = playersGetNumPlayers(serverCoreGetPlayers(sc));
+	if (sc->net->serverLock == TRUE || (numPlayers > 0 && netPlayersIsLocked(&sc->net->np) == TRUE)) {
     returnValue = TRUE;
   }
 
@@ -1483,22 +1577,23 @@ bool serverNetGetIsLocked() {
 *NAME:          serverNetGetUs
 *AUTHOR:        John Morrison
 *CREATION DATE: 16/08/04
-*LAST MODIFIED: 16/08/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Gets the servers IP address and port
 *
 *ARGUMENTS:
+*  sc - Game to use
 * buff - 4 byte buffer for IP bytes
 * port - Port to copy to
 *********************************************************/
-void serverNetGetUs(BYTE *buff, unsigned short *port) {
+void serverNetGetUs(serverCore sc, BYTE *buff, unsigned short *port) {
   struct in_addr dest;
   char *ip;
   char *current;
 
   
 
-  serverTransportGetUs(&dest, port);
+  serverTransportGetUs(sc, &dest, port);
   ip = inet_ntoa(dest);
   current = strtok(ip, ".");
   buff[0] = (BYTE) atoi(current);
@@ -1509,3 +1604,48 @@ void serverNetGetUs(BYTE *buff, unsigned short *port) {
   current = strtok(NULL, ".");
   buff[3] = (BYTE) atoi(current);
 }
+
+/*********************************************************
+*NAME:          serverNetPrintPacketMemory
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Prints the memory kept for reliable packet resends
+*
+*ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+void serverNetPrintPacketMemory(serverCore sc) {
+  char buff[256];   /* Line to print */
+  udpPackets udp;   /* Player's packets */
+  int numPlayers;   /* Players in use */
+  int inUse;        /* Packet bytes kept */
+  int reserved;     /* Arena bytes held */
+  int playerInUse;  /* Packet bytes kept for a player */
+  int playerArena;  /* Arena bytes held for a player */
+  int held;         /* Arena bytes handed out by the pool */
+  int pooled;       /* Arena bytes waiting in the pool */
+  BYTE count;       /* Looping variable */
+
+  numPlayers = 0;
+  inUse = 0;
+  reserved = 0;
+  serverCoreLock(sc);
+  for (count=0;count<MAX_TANKS;count++) {
+    if (netPlayersGetInUse(&sc->net->np, count) == TRUE) {
+      udp = netPlayersGetUdpPackets(&sc->net->np, count);
+      udpPacketsGetMemory(&udp, &playerInUse, &playerArena);
+      inUse += playerInUse;
+      reserved += playerArena;
+      numPlayers++;
+    }
+  }
+  serverCoreUnlock(sc);
+  udpPacketsGetPoolMemory(&held, &pooled);
+
+  sprintf(buff, "Reliable packets: %d players, %d bytes in use, %d bytes reserved", numPlayers, inUse, reserved);
+  screenServerConsoleMessage(buff);
+  sprintf(buff, "  pool %d bytes out, %d bytes free", held, pooled);
+  screenServerConsoleMessage(buff);
+}
@@ -30,6 +30,8 @@
 
 #include "../bolo/global.h"
 #include "../bolo/backend.h"
+#include "../bolo/netplayers.h"
+#include "servercore.h"
 
 #ifdef _WIN32
   #include <winsock.h>
@@ -295,12 +297,13 @@ typedef struct {
 *NAME:          serverNetCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/08/99
-*LAST MODIFIED: 27/02/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets the network kind of game being played and sets up
 * udp
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  myPort   - UDP port on this machine
 *  password - Password to use to verify joins
 *  ai       - Ai Type of the game (allow/disallow/adv)
@@ -311,20 +314,20 @@ typedef struct {
 *  maxPlayers  - Max players this server can handle (0 for
 *                unlimited)
 *********************************************************/
-bool serverNetCreate(unsigned short myPort, char *password, aiType ai, char *trackerAddr, unsigned short trackerPort, bool useTracker, char *useAddr, BYTE maxPlayers);
+bool serverNetCreate(serverCore sc, unsigned short myPort, char *password, aiType ai, char *trackerAddr, unsigned short trackerPort, bool useTracker, char *useAddr, BYTE maxPlayers);
 
 /*********************************************************
 *NAME:          serverNetDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Shuts down the network. Shutsdown transport as well.
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetDestroy(void);
+void serverNetDestroy(serverCore sc);
 
 /*********************************************************
 *NAME:          netGetType
@@ -371,34 +374,36 @@ void netCheckLast(void);
 *NAME:          serverNetUDPPacketArrive
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/08/99
-*LAST MODIFIED: 19/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A UDP packet has arrived. It is processed here.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff  - Buffer that has arrived.
 *  len   - length of the packet
 *  addr  - Address long
 *  port  - The port the last packet came in on
 *********************************************************/
-void serverNetUDPPacketArrive(BYTE *buff, int len, unsigned long addr, unsigned short port);
+void serverNetUDPPacketArrive(serverCore sc, BYTE *buff, int len, unsigned long addr, unsigned short port);
 
 /*********************************************************
 *NAME:          serverNetTCPPacketArrive
 *AUTHOR:        John Morrison
 *CREATION DATE: 27/08/99
-*LAST MODIFIED: 19/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A UDP packet has arrived. It is processed here.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff      - Buffer that has arrived.
 *  len       - length of the packet
 *  playerNum - The player number packet came from
 *  addr  - Address long
 *  port  - The port the last packet came in on
 *********************************************************/
-void serverNetTCPPacketArrive(BYTE *buff, int len, BYTE playerNum, unsigned long addr, unsigned short port);
+void serverNetTCPPacketArrive(serverCore sc, BYTE *buff, int len, BYTE playerNum, unsigned long addr, unsigned short port);
 
 
 /*********************************************************
@@ -419,15 +424,16 @@ bool netPacketTokenArrive(void);
 *NAME:          serverNetMakeInfoRespsonse
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A request for an info packet has been made. Make a 
 * response packet.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff - Buffer to hold the info packet.
 *********************************************************/
-void serverNetMakeInfoRespsonse(INFO_PACKET *buff);
+void serverNetMakeInfoRespsonse(serverCore sc, INFO_PACKET *buff);
 
 /*********************************************************
 *NAME:          serverNetMakePacketHeader
@@ -730,7 +736,7 @@ void netSeenBefore(BYTE *buff, int len);
 *NAME:          serverNetPlayerNumReq
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 19/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Request for a player number. Checks name isn't in use and
 * returns a new player number for the player. Sends out
@@ -738,233 +744,302 @@ void netSeenBefore(BYTE *buff, int len);
 * the game
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff    - Buffer that has arrived.
 *  len     - length of the packet
 *  addr    - Address this packet came form
 *  port    - Port this packet came from
 *********************************************************/
-void serverNetPlayerNumReq(BYTE *buff, int len, unsigned long addr, unsigned short port);
+void serverNetPlayerNumReq(serverCore sc, BYTE *buff, int len, unsigned long addr, unsigned short port);
 
 /*********************************************************
 *NAME:          serverNetPlayerLeave
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 18/12/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Called when a TCP socket is closed indicating a player
 * has left the game. Tells all the clients about it and 
 * make slot available.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  playerNum - The player number that quit
 *  graceful  - True if the player choose to quit, false
 *              if timed out
 *********************************************************/
-void serverNetPlayerLeave(BYTE playerNum, bool graceful);
+void serverNetPlayerLeave(serverCore sc, BYTE playerNum, bool graceful);
 
 /*********************************************************
 *NAME:          serverNetPlayerDataReq
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/08/99
-*LAST MODIFIED: 19/19/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A request has been made for player data packet. Process
 * it and send the reply.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff      - Buffer that has arrived.
 *  len       - length of the packet
 *********************************************************/
-void serverNetPlayerDataReq();
+void serverNetPlayerDataReq(serverCore sc);
 
 /*********************************************************
 *NAME:          serverNetChangePlayerName
 *AUTHOR:        John Morrison
 *CREATION DATE: 29/8/99
-*LAST MODIFIED: 29/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * A change of player name packet has been recieved. Send
 * it out the make the change.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  sockNum - The socket it came from
 *  buff    - Buffer that has arrived.
 *********************************************************/
-void serverNetChangePlayerName(BYTE sockNum, BYTE *buff);
+void serverNetChangePlayerName(serverCore sc, BYTE sockNum, BYTE *buff);
+
+/*********************************************************
+*NAME:          serverNetPublishSnapshot
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Processes waiting packets then publishes the snapshot
+* that serverNetMakePosPackets and serverNetMakeData
+* build from. Positions are only taken every third call.
+* This is the only place packet building takes the mutex.
+*
+*ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+void serverNetPublishSnapshot(serverCore sc);
 
 /*********************************************************
 *NAME:          serverNetMakePosPackets
 *AUTHOR:        John Morrison
 *CREATION DATE: 31/8/99
-*LAST MODIFIED: 31/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Makes and send out the positions of every person in the
-* game.
+* game from the published snapshot.
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetMakePosPackets(void);
+void serverNetMakePosPackets(serverCore sc);
 
 /*********************************************************
 *NAME:          severNetProcessClientData
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/10/99
-*LAST MODIFIED:  21/8/00
+*LAST MODIFIED:  16/10/26
 *PURPOSE:
 * Client data has arrived. Client data consists of:
 * - Shells that have been fired.
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  buff      - Buffer that has arrived.
 *  len       - Length of the packet.
 *  playerNum - Player number this packet belongs with
 *********************************************************/
-void severNetProcessClientData(BYTE *buff, int len, BYTE playerNum);
+void severNetProcessClientData(serverCore sc, BYTE *buff, int len, BYTE playerNum);
 
 /*********************************************************
 *NAME:          severNetProcessClientData
 *AUTHOR:        John Morrison
 *CREATION DATE: 30/10/99
-*LAST MODIFIED: 30/10/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Makes the server data to be sent to all clients.
+* Makes the server data to be sent to all clients from
+* the published snapshot.
 * Includes:
 * - Map Data
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetMakeData();
+void serverNetMakeData(serverCore sc);
 
 /*********************************************************
 *NAME:          serverNetSendTrackerUpdate
 *AUTHOR:        John Morrison
 *CREATION DATE: 22/12/99
-*LAST MODIFIED: 22/12/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Called when it is time to send the tracker an updated
 * game snapshot
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetSendTrackerUpdate();
+void serverNetSendTrackerUpdate(serverCore sc);
 
 /*********************************************************
 *NAME:          serverNetSetLock
 *AUTHOR:        John Morrison
 *CREATION DATE: 1/6/00
-*LAST MODIFIED: 1/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets whether the server lock is on or off
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  lockState - The state to set to 
 *********************************************************/
-void serverNetSetLock(bool lockState);
+void serverNetSetLock(serverCore sc, bool lockState);
 
 /*********************************************************
 *NAME:          serverNetIsGameLocked
 *AUTHOR:        John Morrison
 *CREATION DATE: 1/6/00
-*LAST MODIFIED: 1/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns whether the game is locked or not
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-bool serverNetIsGameLocked();
+bool serverNetIsGameLocked(serverCore sc);
 
 /*********************************************************
 *NAME:          serverNetSendQuitMessage
 *AUTHOR:        John Morrison
 *CREATION DATE: 1/6/00
-*LAST MODIFIED: 1/6/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends the quit message to all clients
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-void serverNetSendQuitMessage();
+void serverNetSendQuitMessage(serverCore sc);
 
-void serverNetSendAllExceptPlayer(BYTE playerNum, BYTE *buff, int len);
-void serverNetSendPlayer(BYTE playerNum, BYTE *buff, int len);
-void serverNetSendAll(BYTE *buff, int len);
+void serverNetSendAllExceptPlayer(serverCore sc, BYTE playerNum, BYTE *buff, int len);
+void serverNetSendPlayer(serverCore sc, BYTE playerNum, BYTE *buff, int len);
+void serverNetSendAll(serverCore sc, BYTE *buff, int len);
 
 /*********************************************************
 *NAME:          serverNetCheckRemovePlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 2/08/02
-*LAST MODIFIED: 2/08/02
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Sends the man has return packet to playerNum
+*
+*ARGUMENTS:
+*  sc - Game to use
+*  playerNum - Player number to send to.
+*  numTrees  - Amount of trees lgm is carrying
+*  numMines  - Amount of mines the lgm is carrying
+*  pillNum   - Pillbox being carries
+*********************************************************/
+void serverNetCheckRemovePlayers(serverCore sc);
+
+void serverNetSendManWorkingMessage(serverCore sc, BYTE playerNum, BYTE mapX, BYTE mapY, BYTE numMines, BYTE numTrees, BYTE pillNum);
+
+/*********************************************************
+*NAME:          serverNetSendManReturnMessge
+*AUTHOR:        John Morrison
+*CREATION DATE: 2/12/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends the man has return packet to playerNum
 *
 *ARGUMENTS:
+*  sc        - Game to use
 *  playerNum - Player number to send to.
 *  numTrees  - Amount of trees lgm is carrying
 *  numMines  - Amount of mines the lgm is carrying
 *  pillNum   - Pillbox being carries
 *********************************************************/
-void serverNetCheckRemovePlayers();
+void serverNetSendManReturnMessge(serverCore sc, BYTE playerNum, BYTE numTrees, BYTE numMines, BYTE pillNum);
 
-void serverNetSendManWorkingMessage(BYTE playerNum, BYTE mapX, BYTE mapY, BYTE numMines, BYTE numTrees, BYTE pillNum);
+/*********************************************************
+*NAME:          serverNetGetNetPlayers
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Returns the network status of the game's players
+*
+*ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+netPlayers *serverNetGetNetPlayers(serverCore sc);
 
 /*********************************************************
 *NAME:          serverNetSendserverMessageAllPlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 2/08/02
-*LAST MODIFIED: 2/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends a server message to all players 
 *
 *ARGUMENTS:
+*  sc - Game to use
 *  msg - Message to send 
 *********************************************************/
-void serverNetSendServerMessageAllPlayers(char *msg);
+void serverNetSendServerMessageAllPlayers(serverCore sc, char *msg);
 
 /*********************************************************
 *NAME:          serverNetGetMaxPlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/11/03
-*LAST MODIFIED: 19/11/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns the maximum number of players allowed on this
 * server
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-BYTE serverNetGetMaxPlayers();
+BYTE serverNetGetMaxPlayers(serverCore sc);
 
 /*********************************************************
 *NAME:          serverNetGetIsLocked
 *AUTHOR:        John Morrison
 *CREATION DATE: 19/11/03
-*LAST MODIFIED: 19/11/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Returns if the game is locked or not.
 *
 *ARGUMENTS:
-*
+*  sc - Game to use
 *********************************************************/
-bool serverNetGetIsLocked();
+bool serverNetGetIsLocked(serverCore sc);
 
 /*********************************************************
 *NAME:          serverNetGetUs
 *AUTHOR:        John Morrison
 *CREATION DATE: 16/08/04
-*LAST MODIFIED: 16/08/04
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Gets the servers IP address and port
 *
 *ARGUMENTS:
+*  sc - Game to use
 * buff - 4 byte buffer for IP bytes
 * port - Port to copy to
 *********************************************************/
-void serverNetGetUs(BYTE *buff, unsigned short *port);
+void serverNetGetUs(serverCore sc, BYTE *buff, unsigned short *port);
+
+/*********************************************************
+*NAME:          serverNetPrintPacketMemory
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Prints the memory kept for reliable packet resends
+*
+*ARGUMENTS:
+*  sc - Game to use
+*********************************************************/
+void serverNetPrintPacketMemory(serverCore sc);
 
 #pragma pack(pop, enter_servernet_obj,1)
 
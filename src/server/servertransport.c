@@ -20,7 +20,7 @@
 *Filename:      serverTransport.c
 *Author:        John Morrison
 *Creation Date: 11/8/99
-*Last Modified: 12/1/00
+*Last Modified: 16/10/26
 *Purpose:
 *  WinBolo Server Transport layer.
 *********************************************************/
@@ -54,12 +54,14 @@ typedef int SOCKET;
 #include "servercore.h"
 
 
-SOCKET sockUdp = INVALID_SOCKET; /* Our UDP socket */
-
-struct sockaddr_in addrUs;      /* Our own machine */
-unsigned short myPort;          /* Our UDP Port number */
-struct sockaddr_in addrLast;    /* Where the last packet came from */
-struct sockaddr_in addrTracker; /* Tracker machine */
+/* A game's UDP socket */
+struct serverTransportObj {
+  SOCKET sockUdp;                 /* Our UDP socket */
+  struct sockaddr_in addrUs;      /* Our own machine */
+  unsigned short myPort;          /* Our UDP Port number */
+  struct sockaddr_in addrLast;    /* Where the last packet came from */
+  struct sockaddr_in addrTracker; /* Tracker machine */
+};
 
 
 static unsigned long getaddrbyany(char *sp_name)  {               
@@ -85,16 +87,17 @@ static unsigned long getaddrbyany(char *sp_name)  {
 *NAME:          serverTransportCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 11/8/99
-*LAST MODIFIED: 10/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Creates the new servers transport layer. Returns FALSE 
-*  if an error occured
+*  Creates the new servers transport layer for a game.
+*  Returns FALSE if an error occured
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 * port      - Port to run server on.
 * addrToUse - The address to use if not NULL
 *********************************************************/
-bool serverTransportCreate(unsigned short port, char *addrToUse) {
+bool serverTransportCreate(serverCore sc, unsigned short port, char *addrToUse) {
   bool returnValue = TRUE; /* Value to return */
   int ret;                 /* Function returns */
   struct sockaddr_in addr; /* Socket structure */
@@ -103,8 +106,15 @@ bool serverTransportCreate(unsigned short port, char *addrToUse) {
 
   screenServerConsoleMessage((char *) "Server Transport Startup");
 
+  New(sc->transport);
+  if (sc->transport == NULL) {
+    returnValue = FALSE;
+  } else {
+    sc->transport->sockUdp = INVALID_SOCKET;
+  }
+
   if (returnValue == TRUE) {
-    myPort = port;
+    sc->transport->myPort = port;
     addr.sin_family = AF_INET;
     addr.sin_port = htons(port);
     addr.sin_addr.s_addr = INADDR_ANY;
@@ -118,8 +128,8 @@ bool serverTransportCreate(unsigned short port, char *addrToUse) {
 
   /* Create Sockets */
   if (returnValue == TRUE) {    
-    sockUdp = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (sockUdp == INVALID_SOCKET) {
+    sc->transport->sockUdp = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sc->transport->sockUdp == INVALID_SOCKET) {
       fprintf(stderr, "Error Creating UDP Socket\n");
       returnValue = FALSE;
     }
@@ -127,7 +137,7 @@ bool serverTransportCreate(unsigned short port, char *addrToUse) {
 
   /* Binding */
   if (returnValue == TRUE) {
-    ret = bind(sockUdp, (struct sockaddr *)&addr, sizeof(addr));
+    ret = bind(sc->transport->sockUdp, (struct sockaddr *)&addr, sizeof(addr));
     if (ret < 0) {
       fprintf(stderr, "Error Binding UDP Socket\n");
       returnValue = FALSE;
@@ -138,7 +148,7 @@ bool serverTransportCreate(unsigned short port, char *addrToUse) {
   /* Set to non blocking */
   if (returnValue == TRUE) {
     noBlock = NO_BLOCK_SOCK;
-    ret = fcntl(sockUdp, F_SETFL, O_NONBLOCK | fcntl(sockUdp, F_GETFL));
+    ret = fcntl(sc->transport->sockUdp, F_SETFL, O_NONBLOCK | fcntl(sc->transport->sockUdp, F_GETFL));
     if (ret == SOCKET_ERROR) {
       returnValue = FALSE;
     }
@@ -152,19 +162,24 @@ bool serverTransportCreate(unsigned short port, char *addrToUse) {
 *NAME:          serverTransportDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 11/8/99
-*LAST MODIFIED: 11/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Shuts down the server transport subsystem.
 *
 *ARGUMENTS:
-*
+*  sc - Game the socket belongs to
 *********************************************************/
-void serverTransportDestroy() {
+void serverTransportDestroy(serverCore sc) {
 
   screenServerConsoleMessage((char *) "Server Transport Shutdown");
-  shutdown(sockUdp, SD_BOTH);
-  closesocket(sockUdp);
-  sockUdp = INVALID_SOCKET;
+  if (sc->transport != NULL) {
+    if (sc->transport->sockUdp != INVALID_SOCKET) {
+      shutdown(sc->transport->sockUdp, SD_BOTH);
+      closesocket(sc->transport->sockUdp);
+    }
+    Dispose(sc->transport);
+    sc->transport = NULL;
+  }
 }
 
 
@@ -172,45 +187,61 @@ void serverTransportDestroy() {
 *NAME:          serverTransportListenUDP
 *AUTHOR:        John Morrison
 *CREATION DATE: 13/8/99
-*LAST MODIFIED: 13/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Listens for incoming UDP packets and processes them. 
 *  Function exits upon an error caused by the sockUdp 
 *  being closed.
 *
 *ARGUMENTS:
-*
+*  sc - Game the socket belongs to
 *********************************************************/
-void serverTransportListenUDP(void) {
+void serverTransportListenUDP(serverCore sc) {
   BYTE info[512 /*MAX_PACKET_SIZE */];  /* The packet                 */
   int packetLen;               /* Size of the packet         */
   struct sockaddr_in from;     /* Where the packet came from */
   int fromlen;                 /* size of the from struct    */
   
   fromlen = sizeof(from);
-  packetLen = recvfrom(sockUdp, info, 512 /* MAX_PACKET_SIZE*/ , 0, (struct sockaddr *)&from, &fromlen);
+  packetLen = recvfrom(sc->transport->sockUdp, info, 512 /* MAX_PACKET_SIZE*/ , 0, (struct sockaddr *)&from, &fromlen);
   while (packetLen != SOCKET_ERROR) {
      /* We have data - Yah! */
-    memcpy(&addrLast, &from, (size_t) sizeof(from));
-    serverNetUDPPacketArrive(info, packetLen, from.sin_addr.s_addr,  from.sin_port);
+    memcpy(&sc->transport->addrLast, &from, (size_t) sizeof(from));
+    serverNetUDPPacketArrive(sc, info, packetLen, from.sin_addr.s_addr,  from.sin_port);
     /* Process it and await more data */
     fromlen = sizeof(from);
-    packetLen = recvfrom(sockUdp, info, 512 /*MAX_PACKET_SIZE*/, 0, (struct sockaddr *)&from, &fromlen);
+    packetLen = recvfrom(sc->transport->sockUdp, info, 512 /*MAX_PACKET_SIZE*/, 0, (struct sockaddr *)&from, &fromlen);
   }
 }
 
+/*********************************************************
+*NAME:          serverTransportGetSocket
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the UDP socket so the server event loop can
+*  wait for it to become readable
+*
+*ARGUMENTS:
+*  sc - Game the socket belongs to
+*********************************************************/
+int serverTransportGetSocket(serverCore sc) {
+  return sc->transport->sockUdp;
+}
+
 /*********************************************************
 *NAME:          serverTransportSetUs
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets up our IP address.
 *
 *ARGUMENTS:
-*
+*  sc - Game the socket belongs to
 *********************************************************/
-void serverTransportSetUs(void) {
+void serverTransportSetUs(serverCore sc) {
   char str[FILENAME_MAX]; /* Temp string to hold host name  & IP as string*/
   HOSTENT  *hd;           /* Host Data */
   int ipa;               /* Bytes for each IP address components */
@@ -232,41 +263,50 @@ void serverTransportSetUs(void) {
     strcpy(str, "127.0.0.1\0");
   }
   sprintf(str, "%d.%d.%d.%d\0",ipa,ipb,ipc,ipd);
-  addrUs.sin_addr.s_addr = inet_addr(str);
-  addrUs.sin_port = myPort;
+  sc->transport->addrUs.sin_addr.s_addr = inet_addr(str);
+  sc->transport->addrUs.sin_port = sc->transport->myPort;
 }
 
 /*********************************************************
 *NAME:          serverTransportGetUs
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Gets our IP address and port.
+* Gets our IP address and port. Both are zero if the game
+* is not listening
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  dest - Destination address
 *  port - Destination port
 *********************************************************/
-void serverTransportGetUs(struct in_addr *dest, unsigned short *port) {
-  memcpy(dest, &(addrUs.sin_addr), (size_t) sizeof(*dest));
-  *port = myPort;
+void serverTransportGetUs(serverCore sc, struct in_addr *dest, unsigned short *port) {
+  if (sc->transport == NULL) {
+    /* Not listening */
+    memset(dest, 0, sizeof(*dest));
+    *port = 0;
+    return;
+  }
+  memcpy(dest, &(sc->transport->addrUs.sin_addr), (size_t) sizeof(*dest));
+  *port = sc->transport->myPort;
 }
 
 /*********************************************************
 *NAME:          serverTransportSendUDPLast
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/08/99
-*LAST MODIFIED: 19/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends a packet to the last UDP connection made.
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  buff  - Buffer to send 
 *  len   - length of the buffer
 *  wantCrc - Should we add a CRC to this?
 *********************************************************/
-void serverTransportSendUDPLast(BYTE *buff, int len, bool wantCrc) {
+void serverTransportSendUDPLast(serverCore sc, BYTE *buff, int len, bool wantCrc) {
   BYTE crcA, crcB;
   int i;
 
@@ -276,12 +316,12 @@ void serverTransportSendUDPLast(BYTE *buff, int len, bool wantCrc) {
     buff[len+1] = crcB;
     len+=2;
   }
-  i = sendto(sockUdp, (char *) buff, len, 0, (struct sockaddr *)&addrLast, sizeof(addrLast));
+  i = sendto(sc->transport->sockUdp, (char *) buff, len, 0, (struct sockaddr *)&sc->transport->addrLast, sizeof(sc->transport->addrLast));
 }
 
 // FIXME: Prototype
-void serverTransportSendUDP(BYTE *buff, int len, struct sockaddr_in *addr) {
-  sendto(sockUdp, (char *) buff, len, 0, (struct sockaddr *) addr, sizeof(*addr));
+void serverTransportSendUDP(serverCore sc, BYTE *buff, int len, struct sockaddr_in *addr) {
+  sendto(sc->transport->sockUdp, (char *) buff, len, 0, (struct sockaddr *) addr, sizeof(*addr));
 
 }
 
@@ -290,29 +330,30 @@ void serverTransportSendUDP(BYTE *buff, int len, struct sockaddr_in *addr) {
 *NAME:          serverTransportSetTracker
 *AUTHOR:        John Morrison
 *CREATION DATE: 13/11/99
-*LAST MODIFIED: 21/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets the trackers details up. Returns success.
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  address - Address of the tracker
 *  port    - Port of the tracker
 *********************************************************/
-bool serverTransportSetTracker(char *address, unsigned short port) {
+bool serverTransportSetTracker(serverCore sc, char *address, unsigned short port) {
   bool returnValue;    /* Value to return      */
   struct hostent *phe; /* Used for DNS lookups */
   
   returnValue = TRUE;
-  addrTracker.sin_family = AF_INET;
-  addrTracker.sin_port = htons(port);
-  addrTracker.sin_addr.s_addr = inet_addr(address);
-  if (addrTracker.sin_addr.s_addr == INADDR_NONE) {
+  sc->transport->addrTracker.sin_family = AF_INET;
+  sc->transport->addrTracker.sin_port = htons(port);
+  sc->transport->addrTracker.sin_addr.s_addr = inet_addr(address);
+  if (sc->transport->addrTracker.sin_addr.s_addr == INADDR_NONE) {
     /* Not an IP Address. Do a hostname lookup */
     phe = gethostbyname(address);
     if (phe == 0) {
       returnValue = FALSE;
     } else {
-      addrTracker.sin_addr.s_addr = *((u_long*)phe->h_addr_list[0]);
+      sc->transport->addrTracker.sin_addr.s_addr = *((u_long*)phe->h_addr_list[0]);
     }
   }
 
@@ -323,20 +364,21 @@ bool serverTransportSetTracker(char *address, unsigned short port) {
 *NAME:          serverTransportSendUdpTracker
 *AUTHOR:        John Morrison
 *CREATION DATE: 13/11/99
-*LAST MODIFIED: 13/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends a udp packet to the tracker
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  buff  - Buffer to send 
 *  len   - length of the buffer
 *********************************************************/
-void serverTransportSendUdpTracker(BYTE *buff, int len) {
-  sendto(sockUdp, (char *) buff, len, 0, (struct sockaddr *)&addrTracker, sizeof(addrTracker));
+void serverTransportSendUdpTracker(serverCore sc, BYTE *buff, int len) {
+  sendto(sc->transport->sockUdp, (char *) buff, len, 0, (struct sockaddr *)&sc->transport->addrTracker, sizeof(sc->transport->addrTracker));
 }
 
 
-void serverTransportDoChecks() {
-  serverTransportListenUDP();
+void serverTransportDoChecks(serverCore sc) {
+  serverTransportListenUDP(sc);
   return;
 }
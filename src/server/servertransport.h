@@ -20,7 +20,7 @@
 *Filename:      serverTransport.h
 *Author:        John Morrison
 *Creation Date: 11/8/99
-*Last Modified: 12/1/00
+*Last Modified: 16/10/26
 *Purpose:
 *  WinBolo Server Transport layer.
 *********************************************************/
@@ -29,6 +29,7 @@
 #define SERVER_TRANSPORT_H
 
 #include "../bolo/global.h"
+#include "servercore.h"
 
 #ifdef _WIN32
 #else 
@@ -48,119 +49,154 @@
 #define NO_BLOCK_SOCK 1
 
 // FIXME: Prototype
-void serverTransportSendUDP(BYTE *buff, int len, struct sockaddr_in *addr);
+void serverTransportSendUDP(serverCore sc, BYTE *buff, int len, struct sockaddr_in *addr);
 
 /*********************************************************
 *NAME:          serverTransportCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 11/8/99
-*LAST MODIFIED: 10/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Creates the new servers transport layer. Returns FALSE 
 *  if an error occured
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 * port      - Port to run server on.
 * addrToUse - The address to use if not NULL
 *********************************************************/
-bool serverTransportCreate(unsigned short port, char *addrToUse);
+bool serverTransportCreate(serverCore sc, unsigned short port, char *addrToUse);
 
 /*********************************************************
 *NAME:          serverTransportDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 11/8/99
-*LAST MODIFIED: 11/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Shuts down the server transport subsystem.
 *
 *ARGUMENTS:
-*
+*  sc - Game the socket belongs to
 *********************************************************/
-void serverTransportDestroy();
+void serverTransportDestroy(serverCore sc);
 
 /*********************************************************
 *NAME:          serverTransportListenUDP
 *AUTHOR:        John Morrison
 *CREATION DATE: 13/8/99
-*LAST MODIFIED: 13/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Listens for incoming UDP packets and processes them. 
 *  Function exits upon an error caused by the sockUdp 
 *  being closed.
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
+*********************************************************/
+void serverTransportListenUDP(serverCore sc);
+
+#ifndef _WIN32
+/*********************************************************
+*NAME:          serverTransportGetSocket
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Returns the UDP socket so the server event loop can
+*  wait for it to become readable
 *
+*ARGUMENTS:
+*  sc - Game the socket belongs to
 *********************************************************/
-void serverTransportListenUDP(void);
+int serverTransportGetSocket(serverCore sc);
+#endif
 
 /*********************************************************
 *NAME:          serverTransportSetUs
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets up our IP address.
 *
 *ARGUMENTS:
-*
+*  sc - Game the socket belongs to
 *********************************************************/
-void serverTransportSetUs(void);
+void serverTransportSetUs(serverCore sc);
 
 /*********************************************************
 *NAME:          serverTransportGetUs
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Gets our IP address and port.
+* Gets our IP address and port. Both are zero if the game
+* is not listening
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  dest - Destination address
 *  port - Destination port
 *********************************************************/
-void serverTransportGetUs(struct in_addr *dest, unsigned short *port);
+void serverTransportGetUs(serverCore sc, struct in_addr *dest, unsigned short *port);
 
 /*********************************************************
 *NAME:          serverTransportSendUDPLast
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/08/99
-*LAST MODIFIED: 19/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends a packet to the last UDP connection made.
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  buff  - Buffer to send 
 *  len   - length of the buffer
 *  wantCrc - Should we add a CRC to this?
 *********************************************************/
-void serverTransportSendUDPLast(BYTE *buff, int len, bool wantCrc);
+void serverTransportSendUDPLast(serverCore sc, BYTE *buff, int len, bool wantCrc);
 
 /*********************************************************
 *NAME:          serverTransportSetTracker
 *AUTHOR:        John Morrison
 *CREATION DATE: 13/11/99
-*LAST MODIFIED: 21/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets the trackers details up. Returns success.
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  address - Address of the tracker
 *  port    - Port of the tracker
 *********************************************************/
-bool serverTransportSetTracker(char *address, unsigned short port);
+bool serverTransportSetTracker(serverCore sc, char *address, unsigned short port);
 
 /*********************************************************
 *NAME:          serverTransportSendUdpTracker
 *AUTHOR:        John Morrison
 *CREATION DATE: 13/11/99
-*LAST MODIFIED: 13/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends a udp packet to the tracker
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  buff  - Buffer to send 
 *  len   - length of the buffer
 *********************************************************/
-void serverTransportSendUdpTracker(BYTE *buff, int len);
+void serverTransportSendUdpTracker(serverCore sc, BYTE *buff, int len);
+
+/*********************************************************
+*NAME:          serverTransportDoChecks
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+* Processes any packets waiting on the game's socket
+*
+*ARGUMENTS:
+*  sc - Game the socket belongs to
+*********************************************************/
+void serverTransportDoChecks(serverCore sc);
 
 #endif /* SERVER_TRANSPORT_H */
@@ -20,12 +20,13 @@
 *Filename:      threads.c
 *Author:        John Morrison
 *Creation Date: 12/08/99
-*Last Modified: 21/09/03
+*Last Modified: 16/10/26
 *Purpose:
 *  WinBolo Server Thread manager
 *********************************************************/
 
 #include <stdio.h>
+#include <string.h>
 #ifdef _WIN32
 #include <winsock2.h>
 #include <windows.h>
@@ -34,6 +35,7 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include "SDL.h"
+#include "SDL_thread.h"
 typedef SDL_mutex *HANDLE;
 #endif
 #include "../bolo/global.h"
@@ -42,9 +44,38 @@ typedef SDL_mutex *HANDLE;
 #include "threads.h"
 
 HANDLE hMutexHandle = NULL;
-bool threadServerContext = FALSE;
+/* Each thread dispatches the backend on its own context */
+static THREAD_LOCAL bool threadServerContext = FALSE;
 bool threadStarted = FALSE;
 
+struct threadsMutexObj {
+  HANDLE handle; /* The system mutex */
+};
+
+/* A queued job */
+typedef struct {
+  threadsJob job; /* Function to run */
+  void *arg;      /* Passed to it */
+} threadsPoolItem;
+
+struct threadsPoolObj {
+  threadsPoolItem item[THREADS_POOL_MAX_JOBS]; /* Ring of queued jobs */
+  int head;               /* Next job to run */
+  int numItems;           /* Jobs queued */
+  bool stopping;          /* Workers should exit once the ring is empty */
+  unsigned long jobsRun;  /* Jobs run so far */
+  int numWorkers;         /* Threads started */
+  bool context;           /* Context the workers run in */
+  HANDLE lock;            /* Guards the above */
+#ifdef _WIN32
+  HANDLE ready;           /* Counts jobs queued */
+  HANDLE *worker;         /* The threads */
+#else
+  SDL_sem *ready;
+  SDL_Thread **worker;
+#endif
+};
+
 /*********************************************************
 *NAME:          threadsCreate
 *AUTHOR:        John Morrison
@@ -147,10 +178,11 @@ void threadsReleaseMutex(void) {
 *NAME:          threadsGetContext
 *AUTHOR:        John Morrison
 *CREATION DATE: 27/07/03
-*LAST MODIFIED: 27/07/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns the current thread context. TRUE if we are in
-*  a server context, false if we are in a client
+*  a server context, false if we are in a client. Each
+*  thread has its own
 *
 *ARGUMENTS:
 *
@@ -163,10 +195,11 @@ bool threadsGetContext() {
 *NAME:          threadsSetContext
 *AUTHOR:        John Morrison
 *CREATION DATE: 27/07/03
-*LAST MODIFIED: 27/07/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Sets the current thread context. TRUE if we are in
-*  a server context, false if we are in a client
+*  a server context, false if we are in a client. Only
+*  the calling thread is changed
 *
 *ARGUMENTS:
 *  serverContext - Context to set to
@@ -174,3 +207,339 @@ bool threadsGetContext() {
 void threadsSetContext(bool serverContext) {
   threadServerContext = serverContext;
 }
+
+/*********************************************************
+*NAME:          threadsMutexCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates a mutex. Returns NULL on failure
+*
+*ARGUMENTS:
+*
+*********************************************************/
+threadsMutex threadsMutexCreate(void) {
+  threadsMutex returnValue; /* Value to return */
+
+  New(returnValue);
+  if (returnValue != NULL) {
+#ifdef _WIN32
+    returnValue->handle = CreateMutex(NULL, FALSE, NULL);
+#else
+    returnValue->handle = SDL_CreateMutex();
+#endif
+    if (returnValue->handle == NULL) {
+      fprintf(stderr, "Error Creating Mutex\n");
+      Dispose(returnValue);
+      returnValue = NULL;
+    }
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          threadsMutexDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys a mutex. It must not be held
+*
+*ARGUMENTS:
+*  value - Pointer to the mutex
+*********************************************************/
+void threadsMutexDestroy(threadsMutex *value) {
+  if (*value != NULL) {
+#ifdef _WIN32
+    CloseHandle((*value)->handle);
+#else
+    SDL_DestroyMutex((*value)->handle);
+#endif
+    Dispose(*value);
+    *value = NULL;
+  }
+}
+
+/*********************************************************
+*NAME:          threadsMutexWait
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Waits till the mutex is acquired. A thread holding it
+*  may acquire it again
+*
+*ARGUMENTS:
+*  value - The mutex
+*********************************************************/
+void threadsMutexWait(threadsMutex value) {
+#ifdef _WIN32
+  WaitForSingleObject(value->handle, INFINITE);
+#else
+  SDL_mutexP(value->handle);
+#endif
+}
+
+/*********************************************************
+*NAME:          threadsMutexRelease
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Releases the mutex once for each time it was acquired
+*
+*ARGUMENTS:
+*  value - The mutex
+*********************************************************/
+void threadsMutexRelease(threadsMutex value) {
+#ifdef _WIN32
+  ReleaseMutex(value->handle);
+#else
+  SDL_mutexV(value->handle);
+#endif
+}
+
+/*********************************************************
+*NAME:          threadsPoolRun
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  A worker thread. Runs queued jobs in the context of
+*  the thread that made the pool until the pool is
+*  stopping and none are left
+*
+*ARGUMENTS:
+*  arg - The pool
+*********************************************************/
+static int threadsPoolRun(void *arg) {
+  threadsPool value;    /* The pool */
+  threadsPoolItem item; /* Job being run */
+  bool done;            /* Time to exit */
+
+  value = (threadsPool) arg;
+  threadsSetContext(value->context);
+  done = FALSE;
+  while (done == FALSE) {
+#ifdef _WIN32
+    WaitForSingleObject(value->ready, INFINITE);
+    WaitForSingleObject(value->lock, INFINITE);
+#else
+    SDL_SemWait(value->ready);
+    SDL_mutexP(value->lock);
+#endif
+    item.job = NULL;
+    if (value->numItems > 0) {
+      item = value->item[value->head];
+      value->head = (value->head + 1) % THREADS_POOL_MAX_JOBS;
+      value->numItems--;
+      value->jobsRun++;
+    } else if (value->stopping == TRUE) {
+      done = TRUE;
+    }
+#ifdef _WIN32
+    ReleaseMutex(value->lock);
+#else
+    SDL_mutexV(value->lock);
+#endif
+    if (item.job != NULL) {
+      item.job(item.arg);
+    }
+  }
+  return 0;
+}
+
+/*********************************************************
+*NAME:          threadsPoolCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Starts a pool of worker threads. They run jobs in the
+*  context of the calling thread. Returns NULL on failure
+*
+*ARGUMENTS:
+*  numWorkers - Number of threads to start
+*********************************************************/
+threadsPool threadsPoolCreate(int numWorkers) {
+  threadsPool returnValue; /* Value to return */
+  int count;               /* Looping variable */
+#ifdef _WIN32
+  DWORD threadId;          /* Not used */
+#endif
+
+  if (numWorkers < 1) {
+    return NULL;
+  }
+  New(returnValue);
+  if (returnValue == NULL) {
+    return NULL;
+  }
+  memset(returnValue, 0, sizeof(*returnValue));
+  returnValue->context = threadsGetContext();
+  returnValue->worker = emalloc(sizeof(*returnValue->worker) * numWorkers);
+#ifdef _WIN32
+  returnValue->lock = CreateMutex(NULL, FALSE, NULL);
+  returnValue->ready = CreateSemaphore(NULL, 0, THREADS_POOL_MAX_JOBS + numWorkers, NULL);
+#else
+  returnValue->lock = SDL_CreateMutex();
+  returnValue->ready = SDL_CreateSemaphore(0);
+#endif
+  if (returnValue->worker == NULL || returnValue->lock == NULL || returnValue->ready == NULL) {
+    fprintf(stderr, "Error Creating Worker Pool\n");
+    threadsPoolDestroy(&returnValue);
+    return NULL;
+  }
+
+  for (count=0;count<numWorkers;count++) {
+#ifdef _WIN32
+    returnValue->worker[count] = CreateThread((LPSECURITY_ATTRIBUTES) NULL, 0, (LPTHREAD_START_ROUTINE) threadsPoolRun, returnValue, 0, &threadId);
+#else
+    returnValue->worker[count] = SDL_CreateThread(threadsPoolRun, returnValue);
+#endif
+    if (returnValue->worker[count] == NULL) {
+      fprintf(stderr, "Error Creating Worker Thread\n");
+      threadsPoolDestroy(&returnValue);
+      return NULL;
+    }
+    returnValue->numWorkers++;
+  }
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          threadsPoolDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Runs the jobs still queued, stops the workers and
+*  frees the pool
+*
+*ARGUMENTS:
+*  value - Pointer to the pool
+*********************************************************/
+void threadsPoolDestroy(threadsPool *value) {
+  int count; /* Looping variable */
+
+  if (*value == NULL) {
+    return;
+  }
+  if ((*value)->numWorkers > 0) {
+#ifdef _WIN32
+    WaitForSingleObject((*value)->lock, INFINITE);
+    (*value)->stopping = TRUE;
+    ReleaseMutex((*value)->lock);
+    ReleaseSemaphore((*value)->ready, (*value)->numWorkers, NULL);
+#else
+    SDL_mutexP((*value)->lock);
+    (*value)->stopping = TRUE;
+    SDL_mutexV((*value)->lock);
+    for (count=0;count<(*value)->numWorkers;count++) {
+      SDL_SemPost((*value)->ready);
+    }
+#endif
+  }
+  for (count=0;count<(*value)->numWorkers;count++) {
+#ifdef _WIN32
+    WaitForSingleObject((*value)->worker[count], INFINITE);
+    CloseHandle((*value)->worker[count]);
+#else
+    SDL_WaitThread((*value)->worker[count], NULL);
+#endif
+  }
+#ifdef _WIN32
+  if ((*value)->lock != NULL) {
+    CloseHandle((*value)->lock);
+  }
+  if ((*value)->ready != NULL) {
+    CloseHandle((*value)->ready);
+  }
+#else
+  if ((*value)->lock != NULL) {
+    SDL_DestroyMutex((*value)->lock);
+  }
+  if ((*value)->ready != NULL) {
+    SDL_DestroySemaphore((*value)->ready);
+  }
+#endif
+  if ((*value)->worker != NULL) {
+    Dispose((*value)->worker);
+  }
+  Dispose(*value);
+  *value = NULL;
+}
+
+/*********************************************************
+*NAME:          threadsPoolAdd
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Queues a job for the next free worker. Returns FALSE
+*  if THREADS_POOL_MAX_JOBS are already queued
+*
+*ARGUMENTS:
+*  value - The pool
+*  job   - Function to run
+*  arg   - Passed to job
+*********************************************************/
+bool threadsPoolAdd(threadsPool value, threadsJob job, void *arg) {
+  bool returnValue; /* Value to return */
+  int pos;          /* Ring position to queue at */
+
+  returnValue = FALSE;
+#ifdef _WIN32
+  WaitForSingleObject(value->lock, INFINITE);
+#else
+  SDL_mutexP(value->lock);
+#endif
+  if (value->numItems < THREADS_POOL_MAX_JOBS) {
+    pos = (value->head + value->numItems) % THREADS_POOL_MAX_JOBS;
+    value->item[pos].job = job;
+    value->item[pos].arg = arg;
+    value->numItems++;
+    returnValue = TRUE;
+  }
+#ifdef _WIN32
+  ReleaseMutex(value->lock);
+  if (returnValue == TRUE) {
+    ReleaseSemaphore(value->ready, 1, NULL);
+  }
+#else
+  SDL_mutexV(value->lock);
+  if (returnValue == TRUE) {
+    SDL_SemPost(value->ready);
+  }
+#endif
+  return returnValue;
+}
+
+/*********************************************************
+*NAME:          threadsPoolGetStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the number of workers and jobs they have run
+*
+*ARGUMENTS:
+*  value      - The pool
+*  numWorkers - Set to the number of workers
+*  jobsRun    - Set to the jobs run so far
+*********************************************************/
+void threadsPoolGetStats(threadsPool value, int *numWorkers, unsigned long *jobsRun) {
+#ifdef _WIN32
+  WaitForSingleObject(value->lock, INFINITE);
+#else
+  SDL_mutexP(value->lock);
+#endif
+  *numWorkers = value->numWorkers;
+  *jobsRun = value->jobsRun;
+#ifdef _WIN32
+  ReleaseMutex(value->lock);
+#else
+  SDL_mutexV(value->lock);
+#endif
+}
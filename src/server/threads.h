@@ -20,7 +20,7 @@
 *Filename:      threads.h
 *Author:        John Morrison
 *Creation Date: 12/08/99
-*Last Modified: 21/09/03
+*Last Modified: 16/10/26
 *Purpose:
 *  WinBolo Server Thread manager
 *********************************************************/
@@ -30,6 +30,18 @@
 
 #include "../bolo/global.h"
 
+/* Most jobs a worker pool can have queued */
+#define THREADS_POOL_MAX_JOBS 256
+
+/* A mutex guarding one game */
+typedef struct threadsMutexObj *threadsMutex;
+
+/* Work handed to a worker pool */
+typedef void (*threadsJob)(void *arg);
+
+/* Threads that run the jobs queued on them */
+typedef struct threadsPoolObj *threadsPool;
+
 /*********************************************************
 *NAME:          threadsCreate
 *AUTHOR:        John Morrison
@@ -88,10 +100,11 @@ void threadsReleaseMutex(void);
 *NAME:          threadsGetContext
 *AUTHOR:        John Morrison
 *CREATION DATE: 27/07/03
-*LAST MODIFIED: 27/07/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Returns the current thread context. TRUE if we are in
-*  a server context, false if we are in a client
+*  a server context, false if we are in a client. Each
+*  thread has its own
 *
 *ARGUMENTS:
 *
@@ -102,15 +115,128 @@ bool threadsGetContext();
 *NAME:          threadsSetContext
 *AUTHOR:        John Morrison
 *CREATION DATE: 27/07/03
-*LAST MODIFIED: 27/07/03
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Sets the current thread context. TRUE if we are in
-*  a server context, false if we are in a client
+*  a server context, false if we are in a client. Only
+*  the calling thread is changed
 *
 *ARGUMENTS:
 *  serverContext - Context to set to
 *********************************************************/
 void threadsSetContext(bool serverContext);
 
+/*********************************************************
+*NAME:          threadsMutexCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Creates a mutex. Returns NULL on failure
+*
+*ARGUMENTS:
+*
+*********************************************************/
+threadsMutex threadsMutexCreate(void);
+
+/*********************************************************
+*NAME:          threadsMutexDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Destroys a mutex. It must not be held
+*
+*ARGUMENTS:
+*  value - Pointer to the mutex
+*********************************************************/
+void threadsMutexDestroy(threadsMutex *value);
+
+/*********************************************************
+*NAME:          threadsMutexWait
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Waits till the mutex is acquired. A thread holding it
+*  may acquire it again
+*
+*ARGUMENTS:
+*  value - The mutex
+*********************************************************/
+void threadsMutexWait(threadsMutex value);
+
+/*********************************************************
+*NAME:          threadsMutexRelease
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Releases the mutex once for each time it was acquired
+*
+*ARGUMENTS:
+*  value - The mutex
+*********************************************************/
+void threadsMutexRelease(threadsMutex value);
+
+/*********************************************************
+*NAME:          threadsPoolCreate
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Starts a pool of worker threads. They run jobs in the
+*  context of the calling thread. Returns NULL on failure
+*
+*ARGUMENTS:
+*  numWorkers - Number of threads to start
+*********************************************************/
+threadsPool threadsPoolCreate(int numWorkers);
+
+/*********************************************************
+*NAME:          threadsPoolDestroy
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Runs the jobs still queued, stops the workers and
+*  frees the pool
+*
+*ARGUMENTS:
+*  value - Pointer to the pool
+*********************************************************/
+void threadsPoolDestroy(threadsPool *value);
+
+/*********************************************************
+*NAME:          threadsPoolAdd
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Queues a job for the next free worker. Returns FALSE
+*  if THREADS_POOL_MAX_JOBS are already queued
+*
+*ARGUMENTS:
+*  value - The pool
+*  job   - Function to run
+*  arg   - Passed to job
+*********************************************************/
+bool threadsPoolAdd(threadsPool value, threadsJob job, void *arg);
+
+/*********************************************************
+*NAME:          threadsPoolGetStats
+*AUTHOR:        OpenBolo Contributors
+*CREATION DATE: 16/10/26
+*LAST MODIFIED: 16/10/26
+*PURPOSE:
+*  Gets the number of workers and jobs they have run
+*
+*ARGUMENTS:
+*  value      - The pool
+*  numWorkers - Set to the number of workers
+*  jobsRun    - Set to the jobs run so far
+*********************************************************/
+void threadsPoolGetStats(threadsPool value, int *numWorkers, unsigned long *jobsRun);
+
 #endif /* _THREADS_H */
 
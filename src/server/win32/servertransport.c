@@ -20,7 +20,7 @@
 *Filename:      serverTransport.c
 *Author:        John Morrison
 *Creation Date: 11/8/99
-*Last Modified: 12/1/00
+*Last Modified: 16/10/26
 *Purpose:
 *  WinBolo Server Transport layer.
 *********************************************************/
@@ -44,12 +44,14 @@
 #include "../servercore.h"
 
 
-SOCKET sockUdp = INVALID_SOCKET; /* Our UDP socket */
-
-struct sockaddr_in addrServerUs;      /* Our own machine */
-unsigned short myServerPort;          /* Our UDP Port number */
-struct sockaddr_in addrServerLast;    /* Where the last packet came from */
-struct sockaddr_in addrServerTracker; /* Tracker machine */
+/* A game's UDP socket */
+struct serverTransportObj {
+  SOCKET sockUdp;                       /* Our UDP socket */
+  struct sockaddr_in addrServerUs;      /* Our own machine */
+  unsigned short myServerPort;          /* Our UDP Port number */
+  struct sockaddr_in addrServerLast;    /* Where the last packet came from */
+  struct sockaddr_in addrServerTracker; /* Tracker machine */
+};
 
 
 static unsigned long getaddrbyany(char *sp_name)  {               
@@ -75,16 +77,17 @@ static unsigned long getaddrbyany(char *sp_name)  {
 *NAME:          serverTransportCreate
 *AUTHOR:        John Morrison
 *CREATION DATE: 11/8/99
-*LAST MODIFIED: 10/9/00
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-*  Creates the new servers transport layer. Returns FALSE 
-*  if an error occured
+*  Creates the new servers transport layer for a game.
+*  Returns FALSE if an error occured
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 * port      - Port to run server on.
 * addrToUse - The address to use if not NULL
 *********************************************************/
-bool serverTransportCreate(unsigned short port, char *addrToUse) {
+bool serverTransportCreate(serverCore sc, unsigned short port, char *addrToUse) {
   bool returnValue = TRUE; /* Value to return */
   WSADATA wsaData;         /* Winsock create data */
   int ret;                 /* Function returns */
@@ -101,9 +104,15 @@ bool serverTransportCreate(unsigned short port, char *addrToUse) {
     returnValue = FALSE;
   }
 
+  New(sc->transport);
+  if (sc->transport == NULL) {
+    returnValue = FALSE;
+  } else {
+    sc->transport->sockUdp = INVALID_SOCKET;
+  }
 
   if (returnValue == TRUE) {
-    myServerPort = port;
+    sc->transport->myServerPort = port;
     addr.sin_family = AF_INET;
     addr.sin_port = htons(port);
     addr.sin_addr.s_addr = INADDR_ANY;
@@ -117,8 +126,8 @@ bool serverTransportCreate(unsigned short port, char *addrToUse) {
 
   /* Create Sockets */
   if (returnValue == TRUE) {    
-    sockUdp = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (sockUdp == INVALID_SOCKET) {
+    sc->transport->sockUdp = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sc->transport->sockUdp == INVALID_SOCKET) {
       fprintf(stderr, "Error Creating UDP Socket\n");
       returnValue = FALSE;
     }
@@ -126,7 +135,7 @@ bool serverTransportCreate(unsigned short port, char *addrToUse) {
 
   /* Binding */
   if (returnValue == TRUE) {
-    ret = bind(sockUdp, (struct sockaddr *)&addr, sizeof(addr));
+    ret = bind(sc->transport->sockUdp, (struct sockaddr *)&addr, sizeof(addr));
     if (ret < 0) {
       fprintf(stderr, "Error Binding UDP Socket\n");
       returnValue = FALSE;
@@ -137,7 +146,7 @@ bool serverTransportCreate(unsigned short port, char *addrToUse) {
   /* Set to non blocking */
   if (returnValue == TRUE) {
     noBlock = NO_BLOCK_SOCK;
-    ret = ioctlsocket(sockUdp, FIONBIO, &noBlock);
+    ret = ioctlsocket(sc->transport->sockUdp, FIONBIO, &noBlock);
     if (ret == SOCKET_ERROR) {
       returnValue = FALSE;
     }
@@ -151,18 +160,23 @@ bool serverTransportCreate(unsigned short port, char *addrToUse) {
 *NAME:          serverTransportDestroy
 *AUTHOR:        John Morrison
 *CREATION DATE: 11/8/99
-*LAST MODIFIED: 11/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Shuts down the server transport subsystem.
 *
 *ARGUMENTS:
-*
+*  sc - Game the socket belongs to
 *********************************************************/
-void serverTransportDestroy() {
+void serverTransportDestroy(serverCore sc) {
   screenServerConsoleMessage((char *) "Server Transport Shutdown");
-  shutdown(sockUdp, SD_BOTH);
-  closesocket(sockUdp);
-  sockUdp = INVALID_SOCKET;
+  if (sc->transport != NULL) {
+    if (sc->transport->sockUdp != INVALID_SOCKET) {
+      shutdown(sc->transport->sockUdp, SD_BOTH);
+      closesocket(sc->transport->sockUdp);
+    }
+    Dispose(sc->transport);
+    sc->transport = NULL;
+  }
   WSACleanup();
 }
 
@@ -171,30 +185,30 @@ void serverTransportDestroy() {
 *NAME:          serverTransportListenUDP
 *AUTHOR:        John Morrison
 *CREATION DATE: 13/8/99
-*LAST MODIFIED: 13/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 *  Listens for incoming UDP packets and processes them. 
 *  Function exits upon an error caused by the sockUdp 
 *  being closed.
 *
 *ARGUMENTS:
-*
+*  sc - Game the socket belongs to
 *********************************************************/
-void serverTransportListenUDP(void) {
+void serverTransportListenUDP(serverCore sc) {
   BYTE info[512 /*MAX_PACKET_SIZE */];  /* The packet                 */
   int packetLen;               /* Size of the packet         */
   struct sockaddr_in from;     /* Where the packet came from */
   int fromlen;                 /* size of the from struct    */
   
   fromlen = sizeof(from);
-  packetLen = recvfrom(sockUdp, info, 512 /* MAX_PACKET_SIZE*/ , 0, (struct sockaddr *)&from, &fromlen);
+  packetLen = recvfrom(sc->transport->sockUdp, info, 512 /* MAX_PACKET_SIZE*/ , 0, (struct sockaddr *)&from, &fromlen);
   while (packetLen != SOCKET_ERROR) {
      /* We have data - Yah! */
-    memcpy(&addrServerLast, &from, (size_t) sizeof(from));
-    serverNetUDPPacketArrive(info, packetLen, from.sin_addr.S_un.S_addr,  from.sin_port);
+    memcpy(&sc->transport->addrServerLast, &from, (size_t) sizeof(from));
+    serverNetUDPPacketArrive(sc, info, packetLen, from.sin_addr.S_un.S_addr,  from.sin_port);
     /* Process it and await more data */
     fromlen = sizeof(from);
-    packetLen = recvfrom(sockUdp, info, 512 /*MAX_PACKET_SIZE*/, 0, (struct sockaddr *)&from, &fromlen);
+    packetLen = recvfrom(sc->transport->sockUdp, info, 512 /*MAX_PACKET_SIZE*/, 0, (struct sockaddr *)&from, &fromlen);
   }
 }
 
@@ -202,14 +216,14 @@ void serverTransportListenUDP(void) {
 *NAME:          serverTransportSetUs
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets up our IP address.
 *
 *ARGUMENTS:
-*
+*  sc - Game the socket belongs to
 *********************************************************/
-void serverTransportSetUs(void) {
+void serverTransportSetUs(serverCore sc) {
   char str[FILENAME_MAX]; /* Temp string to hold host name  & IP as string*/
   HOSTENT  *hd;           /* Host Data */
   int ipa;               /* Bytes for each IP address components */
@@ -231,41 +245,43 @@ void serverTransportSetUs(void) {
     strcpy(str, "127.0.0.1\0");
   }
   sprintf(str, "%d.%d.%d.%d\0",ipa,ipb,ipc,ipd);
-  addrServerUs.sin_addr.s_addr = inet_addr(str);
-  addrServerUs.sin_port = myServerPort;
+  sc->transport->addrServerUs.sin_addr.s_addr = inet_addr(str);
+  sc->transport->addrServerUs.sin_port = sc->transport->myServerPort;
 }
 
 /*********************************************************
 *NAME:          serverTransportGetUs
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/8/99
-*LAST MODIFIED: 15/8/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Gets our IP address and port.
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  dest - Destination address
 *  port - Destination port
 *********************************************************/
-void serverTransportGetUs(struct in_addr *dest, unsigned short *port) {
-  memcpy(dest, &(addrServerUs.sin_addr), (size_t) sizeof(*dest));
-  *port = myServerPort;
+void serverTransportGetUs(serverCore sc, struct in_addr *dest, unsigned short *port) {
+  memcpy(dest, &(sc->transport->addrServerUs.sin_addr), (size_t) sizeof(*dest));
+  *port = sc->transport->myServerPort;
 }
 
 /*********************************************************
 *NAME:          serverTransportSendUDPLast
 *AUTHOR:        John Morrison
 *CREATION DATE: 15/08/99
-*LAST MODIFIED: 19/08/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends a packet to the last UDP connection made.
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  buff  - Buffer to send 
 *  len   - length of the buffer
 *  wantCrc - Should we add a CRC to this?
 *********************************************************/
-void serverTransportSendUDPLast(BYTE *buff, int len, bool wantCrc) {
+void serverTransportSendUDPLast(serverCore sc, BYTE *buff, int len, bool wantCrc) {
   BYTE crcA, crcB;
   int i;
 
@@ -275,7 +291,7 @@ void serverTransportSendUDPLast(BYTE *buff, int len, bool wantCrc) {
     buff[len+1] = crcB;
     len+=2;
   }
-  i = sendto(sockUdp, (char *) buff, len, 0, (struct sockaddr *)&addrServerLast, sizeof(addrServerLast));
+  i = sendto(sc->transport->sockUdp, (char *) buff, len, 0, (struct sockaddr *)&sc->transport->addrServerLast, sizeof(sc->transport->addrServerLast));
   if (i <= 0) {
 /*    fprintf(stderr, "bad\n"); 
     i = WSAGetLastError();
@@ -351,7 +367,7 @@ case WSAENETUNREACH:
       break;
     }
     printf("Retrying,,,\n"); 
-    i = sendto(sockUdp, (char *) buff, len, 0, (struct sockaddr *)&addrLast, sizeof(addrLast));
+    i = sendto(sc->transport->sockUdp, (char *) buff, len, 0, (struct sockaddr *)&addrLast, sizeof(addrLast));
   if (i <= 0) {
     fprintf(stderr, "still bad\n");
   } */
@@ -360,8 +376,8 @@ case WSAENETUNREACH:
 }
 
 // FIXME: Prototype
-void serverTransportSendUDP(BYTE *buff, int len, struct sockaddr_in *addr) {
-  sendto(sockUdp, (char *) buff, len, 0, (struct sockaddr *) addr, sizeof(*addr));
+void serverTransportSendUDP(serverCore sc, BYTE *buff, int len, struct sockaddr_in *addr) {
+  sendto(sc->transport->sockUdp, (char *) buff, len, 0, (struct sockaddr *) addr, sizeof(*addr));
 
 }
 
@@ -370,29 +386,30 @@ void serverTransportSendUDP(BYTE *buff, int len, struct sockaddr_in *addr) {
 *NAME:          serverTransportSetTracker
 *AUTHOR:        John Morrison
 *CREATION DATE: 13/11/99
-*LAST MODIFIED: 21/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sets the trackers details up. Returns success.
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  address - Address of the tracker
 *  port    - Port of the tracker
 *********************************************************/
-bool serverTransportSetTracker(char *address, unsigned short port) {
+bool serverTransportSetTracker(serverCore sc, char *address, unsigned short port) {
   bool returnValue;    /* Value to return      */
   struct hostent *phe; /* Used for DNS lookups */
   
   returnValue = TRUE;
-  addrServerTracker.sin_family = AF_INET;
-  addrServerTracker.sin_port = htons(port);
-  addrServerTracker.sin_addr.s_addr = inet_addr(address);
-  if (addrServerTracker.sin_addr.s_addr == INADDR_NONE) {
+  sc->transport->addrServerTracker.sin_family = AF_INET;
+  sc->transport->addrServerTracker.sin_port = htons(port);
+  sc->transport->addrServerTracker.sin_addr.s_addr = inet_addr(address);
+  if (sc->transport->addrServerTracker.sin_addr.s_addr == INADDR_NONE) {
     /* Not an IP Address. Do a hostname lookup */
     phe = gethostbyname(address);
     if (phe == 0) {
       returnValue = FALSE;
     } else {
-      addrServerTracker.sin_addr.s_addr = *((u_long*)phe->h_addr_list[0]);
+      sc->transport->addrServerTracker.sin_addr.s_addr = *((u_long*)phe->h_addr_list[0]);
     }
   }
 
@@ -403,20 +420,21 @@ bool serverTransportSetTracker(char *address, unsigned short port) {
 *NAME:          serverTransportSendUdpTracker
 *AUTHOR:        John Morrison
 *CREATION DATE: 13/11/99
-*LAST MODIFIED: 13/11/99
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Sends a udp packet to the tracker
 *
 *ARGUMENTS:
+*  sc - Game the socket belongs to
 *  buff  - Buffer to send 
 *  len   - length of the buffer
 *********************************************************/
-void serverTransportSendUdpTracker(BYTE *buff, int len) {
-  sendto(sockUdp, (char *) buff, len, 0, (struct sockaddr *)&addrServerTracker, sizeof(addrServerTracker));
+void serverTransportSendUdpTracker(serverCore sc, BYTE *buff, int len) {
+  sendto(sc->transport->sockUdp, (char *) buff, len, 0, (struct sockaddr *)&sc->transport->addrServerTracker, sizeof(sc->transport->addrServerTracker));
 }
 
 
-void serverTransportDoChecks() {
-  serverTransportListenUDP();
+void serverTransportDoChecks(serverCore sc) {
+  serverTransportListenUDP(sc);
   return;
 }
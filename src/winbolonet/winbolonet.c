@@ -41,6 +41,8 @@ BYTE winboloNetServerKey[WINBOLONET_KEY_LEN];
 /* Keys for each player if in use - Always position 0 if we are a client */
 BYTE winboloNetPlayerKey[MAX_TANKS][WINBOLONET_KEY_LEN];
 time_t winboloNetLastSent;
+/* Game the server session is for */
+serverCore winboloNetGame = NULL;
 
 //FIXME: All the string error catching stuff
 
@@ -48,10 +50,11 @@ time_t winboloNetLastSent;
 *NAME:          winbolonetCreateServer
 *AUTHOR:        John Morrison
 *CREATION DATE: 23/09/01
-*LAST MODIFIED: 02/04/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Initialises the WinBolo.net module. Returns success.
-* Tries to contact server to verify versions.
+* Tries to contact server to verify versions. The game
+* the calling thread is working on is the one tracked.
 *
 *ARGUMENTS:
 * mapName - Name of the map
@@ -74,6 +77,7 @@ bool winbolonetCreateServer(char *mapName, unsigned short port, BYTE gameType, B
 
   screenServerConsoleMessage((char *) "WinBolo.net Startup");
   winboloNetRunning = FALSE;
+  winboloNetGame = serverCoreGetContext();
   winbolonetEventsCreate();
   winboloNetServerKey[0] = EMPTY_CHAR;
   count = 0;
@@ -725,9 +729,11 @@ void winboloNetClientLeaveGame(BYTE playerNum, BYTE numPlayers, BYTE freeBases,
 *NAME:          winbolonetAddEvent
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/04/02
-*LAST MODIFIED: 04/04/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Adds a WinBolo.net Event for sending to the server
+* Adds a WinBolo.net Event for sending to the server.
+* Events from games other than the tracked one are
+* dropped
 *
 *ARGUMENTS:
 *  eventType - Type of event this is
@@ -740,7 +746,7 @@ void winbolonetAddEvent(BYTE eventType, bool isServer, BYTE playerA, BYTE player
   BYTE *keyB;
   BYTE emptyKey[WINBOLONET_KEY_LEN];
  
- if (winboloNetRunning == TRUE && isServer == TRUE) {  
+ if (winboloNetRunning == TRUE && isServer == TRUE && (winboloNetGame == NULL || winboloNetGame == serverCoreGetContext())) {
     emptyKey[0] = EMPTY_CHAR;
     keyA = winboloNetPlayerKey[playerA];
     if (playerB == WINBOLO_NET_NO_PLAYER) {
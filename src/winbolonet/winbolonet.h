@@ -80,10 +80,11 @@ void winbolonetServerSendTeams(BYTE *array, BYTE length, BYTE numTeams);
 *NAME:          winbolonetCreateServer
 *AUTHOR:        John Morrison
 *CREATION DATE: 23/09/01
-*LAST MODIFIED: 02/04/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
 * Initialises the WinBolo.net module. Returns success.
-* Tries to contact server to verify versions.
+* Tries to contact server to verify versions. The game
+* the calling thread is working on is the one tracked.
 *
 *ARGUMENTS:
 * mapName - Name of the map
@@ -271,9 +272,11 @@ void winbolonetServerSendTeams(BYTE *array, BYTE length, BYTE numTeams);
 *NAME:          winbolonetAddEventTwoPlayers
 *AUTHOR:        John Morrison
 *CREATION DATE: 04/04/02
-*LAST MODIFIED: 04/04/02
+*LAST MODIFIED: 16/10/26
 *PURPOSE:
-* Adds a WinBolo.net Event for sending to the server
+* Adds a WinBolo.net Event for sending to the server.
+* Events from games other than the tracked one are
+* dropped
 *
 *ARGUMENTS:
 *  eventType - Type of event this is
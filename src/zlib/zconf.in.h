@@ -32,6 +32,7 @@
 #  define inflateSyncPoint z_inflateSyncPoint
 #  define inflateCopy   z_inflateCopy
 #  define inflateReset  z_inflateReset
+#  define inflatePrime  z_inflatePrime
 #  define compress      z_compress
 #  define compress2     z_compress2
 #  define compressBound z_compressBound